@@ -0,0 +1,10 @@
+(define count-down
+  (lambda (n) (if (= n 0) 0 (+ 1 (count-down (- n 1))))))
+(define build
+  (lambda (n) (if (= n 0) (quote ()) (cons n (build (- n 1))))))
+(define repeat
+  (lambda (k acc) (if (= k 0) acc (repeat (- k 1) (+ acc (count-down 3000))))))
+(display (repeat 20 0))
+(newline)
+(display (length (build 2000)))
+(newline)
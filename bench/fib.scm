@@ -0,0 +1,3 @@
+(define fib (lambda (n) (if (< n 2) n (+ (fib (- n 1)) (fib (- n 2))))))
+(display (fib 22))
+(newline)
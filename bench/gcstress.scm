@@ -0,0 +1,13 @@
+(define make-list
+  (lambda (n acc) (if (= n 0) acc (make-list (- n 1) (cons n acc)))))
+(define churn
+  (lambda (k total)
+    (if (= k 0)
+        total
+        (churn (- k 1) (+ total (length (make-list 200 (quote ()))))))))
+(define tree
+  (lambda (d) (if (= d 0) (quote ()) (list (tree (- d 1)) (tree (- d 1))))))
+(display (churn 300 0))
+(newline)
+(display (length (tree 14)))
+(newline)
@@ -0,0 +1,33 @@
+(define lookup
+  (lambda (var env)
+    (if (equal? var (car (car env)))
+        (car (cdr (car env)))
+        (lookup var (cdr env)))))
+(define ev
+  (lambda (e env)
+    (if (number? e)
+        e
+        (if (symbol? e)
+            (lookup e env)
+            (if (equal? (car e) (quote add))
+                (+ (ev (car (cdr e)) env) (ev (car (cdr (cdr e))) env))
+                (if (equal? (car e) (quote mul))
+                    (* (ev (car (cdr e)) env) (ev (car (cdr (cdr e))) env))
+                    (if (equal? (car e) (quote sub))
+                        (- (ev (car (cdr e)) env) (ev (car (cdr (cdr e))) env))
+                        (if (equal? (car e) (quote let1))
+                            (ev (car (cdr (cdr (cdr e))))
+                                (cons (list (car (cdr e)) (ev (car (cdr (cdr e))) env)) env))
+                            0))))))))
+(define env0
+  (list (list (quote alpha) 1) (list (quote beta) 2) (list (quote gamma) 3)
+        (list (quote delta) 4) (list (quote epsilon) 5) (list (quote zeta) 6)))
+(define prog
+  (quote (let1 x (add alpha beta)
+           (let1 y (mul x gamma)
+             (let1 z (sub y delta)
+               (add (mul z epsilon) (add x (mul y zeta))))))))
+(define loop
+  (lambda (n acc) (if (= n 0) acc (loop (- n 1) (+ acc (ev prog env0))))))
+(display (loop 1000 0))
+(newline)
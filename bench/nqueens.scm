@@ -0,0 +1,23 @@
+(define one-to
+  (lambda (n)
+    (if (= n 0) (quote ()) (cons n (one-to (- n 1))))))
+(define ok?
+  (lambda (row dist placed)
+    (if (null? placed)
+        1
+        (if (= (car placed) (+ row dist))
+            0
+            (if (= (car placed) (- row dist))
+                0
+                (ok? row (+ dist 1) (cdr placed)))))))
+(define try-it
+  (lambda (x y z)
+    (if (null? x)
+        (if (null? y) 1 0)
+        (+ (if (ok? (car x) 1 z)
+               (try-it (append (cdr x) y) (quote ()) (cons (car x) z))
+               0)
+           (try-it (cdr x) (cons (car x) y) z)))))
+(define queens (lambda (n) (try-it (one-to n) (quote ()) (quote ()))))
+(display (queens 8))
+(newline)
@@ -0,0 +1,23 @@
+(define map
+  (lambda (fn lst)
+    (if (null? lst) (quote ()) (cons (fn (car lst)) (map fn (cdr lst))))))
+(define filter
+  (lambda (pred lst)
+    (if (null? lst)
+        (quote ())
+        (if (pred (car lst))
+            (cons (car lst) (filter pred (cdr lst)))
+            (filter pred (cdr lst))))))
+(define sum
+  (lambda (lst) (if (null? lst) 0 (+ (car lst) (sum (cdr lst))))))
+(define range
+  (lambda (a b) (if (< a b) (cons a (range (+ a 1) b)) (quote ()))))
+(define pipeline
+  (lambda (n)
+    (sum (map (lambda (x) (* x 3))
+              (filter (lambda (x) (> x 2))
+                      (append (range 0 n) (map (lambda (x) (+ x 1)) (range 0 n))))))))
+(define repeat
+  (lambda (k acc) (if (= k 0) acc (repeat (- k 1) (+ acc (pipeline 400))))))
+(display (repeat 10 0))
+(newline)
@@ -0,0 +1,219 @@
+// Benchmark runner.
+// Runs every script several times with the given interpreter and prints one
+// JSON object per script on stdout, so that results from two commits can be
+// diffed or loaded by a script:
+//
+//   {"bench":"fib","runs":5,"median_ms":..., "min_ms":..., "max_ms":...,
+//    "peak_rss_kb":..., "cycles":..., "instructions":..., "cache_misses":...,
+//    "branch_misses":..., "status":"ok"}
+//
+// Hardware counters come from perf_event_open and are reported as medians;
+// they are null when the kernel doesn't allow them (e.g. in containers or
+// with a high perf_event_paranoid).
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+
+#define MAX_RUNS 64
+#define NUM_COUNTERS 4
+
+static const struct {
+    const char *name;
+    uint64_t config;
+} counters[NUM_COUNTERS] = {
+    { "cycles",        PERF_COUNT_HW_CPU_CYCLES },
+    { "instructions",  PERF_COUNT_HW_INSTRUCTIONS },
+    { "cache_misses",  PERF_COUNT_HW_CACHE_MISSES },
+    { "branch_misses", PERF_COUNT_HW_BRANCH_MISSES },
+};
+
+typedef struct Run {
+    double ms;
+    long rss_kb;
+    bool has_counter[NUM_COUNTERS];
+    uint64_t counter[NUM_COUNTERS];
+    bool ok;
+} Run;
+
+static int open_counter(pid_t pid, uint64_t config)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size           = sizeof(attr);
+    attr.type           = PERF_TYPE_HARDWARE;
+    attr.config         = config;
+    attr.disabled       = 1;
+    attr.enable_on_exec = 1;
+    attr.inherit        = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+    return syscall(SYS_perf_event_open, &attr, pid, -1, -1, 0);
+}
+
+static double now_ms()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+// Fork a child that waits on a pipe until its counters are attached,
+// then execs the interpreter on the script with stdout discarded.
+static Run run_once(const char *interp, const char *script)
+{
+    Run run = { .ok = false };
+    int sync[2];
+    if (pipe(sync) < 0) {
+        perror("pipe");
+        exit(1);
+    }
+    double start = now_ms();
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        exit(1);
+    } else if (pid == 0) {
+        char c;
+        close(sync[1]);
+        if (read(sync[0], &c, 1) < 0) {
+            _exit(127);
+        }
+        int devnull = open("/dev/null", O_WRONLY);
+        if (devnull >= 0) {
+            dup2(devnull, STDOUT_FILENO);
+        }
+        execl(interp, interp, "-f", script, (char *) NULL);
+        _exit(127);
+    }
+
+    close(sync[0]);
+    int fds[NUM_COUNTERS];
+    for (int i = 0; i < NUM_COUNTERS; i++) {
+        fds[i] = open_counter(pid, counters[i].config);
+    }
+    if (write(sync[1], "x", 1) < 0) {
+        perror("write");
+    }
+    close(sync[1]);
+
+    int status;
+    struct rusage usage;
+    if (wait4(pid, &status, 0, &usage) < 0) {
+        perror("wait4");
+        exit(1);
+    }
+    run.ms = now_ms() - start;
+    run.rss_kb = usage.ru_maxrss;
+    run.ok = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    for (int i = 0; i < NUM_COUNTERS; i++) {
+        run.has_counter[i] = fds[i] >= 0
+            && read(fds[i], &run.counter[i], sizeof(uint64_t)) == sizeof(uint64_t);
+        if (fds[i] >= 0) {
+            close(fds[i]);
+        }
+    }
+    return run;
+}
+
+static int compare_double(const void *a, const void *b)
+{
+    double x = *(const double *) a, y = *(const double *) b;
+    return x < y ? -1 : x > y ? 1 : 0;
+}
+
+static int compare_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *) a, y = *(const uint64_t *) b;
+    return x < y ? -1 : x > y ? 1 : 0;
+}
+
+// "bench/fib.scm" -> "fib"
+static void bench_name(const char *path, char *out, size_t size)
+{
+    const char *base = strrchr(path, '/');
+    base = base ? base + 1 : path;
+    size_t len = strcspn(base, ".");
+    if (len >= size) {
+        len = size - 1;
+    }
+    memcpy(out, base, len);
+    out[len] = '\0';
+}
+
+static void report(const char *script, Run *runs, int n)
+{
+    char name[256];
+    bench_name(script, name, sizeof(name));
+
+    double times[MAX_RUNS];
+    long peak_rss = 0;
+    bool ok = true;
+    for (int i = 0; i < n; i++) {
+        times[i] = runs[i].ms;
+        peak_rss = runs[i].rss_kb > peak_rss ? runs[i].rss_kb : peak_rss;
+        ok = ok && runs[i].ok;
+    }
+    qsort(times, n, sizeof(double), compare_double);
+
+    printf("{\"bench\":\"%s\",\"runs\":%d,\"median_ms\":%.3f,\"min_ms\":%.3f,"
+           "\"max_ms\":%.3f,\"peak_rss_kb\":%ld",
+           name, n, times[n/2], times[0], times[n-1], peak_rss);
+    for (int c = 0; c < NUM_COUNTERS; c++) {
+        uint64_t values[MAX_RUNS];
+        int count = 0;
+        for (int i = 0; i < n; i++) {
+            if (runs[i].has_counter[c]) {
+                values[count++] = runs[i].counter[c];
+            }
+        }
+        if (count == 0) {
+            printf(",\"%s\":null", counters[c].name);
+        } else {
+            qsort(values, count, sizeof(uint64_t), compare_u64);
+            printf(",\"%s\":%llu", counters[c].name,
+                   (unsigned long long) values[count/2]);
+        }
+    }
+    printf(",\"status\":\"%s\"}\n", ok ? "ok" : "fail");
+    fflush(stdout);
+}
+
+int main(int argc, char *argv[])
+{
+    int runs = 5;
+    int argi = 1;
+    if (argc > 2 && strcmp(argv[1], "-n") == 0) {
+        runs = atoi(argv[2]);
+        argi = 3;
+    }
+    if (runs < 1 || runs > MAX_RUNS || argc - argi < 2) {
+        fprintf(stderr, "usage: %s [-n runs (1-%d)] interpreter script...\n",
+            argv[0], MAX_RUNS);
+        return 1;
+    }
+    const char *interp = argv[argi++];
+    for (; argi < argc; argi++) {
+        Run results[MAX_RUNS];
+        // one warm-up run, so that the first measurement doesn't pay for
+        // cold page cache
+        run_once(interp, argv[argi]);
+        for (int i = 0; i < runs; i++) {
+            results[i] = run_once(interp, argv[argi]);
+        }
+        report(argv[argi], results, runs);
+    }
+    return 0;
+}
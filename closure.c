@@ -0,0 +1,253 @@
+// Closure conversion.
+// A closure used to keep the whole environment it was made in, and with it
+// every enclosing frame and everything bound there, even if it only used one
+// variable. Now, after optimization, each top-level form goes through a pass
+// that annotates every lambda with the local variables of enclosing scopes
+// that its body refers to:
+//
+//   (lambda (param...) body (quote ((captured...) (boxed...) stack-frame)))
+//
+// When the closure is made, the captured variables are copied into a frame
+// of its own, whose outer is the global environment (see closure_env), and
+// the frames around it may then be collected. A closure that captures
+// nothing gets the global environment itself.
+// A variable that may change after it's captured, because it's set!,
+// defined in a body or bound by letrec, is boxed: the frame where it lives
+// and every closure that captured it share the box.
+// The annotation is quoted, so other passes see it as a constant. A lambda
+// that refers to a shadowed name isn't annotated, and keeps its environment.
+//
+// Escape analysis.
+// A call frame can only be reached after the call returns through a closure
+// or a promise made while it was live. So when a body makes none,
+// stack-frame is true, and calls take their frame from the collector's frame
+// stack instead of the heap (see gc_push_frame). A closure is made by a
+// lambda, or by a named let that isn't a loop (see call_named_let); the
+// latter only matters if the body uses the loop's name as a value, as calls
+// to it all return before the frame does.
+
+typedef struct Converter {
+    List bound;   // local variables around the current expression
+    List mutable; // names defined, set! or bound by letrec anywhere in the form
+    int lambdas;  // how many lambdas the current expression is in
+} Converter;
+
+static void find_mutable(Interp *interp, Converter *c, Exp x)
+{
+    if (x.type != EXP_LIST || AS_LIST(x).size == 0) {
+        return;
+    }
+    List l = AS_LIST(x);
+    if (is_form(l.data[0], "quote")) {
+        return;
+    } else if ((is_form(l.data[0], "define") || is_form(l.data[0], "set!"))
+            && l.size > 1 && is_symbol(l.data[1])) {
+        list_add(interp, &c->mutable, l.data[1]);
+    } else if (is_form(l.data[0], "letrec") && l.size > 1 && l.data[1].type == EXP_LIST) {
+        List bindings = AS_LIST(l.data[1]);
+        for (size_t i = 0; i < bindings.size; i++) {
+            if (bindings.data[i].type == EXP_LIST && AS_LIST(bindings.data[i]).size > 0) {
+                list_add(interp, &c->mutable, AS_LIST(bindings.data[i]).data[0]);
+            }
+        }
+    }
+    for (size_t i = 0; i < l.size; i++) {
+        find_mutable(interp, c, l.data[i]);
+    }
+}
+
+// Bind every name that x defines outside of lambdas. Defines inside a let
+// body are bound one scope early, which only means a lambda may look for
+// a variable that isn't there yet: it then keeps its environment.
+static void bind_defines(Interp *interp, Converter *c, Exp x)
+{
+    if (x.type != EXP_LIST || AS_LIST(x).size == 0) {
+        return;
+    }
+    List l = AS_LIST(x);
+    if (is_form(l.data[0], "quote") || is_form(l.data[0], "lambda")) {
+        return;
+    } else if (is_form(l.data[0], "define") && l.size > 1 && is_symbol(l.data[1])) {
+        list_add(interp, &c->bound, l.data[1]);
+    }
+    for (size_t i = 0; i < l.size; i++) {
+        bind_defines(interp, c, l.data[i]);
+    }
+}
+
+static void bind_vars(Interp *interp, Converter *c, Exp bindings)
+{
+    if (bindings.type != EXP_LIST) {
+        return;
+    }
+    for (size_t i = 0; i < AS_LIST(bindings).size; i++) {
+        Exp b = AS_LIST(bindings).data[i];
+        if (b.type == EXP_LIST && AS_LIST(b).size > 0 && is_symbol(AS_LIST(b).data[0])) {
+            list_add(interp, &c->bound, AS_LIST(b).data[0]);
+        }
+    }
+}
+
+static size_t count(List l, Exp name)
+{
+    size_t n = 0;
+    for (size_t i = 0; i < l.size; i++) {
+        n += exp_eq(l.data[i], name);
+    }
+    return n;
+}
+
+// Add to captured every variable x refers to that's bound around the lambda
+// and isn't one of its params. Return false if one of them is shadowed.
+static bool find_captured(Interp *interp, Converter *c, Exp x, List params, List *captured)
+{
+    if (is_symbol(x)) {
+        size_t n = in_list(params, x) ? 0 : count(c->bound, x);
+        if (n > 0 && !in_list(*captured, x)) {
+            list_add(interp, captured, x);
+        }
+        return n <= 1;
+    } else if (x.type != EXP_LIST || AS_LIST(x).size == 0 || is_form(AS_LIST(x).data[0], "quote")) {
+        return true;
+    }
+    for (size_t i = 0; i < AS_LIST(x).size; i++) {
+        if (!find_captured(interp, c, AS_LIST(x).data[i], params, captured)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Whether x uses name other than as the procedure of a call.
+static bool used_as_value(Exp x, Exp name)
+{
+    if (is_symbol(x)) {
+        return exp_eq(x, name);
+    } else if (x.type != EXP_LIST || AS_LIST(x).size == 0 || is_form(AS_LIST(x).data[0], "quote")) {
+        return false;
+    }
+    List l = AS_LIST(x);
+    for (size_t i = exp_eq(l.data[0], name) ? 1 : 0; i < l.size; i++) {
+        if (used_as_value(l.data[i], name)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Whether evaluating x may make a closure or promise that keeps the current
+// frame.
+static bool makes_escaping_closure(Exp x)
+{
+    if (x.type != EXP_LIST || AS_LIST(x).size == 0) {
+        return false;
+    }
+    List l = AS_LIST(x);
+    if (is_form(l.data[0], "quote")) {
+        return false;
+    } else if (keeps_env(l.data[0])) {
+        return true;
+    } else if (is_form(l.data[0], "let") && l.size > 2 && is_symbol(l.data[1])) {
+        for (size_t i = 3; i < l.size; i++) {
+            if (used_as_value(l.data[i], l.data[1])) {
+                return true;
+            }
+        }
+    }
+    for (size_t i = 0; i < l.size; i++) {
+        if (makes_escaping_closure(l.data[i])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void annotate(Interp *interp, Converter *c, Exp x)
+{
+    List l = AS_LIST(x);
+    List params = AS_LIST(l.data[1]);
+    Exp captured = mklist(interp, (List) VECTOR_INIT());
+    if (!find_captured(interp, c, l.data[2], params, &AS_LIST(captured))) {
+        if (l.size == 4) {
+            AS_LIST(x).size = 3;
+        }
+        return;
+    }
+    Exp boxed = mklist(interp, (List) VECTOR_INIT());
+    for (size_t i = 0; i < AS_LIST(captured).size; i++) {
+        if (in_list(c->mutable, AS_LIST(captured).data[i])) {
+            list_add(interp, &AS_LIST(boxed), AS_LIST(captured).data[i]);
+        }
+    }
+    Exp vars = mklist(interp, (List) VECTOR_INIT());
+    list_add(interp, &AS_LIST(vars), captured);
+    list_add(interp, &AS_LIST(vars), boxed);
+    list_add(interp, &AS_LIST(vars), mknum(!makes_escaping_closure(l.data[2])));
+    Exp quoted = mklist(interp, (List) VECTOR_INIT());
+    list_add(interp, &AS_LIST(quoted), mkcsym(interp, "quote"));
+    list_add(interp, &AS_LIST(quoted), vars);
+    if (l.size == 4) {
+        AS_LIST(x).data[3] = quoted;
+    } else {
+        list_add(interp, &AS_LIST(x), quoted);
+    }
+}
+
+// The variables each form binds are seen as bound in all of it, inits
+// included. That's never wrong, as looking for a variable that's bound
+// further out finds it anyway.
+static void convert(Interp *interp, Converter *c, Exp x)
+{
+    if (x.type != EXP_LIST || AS_LIST(x).size == 0) {
+        return;
+    }
+    List l = AS_LIST(x);
+    Exp op = l.data[0];
+    size_t scope = c->bound.size;
+    if (is_form(op, "quote")) {
+        return;
+    } else if (is_form(op, "lambda")) {
+        if ((l.size != 3 && l.size != 4) || l.data[1].type != EXP_LIST) {
+            return;
+        }
+        annotate(interp, c, x);
+        for (size_t i = 0; i < AS_LIST(l.data[1]).size; i++) {
+            list_add(interp, &c->bound, AS_LIST(l.data[1]).data[i]);
+        }
+        bind_defines(interp, c, l.data[2]);
+        c->lambdas++;
+        convert(interp, c, l.data[2]);
+        c->lambdas--;
+        c->bound.size = scope;
+        return;
+    } else if (is_form(op, "let") || is_form(op, "let*") || is_form(op, "letrec")
+            || is_form(op, "do")) {
+        size_t at = 1;
+        if (l.size > 1 && is_symbol(l.data[1])) {
+            list_add(interp, &c->bound, l.data[1]); // named let
+            at = 2;
+        }
+        if (at < l.size) {
+            bind_vars(interp, c, l.data[at]);
+        }
+        for (size_t i = at + 1; i < l.size && c->lambdas == 0; i++) {
+            bind_defines(interp, c, l.data[i]); // else the lambda bound them
+        }
+    } else if (is_form(op, "guard") && l.size > 1 && l.data[1].type == EXP_LIST
+            && AS_LIST(l.data[1]).size > 0) {
+        list_add(interp, &c->bound, AS_LIST(l.data[1]).data[0]);
+    }
+    for (size_t i = 0; i < l.size; i++) {
+        convert(interp, c, l.data[i]);
+    }
+    c->bound.size = scope;
+}
+
+static void convert_closures(Interp *interp, Exp form)
+{
+    Converter c = { .bound = VECTOR_INIT(), .mutable = VECTOR_INIT(), .lambdas = 0 };
+    find_mutable(interp, &c, form);
+    convert(interp, &c, form);
+    list_free(interp, &c.bound);
+    list_free(interp, &c.mutable);
+}
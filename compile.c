@@ -0,0 +1,1381 @@
+// Ahead-of-time compilation of a script to C (scheme -c script.scm -o out.c).
+// The C code is a program that runs the script, linked with the runtime:
+// it calls the primitives and allocates through the collector like the
+// interpreter does, and prints the value of each top-level form the same way.
+//
+// Forms are expanded and optimized when they're compiled. A procedure
+// defined once by (define name (lambda ...)) and never set! is known: it
+// becomes a C function, bound to its name as a C procedure, and compiled
+// code calls it directly. Primitives the script never redefines are called
+// directly too, and + - * comparisons and not are compiled inline when their
+// arguments are numbers.
+// Values known to be numbers (constants, results of numeric primitives and
+// locals only ever bound to those) live in C doubles. A known procedure
+// whose body only computes numbers also gets a version on doubles, which
+// its generic version calls when every argument is a number.
+// Self tail calls, named lets only called in tail position and do loops
+// become C loops. Other calls nest in C, and each compiled function checks
+// the C stack on entry, as proc_call does, so that recursion too deep
+// raises a stack overflow rather than crashing.
+//
+// Compiled code understands quote, if, let, let*, named let, do, cond
+// (without =>), when, unless, and, or, begin, set! of locals and calls.
+// A top-level form using anything else (lambda, letrec, guard, internal
+// define...) is embedded as data and handed to the interpreter when the
+// program runs, in its turn.
+
+#include "compile.h"
+
+#include <ctype.h>
+#include <stdarg.h>
+#include "gcobject.h"
+#include "ht.h"
+
+// A procedure defined once at top level and never set!.
+typedef struct Known {
+    Exp name;
+    Exp lambda;
+    bool compiled; // its body compiles to C
+    bool numeric;  // it also has a version on doubles
+} Known;
+
+// What the generated code refers to, as indexes in arrays it sets up in init().
+typedef struct Program {
+    Interp *interp;
+    List syms;  // symbols: sym[i]
+    List lits;  // quoted constants and forms left to the interpreter: lit[i]
+    List prims; // names of primitives called through prim[i]
+    Known *known;
+    size_t nknown;
+    int datums; // C variables made by init() so far
+} Program;
+
+// A value computed by generated code: a C expression of type Exp, or double
+// if num.
+typedef struct Val {
+    char c[48];
+    bool num;
+    bool temp; // c is a variable declared for this value
+    bool jump; // the code jumped back to a loop, so there's no value
+} Val;
+
+typedef struct Local {
+    Exp name;
+    char c[24]; // the C variable
+    bool num;   // whether it's a double
+    int loop;   // for the name of a named let, its index in loops, else -1
+} Local;
+
+// A named let, or the compiled procedure itself, whose tail calls jump back.
+typedef struct Loop {
+    size_t vars; // index of the first variable in locals
+    size_t nvars;
+    char label[16];
+    bool tail;   // whether it's in tail position of the enclosing loop
+    bool *boxed; // variables that can't be doubles
+    bool retry;  // a variable got something else than a number: compile again
+    bool used;   // whether anything jumps to label
+} Loop;
+
+// The state of compiling a C function.
+typedef struct Gen {
+    Program *prog;
+    Writer *w;
+    int indent;
+    Local *locals; // innermost last
+    size_t nlocals, locals_cap;
+    Loop *loops;
+    size_t nloops, loops_cap;
+    int vars;      // C variables made so far
+    Known *self;   // the procedure compiled, or NULL at top level
+    bool numeric;  // compiling self's version on doubles
+    bool failed;
+} Gen;
+
+static void *grow(void *p, size_t size)
+{
+    p = realloc(p, size);
+    if (!p) {
+        abort();
+    }
+    return p;
+}
+
+static bool is_form(Exp op, const char *name)
+{
+    return is_symbol(op) && strcmp(AS_SYM(op), name) == 0;
+}
+
+static const char *special_forms[] = {
+    "quote", "if", "define", "set!", "lambda", "let", "let*", "letrec", "do",
+    "cond", "when", "unless", "and", "or", "guard", "delay", "delay-force", "cons-stream",
+    "future",
+};
+
+static bool is_special_form(Exp op)
+{
+    for (size_t i = 0; i < sizeof(special_forms) / sizeof(special_forms[0]); i++) {
+        if (strcmp(AS_SYM(op), special_forms[i]) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Output.
+
+static void vout(Writer *w, const char *fmt, va_list ap)
+{
+    va_list copy;
+    va_copy(copy, ap);
+    int n = vsnprintf(NULL, 0, fmt, copy);
+    va_end(copy);
+    writer_reserve(w, n + 1);
+    vsnprintf(w->buf + w->len, n + 1, fmt, ap);
+    w->len += n;
+}
+
+static void out(Writer *w, const char *fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    vout(w, fmt, ap);
+    va_end(ap);
+}
+
+// Write a line of code at the current indentation.
+static void line(Gen *g, const char *fmt, ...)
+{
+    for (int i = 0; i < g->indent; i++) {
+        writer_puts(g->w, "    ");
+    }
+    va_list ap;
+    va_start(ap, fmt);
+    vout(g->w, fmt, ap);
+    va_end(ap);
+    writer_putc(g->w, '\n');
+}
+
+static void c_string(Writer *w, const char *s)
+{
+    writer_putc(w, '"');
+    for (; *s; s++) {
+        unsigned char c = *s;
+        if (c == '"' || c == '\\' || c == '?') {
+            // ? too, so that no trigraph can appear
+            writer_putc(w, '\\');
+            writer_putc(w, c);
+        } else if (isprint(c)) {
+            writer_putc(w, c);
+        } else {
+            out(w, "\\%03o", c);
+        }
+    }
+    writer_putc(w, '"');
+}
+
+static void number_literal(double x, char buf[FORMAT_NUMBER_MAX + 2])
+{
+    if (isnan(x)) {
+        strcpy(buf, "NAN");
+    } else if (isinf(x)) {
+        strcpy(buf, x > 0 ? "INFINITY" : "-INFINITY");
+    } else {
+        size_t n = format_number(x, buf);
+        buf[n] = '\0';
+        if (!strpbrk(buf, ".e")) {
+            strcpy(buf + n, ".0");
+        }
+    }
+}
+
+// Write form as a one-line comment, cut if it's long.
+static void comment(Writer *w, Exp form)
+{
+    Writer text;
+    writer_init(&text, -1, 128);
+    print_to(&text, form);
+    size_t len = text.len < 72 ? text.len : 72;
+    writer_puts(w, "    // ");
+    for (size_t i = 0; i < len; i++) {
+        char c = text.buf[i];
+        writer_putc(w, c == '\n' || c == '\\' || c == '?' ? ' ' : c);
+    }
+    writer_puts(w, len < text.len ? " ...\n" : "\n");
+    writer_free(&text);
+}
+
+static size_t intern(Program *p, List *l, Exp x)
+{
+    if (l != &p->lits) {
+        for (size_t i = 0; i < l->size; i++) {
+            if (exp_eq(l->data[i], x)) {
+                return i;
+            }
+        }
+    }
+    list_add(p->interp, l, x);
+    return l->size - 1;
+}
+
+// Values.
+
+static Val val(bool num, const char *fmt, ...)
+{
+    Val v = { .num = num };
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(v.c, sizeof(v.c), fmt, ap);
+    va_end(ap);
+    return v;
+}
+
+static Val void_val(void) { return val(false, "VOID_EXP"); }
+
+static Val fail(Gen *g)
+{
+    g->failed = true;
+    return void_val();
+}
+
+static Val jumped(void)
+{
+    Val v = void_val();
+    v.jump = true;
+    return v;
+}
+
+static const char *type_of(bool num) { return num ? "double" : "Exp"; }
+
+// A new variable set to the expression in code.
+static Val temp(Gen *g, bool num, const char *code)
+{
+    Val v = val(num, "v%d", g->vars++);
+    v.temp = true;
+    line(g, "%s %s = %s;", type_of(num), v.c, code);
+    return v;
+}
+
+// v as an Exp, or as a double if num.
+static Val as(Val v, bool num)
+{
+    if (v.num == num) {
+        return v;
+    }
+    assert(!num);
+    return val(false, "mknum(%s)", v.c);
+}
+
+static void cond_of(Val v, char buf[96])
+{
+    snprintf(buf, 96, v.num ? "%s != 0" : "is_true(%s)", v.c);
+}
+
+// Evaluate v only for its effects.
+static void discard(Gen *g, Val v)
+{
+    if (v.temp) {
+        line(g, "(void) %s;", v.c);
+    }
+}
+
+static Local *find_local(Gen *g, Exp name)
+{
+    for (size_t i = g->nlocals; i-- > 0; ) {
+        if (exp_eq(g->locals[i].name, name)) {
+            return &g->locals[i];
+        }
+    }
+    return NULL;
+}
+
+static Local *add_local(Gen *g, Exp name, bool num, int loop)
+{
+    if (g->nlocals == g->locals_cap) {
+        g->locals_cap = vector_grow_cap(g->locals_cap);
+        g->locals = grow(g->locals, sizeof(Local) * g->locals_cap);
+    }
+    Local *local = &g->locals[g->nlocals++];
+    *local = (Local) { .name = name, .num = num, .loop = loop };
+    snprintf(local->c, sizeof(local->c), "l%d", g->vars++);
+    return local;
+}
+
+static size_t add_loop(Gen *g, bool tail, size_t nvars)
+{
+    if (g->nloops == g->loops_cap) {
+        g->loops_cap = vector_grow_cap(g->loops_cap);
+        g->loops = grow(g->loops, sizeof(Loop) * g->loops_cap);
+    }
+    Loop *loop = &g->loops[g->nloops];
+    *loop = (Loop) { .nvars = nvars, .tail = tail, .boxed = calloc(nvars + 1, sizeof(bool)) };
+    snprintf(loop->label, sizeof(loop->label), "loop%d", g->vars++);
+    return g->nloops++;
+}
+
+static void pop_loop(Gen *g)
+{
+    free(g->loops[--g->nloops].boxed);
+}
+
+// Whether a call in tail position (if tail) can jump back to loop i: every
+// loop inside it must be in tail position too.
+static bool can_jump(Gen *g, size_t i, bool tail)
+{
+    for (size_t j = i + 1; tail && j < g->nloops; j++) {
+        tail = g->loops[j].tail;
+    }
+    return tail;
+}
+
+// Whether name is set! anywhere in l[from..].
+static bool assigned_in(List l, size_t from, Exp name)
+{
+    if (l.size > 0 && is_form(l.data[0], "quote")) {
+        return false;
+    }
+    if (from == 0 && l.size == 3 && is_form(l.data[0], "set!") && exp_eq(l.data[1], name)) {
+        return true;
+    }
+    for (size_t i = from; i < l.size; i++) {
+        if (l.data[i].type == EXP_LIST && assigned_in(AS_LIST(l.data[i]), 0, name)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static Known *find_known(Program *p, Exp name)
+{
+    for (size_t i = 0; i < p->nknown; i++) {
+        if (exp_eq(p->known[i].name, name)) {
+            return &p->known[i];
+        }
+    }
+    return NULL;
+}
+
+static size_t known_arity(Known *k)
+{
+    return AS_LIST(AS_LIST(k->lambda).data[1]).size;
+}
+
+// The primitive a global name is bound to, if the script never defines or
+// set!s that name.
+static bool primitive(Program *p, Exp name, CProc *proc)
+{
+    Exp value;
+    if (ht_lookup(&AS_HT(p->interp->definitions), name, &value)
+     || !ht_lookup(&ENV_HT(p->interp->global), name, &value) || value.type != EXP_C_PROC) {
+        return false;
+    }
+    *proc = value.cproc;
+    return true;
+}
+
+static bool numeric_primitive(CProc proc)
+{
+    return proc == scheme_sum || proc == scheme_sub || proc == scheme_mul
+        || proc == scheme_gt || proc == scheme_lt || proc == scheme_ge
+        || proc == scheme_le || proc == scheme_eq || proc == scheme_not;
+}
+
+// Expressions.
+
+static Val compile(Gen *g, Exp x, bool tail);
+
+// Compile l[from..], whose last value is the result.
+static Val compile_body(Gen *g, List l, size_t from, bool tail)
+{
+    if (from >= l.size) {
+        return g->numeric ? fail(g) : void_val();
+    }
+    for (size_t i = from; i < l.size - 1; i++) {
+        discard(g, compile(g, l.data[i], false));
+    }
+    return compile(g, l.data[l.size - 1], tail);
+}
+
+// Compile code that computes a if cond holds and b otherwise. a and b were
+// compiled into then_w and else_w, at one more indentation level.
+static Val branch(Gen *g, const char *cond, Writer *then_w, Val a, Writer *else_w, Val b)
+{
+    bool num = (a.jump || a.num) && (b.jump || b.num);
+    Val res = jumped();
+    if (!a.jump || !b.jump) {
+        res = val(num, "v%d", g->vars++);
+        res.temp = true;
+        line(g, "%s %s;", type_of(num), res.c);
+    }
+    line(g, "if (%s) {", cond);
+    writer_write(g->w, then_w->buf, then_w->len);
+    if (!a.jump) {
+        line(g, "    %s = %s;", res.c, as(a, num).c);
+    }
+    line(g, "} else {");
+    writer_write(g->w, else_w->buf, else_w->len);
+    if (!b.jump) {
+        line(g, "    %s = %s;", res.c, as(b, num).c);
+    }
+    line(g, "}");
+    writer_free(then_w);
+    writer_free(else_w);
+    return res;
+}
+
+// Where the code of a branch goes while it's compiled.
+static Writer *enter_branch(Gen *g, Writer *w)
+{
+    Writer *prev = g->w;
+    writer_init(w, -1, 256);
+    g->w = w;
+    g->indent++;
+    return prev;
+}
+
+static void leave_branch(Gen *g, Writer *prev)
+{
+    g->w = prev;
+    g->indent--;
+}
+
+static Val compile_if(Gen *g, List l, bool tail)
+{
+    if (l.size != 4) {
+        return fail(g);
+    }
+    Val test = compile(g, l.data[1], false);
+    Writer then_w, else_w;
+    Writer *prev = enter_branch(g, &then_w);
+    Val a = compile(g, l.data[2], tail);
+    g->w = &else_w;
+    writer_init(&else_w, -1, 256);
+    Val b = compile(g, l.data[3], tail);
+    leave_branch(g, prev);
+    char cond[96];
+    cond_of(test, cond);
+    return branch(g, cond, &then_w, a, &else_w, b);
+}
+
+// (cond clause...) from clause i on.
+static Val compile_clauses(Gen *g, List l, size_t i, bool tail)
+{
+    if (i == l.size) {
+        return void_val();
+    }
+    if (l.data[i].type != EXP_LIST || AS_LIST(l.data[i]).size == 0) {
+        return fail(g);
+    }
+    List clause = AS_LIST(l.data[i]);
+    if (is_form(clause.data[0], "else")) {
+        return compile_body(g, clause, 1, tail);
+    }
+    if (clause.size == 3 && is_form(clause.data[1], "=>")) {
+        return fail(g);
+    }
+    Val test = compile(g, clause.data[0], false);
+    Writer then_w, else_w;
+    Writer *prev = enter_branch(g, &then_w);
+    Val a = clause.size == 1 ? test : compile_body(g, clause, 1, tail);
+    g->w = &else_w;
+    writer_init(&else_w, -1, 256);
+    Val b = compile_clauses(g, l, i + 1, tail);
+    leave_branch(g, prev);
+    char cond[96];
+    cond_of(test, cond);
+    return branch(g, cond, &then_w, a, &else_w, b);
+}
+
+static Val compile_when(Gen *g, List l, bool tail, bool when)
+{
+    if (l.size < 2) {
+        return fail(g);
+    }
+    Val test = compile(g, l.data[1], false);
+    Writer then_w, else_w;
+    Writer *prev = enter_branch(g, &then_w);
+    Val a = compile_body(g, l, 2, tail);
+    g->w = &else_w;
+    writer_init(&else_w, -1, 256);
+    leave_branch(g, prev);
+    char cond[96];
+    cond_of(test, cond);
+    if (!when) {
+        char negated[100];
+        snprintf(negated, sizeof(negated), "!(%s)", cond);
+        return branch(g, negated, &then_w, a, &else_w, void_val());
+    }
+    return branch(g, cond, &then_w, a, &else_w, void_val());
+}
+
+// (and e...) or (or e...) from e i on.
+static Val compile_and_or(Gen *g, List l, size_t i, bool tail, bool and)
+{
+    if (i == l.size) {
+        return val(true, and ? "1.0" : "0.0");
+    } else if (i == l.size - 1) {
+        return compile(g, l.data[i], tail);
+    }
+    Val v = compile(g, l.data[i], false);
+    Writer rest_w, v_w;
+    Writer *prev = enter_branch(g, &rest_w);
+    Val rest = compile_and_or(g, l, i + 1, tail, and);
+    writer_init(&v_w, -1, 16);
+    leave_branch(g, prev);
+    char cond[96];
+    cond_of(v, cond);
+    return and ? branch(g, cond, &rest_w, rest, &v_w, v)
+               : branch(g, cond, &v_w, v, &rest_w, rest);
+}
+
+// Bind name to v in a new local variable, a double if v is a number that
+// never changes.
+static void bind(Gen *g, Exp name, Val v, bool num)
+{
+    num = num && !g->failed;
+    Local *local = add_local(g, name, num, -1);
+    line(g, "%s %s = %s;", type_of(num), local->c, as(v, num).c);
+}
+
+static bool check_bindings(Exp bindings, size_t min, size_t max)
+{
+    if (bindings.type != EXP_LIST) {
+        return false;
+    }
+    for (size_t i = 0; i < AS_LIST(bindings).size; i++) {
+        Exp b = AS_LIST(bindings).data[i];
+        if (b.type != EXP_LIST || AS_LIST(b).size < min || AS_LIST(b).size > max
+         || !is_symbol(AS_LIST(b).data[0])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static Val compile_let(Gen *g, List l, bool tail, bool star)
+{
+    if (l.size < 3 || !check_bindings(l.data[1], 2, 2)) {
+        return fail(g);
+    }
+    List bindings = AS_LIST(l.data[1]);
+    size_t scope = g->nlocals;
+    Val *inits = grow(NULL, sizeof(Val) * (bindings.size + 1));
+    for (size_t i = 0; i < bindings.size; i++) {
+        List b = AS_LIST(bindings.data[i]);
+        inits[i] = compile(g, b.data[1], false);
+        if (!g->numeric && assigned_in(l, 2, b.data[0])) {
+            inits[i] = as(inits[i], false);
+        }
+        if (star) {
+            bind(g, b.data[0], inits[i], inits[i].num);
+        }
+    }
+    if (!star) {
+        // every init is evaluated before any variable is bound
+        for (size_t i = 0; i < bindings.size; i++) {
+            bind(g, AS_LIST(bindings.data[i]).data[0], inits[i], inits[i].num);
+        }
+    }
+    free(inits);
+    Val res = compile_body(g, l, 2, tail);
+    g->nlocals = scope;
+    return res;
+}
+
+// Jump back to loop i with the arguments of the call l as its new variables.
+static Val compile_jump(Gen *g, size_t i, List l)
+{
+    if (l.size - 1 != g->loops[i].nvars) {
+        return fail(g);
+    }
+    Val *args = grow(NULL, sizeof(Val) * l.size);
+    for (size_t j = 1; j < l.size; j++) {
+        args[j-1] = compile(g, l.data[j], false);
+    }
+    Loop *loop = &g->loops[i];
+    // copy every argument first, as they may use the variables
+    for (size_t j = 0; j < loop->nvars; j++) {
+        if (!args[j].num && !loop->boxed[j]) {
+            loop->boxed[j] = true;
+            loop->retry = true;
+        }
+        Local *var = &g->locals[loop->vars + j];
+        if (!args[j].temp && (args[j].num || !var->num)) {
+            args[j] = temp(g, var->num, as(args[j], var->num).c);
+        }
+    }
+    for (size_t j = 0; j < loop->nvars; j++) {
+        Local *var = &g->locals[loop->vars + j];
+        if (var->num && !args[j].num) {
+            continue; // compiled again anyway
+        }
+        line(g, "%s = %s;", var->c, as(args[j], var->num).c);
+    }
+    line(g, "goto %s;", loop->label);
+    loop->used = true;
+    free(args);
+    return jumped();
+}
+
+// (let name ((var init)...) body...), where name may only be called in tail
+// position: the body is a loop.
+static Val compile_named_let(Gen *g, List l, bool tail)
+{
+    if (l.size < 4 || !check_bindings(l.data[2], 2, 2)) {
+        return fail(g);
+    }
+    List bindings = AS_LIST(l.data[2]);
+    Val *inits = grow(NULL, sizeof(Val) * (bindings.size + 1));
+    for (size_t i = 0; i < bindings.size; i++) {
+        inits[i] = compile(g, AS_LIST(bindings.data[i]).data[1], false);
+    }
+    size_t loop = add_loop(g, tail, bindings.size);
+    for (size_t i = 0; i < bindings.size; i++) {
+        Exp var = AS_LIST(bindings.data[i]).data[0];
+        g->loops[loop].boxed[i] = !g->numeric && (!inits[i].num || assigned_in(l, 3, var));
+    }
+    Writer *prev = g->w;
+    Writer w, body_w;
+    Val res;
+    do {
+        g->loops[loop].retry = false;
+        g->loops[loop].used = false;
+        writer_init(&w, -1, 256);
+        writer_init(&body_w, -1, 256);
+        size_t scope = g->nlocals;
+        g->w = &w;
+        add_local(g, l.data[1], false, (int) loop);
+        g->loops[loop].vars = g->nlocals;
+        for (size_t i = 0; i < bindings.size; i++) {
+            bind(g, AS_LIST(bindings.data[i]).data[0], inits[i], !g->loops[loop].boxed[i]);
+        }
+        g->w = &body_w;
+        Val body = compile_body(g, l, 3, true);
+        g->w = &w;
+        res = jumped();
+        if (!body.jump) {
+            res = val(body.num, "v%d", g->vars++);
+            res.temp = true;
+            line(g, "%s %s;", type_of(res.num), res.c);
+        }
+        if (g->loops[loop].used) {
+            line(g, "%s:;", g->loops[loop].label);
+        }
+        writer_write(&w, body_w.buf, body_w.len);
+        if (!body.jump) {
+            line(g, "%s = %s;", res.c, body.c);
+        }
+        writer_free(&body_w);
+        g->nlocals = scope;
+        if (g->loops[loop].retry && !g->failed) {
+            writer_free(&w);
+        }
+    } while (g->loops[loop].retry && !g->failed);
+    g->w = prev;
+    writer_write(g->w, w.buf, w.len);
+    writer_free(&w);
+    pop_loop(g);
+    free(inits);
+    return res;
+}
+
+// (do ((var init step)...) (test expr...) command...)
+static Val compile_do(Gen *g, List l, bool tail)
+{
+    if (l.size < 3 || !check_bindings(l.data[1], 2, 3)
+     || l.data[2].type != EXP_LIST || AS_LIST(l.data[2]).size == 0) {
+        return fail(g);
+    }
+    List specs = AS_LIST(l.data[1]);
+    List end = AS_LIST(l.data[2]);
+    Val *vals = grow(NULL, sizeof(Val) * (specs.size + 1));
+    bool *boxed = calloc(specs.size + 1, sizeof(bool));
+    for (size_t i = 0; i < specs.size; i++) {
+        vals[i] = compile(g, AS_LIST(specs.data[i]).data[1], false);
+        boxed[i] = !g->numeric && (!vals[i].num || assigned_in(l, 2, AS_LIST(specs.data[i]).data[0]));
+    }
+    Writer *prev = g->w;
+    Writer w;
+    Val res;
+    bool retry;
+    do {
+        retry = false;
+        writer_init(&w, -1, 256);
+        g->w = &w;
+        size_t scope = g->nlocals;
+        size_t vars = g->nlocals;
+        for (size_t i = 0; i < specs.size; i++) {
+            bind(g, AS_LIST(specs.data[i]).data[0], vals[i], !boxed[i]);
+        }
+        line(g, "for (;;) {");
+        g->indent++;
+        Val test = compile(g, end.data[0], false);
+        char cond[96];
+        cond_of(test, cond);
+        line(g, "if (%s) {", cond);
+        line(g, "    break;");
+        line(g, "}");
+        for (size_t i = 3; i < l.size; i++) {
+            discard(g, compile(g, l.data[i], false));
+        }
+        Val *steps = grow(NULL, sizeof(Val) * (specs.size + 1));
+        for (size_t i = 0; i < specs.size; i++) {
+            List spec = AS_LIST(specs.data[i]);
+            if (spec.size < 3) {
+                continue;
+            }
+            Local *var = &g->locals[vars + i];
+            steps[i] = compile(g, spec.data[2], false);
+            if (!steps[i].num && var->num) {
+                boxed[i] = retry = true;
+            } else if (!steps[i].temp) {
+                steps[i] = temp(g, var->num, as(steps[i], var->num).c);
+            }
+        }
+        for (size_t i = 0; i < specs.size && !retry; i++) {
+            Local *var = &g->locals[vars + i];
+            if (AS_LIST(specs.data[i]).size == 3) {
+                line(g, "%s = %s;", var->c, as(steps[i], var->num).c);
+            }
+        }
+        free(steps);
+        g->indent--;
+        line(g, "}");
+        res = compile_body(g, end, 1, tail);
+        g->nlocals = scope;
+        if (retry && !g->failed) {
+            writer_free(&w);
+        }
+    } while (retry && !g->failed);
+    g->w = prev;
+    writer_write(g->w, w.buf, w.len);
+    writer_free(&w);
+    free(vals);
+    free(boxed);
+    return res;
+}
+
+static Val compile_set(Gen *g, List l)
+{
+    Local *local = l.size == 3 && is_symbol(l.data[1]) ? find_local(g, l.data[1]) : NULL;
+    if (!local || local->loop != -1 || g->numeric) {
+        return fail(g);
+    }
+    char c[sizeof(local->c)];
+    strcpy(c, local->c);
+    bool num = local->num;
+    Val v = compile(g, l.data[2], false);
+    if (num && !v.num) {
+        return fail(g);
+    }
+    line(g, "%s = %s;", c, as(v, num).c);
+    return void_val();
+}
+
+// Write the C array and List of args.
+static Val arg_list(Gen *g, Val *args, size_t n)
+{
+    Val list = val(false, "a%d", g->vars++);
+    if (n == 0) {
+        line(g, "List %s = VECTOR_INIT();", list.c);
+        return list;
+    }
+    Writer w;
+    writer_init(&w, -1, 64);
+    for (size_t i = 0; i < n; i++) {
+        out(&w, "%s%s", i == 0 ? "" : ", ", as(args[i], false).c);
+    }
+    line(g, "Exp %s_data[] = { %.*s };", list.c, (int) w.len, w.buf);
+    line(g, "List %s = { .data = %s_data, .size = %zu, .cap = %zu };", list.c, list.c, n, n);
+    writer_free(&w);
+    return list;
+}
+
+static Val *compile_args(Gen *g, List l)
+{
+    Val *args = grow(NULL, sizeof(Val) * l.size);
+    for (size_t i = 1; i < l.size; i++) {
+        args[i-1] = compile(g, l.data[i], false);
+    }
+    return args;
+}
+
+static Val call_val(Gen *g, bool num, Writer *code)
+{
+    writer_putc(code, '\0');
+    Val v = temp(g, num, code->buf);
+    writer_free(code);
+    return v;
+}
+
+static Val compile_known_call(Gen *g, Known *k, List l)
+{
+    size_t id = k - g->prog->known;
+    Val *args = compile_args(g, l);
+    size_t n = l.size - 1;
+    bool num = k->numeric;
+    for (size_t i = 0; i < n; i++) {
+        num = num && args[i].num;
+    }
+    if (g->numeric && !num) {
+        free(args);
+        return fail(g);
+    }
+    if (k != g->self) {
+        line(g, "if (!defined[%zu]) {", id);
+        line(g, "    undefined(interp, sym[%zu]);", intern(g->prog, &g->prog->syms, k->name));
+        line(g, "}");
+    }
+    Writer code;
+    writer_init(&code, -1, 64);
+    out(&code, "proc_%zu%s(interp", id, num ? "_num" : "");
+    for (size_t i = 0; i < n; i++) {
+        out(&code, ", %s", as(args[i], num).c);
+    }
+    writer_putc(&code, ')');
+    free(args);
+    return call_val(g, num, &code);
+}
+
+static const char *inline_operator(CProc proc)
+{
+    return proc == scheme_sum ? "+"
+         : proc == scheme_sub ? "-"
+         : proc == scheme_mul ? "*"
+         : proc == scheme_gt  ? ">"
+         : proc == scheme_lt  ? "<"
+         : proc == scheme_ge  ? ">="
+         : proc == scheme_le  ? "<="
+         : proc == scheme_eq  ? "==" : NULL;
+}
+
+// (op arg...) where op is a primitive: inline if it's a numeric one and the
+// arguments are numbers, a direct call otherwise.
+static Val compile_primitive(Gen *g, Exp op, CProc proc, List l)
+{
+    Val *args = compile_args(g, l);
+    size_t n = l.size - 1;
+    bool num = true;
+    for (size_t i = 0; i < n; i++) {
+        num = num && args[i].num;
+    }
+    Writer code;
+    writer_init(&code, -1, 64);
+    bool arith = proc == scheme_sum || proc == scheme_mul || (proc == scheme_sub && n > 0);
+    bool compare = inline_operator(proc) && !arith && n == 2;
+    if (num && (arith || compare || (proc == scheme_not && n == 1))) {
+        if (proc == scheme_not) {
+            out(&code, "(double) (%s == 0)", args[0].c);
+        } else if (compare) {
+            out(&code, "(double) (%s %s %s)", args[0].c, inline_operator(proc), args[1].c);
+        } else if (proc == scheme_sub && n == 1) {
+            out(&code, "(-(%s))", args[0].c);
+        } else {
+            // + and * start from 0 and 1, which matters for -0
+            out(&code, "(%s", proc == scheme_sum ? "0.0" : proc == scheme_mul ? "1.0" : args[0].c);
+            for (size_t i = proc == scheme_sub ? 1 : 0; i < n; i++) {
+                out(&code, " %s %s", inline_operator(proc), args[i].c);
+            }
+            writer_putc(&code, ')');
+        }
+        free(args);
+        return call_val(g, true, &code);
+    }
+    if (g->numeric) {
+        free(args);
+        writer_free(&code);
+        return fail(g);
+    }
+    Val list = arg_list(g, args, n);
+    free(args);
+    if (numeric_primitive(proc)) {
+        // declared in scheme.h, and always return a number
+        out(&code, "scheme_%s(interp, %s).number",
+            proc == scheme_sum ? "sum" : proc == scheme_sub ? "sub" : proc == scheme_mul ? "mul"
+          : proc == scheme_gt ? "gt" : proc == scheme_lt ? "lt" : proc == scheme_ge ? "ge"
+          : proc == scheme_le ? "le" : proc == scheme_eq ? "eq" : "not", list.c);
+        return call_val(g, true, &code);
+    }
+    out(&code, "prim[%zu](interp, %s)", intern(g->prog, &g->prog->prims, op), list.c);
+    return call_val(g, false, &code);
+}
+
+static Val compile_call(Gen *g, List l, bool tail)
+{
+    Exp op = l.data[0];
+    if (is_symbol(op)) {
+        Local *local = find_local(g, op);
+        if (local && local->loop != -1) {
+            size_t loop = local->loop;
+            return can_jump(g, loop, tail) ? compile_jump(g, loop, l) : fail(g);
+        }
+        Known *k = local ? NULL : find_known(g->prog, op);
+        CProc proc;
+        if (k && k == g->self && can_jump(g, 0, tail) && l.size - 1 == known_arity(k)) {
+            return compile_jump(g, 0, l);
+        } else if (k && k->compiled && l.size - 1 == known_arity(k)) {
+            return compile_known_call(g, k, l);
+        } else if (!local && primitive(g->prog, op, &proc)) {
+            return is_form(op, "begin") && l.size > 1 ? compile_body(g, l, 1, tail)
+                                                      : compile_primitive(g, op, proc, l);
+        }
+    }
+    if (g->numeric) {
+        return fail(g);
+    }
+    // the procedure is evaluated and checked before the arguments
+    Val f = compile(g, op, false);
+    Writer code;
+    writer_init(&code, -1, 64);
+    out(&code, "proc_ref(interp, %s)", f.c);
+    f = call_val(g, false, &code);
+    Val *args = compile_args(g, l);
+    Val list = arg_list(g, args, l.size - 1);
+    free(args);
+    writer_init(&code, -1, 64);
+    out(&code, "call(interp, %s, %s)", f.c, list.c);
+    return call_val(g, false, &code);
+}
+
+static Val compile(Gen *g, Exp x, bool tail)
+{
+    if (g->failed) {
+        return void_val();
+    } else if (is_number(x)) {
+        char buf[FORMAT_NUMBER_MAX + 2];
+        number_literal(x.number, buf);
+        return val(true, "%s", buf);
+    } else if (is_symbol(x)) {
+        Local *local = find_local(g, x);
+        if (local) {
+            return local->loop == -1 ? val(local->num, "%s", local->c) : fail(g);
+        } else if (g->numeric) {
+            return fail(g);
+        }
+        char code[64];
+        snprintf(code, sizeof(code), "global_ref(interp, sym[%zu])",
+                 intern(g->prog, &g->prog->syms, x));
+        return temp(g, false, code);
+    } else if (x.type != EXP_LIST) {
+        // the void left by define-syntax
+        return g->numeric ? fail(g) : val(false, "lit[%zu]", intern(g->prog, &g->prog->lits, x));
+    }
+    List l = AS_LIST(x);
+    if (l.size == 0) {
+        return fail(g);
+    }
+    Exp op = l.data[0];
+    if (!is_symbol(op) || !is_special_form(op)) {
+        return compile_call(g, l, tail);
+    } else if (is_form(op, "quote")) {
+        if (l.size != 2 || (g->numeric && !is_number(l.data[1]))) {
+            return fail(g);
+        }
+        return is_number(l.data[1]) ? compile(g, l.data[1], tail)
+                                    : val(false, "lit[%zu]", intern(g->prog, &g->prog->lits, l.data[1]));
+    } else if (is_form(op, "if")) {
+        return compile_if(g, l, tail);
+    } else if (is_form(op, "let") && l.size > 1 && is_symbol(l.data[1])) {
+        return compile_named_let(g, l, tail);
+    } else if (is_form(op, "let") || is_form(op, "let*")) {
+        return compile_let(g, l, tail, is_form(op, "let*"));
+    } else if (is_form(op, "do")) {
+        return compile_do(g, l, tail);
+    } else if (is_form(op, "set!")) {
+        return compile_set(g, l);
+    } else if (g->numeric) {
+        return fail(g);
+    } else if (is_form(op, "cond")) {
+        return compile_clauses(g, l, 1, tail);
+    } else if (is_form(op, "when") || is_form(op, "unless")) {
+        return compile_when(g, l, tail, is_form(op, "when"));
+    } else if (is_form(op, "and") || is_form(op, "or")) {
+        return compile_and_or(g, l, 1, tail, is_form(op, "and"));
+    }
+    return fail(g);
+}
+
+// Procedures and top-level forms.
+
+static void free_gen(Gen *g)
+{
+    while (g->nloops > 0) {
+        pop_loop(g);
+    }
+    free(g->locals);
+    free(g->loops);
+}
+
+static void params_decl(Writer *w, Known *k, bool num)
+{
+    out(w, "(Interp *interp");
+    for (size_t i = 0; i < known_arity(k); i++) {
+        out(w, ", %s p%zu", type_of(num), i);
+    }
+    writer_putc(w, ')');
+}
+
+// Compile k, or its version on doubles if numeric, to the C function
+// proc_<index>[_num]. Return false if its body can't be compiled.
+static bool compile_proc(Program *p, Known *k, bool numeric, Writer *w)
+{
+    size_t id = k - p->known;
+    List params = AS_LIST(AS_LIST(k->lambda).data[1]);
+    Writer body;
+    writer_init(&body, -1, 1024);
+    Gen g = { .prog = p, .w = &body, .indent = 1, .self = k, .numeric = numeric };
+    add_loop(&g, true, params.size);
+    strcpy(g.loops[0].label, "top");
+    for (size_t i = 0; i < params.size; i++) {
+        Local *local = add_local(&g, params.data[i], numeric, -1);
+        snprintf(local->c, sizeof(local->c), "p%zu", i);
+        g.loops[0].boxed[i] = !numeric;
+    }
+    if (!numeric && k->numeric) {
+        Writer code;
+        writer_init(&code, -1, 64);
+        for (size_t i = 0; i < params.size; i++) {
+            out(&code, "%sis_number(p%zu)", i == 0 ? "" : " && ", i);
+        }
+        line(&g, "if (%.*s) {", code.len == 0 ? 1 : (int) code.len, code.len == 0 ? "1" : code.buf);
+        writer_clear(&code);
+        for (size_t i = 0; i < params.size; i++) {
+            out(&code, ", p%zu.number", i);
+        }
+        line(&g, "    return mknum(proc_%zu_num(interp%.*s));", id, (int) code.len, code.buf);
+        line(&g, "}");
+        writer_free(&code);
+    }
+    Val res = compile(&g, AS_LIST(k->lambda).data[2], true);
+    bool ok = !g.failed && (!numeric || res.num || res.jump);
+    if (ok && !res.jump) {
+        line(&g, "return %s;", as(res, numeric).c);
+    }
+    if (ok) {
+        out(w, "// %s\nstatic %s proc_%zu%s", AS_SYM(k->name), type_of(numeric), id,
+            numeric ? "_num" : "");
+        params_decl(w, k, numeric);
+        out(w, "\n{\n    check_stack(interp);\n%s", g.loops[0].used ? "top:;\n" : "");
+        writer_write(w, body.buf, body.len);
+        out(w, "}\n\n");
+    }
+    writer_free(&body);
+    free_gen(&g);
+    return ok;
+}
+
+// Whether (define name x) defines a known procedure.
+static bool known_definition(Interp *interp, List l)
+{
+    Exp def;
+    if (l.size != 3 || !is_form(l.data[0], "define") || !is_symbol(l.data[1])
+     || l.data[2].type != EXP_LIST || AS_LIST(l.data[2]).size != 3
+     || !is_form(AS_LIST(l.data[2]).data[0], "lambda")
+     || AS_LIST(l.data[2]).data[1].type != EXP_LIST
+     || !ht_lookup(&AS_HT(interp->definitions), l.data[1], &def)
+     || def.type != EXP_LIST || def.obj != l.data[2].obj) {
+        return false;
+    }
+    List params = AS_LIST(AS_LIST(l.data[2]).data[1]);
+    for (size_t i = 0; i < params.size; i++) {
+        if (!is_symbol(params.data[i])) {
+            return false;
+        }
+        for (size_t j = 0; j < i; j++) {
+            if (exp_eq(params.data[i], params.data[j])) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Code that builds the constant x into the C variable into.
+static void build_datum(Program *p, Writer *w, Exp x, const char *into, int indent)
+{
+    char num[FORMAT_NUMBER_MAX + 2];
+    out(w, "%*s", indent * 4, "");
+    switch (x.type) {
+    case EXP_NUMBER:
+        number_literal(x.number, num);
+        out(w, "%s = mknum(%s);\n", into, num);
+        break;
+    case EXP_SYMBOL:
+        out(w, "%s = sym[%zu];\n", into, intern(p, &p->syms, x));
+        break;
+    case EXP_VOID:
+        out(w, "%s = VOID_EXP;\n", into);
+        break;
+    case EXP_LIST: {
+        int d = p->datums++;
+        out(w, "{\n%*sList d%d = VECTOR_INIT();\n", indent * 4 + 4, "", d);
+        for (size_t i = 0; i < AS_LIST(x).size; i++) {
+            char elem[32];
+            snprintf(elem, sizeof(elem), "e%d", p->datums++);
+            out(w, "%*sExp %s;\n", indent * 4 + 4, "", elem);
+            build_datum(p, w, AS_LIST(x).data[i], elem, indent + 1);
+            out(w, "%*slist_add(interp, &d%d, %s);\n", indent * 4 + 4, "", d, elem);
+        }
+        out(w, "%*s%s = mklist(interp, d%d);\n%*s}\n", indent * 4 + 4, "", into, d,
+            indent * 4, "");
+        break;
+    }
+    default:
+        die(p->interp, "compile: can't embed a constant of type %d\n", x.type);
+    }
+}
+
+// Compile a top-level form into the body of run(), or leave it to the
+// interpreter if it can't be compiled.
+static void compile_toplevel(Program *p, Exp form, Writer *w)
+{
+    comment(w, form);
+    List l = form.type == EXP_LIST ? AS_LIST(form) : (List) VECTOR_INIT();
+    Known *k = form.type == EXP_LIST && known_definition(p->interp, l)
+        ? find_known(p, l.data[1]) : NULL;
+    if (k && k->compiled) {
+        out(w, "    defined[%zu] = true;\n    interp_define(interp, ", (size_t) (k - p->known));
+        c_string(w, AS_SYM(k->name));
+        out(w, ", mkcproc(proc_%zu_entry));\n", (size_t) (k - p->known));
+        return;
+    }
+    Writer code;
+    writer_init(&code, -1, 256);
+    Gen g = { .prog = p, .w = &code, .indent = 2 };
+    bool define = l.size == 3 && is_form(l.data[0], "define")
+        && is_symbol(l.data[1]);
+    Val v = compile(&g, define ? l.data[2] : form, false);
+    if (!g.failed && !v.jump) {
+        out(w, "    gc_maybe_collect(interp);\n    {\n");
+        writer_write(w, code.buf, code.len);
+        if (define) {
+            out(w, "        interp_define(interp, ");
+            c_string(w, AS_SYM(l.data[1]));
+            out(w, ", %s);\n", as(v, false).c);
+        } else {
+            out(w, "        show(interp, %s);\n", as(v, false).c);
+        }
+        out(w, "    }\n");
+    } else {
+        out(w, "    eval_form(interp, lit[%zu]);\n", intern(p, &p->lits, form));
+    }
+    writer_free(&code);
+    free_gen(&g);
+}
+
+static const char *prelude =
+    "#include \"scheme.h\"\n"
+    "#include \"gcobject.h\"\n"
+    "#include \"ht.h\"\n"
+    "\n"
+    "#define VOID_EXP ((Exp) { .type = EXP_VOID })\n"
+    "\n"
+    "static inline noreturn void undefined(Interp *interp, Exp name)\n"
+    "{\n"
+    "    die(interp, \"undefined symbol: %s\\n\", AS_SYM(name));\n"
+    "}\n"
+    "\n"
+    "static inline Exp global_ref(Interp *interp, Exp name)\n"
+    "{\n"
+    "    Exp value;\n"
+    "    if (!ht_lookup(&ENV_HT(interp->global), name, &value)) {\n"
+    "        undefined(interp, name);\n"
+    "    }\n"
+    "    return value;\n"
+    "}\n"
+    "\n"
+    "// Raise a stack overflow past the limit run() set, as proc_call does.\n"
+    "static inline void check_stack(Interp *interp)\n"
+    "{\n"
+    "    if ((uintptr_t) __builtin_frame_address(0) < interp->stack_limit) {\n"
+    "        stack_overflow(interp);\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "static inline Exp proc_ref(Interp *interp, Exp proc)\n"
+    "{\n"
+    "    if (!is_proc(proc)) {\n"
+    "        die(interp, \"error: not a procedure\\n\");\n"
+    "    }\n"
+    "    return proc;\n"
+    "}\n"
+    "\n"
+    "static inline Exp call(Interp *interp, Exp proc, List args)\n"
+    "{\n"
+    "    return proc.type == EXP_C_PROC ? proc.cproc(interp, args)\n"
+    "                                   : proc_call(interp, &AS_PROC(proc), args);\n"
+    "}\n"
+    "\n"
+    "// Print the value of a top-level form.\n"
+    "static inline void show(Interp *interp, Exp val)\n"
+    "{\n"
+    "    print_to(interp->out, val);\n"
+    "    if (val.type != EXP_VOID && val.type != EXP_EMPTY) {\n"
+    "        writer_putc(interp->out, '\\n');\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "// Run a form the compiler left to the interpreter.\n"
+    "static inline void eval_form(Interp *interp, Exp form)\n"
+    "{\n"
+    "    Exp val = interp_eval(interp, form);\n"
+    "    show(interp, val);\n"
+    "    interp_unpin(interp, val);\n"
+    "}\n"
+    "\n";
+
+void compile_script(Interp *interp, const char *src, const char *name, Writer *w)
+{
+    Exp forms = interp_parse(interp, src);
+    List l = AS_LIST(forms);
+    // the whole script is expanded and scanned first, as by exec_string
+    for (size_t i = 0; i < l.size; i++) {
+        l.data[i] = expand(interp, l.data[i]);
+    }
+    for (size_t i = 0; i < l.size; i++) {
+        note_definitions(interp, l.data[i]);
+    }
+    if (interp->optimize) {
+        for (size_t i = 0; i < l.size; i++) {
+            l.data[i] = optimize(interp, l.data[i]);
+        }
+        for (size_t i = 0; i < l.size; i++) {
+            note_definitions(interp, l.data[i]);
+        }
+    }
+
+    Program p = { .interp = interp, .syms = VECTOR_INIT(), .lits = VECTOR_INIT(),
+                  .prims = VECTOR_INIT() };
+    for (size_t i = 0; i < l.size; i++) {
+        if (l.data[i].type == EXP_LIST && known_definition(interp, AS_LIST(l.data[i]))) {
+            p.known = grow(p.known, sizeof(Known) * (p.nknown + 1));
+            p.known[p.nknown++] = (Known) {
+                .name = AS_LIST(l.data[i]).data[1], .lambda = AS_LIST(l.data[i]).data[2],
+                .compiled = true, .numeric = true,
+            };
+        }
+    }
+
+    // a procedure is only compiled if every known procedure it calls is,
+    // and only has a version on doubles if those it calls do too.
+    Writer scratch;
+    writer_init(&scratch, -1, 1024);
+    for (int numeric = 0; numeric <= 1; numeric++) {
+        bool changed;
+        do {
+            changed = false;
+            for (size_t i = 0; i < p.nknown; i++) {
+                Known *k = &p.known[i];
+                bool *flag = numeric ? &k->numeric : &k->compiled;
+                k->numeric = k->numeric && k->compiled;
+                if (*flag && !compile_proc(&p, k, numeric, &scratch)) {
+                    *flag = false;
+                    changed = true;
+                }
+                writer_clear(&scratch);
+            }
+        } while (changed);
+    }
+    writer_free(&scratch);
+
+    Writer procs, run, init;
+    writer_init(&procs, -1, 4096);
+    writer_init(&run, -1, 4096);
+    writer_init(&init, -1, 4096);
+    for (size_t i = 0; i < p.nknown; i++) {
+        Known *k = &p.known[i];
+        if (!k->compiled) {
+            continue;
+        }
+        if (k->numeric) {
+            compile_proc(&p, k, true, &procs);
+        }
+        compile_proc(&p, k, false, &procs);
+        out(&procs, "static Exp proc_%zu_entry(Interp *interp, List args)\n{\n"
+                    "    if (args.size != %zu) {\n"
+                    "        die(interp, \"%%s: arity mismatch\\n\", ", i, known_arity(k));
+        c_string(&procs, AS_SYM(k->name));
+        out(&procs, ");\n    }\n    return proc_%zu(interp", i);
+        for (size_t j = 0; j < known_arity(k); j++) {
+            out(&procs, ", args.data[%zu]", j);
+        }
+        out(&procs, ");\n}\n\n");
+    }
+    for (size_t i = 0; i < l.size; i++) {
+        if (l.data[i].type != EXP_VOID) {
+            compile_toplevel(&p, l.data[i], &run);
+        }
+    }
+    for (size_t i = 0; i < p.lits.size; i++) {
+        char into[32];
+        snprintf(into, sizeof(into), "lit[%zu]", i);
+        build_datum(&p, &init, p.lits.data[i], into, 1);
+        out(&init, "    interp_pin(interp, lit[%zu]);\n", i);
+    }
+    for (size_t i = 0; i < p.prims.size; i++) {
+        out(&init, "    prim[%zu] = global_ref(interp, sym[%zu]).cproc;\n", i,
+            intern(&p, &p.syms, p.prims.data[i]));
+    }
+
+    out(w, "// Compiled from %s by scheme -c.\n\n", name);
+    writer_puts(w, prelude);
+    if (p.syms.size > 0) {
+        out(w, "static Exp sym[%zu];\n", p.syms.size);
+    }
+    if (p.lits.size > 0) {
+        out(w, "static Exp lit[%zu];\n", p.lits.size);
+    }
+    if (p.prims.size > 0) {
+        out(w, "static CProc prim[%zu];\n", p.prims.size);
+    }
+    // set by the definitions of compiled procedures, which the calls to
+    // them check
+    size_t ncompiled = 0;
+    for (size_t i = 0; i < p.nknown; i++) {
+        ncompiled += p.known[i].compiled;
+    }
+    if (ncompiled > 0) {
+        out(w, "static bool defined[%zu];\n", p.nknown);
+    }
+    writer_putc(w, '\n');
+    for (size_t i = 0; i < p.nknown; i++) {
+        if (p.known[i].compiled) {
+            for (int numeric = p.known[i].numeric; numeric >= 0; numeric--) {
+                out(w, "static %s proc_%zu%s", type_of(numeric), i, numeric ? "_num" : "");
+                params_decl(w, &p.known[i], numeric);
+                out(w, ";\n");
+            }
+        }
+    }
+    writer_puts(w, "\n");
+    writer_write(w, procs.buf, procs.len);
+    out(w, "static void init(Interp *interp)\n{\n");
+    for (size_t i = 0; i < p.syms.size; i++) {
+        out(w, "    sym[%zu] = interp_symbol(interp, ", i);
+        c_string(w, AS_SYM(p.syms.data[i]));
+        out(w, ");\n    interp_pin(interp, sym[%zu]);\n", i);
+    }
+    writer_write(w, init.buf, init.len);
+    out(w, "}\n\nstatic void run(Interp *interp)\n{\n    stack_enter(interp);\n");
+    writer_write(w, run.buf, run.len);
+    out(w, "}\n\n"
+           "int main(void)\n"
+           "{\n"
+           "    Interp *interp = interp_new();\n"
+           "    // forms left to the interpreter were optimized when compiled\n"
+           "    interp->optimize = false;\n"
+           "    init(interp);\n"
+           "    run(interp);\n"
+           "    interp_free(interp);\n"
+           "    return 0;\n"
+           "}\n");
+
+    writer_free(&procs);
+    writer_free(&run);
+    writer_free(&init);
+    list_free(interp, &p.syms);
+    list_free(interp, &p.lits);
+    list_free(interp, &p.prims);
+    free(p.known);
+    interp_unpin(interp, forms);
+}
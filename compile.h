@@ -0,0 +1,9 @@
+#pragma once
+
+#include "scheme.h"
+
+// Translate the script src, read from the file name, into the C source of a
+// program that runs it, and append that to out (an in-memory Writer).
+// The program is compiled and linked with every object of the interpreter
+// except main.c's (see make aot).
+void compile_script(Interp *interp, const char *src, const char *name, Writer *out);
@@ -1,303 +1,1310 @@
 // All scheme procedures that are inside the standard environment.
 
-Exp scheme_sum(List args)
+Exp scheme_sum(Interp *interp, List args)
 {
     double sum = 0;
     for (size_t i = 0; i < args.size; i++) {
-        if (!is_number(args.data[i])) die("+: not a number\n");
+        if (!is_number(args.data[i])) die(interp, "+: not a number\n");
         sum += args.data[i].number;
     }
     return mknum(sum);
 }
 
-Exp scheme_sub(List args)
+Exp scheme_sub(Interp *interp, List args)
 {
-    if (args.size == 0) die("-: arity mismatch\n");
-    if (!is_number(args.data[0])) die("-: not a number\n");
+    if (args.size == 0) die(interp, "-: arity mismatch\n");
+    if (!is_number(args.data[0])) die(interp, "-: not a number\n");
     if (args.size == 1) {
         return mknum(-args.data[0].number);
     }
     double sub = args.data[0].number;
     for (size_t i = 1; i < args.size; i++) {
-        if (!is_number(args.data[i])) die("-: not a number\n");
+        if (!is_number(args.data[i])) die(interp, "-: not a number\n");
         sub -= args.data[i].number;
     }
     return mknum(sub);
 }
 
-Exp scheme_mul(List args)
+Exp scheme_mul(Interp *interp, List args)
 {
     double mul = 1;
     for (size_t i = 0; i < args.size; i++) {
-        if (!is_number(args.data[i])) die("*: not a number\n");
+        if (!is_number(args.data[i])) die(interp, "*: not a number\n");
         mul *= args.data[i].number;
     }
     return mknum(mul);
 }
 
-Exp scheme_abs(List args)
+Exp scheme_abs(Interp *interp, List args)
 {
-    if (args.size != 1) die("=: arity mismatch\n");
-    if (!is_number(args.data[0])) die("=: not a number\n");
+    if (args.size != 1) die(interp, "=: arity mismatch\n");
+    if (!is_number(args.data[0])) die(interp, "=: not a number\n");
     return mknum(fabs(args.data[0].number));
 }
 
-Exp scheme_gt(List args)
+Exp scheme_gt(Interp *interp, List args)
 {
-    if (args.size == 0) die(">: arity mismatch\n");
+    if (args.size == 0) die(interp, ">: arity mismatch\n");
     if (args.size == 1) return SCHEME_TRUE;
     if (!is_number(args.data[0]) || !is_number(args.data[1]))
-        die(">: not a number\n");
+        die(interp, ">: not a number\n");
     return mknum(args.data[0].number > args.data[1].number);
 }
 
-Exp scheme_lt(List args)
+Exp scheme_lt(Interp *interp, List args)
 {
-    if (args.size == 0) die("<: arity mismatch\n");
+    if (args.size == 0) die(interp, "<: arity mismatch\n");
     if (args.size == 1) return SCHEME_TRUE;
     if (!is_number(args.data[0]) || !is_number(args.data[1]))
-        die("<: not a number\n");
+        die(interp, "<: not a number\n");
     return mknum(args.data[0].number < args.data[1].number);
 }
 
-Exp scheme_ge(List args)
+Exp scheme_ge(Interp *interp, List args)
 {
-    if (args.size == 0) die(">=: arity mismatch\n");
+    if (args.size == 0) die(interp, ">=: arity mismatch\n");
     if (args.size == 1) return SCHEME_TRUE;
     if (!is_number(args.data[0]) || !is_number(args.data[1]))
-        die(">=: not a number\n");
+        die(interp, ">=: not a number\n");
     return mknum(args.data[0].number >= args.data[1].number);
 }
 
-Exp scheme_le(List args)
+Exp scheme_le(Interp *interp, List args)
 {
-    if (args.size == 0) die("<=: arity mismatch\n");
+    if (args.size == 0) die(interp, "<=: arity mismatch\n");
     if (args.size == 1) return SCHEME_TRUE;
     if (!is_number(args.data[0]) || !is_number(args.data[1]))
-        die("<=: not a number\n");
+        die(interp, "<=: not a number\n");
     return mknum(args.data[0].number <= args.data[1].number);
 }
 
-Exp scheme_eq(List args)
+Exp scheme_eq(Interp *interp, List args)
 {
-    if (args.size == 0) die("=: arity mismatch\n");
+    if (args.size == 0) die(interp, "=: arity mismatch\n");
     if (args.size == 1) return SCHEME_TRUE;
     if (!is_number(args.data[0]) || !is_number(args.data[1]))
-        die("=: not a number\n");
+        die(interp, "=: not a number\n");
     return mknum(args.data[0].number == args.data[1].number);
 }
 
-Exp scheme_not(List args)
+Exp scheme_not(Interp *interp, List args)
 {
-    if (args.size != 1) die("not: arity mismatch\n");
+    if (args.size != 1) die(interp, "not: arity mismatch\n");
     if (!is_number(args.data[0])) {
         return SCHEME_FALSE;
     }
     return mknum(args.data[0].number == 0 ? 1 : 0);
 }
 
-Exp scheme_and(List args)
+Exp scheme_begin(Interp *interp, List args)
 {
-    for (size_t i = 0; i < args.size; i++) {
-        if (is_number(args.data[i]) && args.data[i].number == 0) {
-            return SCHEME_FALSE;
-        }
-    }
+    if (args.size == 0) die(interp, "begin: arity mismatch\n");
     return args.data[args.size-1];
 }
 
-Exp scheme_or(List args)
+// An empty list object with room for cap elements. A short one only needs
+// the room mklist makes in the object.
+static Exp mklist_with_cap(Interp *interp, size_t cap)
 {
-    for (size_t i = 0; i < args.size; i++) {
-        if (!is_number(args.data[i]) || args.data[i].number != 0) {
-            return args.data[i];
-        }
+    List l = VECTOR_INIT();
+    l.cap = cap;
+    if (cap > LIST_INLINE_MAX) {
+        l.data = ALLOCATE(interp, Exp, cap);
     }
-    return SCHEME_FALSE;
+    return mklist(interp, l);
 }
 
-Exp scheme_begin(List args)
+Exp scheme_list(Interp *interp, List args)
 {
-    if (args.size == 0) die("begin: arity mismatch\n");
-    return args.data[args.size-1];
-}
-
-Exp scheme_list(List args)
-{
-    List new_list = VECTOR_INIT();
+    Exp res = mklist_with_cap(interp, args.size);
+    List *l = &AS_LIST(res);
     for (size_t i = 0; i < args.size; i++) {
-        list_add(&new_list, args.data[i]);
+        l->data[l->size++] = args.data[i];
     }
-    return mklist(new_list);
+    return res;
 }
 
-Exp scheme_cons(List args)
+Exp scheme_cons(Interp *interp, List args)
 {
-    if (args.size != 2) die("cons: arity mismatch\n");
-    if (args.data[1].type != EXP_LIST) die("cons: second arg must be a list\n");
-    List res = VECTOR_INIT();
-    list_add(&res, args.data[0]);
-    for (size_t i = 0; i < AS_LIST(args.data[1]).size; i++) {
-        list_add(&res, AS_LIST(args.data[1]).data[i]);
+    if (args.size != 2) die(interp, "cons: arity mismatch\n");
+    if (args.data[1].type != EXP_LIST) die(interp, "cons: second arg must be a list\n");
+    List tail = AS_LIST(args.data[1]);
+    Exp res = mklist_with_cap(interp, tail.size + 1);
+    List *l = &AS_LIST(res);
+    l->data[l->size++] = args.data[0];
+    for (size_t i = 0; i < tail.size; i++) {
+        l->data[l->size++] = tail.data[i];
     }
-    return mklist(res);
+    return res;
 }
 
-Exp scheme_car(List args)
+Exp scheme_car(Interp *interp, List args)
 {
-    if (args.size != 1) die("car: arity mismatch\n");
-    if (args.data[0].type != EXP_LIST) die("car: expected list\n");
+    if (args.size != 1) die(interp, "car: arity mismatch\n");
+    if (args.data[0].type != EXP_LIST) die(interp, "car: expected list\n");
     return AS_LIST(args.data[0]).data[0];
 }
 
-Exp scheme_cdr(List args)
+Exp scheme_cdr(Interp *interp, List args)
 {
-    if (args.size != 1) die("cdr: arity mismatch\n");
-    if (args.data[0].type != EXP_LIST) die("cdr: expected list\n");
-    List res = VECTOR_INIT();
-    for (size_t i = 1; i < AS_LIST(args.data[0]).size; i++) {
-        list_add(&res, AS_LIST(args.data[0]).data[i]);
+    if (args.size != 1) die(interp, "cdr: arity mismatch\n");
+    if (args.data[0].type != EXP_LIST) die(interp, "cdr: expected list\n");
+    List lst = AS_LIST(args.data[0]);
+    Exp res = mklist_with_cap(interp, lst.size > 0 ? lst.size - 1 : 0);
+    List *l = &AS_LIST(res);
+    for (size_t i = 1; i < lst.size; i++) {
+        l->data[l->size++] = lst.data[i];
     }
-    return mklist(res);
+    return res;
 }
 
-Exp scheme_length(List args)
+Exp scheme_length(Interp *interp, List args)
 {
-    if (args.size != 1) die("length: arity mismatch\n");
-    if (args.data[0].type != EXP_LIST) die("length: not a list\n");
+    if (args.size != 1) die(interp, "length: arity mismatch\n");
+    if (args.data[0].type != EXP_LIST) die(interp, "length: not a list\n");
     return mknum(AS_LIST(args.data[0]).size);
 }
 
-Exp scheme_is_null(List args)
+Exp scheme_is_null(Interp *interp, List args)
 {
-    if (args.size != 1) die("length: arity mismatch\n");
+    if (args.size != 1) die(interp, "length: arity mismatch\n");
     return args.data[0].type != EXP_LIST
         ? SCHEME_FALSE
         : mknum(AS_LIST(args.data[0]).size == 0);
 }
 
-Exp scheme_is_eq(List args)
+// Symbols aren't interned, so two symbols are eq? when their names match.
+bool exp_eq(Exp first, Exp second)
 {
-    if (args.size != 2) die("eq?: arity mismatch\n");
-    if (args.data[0].type != args.data[1].type) {
-        return SCHEME_FALSE;
+    if (first.type != second.type) {
+        return false;
     }
-    Exp first = args.data[0], second = args.data[1];
     switch (first.type) {
-    case EXP_EMPTY:  return SCHEME_TRUE;
-    case EXP_NUMBER: return mknum(first.number == second.number);
-    case EXP_SYMBOL:
+    case EXP_EMPTY:  return true;
+    case EXP_NUMBER: return first.number == second.number;
+    case EXP_SYMBOL: return first.obj == second.obj
+                         || strcmp(AS_SYM(first), AS_SYM(second)) == 0;
     case EXP_LIST:
-    case EXP_PROC:   return mknum(first.obj == second.obj);
-    case EXP_C_PROC: return mknum(first.cproc == second.cproc);
-    case EXP_VOID:   return SCHEME_TRUE;
-    case EXP_EOF:    return SCHEME_TRUE;
+    case EXP_VECTOR:
+    case EXP_HASH_TABLE:
+    case EXP_CONDITION:
+    case EXP_BOX:
+    case EXP_PROMISE:
+    case EXP_FUTURE:
+    case EXP_THREAD:
+    case EXP_CHANNEL:
+    case EXP_PROC:   return first.obj == second.obj;
+    case EXP_C_PROC: return first.cproc == second.cproc;
+    case EXP_VOID:   return true;
+    case EXP_EOF:    return true;
     }
-    return SCHEME_FALSE;
+    return false;
 }
 
-static Exp list_equal(Exp first, Exp second)
+Exp scheme_is_eq(Interp *interp, List args)
 {
-    if (AS_LIST(first).size != AS_LIST(second).size) {
-        return SCHEME_FALSE;
+    if (args.size != 2) die(interp, "eq?: arity mismatch\n");
+    return mknum(exp_eq(args.data[0], args.data[1]));
+}
+
+static bool elements_equal(List first, List second)
+{
+    if (first.size != second.size) {
+        return false;
     }
-    for (size_t i = 0; i < AS_LIST(first).size; i++) {
-        Exp res = list_equal(AS_LIST(first).data[i], AS_LIST(second).data[i]);
-        if (res.number == 0) {
-            return SCHEME_FALSE;
+    for (size_t i = 0; i < first.size; i++) {
+        if (!exp_equal(first.data[i], second.data[i])) {
+            return false;
         }
     }
-    return SCHEME_TRUE;
+    return true;
 }
 
-Exp scheme_equal(List args)
+bool exp_equal(Exp first, Exp second)
 {
-    if (args.size != 2) die("equal?: arity mismatch\n");
-    if (args.data[0].type != args.data[1].type) {
-        return SCHEME_FALSE;
+    if (first.type != second.type) {
+        return false;
     }
-    switch (args.data[0].type) {
-    case EXP_EMPTY:
-    case EXP_NUMBER:
-    case EXP_C_PROC:
-    case EXP_PROC:
-    case EXP_VOID:
-    case EXP_EOF:
-        return scheme_is_eq(args);
-    case EXP_SYMBOL:
-        return mknum(strcmp(AS_SYM(args.data[0]), AS_SYM(args.data[1])) == 0);
+    switch (first.type) {
     case EXP_LIST:
-        return list_equal(args.data[0], args.data[1]);
+        return elements_equal(AS_LIST(first), AS_LIST(second));
+    case EXP_VECTOR:
+        return elements_equal(AS_VECTOR(first), AS_VECTOR(second));
+    default:
+        return exp_eq(first, second);
     }
-    return SCHEME_FALSE;
+}
+
+Exp scheme_equal(Interp *interp, List args)
+{
+    if (args.size != 2) die(interp, "equal?: arity mismatch\n");
+    return mknum(exp_equal(args.data[0], args.data[1]));
 }
 
 // (append . lst)
-Exp scheme_append(List args)
+Exp scheme_append(Interp *interp, List args)
 {
     List res = VECTOR_INIT();
     for (size_t i = 0; i < args.size; i++) {
         if (args.data[i].type != EXP_LIST) {
-            die("append: argument #%d is not a list\n", i);
+            die(interp, "append: argument #%d is not a list\n", i);
         }
         for (size_t j = 0; j < AS_LIST(args.data[i]).size; j++) {
-            list_add(&res, AS_LIST(args.data[i]).data[j]);
+            list_add(interp, &res, AS_LIST(args.data[i]).data[j]);
         }
     }
-    return mklist(res);
+    return mklist(interp, res);
 }
 
 // (apply proc lst)
-Exp scheme_apply(List args)
+Exp scheme_apply(Interp *interp, List args)
 {
-    if (args.size != 2) die("apply: arity mismatch\n");
+    if (args.size != 2) die(interp, "apply: arity mismatch\n");
     if (args.data[0].type != EXP_C_PROC && args.data[0].type != EXP_PROC) {
-        die("apply: argument #1 must be a procedure\n");
+        die(interp, "apply: argument #1 must be a procedure\n");
     }
     if (args.data[1].type != EXP_LIST) {
-        die("apply: argument #2 must be a list\n");
+        die(interp, "apply: argument #2 must be a list\n");
     }
     Exp proc = args.data[0];
     List proc_args = AS_LIST(args.data[1]);
-    return proc.type == EXP_C_PROC ? proc.cproc(proc_args)
-                                   : proc_call(&AS_PROC(proc), proc_args);
+    return proc.type == EXP_C_PROC ? proc.cproc(interp, proc_args)
+                                   : proc_call(interp, &AS_PROC(proc), proc_args);
+}
+
+// Higher-order and searching list procedures.
+// These work directly on the List arrays: results are allocated once with
+// the right capacity, and procedure arguments are passed through one
+// argument list reused for every call.
+
+// Call a procedure value with an argument list.
+static Exp call_proc(Interp *interp, Exp proc, List args)
+{
+    return proc.type == EXP_C_PROC ? proc.cproc(interp, args)
+                                   : proc_call(interp, &AS_PROC(proc), args);
+}
+
+// Copy of the elements of lst starting from index start.
+static List elements_copy_from(Interp *interp, List lst, size_t start)
+{
+    List res = VECTOR_INIT();
+    size_t size = start < lst.size ? lst.size - start : 0;
+    if (size > 0) {
+        res.data = ALLOCATE(interp, Exp, size);
+        res.cap = res.size = size;
+        memcpy(res.data, lst.data + start, sizeof(Exp) * size);
+    }
+    return res;
+}
+
+static Exp list_copy_from(Interp *interp, List lst, size_t start)
+{
+    return mklist(interp, elements_copy_from(interp, lst, start));
+}
+
+// Check that args[from..] are all lists and return the shortest length.
+static size_t check_lists(Interp *interp, List args, size_t from, const char *name)
+{
+    size_t len = SIZE_MAX;
+    for (size_t i = from; i < args.size; i++) {
+        if (args.data[i].type != EXP_LIST) {
+            die(interp, "%s: argument #%zu is not a list\n", name, i + 1);
+        }
+        if (AS_LIST(args.data[i]).size < len) {
+            len = AS_LIST(args.data[i]).size;
+        }
+    }
+    return len;
+}
+
+// Fill call_args with the i-th element of each list in args[from..].
+static void gather_args(List *call_args, List args, size_t from, size_t i)
+{
+    for (size_t j = from; j < args.size; j++) {
+        call_args->data[j - from] = AS_LIST(args.data[j]).data[i];
+    }
+}
+
+// (map proc lst1 lst2 ...)
+Exp scheme_map(Interp *interp, List args)
+{
+    if (args.size < 2) die(interp, "map: arity mismatch\n");
+    if (!is_proc(args.data[0])) die(interp, "map: argument #1 must be a procedure\n");
+    size_t len = check_lists(interp, args, 1, "map");
+    Exp res = mklist_with_cap(interp, len);
+    save(interp, res);
+    Exp call_args = mklist_with_cap(interp, args.size - 1);
+    save(interp, call_args);
+    AS_LIST(call_args).size = args.size - 1;
+    for (size_t i = 0; i < len; i++) {
+        gather_args(&AS_LIST(call_args), args, 1, i);
+        Exp elem = call_proc(interp, args.data[0], AS_LIST(call_args));
+        AS_LIST(res).data[AS_LIST(res).size++] = elem;
+    }
+    unsave(interp, call_args);
+    unsave(interp, res);
+    return res;
+}
+
+// (for-each proc lst1 lst2 ...)
+Exp scheme_for_each(Interp *interp, List args)
+{
+    if (args.size < 2) die(interp, "for-each: arity mismatch\n");
+    if (!is_proc(args.data[0])) die(interp, "for-each: argument #1 must be a procedure\n");
+    size_t len = check_lists(interp, args, 1, "for-each");
+    Exp call_args = mklist_with_cap(interp, args.size - 1);
+    save(interp, call_args);
+    AS_LIST(call_args).size = args.size - 1;
+    for (size_t i = 0; i < len; i++) {
+        gather_args(&AS_LIST(call_args), args, 1, i);
+        call_proc(interp, args.data[0], AS_LIST(call_args));
+    }
+    unsave(interp, call_args);
+    return (Exp) { .type = EXP_VOID };
+}
+
+// (filter pred lst)
+Exp scheme_filter(Interp *interp, List args)
+{
+    if (args.size != 2) die(interp, "filter: arity mismatch\n");
+    if (!is_proc(args.data[0])) die(interp, "filter: argument #1 must be a procedure\n");
+    size_t len = check_lists(interp, args, 1, "filter");
+    Exp res = mklist_with_cap(interp, len);
+    save(interp, res);
+    Exp call_args = mklist_with_cap(interp, 1);
+    save(interp, call_args);
+    AS_LIST(call_args).size = 1;
+    for (size_t i = 0; i < len; i++) {
+        Exp elem = AS_LIST(args.data[1]).data[i];
+        AS_LIST(call_args).data[0] = elem;
+        if (is_true(call_proc(interp, args.data[0], AS_LIST(call_args)))) {
+            AS_LIST(res).data[AS_LIST(res).size++] = elem;
+        }
+    }
+    unsave(interp, call_args);
+    unsave(interp, res);
+    return res;
+}
+
+// (fold-left proc init lst1 lst2 ...): (proc (proc init e1) e2) ...
+Exp scheme_fold_left(Interp *interp, List args)
+{
+    if (args.size < 3) die(interp, "fold-left: arity mismatch\n");
+    if (!is_proc(args.data[0])) die(interp, "fold-left: argument #1 must be a procedure\n");
+    size_t len = check_lists(interp, args, 2, "fold-left");
+    Exp acc = args.data[1];
+    Exp call_args = mklist_with_cap(interp, args.size - 1);
+    save(interp, call_args);
+    AS_LIST(call_args).size = args.size - 1;
+    for (size_t i = 0; i < len; i++) {
+        AS_LIST(call_args).data[0] = acc;
+        for (size_t j = 2; j < args.size; j++) {
+            AS_LIST(call_args).data[j - 1] = AS_LIST(args.data[j]).data[i];
+        }
+        acc = call_proc(interp, args.data[0], AS_LIST(call_args));
+    }
+    unsave(interp, call_args);
+    return acc;
+}
+
+// (fold-right proc init lst1 lst2 ...): (proc e1 (proc e2 ... init))
+Exp scheme_fold_right(Interp *interp, List args)
+{
+    if (args.size < 3) die(interp, "fold-right: arity mismatch\n");
+    if (!is_proc(args.data[0])) die(interp, "fold-right: argument #1 must be a procedure\n");
+    size_t len = check_lists(interp, args, 2, "fold-right");
+    size_t nlists = args.size - 2;
+    Exp acc = args.data[1];
+    Exp call_args = mklist_with_cap(interp, nlists + 1);
+    save(interp, call_args);
+    AS_LIST(call_args).size = nlists + 1;
+    for (size_t i = len; i-- > 0; ) {
+        gather_args(&AS_LIST(call_args), args, 2, i);
+        AS_LIST(call_args).data[nlists] = acc;
+        acc = call_proc(interp, args.data[0], AS_LIST(call_args));
+    }
+    unsave(interp, call_args);
+    return acc;
+}
+
+// (reduce proc ridentity lst): (proc e3 (proc e2 e1)) ...
+Exp scheme_reduce(Interp *interp, List args)
+{
+    if (args.size != 3) die(interp, "reduce: arity mismatch\n");
+    if (!is_proc(args.data[0])) die(interp, "reduce: argument #1 must be a procedure\n");
+    size_t len = check_lists(interp, args, 2, "reduce");
+    if (len == 0) {
+        return args.data[1];
+    }
+    Exp acc = AS_LIST(args.data[2]).data[0];
+    Exp call_args = mklist_with_cap(interp, 2);
+    save(interp, call_args);
+    AS_LIST(call_args).size = 2;
+    for (size_t i = 1; i < len; i++) {
+        AS_LIST(call_args).data[0] = AS_LIST(args.data[2]).data[i];
+        AS_LIST(call_args).data[1] = acc;
+        acc = call_proc(interp, args.data[0], AS_LIST(call_args));
+    }
+    unsave(interp, call_args);
+    return acc;
+}
+
+static size_t check_index(Interp *interp, Exp index, size_t size, const char *name)
+{
+    if (!is_number(index) || index.number < 0 || index.number != (size_t) index.number) {
+        die(interp, "%s: index must be a non-negative integer\n", name);
+    }
+    if ((size_t) index.number > size) {
+        die(interp, "%s: index out of range\n", name);
+    }
+    return (size_t) index.number;
+}
+
+// (list-ref lst k)
+Exp scheme_list_ref(Interp *interp, List args)
+{
+    if (args.size != 2) die(interp, "list-ref: arity mismatch\n");
+    if (args.data[0].type != EXP_LIST) die(interp, "list-ref: argument #1 is not a list\n");
+    List lst = AS_LIST(args.data[0]);
+    size_t k = check_index(interp, args.data[1], lst.size, "list-ref");
+    if (k == lst.size) die(interp, "list-ref: index out of range\n");
+    return lst.data[k];
+}
+
+// (list-tail lst k)
+Exp scheme_list_tail(Interp *interp, List args)
+{
+    if (args.size != 2) die(interp, "list-tail: arity mismatch\n");
+    if (args.data[0].type != EXP_LIST) die(interp, "list-tail: argument #1 is not a list\n");
+    List lst = AS_LIST(args.data[0]);
+    return list_copy_from(interp, lst, check_index(interp, args.data[1], lst.size, "list-tail"));
+}
+
+Exp scheme_reverse(Interp *interp, List args)
+{
+    if (args.size != 1) die(interp, "reverse: arity mismatch\n");
+    if (args.data[0].type != EXP_LIST) die(interp, "reverse: not a list\n");
+    List lst = AS_LIST(args.data[0]);
+    Exp res = mklist_with_cap(interp, lst.size);
+    for (size_t i = 0; i < lst.size; i++) {
+        AS_LIST(res).data[i] = lst.data[lst.size - 1 - i];
+    }
+    AS_LIST(res).size = lst.size;
+    return res;
+}
+
+static Exp find_assoc(Interp *interp, List args, bool (*same)(Exp, Exp), const char *name)
+{
+    if (args.size != 2) die(interp, "%s: arity mismatch\n", name);
+    if (args.data[1].type != EXP_LIST) die(interp, "%s: argument #2 is not a list\n", name);
+    List alist = AS_LIST(args.data[1]);
+    for (size_t i = 0; i < alist.size; i++) {
+        Exp pair = alist.data[i];
+        if (pair.type != EXP_LIST || AS_LIST(pair).size == 0) {
+            die(interp, "%s: argument #2 is not an association list\n", name);
+        }
+        if (same(args.data[0], AS_LIST(pair).data[0])) {
+            return pair;
+        }
+    }
+    return SCHEME_FALSE;
+}
+
+static Exp find_member(Interp *interp, List args, bool (*same)(Exp, Exp), const char *name)
+{
+    if (args.size != 2) die(interp, "%s: arity mismatch\n", name);
+    if (args.data[1].type != EXP_LIST) die(interp, "%s: argument #2 is not a list\n", name);
+    List lst = AS_LIST(args.data[1]);
+    for (size_t i = 0; i < lst.size; i++) {
+        if (same(args.data[0], lst.data[i])) {
+            return list_copy_from(interp, lst, i);
+        }
+    }
+    return SCHEME_FALSE;
+}
+
+// (assoc key alist), (assq key alist)
+Exp scheme_assoc(Interp *interp, List args) { return find_assoc(interp, args, exp_equal, "assoc"); }
+Exp scheme_assq(Interp *interp, List args)  { return find_assoc(interp, args, exp_eq,    "assq"); }
+
+// (member x lst), (memq x lst)
+Exp scheme_member(Interp *interp, List args) { return find_member(interp, args, exp_equal, "member"); }
+Exp scheme_memq(Interp *interp, List args)   { return find_member(interp, args, exp_eq,    "memq"); }
+
+// (iota count [start [step]])
+Exp scheme_iota(Interp *interp, List args)
+{
+    if (args.size < 1 || args.size > 3) die(interp, "iota: arity mismatch\n");
+    for (size_t i = 0; i < args.size; i++) {
+        if (!is_number(args.data[i])) die(interp, "iota: not a number\n");
+    }
+    if (args.data[0].number < 0) die(interp, "iota: count must be non-negative\n");
+    size_t count = (size_t) args.data[0].number;
+    double start = args.size > 1 ? args.data[1].number : 0;
+    double step  = args.size > 2 ? args.data[2].number : 1;
+    Exp res = mklist_with_cap(interp, count);
+    for (size_t i = 0; i < count; i++) {
+        AS_LIST(res).data[i] = mknum(start + i * step);
+    }
+    AS_LIST(res).size = count;
+    return res;
+}
+
+// Stable merge sort over a List's array.
+// When the comparator is the built-in < or > and every element is a number,
+// numbers are compared directly and the comparator is never called.
+
+typedef struct SortCmp {
+    Interp *interp;
+    Exp proc;
+    Exp call_args;
+    enum { SORT_CALL, SORT_LT, SORT_GT } mode;
+} SortCmp;
+
+static bool sort_less(SortCmp *cmp, Exp a, Exp b)
+{
+    switch (cmp->mode) {
+    case SORT_LT: return a.number < b.number;
+    case SORT_GT: return a.number > b.number;
+    default:
+        AS_LIST(cmp->call_args).data[0] = a;
+        AS_LIST(cmp->call_args).data[1] = b;
+        return is_true(call_proc(cmp->interp, cmp->proc, AS_LIST(cmp->call_args)));
+    }
+}
+
+#define SORT_INSERTION_THRESHOLD 16
+
+static void merge_sort(SortCmp *cmp, Exp *data, Exp *tmp, size_t n)
+{
+    if (n <= SORT_INSERTION_THRESHOLD) {
+        for (size_t i = 1; i < n; i++) {
+            Exp x = data[i];
+            size_t j = i;
+            while (j > 0 && sort_less(cmp, x, data[j-1])) {
+                data[j] = data[j-1];
+                j--;
+            }
+            data[j] = x;
+        }
+        return;
+    }
+    size_t mid = n / 2;
+    merge_sort(cmp, data, tmp, mid);
+    merge_sort(cmp, data + mid, tmp, n - mid);
+    // already in order: nothing to merge
+    if (!sort_less(cmp, data[mid], data[mid-1])) {
+        return;
+    }
+    memcpy(tmp, data, sizeof(Exp) * mid);
+    size_t i = 0, j = mid, k = 0;
+    while (i < mid && j < n) {
+        // take from the right run only when strictly less, to stay stable
+        data[k++] = sort_less(cmp, data[j], tmp[i]) ? data[j++] : tmp[i++];
+    }
+    while (i < mid) {
+        data[k++] = tmp[i++];
+    }
 }
 
-Exp scheme_is_list(List args)
+static void sort_list(Interp *interp, List *lst, Exp proc, const char *name)
 {
-    if (args.size != 1) die("list?: arity mismatch\n");
+    if (!is_proc(proc)) die(interp, "%s: argument #2 must be a procedure\n", name);
+    SortCmp cmp = { .interp = interp, .proc = proc, .mode = SORT_CALL };
+    if (proc.type == EXP_C_PROC
+     && (proc.cproc == scheme_lt || proc.cproc == scheme_gt)) {
+        bool all_numbers = true;
+        for (size_t i = 0; i < lst->size && all_numbers; i++) {
+            all_numbers = is_number(lst->data[i]);
+        }
+        if (all_numbers) {
+            cmp.mode = proc.cproc == scheme_lt ? SORT_LT : SORT_GT;
+        }
+    }
+    if (cmp.mode == SORT_CALL) {
+        cmp.call_args = mklist_with_cap(interp, 2);
+        AS_LIST(cmp.call_args).size = 2;
+        save(interp, cmp.call_args);
+    }
+    if (lst->size > 1) {
+        // keep the scratch space in an object, so that it's reclaimed
+        // even if the comparator raises an error
+        Exp tmp = mklist_with_cap(interp, lst->size / 2);
+        save(interp, tmp);
+        merge_sort(&cmp, lst->data, AS_LIST(tmp).data, lst->size);
+        unsave(interp, tmp);
+    }
+    if (cmp.mode == SORT_CALL) {
+        unsave(interp, cmp.call_args);
+    }
+}
+
+// (sort seq less?): a sorted copy of a list or vector
+Exp scheme_sort(Interp *interp, List args)
+{
+    if (args.size != 2) die(interp, "sort: arity mismatch\n");
+    Exp seq = args.data[0];
+    if (seq.type != EXP_LIST && seq.type != EXP_VECTOR) {
+        die(interp, "sort: argument #1 is not a list or vector\n");
+    }
+    Exp res = seq.type == EXP_LIST ? mklist(interp, elements_copy_from(interp, AS_LIST(seq), 0))
+                                   : mkvector(interp, elements_copy_from(interp, AS_VECTOR(seq), 0));
+    save(interp, res);
+    sort_list(interp, seq.type == EXP_LIST ? &AS_LIST(res) : &AS_VECTOR(res),
+              args.data[1], "sort");
+    unsave(interp, res);
+    return res;
+}
+
+// (sort! seq less?): sort a list or vector in place and return it
+Exp scheme_sort_in_place(Interp *interp, List args)
+{
+    if (args.size != 2) die(interp, "sort!: arity mismatch\n");
+    Exp seq = args.data[0];
+    if (seq.type != EXP_LIST && seq.type != EXP_VECTOR) {
+        die(interp, "sort!: argument #1 is not a list or vector\n");
+    }
+    sort_list(interp, seq.type == EXP_LIST ? &AS_LIST(seq) : &AS_VECTOR(seq),
+              args.data[1], "sort!");
+    return seq;
+}
+
+// Vectors: fixed-position element access on the same array as List.
+
+static Exp check_vector(Interp *interp, Exp v, const char *name)
+{
+    if (v.type != EXP_VECTOR) die(interp, "%s: argument #1 is not a vector\n", name);
+    return v;
+}
+
+static Exp mkvector_filled(Interp *interp, size_t size, Exp fill)
+{
+    List v = VECTOR_INIT();
+    if (size > 0) {
+        v.data = ALLOCATE(interp, Exp, size);
+        v.cap = v.size = size;
+        for (size_t i = 0; i < size; i++) {
+            v.data[i] = fill;
+        }
+    }
+    return mkvector(interp, v);
+}
+
+Exp scheme_is_vector(Interp *interp, List args)
+{
+    if (args.size != 1) die(interp, "vector?: arity mismatch\n");
+    return mknum(args.data[0].type == EXP_VECTOR);
+}
+
+// (make-vector k [fill])
+Exp scheme_make_vector(Interp *interp, List args)
+{
+    if (args.size != 1 && args.size != 2) die(interp, "make-vector: arity mismatch\n");
+    size_t size = check_index(interp, args.data[0], SIZE_MAX, "make-vector");
+    return mkvector_filled(interp, size, args.size == 2 ? args.data[1] : SCHEME_FALSE);
+}
+
+// (vector . elems)
+Exp scheme_vector(Interp *interp, List args)
+{
+    return mkvector(interp, elements_copy_from(interp, args, 0));
+}
+
+Exp scheme_vector_length(Interp *interp, List args)
+{
+    if (args.size != 1) die(interp, "vector-length: arity mismatch\n");
+    return mknum(AS_VECTOR(check_vector(interp, args.data[0], "vector-length")).size);
+}
+
+// (vector-ref vec k)
+Exp scheme_vector_ref(Interp *interp, List args)
+{
+    if (args.size != 2) die(interp, "vector-ref: arity mismatch\n");
+    List v = AS_VECTOR(check_vector(interp, args.data[0], "vector-ref"));
+    size_t k = check_index(interp, args.data[1], v.size, "vector-ref");
+    if (k == v.size) die(interp, "vector-ref: index out of range\n");
+    return v.data[k];
+}
+
+// (vector-set! vec k obj)
+Exp scheme_vector_set(Interp *interp, List args)
+{
+    if (args.size != 3) die(interp, "vector-set!: arity mismatch\n");
+    List *v = &AS_VECTOR(check_vector(interp, args.data[0], "vector-set!"));
+    size_t k = check_index(interp, args.data[1], v->size, "vector-set!");
+    if (k == v->size) die(interp, "vector-set!: index out of range\n");
+    v->data[k] = args.data[2];
+    return (Exp) { .type = EXP_VOID };
+}
+
+// (vector-fill! vec obj)
+Exp scheme_vector_fill(Interp *interp, List args)
+{
+    if (args.size != 2) die(interp, "vector-fill!: arity mismatch\n");
+    List *v = &AS_VECTOR(check_vector(interp, args.data[0], "vector-fill!"));
+    for (size_t i = 0; i < v->size; i++) {
+        v->data[i] = args.data[1];
+    }
+    return (Exp) { .type = EXP_VOID };
+}
+
+// (vector-grow vec k): a new vector of size k starting with the elements of
+// vec; the remaining elements are #f.
+Exp scheme_vector_grow(Interp *interp, List args)
+{
+    if (args.size != 2) die(interp, "vector-grow: arity mismatch\n");
+    List v = AS_VECTOR(check_vector(interp, args.data[0], "vector-grow"));
+    size_t size = check_index(interp, args.data[1], SIZE_MAX, "vector-grow");
+    if (size < v.size) die(interp, "vector-grow: new size is smaller than the vector\n");
+    Exp res = mkvector_filled(interp, size, SCHEME_FALSE);
+    if (v.size > 0) {
+        memcpy(AS_VECTOR(res).data, v.data, sizeof(Exp) * v.size);
+    }
+    return res;
+}
+
+Exp scheme_vector_to_list(Interp *interp, List args)
+{
+    if (args.size != 1) die(interp, "vector->list: arity mismatch\n");
+    return mklist(interp, elements_copy_from(interp, AS_VECTOR(check_vector(interp, args.data[0], "vector->list")), 0));
+}
+
+Exp scheme_list_to_vector(Interp *interp, List args)
+{
+    if (args.size != 1) die(interp, "list->vector: arity mismatch\n");
+    if (args.data[0].type != EXP_LIST) die(interp, "list->vector: argument #1 is not a list\n");
+    return mkvector(interp, elements_copy_from(interp, AS_LIST(args.data[0]), 0));
+}
+
+// Hash tables. (make-hash-table) compares keys with equal?, while
+// (make-hash-table eq?) and (make-eq-hash-table) compare them with eq?.
+
+static HashTable *check_hash_table(Interp *interp, Exp t, const char *name)
+{
+    if (t.type != EXP_HASH_TABLE) die(interp, "%s: argument #1 is not a hash table\n", name);
+    return &AS_HT(t);
+}
+
+// (make-hash-table [equality])
+Exp scheme_make_hash_table(Interp *interp, List args)
+{
+    if (args.size > 1) die(interp, "make-hash-table: arity mismatch\n");
+    if (args.size == 0) {
+        return mkhashtable(interp, true);
+    }
+    Exp eq = args.data[0];
+    if (eq.type != EXP_C_PROC || (eq.cproc != scheme_is_eq && eq.cproc != scheme_equal)) {
+        die(interp, "make-hash-table: equality must be eq? or equal?\n");
+    }
+    return mkhashtable(interp, eq.cproc == scheme_equal);
+}
+
+Exp scheme_make_eq_hash_table(Interp *interp, List args)
+{
+    if (args.size != 0) die(interp, "make-eq-hash-table: arity mismatch\n");
+    return mkhashtable(interp, false);
+}
+
+Exp scheme_is_hash_table(Interp *interp, List args)
+{
+    if (args.size != 1) die(interp, "hash-table?: arity mismatch\n");
+    return mknum(args.data[0].type == EXP_HASH_TABLE);
+}
+
+// (hash-table-ref table key [failure]): failure is called when key is missing
+Exp scheme_hash_table_ref(Interp *interp, List args)
+{
+    if (args.size != 2 && args.size != 3) die(interp, "hash-table-ref: arity mismatch\n");
+    Exp value;
+    if (ht_lookup(check_hash_table(interp, args.data[0], "hash-table-ref"), args.data[1], &value)) {
+        return value;
+    }
+    if (args.size == 2) die(interp, "hash-table-ref: key not found\n");
+    if (!is_proc(args.data[2])) die(interp, "hash-table-ref: argument #3 must be a procedure\n");
+    return call_proc(interp, args.data[2], (List) VECTOR_INIT());
+}
+
+// (hash-table-ref/default table key default)
+Exp scheme_hash_table_ref_default(Interp *interp, List args)
+{
+    if (args.size != 3) die(interp, "hash-table-ref/default: arity mismatch\n");
+    Exp value;
+    return ht_lookup(check_hash_table(interp, args.data[0], "hash-table-ref/default"), args.data[1], &value)
+        ? value : args.data[2];
+}
+
+// (hash-table-set! table key value)
+Exp scheme_hash_table_set(Interp *interp, List args)
+{
+    if (args.size != 3) die(interp, "hash-table-set!: arity mismatch\n");
+    ht_install(check_hash_table(interp, args.data[0], "hash-table-set!"), args.data[1], args.data[2]);
+    return (Exp) { .type = EXP_VOID };
+}
+
+// (hash-table-delete! table key)
+Exp scheme_hash_table_delete(Interp *interp, List args)
+{
+    if (args.size != 2) die(interp, "hash-table-delete!: arity mismatch\n");
+    ht_delete(check_hash_table(interp, args.data[0], "hash-table-delete!"), args.data[1]);
+    return (Exp) { .type = EXP_VOID };
+}
+
+// (hash-table-contains? table key)
+Exp scheme_hash_table_contains(Interp *interp, List args)
+{
+    if (args.size != 2) die(interp, "hash-table-contains?: arity mismatch\n");
+    return mknum(ht_lookup(check_hash_table(interp, args.data[0], "hash-table-contains?"), args.data[1], NULL));
+}
+
+static Exp update_hash_table(Interp *interp, List args, bool has_default, const char *name)
+{
+    HashTable *tab = check_hash_table(interp, args.data[0], name);
+    if (!is_proc(args.data[2])) die(interp, "%s: argument #3 must be a procedure\n", name);
+    Exp value;
+    if (!ht_lookup(tab, args.data[1], &value)) {
+        if (args.size == 3) die(interp, "%s: key not found\n", name);
+        if (has_default) {
+            value = args.data[3];
+        } else {
+            if (!is_proc(args.data[3])) die(interp, "%s: argument #4 must be a procedure\n", name);
+            value = call_proc(interp, args.data[3], (List) VECTOR_INIT());
+        }
+    }
+    List call_args = { .size = 1, .cap = 1, .data = &value };
+    Exp res = call_proc(interp, args.data[2], call_args);
+    save(interp, res);
+    // the procedure may have resized the table, so look it up again
+    ht_install(&AS_HT(args.data[0]), args.data[1], res);
+    unsave(interp, res);
+    return (Exp) { .type = EXP_VOID };
+}
+
+// (hash-table-update! table key proc [failure])
+Exp scheme_hash_table_update(Interp *interp, List args)
+{
+    if (args.size != 3 && args.size != 4) die(interp, "hash-table-update!: arity mismatch\n");
+    return update_hash_table(interp, args, false, "hash-table-update!");
+}
+
+// (hash-table-update!/default table key proc default)
+Exp scheme_hash_table_update_default(Interp *interp, List args)
+{
+    if (args.size != 4) die(interp, "hash-table-update!/default: arity mismatch\n");
+    return update_hash_table(interp, args, true, "hash-table-update!/default");
+}
+
+Exp scheme_hash_table_count(Interp *interp, List args)
+{
+    if (args.size != 1) die(interp, "hash-table-count: arity mismatch\n");
+    return mknum(check_hash_table(interp, args.data[0], "hash-table-count")->count);
+}
+
+typedef enum { HT_KEYS, HT_VALUES, HT_PAIRS } HtListKind;
+
+static Exp hash_table_to_list(Interp *interp, Exp t, HtListKind kind)
+{
+    Exp res = mklist_with_cap(interp, AS_HT(t).count);
+    save(interp, res);
+    HT_FOR_EACH(AS_HT(t), entry) {
+        if (entry->key.type == EXP_EMPTY) {
+            continue;
+        }
+        Exp elem = kind == HT_KEYS ? entry->key : entry->value;
+        if (kind == HT_PAIRS) {
+            List pair = VECTOR_INIT();
+            list_add(interp, &pair, entry->key);
+            list_add(interp, &pair, entry->value);
+            elem = mklist(interp, pair);
+        }
+        AS_LIST(res).data[AS_LIST(res).size++] = elem;
+    }
+    unsave(interp, res);
+    return res;
+}
+
+Exp scheme_hash_table_keys(Interp *interp, List args)
+{
+    if (args.size != 1) die(interp, "hash-table-keys: arity mismatch\n");
+    check_hash_table(interp, args.data[0], "hash-table-keys");
+    return hash_table_to_list(interp, args.data[0], HT_KEYS);
+}
+
+Exp scheme_hash_table_values(Interp *interp, List args)
+{
+    if (args.size != 1) die(interp, "hash-table-values: arity mismatch\n");
+    check_hash_table(interp, args.data[0], "hash-table-values");
+    return hash_table_to_list(interp, args.data[0], HT_VALUES);
+}
+
+// (hash-table->alist table): a list of (key value) lists
+Exp scheme_hash_table_to_alist(Interp *interp, List args)
+{
+    if (args.size != 1) die(interp, "hash-table->alist: arity mismatch\n");
+    check_hash_table(interp, args.data[0], "hash-table->alist");
+    return hash_table_to_list(interp, args.data[0], HT_PAIRS);
+}
+
+// (hash-table-walk table proc): call (proc key value) for every entry
+Exp scheme_hash_table_walk(Interp *interp, List args)
+{
+    if (args.size != 2) die(interp, "hash-table-walk: arity mismatch\n");
+    check_hash_table(interp, args.data[0], "hash-table-walk");
+    if (!is_proc(args.data[1])) die(interp, "hash-table-walk: argument #2 must be a procedure\n");
+    // walk over a snapshot, so that proc can safely modify the table
+    Exp pairs = hash_table_to_list(interp, args.data[0], HT_PAIRS);
+    save(interp, pairs);
+    for (size_t i = 0; i < AS_LIST(pairs).size; i++) {
+        call_proc(interp, args.data[1], AS_LIST(AS_LIST(pairs).data[i]));
+    }
+    unsave(interp, pairs);
+    return (Exp) { .type = EXP_VOID };
+}
+
+Exp scheme_is_list(Interp *interp, List args)
+{
+    if (args.size != 1) die(interp, "list?: arity mismatch\n");
     return mknum(args.data[0].type == EXP_LIST);
 }
 
-Exp scheme_is_number(List args)
+Exp scheme_is_number(Interp *interp, List args)
 {
-    if (args.size != 1) die("number?: arity mismatch\n");
+    if (args.size != 1) die(interp, "number?: arity mismatch\n");
     return mknum(is_number(args.data[0]));
 }
 
-Exp scheme_is_proc(List args)
+Exp scheme_is_proc(Interp *interp, List args)
 {
-    if (args.size != 1) die("procedure?: arity mismatch\n");
+    if (args.size != 1) die(interp, "procedure?: arity mismatch\n");
     return mknum(args.data[0].type == EXP_PROC || args.data[0].type == EXP_C_PROC);
 }
 
-Exp scheme_is_symbol(List args)
+Exp scheme_is_symbol(Interp *interp, List args)
 {
-    if (args.size != 1) die("symbol?: arity mismatch\n");
+    if (args.size != 1) die(interp, "symbol?: arity mismatch\n");
     return mknum(is_symbol(args.data[0]));
 }
 
-Exp scheme_display(List args)
+Exp scheme_display(Interp *interp, List args)
 {
-  if (args.size != 1) die("display: arity mismatch\n");
-  print(args.data[0]);
+  if (args.size != 1) die(interp, "display: arity mismatch\n");
+  print_to(interp->out, args.data[0]);
   return (Exp) { .type = EXP_VOID };
 }
 
-Exp scheme_newline(List args)
+Exp scheme_newline(Interp *interp, List args)
 {
-  if (args.size != 0) die("newline: arity mismatch\n");
-  printf("\n");
+  if (args.size != 0) die(interp, "newline: arity mismatch\n");
+  writer_putc(interp->out, '\n');
   return (Exp) { .type = EXP_VOID };
 }
 
+
+// Errors and exception handlers.
+
+// (error message irritant...)
+Exp scheme_error(Interp *interp, List args)
+{
+    if (args.size < 1) die(interp, "error: arity mismatch\n");
+    Exp irritants = list_copy_from(interp, args, 1);
+    save(interp, irritants);
+    Exp condition = mkcondition(interp, args.data[0], irritants);
+    unsave(interp, irritants);
+    raise_exp(interp, condition);
+}
+
+Exp scheme_raise(Interp *interp, List args)
+{
+    if (args.size != 1) die(interp, "raise: arity mismatch\n");
+    raise_exp(interp, args.data[0]);
+}
+
+Exp scheme_raise_continuable(Interp *interp, List args)
+{
+    if (args.size != 1) die(interp, "raise-continuable: arity mismatch\n");
+    return raise_continuable(interp, args.data[0]);
+}
+
+// (with-exception-handler handler thunk)
+Exp scheme_with_exception_handler(Interp *interp, List args)
+{
+    if (args.size != 2) die(interp, "with-exception-handler: arity mismatch\n");
+    if (!is_proc(args.data[0]) || !is_proc(args.data[1])) {
+        die(interp, "with-exception-handler: arguments must be procedures\n");
+    }
+    // if thunk raises past us, whoever catches it restores the handlers
+    list_add(interp, &interp->handlers, args.data[0]);
+    Exp res = call_proc(interp, args.data[1], (List) VECTOR_INIT());
+    interp->handlers.size--;
+    return res;
+}
+
+Exp scheme_is_error_object(Interp *interp, List args)
+{
+    if (args.size != 1) die(interp, "error-object?: arity mismatch\n");
+    return mknum(args.data[0].type == EXP_CONDITION);
+}
+
+static Condition *check_condition(Interp *interp, List args, const char *name)
+{
+    if (args.size != 1) die(interp, "%s: arity mismatch\n", name);
+    if (args.data[0].type != EXP_CONDITION) die(interp, "%s: argument #1 is not an error object\n", name);
+    return &AS_CONDITION(args.data[0]);
+}
+
+Exp scheme_error_object_message(Interp *interp, List args)
+{
+    return check_condition(interp, args, "error-object-message")->message;
+}
+
+Exp scheme_error_object_irritants(Interp *interp, List args)
+{
+    return check_condition(interp, args, "error-object-irritants")->irritants;
+}
+
+// Promises and streams.
+// A stream is either the empty list or a list (first rest), where rest is a
+// promise of the next stream: only the elements that are asked for are ever
+// computed. The stream procedures that return streams are lazy too: the rest
+// of their result is a promise of a call to themselves.
+
+// The promise holding p's state: p, unless force handed it over.
+static Exp promise_owner(Exp p)
+{
+    while (AS_PROMISE(p).shared) {
+        p = AS_PROMISE(p).exp;
+    }
+    return p;
+}
+
+// Force p. A chain of delay-forces runs in a loop rather than recursively:
+// p takes over each promise its expression yields, so forcing a long chain
+// doesn't grow the C stack. As in SRFI 45, the promise taken over then
+// shares p's state, so that whichever of them is forced, the chain is only
+// run once. Forcing is a safe point for the collector, so that a recursive
+// walk over a long stream keeps only what it still refers to.
+static Exp force(Interp *interp, Exp p)
+{
+    save(interp, p);
+    gc_safe_point(interp);
+    Exp owner = promise_owner(p);
+    Promise *promise = &AS_PROMISE(owner);
+    while (!promise->done) {
+        Exp value = eval(interp, promise->exp, promise->env);
+        if (promise->done) {
+            break; // forced again by exp itself
+        } else if (promise->shared) {
+            // taken over by a promise forced by exp itself
+            owner = promise_owner(owner);
+            promise = &AS_PROMISE(owner);
+        } else if (!promise->chained) {
+            *promise = (Promise) { .done = true, .exp = value };
+        } else if (value.type != EXP_PROMISE) {
+            die(interp, "force: delay-force expression didn't return a promise\n");
+        } else {
+            Exp next = promise_owner(value);
+            if (next.obj != owner.obj) {
+                *promise = AS_PROMISE(next);
+                AS_PROMISE(next) = (Promise) { .shared = true, .exp = owner };
+            }
+        }
+    }
+    unsave(interp, p);
+    return promise->exp;
+}
+
+Exp scheme_force(Interp *interp, List args)
+{
+    if (args.size != 1) die(interp, "force: arity mismatch\n");
+    return args.data[0].type == EXP_PROMISE ? force(interp, args.data[0]) : args.data[0];
+}
+
+Exp scheme_make_promise(Interp *interp, List args)
+{
+    if (args.size != 1) die(interp, "make-promise: arity mismatch\n");
+    if (args.data[0].type == EXP_PROMISE) {
+        return args.data[0];
+    }
+    return mkpromise(interp, (Promise) { .done = true, .exp = args.data[0] });
+}
+
+Exp scheme_is_promise(Interp *interp, List args)
+{
+    if (args.size != 1) die(interp, "promise?: arity mismatch\n");
+    return mknum(args.data[0].type == EXP_PROMISE);
+}
+
+static bool is_stream_pair(Exp s)
+{
+    return s.type == EXP_LIST && AS_LIST(s).size == 2 && AS_LIST(s).data[1].type == EXP_PROMISE;
+}
+
+static Exp check_stream(Interp *interp, Exp s, const char *name, int n)
+{
+    if (!is_stream_pair(s) && (s.type != EXP_LIST || AS_LIST(s).size != 0)) {
+        die(interp, "%s: argument #%d must be a stream\n", name, n);
+    }
+    return s;
+}
+
+// The rest of the stream pair s, forced.
+static Exp stream_rest(Interp *interp, Exp s, const char *name)
+{
+    Exp rest = force(interp, AS_LIST(s).data[1]);
+    return check_stream(interp, rest, name, 1);
+}
+
+// (quote x)
+static Exp quoted(Interp *interp, Exp x)
+{
+    Exp res = mklist_with_cap(interp, 2);
+    list_add(interp, &AS_LIST(res), mkcsym(interp, "quote"));
+    list_add(interp, &AS_LIST(res), x);
+    return res;
+}
+
+Exp scheme_stream_cdr(Interp *interp, List args);
+
+// (first promise), a stream whose rest is what (proc a b) returns, where a
+// and b are expressions.
+static Exp lazy_stream(Interp *interp, Exp first, CProc proc, Exp a, Exp b)
+{
+    save(interp, a);
+    save(interp, b);
+    Exp call = mklist_with_cap(interp, 3);
+    list_add(interp, &AS_LIST(call), mkcproc(proc));
+    list_add(interp, &AS_LIST(call), a);
+    list_add(interp, &AS_LIST(call), b);
+    save(interp, call);
+    Exp res = mklist_with_cap(interp, 2);
+    list_add(interp, &AS_LIST(res), first);
+    list_add(interp, &AS_LIST(res), mkpromise(interp, (Promise) { .exp = call, .env = interp->global }));
+    unsave(interp, call);
+    unsave(interp, b);
+    unsave(interp, a);
+    return res;
+}
+
+// (stream-cdr (quote s))
+static Exp rest_of(Interp *interp, Exp s)
+{
+    Exp q = quoted(interp, s);
+    save(interp, q);
+    Exp res = mklist_with_cap(interp, 2);
+    list_add(interp, &AS_LIST(res), mkcproc(scheme_stream_cdr));
+    list_add(interp, &AS_LIST(res), q);
+    unsave(interp, q);
+    return res;
+}
+
+Exp scheme_stream_car(Interp *interp, List args)
+{
+    if (args.size != 1) die(interp, "stream-car: arity mismatch\n");
+    if (!is_stream_pair(args.data[0])) die(interp, "stream-car: argument #1 must be a non-empty stream\n");
+    return AS_LIST(args.data[0]).data[0];
+}
+
+Exp scheme_stream_cdr(Interp *interp, List args)
+{
+    if (args.size != 1) die(interp, "stream-cdr: arity mismatch\n");
+    if (!is_stream_pair(args.data[0])) die(interp, "stream-cdr: argument #1 must be a non-empty stream\n");
+    return stream_rest(interp, args.data[0], "stream-cdr");
+}
+
+Exp scheme_is_stream_pair(Interp *interp, List args)
+{
+    if (args.size != 1) die(interp, "stream-pair?: arity mismatch\n");
+    return mknum(is_stream_pair(args.data[0]));
+}
+
+Exp scheme_is_stream_null(Interp *interp, List args)
+{
+    if (args.size != 1) die(interp, "stream-null?: arity mismatch\n");
+    return mknum(args.data[0].type == EXP_LIST && AS_LIST(args.data[0]).size == 0);
+}
+
+// (stream-map proc stream)
+Exp scheme_stream_map(Interp *interp, List args)
+{
+    if (args.size != 2) die(interp, "stream-map: arity mismatch\n");
+    if (!is_proc(args.data[0])) die(interp, "stream-map: argument #1 must be a procedure\n");
+    Exp s = check_stream(interp, args.data[1], "stream-map", 2);
+    if (!is_stream_pair(s)) {
+        return s;
+    }
+    Exp first = call_proc(interp, args.data[0], (List) { .data = AS_LIST(s).data, .size = 1, .cap = 1 });
+    save(interp, first);
+    Exp res = lazy_stream(interp, first, scheme_stream_map, quoted(interp, args.data[0]), rest_of(interp, s));
+    unsave(interp, first);
+    return res;
+}
+
+// (stream-filter pred stream)
+// Elements that don't satisfy pred are skipped in a loop, so a long run of
+// them doesn't grow the C stack either. The run stays live until the loop
+// ends, though, as the caller still holds the stream it started from.
+Exp scheme_stream_filter(Interp *interp, List args)
+{
+    if (args.size != 2) die(interp, "stream-filter: arity mismatch\n");
+    if (!is_proc(args.data[0])) die(interp, "stream-filter: argument #1 must be a procedure\n");
+    Exp s = check_stream(interp, args.data[1], "stream-filter", 2);
+    save(interp, s);
+    while (is_stream_pair(s)
+        && !is_true(call_proc(interp, args.data[0], (List) { .data = AS_LIST(s).data, .size = 1, .cap = 1 }))) {
+        unsave(interp, s);
+        s = stream_rest(interp, s, "stream-filter");
+        save(interp, s);
+    }
+    Exp res = is_stream_pair(s)
+        ? lazy_stream(interp, AS_LIST(s).data[0], scheme_stream_filter,
+                      quoted(interp, args.data[0]), rest_of(interp, s))
+        : s;
+    unsave(interp, s);
+    return res;
+}
+
+// (stream-take stream n): a stream of the first n elements of stream.
+Exp scheme_stream_take(Interp *interp, List args)
+{
+    if (args.size != 2) die(interp, "stream-take: arity mismatch\n");
+    Exp s = check_stream(interp, args.data[0], "stream-take", 1);
+    if (!is_number(args.data[1])) die(interp, "stream-take: argument #2 must be a number\n");
+    if (!is_stream_pair(s) || args.data[1].number < 1) {
+        return mklist(interp, (List) VECTOR_INIT());
+    }
+    return lazy_stream(interp, AS_LIST(s).data[0], scheme_stream_take,
+                       rest_of(interp, s), mknum(args.data[1].number - 1));
+}
+
+// (stream->list stream [n]): a list of the first n elements of stream, or
+// of all of them.
+Exp scheme_stream_to_list(Interp *interp, List args)
+{
+    if (args.size != 1 && args.size != 2) die(interp, "stream->list: arity mismatch\n");
+    if (args.size == 2 && !is_number(args.data[1])) die(interp, "stream->list: argument #2 must be a number\n");
+    double n = args.size == 2 ? args.data[1].number : INFINITY;
+    Exp s = check_stream(interp, args.data[0], "stream->list", 1);
+    Exp res = mklist(interp, (List) VECTOR_INIT());
+    save(interp, res);
+    save(interp, s);
+    for (; is_stream_pair(s) && AS_LIST(res).size < n; ) {
+        list_add(interp, &AS_LIST(res), AS_LIST(s).data[0]);
+        if (AS_LIST(res).size < n) {
+            unsave(interp, s);
+            s = stream_rest(interp, s, "stream->list");
+            save(interp, s);
+        }
+    }
+    unsave(interp, s);
+    unsave(interp, res);
+    return res;
+}
+
+#ifdef HEAP_PROFILE
+// (heap-profile): print the allocation-site report gathered so far
+Exp scheme_heap_profile(Interp *interp, List args)
+{
+    if (args.size != 0) die(interp, "heap-profile: arity mismatch\n");
+    heapprof_report();
+    return (Exp) { .type = EXP_VOID };
+}
+#endif
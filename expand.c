@@ -0,0 +1,540 @@
+// Macro expansion.
+// Every top-level form is expanded once, before it's evaluated: macro uses
+// are replaced with their expansion, so procedure bodies are stored already
+// expanded and running them never expands anything again.
+// Macros are defined by define-syntax, let-syntax and letrec-syntax, and are
+// written with syntax-rules:
+//
+//   (define-syntax swap!
+//     (syntax-rules ()
+//       ((_ a b) (let ((tmp a)) (set! a b) (set! b tmp)))))
+//
+// Patterns may use literals, _ and ellipses (followed by more patterns).
+// Variables bound by a template (tmp above) are renamed at each expansion,
+// so they can't capture the user's variables.
+// A local variable shadows a macro of the same name where it's in scope:
+// there, (name arg...) is a call.
+
+// A pattern variable and what it matched. With depth > 0 the variable was
+// under an ellipsis, and value is a list of depth - 1 values.
+typedef struct Binding {
+    Exp var;
+    Exp value;
+    int depth;
+} Binding;
+
+VECTOR_DECLARE_STRUCT(Bindings, Binding);
+static VECTOR_DEFINE_INIT(Bindings, Binding, bindings)
+static VECTOR_DEFINE_ADD_CTX(Bindings, Binding, bindings, Interp *)
+static VECTOR_DEFINE_FREE_CTX(Bindings, Binding, bindings, Interp *)
+
+// The scopes around the expression being expanded, innermost first: a
+// let-syntax body, where macros are bound, or the body of a binding form,
+// where local variables are, which shadow macros of the same name.
+typedef struct MacroEnv {
+    List bindings; // ((name (syntax-rules ...)) ...)
+    List vars;     // local variables
+    struct MacroEnv *outer;
+} MacroEnv;
+
+static Binding *find_binding(Bindings *b, Exp var)
+{
+    for (size_t i = 0; i < b->size; i++) {
+        if (exp_eq(b->data[i].var, var)) {
+            return &b->data[i];
+        }
+    }
+    return NULL;
+}
+
+static bool is_literal(List literals, Exp sym)
+{
+    for (size_t i = 0; i < literals.size; i++) {
+        if (exp_eq(literals.data[i], sym)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool is_pattern_var(Exp x, List literals)
+{
+    return is_symbol(x) && !is_form(x, "_") && !is_form(x, "...")
+        && !is_literal(literals, x);
+}
+
+// Whether l[i] is followed by an ellipsis.
+static bool before_ellipsis(List l, size_t i)
+{
+    return i + 1 < l.size && is_form(l.data[i+1], "...");
+}
+
+// Bind every variable of pat to an empty list, for an ellipsis to fill.
+static void add_sequence_vars(Interp *interp, Exp pat, List literals, int depth, Bindings *b)
+{
+    if (is_pattern_var(pat, literals)) {
+        bindings_add(interp, b, (Binding) {
+            .var = pat, .value = mklist(interp, (List) VECTOR_INIT()), .depth = depth
+        });
+    } else if (pat.type == EXP_LIST) {
+        List l = AS_LIST(pat);
+        for (size_t i = 0; i < l.size; i++) {
+            add_sequence_vars(interp, l.data[i], literals, depth + before_ellipsis(l, i), b);
+        }
+    }
+}
+
+static bool match(Interp *interp, Exp pat, Exp form, List literals, Bindings *b);
+
+// Match pat[pfrom..] against form[ffrom..].
+static bool match_list(Interp *interp, List pat, size_t pfrom, List form, size_t ffrom,
+                       List literals, Bindings *b)
+{
+    size_t ell = pfrom;
+    while (ell < pat.size && !before_ellipsis(pat, ell)) {
+        ell++;
+    }
+    size_t nforms = ffrom < form.size ? form.size - ffrom : 0;
+    if (ell == pat.size) {
+        if (pat.size - pfrom != nforms) {
+            return false;
+        }
+        for (size_t i = 0; i < nforms; i++) {
+            if (!match(interp, pat.data[pfrom+i], form.data[ffrom+i], literals, b)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // pat[ell] matches any number of forms, between the ones before and after
+    size_t before = ell - pfrom, after = pat.size - (ell + 2);
+    if (nforms < before + after) {
+        return false;
+    }
+    for (size_t i = 0; i < before; i++) {
+        if (!match(interp, pat.data[pfrom+i], form.data[ffrom+i], literals, b)) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < after; i++) {
+        if (!match(interp, pat.data[ell+2+i], form.data[form.size-after+i], literals, b)) {
+            return false;
+        }
+    }
+    size_t first = b->size;
+    add_sequence_vars(interp, pat.data[ell], literals, 1, b);
+    for (size_t k = ffrom + before; k < form.size - after; k++) {
+        Bindings one = VECTOR_INIT();
+        bool ok = match(interp, pat.data[ell], form.data[k], literals, &one);
+        for (size_t i = first; ok && i < b->size; i++) {
+            Binding *m = find_binding(&one, b->data[i].var);
+            list_add(interp, &AS_LIST(b->data[i].value), m->value);
+        }
+        bindings_free(interp, &one);
+        if (!ok) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool match(Interp *interp, Exp pat, Exp form, List literals, Bindings *b)
+{
+    if (is_form(pat, "_")) {
+        return true;
+    } else if (is_symbol(pat) && is_literal(literals, pat)) {
+        return is_symbol(form) && exp_eq(pat, form);
+    } else if (is_symbol(pat)) {
+        bindings_add(interp, b, (Binding) { .var = pat, .value = form, .depth = 0 });
+        return true;
+    } else if (pat.type == EXP_LIST) {
+        return form.type == EXP_LIST
+            && match_list(interp, AS_LIST(pat), 0, AS_LIST(form), 0, literals, b);
+    }
+    return exp_equal(pat, form);
+}
+
+static bool occurs(Exp x, Exp var)
+{
+    if (is_symbol(x)) {
+        return exp_eq(x, var);
+    } else if (x.type == EXP_LIST) {
+        for (size_t i = 0; i < AS_LIST(x).size; i++) {
+            if (occurs(AS_LIST(x).data[i], var)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// A fresh name for var, that no program can use.
+static Exp gensym(Interp *interp, Exp var)
+{
+    char name[256];
+    snprintf(name, sizeof(name), "%s#%zu", AS_SYM(var), ++interp->gensym);
+    return mkcsym(interp, name);
+}
+
+// Give a variable bound by the template a fresh name for this expansion.
+static void add_rename(Interp *interp, Exp var, Bindings *b, Bindings *renames)
+{
+    if (!is_symbol(var) || is_form(var, "...") || find_binding(b, var)
+     || find_binding(renames, var)) {
+        return;
+    }
+    bindings_add(interp, renames, (Binding) { .var = var, .value = gensym(interp, var) });
+}
+
+// Find the variables bound by the binding forms of a template.
+static void find_binders(Interp *interp, Exp tmpl, Bindings *b, Bindings *renames)
+{
+    if (tmpl.type != EXP_LIST || AS_LIST(tmpl).size == 0) {
+        return;
+    }
+    List l = AS_LIST(tmpl);
+    Exp op = l.data[0];
+    if (is_form(op, "quote")) {
+        return;
+    } else if (is_form(op, "lambda") && l.size > 1 && l.data[1].type == EXP_LIST) {
+        for (size_t i = 0; i < AS_LIST(l.data[1]).size; i++) {
+            add_rename(interp, AS_LIST(l.data[1]).data[i], b, renames);
+        }
+    } else if (is_form(op, "let") || is_form(op, "let*") || is_form(op, "letrec")
+            || is_form(op, "do")) {
+        size_t at = 1;
+        if (l.size > 1 && is_symbol(l.data[1])) {
+            add_rename(interp, l.data[1], b, renames); // named let
+            at = 2;
+        }
+        if (at < l.size && l.data[at].type == EXP_LIST) {
+            List bindings = AS_LIST(l.data[at]);
+            for (size_t i = 0; i < bindings.size; i++) {
+                if (bindings.data[i].type == EXP_LIST && AS_LIST(bindings.data[i]).size > 0) {
+                    add_rename(interp, AS_LIST(bindings.data[i]).data[0], b, renames);
+                }
+            }
+        }
+    }
+    for (size_t i = 0; i < l.size; i++) {
+        find_binders(interp, l.data[i], b, renames);
+    }
+}
+
+static Exp instantiate(Interp *interp, Exp tmpl, Bindings *b, Bindings *renames)
+{
+    if (is_symbol(tmpl)) {
+        Binding *m = find_binding(b, tmpl);
+        if (!m) {
+            m = find_binding(renames, tmpl);
+        }
+        return m ? m->value : tmpl;
+    } else if (tmpl.type != EXP_LIST) {
+        return tmpl;
+    }
+    List l = AS_LIST(tmpl);
+    Exp res = mklist(interp, (List) VECTOR_INIT());
+    save(interp, res);
+    for (size_t i = 0; i < l.size; i++) {
+        if (!before_ellipsis(l, i)) {
+            Exp elem = instantiate(interp, l.data[i], b, renames);
+            save(interp, elem);
+            list_add(interp, &AS_LIST(res), elem);
+            unsave(interp, elem);
+            continue;
+        }
+        // repeat l[i] once for each element of the sequences it uses
+        Exp sub = l.data[i];
+        size_t n = SIZE_MAX;
+        for (size_t j = 0; j < b->size; j++) {
+            if (b->data[j].depth > 0 && occurs(sub, b->data[j].var)
+             && AS_LIST(b->data[j].value).size < n) {
+                n = AS_LIST(b->data[j].value).size;
+            }
+        }
+        for (size_t k = 0; n != SIZE_MAX && k < n; k++) {
+            Bindings one = VECTOR_INIT();
+            for (size_t j = 0; j < b->size; j++) {
+                Binding m = b->data[j];
+                if (m.depth > 0 && occurs(sub, m.var)) {
+                    m = (Binding) {
+                        .var = m.var, .value = AS_LIST(m.value).data[k], .depth = m.depth - 1
+                    };
+                }
+                bindings_add(interp, &one, m);
+            }
+            Exp elem = instantiate(interp, sub, &one, renames);
+            bindings_free(interp, &one);
+            save(interp, elem);
+            list_add(interp, &AS_LIST(res), elem);
+            unsave(interp, elem);
+        }
+        i++; // skip the ellipsis
+    }
+    unsave(interp, res);
+    return res;
+}
+
+// Check a (syntax-rules (literal...) (pattern template)...) form.
+static void check_rules(Interp *interp, Exp spec, const char *name)
+{
+    if (spec.type != EXP_LIST || AS_LIST(spec).size < 2
+     || !is_form(AS_LIST(spec).data[0], "syntax-rules")
+     || AS_LIST(spec).data[1].type != EXP_LIST) {
+        die(interp, "%s: expected syntax-rules\n", name);
+    }
+    List l = AS_LIST(spec);
+    for (size_t i = 2; i < l.size; i++) {
+        if (l.data[i].type != EXP_LIST || AS_LIST(l.data[i]).size != 2
+         || AS_LIST(l.data[i]).data[0].type != EXP_LIST) {
+            die(interp, "%s: bad syntax rule\n", name);
+        }
+    }
+}
+
+// Expand a use of a macro, through the first of its rules that matches.
+static Exp expand_use(Interp *interp, Exp spec, Exp form)
+{
+    List rules = AS_LIST(spec);
+    List literals = AS_LIST(rules.data[1]);
+    for (size_t i = 2; i < rules.size; i++) {
+        List rule = AS_LIST(rules.data[i]);
+        Bindings b = VECTOR_INIT();
+        if (match_list(interp, AS_LIST(rule.data[0]), 1, AS_LIST(form), 1, literals, &b)) {
+            Bindings renames = VECTOR_INIT();
+            find_binders(interp, rule.data[1], &b, &renames);
+            Exp res = instantiate(interp, rule.data[1], &b, &renames);
+            bindings_free(interp, &renames);
+            bindings_free(interp, &b);
+            return res;
+        }
+        bindings_free(interp, &b);
+    }
+    die(interp, "%s: no syntax rule matches\n", AS_SYM(AS_LIST(form).data[0]));
+}
+
+static Exp lookup_macro(Interp *interp, MacroEnv *menv, Exp name)
+{
+    for (; menv; menv = menv->outer) {
+        for (size_t i = 0; i < menv->vars.size; i++) {
+            if (exp_eq(menv->vars.data[i], name)) {
+                return (Exp) { .type = EXP_EMPTY };
+            }
+        }
+        for (size_t i = 0; i < menv->bindings.size; i++) {
+            if (exp_eq(AS_LIST(menv->bindings.data[i]).data[0], name)) {
+                return AS_LIST(menv->bindings.data[i]).data[1];
+            }
+        }
+    }
+    Exp spec = { .type = EXP_EMPTY };
+    ht_lookup(&AS_HT(interp->macros), name, &spec);
+    return spec;
+}
+
+static Exp expand_in(Interp *interp, Exp x, MacroEnv *menv);
+
+static void expand_from(Interp *interp, List l, size_t from, MacroEnv *menv)
+{
+    for (size_t i = from; i < l.size; i++) {
+        l.data[i] = expand_in(interp, l.data[i], menv);
+    }
+}
+
+// Add to vars the names defined by the body l[from..], which are local to
+// it. Only definitions written in the body are seen, not those a macro
+// use in it expands to.
+static void add_defines(Interp *interp, List *vars, List l, size_t from)
+{
+    for (size_t i = from; i < l.size; i++) {
+        if (l.data[i].type != EXP_LIST || AS_LIST(l.data[i]).size < 2) {
+            continue;
+        }
+        List form = AS_LIST(l.data[i]);
+        if (is_form(form.data[0], "define") && is_symbol(form.data[1])) {
+            list_add(interp, vars, form.data[1]);
+        } else if (is_form(form.data[0], "begin")) {
+            add_defines(interp, vars, form, 1);
+        }
+    }
+}
+
+// Add to vars the name bound by the binding (name init...).
+static void add_binding(Interp *interp, List *vars, Exp b)
+{
+    if (b.type == EXP_LIST && AS_LIST(b).size > 0 && is_symbol(AS_LIST(b).data[0])) {
+        list_add(interp, vars, AS_LIST(b).data[0]);
+    }
+}
+
+static void add_bound(Interp *interp, List *vars, List bindings)
+{
+    for (size_t i = 0; i < bindings.size; i++) {
+        add_binding(interp, vars, bindings.data[i]);
+    }
+}
+
+// Expand the body l[from..], in the scope of vars and its definitions.
+static void expand_body(Interp *interp, List l, size_t from, List *vars, MacroEnv *menv)
+{
+    add_defines(interp, vars, l, from);
+    MacroEnv scope = { .bindings = VECTOR_INIT(), .vars = *vars, .outer = menv };
+    expand_from(interp, l, from, &scope);
+}
+
+// Expand element i of every list in l[from..].
+static void expand_each(Interp *interp, List l, size_t from, size_t i, MacroEnv *menv)
+{
+    for (size_t j = from; j < l.size; j++) {
+        if (l.data[j].type == EXP_LIST && i < AS_LIST(l.data[j]).size) {
+            AS_LIST(l.data[j]).data[i] = expand_in(interp, AS_LIST(l.data[j]).data[i], menv);
+        }
+    }
+}
+
+// (let [name] bindings body...), (let* bindings body...) or
+// (letrec bindings body...). The inits of let are outside the scope of its
+// variables, those of let* see the variables before them, and those of
+// letrec see them all.
+static void expand_let(Interp *interp, List l, MacroEnv *menv)
+{
+    size_t at = l.size > 1 && is_symbol(l.data[1]) ? 2 : 1;
+    List vars = VECTOR_INIT();
+    if (at < l.size && l.data[at].type == EXP_LIST) {
+        List bindings = AS_LIST(l.data[at]);
+        if (is_form(l.data[0], "letrec")) {
+            add_bound(interp, &vars, bindings);
+        }
+        for (size_t i = 0; i < bindings.size; i++) {
+            MacroEnv scope = { .bindings = VECTOR_INIT(), .vars = vars, .outer = menv };
+            if (bindings.data[i].type == EXP_LIST && AS_LIST(bindings.data[i]).size > 1) {
+                List b = AS_LIST(bindings.data[i]);
+                b.data[1] = expand_in(interp, b.data[1], &scope);
+            }
+            if (is_form(l.data[0], "let*")) {
+                add_binding(interp, &vars, bindings.data[i]);
+            }
+        }
+        vars.size = 0;
+        add_bound(interp, &vars, bindings);
+    }
+    if (at == 2) {
+        list_add(interp, &vars, l.data[1]);
+    }
+    expand_body(interp, l, at + 1, &vars, menv);
+    list_free(interp, &vars);
+}
+
+// Expand x in place where possible, and return the expanded form.
+// Only the parts of core forms that are expressions are expanded, each in
+// the scope of the local variables around it.
+static Exp expand_in(Interp *interp, Exp x, MacroEnv *menv)
+{
+    if (x.type != EXP_LIST || AS_LIST(x).size == 0) {
+        return x;
+    }
+    List l = AS_LIST(x);
+    Exp op = l.data[0];
+    if (is_symbol(op)) {
+        Exp spec = lookup_macro(interp, menv, op);
+        if (spec.type != EXP_EMPTY) {
+            Exp res = expand_use(interp, spec, x);
+            save(interp, res);
+            res = expand_in(interp, res, menv);
+            unsave(interp, res);
+            return res;
+        }
+    }
+    if (is_form(op, "quote")) {
+        return x;
+    } else if (is_form(op, "define-syntax")) {
+        if (l.size != 3 || !is_symbol(l.data[1])) {
+            die(interp, "define-syntax: bad syntax\n");
+        }
+        check_rules(interp, l.data[2], AS_SYM(l.data[1]));
+        ht_install(&AS_HT(interp->macros), l.data[1], l.data[2]);
+        return (Exp) { .type = EXP_VOID };
+    } else if (is_form(op, "let-syntax") || is_form(op, "letrec-syntax")) {
+        if (l.size < 3 || l.data[1].type != EXP_LIST) {
+            die(interp, "%s: bad syntax\n", AS_SYM(op));
+        }
+        List bindings = AS_LIST(l.data[1]);
+        for (size_t i = 0; i < bindings.size; i++) {
+            if (bindings.data[i].type != EXP_LIST || AS_LIST(bindings.data[i]).size != 2
+             || !is_symbol(AS_LIST(bindings.data[i]).data[0])) {
+                die(interp, "%s: bad binding\n", AS_SYM(op));
+            }
+            check_rules(interp, AS_LIST(bindings.data[i]).data[1], AS_SYM(op));
+        }
+        MacroEnv inner = { .bindings = bindings, .vars = VECTOR_INIT(), .outer = menv };
+        List vars = VECTOR_INIT();
+        expand_body(interp, l, 2, &vars, &inner);
+        list_free(interp, &vars);
+        // what's left is (let () body...)
+        l.data[0] = mkcsym(interp, "let");
+        l.data[1] = mklist(interp, (List) VECTOR_INIT());
+        return x;
+    } else if (is_form(op, "lambda")) {
+        List vars = VECTOR_INIT();
+        if (l.size > 1 && l.data[1].type == EXP_LIST) {
+            List params = AS_LIST(l.data[1]);
+            for (size_t i = 0; i < params.size; i++) {
+                list_add(interp, &vars, params.data[i]);
+            }
+        }
+        expand_body(interp, l, 2, &vars, menv);
+        list_free(interp, &vars);
+        return x;
+    } else if (is_form(op, "define")) {
+        expand_from(interp, l, 2, menv);
+        return x;
+    } else if (is_form(op, "let") || is_form(op, "let*") || is_form(op, "letrec")) {
+        expand_let(interp, l, menv);
+        return x;
+    } else if (is_form(op, "do")) {
+        List vars = VECTOR_INIT();
+        if (l.size > 1 && l.data[1].type == EXP_LIST) {
+            expand_each(interp, AS_LIST(l.data[1]), 0, 1, menv);
+            add_bound(interp, &vars, AS_LIST(l.data[1]));
+        }
+        MacroEnv scope = { .bindings = VECTOR_INIT(), .vars = vars, .outer = menv };
+        if (l.size > 1 && l.data[1].type == EXP_LIST) {
+            expand_each(interp, AS_LIST(l.data[1]), 0, 2, &scope);
+        }
+        if (l.size > 2 && l.data[2].type == EXP_LIST) {
+            expand_from(interp, AS_LIST(l.data[2]), 0, &scope);
+        }
+        expand_from(interp, l, 3, &scope);
+        list_free(interp, &vars);
+        return x;
+    } else if (is_form(op, "cond")) {
+        for (size_t i = 1; i < l.size; i++) {
+            if (l.data[i].type == EXP_LIST) {
+                expand_from(interp, AS_LIST(l.data[i]), 0, menv);
+            }
+        }
+        return x;
+    } else if (is_form(op, "guard")) {
+        if (l.size > 1 && l.data[1].type == EXP_LIST && AS_LIST(l.data[1]).size > 0) {
+            List spec = AS_LIST(l.data[1]);
+            // (guard (var clause...) body...): var is bound in the clauses
+            MacroEnv scope = { .bindings = VECTOR_INIT(), .outer = menv,
+                               .vars = { .data = spec.data, .size = 1, .cap = 1 } };
+            for (size_t i = 1; i < spec.size; i++) {
+                if (spec.data[i].type == EXP_LIST) {
+                    expand_from(interp, AS_LIST(spec.data[i]), 0, &scope);
+                }
+            }
+        }
+        expand_from(interp, l, 2, menv);
+        return x;
+    }
+    expand_from(interp, l, 0, menv);
+    return x;
+}
+
+Exp expand(Interp *interp, Exp form)
+{
+    return expand_in(interp, form, NULL);
+}
@@ -1,3 +1,5 @@
+#pragma once
+
 #include "ht.h"
 #include "scheme.h"
 
@@ -6,59 +8,183 @@ typedef enum GCObjectType {
     GC_LIST = 4,
     GC_PROC = 5,
     GC_HT = 6,
+    GC_VECTOR = 7,
+    GC_ENV = 8,
+    GC_CONDITION = 9,
+    GC_BOX = 10,
+    GC_PROMISE = 11,
+    GC_FUTURE = 12,
+    GC_THREAD = 13,
+    GC_CHANNEL = 14,
 } GCObjectType;
 
+// The payload of a GC_ENV object. env.obj points back to the object.
+typedef struct EnvFrame {
+    HashTable ht;
+    Env env;
+} EnvFrame;
+
+// An object is a header followed by the payload of its type, and is
+// allocated with exactly the size of that payload (see GC_OBJ_SIZE): only
+// the largest types fill the whole union. A symbol has no member of its own:
+// its characters follow the header (see AS_SYM). A short list keeps its
+// elements right after its List (see mklist).
 typedef struct GCObject {
     GCObjectType type;
+    bool marked;
+    bool shared; // made before gc_share; its mark is in gc.shared_marks
+    unsigned char inline_cap; // GC_LIST: room for elements in the object
+#ifdef HEAP_PROFILE
+    bool survived;
+    int site;
+#endif
+    struct GCObject *next;
     union {
-        Symbol symbol;
         List list;
         Procedure proc;
         HashTable ht;
+        List vector;
+        EnvFrame frame;
+        Condition condition;
+        Exp box;
+        Promise promise;
+        Future future;
+        Thread thread;
+        Channel channel;
     };
-    bool marked;
-    struct GCObject *next;
 } GCObject;
 
+#define GC_HEADER_SIZE offsetof(GCObject, list)
+#define GC_OBJ_SIZE(member) \
+    (offsetof(GCObject, member) + sizeof(((GCObject *) 0)->member))
+
+// Lists with up to this many elements store them in the object.
+#define LIST_INLINE_MAX 8
+// Room for elements in a list object made empty, for list_add to fill.
+#define LIST_INLINE_EMPTY 4
+
 #define AS_LIST(e) (e).obj->list
 #define AS_PROC(e) (e).obj->proc
-#define AS_SYM(e) (e).obj->symbol
+#define AS_SYM(e) obj_symbol((e).obj)
+#define AS_VECTOR(e) (e).obj->vector
+#define AS_HT(e) (e).obj->ht
+#define AS_CONDITION(e) (e).obj->condition
+#define AS_PROMISE(e) (e).obj->promise
+#define AS_FUTURE(e) (e).obj->future
+#define AS_THREAD(e) (e).obj->thread
+#define AS_CHANNEL(e) (e).obj->channel
 
 static inline bool is_obj(Exp exp)
 {
-    return exp.type == EXP_LIST || exp.type == EXP_PROC || exp.type == EXP_SYMBOL;
+    return exp.type == EXP_LIST || exp.type == EXP_PROC || exp.type == EXP_SYMBOL
+        || exp.type == EXP_VECTOR || exp.type == EXP_HASH_TABLE
+        || exp.type == EXP_CONDITION || exp.type == EXP_BOX || exp.type == EXP_PROMISE
+        || exp.type == EXP_FUTURE || exp.type == EXP_THREAD || exp.type == EXP_CHANNEL;
+}
+
+static inline Symbol obj_symbol(GCObject *obj)
+{
+    return (char *) obj + GC_HEADER_SIZE;
+}
+
+// A new object of the given type and size, with its header set.
+GCObject *alloc_obj(Interp *interp, GCObjectType type, size_t size);
+
+// Push exp on the GC stack, or pop it, if it's an object.
+void save(Interp *interp, Exp exp);
+void unsave(Interp *interp, Exp exp);
+
+static inline Exp mksym(Interp *interp, const char *name, size_t len)
+{
+    GCObject *obj = alloc_obj(interp, GC_SYMBOL, GC_HEADER_SIZE + len + 1);
+    memcpy(obj_symbol(obj), name, len);
+    obj_symbol(obj)[len] = '\0';
+    return (Exp) { .type = EXP_SYMBOL, .obj = obj };
+}
+
+// A list object that takes over l. Unless l is long (or has room for many
+// elements), they are moved into the object, with room for as many as
+// l.cap, so that code writing up to a capacity it asked for still can.
+Exp mklist(Interp *interp, List l);
+
+static inline Exp mkvector(Interp *interp, List v)
+{
+    GCObject *obj = alloc_obj(interp, GC_VECTOR, GC_OBJ_SIZE(vector));
+    obj->vector = v;
+    return (Exp) { .type = EXP_VECTOR, .obj = obj };
+}
+
+static inline Exp mkhashtable(Interp *interp, bool structural)
+{
+    GCObject *obj = alloc_obj(interp, GC_HT, GC_OBJ_SIZE(ht));
+    obj->ht = structural ? (HashTable) HT_INIT_EQUAL_WITH_ALLOCATOR(ht_reallocate, interp)
+                         : (HashTable) HT_INIT_WITH_ALLOCATOR(ht_reallocate, interp);
+    return (Exp) { .type = EXP_HASH_TABLE, .obj = obj };
+}
+
+static inline Exp mkproc(Interp *interp, Exp params, Exp body, Env *env)
+{
+    GCObject *obj = alloc_obj(interp, GC_PROC, GC_OBJ_SIZE(proc));
+    obj->proc = (Procedure) { .params = params, .body = body, .env = env, };
+    return (Exp) { .type = EXP_PROC, .obj = obj };
 }
 
-GCObject *alloc_obj(GCObject from);
+static inline Exp mkcondition(Interp *interp, Exp message, Exp irritants)
+{
+    GCObject *obj = alloc_obj(interp, GC_CONDITION, GC_OBJ_SIZE(condition));
+    obj->condition = (Condition) { .message = message, .irritants = irritants };
+    return (Exp) { .type = EXP_CONDITION, .obj = obj };
+}
+
+static inline Exp mkpromise(Interp *interp, Promise promise)
+{
+    GCObject *obj = alloc_obj(interp, GC_PROMISE, GC_OBJ_SIZE(promise));
+    obj->promise = promise;
+    return (Exp) { .type = EXP_PROMISE, .obj = obj };
+}
+
+static inline Exp mkfuture(Interp *interp, struct Task *task)
+{
+    GCObject *obj = alloc_obj(interp, GC_FUTURE, GC_OBJ_SIZE(future));
+    obj->future = (Future) { .task = task, .value = { .type = EXP_VOID } };
+    return (Exp) { .type = EXP_FUTURE, .obj = obj };
+}
 
-static inline Exp mkobj(ExpType type, GCObject from)
+static inline Exp mkthread(Interp *interp, Exp thunk)
 {
-    return (Exp) { .type = type, .obj = alloc_obj(from) };
+    GCObject *obj = alloc_obj(interp, GC_THREAD, GC_OBJ_SIZE(thread));
+    obj->thread = (Thread) { .thunk = thunk, .value = { .type = EXP_VOID } };
+    return (Exp) { .type = EXP_THREAD, .obj = obj };
 }
 
-static inline Exp mksym(Symbol s)
+static inline Exp mkchannel(Interp *interp, size_t capacity)
 {
-    return mkobj(EXP_SYMBOL, (GCObject) { .type = GC_SYMBOL, .symbol = s });
+    GCObject *obj = alloc_obj(interp, GC_CHANNEL, GC_OBJ_SIZE(channel));
+    obj->channel = (Channel) { .values = VECTOR_INIT(), .capacity = capacity };
+    return (Exp) { .type = EXP_CHANNEL, .obj = obj };
 }
 
-static inline Exp mklist(List l)
+// A box holds a captured variable that may still change (see closure.c).
+static inline Exp mkbox(Interp *interp, Exp value)
 {
-    return mkobj(EXP_LIST, (GCObject) { .type = GC_LIST, .list = l });
+    GCObject *obj = alloc_obj(interp, GC_BOX, GC_OBJ_SIZE(box));
+    obj->box = value;
+    return (Exp) { .type = EXP_BOX, .obj = obj };
 }
 
-static inline Exp mkproc(Exp params, Exp body, Env env)
+static inline Exp unbox(Exp exp)
 {
-    return mkobj(EXP_PROC, (GCObject) {
-        .type = GC_PROC,
-        .proc = (Procedure) { .params = params, .body = body, .env = env, }
-    });
+    return exp.type == EXP_BOX ? exp.obj->box : exp;
 }
 
-static inline Env new_env(Env *outer)
+static inline Env *new_env(Interp *interp, Env *outer)
 {
-    return (Env) {
-        .obj = alloc_obj((GCObject) { .type = GC_HT, .ht = HT_INIT_WITH_ALLOCATOR(reallocate) }),
-        .outer = outer,
+    GCObject *obj = alloc_obj(interp, GC_ENV, GC_OBJ_SIZE(frame));
+    obj->frame = (EnvFrame) {
+        .ht = HT_INIT_WITH_ALLOCATOR(ht_reallocate, interp),
+        .env = { .obj = obj, .outer = outer }
     };
+    return &obj->frame.env;
 }
 
+#define ENV_HT(env) (env)->obj->frame.ht
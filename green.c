@@ -0,0 +1,541 @@
+// Green threads.
+// (spawn thunk) makes a thread that calls thunk, and returns it. (yield)
+// lets the other threads run. (join thread) waits for thread to finish, and
+// returns what thunk returned, or raises what it raised.
+// (make-channel [capacity]) makes a channel. (channel-send channel value)
+// adds value to it, waiting while it already holds capacity values, and
+// (channel-receive channel) takes out the oldest one, waiting while there's
+// none.
+//
+// Every thread runs on the interpreter's OS thread, on a C stack of its own,
+// so that eval can switch threads wherever it is. Switching is preemptive:
+// eval and proc_call count interp->fuel down, and when it runs out, the
+// thread goes to the back of the run queue. A thread that waits leaves the
+// run queue until a join or a channel operation wakes it, so waiting costs
+// nothing. The interpreter state that follows a call stack, such as the GC
+// stacks and the error handlers, is switched along with it.
+//
+// A top-level form doesn't end until every thread has finished or blocked.
+// The blocked ones stay, for a later form to wake. The collector, whether
+// between top-level forms or at a safe point within one (gc_safe_point),
+// marks what the threads that aren't running hold: their GC stacks and
+// handlers, and whatever their C stacks and saved registers point into,
+// as eval keeps some values in C variables only (see gc_mark_words).
+
+#define _DEFAULT_SOURCE
+
+#include "green.h"
+
+#include <sys/mman.h>
+#include <ucontext.h>
+#include <unistd.h>
+#include "gcobject.h"
+#include "ht.h"
+#include "profile.h"
+
+#ifdef __SANITIZE_ADDRESS__
+#include <sanitizer/asan_interface.h>
+#include <sanitizer/common_interface_defs.h>
+#endif
+
+// The C stack of a thread. Pages are only used once they're touched.
+#define GREEN_STACK_SIZE (8 * 1024 * 1024)
+
+// A thread's stack, and its part of the interpreter's state while it's
+// switched out. The fibers of finished threads are reused by new ones.
+typedef struct Fiber {
+    ucontext_t context;
+    char *stack;        // NULL for the main thread, which uses the process's
+    GCObject *thread;   // its Thread object, NULL for the main thread
+    size_t index;       // in Scheduler.live
+    WaitQueue *waiting; // the queue it's in while it's blocked
+    bool deadlocked;    // woken because every other thread is blocked
+    struct Fiber *next; // in the run queue, a wait queue or the free list
+    GCObject **savestack;
+    int sp;
+    Env **envstack;
+    int env_sp;
+    GCObject **frames;
+    size_t frames_sp;
+    size_t frames_cap;
+    ErrorHandler *handler;
+    List handlers;
+    uintptr_t stack_limit;
+    uintptr_t stack_base;
+    uintptr_t stack_top; // the lowest address in use while switched out
+#ifdef HEAP_PROFILE
+    int site;
+#endif
+#ifdef __SANITIZE_ADDRESS__
+    const void *bottom; // AddressSanitizer must be told which stack is used
+    size_t size;
+#endif
+} Fiber;
+
+typedef struct Scheduler {
+    Fiber main;         // runs the top-level forms
+    Fiber *current;
+    WaitQueue runnable;
+    Fiber **live;       // threads that haven't finished, except main
+    size_t nlive;
+    size_t cap;
+    Fiber *free;
+} Scheduler;
+
+static void enqueue(WaitQueue *queue, Fiber *f)
+{
+    f->next = NULL;
+    if (queue->tail) {
+        queue->tail->next = f;
+    } else {
+        queue->head = f;
+    }
+    queue->tail = f;
+}
+
+static Fiber *dequeue(WaitQueue *queue)
+{
+    Fiber *f = queue->head;
+    if (f) {
+        queue->head = f->next;
+        if (!queue->head) {
+            queue->tail = NULL;
+        }
+    }
+    return f;
+}
+
+static void remove_from(WaitQueue *queue, Fiber *f)
+{
+    Fiber *prev = NULL;
+    for (Fiber *cur = queue->head; cur; prev = cur, cur = cur->next) {
+        if (cur == f) {
+            if (prev) {
+                prev->next = f->next;
+            } else {
+                queue->head = f->next;
+            }
+            if (queue->tail == f) {
+                queue->tail = prev;
+            }
+            return;
+        }
+    }
+}
+
+static Scheduler *get_scheduler(Interp *interp)
+{
+    if (!interp->scheduler) {
+        Scheduler *s = calloc(1, sizeof(Scheduler));
+        if (!s) {
+            abort();
+        }
+        s->current = &s->main;
+        interp->scheduler = s;
+    }
+    return interp->scheduler;
+}
+
+// An address below the frames of the caller, and the registers they saved.
+static __attribute__((noinline)) uintptr_t frame_below(void)
+{
+    return (uintptr_t) __builtin_frame_address(0);
+}
+
+// Switch from the current thread to f.
+static void switch_to(Interp *interp, Fiber *f)
+{
+    Scheduler *s = interp->scheduler;
+    Fiber *from = s->current;
+    if (f == from) {
+        return;
+    }
+    GC *gc = &interp->gc;
+    from->savestack = gc->savestack;
+    from->sp = gc->sp;
+    from->envstack = gc->envstack;
+    from->env_sp = gc->env_sp;
+    from->frames = gc->frames;
+    from->frames_sp = gc->frames_sp;
+    from->frames_cap = gc->frames_cap;
+    from->handler = interp->handler;
+    from->handlers = interp->handlers;
+    from->stack_limit = interp->stack_limit;
+    from->stack_base = interp->stack_base;
+#ifdef HEAP_PROFILE
+    from->site = heapprof_current(interp);
+    heapprof_set(interp, f->site);
+#endif
+    gc->savestack = f->savestack;
+    gc->sp = f->sp;
+    gc->envstack = f->envstack;
+    gc->env_sp = f->env_sp;
+    gc->frames = f->frames;
+    gc->frames_sp = f->frames_sp;
+    gc->frames_cap = f->frames_cap;
+    interp->handler = f->handler;
+    interp->handlers = f->handlers;
+    interp->stack_limit = f->stack_limit;
+    interp->stack_base = f->stack_base;
+    interp->fuel = GREEN_FUEL;
+    s->current = f;
+    from->stack_top = frame_below();
+#ifdef __SANITIZE_ADDRESS__
+    void *fake_stack;
+    __sanitizer_start_switch_fiber(&fake_stack, f->bottom, f->size);
+    swapcontext(&from->context, &f->context);
+    __sanitizer_finish_switch_fiber(fake_stack, NULL, NULL);
+#else
+    swapcontext(&from->context, &f->context);
+#endif
+}
+
+// Let the next runnable thread run.
+static void yield(Interp *interp)
+{
+    Scheduler *s = interp->scheduler;
+    if (s && s->runnable.head) {
+        enqueue(&s->runnable, s->current);
+        switch_to(interp, dequeue(&s->runnable));
+    }
+}
+
+void green_preempt(Interp *interp)
+{
+    interp->fuel = GREEN_FUEL;
+    yield(interp);
+}
+
+// Wait in queue until woken. If no other thread can run, that's an error.
+static void block(Interp *interp, WaitQueue *queue, const char *name)
+{
+    Scheduler *s = interp->scheduler;
+    Fiber *next = s ? dequeue(&s->runnable) : NULL;
+    if (!next) {
+        die(interp, "%s: every thread is blocked\n", name);
+    }
+    Fiber *f = s->current;
+    enqueue(queue, f);
+    f->waiting = queue;
+    switch_to(interp, next);
+    if (f->deadlocked) {
+        f->deadlocked = false;
+        die(interp, "%s: every thread is blocked\n", name);
+    }
+}
+
+// Make the first thread waiting in queue runnable.
+static void wake(Interp *interp, WaitQueue *queue)
+{
+    Fiber *f = dequeue(queue);
+    if (f) {
+        f->waiting = NULL;
+        enqueue(&interp->scheduler->runnable, f);
+    }
+}
+
+// Take f out of the live threads, and keep it for a new one.
+static void retire(Scheduler *s, Fiber *f)
+{
+    s->live[f->index] = s->live[--s->nlive];
+    s->live[f->index]->index = f->index;
+    f->next = s->free;
+    s->free = f;
+}
+
+// The condition of the last error caught by interp_try.
+static Exp caught(Interp *interp)
+{
+    Exp raised = interp->raised;
+    if (raised.type == EXP_EMPTY) {
+        raised = mkcondition(interp, interp_symbol(interp, interp->error),
+                             mklist(interp, (List) VECTOR_INIT()));
+    }
+    interp->raised = (Exp) { .type = EXP_EMPTY };
+    return raised;
+}
+
+static void run_thread(Interp *interp, void *data)
+{
+    Thread *t = data;
+    List args = VECTOR_INIT();
+    t->value = t->thunk.type == EXP_C_PROC ? t->thunk.cproc(interp, args)
+                                           : proc_call(interp, &AS_PROC(t->thunk), args);
+}
+
+// Where a thread starts. makecontext only passes ints, so interp comes in
+// two halves.
+static void fiber_main(unsigned int lo, unsigned int hi)
+{
+    Interp *interp = (Interp *) (((uintptr_t) hi << 32) | lo);
+    Scheduler *s = interp->scheduler;
+    Fiber *f = s->current;
+#ifdef __SANITIZE_ADDRESS__
+    if (!s->main.bottom) {
+        // the first switch away from main tells where its stack is
+        __sanitizer_finish_switch_fiber(NULL, &s->main.bottom, &s->main.size);
+    } else {
+        __sanitizer_finish_switch_fiber(NULL, NULL, NULL);
+    }
+#endif
+    Thread *t = &f->thread->thread;
+    if (!interp_try(interp, run_thread, t)) {
+        t->value = caught(interp);
+        t->failed = true;
+    }
+    t->fiber = NULL;
+    while (t->joiners.head) {
+        wake(interp, &t->joiners);
+    }
+    retire(s, f);
+    Fiber *next = dequeue(&s->runnable);
+    if (!next) {
+        // main is blocked, and nothing can wake it anymore
+        next = &s->main;
+        remove_from(next->waiting, next);
+        next->waiting = NULL;
+        next->deadlocked = true;
+    }
+    switch_to(interp, next); // never comes back: the fiber is reset first
+}
+
+static Fiber *new_fiber(Interp *interp, Scheduler *s)
+{
+    Fiber *f = s->free;
+    if (f) {
+        s->free = f->next;
+    } else {
+        f = calloc(1, sizeof(Fiber));
+        if (!f) {
+            abort();
+        }
+        f->stack = mmap(NULL, GREEN_STACK_SIZE, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (f->stack == MAP_FAILED) {
+            free(f);
+            die(interp, "spawn: out of memory\n");
+        }
+        // overflowing the stack faults instead of overwriting memory
+        mprotect(f->stack, sysconf(_SC_PAGESIZE), PROT_NONE);
+        f->savestack = malloc(sizeof(GCObject *) * GC_STACK_SIZE);
+        f->envstack = malloc(sizeof(Env *) * GC_STACK_SIZE);
+        if (!f->savestack || !f->envstack) {
+            abort();
+        }
+        f->handlers = (List) VECTOR_INIT();
+    }
+#ifdef __SANITIZE_ADDRESS__
+    // the last thread may have left its frames poisoned
+    ASAN_UNPOISON_MEMORY_REGION(f->stack, GREEN_STACK_SIZE);
+    f->bottom = f->stack;
+    f->size = GREEN_STACK_SIZE;
+#endif
+    f->sp = 0;
+    f->env_sp = 0;
+    f->frames_sp = 0;
+    f->handler = NULL;
+    f->handlers.size = 0;
+    f->stack_limit = 0; // set by the interp_try in fiber_main
+    f->stack_base = 0;
+    f->waiting = NULL;
+    f->deadlocked = false;
+#ifdef HEAP_PROFILE
+    f->site = heapprof_current(interp);
+#endif
+    if (s->nlive == s->cap) {
+        s->cap = vector_grow_cap(s->cap);
+        s->live = realloc(s->live, sizeof(Fiber *) * s->cap);
+        if (!s->live) {
+            abort();
+        }
+    }
+    f->index = s->nlive;
+    s->live[s->nlive++] = f;
+    getcontext(&f->context);
+    f->context.uc_stack.ss_sp = f->stack;
+    f->context.uc_stack.ss_size = GREEN_STACK_SIZE;
+    f->context.uc_link = NULL;
+    uintptr_t p = (uintptr_t) interp;
+    makecontext(&f->context, (void (*)(void)) fiber_main, 2,
+                (unsigned int) p, (unsigned int) (p >> 32));
+    return f;
+}
+
+static void mark_fiber(Interp *interp, Fiber *f)
+{
+    for (size_t i = 0; i < f->frames_sp; i++) {
+        f->frames[i]->marked = false;
+    }
+    for (int i = 0; i < f->env_sp; i++) {
+        gc_mark(interp, f->envstack[i]->obj);
+    }
+    for (int i = 0; i < f->sp; i++) {
+        gc_mark(interp, f->savestack[i]);
+    }
+    for (size_t i = 0; i < f->handlers.size; i++) {
+        if (is_obj(f->handlers.data[i])) {
+            gc_mark(interp, f->handlers.data[i].obj);
+        }
+    }
+    if (f->thread) {
+        gc_mark(interp, f->thread);
+    }
+    if (f->stack_base) {
+        gc_mark_words(interp, (void *) f->stack_top, (void *) f->stack_base);
+        gc_mark_words(interp, &f->context, &f->context + 1);
+    }
+}
+
+void green_mark(Interp *interp)
+{
+    Scheduler *s = interp->scheduler;
+    if (!s) {
+        return;
+    }
+    if (s->current != &s->main) {
+        mark_fiber(interp, &s->main);
+    }
+    for (size_t i = 0; i < s->nlive; i++) {
+        if (s->live[i] != s->current) {
+            mark_fiber(interp, s->live[i]);
+        }
+    }
+}
+
+void green_finish(Interp *interp)
+{
+    Scheduler *s = interp->scheduler;
+    if (!s || s->current != &s->main) {
+        return;
+    }
+    while (s->runnable.head) {
+        yield(interp);
+    }
+}
+
+static void free_fiber(Interp *interp, Fiber *f)
+{
+    for (size_t i = 0; i < f->frames_cap && f->frames[i]; i++) {
+        ht_free(&f->frames[i]->frame.ht);
+        free(f->frames[i]);
+    }
+    free(f->frames);
+    free(f->savestack);
+    free(f->envstack);
+    list_free(interp, &f->handlers);
+    munmap(f->stack, GREEN_STACK_SIZE);
+    free(f);
+}
+
+void green_free(Interp *interp)
+{
+    Scheduler *s = interp->scheduler;
+    if (!s) {
+        return;
+    }
+    for (size_t i = 0; i < s->nlive; i++) {
+        free_fiber(interp, s->live[i]);
+    }
+    while (s->free) {
+        Fiber *f = s->free;
+        s->free = f->next;
+        free_fiber(interp, f);
+    }
+    free(s->live);
+    free(s);
+    interp->scheduler = NULL;
+}
+
+// (spawn thunk)
+Exp scheme_spawn(Interp *interp, List args)
+{
+    if (args.size != 1) die(interp, "spawn: arity mismatch\n");
+    if (!is_proc(args.data[0])) die(interp, "spawn: argument #1 must be a procedure\n");
+    Scheduler *s = get_scheduler(interp);
+    Exp thread = mkthread(interp, args.data[0]);
+    Fiber *f = new_fiber(interp, s);
+    f->thread = thread.obj;
+    AS_THREAD(thread).fiber = f;
+    enqueue(&s->runnable, f);
+    return thread;
+}
+
+// (yield)
+Exp scheme_yield(Interp *interp, List args)
+{
+    if (args.size != 0) die(interp, "yield: arity mismatch\n");
+    yield(interp);
+    return (Exp) { .type = EXP_VOID };
+}
+
+// (join thread)
+Exp scheme_join(Interp *interp, List args)
+{
+    if (args.size != 1) die(interp, "join: arity mismatch\n");
+    if (args.data[0].type != EXP_THREAD) die(interp, "join: argument #1 must be a thread\n");
+    Thread *t = &AS_THREAD(args.data[0]);
+    if (t->fiber && t->fiber == interp->scheduler->current) {
+        die(interp, "join: a thread can't wait for itself\n");
+    }
+    while (t->fiber) {
+        block(interp, &t->joiners, "join");
+    }
+    if (t->failed) {
+        raise_exp(interp, t->value);
+    }
+    return t->value;
+}
+
+// (make-channel [capacity])
+Exp scheme_make_channel(Interp *interp, List args)
+{
+    if (args.size > 1) die(interp, "make-channel: arity mismatch\n");
+    size_t capacity = 0;
+    if (args.size == 1) {
+        if (!is_number(args.data[0]) || args.data[0].number < 1
+         || args.data[0].number != floor(args.data[0].number)) {
+            die(interp, "make-channel: argument #1 must be a positive integer\n");
+        }
+        capacity = args.data[0].number;
+    }
+    return mkchannel(interp, capacity);
+}
+
+static Channel *check_channel(Interp *interp, List args, size_t arity, const char *name)
+{
+    if (args.size != arity) die(interp, "%s: arity mismatch\n", name);
+    if (args.data[0].type != EXP_CHANNEL) die(interp, "%s: argument #1 must be a channel\n", name);
+    return &AS_CHANNEL(args.data[0]);
+}
+
+// (channel-send channel value)
+Exp scheme_channel_send(Interp *interp, List args)
+{
+    Channel *c = check_channel(interp, args, 2, "channel-send");
+    while (c->capacity > 0 && c->values.size - c->head >= c->capacity) {
+        block(interp, &c->senders, "channel-send");
+    }
+    list_add(interp, &c->values, args.data[1]);
+    wake(interp, &c->receivers);
+    return (Exp) { .type = EXP_VOID };
+}
+
+// (channel-receive channel)
+Exp scheme_channel_receive(Interp *interp, List args)
+{
+    Channel *c = check_channel(interp, args, 1, "channel-receive");
+    while (c->head == c->values.size) {
+        block(interp, &c->receivers, "channel-receive");
+    }
+    Exp value = c->values.data[c->head++];
+    if (c->head == c->values.size) {
+        c->head = c->values.size = 0;
+    } else if (c->head >= 64 && c->head * 2 >= c->values.size) {
+        // reuse the room of the values received so far
+        c->values.size -= c->head;
+        memmove(c->values.data, c->values.data + c->head, sizeof(Exp) * c->values.size);
+        c->head = 0;
+    }
+    wake(interp, &c->senders);
+    return value;
+}
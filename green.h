@@ -0,0 +1,25 @@
+#pragma once
+
+#include "scheme.h"
+
+// How many steps of eval and proc_call a green thread takes before the
+// next one gets its turn.
+#define GREEN_FUEL 10000
+
+// Called when interp->fuel runs out: let the next runnable green thread
+// run, if there is one.
+void green_preempt(Interp *interp);
+// Let the other green threads run until each one has finished or blocked
+// (see green.c). Called where top-level forms end.
+void green_finish(Interp *interp);
+// Mark what the green threads that are switched out hold; for gc_collect.
+void green_mark(Interp *interp);
+// Free the green threads of interp.
+void green_free(Interp *interp);
+
+Exp scheme_spawn(Interp *interp, List args);
+Exp scheme_yield(Interp *interp, List args);
+Exp scheme_join(Interp *interp, List args);
+Exp scheme_make_channel(Interp *interp, List args);
+Exp scheme_channel_send(Interp *interp, List args);
+Exp scheme_channel_receive(Interp *interp, List args);
@@ -28,11 +28,50 @@ static u32 hash_string(const char *str, size_t len)
 // Value types must have these traits: nullable
 
 static inline bool is_empty_key(HtKey v)     { return v.type == EXP_EMPTY; }
-static inline u32 hash(HtKey v)              { return hash_string(v.obj->symbol, strlen(v.obj->symbol)); }
 
-static inline bool key_equal(HtKey a, HtKey b)
+static inline u32 hash_bytes(const void *p, size_t len)
 {
-    return strcmp(a.obj->symbol, b.obj->symbol) == 0;
+    return hash_string((const char *) p, len);
+}
+
+static u32 hash(HtKey v, bool structural)
+{
+    switch (v.type) {
+    case EXP_SYMBOL:
+        return hash_string(AS_SYM(v), strlen(AS_SYM(v)));
+    case EXP_NUMBER: {
+        double n = v.number == 0 ? 0 : v.number; // -0 and 0 are the same key
+        return hash_bytes(&n, sizeof(n));
+    }
+    case EXP_C_PROC:
+        return hash_bytes(&v.cproc, sizeof(v.cproc));
+    case EXP_LIST:
+    case EXP_VECTOR:
+        if (structural) {
+            List *l = v.type == EXP_LIST ? &v.obj->list : &v.obj->vector;
+            u32 h = 2166136261u ^ v.type;
+            for (size_t i = 0; i < l->size; i++) {
+                h = (h ^ hash(l->data[i], true)) * 16777619;
+            }
+            return h;
+        }
+        return hash_bytes(&v.obj, sizeof(v.obj));
+    case EXP_PROC:
+    case EXP_HASH_TABLE:
+    case EXP_CONDITION:
+    case EXP_PROMISE:
+    case EXP_FUTURE:
+    case EXP_THREAD:
+    case EXP_CHANNEL:
+        return hash_bytes(&v.obj, sizeof(v.obj));
+    default:
+        return v.type;
+    }
+}
+
+static inline bool key_equal(HtKey a, HtKey b, bool structural)
+{
+    return structural ? exp_equal(a, b) : exp_eq(a, b);
 }
 
 static inline bool is_empty_value(HtValue v) { return v.type == EXP_EMPTY; }
@@ -56,9 +95,9 @@ static inline void make_tombstone(HtEntry *entry)
 
 #define HT_MAX_LOAD 0.75
 
-static HtEntry *find_entry(HtEntry *entries, size_t cap, HtKey key)
+static HtEntry *find_entry(HtEntry *entries, size_t cap, HtKey key, bool structural)
 {
-    u32 i = hash(key) % cap;
+    u32 i = hash(key, structural) % cap;
     HtEntry *first_tombstone = NULL;
     for (;;) {
         HtEntry *ptr = &entries[i];
@@ -68,7 +107,7 @@ static HtEntry *find_entry(HtEntry *entries, size_t cap, HtKey key)
                 return first_tombstone != NULL ? first_tombstone : ptr;
             else if (first_tombstone == NULL)
                 first_tombstone = ptr;
-        } else if (key_equal(ptr->key, key))
+        } else if (key_equal(ptr->key, key, structural))
             return ptr;
         i = (i + 1) & (cap - 1);
     }
@@ -77,7 +116,7 @@ static HtEntry *find_entry(HtEntry *entries, size_t cap, HtKey key)
 static void adjust_cap(HashTable *tab, size_t cap)
 {
     HtEntry *entries = (HtEntry *) tab->allocate(
-        NULL, 0, sizeof(HtEntry) * cap
+        tab->ctx, NULL, 0, sizeof(HtEntry) * cap
     );
     for (size_t i = 0; i < cap; i++)
         make_empty(&entries[i]);
@@ -87,13 +126,13 @@ static void adjust_cap(HashTable *tab, size_t cap)
         HtEntry *entry = &tab->entries[i];
         if (is_empty_key(entry->key))
             continue;
-        HtEntry *dest = find_entry(entries, cap, entry->key);
+        HtEntry *dest = find_entry(entries, cap, entry->key, tab->structural);
         dest->key   = entry->key;
         dest->value = entry->value;
         tab->size++;
     }
     // free tab's array
-    tab->allocate(tab->entries, sizeof(HtEntry) * tab->cap, 0);
+    tab->allocate(tab->ctx, tab->entries, sizeof(HtEntry) * tab->cap, 0);
     tab->entries = entries;
     tab->cap     = cap;
 }
@@ -109,10 +148,12 @@ bool ht_install(HashTable *tab, HtKey key, HtValue value)
         adjust_cap(tab, cap);
     }
 
-    HtEntry *entry = find_entry(tab->entries, tab->cap, key);
+    HtEntry *entry = find_entry(tab->entries, tab->cap, key, tab->structural);
     bool is_new = is_empty_key(entry->key);
     if (is_new && is_empty_value(entry->value))
         tab->size++;
+    if (is_new)
+        tab->count++;
     entry->key   = key;
     entry->value = value;
     return is_new;
@@ -122,7 +163,7 @@ bool ht_lookup(HashTable *tab, HtKey key, HtValue *value)
 {
     if (tab->size == 0)
         return false;
-    HtEntry *entry = find_entry(tab->entries, tab->cap, key);
+    HtEntry *entry = find_entry(tab->entries, tab->cap, key, tab->structural);
     if (is_empty_key(entry->key))
         return false;
     if (value)
@@ -134,19 +175,28 @@ bool ht_delete(HashTable *tab, HtKey key)
 {
     if (tab->size == 0)
         return false;
-    HtEntry *entry = find_entry(tab->entries, tab->cap, key);
+    HtEntry *entry = find_entry(tab->entries, tab->cap, key, tab->structural);
     if (is_empty_key(entry->key))
         return false;
     // place a tombstone
     make_tombstone(entry);
+    tab->count--;
     return true;
 }
 
+void ht_clear(HashTable *tab)
+{
+    for (size_t i = 0; i < tab->cap; i++)
+        make_empty(&tab->entries[i]);
+    tab->size  = 0;
+    tab->count = 0;
+}
+
 void ht_add_all(HashTable *from, HashTable *to)
 {
     for (size_t i = 0; i < from->cap; i++) {
         HtEntry *entry = &from->entries[i];
-        if (is_empty_key(entry->key))
+        if (!is_empty_key(entry->key))
             ht_install(to, entry->key, entry->value);
     }
 }
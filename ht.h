@@ -8,7 +8,7 @@
 
 typedef Exp HtKey;
 typedef Exp HtValue;
-typedef void *(*HtAllocator)(void *ptr, size_t old, size_t new);
+typedef void *(*HtAllocator)(void *ctx, void *ptr, size_t old, size_t new);
 
 typedef struct HtEntry {
     HtKey key;
@@ -16,14 +16,18 @@ typedef struct HtEntry {
 } HtEntry;
 
 typedef struct HashTable {
-    size_t size;
+    size_t size;        // used slots, including tombstones
     size_t cap;
+    size_t count;       // live entries
     HtEntry *entries;
     HtAllocator allocate;
+    void *ctx;          // passed to allocate
+    bool structural;    // compare keys with equal? instead of eq?
 } HashTable;
 
-static inline void *ht_default_allocator(void *ptr, size_t old, size_t new)
+static inline void *ht_default_allocator(void *ctx, void *ptr, size_t old, size_t new)
 {
+    (void) ctx;
     (void) old;
     if (new == 0) {
         free(ptr);
@@ -35,28 +39,37 @@ static inline void *ht_default_allocator(void *ptr, size_t old, size_t new)
 #define HT_INIT() \
 { .size = 0, .cap = 0, .entries = NULL, .allocate = ht_default_allocator }
 
-#define HT_INIT_WITH_ALLOCATOR(allocator) \
-{ .size = 0, .cap = 0, .entries = NULL, .allocate = allocator }
+#define HT_INIT_WITH_ALLOCATOR(allocator, context) \
+{ .size = 0, .cap = 0, .entries = NULL, .allocate = allocator, .ctx = context }
+
+#define HT_INIT_EQUAL_WITH_ALLOCATOR(allocator, context) \
+{ .size = 0, .cap = 0, .entries = NULL, .allocate = allocator, .ctx = context, .structural = true }
 
 static inline void ht_init(HashTable *tab)
 {
     tab->size    = 0;
     tab->cap     = 0;
+    tab->count   = 0;
     tab->entries = NULL;
     tab->allocate = ht_default_allocator;
+    tab->ctx     = NULL;
+    tab->structural = false;
 }
 
-static inline void ht_init_with_allocator(HashTable *tab, HtAllocator allocator)
+static inline void ht_init_with_allocator(HashTable *tab, HtAllocator allocator, void *ctx)
 {
     tab->size    = 0;
     tab->cap     = 0;
+    tab->count   = 0;
     tab->entries = NULL;
     tab->allocate = allocator;
+    tab->ctx     = ctx;
+    tab->structural = false;
 }
 
 static inline void ht_free(HashTable *tab)
 {
-    tab->allocate(tab->entries, sizeof(HtEntry) * tab->cap, 0);
+    tab->allocate(tab->ctx, tab->entries, sizeof(HtEntry) * tab->cap, 0);
     ht_init(tab);
 }
 
@@ -70,9 +83,16 @@ bool ht_lookup(HashTable *tab, HtKey key, HtValue *value);
 // delete key from tab and return if key was actually deleted
 bool ht_delete(HashTable *tab, HtKey key);
 
+// remove every entry from tab, keeping its memory for new ones
+void ht_clear(HashTable *tab);
+
 // copy all entries from another HashTable
 void ht_add_all(HashTable *from, HashTable *to);
 
+// Keys may be any expression. Numbers compare by value and symbols by name;
+// lists and vectors compare by identity, or element-wise in a structural
+// table. Environments only ever use symbol keys.
+
 #define HT_FOR_EACH(tab, entry) \
     for (HtEntry *entry = (tab).entries; ((size_t) (entry - (tab).entries)) < (tab).cap; entry++)
 
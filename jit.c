@@ -0,0 +1,642 @@
+// Native code for hot procedures.
+// Every procedure counts its calls, and after JIT_THRESHOLD of them its body
+// is compiled to x86-64 code, if it only uses what the compiler knows:
+// numbers, its parameters, global numbers, if, the numeric primitives
+// (+ - * > < >= <= = not) and calls to itself. Every value is then a double.
+//
+// Native code is entered from proc_call through a stub that checks that
+// every argument is a number; if one isn't, the interpreter runs the call.
+// Global names are resolved when the code is compiled, and checked again
+// before it runs if any global variable was assigned since then.
+// As the code has no side effects, it can give up at any point and let the
+// interpreter redo the call. Only when it's about to run out of stack does
+// it raise a stack overflow instead: the interpreter, whose frames are
+// bigger, would run out too, after entering native code again at every
+// level of its recursion.
+//
+// The count and code of a procedure shared with the fork server's children
+// (see gc_share) are kept in a table of the interpreter instead, so that
+// children don't write to the pages they share.
+//
+// Compiled procedures are listed in /tmp/perf-<pid>.map, so that perf can
+// name their frames.
+
+#define _DEFAULT_SOURCE
+
+#include "jit.h"
+
+#include <unistd.h>
+#include "gcobject.h"
+#include "ht.h"
+
+#if defined(__x86_64__) && defined(__linux__)
+
+#include <sys/mman.h>
+
+// How much stack native code may use below where it's entered, when
+// evaluation hasn't set a limit (see stack_enter).
+#define JIT_STACK_SIZE (1024 * 1024)
+
+// State of a native call. Native code keeps a pointer to it in rbx.
+typedef struct JitCtx {
+    double result;
+    uintptr_t saved_rsp; // rsp to restore when giving up
+    uintptr_t limit;     // lowest rsp allowed
+} JitCtx;
+
+typedef int (*JitEntry)(JitCtx *ctx, const Exp *args);
+
+// A global name used by the code, and its value at compile time.
+typedef struct JitDep {
+    Exp name;
+    Exp value;
+} JitDep;
+
+struct JitCode {
+    void *mem;
+    size_t size;
+    JitEntry entry;
+    size_t version; // interp->global_version when deps were last checked
+    JitDep *deps;
+    size_t ndeps;
+};
+
+// JIT buffers are bookkeeping, not Scheme values, so they use plain realloc.
+typedef struct Compiler {
+    Interp *interp;
+    Procedure *proc;
+    List params;
+    uint8_t *buf;
+    size_t len, cap;
+    size_t fn;   // offset of the procedure's code
+    size_t body; // offset of its body, where tail calls jump
+    size_t bail; // offset of the code that gives up
+    JitDep *deps;
+    size_t ndeps, deps_cap;
+} Compiler;
+
+static void *grow(void *p, size_t size)
+{
+    p = realloc(p, size);
+    if (!p) {
+        abort();
+    }
+    return p;
+}
+
+static void emit(Compiler *c, const uint8_t *bytes, size_t n)
+{
+    if (c->len + n > c->cap) {
+        c->cap = c->cap * 2 + n;
+        c->buf = grow(c->buf, c->cap);
+    }
+    memcpy(c->buf + c->len, bytes, n);
+    c->len += n;
+}
+
+#define EMIT(c, ...) \
+    emit(c, (const uint8_t[]) { __VA_ARGS__ }, sizeof((const uint8_t[]) { __VA_ARGS__ }))
+
+static void emit32(Compiler *c, uint32_t x) { emit(c, (uint8_t *) &x, 4); }
+static void emit64(Compiler *c, uint64_t x) { emit(c, (uint8_t *) &x, 8); }
+
+// Emit a placeholder for a rel32 operand, to be patched with patch().
+static size_t emit_rel32(Compiler *c)
+{
+    size_t at = c->len;
+    emit32(c, 0);
+    return at;
+}
+
+static void patch(Compiler *c, size_t at, size_t target)
+{
+    int32_t rel = (int32_t) (target - (at + 4));
+    memcpy(c->buf + at, &rel, 4);
+}
+
+static void jump_to(Compiler *c, size_t target)
+{
+    patch(c, emit_rel32(c), target);
+}
+
+// xmm0 <- x
+static void emit_const(Compiler *c, double x)
+{
+    uint64_t bits;
+    memcpy(&bits, &x, 8);
+    EMIT(c, 0x48, 0xB8);             // mov rax, imm64
+    emit64(c, bits);
+    EMIT(c, 0x66, 0x48, 0x0F, 0x6E, 0xC0); // movq xmm0, rax
+}
+
+// Where parameter i is, relative to rbp: arguments are pushed in order
+// before the call.
+static int32_t param_offset(Compiler *c, size_t i)
+{
+    return 16 + 8 * (int32_t) (c->params.size - 1 - i);
+}
+
+static void emit_push(Compiler *c)
+{
+    EMIT(c, 0x48, 0x83, 0xEC, 0x08);       // sub rsp, 8
+    EMIT(c, 0xF2, 0x0F, 0x11, 0x04, 0x24); // movsd [rsp], xmm0
+}
+
+// Move xmm0 to xmm1 and pop into xmm0, so that xmm0 holds the first
+// operand and xmm1 the second.
+static void emit_pop_under(Compiler *c)
+{
+    EMIT(c, 0x66, 0x0F, 0x28, 0xC8);       // movapd xmm1, xmm0
+    EMIT(c, 0xF2, 0x0F, 0x10, 0x04, 0x24); // movsd xmm0, [rsp]
+    EMIT(c, 0x48, 0x83, 0xC4, 0x08);       // add rsp, 8
+}
+
+static void emit_pop_xmm1(Compiler *c)
+{
+    EMIT(c, 0xF2, 0x0F, 0x10, 0x0C, 0x24); // movsd xmm1, [rsp]
+    EMIT(c, 0x48, 0x83, 0xC4, 0x08);       // add rsp, 8
+}
+
+// xmm0 <- al ? 1.0 : 0.0
+static void emit_bool(Compiler *c)
+{
+    EMIT(c, 0x0F, 0xB6, 0xC0);             // movzx eax, al
+    EMIT(c, 0xF2, 0x0F, 0x2A, 0xC0);       // cvtsi2sd xmm0, eax
+}
+
+// al <- xmm0 == xmm1, false if either is NaN
+static void emit_equal(Compiler *c)
+{
+    EMIT(c, 0x66, 0x0F, 0x2E, 0xC1);       // ucomisd xmm0, xmm1
+    EMIT(c, 0x0F, 0x94, 0xC0);             // sete al
+    EMIT(c, 0x0F, 0x9B, 0xC1);             // setnp cl
+    EMIT(c, 0x20, 0xC8);                   // and al, cl
+}
+
+static void add_dep(Compiler *c, Exp name, Exp value)
+{
+    if (c->ndeps == c->deps_cap) {
+        c->deps_cap = vector_grow_cap(c->deps_cap);
+        c->deps = grow(c->deps, sizeof(JitDep) * c->deps_cap);
+    }
+    c->deps[c->ndeps++] = (JitDep) { .name = name, .value = value };
+}
+
+static bool lookup_param(Compiler *c, Exp name, size_t *index)
+{
+    for (size_t i = c->params.size; i-- > 0; ) {
+        if (exp_eq(c->params.data[i], name)) {
+            *index = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+// The value of a global name, which the code will depend on.
+static bool lookup_global(Compiler *c, Exp name, Exp *value)
+{
+    if (!ht_lookup(&ENV_HT(c->interp->global), name, value)) {
+        return false;
+    }
+    add_dep(c, name, *value);
+    return true;
+}
+
+static const char *special_forms[] = {
+    "quote", "if", "define", "set!", "lambda", "let", "let*", "letrec", "do",
+    "cond", "when", "unless", "and", "or", "guard", "delay", "delay-force", "cons-stream",
+    "future",
+};
+
+static bool is_special_form(Exp op)
+{
+    for (size_t i = 0; i < sizeof(special_forms) / sizeof(special_forms[0]); i++) {
+        if (strcmp(AS_SYM(op), special_forms[i]) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool compile(Compiler *c, Exp x, bool tail);
+
+// Compile (op arg...) where op is one of the numeric primitives.
+static bool compile_primitive(Compiler *c, CProc proc, List args)
+{
+    if (proc == scheme_sum || proc == scheme_mul) {
+        bool sum = proc == scheme_sum;
+        if (args.size == 0) {
+            emit_const(c, sum ? 0 : 1);
+            return true;
+        }
+        if (!compile(c, args.data[0], false)) {
+            return false;
+        }
+        if (sum) {
+            // the sum starts from 0, which turns -0 into 0
+            EMIT(c, 0x66, 0x0F, 0x57, 0xC9); // xorpd xmm1, xmm1
+            EMIT(c, 0xF2, 0x0F, 0x58, 0xC1); // addsd xmm0, xmm1
+        }
+        for (size_t i = 1; i < args.size; i++) {
+            emit_push(c);
+            if (!compile(c, args.data[i], false)) {
+                return false;
+            }
+            emit_pop_xmm1(c);
+            EMIT(c, 0xF2, 0x0F, sum ? 0x58 : 0x59, 0xC1); // addsd/mulsd xmm0, xmm1
+        }
+        return true;
+    } else if (proc == scheme_sub) {
+        if (args.size == 0 || !compile(c, args.data[0], false)) {
+            return false;
+        }
+        if (args.size == 1) {
+            EMIT(c, 0x48, 0xB8);                 // mov rax, sign bit
+            emit64(c, 0x8000000000000000ull);
+            EMIT(c, 0x66, 0x48, 0x0F, 0x6E, 0xC8); // movq xmm1, rax
+            EMIT(c, 0x66, 0x0F, 0x57, 0xC1);     // xorpd xmm0, xmm1
+        }
+        for (size_t i = 1; i < args.size; i++) {
+            emit_push(c);
+            if (!compile(c, args.data[i], false)) {
+                return false;
+            }
+            emit_pop_under(c);
+            EMIT(c, 0xF2, 0x0F, 0x5C, 0xC1);     // subsd xmm0, xmm1
+        }
+        return true;
+    } else if (proc == scheme_not) {
+        if (args.size != 1 || !compile(c, args.data[0], false)) {
+            return false;
+        }
+        EMIT(c, 0x66, 0x0F, 0x57, 0xC9);         // xorpd xmm1, xmm1
+        emit_equal(c);
+        emit_bool(c);
+        return true;
+    }
+
+    // comparisons, of exactly two numbers
+    if (args.size != 2 || !compile(c, args.data[0], false)) {
+        return false;
+    }
+    emit_push(c);
+    if (!compile(c, args.data[1], false)) {
+        return false;
+    }
+    emit_pop_under(c); // xmm0 = first, xmm1 = second
+    // > and >= compare first with second, < and <= second with first;
+    // seta and setae are false when either is NaN.
+    if (proc == scheme_gt || proc == scheme_ge) {
+        EMIT(c, 0x66, 0x0F, 0x2E, 0xC1);         // ucomisd xmm0, xmm1
+        EMIT(c, 0x0F, proc == scheme_gt ? 0x97 : 0x93, 0xC0); // seta/setae al
+    } else if (proc == scheme_lt || proc == scheme_le) {
+        EMIT(c, 0x66, 0x0F, 0x2E, 0xC8);         // ucomisd xmm1, xmm0
+        EMIT(c, 0x0F, proc == scheme_lt ? 0x97 : 0x93, 0xC0); // seta/setae al
+    } else if (proc == scheme_eq) {
+        emit_equal(c);
+    } else {
+        return false;
+    }
+    emit_bool(c);
+    return true;
+}
+
+// Compile a call to the procedure being compiled.
+static bool compile_self_call(Compiler *c, List args, bool tail)
+{
+    if (args.size != c->params.size) {
+        return false;
+    }
+    for (size_t i = 0; i < args.size; i++) {
+        if (!compile(c, args.data[i], false)) {
+            return false;
+        }
+        emit_push(c);
+    }
+    if (tail) {
+        // nothing else is on the stack: store the arguments in place of
+        // the parameters and start over
+        for (size_t i = args.size; i-- > 0; ) {
+            EMIT(c, 0x58);                       // pop rax
+            EMIT(c, 0x48, 0x89, 0x85);           // mov [rbp + offset], rax
+            emit32(c, param_offset(c, i));
+        }
+        EMIT(c, 0xE9);                           // jmp body
+        jump_to(c, c->body);
+        return true;
+    }
+    EMIT(c, 0xE8);                               // call fn
+    jump_to(c, c->fn);
+    if (args.size > 0) {
+        EMIT(c, 0x48, 0x81, 0xC4);               // add rsp, 8 * nargs
+        emit32(c, 8 * args.size);
+    }
+    return true;
+}
+
+// Compile x, leaving its value in xmm0.
+static bool compile(Compiler *c, Exp x, bool tail)
+{
+    size_t index;
+    Exp value;
+    if (is_number(x)) {
+        emit_const(c, x.number);
+        return true;
+    } else if (is_symbol(x) && lookup_param(c, x, &index)) {
+        EMIT(c, 0xF2, 0x0F, 0x10, 0x85);         // movsd xmm0, [rbp + offset]
+        emit32(c, param_offset(c, index));
+        return true;
+    } else if (is_symbol(x)) {
+        if (!lookup_global(c, x, &value) || !is_number(value)) {
+            return false;
+        }
+        emit_const(c, value.number);
+        return true;
+    } else if (x.type != EXP_LIST || AS_LIST(x).size == 0 || !is_symbol(AS_LIST(x).data[0])) {
+        return false;
+    }
+    List l = AS_LIST(x);
+    Exp op = l.data[0];
+    List args = { .data = l.data + 1, .size = l.size - 1, .cap = l.size - 1 };
+    if (strcmp(AS_SYM(op), "if") == 0 && l.size == 4) {
+        if (!compile(c, l.data[1], false)) {
+            return false;
+        }
+        // false is 0 only: NaN is true
+        EMIT(c, 0x66, 0x0F, 0x57, 0xC9);         // xorpd xmm1, xmm1
+        EMIT(c, 0x66, 0x0F, 0x2E, 0xC1);         // ucomisd xmm0, xmm1
+        EMIT(c, 0x0F, 0x8A);                     // jp conseq
+        size_t to_conseq = emit_rel32(c);
+        EMIT(c, 0x0F, 0x84);                     // je alt
+        size_t to_alt = emit_rel32(c);
+        patch(c, to_conseq, c->len);
+        if (!compile(c, l.data[2], tail)) {
+            return false;
+        }
+        EMIT(c, 0xE9);                           // jmp end
+        size_t to_end = emit_rel32(c);
+        patch(c, to_alt, c->len);
+        if (!compile(c, l.data[3], tail)) {
+            return false;
+        }
+        patch(c, to_end, c->len);
+        return true;
+    } else if (is_special_form(op) || lookup_param(c, op, &index)
+            || !lookup_global(c, op, &value)) {
+        return false;
+    } else if (value.type == EXP_C_PROC) {
+        return compile_primitive(c, value.cproc, args);
+    } else if (value.type == EXP_PROC && &AS_PROC(value) == c->proc) {
+        return compile_self_call(c, args, tail);
+    }
+    return false;
+}
+
+// The name of proc in the global environment, for perf.
+static const char *proc_name(Interp *interp, Procedure *proc)
+{
+    HT_FOR_EACH(ENV_HT(interp->global), entry) {
+        if (entry->value.type == EXP_PROC && &AS_PROC(entry->value) == proc
+         && is_symbol(entry->key)) {
+            return AS_SYM(entry->key);
+        }
+    }
+    return "lambda";
+}
+
+static void write_perf_map(Interp *interp, JitCode *code, Procedure *proc)
+{
+    static _Thread_local FILE *perf_map = NULL; // one per worker thread
+    if (!perf_map) {
+        char path[64];
+        snprintf(path, sizeof(path), "/tmp/perf-%d.map", (int) getpid());
+        perf_map = fopen(path, "a");
+        if (!perf_map) {
+            return;
+        }
+    }
+    fprintf(perf_map, "%lx %zx scheme:%s\n", (unsigned long) (uintptr_t) code->mem,
+            code->size, proc_name(interp, proc));
+    fflush(perf_map);
+}
+
+// Compile proc. Return NULL if it uses anything the compiler doesn't know.
+static JitCode *jit_compile(Interp *interp, Procedure *proc)
+{
+    if (proc->env != interp->global || proc->params.type != EXP_LIST) {
+        return NULL;
+    }
+    Compiler c = { .interp = interp, .proc = proc, .params = AS_LIST(proc->params) };
+    for (size_t i = 0; i < c.params.size; i++) {
+        if (!is_symbol(c.params.data[i])) {
+            return NULL;
+        }
+    }
+
+    // entry stub: int entry(JitCtx *ctx (rdi), const Exp *args (rsi))
+    EMIT(&c, 0x53);                              // push rbx
+    EMIT(&c, 0x55);                              // push rbp
+    EMIT(&c, 0x48, 0x89, 0xFB);                  // mov rbx, rdi
+    EMIT(&c, 0x48, 0x89, 0xA3);                  // mov [rbx + saved_rsp], rsp
+    emit32(&c, offsetof(JitCtx, saved_rsp));
+    size_t *guards = grow(NULL, sizeof(size_t) * (c.params.size + 1));
+    for (size_t i = 0; i < c.params.size; i++) {
+        // the type guard: every argument must be a number
+        EMIT(&c, 0x81, 0xBE);                    // cmp dword [rsi + type], EXP_NUMBER
+        emit32(&c, i * sizeof(Exp) + offsetof(Exp, type));
+        emit32(&c, EXP_NUMBER);
+        EMIT(&c, 0x0F, 0x85);                    // jne bail
+        guards[i] = emit_rel32(&c);
+        EMIT(&c, 0xFF, 0xB6);                    // push qword [rsi + number]
+        emit32(&c, i * sizeof(Exp) + offsetof(Exp, number));
+    }
+    EMIT(&c, 0xE8);                              // call fn
+    size_t to_fn = emit_rel32(&c);
+    EMIT(&c, 0x48, 0x81, 0xC4);                  // add rsp, 8 * nparams
+    emit32(&c, 8 * c.params.size);
+    EMIT(&c, 0xF2, 0x0F, 0x11, 0x83);            // movsd [rbx + result], xmm0
+    emit32(&c, offsetof(JitCtx, result));
+    EMIT(&c, 0xB8, 0x01, 0x00, 0x00, 0x00);      // mov eax, 1
+    EMIT(&c, 0x5D, 0x5B, 0xC3);                  // pop rbp; pop rbx; ret
+
+    c.bail = c.len;
+    EMIT(&c, 0x48, 0x8B, 0xA3);                  // mov rsp, [rbx + saved_rsp]
+    emit32(&c, offsetof(JitCtx, saved_rsp));
+    EMIT(&c, 0x31, 0xC0);                        // xor eax, eax
+    EMIT(&c, 0x5D, 0x5B, 0xC3);                  // pop rbp; pop rbx; ret
+    for (size_t i = 0; i < c.params.size; i++) {
+        patch(&c, guards[i], c.bail);
+    }
+    free(guards);
+
+    // the procedure itself
+    c.fn = c.len;
+    patch(&c, to_fn, c.fn);
+    EMIT(&c, 0x55);                              // push rbp
+    EMIT(&c, 0x48, 0x89, 0xE5);                  // mov rbp, rsp
+    EMIT(&c, 0x48, 0x3B, 0xA3);                  // cmp rsp, [rbx + limit]
+    emit32(&c, offsetof(JitCtx, limit));
+    EMIT(&c, 0x0F, 0x82);                        // jb bail
+    jump_to(&c, c.bail);
+    c.body = c.len;
+    bool ok = compile(&c, proc->body, true);
+    EMIT(&c, 0x48, 0x89, 0xEC);                  // mov rsp, rbp
+    EMIT(&c, 0x5D, 0xC3);                        // pop rbp; ret
+
+    void *mem = MAP_FAILED;
+    if (ok) {
+        mem = mmap(NULL, c.len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    }
+    if (mem == MAP_FAILED) {
+        free(c.buf);
+        free(c.deps);
+        return NULL;
+    }
+    memcpy(mem, c.buf, c.len);
+    free(c.buf);
+    mprotect(mem, c.len, PROT_READ | PROT_EXEC);
+
+    JitCode *code = grow(NULL, sizeof(JitCode));
+    *code = (JitCode) {
+        .mem = mem, .size = c.len, .version = interp->global_version,
+        .deps = c.deps, .ndeps = c.ndeps,
+    };
+    memcpy(&code->entry, &mem, sizeof(code->entry));
+    write_perf_map(interp, code, proc);
+    return code;
+}
+
+// Whether every global the code uses still has the value it was compiled with.
+static bool deps_valid(Interp *interp, JitCode *code)
+{
+    for (size_t i = 0; i < code->ndeps; i++) {
+        Exp value;
+        JitDep *dep = &code->deps[i];
+        if (!ht_lookup(&ENV_HT(interp->global), dep->name, &value)
+         || value.type != dep->value.type
+         || (value.type == EXP_NUMBER && value.number != dep->value.number)
+         || (value.type == EXP_C_PROC && value.cproc != dep->value.cproc)
+         || (value.type == EXP_PROC && value.obj != dep->value.obj)) {
+            return false;
+        }
+    }
+    code->version = interp->global_version;
+    return true;
+}
+
+// Run proc natively, with its code and call count in *jit and *calls.
+static bool run(Interp *interp, Procedure *proc, JitCode **jit, int *calls, List args, Exp *res)
+{
+    if (*jit && (*jit)->version != interp->global_version
+     && !deps_valid(interp, *jit)) {
+        // start counting again, then recompile
+        jit_free(*jit);
+        *jit = NULL;
+        *calls = 0;
+        return false;
+    }
+    if (!*jit) {
+        *jit = jit_compile(interp, proc);
+        if (!*jit) {
+            *calls = JIT_NEVER;
+            return false;
+        }
+    }
+    if (args.size != AS_LIST(proc->params).size) {
+        return false;
+    }
+    JitCtx ctx;
+    // give up where proc_call would report the overflow
+    ctx.limit = interp->stack_limit ? interp->stack_limit : (uintptr_t) &ctx - JIT_STACK_SIZE;
+    if (!(*jit)->entry(&ctx, args.data)) {
+        bool numbers = true;
+        for (size_t i = 0; i < args.size; i++) {
+            numbers = numbers && args.data[i].type == EXP_NUMBER;
+        }
+        if (numbers && interp->stack_limit) {
+            // past the type guards, so out of stack
+            stack_overflow(interp);
+        }
+        return false;
+    }
+    *res = mknum(ctx.result);
+    return true;
+}
+
+void jit_free(JitCode *code)
+{
+    if (code) {
+        munmap(code->mem, code->size);
+        free(code->deps);
+        free(code);
+    }
+}
+
+#else
+
+static bool run(Interp *interp, Procedure *proc, JitCode **jit, int *calls, List args, Exp *res)
+{
+    *calls = JIT_NEVER;
+    return false;
+}
+
+void jit_free(JitCode *code) { }
+
+#endif
+
+bool jit_run(Interp *interp, Procedure *proc, List args, Exp *res)
+{
+    return run(interp, proc, &proc->jit, &proc->calls, args, res);
+}
+
+// Find proc in interp->shared_jit, an open-addressed table keyed by the
+// procedure's address, adding it if it isn't there.
+static SharedJit *shared_entry(Interp *interp, Procedure *proc)
+{
+    if (2 * (interp->shared_jit_size + 1) > interp->shared_jit_cap) {
+        size_t old = interp->shared_jit_cap;
+        SharedJit *entries = interp->shared_jit;
+        interp->shared_jit_cap = old ? 2 * old : 64;
+        interp->shared_jit = calloc(interp->shared_jit_cap, sizeof(SharedJit));
+        if (!interp->shared_jit) {
+            abort();
+        }
+        interp->shared_jit_size = 0;
+        for (size_t i = 0; i < old; i++) {
+            if (entries[i].proc) {
+                *shared_entry(interp, entries[i].proc) = entries[i];
+            }
+        }
+        free(entries);
+    }
+    size_t mask = interp->shared_jit_cap - 1;
+    size_t hash = (uintptr_t) proc * 0x9E3779B97F4A7C15u;
+    size_t i = (hash ^ hash >> 29) & mask;
+    while (interp->shared_jit[i].proc) {
+        if (interp->shared_jit[i].proc == proc) {
+            return &interp->shared_jit[i];
+        }
+        i = (i + 1) & mask;
+    }
+    interp->shared_jit[i] = (SharedJit) { .proc = proc, .calls = 0, .jit = NULL };
+    interp->shared_jit_size++;
+    return &interp->shared_jit[i];
+}
+
+bool jit_run_shared(Interp *interp, Procedure *proc, List args, Exp *res)
+{
+    SharedJit *entry = shared_entry(interp, proc);
+    if (!entry->jit && (entry->calls == JIT_NEVER || ++entry->calls < JIT_THRESHOLD)) {
+        return false;
+    }
+    return run(interp, proc, &entry->jit, &entry->calls, args, res);
+}
+
+void jit_free_shared(Interp *interp)
+{
+    for (size_t i = 0; i < interp->shared_jit_cap; i++) {
+        jit_free(interp->shared_jit[i].jit);
+    }
+    free(interp->shared_jit);
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <stddef.h>
+#include "gcobject.h"
+#include "scheme.h"
+
+// Calls to a procedure before it's compiled to native code.
+#define JIT_THRESHOLD 1000
+// Value of Procedure.calls once compiling it failed.
+#define JIT_NEVER -1
+
+// The call count and native code of a procedure made before gc_share. They
+// live in Interp.shared_jit rather than in the procedure, so that running it
+// in a child of the fork server doesn't copy the pages it shares.
+typedef struct SharedJit {
+    Procedure *proc;
+    int calls;
+    JitCode *jit;
+} SharedJit;
+
+// Run proc natively, compiling it first if needed. Return false if proc
+// can't be run natively, e.g. because an argument isn't a number: the
+// interpreter must run it instead.
+bool jit_run(Interp *interp, Procedure *proc, List args, Exp *res);
+// Count a call to shared proc, and run it natively like jit_run once it has
+// been called often enough.
+bool jit_run_shared(Interp *interp, Procedure *proc, List args, Exp *res);
+void jit_free(JitCode *code);
+// Free the JIT state of shared procedures.
+void jit_free_shared(Interp *interp);
+
+// Run proc natively if it has been called often enough.
+static inline bool jit_enter(Interp *interp, Procedure *proc, List args, Exp *res)
+{
+    if (!interp->jit) {
+        return false;
+    }
+    if (((GCObject *) ((char *) proc - offsetof(GCObject, proc)))->shared) {
+        return jit_run_shared(interp, proc, args, res);
+    }
+    if (!proc->jit && (proc->calls == JIT_NEVER || ++proc->calls < JIT_THRESHOLD)) {
+        return false;
+    }
+    return jit_run(interp, proc, args, res);
+}
@@ -1,4 +1,7 @@
 #include "scheme.h"
+#include "compile.h"
+#include "profile.h"
+#include "serve.h"
 
 static char *read_file(const char *path)
 {
@@ -32,21 +35,73 @@ static char *read_file(const char *path)
     return buf;
 }
 
+static void write_file(const char *path, const char *buf, size_t size)
+{
+    FILE *file = fopen(path, "wb");
+    if (!file) {
+        perror("error");
+        exit(1);
+    }
+    if (fwrite(buf, sizeof(char), size, file) < size || fclose(file) != 0) {
+        fprintf(stderr, "error: couldn't write file %s\n", path);
+        exit(1);
+    }
+}
+
 int main(int argc, char *argv[])
 {
+#ifdef HEAP_PROFILE
+    atexit(heapprof_report);
+#endif
+    Interp *interp = interp_new();
+    if (argc > 1 && strcmp(argv[1], "-O0") == 0) {
+        interp->optimize = false;
+        interp->jit = false;
+        argv[1] = argv[0];
+        argc--;
+        argv++;
+    }
     if (argc == 1) {
-        repl();
+        repl(interp);
     } else if (argc == 3 && strcmp(argv[1], "-s") == 0) {
-        exec_string(argv[2]);
+        interp->whole_program = true;
+        exec_string(interp, argv[2]);
     } else if (argc == 3 && strcmp(argv[1], "-f") == 0) {
         char *contents = read_file(argv[2]);
-        exec_string(contents);
+        interp->whole_program = true;
+        exec_string(interp, contents);
+        free(contents);
+    } else if (argc == 5 && strcmp(argv[1], "-c") == 0 && strcmp(argv[3], "-o") == 0) {
+        char *contents = read_file(argv[2]);
+        Writer code;
+        writer_init(&code, -1, WRITER_DEFAULT_SIZE);
+        interp->whole_program = true;
+        compile_script(interp, contents, argv[2], &code);
+        write_file(argv[4], code.buf, code.len);
+        writer_free(&code);
         free(contents);
+    } else if ((argc == 2 || argc == 3) && strcmp(argv[1], "--serve") == 0) {
+        int status = serve(interp, argc == 3 ? argv[2] : NULL);
+        interp_free(interp);
+        return status;
+    } else if ((argc == 3 || argc == 4) && strcmp(argv[1], "--fork-server") == 0) {
+        if (argc == 4) {
+            char *prelude = read_file(argv[3]);
+            exec_string(interp, prelude);
+            free(prelude);
+        }
+        int status = fork_serve(interp, argv[2]);
+        interp_free(interp);
+        return status;
     } else {
-        printf("usage: %s OR %s -s [string] OR %s [file]\n",
-            argv[0], argv[0], argv[0]);
+        printf("usage: %s OR %s -s [string] OR %s -f [file] OR %s --serve [socket]\n"
+               "       OR %s -c [file] -o [C file] OR %s --fork-server socket [prelude]\n"
+               "       -O0 as first option turns off the optimizer and the JIT\n",
+            argv[0], argv[0], argv[0], argv[0], argv[0], argv[0]);
+        interp_free(interp);
         return 1;
     }
+    interp_free(interp);
     return 0;
 }
 
@@ -7,93 +7,281 @@
 #include "scheme.h"
 #include "gcobject.h"
 #include "vector.h"
+#include "profile.h"
+#include "jit.h"
+#include "parallel.h"
+#include "green.h"
 
 #define GC_HEAP_GROW_FACTOR 2
+#define GC_MIN_HEAP (1024 * 1024)
 
-static struct {
-    size_t bytes_allocated;
-    size_t next;
-    GCObject *obj_list;
-    Env *env_list;
-    GCObject *savestack[BUFSIZ];
-    int sp;
-    Env *envstack[BUFSIZ];
-    int env_sp;
-} gc = {
-    .bytes_allocated = 0,
-    .next = 1024 * 1024,
-    .obj_list = NULL,
-    .env_list = NULL,
-    .sp = 0,
-    .env_sp = 0,
-};
-
-void mark_obj(GCObject *obj)
-{
-    if (!obj || obj->marked) {
+void gc_init(GC *gc)
+{
+    gc->bytes_allocated = 0;
+    gc->next = GC_MIN_HEAP;
+    gc->obj_list = NULL;
+    gc->savestack = malloc(sizeof(GCObject *) * GC_STACK_SIZE);
+    gc->envstack = malloc(sizeof(Env *) * GC_STACK_SIZE);
+    if (!gc->savestack || !gc->envstack) {
+        abort();
+    }
+    gc->sp = 0;
+    gc->env_sp = 0;
+    gc->pins = NULL;
+    gc->pins_size = 0;
+    gc->pins_cap = 0;
+    gc->frames = NULL;
+    gc->frames_sp = 0;
+    gc->frames_cap = 0;
+    gc->shared = NULL;
+    gc->shared_marks = NULL;
+    gc->shared_marks_size = 0;
+    gc->shared_marks_cap = 0;
+    gc->gray = NULL;
+    gc->gray_size = 0;
+    gc->gray_cap = 0;
+    gc->extents = NULL;
+    gc->extents_size = 0;
+    gc->stack_top = 0;
+}
+
+// Free the collector's own bookkeeping, once every object is swept.
+void gc_free(GC *gc)
+{
+    free(gc->savestack);
+    free(gc->envstack);
+    free(gc->pins);
+    free(gc->frames);
+    free(gc->shared_marks);
+    free(gc->gray);
+}
+
+// Add a shared object to the marks of this collection, an open-addressed
+// set of pointers. Return false if it was there already.
+static bool mark_shared(GC *gc, GCObject *obj)
+{
+    if (2 * (gc->shared_marks_size + 1) > gc->shared_marks_cap) {
+        size_t old = gc->shared_marks_cap;
+        GCObject **marks = gc->shared_marks;
+        gc->shared_marks_cap = old ? 2 * old : 1024;
+        gc->shared_marks = calloc(gc->shared_marks_cap, sizeof(GCObject *));
+        if (!gc->shared_marks) {
+            abort();
+        }
+        gc->shared_marks_size = 0;
+        for (size_t i = 0; i < old; i++) {
+            if (marks[i]) {
+                mark_shared(gc, marks[i]);
+            }
+        }
+        free(marks);
+    }
+    size_t mask = gc->shared_marks_cap - 1;
+    size_t hash = (uintptr_t) obj * 0x9E3779B97F4A7C15u;
+    size_t i = (hash ^ hash >> 29) & mask;
+    while (gc->shared_marks[i]) {
+        if (gc->shared_marks[i] == obj) {
+            return false;
+        }
+        i = (i + 1) & mask;
+    }
+    gc->shared_marks[i] = obj;
+    gc->shared_marks_size++;
+    return true;
+}
+
+static void gray(GC *gc, GCObject *obj);
+
+static void mark_ht(GC *gc, HashTable *ht)
+{
+    HT_FOR_EACH(*ht, entry) {
+        if (is_obj(entry->key)) {
+            gray(gc, entry->key.obj);
+        }
+        if (is_obj(entry->value)) {
+            gray(gc, entry->value.obj);
+        }
+    }
+}
+
+// Mark obj, and leave what it refers to for mark_obj to trace: a long list
+// or stream would take as many C stack frames to mark recursively.
+static void gray(GC *gc, GCObject *obj)
+{
+    if (!obj) {
+        return;
+    }
+    if (obj->shared) {
+        if (!mark_shared(gc, obj)) {
+            return;
+        }
+    } else if (obj->marked) {
         return;
+    } else {
+        obj->marked = true;
     }
-    obj->marked = true;
+    if (gc->gray_size == gc->gray_cap) {
+        gc->gray_cap = gc->gray_cap ? 2 * gc->gray_cap : 1024;
+        gc->gray = realloc(gc->gray, sizeof(GCObject *) * gc->gray_cap);
+        if (!gc->gray) {
+            abort();
+        }
+    }
+    gc->gray[gc->gray_size++] = obj;
+}
+
+static void trace_obj(GC *gc, GCObject *obj)
+{
     switch (obj->type) {
     case GC_SYMBOL:
         break;
     case GC_LIST:
         for (size_t i = 0; i < obj->list.size; i++) {
             if (is_obj(obj->list.data[i])) {
-                mark_obj(obj->list.data[i].obj);
+                gray(gc, obj->list.data[i].obj);
+            }
+        }
+        break;
+    case GC_VECTOR:
+        for (size_t i = 0; i < obj->vector.size; i++) {
+            if (is_obj(obj->vector.data[i])) {
+                gray(gc, obj->vector.data[i].obj);
             }
         }
         break;
     case GC_PROC:
-        mark_obj(obj->proc.params.obj); // always a list
+        gray(gc, obj->proc.params.obj); // always a list
         if (is_obj(obj->proc.body)) {
-            mark_obj(obj->proc.body.obj); // may just be a simple number...
+            gray(gc, obj->proc.body.obj); // may just be a simple number...
+        }
+        gray(gc, obj->proc.env->obj);
+        break;
+    case GC_ENV:
+        mark_ht(gc, &obj->frame.ht);
+        if (obj->frame.env.outer) {
+            gray(gc, obj->frame.env.outer->obj);
         }
-        mark_obj(obj->proc.env.obj);
         break;
     case GC_HT:
-        HT_FOR_EACH(obj->ht, entry) {
-            if (!entry) {
-                continue;
-            }
-            mark_obj(entry->key.obj); // always a symbol
-            if (is_obj(entry->value)) {
-                mark_obj(entry->value.obj);
+        mark_ht(gc, &obj->ht);
+        break;
+    case GC_CONDITION:
+        if (is_obj(obj->condition.message)) {
+            gray(gc, obj->condition.message.obj);
+        }
+        gray(gc, obj->condition.irritants.obj); // always a list
+        break;
+    case GC_BOX:
+        if (is_obj(obj->box)) {
+            gray(gc, obj->box.obj);
+        }
+        break;
+    case GC_PROMISE:
+        if (is_obj(obj->promise.exp)) {
+            gray(gc, obj->promise.exp.obj);
+        }
+        if (obj->promise.env) {
+            gray(gc, obj->promise.env->obj);
+        }
+        break;
+    case GC_FUTURE:
+        if (is_obj(obj->future.value)) {
+            gray(gc, obj->future.value.obj);
+        }
+        break;
+    case GC_THREAD:
+        if (is_obj(obj->thread.thunk)) {
+            gray(gc, obj->thread.thunk.obj);
+        }
+        if (is_obj(obj->thread.value)) {
+            gray(gc, obj->thread.value.obj);
+        }
+        break;
+    case GC_CHANNEL:
+        for (size_t i = obj->channel.head; i < obj->channel.values.size; i++) {
+            if (is_obj(obj->channel.values.data[i])) {
+                gray(gc, obj->channel.values.data[i].obj);
             }
         }
+        break;
     default:
         break;
     }
 }
 
-void free_obj(GCObject *o)
+// Mark obj and everything reachable from it.
+static void mark_obj(GC *gc, GCObject *obj)
+{
+    gray(gc, obj);
+    while (gc->gray_size > 0) {
+        trace_obj(gc, gc->gray[--gc->gray_size]);
+    }
+}
+
+// The size an object was allocated with (see alloc_obj).
+static size_t obj_size(GCObject *o)
+{
+    switch (o->type) {
+    case GC_SYMBOL:    return GC_HEADER_SIZE + strlen(obj_symbol(o)) + 1;
+    case GC_LIST:      return GC_OBJ_SIZE(list) + sizeof(Exp) * o->inline_cap;
+    case GC_PROC:      return GC_OBJ_SIZE(proc);
+    case GC_HT:        return GC_OBJ_SIZE(ht);
+    case GC_VECTOR:    return GC_OBJ_SIZE(vector);
+    case GC_ENV:       return GC_OBJ_SIZE(frame);
+    case GC_CONDITION: return GC_OBJ_SIZE(condition);
+    case GC_BOX:       return GC_OBJ_SIZE(box);
+    case GC_PROMISE:   return GC_OBJ_SIZE(promise);
+    case GC_FUTURE:    return GC_OBJ_SIZE(future);
+    case GC_THREAD:    return GC_OBJ_SIZE(thread);
+    case GC_CHANNEL:   return GC_OBJ_SIZE(channel);
+    }
+    return sizeof(GCObject);
+}
+
+void free_obj(Interp *interp, GCObject *o)
 {
 #ifdef DEBUG
     printf("freeing object of type %d\n", o->type);
 #endif
     switch (o->type) {
-    case GC_SYMBOL:
-        FREE_ARRAY(char, o->symbol, strlen(o->symbol) + 1);
-        break;
     case GC_LIST:
-        list_free(&o->list);
+        list_free(interp, &o->list);
+        break;
+    case GC_VECTOR:
+        list_free(interp, &o->vector);
         break;
     case GC_PROC:
+        jit_free(o->proc.jit);
         break;
     case GC_HT:
         ht_free(&o->ht);
         break;
+    case GC_ENV:
+        ht_free(&o->frame.ht);
+        break;
+    case GC_FUTURE:
+        future_release(o->future.task);
+        break;
+    case GC_CHANNEL:
+        list_free(interp, &o->channel.values);
+        break;
     default:
         break;
     }
-    FREE(GCObject, o);
+    reallocate(interp, o, obj_size(o), 0);
 }
 
-void sweep_objects()
+void sweep_objects(Interp *interp)
 {
-    GCObject *cur = gc.obj_list, *prev = NULL;
+    GCObject *cur = interp->gc.obj_list, *prev = NULL;
     while (cur) {
         if (cur->marked) {
+#ifdef HEAP_PROFILE
+            if (!cur->survived) {
+                cur->survived = true;
+                heapprof_survived(cur->site);
+            }
+#endif
             prev = cur;
             cur = cur->next;
         } else {
@@ -102,19 +290,34 @@ void sweep_objects()
             if (prev) {
                 prev->next = cur;
             } else {
-                gc.obj_list = cur;
+                interp->gc.obj_list = cur;
             }
-            free_obj(unreached);
+            free_obj(interp, unreached);
         }
     }
-    for (GCObject *obj = gc.obj_list; obj; obj = obj->next) {
+    for (GCObject *obj = interp->gc.obj_list; obj; obj = obj->next) {
         obj->marked = false;
     }
+    for (size_t i = 0; i < interp->gc.frames_sp; i++) {
+        interp->gc.frames[i]->marked = false;
+    }
 }
 
-void *reallocate(void *ptr, size_t old, size_t new)
+// Free the frames kept for reuse, so that a deep recursion doesn't keep
+// its frames forever.
+static void free_frames(Interp *interp)
 {
-    gc.bytes_allocated += (new - old);
+    GC *gc = &interp->gc;
+    for (size_t i = gc->frames_sp; i < gc->frames_cap && gc->frames[i]; i++) {
+        ht_free(&gc->frames[i]->frame.ht);
+        free(gc->frames[i]);
+        gc->frames[i] = NULL;
+    }
+}
+
+void *reallocate(Interp *interp, void *ptr, size_t old, size_t new)
+{
+    interp->gc.bytes_allocated += (new - old);
 
     if (new == 0) {
 #ifdef DEBUG
@@ -128,12 +331,11 @@ void *reallocate(void *ptr, size_t old, size_t new)
 #ifdef DEBUG
         printf("allocating %ld bytes...\n", new - old);
 #endif
-        // gc_collect();
-    }
-
-    if (gc.bytes_allocated > gc.next) {
-        // gc_collect();
-        gc.next = gc.bytes_allocated * GC_HEAP_GROW_FACTOR;
+#ifdef HEAP_PROFILE
+        heapprof_bytes(interp, new - old);
+#endif
+        // collecting here isn't safe, as eval holds unrooted temporaries;
+        // see gc_maybe_collect and gc_safe_point instead.
     }
 
     void *res = realloc(ptr, new);
@@ -143,46 +345,324 @@ void *reallocate(void *ptr, size_t old, size_t new)
     return res;
 }
 
-void gc_collect()
+// HashTable allocator: the context is the interpreter.
+void *ht_reallocate(void *interp, void *ptr, size_t old, size_t new)
+{
+    return reallocate(interp, ptr, old, new);
+}
+
+// Conservative roots.
+// The values eval holds in C variables, such as the arguments of a call,
+// aren't on the GC stacks. A green thread that's switched out may be in
+// the middle of a call, so its C stack is scanned: any word that points
+// into an object, or into the elements of a list or vector, marks that
+// object. The ranges of addresses are sorted once per collection.
+
+typedef struct Extent {
+    uintptr_t start, end;
+    GCObject *obj;
+} Extent;
+
+static void add_extent(GC *gc, size_t *cap, const void *start, size_t size, GCObject *obj)
+{
+    if (gc->extents_size == *cap) {
+        *cap = *cap ? 2 * *cap : 1024;
+        gc->extents = realloc(gc->extents, sizeof(Extent) * *cap);
+        if (!gc->extents) {
+            abort();
+        }
+    }
+    gc->extents[gc->extents_size++] = (Extent) {
+        .start = (uintptr_t) start, .end = (uintptr_t) start + size, .obj = obj,
+    };
+}
+
+static void add_extents(GC *gc, size_t *cap, GCObject *list)
+{
+    for (GCObject *obj = list; obj; obj = obj->next) {
+        size_t size = obj_size(obj);
+        add_extent(gc, cap, obj, size, obj);
+        List *elems = obj->type == GC_LIST ? &obj->list : obj->type == GC_VECTOR ? &obj->vector
+                    : obj->type == GC_CHANNEL ? &obj->channel.values : NULL;
+        if (elems && elems->data && ((uintptr_t) elems->data < (uintptr_t) obj
+                                  || (uintptr_t) elems->data >= (uintptr_t) obj + size)) {
+            add_extent(gc, cap, elems->data, sizeof(Exp) * elems->cap, obj);
+        }
+    }
+}
+
+static int compare_extents(const void *a, const void *b)
+{
+    uintptr_t x = ((const Extent *) a)->start, y = ((const Extent *) b)->start;
+    return x < y ? -1 : x > y;
+}
+
+// The object that addr points into, or NULL.
+static GCObject *find_extent(GC *gc, uintptr_t addr)
+{
+    size_t lo = 0, hi = gc->extents_size;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (gc->extents[mid].start <= addr) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo > 0 && addr < gc->extents[lo - 1].end ? gc->extents[lo - 1].obj : NULL;
+}
+
+void gc_mark(Interp *interp, GCObject *obj)
+{
+    mark_obj(&interp->gc, obj);
+}
+
+// Stacks have poisoned areas under AddressSanitizer, which is right about
+// them being no C object.
+#ifdef __SANITIZE_ADDRESS__
+__attribute__((no_sanitize_address))
+#endif
+void gc_mark_words(Interp *interp, const void *from, const void *to)
+{
+    GC *gc = &interp->gc;
+    if (!gc->extents) {
+        size_t cap = 0;
+        add_extents(gc, &cap, gc->obj_list);
+        add_extents(gc, &cap, gc->shared);
+        qsort(gc->extents, gc->extents_size, sizeof(Extent), compare_extents);
+    }
+    uintptr_t start = ((uintptr_t) from + sizeof(void *) - 1) & ~(uintptr_t) (sizeof(void *) - 1);
+    for (const uintptr_t *p = (const uintptr_t *) start; (const void *) p < to; p++) {
+        GCObject *obj = find_extent(gc, *p);
+        if (obj) {
+            mark_obj(gc, obj);
+        }
+    }
+}
+
+void gc_collect(Interp *interp)
 {
 #ifdef DEBUG
     printf("collecting memory...\n");
 #endif
-    for (int i = 0; i < gc.env_sp; i++) {
-        mark_obj(gc.envstack[i]->obj);
+    // first, as it clears the marks the threads' frames kept from last time
+    green_mark(interp);
+    if (interp->gc.stack_top) {
+        gc_mark_words(interp, (void *) interp->gc.stack_top, (void *) interp->stack_base);
+    }
+    for (int i = 0; i < interp->gc.env_sp; i++) {
+        mark_obj(&interp->gc, interp->gc.envstack[i]->obj);
+    }
+    for (int i = 0; i < interp->gc.sp; i++) {
+        mark_obj(&interp->gc, interp->gc.savestack[i]);
+    }
+    for (size_t i = 0; i < interp->gc.pins_size; i++) {
+        mark_obj(&interp->gc, interp->gc.pins[i]);
+    }
+    for (size_t i = 0; i < interp->handlers.size; i++) {
+        if (is_obj(interp->handlers.data[i])) {
+            mark_obj(&interp->gc, interp->handlers.data[i].obj);
+        }
+    }
+    if (is_obj(interp->raised)) {
+        mark_obj(&interp->gc, interp->raised.obj);
+    }
+    if (is_obj(interp->macros)) {
+        mark_obj(&interp->gc, interp->macros.obj);
+    }
+    if (is_obj(interp->definitions)) {
+        mark_obj(&interp->gc, interp->definitions.obj);
+    }
+    if (interp->global) {
+        mark_obj(&interp->gc, interp->global->obj);
+    }
+    free(interp->gc.extents);
+    interp->gc.extents = NULL;
+    interp->gc.extents_size = 0;
+    sweep_objects(interp);
+    free_frames(interp);
+    if (interp->gc.shared_marks_size > 0) {
+        memset(interp->gc.shared_marks, 0, sizeof(GCObject *) * interp->gc.shared_marks_cap);
+        interp->gc.shared_marks_size = 0;
+    }
+}
+
+static void collect(Interp *interp)
+{
+    gc_collect(interp);
+    interp->gc.next = interp->gc.bytes_allocated * GC_HEAP_GROW_FACTOR;
+    if (interp->gc.next < GC_MIN_HEAP) {
+        interp->gc.next = GC_MIN_HEAP;
+    }
+}
+
+// Collect if enough memory was allocated since the last collection.
+// Only call this where every live object is reachable from the roots,
+// e.g. between top-level forms.
+void gc_maybe_collect(Interp *interp)
+{
+    if (interp->gc.bytes_allocated > interp->gc.next) {
+        collect(interp);
     }
-    for (int i = 0; i < gc.sp; i++) {
-        mark_obj(gc.savestack[i]);
+}
+
+// Collect with the C stack as a root, from the frame of this call, which is
+// below the registers its caller saved, up to where eval started.
+static __attribute__((noinline)) void collect_from_here(Interp *interp)
+{
+    interp->gc.stack_top = (uintptr_t) __builtin_frame_address(0);
+    collect(interp);
+    interp->gc.stack_top = 0;
+}
+
+static __attribute__((noinline)) void spill_and_collect(Interp *interp)
+{
+    __builtin_unwind_init(); // saves every callee-saved register on the stack
+    collect_from_here(interp);
+}
+
+void gc_safe_point(Interp *interp)
+{
+    if (interp->gc.bytes_allocated > interp->gc.next && interp->stack_base) {
+        spill_and_collect(interp);
+    }
+}
+
+// Pins are bookkeeping for the collector itself, so they use plain realloc.
+void gc_pin(Interp *interp, GCObject *obj)
+{
+    GC *gc = &interp->gc;
+    if (gc->pins_size == gc->pins_cap) {
+        gc->pins_cap = vector_grow_cap(gc->pins_cap);
+        gc->pins = realloc(gc->pins, sizeof(GCObject *) * gc->pins_cap);
+        if (!gc->pins) {
+            abort();
+        }
     }
-    sweep_objects();
+    gc->pins[gc->pins_size++] = obj;
 }
 
-void gc_push_env(Env *env) { gc.envstack[gc.env_sp++] = env; }
-void gc_pop_env()          { gc.env_sp--; }
+void gc_unpin(Interp *interp, GCObject *obj)
+{
+    GC *gc = &interp->gc;
+    for (size_t i = gc->pins_size; i-- > 0; ) {
+        if (gc->pins[i] == obj) {
+            gc->pins[i] = gc->pins[--gc->pins_size];
+            return;
+        }
+    }
+}
 
-void gc_save(GCObject *obj) { gc.savestack[gc.sp++] = obj; }
-void gc_unsave()            { gc.sp--; }
+void gc_push_env(Interp *interp, Env *env)
+{
+    if (interp->gc.env_sp == GC_STACK_SIZE) {
+        stack_overflow(interp);
+    }
+    interp->gc.envstack[interp->gc.env_sp++] = env;
+}
+void gc_pop_env(Interp *interp)            { interp->gc.env_sp--; }
 
-void gc_sweep()
+// Frames for calls whose environment can't be reached once they return
+// (see Procedure.stack_frame) are taken from a stack of GC_ENV objects that
+// are never swept: popping one makes no garbage, and the next call reuses
+// it, hashtable included. While in use, a frame is rooted like any Env
+// pushed with gc_push_env.
+Env *gc_push_frame(Interp *interp, Env *outer)
 {
-    sweep_objects();
+    GC *gc = &interp->gc;
+    if (gc->frames_sp == gc->frames_cap) {
+        size_t old = gc->frames_cap;
+        gc->frames_cap = vector_grow_cap(old);
+        gc->frames = realloc(gc->frames, sizeof(GCObject *) * gc->frames_cap);
+        if (!gc->frames) {
+            abort();
+        }
+        memset(gc->frames + old, 0, sizeof(GCObject *) * (gc->frames_cap - old));
+    }
+    GCObject *obj = gc->frames[gc->frames_sp];
+    if (!obj) {
+        obj = calloc(1, GC_OBJ_SIZE(frame));
+        if (!obj) {
+            abort();
+        }
+        obj->type = GC_ENV;
+        obj->frame = (EnvFrame) { .ht = HT_INIT_WITH_ALLOCATOR(ht_reallocate, interp) };
+        gc->frames[gc->frames_sp] = obj;
+    } else {
+        ht_clear(&obj->frame.ht);
+    }
+    gc->frames_sp++;
+    obj->frame.env = (Env) { .obj = obj, .outer = outer };
+    gc_push_env(interp, &obj->frame.env);
+    return &obj->frame.env;
+}
+
+void gc_pop_frame(Interp *interp)
+{
+    gc_pop_env(interp);
+    interp->gc.frames_sp--;
+}
+
+void gc_save(Interp *interp, GCObject *obj)
+{
+    if (interp->gc.sp == GC_STACK_SIZE) {
+        stack_overflow(interp);
+    }
+    interp->gc.savestack[interp->gc.sp++] = obj;
+}
+void gc_unsave(Interp *interp)              { interp->gc.sp--; }
+
+// Objects shared with the children of a fork server (see serve.c) aren't
+// swept: freeing one, or just clearing its mark bit, would make the child
+// copy the page it's on. Their marks are kept in gc.shared_marks instead,
+// and they stay allocated until the interpreter is freed.
+void gc_share(Interp *interp)
+{
+    GC *gc = &interp->gc;
+    GCObject *last = NULL;
+    for (GCObject *obj = gc->obj_list; obj; obj = obj->next) {
+        obj->shared = true;
+        last = obj;
+    }
+    if (last) {
+        last->next = gc->shared;
+        gc->shared = gc->obj_list;
+        gc->obj_list = NULL;
+    }
+}
+
+void gc_sweep(Interp *interp)
+{
+    sweep_objects(interp);
+    free_frames(interp);
+    while (interp->gc.shared) {
+        GCObject *obj = interp->gc.shared;
+        interp->gc.shared = obj->next;
+        free_obj(interp, obj);
+    }
 #ifdef DEBUG
-    if (gc.bytes_allocated == 0) {
+    if (interp->gc.bytes_allocated == 0) {
         printf("hooray! nothing allocated anymore!\n");
     }
 #endif
 }
 
-GCObject *alloc_obj(GCObject from)
+GCObject *alloc_obj(Interp *interp, GCObjectType type, size_t size)
 {
 #ifdef DEBUG
-    printf("allocating object of type %d\n", from.type);
+    printf("allocating object of type %d\n", type);
 #endif
-    GCObject *obj = ALLOCATE(GCObject, 1);
-    memcpy(obj, &from, sizeof(GCObject));
+    GCObject *obj = reallocate(interp, NULL, 0, size);
+    obj->type = type;
     obj->marked = false;
-    obj->next = gc.obj_list;
-    gc.obj_list = obj;
+    obj->shared = false;
+    obj->inline_cap = 0;
+#ifdef HEAP_PROFILE
+    obj->survived = false;
+    obj->site = heapprof_current(interp);
+    heapprof_object(interp);
+#endif
+    obj->next = interp->gc.obj_list;
+    interp->gc.obj_list = obj;
     return obj;
 }
-
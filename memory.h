@@ -1,28 +1,78 @@
 #pragma once
 
 #include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
 
 typedef struct Env Env;
 typedef struct GCObject GCObject;
+typedef struct Interp Interp;
 
-void *reallocate(void *ptr, size_t old, size_t new);
-void gc_collect();
-void gc_push_env(Env *env);
-void gc_pop_env();
-void gc_save(GCObject *obj);
-void gc_unsave();
-void gc_sweep();
+// The state of an interpreter's garbage collector.
+typedef struct GC {
+    size_t bytes_allocated;
+    size_t next;
+    GCObject *obj_list;
+    GCObject **savestack; // GC_STACK_SIZE entries, like envstack; each green
+    int sp;               // thread has its own (see green.c)
+    Env **envstack;
+    int env_sp;
+    GCObject **pins; // objects kept alive on behalf of an embedding host
+    size_t pins_size;
+    size_t pins_cap;
+    GCObject **frames; // call frames that can't outlive their call (see gc_push_frame)
+    size_t frames_sp;  // frames in use; the ones above are kept for reuse
+    size_t frames_cap;
+    GCObject *shared;        // objects made before gc_share, never swept
+    GCObject **shared_marks; // which of them the current collection reached
+    size_t shared_marks_size;
+    size_t shared_marks_cap;
+    GCObject **gray;         // marked objects whose references are still to
+    size_t gray_size;        // be marked (see mark_obj)
+    size_t gray_cap;
+    struct Extent *extents;  // while collecting: what a conservative root may
+    size_t extents_size;     // point into, by address (see gc_mark_words)
+    uintptr_t stack_top;     // while collecting at a safe point: the C stack's top
+} GC;
 
-#define ALLOCATE(type, count) \
-    (type *) reallocate(NULL, 0, sizeof(type) * (count))
+#define GC_STACK_SIZE BUFSIZ
 
-#define GROW_ARRAY(type, ptr, old, new) \
-    (type *) reallocate(ptr, sizeof(type) * (old), sizeof(type) * (new))
+void gc_init(GC *gc);
+void gc_free(GC *gc);
+void *reallocate(Interp *interp, void *ptr, size_t old, size_t new);
+void *ht_reallocate(void *interp, void *ptr, size_t old, size_t new);
+void gc_collect(Interp *interp);
+void gc_push_env(Interp *interp, Env *env);
+void gc_pop_env(Interp *interp);
+Env *gc_push_frame(Interp *interp, Env *outer);
+void gc_pop_frame(Interp *interp);
+void gc_save(Interp *interp, GCObject *obj);
+void gc_unsave(Interp *interp);
+void gc_sweep(Interp *interp);
+void gc_share(Interp *interp);
+void gc_maybe_collect(Interp *interp);
+// Collect inside a form, if enough memory was allocated since the last
+// collection: eval's unrooted temporaries are found by scanning the C stack
+// conservatively (see gc_mark_words). Only for use under eval, where the
+// loops and force call it so that a long walk over a stream or a loop that
+// allocates runs in bounded memory.
+void gc_safe_point(Interp *interp);
+void gc_pin(Interp *interp, GCObject *obj);
+// Mark from roots the GC doesn't know of: obj, or every object a word in
+// [from, to) points into. Only for use while gc_collect runs.
+void gc_mark(Interp *interp, GCObject *obj);
+void gc_mark_words(Interp *interp, const void *from, const void *to);
+void gc_unpin(Interp *interp, GCObject *obj);
 
-#define FREE(type, ptr) reallocate(ptr, sizeof(type), 0)
+#define ALLOCATE(interp, type, count) \
+    (type *) reallocate(interp, NULL, 0, sizeof(type) * (count))
 
-#define FREE_ARRAY(type, ptr, old) \
+#define GROW_ARRAY(interp, type, ptr, old, new) \
+    (type *) reallocate(interp, ptr, sizeof(type) * (old), sizeof(type) * (new))
+
+#define FREE(interp, type, ptr) reallocate(interp, ptr, sizeof(type), 0)
+
+#define FREE_ARRAY(interp, type, ptr, old) \
     do { \
-        reallocate(ptr, sizeof(type) * (old), 0); \
+        reallocate(interp, ptr, sizeof(type) * (old), 0); \
     } while (0)
-
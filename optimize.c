@@ -0,0 +1,568 @@
+// Optimizer.
+// After expansion, each top-level form goes through a pass that rewrites,
+// in place where possible:
+//
+//   - calls to pure standard primitives with constant arguments, such as
+//     (* 2 pi), into their value;
+//   - (if test conseq alt) with a constant test into the branch it takes;
+//   - (begin ...) without its side-effect-free non-tail expressions;
+//   - calls to small procedures into their body (see Inlining below).
+//
+// A primitive is only folded when its name provably refers to the entry
+// made by standard_env: the name isn't bound by anything around the call,
+// nor defined or set! anywhere in the program (see note_definitions), and
+// the global binding still holds the standard C procedure. That needs the
+// whole program up front, as exec_string has it for a script
+// (interp->whole_program): in a session that's still growing, such as the
+// REPL or a host using the embedding API, a later form could assign the
+// name, so nothing global is folded there.
+
+// Pure primitives, and the number of arguments they accept (max -1: any).
+// They are only folded with numbers as arguments, so they can't fail.
+static const struct {
+    CProc proc;
+    int min, max;
+} pure_procs[] = {
+    { scheme_sum,       0, -1 },
+    { scheme_sub,       1, -1 },
+    { scheme_mul,       0, -1 },
+    { scheme_gt,        1, -1 },
+    { scheme_lt,        1, -1 },
+    { scheme_ge,        1, -1 },
+    { scheme_le,        1, -1 },
+    { scheme_eq,        1, -1 },
+    { scheme_not,       1,  1 },
+    { scheme_is_number, 1,  1 },
+};
+
+typedef struct Optimizer {
+    List bound;    // local variables around the current expression
+    List assigned; // names defined or set! anywhere in the form
+    int depth;     // how many inlined bodies the current expression is in
+} Optimizer;
+
+static bool in_list(List l, Exp name)
+{
+    for (size_t i = l.size; i-- > 0; ) {
+        if (exp_eq(l.data[i], name)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool is_bound(Optimizer *opt, Exp name)
+{
+    return in_list(opt->bound, name) || in_list(opt->assigned, name);
+}
+
+// The value of name in the global environment, if nothing else may
+// have bound it.
+static bool global_value(Interp *interp, Optimizer *opt, Exp name, Exp *value)
+{
+    return is_symbol(name) && !is_bound(opt, name)
+        && ht_lookup(&ENV_HT(interp->global), name, value);
+}
+
+// The value standard_env gave name, if the program never defines or set!s it.
+static bool standard_value(Interp *interp, Optimizer *opt, Exp name, Exp *value)
+{
+    return interp->whole_program && global_value(interp, opt, name, value)
+        && !ht_lookup(&AS_HT(interp->definitions), name, NULL);
+}
+
+// Whether x always evaluates to the same value, without side effects.
+// If so, put the value in *value.
+static bool constant_value(Exp x, Exp *value)
+{
+    if (is_number(x)) {
+        *value = x;
+        return true;
+    } else if (x.type == EXP_LIST && AS_LIST(x).size == 2 && is_form(AS_LIST(x).data[0], "quote")) {
+        *value = AS_LIST(x).data[1];
+        return true;
+    }
+    return false;
+}
+
+// Add every name defined or set! anywhere in x to the assigned names.
+static void find_assigned(Interp *interp, Optimizer *opt, Exp x)
+{
+    if (x.type != EXP_LIST || AS_LIST(x).size == 0) {
+        return;
+    }
+    List l = AS_LIST(x);
+    if (is_form(l.data[0], "quote")) {
+        return;
+    } else if ((is_form(l.data[0], "define") || is_form(l.data[0], "set!"))
+            && l.size > 1 && is_symbol(l.data[1])) {
+        list_add(interp, &opt->assigned, l.data[1]);
+    }
+    for (size_t i = 0; i < l.size; i++) {
+        find_assigned(interp, opt, l.data[i]);
+    }
+}
+
+// Add the names bound by a list of bindings ((name ...) ...).
+static void bind_names(Interp *interp, Optimizer *opt, Exp bindings)
+{
+    if (bindings.type != EXP_LIST) {
+        return;
+    }
+    for (size_t i = 0; i < AS_LIST(bindings).size; i++) {
+        Exp b = AS_LIST(bindings).data[i];
+        if (b.type == EXP_LIST && AS_LIST(b).size > 0) {
+            list_add(interp, &opt->bound, AS_LIST(b).data[0]);
+        }
+    }
+}
+
+static Exp optimize_in(Interp *interp, Optimizer *opt, Exp x);
+
+static void optimize_from(Interp *interp, Optimizer *opt, List l, size_t from)
+{
+    for (size_t i = from; i < l.size; i++) {
+        l.data[i] = optimize_in(interp, opt, l.data[i]);
+    }
+}
+
+// Call a pure primitive if every argument is a constant number.
+static Exp fold_call(Interp *interp, Optimizer *opt, Exp x)
+{
+    List l = AS_LIST(x);
+    Exp proc;
+    if (!standard_value(interp, opt, l.data[0], &proc) || proc.type != EXP_C_PROC) {
+        return x;
+    }
+    int nargs = l.size - 1;
+    for (size_t i = 0; i < sizeof(pure_procs) / sizeof(pure_procs[0]); i++) {
+        if (pure_procs[i].proc != proc.cproc) {
+            continue;
+        }
+        if (nargs < pure_procs[i].min || (pure_procs[i].max != -1 && nargs > pure_procs[i].max)) {
+            return x;
+        }
+        for (size_t j = 1; j < l.size; j++) {
+            if (!is_number(l.data[j])) {
+                return x;
+            }
+        }
+        List args = { .data = l.data + 1, .size = nargs, .cap = nargs };
+        return proc.cproc(interp, args);
+    }
+    return x;
+}
+
+// Drop the non-tail arguments of a (begin ...) that have no effect.
+static Exp prune_begin(Interp *interp, Optimizer *opt, Exp x)
+{
+    List *l = &AS_LIST(x);
+    Exp proc, value;
+    if (l->size < 2 || !standard_value(interp, opt, l->data[0], &proc)
+     || proc.type != EXP_C_PROC || proc.cproc != scheme_begin) {
+        return x;
+    }
+    size_t n = 1;
+    for (size_t i = 1; i < l->size; i++) {
+        if (i == l->size - 1 || !constant_value(l->data[i], &value)) {
+            l->data[n++] = l->data[i];
+        }
+    }
+    l->size = n;
+    return n == 2 ? l->data[1] : x;
+}
+
+// Inlining.
+// A call to a small global procedure, or to a lambda written in place, is
+// replaced with the procedure's body, with the parameters replaced by the
+// arguments. That's only done when every argument is a constant or a local
+// variable that's never assigned, so that the argument has the same value
+// wherever the body uses it. Variables bound inside the body are renamed,
+// so that they can't capture the arguments, and the free variables of a
+// global procedure's body may not be bound at the call site, where they'd
+// refer to something else.
+// Global procedures are only inlined if they are defined once, never set!
+// (see note_definitions) and don't call themselves. As with folding, that
+// is only known of a whole program: in a growing session, a procedure
+// defined once so far could still be defined again, so only lambdas
+// written in place are inlined there.
+
+#define INLINE_BUDGET 24 // biggest body inlined, counting every symbol, constant and list
+#define INLINE_DEPTH  4  // most inlined bodies nested in each other
+
+// Record what names are bound to in interp->definitions: a name defined
+// only by one (define name (lambda ...)) maps to the lambda, any other name
+// that's defined or set! maps to void. Scanning the same form again
+// changes nothing, so a script can be scanned whole before it runs.
+// Forms are scanned once expanded, as a macro use may define or set! a name.
+void note_definitions(Interp *interp, Exp x)
+{
+    if (x.type != EXP_LIST || AS_LIST(x).size == 0) {
+        return;
+    }
+    List l = AS_LIST(x);
+    if (is_form(l.data[0], "quote")) {
+        return;
+    } else if ((is_form(l.data[0], "define") || is_form(l.data[0], "set!"))
+            && l.size > 1 && is_symbol(l.data[1])) {
+        HashTable *defs = &AS_HT(interp->definitions);
+        Exp prev = { .type = EXP_EMPTY };
+        bool found = ht_lookup(defs, l.data[1], &prev);
+        bool lambda = is_form(l.data[0], "define") && l.size == 3
+            && l.data[2].type == EXP_LIST && AS_LIST(l.data[2]).size > 0
+            && is_form(AS_LIST(l.data[2]).data[0], "lambda");
+        bool same = found && prev.type == EXP_LIST && prev.obj == l.data[2].obj;
+        ht_install(defs, l.data[1], lambda && (!found || same) ? l.data[2]
+                                                               : (Exp) { .type = EXP_VOID });
+    }
+    for (size_t i = 0; i < l.size; i++) {
+        note_definitions(interp, l.data[i]);
+    }
+}
+
+// Whether x is (lambda (param...) body), maybe annotated by closure.c.
+static bool is_lambda(Exp x)
+{
+    if (x.type != EXP_LIST || (AS_LIST(x).size != 3 && AS_LIST(x).size != 4) || !is_form(AS_LIST(x).data[0], "lambda")
+     || AS_LIST(x).data[1].type != EXP_LIST) {
+        return false;
+    }
+    List params = AS_LIST(AS_LIST(x).data[1]);
+    for (size_t i = 0; i < params.size; i++) {
+        if (!is_symbol(params.data[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// The size of a body, or -1 if it can't be inlined: if it defines
+// something, sets a parameter or has a guard.
+static int inline_size(Exp x, List params)
+{
+    if (x.type != EXP_LIST || AS_LIST(x).size == 0) {
+        return 1;
+    }
+    List l = AS_LIST(x);
+    if (is_form(l.data[0], "quote")) {
+        return 1;
+    } else if (is_form(l.data[0], "define") || is_form(l.data[0], "guard")
+            || (is_form(l.data[0], "set!") && l.size > 1 && in_list(params, l.data[1]))) {
+        return -1;
+    }
+    int size = 1;
+    for (size_t i = 0; i < l.size; i++) {
+        int n = inline_size(l.data[i], params);
+        if (n < 0) {
+            return -1;
+        }
+        size += n;
+    }
+    return size;
+}
+
+// Copies a body, replacing variables by what they're mapped to.
+typedef struct Renamer {
+    Bindings map;       // innermost last
+    Optimizer *opt;
+    bool check_capture; // fail on free variables bound at the call site
+    bool failed;
+} Renamer;
+
+static Exp rename_var(Renamer *r, Exp var)
+{
+    for (size_t i = r->map.size; i-- > 0; ) {
+        if (exp_eq(r->map.data[i].var, var)) {
+            return r->map.data[i].value;
+        }
+    }
+    if (r->check_capture && is_bound(r->opt, var)) {
+        r->failed = true;
+    }
+    return var;
+}
+
+static Exp bind_fresh(Interp *interp, Renamer *r, Exp var)
+{
+    Exp fresh = gensym(interp, var);
+    bindings_add(interp, &r->map, (Binding) { .var = var, .value = fresh });
+    return fresh;
+}
+
+static Exp rename_in(Interp *interp, Renamer *r, Exp x);
+
+static void rename_from(Interp *interp, Renamer *r, List l, size_t from, Exp res)
+{
+    for (size_t i = from; i < l.size; i++) {
+        list_add(interp, &AS_LIST(res), rename_in(interp, r, l.data[i]));
+    }
+}
+
+// Copy a let, let*, letrec, named let or do form, with fresh names for
+// the variables it binds.
+static Exp rename_binding_form(Interp *interp, Renamer *r, Exp x)
+{
+    List l = AS_LIST(x);
+    Exp op = l.data[0];
+    size_t at = l.size > 1 && is_symbol(l.data[1]) && is_form(op, "let") ? 2 : 1;
+    if (at >= l.size || l.data[at].type != EXP_LIST) {
+        r->failed = true;
+        return x;
+    }
+    List bindings = AS_LIST(l.data[at]);
+    for (size_t i = 0; i < bindings.size; i++) {
+        if (bindings.data[i].type != EXP_LIST || AS_LIST(bindings.data[i]).size == 0
+         || !is_symbol(AS_LIST(bindings.data[i]).data[0])) {
+            r->failed = true;
+            return x;
+        }
+    }
+    bool seq = is_form(op, "let*"), rec = is_form(op, "letrec");
+    Exp res = mklist(interp, (List) VECTOR_INIT());
+    list_add(interp, &AS_LIST(res), op);
+    if (at == 2) {
+        // the name of a named let is only bound in its body
+        list_add(interp, &AS_LIST(res), (Exp) { .type = EXP_EMPTY });
+    }
+    Exp vars = mklist(interp, (List) VECTOR_INIT());
+    Exp inits = mklist(interp, (List) VECTOR_INIT());
+    for (size_t i = 0; rec && i < bindings.size; i++) {
+        list_add(interp, &AS_LIST(vars), bind_fresh(interp, r, AS_LIST(bindings.data[i]).data[0]));
+    }
+    for (size_t i = 0; i < bindings.size; i++) {
+        List b = AS_LIST(bindings.data[i]);
+        list_add(interp, &AS_LIST(inits), b.size > 1 ? rename_in(interp, r, b.data[1])
+                                                     : (Exp) { .type = EXP_EMPTY });
+        if (seq) {
+            list_add(interp, &AS_LIST(vars), bind_fresh(interp, r, b.data[0]));
+        }
+    }
+    for (size_t i = 0; !seq && !rec && i < bindings.size; i++) {
+        list_add(interp, &AS_LIST(vars), bind_fresh(interp, r, AS_LIST(bindings.data[i]).data[0]));
+    }
+    if (at == 2) {
+        AS_LIST(res).data[1] = bind_fresh(interp, r, l.data[1]);
+    }
+    // the steps of do are in the scope of every variable
+    Exp new_bindings = mklist(interp, (List) VECTOR_INIT());
+    for (size_t i = 0; i < bindings.size; i++) {
+        List b = AS_LIST(bindings.data[i]);
+        Exp binding = mklist(interp, (List) VECTOR_INIT());
+        list_add(interp, &AS_LIST(binding), AS_LIST(vars).data[i]);
+        if (b.size > 1) {
+            list_add(interp, &AS_LIST(binding), AS_LIST(inits).data[i]);
+        }
+        rename_from(interp, r, b, 2, binding);
+        list_add(interp, &AS_LIST(new_bindings), binding);
+    }
+    list_add(interp, &AS_LIST(res), new_bindings);
+    rename_from(interp, r, l, at + 1, res);
+    return res;
+}
+
+static Exp rename_in(Interp *interp, Renamer *r, Exp x)
+{
+    if (is_symbol(x)) {
+        return rename_var(r, x);
+    } else if (x.type != EXP_LIST || AS_LIST(x).size == 0) {
+        return x;
+    }
+    List l = AS_LIST(x);
+    Exp op = l.data[0];
+    if (is_form(op, "quote")) {
+        return x;
+    }
+    size_t scope = r->map.size;
+    Exp res;
+    if (is_form(op, "lambda")) {
+        if (!is_lambda(x)) {
+            r->failed = true;
+            return x;
+        }
+        res = mklist(interp, (List) VECTOR_INIT());
+        list_add(interp, &AS_LIST(res), op);
+        Exp params = mklist(interp, (List) VECTOR_INIT());
+        for (size_t i = 0; i < AS_LIST(l.data[1]).size; i++) {
+            list_add(interp, &AS_LIST(params), bind_fresh(interp, r, AS_LIST(l.data[1]).data[i]));
+        }
+        list_add(interp, &AS_LIST(res), params);
+        // without closure.c's annotation, which names the old variables
+        list_add(interp, &AS_LIST(res), rename_in(interp, r, l.data[2]));
+    } else if (is_form(op, "let") || is_form(op, "let*") || is_form(op, "letrec")
+            || is_form(op, "do")) {
+        res = rename_binding_form(interp, r, x);
+    } else {
+        res = mklist(interp, (List) VECTOR_INIT());
+        rename_from(interp, r, l, 0, res);
+    }
+    r->map.size = scope;
+    return res;
+}
+
+// Whether x may replace a parameter: it has the same value wherever the
+// body uses it, and evaluating it has no effect.
+static bool is_simple_arg(Optimizer *opt, Exp x)
+{
+    Exp value;
+    return constant_value(x, &value)
+        || (is_symbol(x) && in_list(opt->bound, x) && !in_list(opt->assigned, x));
+}
+
+// The body of lambda, with its parameters replaced by args, or empty if
+// it can't be inlined.
+static Exp inline_body(Interp *interp, Optimizer *opt, Exp lambda, List args, bool check_capture)
+{
+    List params = AS_LIST(AS_LIST(lambda).data[1]);
+    if (params.size != args.size || opt->depth >= INLINE_DEPTH) {
+        return (Exp) { .type = EXP_EMPTY };
+    }
+    for (size_t i = 0; i < args.size; i++) {
+        if (!is_simple_arg(opt, args.data[i])) {
+            return (Exp) { .type = EXP_EMPTY };
+        }
+    }
+    Renamer r = { .map = VECTOR_INIT(), .opt = opt, .check_capture = check_capture };
+    for (size_t i = 0; i < params.size; i++) {
+        bindings_add(interp, &r.map, (Binding) { .var = params.data[i], .value = args.data[i] });
+    }
+    Exp res = rename_in(interp, &r, AS_LIST(lambda).data[2]);
+    bindings_free(interp, &r.map);
+    if (r.failed) {
+        return (Exp) { .type = EXP_EMPTY };
+    }
+    opt->depth++;
+    res = optimize_in(interp, opt, res);
+    opt->depth--;
+    return res;
+}
+
+static Exp inline_call(Interp *interp, Optimizer *opt, Exp x)
+{
+    List l = AS_LIST(x);
+    Exp op = l.data[0], def, value, res = { .type = EXP_EMPTY };
+    List args = { .data = l.data + 1, .size = l.size - 1, .cap = l.size - 1 };
+    if (is_lambda(op)) {
+        // ((lambda (param...) body) arg...)
+        if (inline_size(AS_LIST(op).data[2], AS_LIST(AS_LIST(op).data[1])) >= 0) {
+            res = inline_body(interp, opt, op, args, false);
+        }
+    } else if (interp->whole_program
+            && global_value(interp, opt, op, &value) && value.type == EXP_PROC
+            && AS_PROC(value).env == interp->global
+            && ht_lookup(&AS_HT(interp->definitions), op, &def) && is_lambda(def)
+            && AS_PROC(value).params.obj == AS_LIST(def).data[1].obj) {
+        // a call to a global procedure that's still the one defined by def
+        Exp body = AS_LIST(def).data[2];
+        int size = inline_size(body, AS_LIST(AS_LIST(def).data[1]));
+        if (size >= 0 && size <= INLINE_BUDGET && !occurs(body, op)) {
+            res = inline_body(interp, opt, def, args, true);
+        }
+    }
+    return res.type == EXP_EMPTY ? x : res;
+}
+
+static Exp optimize_in(Interp *interp, Optimizer *opt, Exp x)
+{
+    Exp value;
+    if (is_symbol(x) && strcmp(AS_SYM(x), "pi") == 0) {
+        // the one constant of the standard environment
+        return standard_value(interp, opt, x, &value) && is_number(value)
+            && value.number == SCHEME_PI ? value : x;
+    } else if (x.type != EXP_LIST || AS_LIST(x).size == 0) {
+        return x;
+    }
+    List l = AS_LIST(x);
+    Exp op = l.data[0];
+    size_t scope = opt->bound.size;
+    if (is_form(op, "quote")) {
+        return x;
+    } else if (is_form(op, "if") && l.size == 4) {
+        l.data[1] = optimize_in(interp, opt, l.data[1]);
+        if (constant_value(l.data[1], &value)) {
+            return optimize_in(interp, opt, l.data[is_true(value) ? 2 : 3]);
+        }
+        optimize_from(interp, opt, l, 2);
+        return x;
+    } else if (is_form(op, "define") || is_form(op, "set!")) {
+        optimize_from(interp, opt, l, 2);
+        return x;
+    } else if (is_form(op, "lambda")) {
+        if (l.size > 1 && l.data[1].type == EXP_LIST) {
+            for (size_t i = 0; i < AS_LIST(l.data[1]).size; i++) {
+                list_add(interp, &opt->bound, AS_LIST(l.data[1]).data[i]);
+            }
+        }
+        optimize_from(interp, opt, l, 2);
+    } else if (is_form(op, "let") || is_form(op, "let*") || is_form(op, "letrec")
+            || is_form(op, "do")) {
+        // the inits are seen as inside the scope too, which only means
+        // less folding in them
+        size_t at = 1;
+        if (l.size > 1 && is_symbol(l.data[1])) {
+            list_add(interp, &opt->bound, l.data[1]); // named let
+            at = 2;
+        }
+        if (at < l.size) {
+            bind_names(interp, opt, l.data[at]);
+        }
+        size_t body = at + 1;
+        if (at < l.size && l.data[at].type == EXP_LIST) {
+            for (size_t i = 0; i < AS_LIST(l.data[at]).size; i++) {
+                Exp b = AS_LIST(l.data[at]).data[i];
+                if (b.type == EXP_LIST) {
+                    optimize_from(interp, opt, AS_LIST(b), 1);
+                }
+            }
+        }
+        if (is_form(op, "do") && body < l.size) {
+            // (test expr...)
+            if (l.data[body].type == EXP_LIST) {
+                optimize_from(interp, opt, AS_LIST(l.data[body]), 0);
+            }
+            body++;
+        }
+        optimize_from(interp, opt, l, body);
+    } else if (is_form(op, "guard")) {
+        if (l.size > 1 && l.data[1].type == EXP_LIST && AS_LIST(l.data[1]).size > 0) {
+            List spec = AS_LIST(l.data[1]);
+            optimize_from(interp, opt, l, 2);
+            list_add(interp, &opt->bound, spec.data[0]);
+            for (size_t i = 1; i < spec.size; i++) {
+                if (spec.data[i].type == EXP_LIST) {
+                    optimize_from(interp, opt, AS_LIST(spec.data[i]), 0);
+                }
+            }
+        }
+    } else if (is_form(op, "cond")) {
+        for (size_t i = 1; i < l.size; i++) {
+            if (l.data[i].type == EXP_LIST) {
+                optimize_from(interp, opt, AS_LIST(l.data[i]), 0);
+            }
+        }
+    } else if (is_form(op, "when") || is_form(op, "unless")
+            || is_form(op, "and") || is_form(op, "or")) {
+        optimize_from(interp, opt, l, 1);
+    } else {
+        optimize_from(interp, opt, l, 0);
+        x = inline_call(interp, opt, x);
+        if (x.type == EXP_LIST) {
+            x = fold_call(interp, opt, x);
+        }
+        if (x.type == EXP_LIST) {
+            x = prune_begin(interp, opt, x);
+        }
+    }
+    opt->bound.size = scope;
+    return x;
+}
+
+Exp optimize(Interp *interp, Exp form)
+{
+    Optimizer opt = { .bound = VECTOR_INIT(), .assigned = VECTOR_INIT(), .depth = 0 };
+    note_definitions(interp, form);
+    find_assigned(interp, &opt, form);
+    Exp res = optimize_in(interp, &opt, form);
+    list_free(interp, &opt.bound);
+    list_free(interp, &opt.assigned);
+    return res;
+}
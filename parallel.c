@@ -0,0 +1,954 @@
+// Parallelism.
+// (future expr) starts evaluating expr on another thread, and (touch f)
+// waits for its value. (parallel-map proc list) and (parallel-for-each proc
+// list) split list into chunks that are mapped on other threads.
+//
+// The work is done by a pool of worker threads, started the first time it's
+// needed, each with an interpreter of its own: its own heap, collector and
+// JIT. Heaps are never shared, so no thread ever has to stop the others to
+// collect: values cross between interpreters as messages, written by the
+// thread that sends them and rebuilt in its own heap by the one that
+// receives them (see Messages). A task thus works on copies: of proc and the
+// elements for parallel-map, of expr and the variables it can see for a
+// future, and of the global variables as they were when the task was made.
+// What a task assigns isn't seen by anyone else, so the procedures should
+// be pure. What a task displays is shown when its result is collected.
+// Without worker threads (SCHEME_THREADS=1, or inside a task), tasks run
+// on the calling thread, but still in an interpreter of their own, so that
+// they work on copies all the same.
+//
+// Each worker has a deque of tasks. It takes its own tasks from the back,
+// and when it has none, steals one from the front of another worker's.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "parallel.h"
+
+#include <pthread.h>
+#include <unistd.h>
+#include "gcobject.h"
+#include "ht.h"
+#include "green.h"
+
+// parallel-map makes this many chunks per worker, so that workers that
+// finish early can steal from the others.
+#define CHUNKS_PER_WORKER 4
+
+// Messages.
+// A value is written as a tag followed by its contents. Objects get an
+// index in the order they're written, and an object that was already
+// written is written again as a reference to its index, so sharing and
+// cycles survive the trip. Procedures go with their environment, except
+// for the global environment: the receiver uses its own.
+
+enum {
+    TAG_NUMBER, TAG_VOID, TAG_EMPTY, TAG_EOF, TAG_C_PROC, TAG_SYMBOL, TAG_LIST,
+    TAG_VECTOR, TAG_HASH_TABLE, TAG_CONDITION, TAG_PROC, TAG_BOX, TAG_PROMISE,
+    TAG_FUTURE, TAG_REF, TAG_GLOBAL, TAG_FRAME, TAG_NONE,
+};
+
+// Objects already written, and their index: an open-addressing table.
+typedef struct Seen {
+    GCObject **keys;
+    size_t *indexes;
+    size_t size;
+    size_t cap;
+} Seen;
+
+typedef struct Sender {
+    Interp *interp;
+    Writer *w;
+    Seen seen;
+    size_t next; // index of the next object
+} Sender;
+
+static void *xcalloc(size_t n, size_t size)
+{
+    void *p = calloc(n, size);
+    if (!p) {
+        abort();
+    }
+    return p;
+}
+
+static size_t hash_ptr(GCObject *obj, size_t cap)
+{
+    return ((uintptr_t) obj >> 4) * 11400714819323198485u & (cap - 1);
+}
+
+static void seen_add(Seen *seen, GCObject *obj, size_t index)
+{
+    if (seen->size + 1 > seen->cap / 2) {
+        Seen grown = {
+            .cap = seen->cap == 0 ? 64 : seen->cap * 2,
+        };
+        grown.keys = xcalloc(grown.cap, sizeof(GCObject *));
+        grown.indexes = xcalloc(grown.cap, sizeof(size_t));
+        for (size_t i = 0; i < seen->cap; i++) {
+            if (seen->keys[i]) {
+                seen_add(&grown, seen->keys[i], seen->indexes[i]);
+            }
+        }
+        free(seen->keys);
+        free(seen->indexes);
+        *seen = grown;
+    }
+    size_t i = hash_ptr(obj, seen->cap);
+    while (seen->keys[i]) {
+        i = (i + 1) & (seen->cap - 1);
+    }
+    seen->keys[i] = obj;
+    seen->indexes[i] = index;
+    seen->size++;
+}
+
+static bool seen_find(Seen *seen, GCObject *obj, size_t *index)
+{
+    if (seen->cap == 0) {
+        return false;
+    }
+    for (size_t i = hash_ptr(obj, seen->cap); seen->keys[i]; i = (i + 1) & (seen->cap - 1)) {
+        if (seen->keys[i] == obj) {
+            *index = seen->indexes[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+static void put_tag(Sender *s, int tag)
+{
+    writer_putc(s->w, (char) tag);
+}
+
+static void put_size(Sender *s, size_t n)
+{
+    writer_write(s->w, (const char *) &n, sizeof(n));
+}
+
+// Write the tag of obj, or a reference to it if it was written already.
+static bool put_obj(Sender *s, GCObject *obj, int tag)
+{
+    size_t index;
+    if (seen_find(&s->seen, obj, &index)) {
+        put_tag(s, TAG_REF);
+        put_size(s, index);
+        return false;
+    }
+    seen_add(&s->seen, obj, s->next++);
+    put_tag(s, tag);
+    return true;
+}
+
+static void settle(Interp *interp, Future *f);
+static void put_exp(Sender *s, Exp x);
+
+static void put_env(Sender *s, Env *env)
+{
+    if (!env) {
+        put_tag(s, TAG_NONE);
+    } else if (env == s->interp->global) {
+        put_tag(s, TAG_GLOBAL);
+    } else if (put_obj(s, env->obj, TAG_FRAME)) {
+        put_size(s, ENV_HT(env).count);
+        HT_FOR_EACH(ENV_HT(env), entry) {
+            if (entry->key.type != EXP_EMPTY) {
+                put_exp(s, entry->key);
+                put_exp(s, entry->value);
+            }
+        }
+        put_env(s, env->outer);
+    }
+}
+
+static void put_elements(Sender *s, List l, size_t from, size_t to)
+{
+    put_size(s, to - from);
+    for (size_t i = from; i < to; i++) {
+        put_exp(s, l.data[i]);
+    }
+}
+
+static void put_exp(Sender *s, Exp x)
+{
+    switch (x.type) {
+    case EXP_NUMBER:
+        put_tag(s, TAG_NUMBER);
+        writer_write(s->w, (const char *) &x.number, sizeof(x.number));
+        break;
+    case EXP_VOID:  put_tag(s, TAG_VOID);  break;
+    case EXP_EMPTY: put_tag(s, TAG_EMPTY); break;
+    case EXP_EOF:   put_tag(s, TAG_EOF);   break;
+    case EXP_C_PROC:
+        // the same function in every interpreter of the process
+        put_tag(s, TAG_C_PROC);
+        writer_write(s->w, (const char *) &x.cproc, sizeof(x.cproc));
+        break;
+    case EXP_SYMBOL:
+        if (put_obj(s, x.obj, TAG_SYMBOL)) {
+            size_t len = strlen(AS_SYM(x)) + 1;
+            put_size(s, len);
+            writer_write(s->w, AS_SYM(x), len);
+        }
+        break;
+    case EXP_LIST:
+        if (put_obj(s, x.obj, TAG_LIST)) {
+            put_elements(s, AS_LIST(x), 0, AS_LIST(x).size);
+        }
+        break;
+    case EXP_VECTOR:
+        if (put_obj(s, x.obj, TAG_VECTOR)) {
+            put_elements(s, AS_VECTOR(x), 0, AS_VECTOR(x).size);
+        }
+        break;
+    case EXP_HASH_TABLE:
+        if (put_obj(s, x.obj, TAG_HASH_TABLE)) {
+            writer_putc(s->w, AS_HT(x).structural);
+            put_size(s, AS_HT(x).count);
+            HT_FOR_EACH(AS_HT(x), entry) {
+                if (entry->key.type != EXP_EMPTY) {
+                    put_exp(s, entry->key);
+                    put_exp(s, entry->value);
+                }
+            }
+        }
+        break;
+    case EXP_CONDITION:
+        if (put_obj(s, x.obj, TAG_CONDITION)) {
+            put_exp(s, AS_CONDITION(x).message);
+            put_exp(s, AS_CONDITION(x).irritants);
+        }
+        break;
+    case EXP_PROC:
+        if (put_obj(s, x.obj, TAG_PROC)) {
+            writer_putc(s->w, AS_PROC(x).stack_frame);
+            put_exp(s, AS_PROC(x).params);
+            put_exp(s, AS_PROC(x).body);
+            put_env(s, AS_PROC(x).env);
+        }
+        break;
+    case EXP_BOX:
+        if (put_obj(s, x.obj, TAG_BOX)) {
+            put_exp(s, x.obj->box);
+        }
+        break;
+    case EXP_PROMISE:
+        if (put_obj(s, x.obj, TAG_PROMISE)) {
+            writer_putc(s->w, AS_PROMISE(x).done);
+            writer_putc(s->w, AS_PROMISE(x).chained);
+            writer_putc(s->w, AS_PROMISE(x).shared);
+            put_exp(s, AS_PROMISE(x).exp);
+            put_env(s, AS_PROMISE(x).env);
+        }
+        break;
+    case EXP_THREAD:
+    case EXP_CHANNEL:
+        // they belong to the green threads of the sending interpreter
+        put_tag(s, TAG_VOID);
+        break;
+    case EXP_FUTURE:
+        // sent once it's computed, so that it's never computed twice
+        if (put_obj(s, x.obj, TAG_FUTURE)) {
+            settle(s->interp, &AS_FUTURE(x));
+            writer_putc(s->w, AS_FUTURE(x).failed);
+            put_exp(s, AS_FUTURE(x).value);
+        }
+        break;
+    }
+}
+
+static void sender_init(Sender *s, Interp *interp, Writer *w)
+{
+    *s = (Sender) { .interp = interp, .w = w };
+}
+
+static void sender_free(Sender *s)
+{
+    free(s->seen.keys);
+    free(s->seen.indexes);
+}
+
+typedef struct Receiver {
+    Interp *interp;
+    const char *p;
+    Exp *objs; // by index; Envs are kept as their object, with type EXP_EMPTY
+    size_t nobjs;
+    size_t cap;
+} Receiver;
+
+static void receiver_init(Receiver *r, Interp *interp, Writer *msg)
+{
+    *r = (Receiver) { .interp = interp, .p = msg->buf };
+}
+
+static void receiver_free(Receiver *r)
+{
+    free(r->objs);
+}
+
+static int get_tag(Receiver *r)
+{
+    return *r->p++;
+}
+
+static size_t get_size(Receiver *r)
+{
+    size_t n;
+    memcpy(&n, r->p, sizeof(n));
+    r->p += sizeof(n);
+    return n;
+}
+
+static Exp got(Receiver *r, Exp x)
+{
+    if (r->nobjs == r->cap) {
+        r->cap = vector_grow_cap(r->cap);
+        r->objs = realloc(r->objs, sizeof(Exp) * r->cap);
+        if (!r->objs) {
+            abort();
+        }
+    }
+    r->objs[r->nobjs++] = x;
+    return x;
+}
+
+static Exp get_exp(Receiver *r);
+
+static Env *get_env(Receiver *r)
+{
+    switch (get_tag(r)) {
+    case TAG_NONE:   return NULL;
+    case TAG_GLOBAL: return r->interp->global;
+    case TAG_REF:    return &r->objs[get_size(r)].obj->frame.env;
+    default:         break; // TAG_FRAME
+    }
+    Env *env = new_env(r->interp, NULL);
+    got(r, (Exp) { .type = EXP_EMPTY, .obj = env->obj });
+    for (size_t n = get_size(r); n > 0; n--) {
+        Exp key = get_exp(r);
+        Exp value = get_exp(r);
+        ht_install(&ENV_HT(env), key, value);
+    }
+    env->outer = get_env(r);
+    return env;
+}
+
+static void get_elements(Receiver *r, List *l)
+{
+    for (size_t n = get_size(r); n > 0; n--) {
+        Exp x = get_exp(r);
+        list_add(r->interp, l, x);
+    }
+}
+
+static Exp get_exp(Receiver *r)
+{
+    Interp *interp = r->interp;
+    Exp x;
+    switch (get_tag(r)) {
+    case TAG_NUMBER:
+        x = mknum(0);
+        memcpy(&x.number, r->p, sizeof(x.number));
+        r->p += sizeof(x.number);
+        return x;
+    case TAG_VOID:  return (Exp) { .type = EXP_VOID };
+    case TAG_EMPTY: return (Exp) { .type = EXP_EMPTY };
+    case TAG_EOF:   return (Exp) { .type = EXP_EOF };
+    case TAG_C_PROC:
+        x = mkcproc(NULL);
+        memcpy(&x.cproc, r->p, sizeof(x.cproc));
+        r->p += sizeof(x.cproc);
+        return x;
+    case TAG_SYMBOL: {
+        size_t len = get_size(r);
+        x = got(r, interp_symbol(interp, r->p));
+        r->p += len;
+        return x;
+    }
+    case TAG_LIST:
+        x = got(r, mklist(interp, (List) VECTOR_INIT()));
+        get_elements(r, &AS_LIST(x));
+        return x;
+    case TAG_VECTOR:
+        x = got(r, mkvector(interp, (List) VECTOR_INIT()));
+        get_elements(r, &AS_VECTOR(x));
+        return x;
+    case TAG_HASH_TABLE:
+        x = got(r, mkhashtable(interp, *r->p++));
+        for (size_t n = get_size(r); n > 0; n--) {
+            Exp key = get_exp(r);
+            Exp value = get_exp(r);
+            ht_install(&AS_HT(x), key, value);
+        }
+        return x;
+    case TAG_CONDITION: {
+        x = got(r, mkcondition(interp, (Exp) { .type = EXP_VOID }, (Exp) { .type = EXP_VOID }));
+        Exp message = get_exp(r);
+        AS_CONDITION(x).message = message;
+        Exp irritants = get_exp(r);
+        AS_CONDITION(x).irritants = irritants;
+        return x;
+    }
+    case TAG_PROC: {
+        x = got(r, mkproc(interp, (Exp) { .type = EXP_VOID }, (Exp) { .type = EXP_VOID }, NULL));
+        AS_PROC(x).stack_frame = *r->p++;
+        Exp params = get_exp(r);
+        AS_PROC(x).params = params;
+        Exp body = get_exp(r);
+        AS_PROC(x).body = body;
+        Env *env = get_env(r);
+        AS_PROC(x).env = env;
+        return x;
+    }
+    case TAG_BOX: {
+        x = got(r, mkbox(interp, (Exp) { .type = EXP_VOID }));
+        Exp value = get_exp(r);
+        x.obj->box = value;
+        return x;
+    }
+    case TAG_PROMISE: {
+        x = got(r, mkpromise(interp, (Promise) {
+            .done = r->p[0], .chained = r->p[1], .shared = r->p[2]
+        }));
+        r->p += 3;
+        Exp exp = get_exp(r);
+        AS_PROMISE(x).exp = exp;
+        Env *env = get_env(r);
+        AS_PROMISE(x).env = env;
+        return x;
+    }
+    case TAG_FUTURE: {
+        x = got(r, mkfuture(interp, NULL));
+        AS_FUTURE(x).failed = *r->p++;
+        Exp value = get_exp(r);
+        AS_FUTURE(x).value = value;
+        return x;
+    }
+    case TAG_REF:
+        return r->objs[get_size(r)];
+    }
+    abort();
+}
+
+// Tasks and the pool.
+
+// The global variables of the interpreter that owns the pool, as of
+// global_version.
+typedef struct Snapshot {
+    Writer msg;
+    size_t version;
+    int refs;
+} Snapshot;
+
+typedef enum TaskKind { TASK_MAP, TASK_FOR_EACH, TASK_FUTURE } TaskKind;
+
+typedef struct Pool Pool;
+
+typedef struct Task {
+    TaskKind kind;
+    Pool *pool;
+    Writer in;         // proc and elements, or expr and env
+    Snapshot *globals;
+    Writer out;        // the result, or what was raised
+    Writer output;     // what the task displayed
+    bool failed;
+    bool done;
+    int refs;          // the pool's until it's done, and its submitter's
+} Task;
+
+typedef struct Worker {
+    pthread_t thread;
+    Pool *pool;
+    Interp *interp;
+    Snapshot *globals; // the ones interp has
+    Task **tasks;      // deque: a ring buffer
+    size_t head, size, cap;
+} Worker;
+
+struct Pool {
+    pthread_mutex_t lock; // protects everything here and the tasks' state
+    pthread_cond_t work;  // signalled when tasks are added, or to stop
+    pthread_cond_t done;  // signalled when a task is done
+    Worker *workers;
+    size_t nworkers;
+    size_t next;          // worker that gets the next task
+    Snapshot *globals;    // the latest snapshot
+    bool stop;
+};
+
+static void snapshot_release(Snapshot *snapshot)
+{
+    if (snapshot && --snapshot->refs == 0) {
+        writer_free(&snapshot->msg);
+        free(snapshot);
+    }
+}
+
+static Task *new_task(Pool *pool, TaskKind kind)
+{
+    Task *t = xcalloc(1, sizeof(Task));
+    t->kind = kind;
+    t->pool = pool;
+    writer_init(&t->in, -1, 1024);
+    writer_init(&t->out, -1, 1024);
+    writer_init(&t->output, -1, 1024);
+    t->refs = 2;
+    return t;
+}
+
+// Call with the pool locked.
+static void task_release(Task *t)
+{
+    if (--t->refs == 0) {
+        writer_free(&t->in);
+        writer_free(&t->out);
+        writer_free(&t->output);
+        snapshot_release(t->globals);
+        free(t);
+    }
+}
+
+void future_release(Task *t)
+{
+    if (t) {
+        Pool *pool = t->pool;
+        pthread_mutex_lock(&pool->lock);
+        task_release(t);
+        pthread_mutex_unlock(&pool->lock);
+    }
+}
+
+static void push_back(Worker *w, Task *t)
+{
+    if (w->size == w->cap) {
+        size_t cap = vector_grow_cap(w->cap);
+        Task **tasks = xcalloc(cap, sizeof(Task *));
+        for (size_t i = 0; i < w->size; i++) {
+            tasks[i] = w->tasks[(w->head + i) % w->cap];
+        }
+        free(w->tasks);
+        w->tasks = tasks;
+        w->head = 0;
+        w->cap = cap;
+    }
+    w->tasks[(w->head + w->size++) % w->cap] = t;
+}
+
+// Call with the pool locked.
+static Task *take_task(Worker *w)
+{
+    if (w->size > 0) {
+        return w->tasks[(w->head + --w->size) % w->cap];
+    }
+    Pool *pool = w->pool;
+    for (size_t i = 0; i < pool->nworkers; i++) {
+        Worker *victim = &pool->workers[i];
+        if (victim->size > 0) {
+            Task *t = victim->tasks[victim->head];
+            victim->head = (victim->head + 1) % victim->cap;
+            victim->size--;
+            return t;
+        }
+    }
+    return NULL;
+}
+
+static void call(Interp *interp, Exp proc, Exp arg, Exp *res)
+{
+    List args = { .data = &arg, .size = 1, .cap = 1 };
+    *res = proc.type == EXP_C_PROC ? proc.cproc(interp, args)
+                                   : proc_call(interp, &AS_PROC(proc), args);
+}
+
+static void send_value(Interp *interp, Writer *w, Exp x)
+{
+    Sender s;
+    sender_init(&s, interp, w);
+    put_exp(&s, x);
+    sender_free(&s);
+}
+
+static Exp receive_value(Interp *interp, Writer *w)
+{
+    Receiver r;
+    receiver_init(&r, interp, w);
+    Exp x = get_exp(&r);
+    receiver_free(&r);
+    return x;
+}
+
+static void run_task(Interp *interp, void *data)
+{
+    Task *t = data;
+    Receiver r;
+    receiver_init(&r, interp, &t->in);
+    Exp res = { .type = EXP_VOID };
+    if (t->kind == TASK_FUTURE) {
+        Exp exp = get_exp(&r);
+        Env *env = get_env(&r);
+        receiver_free(&r);
+        res = eval(interp, exp, env);
+    } else {
+        Exp proc = get_exp(&r);
+        Exp elems = get_exp(&r);
+        receiver_free(&r);
+        if (t->kind == TASK_MAP) {
+            res = mklist(interp, (List) VECTOR_INIT());
+        }
+        for (size_t i = 0; i < AS_LIST(elems).size; i++) {
+            Exp x;
+            call(interp, proc, AS_LIST(elems).data[i], &x);
+            if (t->kind == TASK_MAP) {
+                list_add(interp, &AS_LIST(res), x);
+            }
+        }
+    }
+    save(interp, res);
+    green_finish(interp);
+    unsave(interp, res);
+    send_value(interp, &t->out, res);
+}
+
+// What the last error caught by interp_try raised.
+static Exp caught(Interp *interp)
+{
+    Exp raised = interp->raised;
+    if (raised.type == EXP_EMPTY) {
+        raised = mkcondition(interp, interp_symbol(interp, interp->error),
+                             mklist(interp, (List) VECTOR_INIT()));
+    }
+    interp->raised = (Exp) { .type = EXP_EMPTY };
+    return raised;
+}
+
+static void work(Worker *w, Task *t)
+{
+    Interp *interp = w->interp;
+    // nothing the last task made is live anymore
+    gc_maybe_collect(interp);
+    if (w->globals != t->globals) {
+        Receiver r;
+        receiver_init(&r, interp, &t->globals->msg);
+        for (size_t n = get_size(&r); n > 0; n--) {
+            Exp name = get_exp(&r);
+            Exp value = get_exp(&r);
+            ht_install(&ENV_HT(interp->global), name, value);
+        }
+        receiver_free(&r);
+        interp->global_version++;
+        pthread_mutex_lock(&w->pool->lock);
+        snapshot_release(w->globals);
+        w->globals = t->globals;
+        w->globals->refs++;
+        pthread_mutex_unlock(&w->pool->lock);
+    }
+    interp->out = &t->output;
+    if (!interp_try(interp, run_task, t)) {
+        writer_clear(&t->out);
+        green_finish(interp);
+        send_value(interp, &t->out, caught(interp));
+        t->failed = true;
+    }
+    interp->out = &interp->stdout_writer;
+}
+
+static void *worker_main(void *data)
+{
+    Worker *w = data;
+    Pool *pool = w->pool;
+    pthread_mutex_lock(&pool->lock);
+    while (!pool->stop) {
+        Task *t = take_task(w);
+        if (!t) {
+            pthread_cond_wait(&pool->work, &pool->lock);
+            continue;
+        }
+        pthread_mutex_unlock(&pool->lock);
+        work(w, t);
+        pthread_mutex_lock(&pool->lock);
+        t->done = true;
+        task_release(t);
+        pthread_cond_broadcast(&pool->done);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+static size_t pool_size(void)
+{
+    const char *env = getenv("SCHEME_THREADS");
+    long n = env ? atol(env) : sysconf(_SC_NPROCESSORS_ONLN);
+    return n < 0 ? 0 : n > PARALLEL_MAX_THREADS ? PARALLEL_MAX_THREADS : (size_t) n;
+}
+
+// The pool of interp. Tasks made inside a task, or with fewer than two
+// threads, get a pool without worker threads, and run on the calling one.
+static Pool *get_pool(Interp *interp)
+{
+    if (!interp->pool) {
+        Pool *pool = xcalloc(1, sizeof(Pool));
+        pthread_mutex_init(&pool->lock, NULL);
+        pthread_cond_init(&pool->work, NULL);
+        pthread_cond_init(&pool->done, NULL);
+        size_t n = pool_size();
+        pool->nworkers = n < 2 || interp->worker ? 0 : n;
+        pool->workers = xcalloc(pool->nworkers + 1, sizeof(Worker));
+        for (size_t i = 0; i < pool->nworkers; i++) {
+            Worker *w = &pool->workers[i];
+            w->pool = pool;
+            w->interp = interp_new();
+            w->interp->worker = true;
+            if (pthread_create(&w->thread, NULL, worker_main, w) != 0) {
+                interp_free(w->interp);
+                pool->nworkers = i; // make do with the others
+                break;
+            }
+        }
+        interp->pool = pool;
+    }
+    return interp->pool;
+}
+
+// A task whose input is written by the caller, with the current globals.
+static Task *make_task(Interp *interp, Pool *pool, TaskKind kind)
+{
+    Snapshot *globals = pool->globals;
+    if (!globals || globals->version != interp->global_version) {
+        globals = xcalloc(1, sizeof(Snapshot));
+        writer_init(&globals->msg, -1, 64 * 1024);
+        globals->version = interp->global_version;
+        globals->refs = 1;
+        Sender s;
+        sender_init(&s, interp, &globals->msg);
+        put_size(&s, ENV_HT(interp->global).count);
+        HT_FOR_EACH(ENV_HT(interp->global), entry) {
+            if (entry->key.type != EXP_EMPTY) {
+                put_exp(&s, entry->key);
+                put_exp(&s, entry->value);
+            }
+        }
+        sender_free(&s);
+        pthread_mutex_lock(&pool->lock);
+        snapshot_release(pool->globals);
+        pool->globals = globals;
+        pthread_mutex_unlock(&pool->lock);
+    }
+    Task *t = new_task(pool, kind);
+    t->globals = globals;
+    pthread_mutex_lock(&pool->lock);
+    globals->refs++;
+    pthread_mutex_unlock(&pool->lock);
+    return t;
+}
+
+// Call with the pool locked.
+static void submit(Pool *pool, Task *t)
+{
+    push_back(&pool->workers[pool->next], t);
+    pool->next = (pool->next + 1) % pool->nworkers;
+}
+
+// Collect the result of a done task: show what it displayed, and set
+// *failed if it raised.
+static Exp collect(Interp *interp, Task *t, bool *failed)
+{
+    writer_write(interp->out, t->output.buf, t->output.len);
+    *failed = t->failed;
+    return receive_value(interp, &t->out);
+}
+
+// Call with the pool locked.
+static void wait_for(Pool *pool, Task *t)
+{
+    while (!t->done) {
+        pthread_cond_wait(&pool->done, &pool->lock);
+    }
+}
+
+// Run t on the calling thread, in a pool without worker threads. Its
+// worker slot holds the interpreter tasks run in there.
+static void run_here(Interp *interp, Pool *pool, Task *t)
+{
+    Worker *w = &pool->workers[0];
+    if (!w->interp) {
+        w->pool = pool;
+        w->interp = interp_new();
+        w->interp->worker = true;
+    }
+    // the task goes on deeper in this thread's C stack
+    w->interp->stack_limit = interp->stack_limit;
+    w->interp->stack_base = interp->stack_base;
+    work(w, t);
+    w->interp->stack_limit = 0;
+    w->interp->stack_base = 0;
+    pthread_mutex_lock(&pool->lock);
+    t->done = true;
+    task_release(t);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+Exp make_future(Interp *interp, Exp exp, Env *env)
+{
+    Pool *pool = get_pool(interp);
+    Task *t = make_task(interp, pool, TASK_FUTURE);
+    Sender s;
+    sender_init(&s, interp, &t->in);
+    put_exp(&s, exp);
+    put_env(&s, env);
+    sender_free(&s);
+    if (pool->nworkers == 0) {
+        // computed now, but errors are still only raised by touch
+        run_here(interp, pool, t);
+        return mkfuture(interp, t);
+    }
+    pthread_mutex_lock(&pool->lock);
+    submit(pool, t);
+    pthread_cond_signal(&pool->work);
+    pthread_mutex_unlock(&pool->lock);
+    return mkfuture(interp, t);
+}
+
+// Wait for f to be computed, and take its result.
+static void settle(Interp *interp, Future *f)
+{
+    Task *t = f->task;
+    if (t) {
+        Pool *pool = t->pool;
+        pthread_mutex_lock(&pool->lock);
+        wait_for(pool, t);
+        pthread_mutex_unlock(&pool->lock);
+        f->value = collect(interp, t, &f->failed);
+        f->task = NULL;
+        future_release(t);
+    }
+}
+
+static Exp touch(Interp *interp, Exp future)
+{
+    settle(interp, &AS_FUTURE(future));
+    if (AS_FUTURE(future).failed) {
+        raise_exp(interp, AS_FUTURE(future).value);
+    }
+    return AS_FUTURE(future).value;
+}
+
+// (touch future): its value, once it's computed. Anything else is its own
+// value.
+Exp scheme_touch(Interp *interp, List args)
+{
+    if (args.size != 1) die(interp, "touch: arity mismatch\n");
+    return args.data[0].type == EXP_FUTURE ? touch(interp, args.data[0]) : args.data[0];
+}
+
+static Exp parallel_map(Interp *interp, List args, TaskKind kind, const char *name)
+{
+    if (args.size != 2) die(interp, "%s: arity mismatch\n", name);
+    if (!is_proc(args.data[0])) die(interp, "%s: argument #1 must be a procedure\n", name);
+    if (args.data[1].type != EXP_LIST) die(interp, "%s: argument #2 must be a list\n", name);
+    Exp proc = args.data[0];
+    List l = AS_LIST(args.data[1]);
+    Exp res = kind == TASK_MAP ? mklist(interp, (List) VECTOR_INIT()) : (Exp) { .type = EXP_VOID };
+    if (l.size == 0) {
+        return res;
+    }
+    Pool *pool = get_pool(interp);
+    size_t nchunks = pool->nworkers > 0 ? pool->nworkers * CHUNKS_PER_WORKER : 1;
+    nchunks = nchunks > l.size ? l.size : nchunks;
+    Task **tasks = xcalloc(nchunks, sizeof(Task *));
+    for (size_t i = 0; i < nchunks; i++) {
+        tasks[i] = make_task(interp, pool, kind);
+        Sender s;
+        sender_init(&s, interp, &tasks[i]->in);
+        put_exp(&s, proc);
+        put_tag(&s, TAG_LIST);
+        s.next++;
+        put_elements(&s, l, l.size * i / nchunks, l.size * (i + 1) / nchunks);
+        sender_free(&s);
+    }
+    if (pool->nworkers == 0) {
+        run_here(interp, pool, tasks[0]);
+    } else {
+        pthread_mutex_lock(&pool->lock);
+        for (size_t i = 0; i < nchunks; i++) {
+            submit(pool, tasks[i]);
+        }
+        pthread_cond_broadcast(&pool->work);
+        for (size_t i = 0; i < nchunks; i++) {
+            wait_for(pool, tasks[i]);
+        }
+        pthread_mutex_unlock(&pool->lock);
+    }
+
+    save(interp, res);
+    Exp raised = { .type = EXP_EMPTY };
+    for (size_t i = 0; i < nchunks; i++) {
+        bool failed;
+        Exp x = collect(interp, tasks[i], &failed);
+        if (failed && raised.type == EXP_EMPTY) {
+            raised = x;
+            save(interp, raised);
+        } else if (kind == TASK_MAP && raised.type == EXP_EMPTY) {
+            for (size_t j = 0; j < AS_LIST(x).size; j++) {
+                list_add(interp, &AS_LIST(res), AS_LIST(x).data[j]);
+            }
+        }
+        future_release(tasks[i]);
+    }
+    free(tasks);
+    if (raised.type != EXP_EMPTY) {
+        unsave(interp, raised);
+        unsave(interp, res);
+        raise_exp(interp, raised);
+    }
+    unsave(interp, res);
+    return res;
+}
+
+// (parallel-map proc list)
+Exp scheme_parallel_map(Interp *interp, List args)
+{
+    return parallel_map(interp, args, TASK_MAP, "parallel-map");
+}
+
+// (parallel-for-each proc list)
+// Like every task, proc works on copies: of itself, the elements and the
+// globals. Whatever it assigns, with set! or vector-set! say, is lost once
+// it returns, whether it ran on a worker thread or on the calling one. What
+// it displays is shown.
+Exp scheme_parallel_for_each(Interp *interp, List args)
+{
+    return parallel_map(interp, args, TASK_FOR_EACH, "parallel-for-each");
+}
+
+void parallel_free(Interp *interp)
+{
+    Pool *pool = interp->pool;
+    if (!pool) {
+        return;
+    }
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = true;
+    pthread_cond_broadcast(&pool->work);
+    pthread_mutex_unlock(&pool->lock);
+    if (pool->nworkers == 0 && pool->workers[0].interp) {
+        snapshot_release(pool->workers[0].globals);
+        interp_free(pool->workers[0].interp);
+    }
+    for (size_t i = 0; i < pool->nworkers; i++) {
+        Worker *w = &pool->workers[i];
+        pthread_join(w->thread, NULL);
+        for (size_t j = 0; j < w->size; j++) {
+            task_release(w->tasks[(w->head + j) % w->cap]);
+        }
+        free(w->tasks);
+        snapshot_release(w->globals);
+        interp_free(w->interp);
+    }
+    snapshot_release(pool->globals);
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->work);
+    pthread_cond_destroy(&pool->done);
+    free(pool->workers);
+    free(pool);
+    interp->pool = NULL;
+}
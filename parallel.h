@@ -0,0 +1,20 @@
+#pragma once
+
+#include "scheme.h"
+
+// Number of worker threads, when the environment variable SCHEME_THREADS
+// doesn't set it: one per core. With fewer than two, or inside a worker,
+// futures and parallel-map run on the calling thread, on copies as usual.
+#define PARALLEL_MAX_THREADS 256
+
+// Start evaluating exp in env on a worker thread, and return a future of
+// its value (see parallel.c).
+Exp make_future(Interp *interp, Exp exp, Env *env);
+// Drop a future's interest in its task; called when the future is freed.
+void future_release(struct Task *task);
+// Stop the worker threads of interp, if it has any.
+void parallel_free(Interp *interp);
+
+Exp scheme_touch(Interp *interp, List args);
+Exp scheme_parallel_map(Interp *interp, List args);
+Exp scheme_parallel_for_each(Interp *interp, List args);
@@ -0,0 +1,189 @@
+#include "profile.h"
+
+#ifdef HEAP_PROFILE
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "scheme.h"
+
+typedef struct Site {
+    char *proc;
+    char *op;
+    size_t bytes;
+    size_t objects;
+    size_t survived;
+} Site;
+
+// Sites are kept in a growable array, indexed by an open-addressing table.
+// The profiler uses plain malloc so that it never shows up in its own report.
+// Interpreters on other threads use the same sites, so every access to
+// them holds the lock.
+static struct {
+    pthread_mutex_t lock;
+    Site *sites;
+    size_t size;
+    size_t cap;
+    int *index;
+    size_t index_cap;
+} prof = { .lock = PTHREAD_MUTEX_INITIALIZER };
+
+static uint32_t hash_site(const char *proc, const char *op)
+{
+    uint32_t hash = 2166136261u;
+    for (const char *p = proc; *p; p++) { hash ^= (uint8_t) *p; hash *= 16777619; }
+    hash ^= 0xff;
+    for (const char *p = op;   *p; p++) { hash ^= (uint8_t) *p; hash *= 16777619; }
+    return hash;
+}
+
+static char *dup_name(const char *s)
+{
+    size_t len = strlen(s);
+    char *dup = malloc(len + 1);
+    if (!dup) {
+        abort();
+    }
+    memcpy(dup, s, len + 1);
+    return dup;
+}
+
+static void grow_index()
+{
+    size_t cap = prof.index_cap < 64 ? 64 : prof.index_cap * 2;
+    int *index = malloc(sizeof(int) * cap);
+    if (!index) {
+        abort();
+    }
+    for (size_t i = 0; i < cap; i++) {
+        index[i] = -1;
+    }
+    for (size_t s = 0; s < prof.size; s++) {
+        uint32_t i = hash_site(prof.sites[s].proc, prof.sites[s].op) & (cap - 1);
+        while (index[i] != -1) {
+            i = (i + 1) & (cap - 1);
+        }
+        index[i] = s;
+    }
+    free(prof.index);
+    prof.index = index;
+    prof.index_cap = cap;
+}
+
+static int find_site(const char *proc, const char *op)
+{
+    if ((prof.size + 1) * 2 > prof.index_cap) {
+        grow_index();
+    }
+    uint32_t i = hash_site(proc, op) & (prof.index_cap - 1);
+    for (; prof.index[i] != -1; i = (i + 1) & (prof.index_cap - 1)) {
+        Site *s = &prof.sites[prof.index[i]];
+        if (strcmp(s->proc, proc) == 0 && strcmp(s->op, op) == 0) {
+            return prof.index[i];
+        }
+    }
+    if (prof.size == prof.cap) {
+        prof.cap = prof.cap < 64 ? 64 : prof.cap * 2;
+        prof.sites = realloc(prof.sites, sizeof(Site) * prof.cap);
+        if (!prof.sites) {
+            abort();
+        }
+    }
+    prof.sites[prof.size] = (Site) { .proc = dup_name(proc), .op = dup_name(op) };
+    prof.index[i] = prof.size;
+    return prof.size++;
+}
+
+int heapprof_site(const char *proc, const char *op)
+{
+    pthread_mutex_lock(&prof.lock);
+    int site = find_site(proc, op);
+    pthread_mutex_unlock(&prof.lock);
+    return site;
+}
+
+int heapprof_set(Interp *interp, int site)
+{
+    int prev = interp->prof_site;
+    interp->prof_site = site;
+    return prev;
+}
+
+int heapprof_current(Interp *interp)
+{
+    if (interp->prof_site == -1) {
+        interp->prof_site = heapprof_site(HEAPPROF_TOPLEVEL, HEAPPROF_EVAL);
+    }
+    return interp->prof_site;
+}
+
+// The name lives as long as the process, as sites are never freed.
+const char *heapprof_proc(Interp *interp)
+{
+    int site = heapprof_current(interp);
+    pthread_mutex_lock(&prof.lock);
+    const char *proc = prof.sites[site].proc;
+    pthread_mutex_unlock(&prof.lock);
+    return proc;
+}
+
+void heapprof_bytes(Interp *interp, size_t bytes)
+{
+    int site = heapprof_current(interp);
+    pthread_mutex_lock(&prof.lock);
+    prof.sites[site].bytes += bytes;
+    pthread_mutex_unlock(&prof.lock);
+}
+
+void heapprof_object(Interp *interp)
+{
+    int site = heapprof_current(interp);
+    pthread_mutex_lock(&prof.lock);
+    prof.sites[site].objects++;
+    pthread_mutex_unlock(&prof.lock);
+}
+
+void heapprof_survived(int site)
+{
+    pthread_mutex_lock(&prof.lock);
+    prof.sites[site].survived++;
+    pthread_mutex_unlock(&prof.lock);
+}
+
+static int compare_sites(const void *a, const void *b)
+{
+    const Site *x = a, *y = b;
+    return x->bytes < y->bytes ? 1 : x->bytes > y->bytes ? -1 : 0;
+}
+
+void heapprof_report()
+{
+    pthread_mutex_lock(&prof.lock);
+    size_t size = prof.size;
+    if (size == 0) {
+        pthread_mutex_unlock(&prof.lock);
+        return;
+    }
+    Site *sorted = malloc(sizeof(Site) * size);
+    if (!sorted) {
+        abort();
+    }
+    memcpy(sorted, prof.sites, sizeof(Site) * size);
+    pthread_mutex_unlock(&prof.lock);
+    qsort(sorted, size, sizeof(Site), compare_sites);
+    fprintf(stderr, "heap profile: %zu sites\n", size);
+    fprintf(stderr, "%14s %10s %10s  site\n", "bytes", "objects", "survived");
+    for (size_t i = 0; i < size; i++) {
+        Site *s = &sorted[i];
+        if (s->bytes == 0 && s->objects == 0) {
+            continue;
+        }
+        fprintf(stderr, "%14zu %10zu %10zu  %s in %s\n",
+            s->bytes, s->objects, s->survived, s->op, s->proc);
+    }
+    free(sorted);
+}
+
+#endif
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <stddef.h>
+
+// Allocation-site heap profiler.
+// A site is the pair (user procedure, operation), e.g. "cons in map".
+// Everything is compiled in only when HEAP_PROFILE is defined
+// (make build=profile); otherwise the hooks are empty.
+// Each interpreter has its own current site, and the sites and their counts
+// are shared by all of them, so worker threads are profiled too.
+
+#ifdef HEAP_PROFILE
+
+typedef struct Interp Interp;
+
+#define HEAPPROF_TOPLEVEL "<toplevel>"
+#define HEAPPROF_EVAL     "<eval>"
+
+// Find (or create) the site for (proc, op).
+int heapprof_site(const char *proc, const char *op);
+
+// Make site the current one of interp and return the previous one.
+int heapprof_set(Interp *interp, int site);
+
+// Name of the user procedure of the current site.
+const char *heapprof_proc(Interp *interp);
+
+int heapprof_current(Interp *interp);
+void heapprof_bytes(Interp *interp, size_t bytes);
+void heapprof_object(Interp *interp);
+void heapprof_survived(int site);
+void heapprof_report();
+
+#endif
@@ -0,0 +1,219 @@
+// Compiled from bench/ack.scm by scheme -c.
+
+#include "scheme.h"
+#include "gcobject.h"
+#include "ht.h"
+
+#define VOID_EXP ((Exp) { .type = EXP_VOID })
+
+static inline noreturn void undefined(Interp *interp, Exp name)
+{
+    die(interp, "undefined symbol: %s\n", AS_SYM(name));
+}
+
+static inline Exp global_ref(Interp *interp, Exp name)
+{
+    Exp value;
+    if (!ht_lookup(&ENV_HT(interp->global), name, &value)) {
+        undefined(interp, name);
+    }
+    return value;
+}
+
+// Raise a stack overflow past the limit run() set, as proc_call does.
+static inline void check_stack(Interp *interp)
+{
+    if ((uintptr_t) __builtin_frame_address(0) < interp->stack_limit) {
+        stack_overflow(interp);
+    }
+}
+
+static inline Exp proc_ref(Interp *interp, Exp proc)
+{
+    if (!is_proc(proc)) {
+        die(interp, "error: not a procedure\n");
+    }
+    return proc;
+}
+
+static inline Exp call(Interp *interp, Exp proc, List args)
+{
+    return proc.type == EXP_C_PROC ? proc.cproc(interp, args)
+                                   : proc_call(interp, &AS_PROC(proc), args);
+}
+
+// Print the value of a top-level form.
+static inline void show(Interp *interp, Exp val)
+{
+    print_to(interp->out, val);
+    if (val.type != EXP_VOID && val.type != EXP_EMPTY) {
+        writer_putc(interp->out, '\n');
+    }
+}
+
+// Run a form the compiler left to the interpreter.
+static inline void eval_form(Interp *interp, Exp form)
+{
+    Exp val = interp_eval(interp, form);
+    show(interp, val);
+    interp_unpin(interp, val);
+}
+
+static Exp sym[3];
+static CProc prim[2];
+static bool defined[1];
+
+static double proc_0_num(Interp *interp, double p0, double p1);
+static Exp proc_0(Interp *interp, Exp p0, Exp p1);
+
+// ack
+static double proc_0_num(Interp *interp, double p0, double p1)
+{
+    check_stack(interp);
+top:;
+    double v3 = (double) (p0 == 0.0);
+    double v11;
+    if (v3 != 0) {
+        double v4 = (0.0 + p1 + 1.0);
+        v11 = v4;
+    } else {
+        double v5 = (double) (p1 == 0.0);
+        if (v5 != 0) {
+            double v6 = (p0 - 1.0);
+            double v7 = 1.0;
+            p0 = v6;
+            p1 = v7;
+            goto top;
+        } else {
+            double v8 = (p0 - 1.0);
+            double v9 = (p1 - 1.0);
+            double v10 = proc_0_num(interp, p0, v9);
+            p0 = v8;
+            p1 = v10;
+            goto top;
+        }
+    }
+    return v11;
+}
+
+// ack
+static Exp proc_0(Interp *interp, Exp p0, Exp p1)
+{
+    check_stack(interp);
+top:;
+    if (is_number(p0) && is_number(p1)) {
+        return mknum(proc_0_num(interp, p0.number, p1.number));
+    }
+    Exp a3_data[] = { p0, mknum(0.0) };
+    List a3 = { .data = a3_data, .size = 2, .cap = 2 };
+    double v4 = scheme_eq(interp, a3).number;
+    double v17;
+    if (v4 != 0) {
+        Exp a5_data[] = { p1, mknum(1.0) };
+        List a5 = { .data = a5_data, .size = 2, .cap = 2 };
+        double v6 = scheme_sum(interp, a5).number;
+        v17 = v6;
+    } else {
+        Exp a7_data[] = { p1, mknum(0.0) };
+        List a7 = { .data = a7_data, .size = 2, .cap = 2 };
+        double v8 = scheme_eq(interp, a7).number;
+        if (v8 != 0) {
+            Exp a9_data[] = { p0, mknum(1.0) };
+            List a9 = { .data = a9_data, .size = 2, .cap = 2 };
+            double v10 = scheme_sub(interp, a9).number;
+            Exp v11 = mknum(1.0);
+            p0 = mknum(v10);
+            p1 = v11;
+            goto top;
+        } else {
+            Exp a12_data[] = { p0, mknum(1.0) };
+            List a12 = { .data = a12_data, .size = 2, .cap = 2 };
+            double v13 = scheme_sub(interp, a12).number;
+            Exp a14_data[] = { p1, mknum(1.0) };
+            List a14 = { .data = a14_data, .size = 2, .cap = 2 };
+            double v15 = scheme_sub(interp, a14).number;
+            Exp v16 = proc_0(interp, p0, mknum(v15));
+            p0 = mknum(v13);
+            p1 = v16;
+            goto top;
+        }
+    }
+    return mknum(v17);
+}
+
+static Exp proc_0_entry(Interp *interp, List args)
+{
+    if (args.size != 2) {
+        die(interp, "%s: arity mismatch\n", "ack");
+    }
+    return proc_0(interp, args.data[0], args.data[1]);
+}
+
+static void init(Interp *interp)
+{
+    sym[0] = interp_symbol(interp, "ack");
+    interp_pin(interp, sym[0]);
+    sym[1] = interp_symbol(interp, "display");
+    interp_pin(interp, sym[1]);
+    sym[2] = interp_symbol(interp, "newline");
+    interp_pin(interp, sym[2]);
+    prim[0] = global_ref(interp, sym[1]).cproc;
+    prim[1] = global_ref(interp, sym[2]).cproc;
+}
+
+static void run(Interp *interp)
+{
+    stack_enter(interp);
+    // (define ack (lambda (m n) (if (= m 0) (+ n 1) (if (= n 0) (ack (- m 1) 1 ...
+    defined[0] = true;
+    interp_define(interp, "ack", mkcproc(proc_0_entry));
+    // (display (ack 2 200))
+    gc_maybe_collect(interp);
+    {
+        if (!defined[0]) {
+            undefined(interp, sym[0]);
+        }
+        double v0 = proc_0_num(interp, 2.0, 200.0);
+        Exp a1_data[] = { mknum(v0) };
+        List a1 = { .data = a1_data, .size = 1, .cap = 1 };
+        Exp v2 = prim[0](interp, a1);
+        show(interp, v2);
+    }
+    // (newline)
+    gc_maybe_collect(interp);
+    {
+        List a0 = VECTOR_INIT();
+        Exp v1 = prim[1](interp, a0);
+        show(interp, v1);
+    }
+    // (display (ack 3 5))
+    gc_maybe_collect(interp);
+    {
+        if (!defined[0]) {
+            undefined(interp, sym[0]);
+        }
+        double v0 = proc_0_num(interp, 3.0, 5.0);
+        Exp a1_data[] = { mknum(v0) };
+        List a1 = { .data = a1_data, .size = 1, .cap = 1 };
+        Exp v2 = prim[0](interp, a1);
+        show(interp, v2);
+    }
+    // (newline)
+    gc_maybe_collect(interp);
+    {
+        List a0 = VECTOR_INIT();
+        Exp v1 = prim[1](interp, a0);
+        show(interp, v1);
+    }
+}
+
+int main(void)
+{
+    Interp *interp = interp_new();
+    // forms left to the interpreter were optimized when compiled
+    interp->optimize = false;
+    init(interp);
+    run(interp);
+    interp_free(interp);
+    return 0;
+}
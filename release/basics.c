@@ -0,0 +1,997 @@
+// Compiled from tests/basics.scm by scheme -c.
+
+#include "scheme.h"
+#include "gcobject.h"
+#include "ht.h"
+
+#define VOID_EXP ((Exp) { .type = EXP_VOID })
+
+static inline noreturn void undefined(Interp *interp, Exp name)
+{
+    die(interp, "undefined symbol: %s\n", AS_SYM(name));
+}
+
+static inline Exp global_ref(Interp *interp, Exp name)
+{
+    Exp value;
+    if (!ht_lookup(&ENV_HT(interp->global), name, &value)) {
+        undefined(interp, name);
+    }
+    return value;
+}
+
+// Raise a stack overflow past the limit run() set, as proc_call does.
+static inline void check_stack(Interp *interp)
+{
+    if ((uintptr_t) __builtin_frame_address(0) < interp->stack_limit) {
+        stack_overflow(interp);
+    }
+}
+
+static inline Exp proc_ref(Interp *interp, Exp proc)
+{
+    if (!is_proc(proc)) {
+        die(interp, "error: not a procedure\n");
+    }
+    return proc;
+}
+
+static inline Exp call(Interp *interp, Exp proc, List args)
+{
+    return proc.type == EXP_C_PROC ? proc.cproc(interp, args)
+                                   : proc_call(interp, &AS_PROC(proc), args);
+}
+
+// Print the value of a top-level form.
+static inline void show(Interp *interp, Exp val)
+{
+    print_to(interp->out, val);
+    if (val.type != EXP_VOID && val.type != EXP_EMPTY) {
+        writer_putc(interp->out, '\n');
+    }
+}
+
+// Run a form the compiler left to the interpreter.
+static inline void eval_form(Interp *interp, Exp form)
+{
+    Exp val = interp_eval(interp, form);
+    show(interp, val);
+    interp_unpin(interp, val);
+}
+
+static Exp sym[48];
+static Exp lit[13];
+static CProc prim[18];
+static bool defined[2];
+
+static double proc_0_num(Interp *interp, double p0);
+static Exp proc_0(Interp *interp, Exp p0);
+
+// square
+static double proc_0_num(Interp *interp, double p0)
+{
+    check_stack(interp);
+    double v2 = (1.0 * p0 * p0);
+    return v2;
+}
+
+// square
+static Exp proc_0(Interp *interp, Exp p0)
+{
+    check_stack(interp);
+    if (is_number(p0)) {
+        return mknum(proc_0_num(interp, p0.number));
+    }
+    Exp a2_data[] = { p0, p0 };
+    List a2 = { .data = a2_data, .size = 2, .cap = 2 };
+    double v3 = scheme_mul(interp, a2).number;
+    return mknum(v3);
+}
+
+static Exp proc_0_entry(Interp *interp, List args)
+{
+    if (args.size != 1) {
+        die(interp, "%s: arity mismatch\n", "square");
+    }
+    return proc_0(interp, args.data[0]);
+}
+
+static void init(Interp *interp)
+{
+    sym[0] = interp_symbol(interp, "square");
+    interp_pin(interp, sym[0]);
+    sym[1] = interp_symbol(interp, "make-counter");
+    interp_pin(interp, sym[1]);
+    sym[2] = interp_symbol(interp, "c");
+    interp_pin(interp, sym[2]);
+    sym[3] = interp_symbol(interp, "+");
+    interp_pin(interp, sym[3]);
+    sym[4] = interp_symbol(interp, "<");
+    interp_pin(interp, sym[4]);
+    sym[5] = interp_symbol(interp, "v");
+    interp_pin(interp, sym[5]);
+    sym[6] = interp_symbol(interp, "h");
+    interp_pin(interp, sym[6]);
+    sym[7] = interp_symbol(interp, "x");
+    interp_pin(interp, sym[7]);
+    sym[8] = interp_symbol(interp, "y");
+    interp_pin(interp, sym[8]);
+    sym[9] = interp_symbol(interp, "define");
+    interp_pin(interp, sym[9]);
+    sym[10] = interp_symbol(interp, "lambda");
+    interp_pin(interp, sym[10]);
+    sym[11] = interp_symbol(interp, "let");
+    interp_pin(interp, sym[11]);
+    sym[12] = interp_symbol(interp, "n");
+    interp_pin(interp, sym[12]);
+    sym[13] = interp_symbol(interp, "begin");
+    interp_pin(interp, sym[13]);
+    sym[14] = interp_symbol(interp, "set!");
+    interp_pin(interp, sym[14]);
+    sym[15] = interp_symbol(interp, "letrec");
+    interp_pin(interp, sym[15]);
+    sym[16] = interp_symbol(interp, "even\?");
+    interp_pin(interp, sym[16]);
+    sym[17] = interp_symbol(interp, "if");
+    interp_pin(interp, sym[17]);
+    sym[18] = interp_symbol(interp, "=");
+    interp_pin(interp, sym[18]);
+    sym[19] = interp_symbol(interp, "odd\?");
+    interp_pin(interp, sym[19]);
+    sym[20] = interp_symbol(interp, "-");
+    interp_pin(interp, sym[20]);
+    sym[21] = interp_symbol(interp, "less");
+    interp_pin(interp, sym[21]);
+    sym[22] = interp_symbol(interp, "more");
+    interp_pin(interp, sym[22]);
+    sym[23] = interp_symbol(interp, "same");
+    interp_pin(interp, sym[23]);
+    sym[24] = interp_symbol(interp, "filter");
+    interp_pin(interp, sym[24]);
+    sym[25] = interp_symbol(interp, ">");
+    interp_pin(interp, sym[25]);
+    sym[26] = interp_symbol(interp, "list");
+    interp_pin(interp, sym[26]);
+    sym[27] = interp_symbol(interp, "b");
+    interp_pin(interp, sym[27]);
+    sym[28] = interp_symbol(interp, "a");
+    interp_pin(interp, sym[28]);
+    sym[29] = interp_symbol(interp, "pair");
+    interp_pin(interp, sym[29]);
+    sym[30] = interp_symbol(interp, "none");
+    interp_pin(interp, sym[30]);
+    sym[31] = interp_symbol(interp, "tmp#1");
+    interp_pin(interp, sym[31]);
+    sym[32] = interp_symbol(interp, "map");
+    interp_pin(interp, sym[32]);
+    sym[33] = interp_symbol(interp, "iota");
+    interp_pin(interp, sym[33]);
+    sym[34] = interp_symbol(interp, "fold-left");
+    interp_pin(interp, sym[34]);
+    sym[35] = interp_symbol(interp, "sort");
+    interp_pin(interp, sym[35]);
+    sym[36] = interp_symbol(interp, "append");
+    interp_pin(interp, sym[36]);
+    sym[37] = interp_symbol(interp, "reverse");
+    interp_pin(interp, sym[37]);
+    sym[38] = interp_symbol(interp, "assq");
+    interp_pin(interp, sym[38]);
+    sym[39] = interp_symbol(interp, "make-vector");
+    interp_pin(interp, sym[39]);
+    sym[40] = interp_symbol(interp, "vector-set!");
+    interp_pin(interp, sym[40]);
+    sym[41] = interp_symbol(interp, "list->vector");
+    interp_pin(interp, sym[41]);
+    sym[42] = interp_symbol(interp, "vector->list");
+    interp_pin(interp, sym[42]);
+    sym[43] = interp_symbol(interp, "make-hash-table");
+    interp_pin(interp, sym[43]);
+    sym[44] = interp_symbol(interp, "hash-table-set!");
+    interp_pin(interp, sym[44]);
+    sym[45] = interp_symbol(interp, "hash-table-ref/default");
+    interp_pin(interp, sym[45]);
+    sym[46] = interp_symbol(interp, "hash-table-count");
+    interp_pin(interp, sym[46]);
+    sym[47] = interp_symbol(interp, "cons");
+    interp_pin(interp, sym[47]);
+    {
+        List d0 = VECTOR_INIT();
+        Exp e1;
+        e1 = sym[9];
+        list_add(interp, &d0, e1);
+        Exp e2;
+        e2 = sym[1];
+        list_add(interp, &d0, e2);
+        Exp e3;
+        {
+            List d4 = VECTOR_INIT();
+            Exp e5;
+            e5 = sym[10];
+            list_add(interp, &d4, e5);
+            Exp e6;
+            {
+                List d7 = VECTOR_INIT();
+                e6 = mklist(interp, d7);
+            }
+            list_add(interp, &d4, e6);
+            Exp e8;
+            {
+                List d9 = VECTOR_INIT();
+                Exp e10;
+                e10 = sym[11];
+                list_add(interp, &d9, e10);
+                Exp e11;
+                {
+                    List d12 = VECTOR_INIT();
+                    Exp e13;
+                    {
+                        List d14 = VECTOR_INIT();
+                        Exp e15;
+                        e15 = sym[12];
+                        list_add(interp, &d14, e15);
+                        Exp e16;
+                        e16 = mknum(0.0);
+                        list_add(interp, &d14, e16);
+                        e13 = mklist(interp, d14);
+                    }
+                    list_add(interp, &d12, e13);
+                    e11 = mklist(interp, d12);
+                }
+                list_add(interp, &d9, e11);
+                Exp e17;
+                {
+                    List d18 = VECTOR_INIT();
+                    Exp e19;
+                    e19 = sym[10];
+                    list_add(interp, &d18, e19);
+                    Exp e20;
+                    {
+                        List d21 = VECTOR_INIT();
+                        e20 = mklist(interp, d21);
+                    }
+                    list_add(interp, &d18, e20);
+                    Exp e22;
+                    {
+                        List d23 = VECTOR_INIT();
+                        Exp e24;
+                        e24 = sym[13];
+                        list_add(interp, &d23, e24);
+                        Exp e25;
+                        {
+                            List d26 = VECTOR_INIT();
+                            Exp e27;
+                            e27 = sym[14];
+                            list_add(interp, &d26, e27);
+                            Exp e28;
+                            e28 = sym[12];
+                            list_add(interp, &d26, e28);
+                            Exp e29;
+                            {
+                                List d30 = VECTOR_INIT();
+                                Exp e31;
+                                e31 = sym[3];
+                                list_add(interp, &d30, e31);
+                                Exp e32;
+                                e32 = sym[12];
+                                list_add(interp, &d30, e32);
+                                Exp e33;
+                                e33 = mknum(1.0);
+                                list_add(interp, &d30, e33);
+                                e29 = mklist(interp, d30);
+                            }
+                            list_add(interp, &d26, e29);
+                            e25 = mklist(interp, d26);
+                        }
+                        list_add(interp, &d23, e25);
+                        Exp e34;
+                        e34 = sym[12];
+                        list_add(interp, &d23, e34);
+                        e22 = mklist(interp, d23);
+                    }
+                    list_add(interp, &d18, e22);
+                    e17 = mklist(interp, d18);
+                }
+                list_add(interp, &d9, e17);
+                e8 = mklist(interp, d9);
+            }
+            list_add(interp, &d4, e8);
+            e3 = mklist(interp, d4);
+        }
+        list_add(interp, &d0, e3);
+        lit[0] = mklist(interp, d0);
+    }
+    interp_pin(interp, lit[0]);
+    {
+        List d35 = VECTOR_INIT();
+        Exp e36;
+        e36 = sym[15];
+        list_add(interp, &d35, e36);
+        Exp e37;
+        {
+            List d38 = VECTOR_INIT();
+            Exp e39;
+            {
+                List d40 = VECTOR_INIT();
+                Exp e41;
+                e41 = sym[16];
+                list_add(interp, &d40, e41);
+                Exp e42;
+                {
+                    List d43 = VECTOR_INIT();
+                    Exp e44;
+                    e44 = sym[10];
+                    list_add(interp, &d43, e44);
+                    Exp e45;
+                    {
+                        List d46 = VECTOR_INIT();
+                        Exp e47;
+                        e47 = sym[12];
+                        list_add(interp, &d46, e47);
+                        e45 = mklist(interp, d46);
+                    }
+                    list_add(interp, &d43, e45);
+                    Exp e48;
+                    {
+                        List d49 = VECTOR_INIT();
+                        Exp e50;
+                        e50 = sym[17];
+                        list_add(interp, &d49, e50);
+                        Exp e51;
+                        {
+                            List d52 = VECTOR_INIT();
+                            Exp e53;
+                            e53 = sym[18];
+                            list_add(interp, &d52, e53);
+                            Exp e54;
+                            e54 = sym[12];
+                            list_add(interp, &d52, e54);
+                            Exp e55;
+                            e55 = mknum(0.0);
+                            list_add(interp, &d52, e55);
+                            e51 = mklist(interp, d52);
+                        }
+                        list_add(interp, &d49, e51);
+                        Exp e56;
+                        e56 = mknum(1.0);
+                        list_add(interp, &d49, e56);
+                        Exp e57;
+                        {
+                            List d58 = VECTOR_INIT();
+                            Exp e59;
+                            e59 = sym[19];
+                            list_add(interp, &d58, e59);
+                            Exp e60;
+                            {
+                                List d61 = VECTOR_INIT();
+                                Exp e62;
+                                e62 = sym[20];
+                                list_add(interp, &d61, e62);
+                                Exp e63;
+                                e63 = sym[12];
+                                list_add(interp, &d61, e63);
+                                Exp e64;
+                                e64 = mknum(1.0);
+                                list_add(interp, &d61, e64);
+                                e60 = mklist(interp, d61);
+                            }
+                            list_add(interp, &d58, e60);
+                            e57 = mklist(interp, d58);
+                        }
+                        list_add(interp, &d49, e57);
+                        e48 = mklist(interp, d49);
+                    }
+                    list_add(interp, &d43, e48);
+                    e42 = mklist(interp, d43);
+                }
+                list_add(interp, &d40, e42);
+                e39 = mklist(interp, d40);
+            }
+            list_add(interp, &d38, e39);
+            Exp e65;
+            {
+                List d66 = VECTOR_INIT();
+                Exp e67;
+                e67 = sym[19];
+                list_add(interp, &d66, e67);
+                Exp e68;
+                {
+                    List d69 = VECTOR_INIT();
+                    Exp e70;
+                    e70 = sym[10];
+                    list_add(interp, &d69, e70);
+                    Exp e71;
+                    {
+                        List d72 = VECTOR_INIT();
+                        Exp e73;
+                        e73 = sym[12];
+                        list_add(interp, &d72, e73);
+                        e71 = mklist(interp, d72);
+                    }
+                    list_add(interp, &d69, e71);
+                    Exp e74;
+                    {
+                        List d75 = VECTOR_INIT();
+                        Exp e76;
+                        e76 = sym[17];
+                        list_add(interp, &d75, e76);
+                        Exp e77;
+                        {
+                            List d78 = VECTOR_INIT();
+                            Exp e79;
+                            e79 = sym[18];
+                            list_add(interp, &d78, e79);
+                            Exp e80;
+                            e80 = sym[12];
+                            list_add(interp, &d78, e80);
+                            Exp e81;
+                            e81 = mknum(0.0);
+                            list_add(interp, &d78, e81);
+                            e77 = mklist(interp, d78);
+                        }
+                        list_add(interp, &d75, e77);
+                        Exp e82;
+                        e82 = mknum(0.0);
+                        list_add(interp, &d75, e82);
+                        Exp e83;
+                        {
+                            List d84 = VECTOR_INIT();
+                            Exp e85;
+                            e85 = sym[16];
+                            list_add(interp, &d84, e85);
+                            Exp e86;
+                            {
+                                List d87 = VECTOR_INIT();
+                                Exp e88;
+                                e88 = sym[20];
+                                list_add(interp, &d87, e88);
+                                Exp e89;
+                                e89 = sym[12];
+                                list_add(interp, &d87, e89);
+                                Exp e90;
+                                e90 = mknum(1.0);
+                                list_add(interp, &d87, e90);
+                                e86 = mklist(interp, d87);
+                            }
+                            list_add(interp, &d84, e86);
+                            e83 = mklist(interp, d84);
+                        }
+                        list_add(interp, &d75, e83);
+                        e74 = mklist(interp, d75);
+                    }
+                    list_add(interp, &d69, e74);
+                    e68 = mklist(interp, d69);
+                }
+                list_add(interp, &d66, e68);
+                e65 = mklist(interp, d66);
+            }
+            list_add(interp, &d38, e65);
+            e37 = mklist(interp, d38);
+        }
+        list_add(interp, &d35, e37);
+        Exp e91;
+        {
+            List d92 = VECTOR_INIT();
+            Exp e93;
+            e93 = sym[16];
+            list_add(interp, &d92, e93);
+            Exp e94;
+            e94 = mknum(100.0);
+            list_add(interp, &d92, e94);
+            e91 = mklist(interp, d92);
+        }
+        list_add(interp, &d35, e91);
+        lit[1] = mklist(interp, d35);
+    }
+    interp_pin(interp, lit[1]);
+    lit[2] = sym[21];
+    interp_pin(interp, lit[2]);
+    lit[3] = sym[22];
+    interp_pin(interp, lit[3]);
+    lit[4] = sym[23];
+    interp_pin(interp, lit[4]);
+    {
+        List d95 = VECTOR_INIT();
+        Exp e96;
+        e96 = sym[24];
+        list_add(interp, &d95, e96);
+        Exp e97;
+        {
+            List d98 = VECTOR_INIT();
+            Exp e99;
+            e99 = sym[10];
+            list_add(interp, &d98, e99);
+            Exp e100;
+            {
+                List d101 = VECTOR_INIT();
+                Exp e102;
+                e102 = sym[7];
+                list_add(interp, &d101, e102);
+                e100 = mklist(interp, d101);
+            }
+            list_add(interp, &d98, e100);
+            Exp e103;
+            {
+                List d104 = VECTOR_INIT();
+                Exp e105;
+                e105 = sym[25];
+                list_add(interp, &d104, e105);
+                Exp e106;
+                e106 = sym[7];
+                list_add(interp, &d104, e106);
+                Exp e107;
+                e107 = mknum(2.0);
+                list_add(interp, &d104, e107);
+                e103 = mklist(interp, d104);
+            }
+            list_add(interp, &d98, e103);
+            e97 = mklist(interp, d98);
+        }
+        list_add(interp, &d95, e97);
+        Exp e108;
+        {
+            List d109 = VECTOR_INIT();
+            Exp e110;
+            e110 = sym[26];
+            list_add(interp, &d109, e110);
+            Exp e111;
+            e111 = mknum(1.0);
+            list_add(interp, &d109, e111);
+            Exp e112;
+            e112 = mknum(2.0);
+            list_add(interp, &d109, e112);
+            Exp e113;
+            e113 = mknum(3.0);
+            list_add(interp, &d109, e113);
+            Exp e114;
+            e114 = mknum(4.0);
+            list_add(interp, &d109, e114);
+            e108 = mklist(interp, d109);
+        }
+        list_add(interp, &d95, e108);
+        lit[5] = mklist(interp, d95);
+    }
+    interp_pin(interp, lit[5]);
+    lit[6] = sym[27];
+    interp_pin(interp, lit[6]);
+    lit[7] = sym[28];
+    interp_pin(interp, lit[7]);
+    lit[8] = sym[27];
+    interp_pin(interp, lit[8]);
+    lit[9] = sym[7];
+    interp_pin(interp, lit[9]);
+    lit[10] = sym[29];
+    interp_pin(interp, lit[10]);
+    lit[11] = sym[30];
+    interp_pin(interp, lit[11]);
+    {
+        List d115 = VECTOR_INIT();
+        Exp e116;
+        e116 = sym[11];
+        list_add(interp, &d115, e116);
+        Exp e117;
+        {
+            List d118 = VECTOR_INIT();
+            Exp e119;
+            {
+                List d120 = VECTOR_INIT();
+                Exp e121;
+                e121 = sym[31];
+                list_add(interp, &d120, e121);
+                Exp e122;
+                e122 = sym[7];
+                list_add(interp, &d120, e122);
+                e119 = mklist(interp, d120);
+            }
+            list_add(interp, &d118, e119);
+            e117 = mklist(interp, d118);
+        }
+        list_add(interp, &d115, e117);
+        Exp e123;
+        {
+            List d124 = VECTOR_INIT();
+            Exp e125;
+            e125 = sym[14];
+            list_add(interp, &d124, e125);
+            Exp e126;
+            e126 = sym[7];
+            list_add(interp, &d124, e126);
+            Exp e127;
+            e127 = sym[8];
+            list_add(interp, &d124, e127);
+            e123 = mklist(interp, d124);
+        }
+        list_add(interp, &d115, e123);
+        Exp e128;
+        {
+            List d129 = VECTOR_INIT();
+            Exp e130;
+            e130 = sym[14];
+            list_add(interp, &d129, e130);
+            Exp e131;
+            e131 = sym[8];
+            list_add(interp, &d129, e131);
+            Exp e132;
+            e132 = sym[31];
+            list_add(interp, &d129, e132);
+            e128 = mklist(interp, d129);
+        }
+        list_add(interp, &d115, e128);
+        lit[12] = mklist(interp, d115);
+    }
+    interp_pin(interp, lit[12]);
+    prim[0] = global_ref(interp, sym[26]).cproc;
+    prim[1] = global_ref(interp, sym[32]).cproc;
+    prim[2] = global_ref(interp, sym[33]).cproc;
+    prim[3] = global_ref(interp, sym[34]).cproc;
+    prim[4] = global_ref(interp, sym[24]).cproc;
+    prim[5] = global_ref(interp, sym[35]).cproc;
+    prim[6] = global_ref(interp, sym[36]).cproc;
+    prim[7] = global_ref(interp, sym[37]).cproc;
+    prim[8] = global_ref(interp, sym[38]).cproc;
+    prim[9] = global_ref(interp, sym[39]).cproc;
+    prim[10] = global_ref(interp, sym[40]).cproc;
+    prim[11] = global_ref(interp, sym[41]).cproc;
+    prim[12] = global_ref(interp, sym[42]).cproc;
+    prim[13] = global_ref(interp, sym[43]).cproc;
+    prim[14] = global_ref(interp, sym[44]).cproc;
+    prim[15] = global_ref(interp, sym[45]).cproc;
+    prim[16] = global_ref(interp, sym[46]).cproc;
+    prim[17] = global_ref(interp, sym[47]).cproc;
+}
+
+static void run(Interp *interp)
+{
+    stack_enter(interp);
+    // (define square (lambda (x) (* x x)))
+    defined[0] = true;
+    interp_define(interp, "square", mkcproc(proc_0_entry));
+    // (map square (list 1 2 3))
+    gc_maybe_collect(interp);
+    {
+        Exp v0 = global_ref(interp, sym[0]);
+        Exp a1_data[] = { mknum(1.0), mknum(2.0), mknum(3.0) };
+        List a1 = { .data = a1_data, .size = 3, .cap = 3 };
+        Exp v2 = prim[0](interp, a1);
+        Exp a3_data[] = { v0, v2 };
+        List a3 = { .data = a3_data, .size = 2, .cap = 2 };
+        Exp v4 = prim[1](interp, a3);
+        show(interp, v4);
+    }
+    // (define make-counter (lambda () (let ((n 0)) (lambda () (begin (set! n ( ...
+    eval_form(interp, lit[0]);
+    // (define c (make-counter))
+    gc_maybe_collect(interp);
+    {
+        Exp v0 = global_ref(interp, sym[1]);
+        Exp v1 = proc_ref(interp, v0);
+        List a2 = VECTOR_INIT();
+        Exp v3 = call(interp, v1, a2);
+        interp_define(interp, "c", v3);
+    }
+    // (c)
+    gc_maybe_collect(interp);
+    {
+        Exp v0 = global_ref(interp, sym[2]);
+        Exp v1 = proc_ref(interp, v0);
+        List a2 = VECTOR_INIT();
+        Exp v3 = call(interp, v1, a2);
+        show(interp, v3);
+    }
+    // (c)
+    gc_maybe_collect(interp);
+    {
+        Exp v0 = global_ref(interp, sym[2]);
+        Exp v1 = proc_ref(interp, v0);
+        List a2 = VECTOR_INIT();
+        Exp v3 = call(interp, v1, a2);
+        show(interp, v3);
+    }
+    // (let* ((a 1) (b (+ a 1))) (list a b))
+    gc_maybe_collect(interp);
+    {
+        double l0 = 1.0;
+        double v1 = (0.0 + l0 + 1.0);
+        double l2 = v1;
+        Exp a3_data[] = { mknum(l0), mknum(l2) };
+        List a3 = { .data = a3_data, .size = 2, .cap = 2 };
+        Exp v4 = prim[0](interp, a3);
+        show(interp, v4);
+    }
+    // (letrec ((even  (lambda (n) (if (= n 0) 1 (odd  (- n 1))))) (odd  (lambd ...
+    eval_form(interp, lit[1]);
+    // (cond (0 (quote less)) (1 (quote more)) (else (quote same)))
+    gc_maybe_collect(interp);
+    {
+        Exp v1;
+        if (0.0 != 0) {
+            v1 = lit[2];
+        } else {
+            Exp v0;
+            if (1.0 != 0) {
+                v0 = lit[3];
+            } else {
+                v0 = lit[4];
+            }
+            v1 = v0;
+        }
+        show(interp, v1);
+    }
+    // (and 1 2 3)
+    gc_maybe_collect(interp);
+    {
+        double v1;
+        if (1.0 != 0) {
+            double v0;
+            if (2.0 != 0) {
+                v0 = 3.0;
+            } else {
+                v0 = 2.0;
+            }
+            v1 = v0;
+        } else {
+            v1 = 1.0;
+        }
+        show(interp, mknum(v1));
+    }
+    // (or 0 0)
+    gc_maybe_collect(interp);
+    {
+        double v0;
+        if (0.0 != 0) {
+            v0 = 0.0;
+        } else {
+            v0 = 0.0;
+        }
+        show(interp, mknum(v0));
+    }
+    // (fold-left + 0 (iota 10))
+    gc_maybe_collect(interp);
+    {
+        Exp v0 = global_ref(interp, sym[3]);
+        Exp a1_data[] = { mknum(10.0) };
+        List a1 = { .data = a1_data, .size = 1, .cap = 1 };
+        Exp v2 = prim[2](interp, a1);
+        Exp a3_data[] = { v0, mknum(0.0), v2 };
+        List a3 = { .data = a3_data, .size = 3, .cap = 3 };
+        Exp v4 = prim[3](interp, a3);
+        show(interp, v4);
+    }
+    // (filter (lambda (x) (> x 2)) (list 1 2 3 4))
+    eval_form(interp, lit[5]);
+    // (sort (list 5 3 1 4 2) <)
+    gc_maybe_collect(interp);
+    {
+        Exp a0_data[] = { mknum(5.0), mknum(3.0), mknum(1.0), mknum(4.0), mknum(2.0) };
+        List a0 = { .data = a0_data, .size = 5, .cap = 5 };
+        Exp v1 = prim[0](interp, a0);
+        Exp v2 = global_ref(interp, sym[4]);
+        Exp a3_data[] = { v1, v2 };
+        List a3 = { .data = a3_data, .size = 2, .cap = 2 };
+        Exp v4 = prim[5](interp, a3);
+        show(interp, v4);
+    }
+    // (reverse (append (list 1 2) (list 3)))
+    gc_maybe_collect(interp);
+    {
+        Exp a0_data[] = { mknum(1.0), mknum(2.0) };
+        List a0 = { .data = a0_data, .size = 2, .cap = 2 };
+        Exp v1 = prim[0](interp, a0);
+        Exp a2_data[] = { mknum(3.0) };
+        List a2 = { .data = a2_data, .size = 1, .cap = 1 };
+        Exp v3 = prim[0](interp, a2);
+        Exp a4_data[] = { v1, v3 };
+        List a4 = { .data = a4_data, .size = 2, .cap = 2 };
+        Exp v5 = prim[6](interp, a4);
+        Exp a6_data[] = { v5 };
+        List a6 = { .data = a6_data, .size = 1, .cap = 1 };
+        Exp v7 = prim[7](interp, a6);
+        show(interp, v7);
+    }
+    // (assq (quote b) (list (list (quote a) 1) (list (quote b) 2)))
+    gc_maybe_collect(interp);
+    {
+        Exp a0_data[] = { lit[7], mknum(1.0) };
+        List a0 = { .data = a0_data, .size = 2, .cap = 2 };
+        Exp v1 = prim[0](interp, a0);
+        Exp a2_data[] = { lit[8], mknum(2.0) };
+        List a2 = { .data = a2_data, .size = 2, .cap = 2 };
+        Exp v3 = prim[0](interp, a2);
+        Exp a4_data[] = { v1, v3 };
+        List a4 = { .data = a4_data, .size = 2, .cap = 2 };
+        Exp v5 = prim[0](interp, a4);
+        Exp a6_data[] = { lit[6], v5 };
+        List a6 = { .data = a6_data, .size = 2, .cap = 2 };
+        Exp v7 = prim[8](interp, a6);
+        show(interp, v7);
+    }
+    // (define v (make-vector 3 0))
+    gc_maybe_collect(interp);
+    {
+        Exp a0_data[] = { mknum(3.0), mknum(0.0) };
+        List a0 = { .data = a0_data, .size = 2, .cap = 2 };
+        Exp v1 = prim[9](interp, a0);
+        interp_define(interp, "v", v1);
+    }
+    // (vector-set! v 1 (quote x))
+    gc_maybe_collect(interp);
+    {
+        Exp v0 = global_ref(interp, sym[5]);
+        Exp a1_data[] = { v0, mknum(1.0), lit[9] };
+        List a1 = { .data = a1_data, .size = 3, .cap = 3 };
+        Exp v2 = prim[10](interp, a1);
+        show(interp, v2);
+    }
+    // v
+    gc_maybe_collect(interp);
+    {
+        Exp v0 = global_ref(interp, sym[5]);
+        show(interp, v0);
+    }
+    // (vector->list (list->vector (list 1 2 3)))
+    gc_maybe_collect(interp);
+    {
+        Exp a0_data[] = { mknum(1.0), mknum(2.0), mknum(3.0) };
+        List a0 = { .data = a0_data, .size = 3, .cap = 3 };
+        Exp v1 = prim[0](interp, a0);
+        Exp a2_data[] = { v1 };
+        List a2 = { .data = a2_data, .size = 1, .cap = 1 };
+        Exp v3 = prim[11](interp, a2);
+        Exp a4_data[] = { v3 };
+        List a4 = { .data = a4_data, .size = 1, .cap = 1 };
+        Exp v5 = prim[12](interp, a4);
+        show(interp, v5);
+    }
+    // (define h (make-hash-table))
+    gc_maybe_collect(interp);
+    {
+        List a0 = VECTOR_INIT();
+        Exp v1 = prim[13](interp, a0);
+        interp_define(interp, "h", v1);
+    }
+    // (hash-table-set! h (list 1 2) (quote pair))
+    gc_maybe_collect(interp);
+    {
+        Exp v0 = global_ref(interp, sym[6]);
+        Exp a1_data[] = { mknum(1.0), mknum(2.0) };
+        List a1 = { .data = a1_data, .size = 2, .cap = 2 };
+        Exp v2 = prim[0](interp, a1);
+        Exp a3_data[] = { v0, v2, lit[10] };
+        List a3 = { .data = a3_data, .size = 3, .cap = 3 };
+        Exp v4 = prim[14](interp, a3);
+        show(interp, v4);
+    }
+    // (hash-table-ref/default h (list 1 2) (quote none))
+    gc_maybe_collect(interp);
+    {
+        Exp v0 = global_ref(interp, sym[6]);
+        Exp a1_data[] = { mknum(1.0), mknum(2.0) };
+        List a1 = { .data = a1_data, .size = 2, .cap = 2 };
+        Exp v2 = prim[0](interp, a1);
+        Exp a3_data[] = { v0, v2, lit[11] };
+        List a3 = { .data = a3_data, .size = 3, .cap = 3 };
+        Exp v4 = prim[15](interp, a3);
+        show(interp, v4);
+    }
+    // (hash-table-count h)
+    gc_maybe_collect(interp);
+    {
+        Exp v0 = global_ref(interp, sym[6]);
+        Exp a1_data[] = { v0 };
+        List a1 = { .data = a1_data, .size = 1, .cap = 1 };
+        Exp v2 = prim[16](interp, a1);
+        show(interp, v2);
+    }
+    // (do ((i 0 (+ i 1)) (acc (list) (cons i acc))) ((= i 3) acc))
+    gc_maybe_collect(interp);
+    {
+        List a0 = VECTOR_INIT();
+        Exp v1 = prim[0](interp, a0);
+        double l2 = 0.0;
+        Exp l3 = v1;
+        for (;;) {
+            double v4 = (double) (l2 == 3.0);
+            if (v4 != 0) {
+                break;
+            }
+            double v5 = (0.0 + l2 + 1.0);
+            Exp a6_data[] = { mknum(l2), l3 };
+            List a6 = { .data = a6_data, .size = 2, .cap = 2 };
+            Exp v7 = prim[17](interp, a6);
+            l2 = v5;
+            l3 = v7;
+        }
+        show(interp, l3);
+    }
+    // (let loop ((i 0) (acc 0)) (if (= i 100) acc (loop (+ i 1) (+ acc i))))
+    gc_maybe_collect(interp);
+    {
+        double l2 = 0.0;
+        double l3 = 0.0;
+        double v8;
+        loop0:;
+        double v4 = (double) (l2 == 100.0);
+        double v7;
+        if (v4 != 0) {
+            v7 = l3;
+        } else {
+            double v5 = (0.0 + l2 + 1.0);
+            double v6 = (0.0 + l3 + l2);
+            l2 = v5;
+            l3 = v6;
+            goto loop0;
+        }
+        v8 = v7;
+        show(interp, mknum(v8));
+    }
+    // (define x 1)
+    gc_maybe_collect(interp);
+    {
+        interp_define(interp, "x", mknum(1.0));
+    }
+    // (define y 2)
+    gc_maybe_collect(interp);
+    {
+        interp_define(interp, "y", mknum(2.0));
+    }
+    // (let ((tmp#1 x)) (set! x y) (set! y tmp#1))
+    eval_form(interp, lit[12]);
+    // (list x y)
+    gc_maybe_collect(interp);
+    {
+        Exp v0 = global_ref(interp, sym[7]);
+        Exp v1 = global_ref(interp, sym[8]);
+        Exp a2_data[] = { v0, v1 };
+        List a2 = { .data = a2_data, .size = 2, .cap = 2 };
+        Exp v3 = prim[0](interp, a2);
+        show(interp, v3);
+    }
+    // 0.1
+    gc_maybe_collect(interp);
+    {
+        show(interp, mknum(0.1));
+    }
+    // 0.30000000000000004
+    gc_maybe_collect(interp);
+    {
+        show(interp, mknum(0.30000000000000004));
+    }
+    // 9.999999999999999e+22
+    gc_maybe_collect(interp);
+    {
+        show(interp, mknum(9.999999999999999e+22));
+    }
+    // 5e-324
+    gc_maybe_collect(interp);
+    {
+        show(interp, mknum(5e-324));
+    }
+    // -0.0
+    gc_maybe_collect(interp);
+    {
+        show(interp, mknum(-0.0));
+    }
+    // 3.141592653589793
+    gc_maybe_collect(interp);
+    {
+        show(interp, mknum(3.141592653589793));
+    }
+    // (list -2.5 1.5e+300 0.5)
+    gc_maybe_collect(interp);
+    {
+        Exp a0_data[] = { mknum(-2.5), mknum(1.5e+300), mknum(0.5) };
+        List a0 = { .data = a0_data, .size = 3, .cap = 3 };
+        Exp v1 = prim[0](interp, a0);
+        show(interp, v1);
+    }
+}
+
+int main(void)
+{
+    Interp *interp = interp_new();
+    // forms left to the interpreter were optimized when compiled
+    interp->optimize = false;
+    init(interp);
+    run(interp);
+    interp_free(interp);
+    return 0;
+}
@@ -0,0 +1,210 @@
+// Compiled from /tmp/cd.scm by scheme -c.
+
+#include "scheme.h"
+#include "gcobject.h"
+#include "ht.h"
+
+#define VOID_EXP ((Exp) { .type = EXP_VOID })
+
+static inline noreturn void undefined(Interp *interp, Exp name)
+{
+    die(interp, "undefined symbol: %s\n", AS_SYM(name));
+}
+
+static inline Exp global_ref(Interp *interp, Exp name)
+{
+    Exp value;
+    if (!ht_lookup(&ENV_HT(interp->global), name, &value)) {
+        undefined(interp, name);
+    }
+    return value;
+}
+
+// Raise a stack overflow past the limit run() set, as proc_call does.
+static inline void check_stack(Interp *interp)
+{
+    if ((uintptr_t) __builtin_frame_address(0) < interp->stack_limit) {
+        stack_overflow(interp);
+    }
+}
+
+static inline Exp proc_ref(Interp *interp, Exp proc)
+{
+    if (!is_proc(proc)) {
+        die(interp, "error: not a procedure\n");
+    }
+    return proc;
+}
+
+static inline Exp call(Interp *interp, Exp proc, List args)
+{
+    return proc.type == EXP_C_PROC ? proc.cproc(interp, args)
+                                   : proc_call(interp, &AS_PROC(proc), args);
+}
+
+// Print the value of a top-level form.
+static inline void show(Interp *interp, Exp val)
+{
+    print_to(interp->out, val);
+    if (val.type != EXP_VOID && val.type != EXP_EMPTY) {
+        writer_putc(interp->out, '\n');
+    }
+}
+
+// Run a form the compiler left to the interpreter.
+static inline void eval_form(Interp *interp, Exp form)
+{
+    Exp val = interp_eval(interp, form);
+    show(interp, val);
+    interp_unpin(interp, val);
+}
+
+static Exp sym[5];
+static Exp lit[1];
+static bool defined[1];
+
+static double proc_0_num(Interp *interp, double p0);
+static Exp proc_0(Interp *interp, Exp p0);
+
+// count-down
+static double proc_0_num(Interp *interp, double p0)
+{
+    check_stack(interp);
+    double v2 = (double) (p0 == 0.0);
+    double v6;
+    if (v2 != 0) {
+        v6 = 0.0;
+    } else {
+        double v3 = (p0 - 1.0);
+        double v4 = proc_0_num(interp, v3);
+        double v5 = (0.0 + 1.0 + v4);
+        v6 = v5;
+    }
+    return v6;
+}
+
+// count-down
+static Exp proc_0(Interp *interp, Exp p0)
+{
+    check_stack(interp);
+    if (is_number(p0)) {
+        return mknum(proc_0_num(interp, p0.number));
+    }
+    Exp a2_data[] = { p0, mknum(0.0) };
+    List a2 = { .data = a2_data, .size = 2, .cap = 2 };
+    double v3 = scheme_eq(interp, a2).number;
+    double v8;
+    if (v3 != 0) {
+        v8 = 0.0;
+    } else {
+        Exp a4_data[] = { p0, mknum(1.0) };
+        List a4 = { .data = a4_data, .size = 2, .cap = 2 };
+        double v5 = scheme_sub(interp, a4).number;
+        double v6 = proc_0_num(interp, v5);
+        double v7 = (0.0 + 1.0 + v6);
+        v8 = v7;
+    }
+    return mknum(v8);
+}
+
+static Exp proc_0_entry(Interp *interp, List args)
+{
+    if (args.size != 1) {
+        die(interp, "%s: arity mismatch\n", "count-down");
+    }
+    return proc_0(interp, args.data[0]);
+}
+
+static void init(Interp *interp)
+{
+    sym[0] = interp_symbol(interp, "count-down");
+    interp_pin(interp, sym[0]);
+    sym[1] = interp_symbol(interp, "guard");
+    interp_pin(interp, sym[1]);
+    sym[2] = interp_symbol(interp, "e");
+    interp_pin(interp, sym[2]);
+    sym[3] = interp_symbol(interp, "quote");
+    interp_pin(interp, sym[3]);
+    sym[4] = interp_symbol(interp, "too-deep");
+    interp_pin(interp, sym[4]);
+    {
+        List d0 = VECTOR_INIT();
+        Exp e1;
+        e1 = sym[1];
+        list_add(interp, &d0, e1);
+        Exp e2;
+        {
+            List d3 = VECTOR_INIT();
+            Exp e4;
+            e4 = sym[2];
+            list_add(interp, &d3, e4);
+            Exp e5;
+            {
+                List d6 = VECTOR_INIT();
+                Exp e7;
+                e7 = mknum(1.0);
+                list_add(interp, &d6, e7);
+                Exp e8;
+                {
+                    List d9 = VECTOR_INIT();
+                    Exp e10;
+                    e10 = sym[3];
+                    list_add(interp, &d9, e10);
+                    Exp e11;
+                    e11 = sym[4];
+                    list_add(interp, &d9, e11);
+                    e8 = mklist(interp, d9);
+                }
+                list_add(interp, &d6, e8);
+                e5 = mklist(interp, d6);
+            }
+            list_add(interp, &d3, e5);
+            e2 = mklist(interp, d3);
+        }
+        list_add(interp, &d0, e2);
+        Exp e12;
+        {
+            List d13 = VECTOR_INIT();
+            Exp e14;
+            e14 = sym[0];
+            list_add(interp, &d13, e14);
+            Exp e15;
+            e15 = mknum(100000000.0);
+            list_add(interp, &d13, e15);
+            e12 = mklist(interp, d13);
+        }
+        list_add(interp, &d0, e12);
+        lit[0] = mklist(interp, d0);
+    }
+    interp_pin(interp, lit[0]);
+}
+
+static void run(Interp *interp)
+{
+    stack_enter(interp);
+    // (define count-down (lambda (n) (if (= n 0) 0 (+ 1 (count-down (- n 1)))) ...
+    defined[0] = true;
+    interp_define(interp, "count-down", mkcproc(proc_0_entry));
+    // (guard (e (1 (quote too-deep))) (count-down 100000000))
+    eval_form(interp, lit[0]);
+    // (count-down 10)
+    gc_maybe_collect(interp);
+    {
+        if (!defined[0]) {
+            undefined(interp, sym[0]);
+        }
+        double v0 = proc_0_num(interp, 10.0);
+        show(interp, mknum(v0));
+    }
+}
+
+int main(void)
+{
+    Interp *interp = interp_new();
+    // forms left to the interpreter were optimized when compiled
+    interp->optimize = false;
+    init(interp);
+    run(interp);
+    interp_free(interp);
+    return 0;
+}
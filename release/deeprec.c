@@ -0,0 +1,312 @@
+// Compiled from bench/deeprec.scm by scheme -c.
+
+#include "scheme.h"
+#include "gcobject.h"
+#include "ht.h"
+
+#define VOID_EXP ((Exp) { .type = EXP_VOID })
+
+static inline noreturn void undefined(Interp *interp, Exp name)
+{
+    die(interp, "undefined symbol: %s\n", AS_SYM(name));
+}
+
+static inline Exp global_ref(Interp *interp, Exp name)
+{
+    Exp value;
+    if (!ht_lookup(&ENV_HT(interp->global), name, &value)) {
+        undefined(interp, name);
+    }
+    return value;
+}
+
+// Raise a stack overflow past the limit run() set, as proc_call does.
+static inline void check_stack(Interp *interp)
+{
+    if ((uintptr_t) __builtin_frame_address(0) < interp->stack_limit) {
+        stack_overflow(interp);
+    }
+}
+
+static inline Exp proc_ref(Interp *interp, Exp proc)
+{
+    if (!is_proc(proc)) {
+        die(interp, "error: not a procedure\n");
+    }
+    return proc;
+}
+
+static inline Exp call(Interp *interp, Exp proc, List args)
+{
+    return proc.type == EXP_C_PROC ? proc.cproc(interp, args)
+                                   : proc_call(interp, &AS_PROC(proc), args);
+}
+
+// Print the value of a top-level form.
+static inline void show(Interp *interp, Exp val)
+{
+    print_to(interp->out, val);
+    if (val.type != EXP_VOID && val.type != EXP_EMPTY) {
+        writer_putc(interp->out, '\n');
+    }
+}
+
+// Run a form the compiler left to the interpreter.
+static inline void eval_form(Interp *interp, Exp form)
+{
+    Exp val = interp_eval(interp, form);
+    show(interp, val);
+    interp_unpin(interp, val);
+}
+
+static Exp sym[7];
+static Exp lit[2];
+static CProc prim[4];
+static bool defined[3];
+
+static double proc_0_num(Interp *interp, double p0);
+static Exp proc_0(Interp *interp, Exp p0);
+static Exp proc_1(Interp *interp, Exp p0);
+static double proc_2_num(Interp *interp, double p0, double p1);
+static Exp proc_2(Interp *interp, Exp p0, Exp p1);
+
+// count-down
+static double proc_0_num(Interp *interp, double p0)
+{
+    check_stack(interp);
+    double v2 = (double) (p0 == 0.0);
+    double v6;
+    if (v2 != 0) {
+        v6 = 0.0;
+    } else {
+        double v3 = (p0 - 1.0);
+        double v4 = proc_0_num(interp, v3);
+        double v5 = (0.0 + 1.0 + v4);
+        v6 = v5;
+    }
+    return v6;
+}
+
+// count-down
+static Exp proc_0(Interp *interp, Exp p0)
+{
+    check_stack(interp);
+    if (is_number(p0)) {
+        return mknum(proc_0_num(interp, p0.number));
+    }
+    Exp a2_data[] = { p0, mknum(0.0) };
+    List a2 = { .data = a2_data, .size = 2, .cap = 2 };
+    double v3 = scheme_eq(interp, a2).number;
+    double v8;
+    if (v3 != 0) {
+        v8 = 0.0;
+    } else {
+        Exp a4_data[] = { p0, mknum(1.0) };
+        List a4 = { .data = a4_data, .size = 2, .cap = 2 };
+        double v5 = scheme_sub(interp, a4).number;
+        double v6 = proc_0_num(interp, v5);
+        double v7 = (0.0 + 1.0 + v6);
+        v8 = v7;
+    }
+    return mknum(v8);
+}
+
+static Exp proc_0_entry(Interp *interp, List args)
+{
+    if (args.size != 1) {
+        die(interp, "%s: arity mismatch\n", "count-down");
+    }
+    return proc_0(interp, args.data[0]);
+}
+
+// build
+static Exp proc_1(Interp *interp, Exp p0)
+{
+    check_stack(interp);
+    Exp a2_data[] = { p0, mknum(0.0) };
+    List a2 = { .data = a2_data, .size = 2, .cap = 2 };
+    double v3 = scheme_eq(interp, a2).number;
+    Exp v9;
+    if (v3 != 0) {
+        v9 = lit[1];
+    } else {
+        Exp a4_data[] = { p0, mknum(1.0) };
+        List a4 = { .data = a4_data, .size = 2, .cap = 2 };
+        double v5 = scheme_sub(interp, a4).number;
+        Exp v6 = proc_1(interp, mknum(v5));
+        Exp a7_data[] = { p0, v6 };
+        List a7 = { .data = a7_data, .size = 2, .cap = 2 };
+        Exp v8 = prim[0](interp, a7);
+        v9 = v8;
+    }
+    return v9;
+}
+
+static Exp proc_1_entry(Interp *interp, List args)
+{
+    if (args.size != 1) {
+        die(interp, "%s: arity mismatch\n", "build");
+    }
+    return proc_1(interp, args.data[0]);
+}
+
+// repeat
+static double proc_2_num(Interp *interp, double p0, double p1)
+{
+    check_stack(interp);
+top:;
+    double v3 = (double) (p0 == 0.0);
+    double v7;
+    if (v3 != 0) {
+        v7 = p1;
+    } else {
+        double v4 = (p0 - 1.0);
+        if (!defined[0]) {
+            undefined(interp, sym[0]);
+        }
+        double v5 = proc_0_num(interp, 3000.0);
+        double v6 = (0.0 + p1 + v5);
+        p0 = v4;
+        p1 = v6;
+        goto top;
+    }
+    return v7;
+}
+
+// repeat
+static Exp proc_2(Interp *interp, Exp p0, Exp p1)
+{
+    check_stack(interp);
+top:;
+    if (is_number(p0) && is_number(p1)) {
+        return mknum(proc_2_num(interp, p0.number, p1.number));
+    }
+    Exp a3_data[] = { p0, mknum(0.0) };
+    List a3 = { .data = a3_data, .size = 2, .cap = 2 };
+    double v4 = scheme_eq(interp, a3).number;
+    Exp v10;
+    if (v4 != 0) {
+        v10 = p1;
+    } else {
+        Exp a5_data[] = { p0, mknum(1.0) };
+        List a5 = { .data = a5_data, .size = 2, .cap = 2 };
+        double v6 = scheme_sub(interp, a5).number;
+        if (!defined[0]) {
+            undefined(interp, sym[0]);
+        }
+        double v7 = proc_0_num(interp, 3000.0);
+        Exp a8_data[] = { p1, mknum(v7) };
+        List a8 = { .data = a8_data, .size = 2, .cap = 2 };
+        double v9 = scheme_sum(interp, a8).number;
+        p0 = mknum(v6);
+        p1 = mknum(v9);
+        goto top;
+    }
+    return v10;
+}
+
+static Exp proc_2_entry(Interp *interp, List args)
+{
+    if (args.size != 2) {
+        die(interp, "%s: arity mismatch\n", "repeat");
+    }
+    return proc_2(interp, args.data[0], args.data[1]);
+}
+
+static void init(Interp *interp)
+{
+    sym[0] = interp_symbol(interp, "count-down");
+    interp_pin(interp, sym[0]);
+    sym[1] = interp_symbol(interp, "repeat");
+    interp_pin(interp, sym[1]);
+    sym[2] = interp_symbol(interp, "build");
+    interp_pin(interp, sym[2]);
+    sym[3] = interp_symbol(interp, "cons");
+    interp_pin(interp, sym[3]);
+    sym[4] = interp_symbol(interp, "display");
+    interp_pin(interp, sym[4]);
+    sym[5] = interp_symbol(interp, "newline");
+    interp_pin(interp, sym[5]);
+    sym[6] = interp_symbol(interp, "length");
+    interp_pin(interp, sym[6]);
+    {
+        List d0 = VECTOR_INIT();
+        lit[0] = mklist(interp, d0);
+    }
+    interp_pin(interp, lit[0]);
+    {
+        List d1 = VECTOR_INIT();
+        lit[1] = mklist(interp, d1);
+    }
+    interp_pin(interp, lit[1]);
+    prim[0] = global_ref(interp, sym[3]).cproc;
+    prim[1] = global_ref(interp, sym[4]).cproc;
+    prim[2] = global_ref(interp, sym[5]).cproc;
+    prim[3] = global_ref(interp, sym[6]).cproc;
+}
+
+static void run(Interp *interp)
+{
+    stack_enter(interp);
+    // (define count-down (lambda (n) (if (= n 0) 0 (+ 1 (count-down (- n 1)))) ...
+    defined[0] = true;
+    interp_define(interp, "count-down", mkcproc(proc_0_entry));
+    // (define build (lambda (n) (if (= n 0) (quote ()) (cons n (build (- n 1)) ...
+    defined[1] = true;
+    interp_define(interp, "build", mkcproc(proc_1_entry));
+    // (define repeat (lambda (k acc) (if (= k 0) acc (repeat (- k 1) (+ acc (c ...
+    defined[2] = true;
+    interp_define(interp, "repeat", mkcproc(proc_2_entry));
+    // (display (repeat 20 0))
+    gc_maybe_collect(interp);
+    {
+        if (!defined[2]) {
+            undefined(interp, sym[1]);
+        }
+        double v0 = proc_2_num(interp, 20.0, 0.0);
+        Exp a1_data[] = { mknum(v0) };
+        List a1 = { .data = a1_data, .size = 1, .cap = 1 };
+        Exp v2 = prim[1](interp, a1);
+        show(interp, v2);
+    }
+    // (newline)
+    gc_maybe_collect(interp);
+    {
+        List a0 = VECTOR_INIT();
+        Exp v1 = prim[2](interp, a0);
+        show(interp, v1);
+    }
+    // (display (length (build 2000)))
+    gc_maybe_collect(interp);
+    {
+        if (!defined[1]) {
+            undefined(interp, sym[2]);
+        }
+        Exp v0 = proc_1(interp, mknum(2000.0));
+        Exp a1_data[] = { v0 };
+        List a1 = { .data = a1_data, .size = 1, .cap = 1 };
+        Exp v2 = prim[3](interp, a1);
+        Exp a3_data[] = { v2 };
+        List a3 = { .data = a3_data, .size = 1, .cap = 1 };
+        Exp v4 = prim[1](interp, a3);
+        show(interp, v4);
+    }
+    // (newline)
+    gc_maybe_collect(interp);
+    {
+        List a0 = VECTOR_INIT();
+        Exp v1 = prim[2](interp, a0);
+        show(interp, v1);
+    }
+}
+
+int main(void)
+{
+    Interp *interp = interp_new();
+    // forms left to the interpreter were optimized when compiled
+    interp->optimize = false;
+    init(interp);
+    run(interp);
+    interp_free(interp);
+    return 0;
+}
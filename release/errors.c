@@ -0,0 +1,487 @@
+// Compiled from tests/errors.scm by scheme -c.
+
+#include "scheme.h"
+#include "gcobject.h"
+#include "ht.h"
+
+#define VOID_EXP ((Exp) { .type = EXP_VOID })
+
+static inline noreturn void undefined(Interp *interp, Exp name)
+{
+    die(interp, "undefined symbol: %s\n", AS_SYM(name));
+}
+
+static inline Exp global_ref(Interp *interp, Exp name)
+{
+    Exp value;
+    if (!ht_lookup(&ENV_HT(interp->global), name, &value)) {
+        undefined(interp, name);
+    }
+    return value;
+}
+
+// Raise a stack overflow past the limit run() set, as proc_call does.
+static inline void check_stack(Interp *interp)
+{
+    if ((uintptr_t) __builtin_frame_address(0) < interp->stack_limit) {
+        stack_overflow(interp);
+    }
+}
+
+static inline Exp proc_ref(Interp *interp, Exp proc)
+{
+    if (!is_proc(proc)) {
+        die(interp, "error: not a procedure\n");
+    }
+    return proc;
+}
+
+static inline Exp call(Interp *interp, Exp proc, List args)
+{
+    return proc.type == EXP_C_PROC ? proc.cproc(interp, args)
+                                   : proc_call(interp, &AS_PROC(proc), args);
+}
+
+// Print the value of a top-level form.
+static inline void show(Interp *interp, Exp val)
+{
+    print_to(interp->out, val);
+    if (val.type != EXP_VOID && val.type != EXP_EMPTY) {
+        writer_putc(interp->out, '\n');
+    }
+}
+
+// Run a form the compiler left to the interpreter.
+static inline void eval_form(Interp *interp, Exp form)
+{
+    Exp val = interp_eval(interp, form);
+    show(interp, val);
+    interp_unpin(interp, val);
+}
+
+static Exp sym[24];
+static Exp lit[7];
+static CProc prim[4];
+
+
+static void init(Interp *interp)
+{
+    sym[0] = interp_symbol(interp, "guard");
+    interp_pin(interp, sym[0]);
+    sym[1] = interp_symbol(interp, "e");
+    interp_pin(interp, sym[1]);
+    sym[2] = interp_symbol(interp, "list");
+    interp_pin(interp, sym[2]);
+    sym[3] = interp_symbol(interp, "error-object-message");
+    interp_pin(interp, sym[3]);
+    sym[4] = interp_symbol(interp, "error-object-irritants");
+    interp_pin(interp, sym[4]);
+    sym[5] = interp_symbol(interp, "error");
+    interp_pin(interp, sym[5]);
+    sym[6] = interp_symbol(interp, "quote");
+    interp_pin(interp, sym[6]);
+    sym[7] = interp_symbol(interp, "boom");
+    interp_pin(interp, sym[7]);
+    sym[8] = interp_symbol(interp, "symbol\?");
+    interp_pin(interp, sym[8]);
+    sym[9] = interp_symbol(interp, "caught");
+    interp_pin(interp, sym[9]);
+    sym[10] = interp_symbol(interp, "raise");
+    interp_pin(interp, sym[10]);
+    sym[11] = interp_symbol(interp, "oops");
+    interp_pin(interp, sym[11]);
+    sym[12] = interp_symbol(interp, "with-exception-handler");
+    interp_pin(interp, sym[12]);
+    sym[13] = interp_symbol(interp, "lambda");
+    interp_pin(interp, sym[13]);
+    sym[14] = interp_symbol(interp, "+");
+    interp_pin(interp, sym[14]);
+    sym[15] = interp_symbol(interp, "raise-continuable");
+    interp_pin(interp, sym[15]);
+    sym[16] = interp_symbol(interp, "again");
+    interp_pin(interp, sym[16]);
+    sym[17] = interp_symbol(interp, "not-a-number");
+    interp_pin(interp, sym[17]);
+    sym[18] = interp_symbol(interp, "a");
+    interp_pin(interp, sym[18]);
+    sym[19] = interp_symbol(interp, "before");
+    interp_pin(interp, sym[19]);
+    sym[20] = interp_symbol(interp, "fatal");
+    interp_pin(interp, sym[20]);
+    sym[21] = interp_symbol(interp, "unreached");
+    interp_pin(interp, sym[21]);
+    sym[22] = interp_symbol(interp, "display");
+    interp_pin(interp, sym[22]);
+    sym[23] = interp_symbol(interp, "newline");
+    interp_pin(interp, sym[23]);
+    {
+        List d0 = VECTOR_INIT();
+        Exp e1;
+        e1 = sym[0];
+        list_add(interp, &d0, e1);
+        Exp e2;
+        {
+            List d3 = VECTOR_INIT();
+            Exp e4;
+            e4 = sym[1];
+            list_add(interp, &d3, e4);
+            Exp e5;
+            {
+                List d6 = VECTOR_INIT();
+                Exp e7;
+                e7 = mknum(1.0);
+                list_add(interp, &d6, e7);
+                Exp e8;
+                {
+                    List d9 = VECTOR_INIT();
+                    Exp e10;
+                    e10 = sym[2];
+                    list_add(interp, &d9, e10);
+                    Exp e11;
+                    {
+                        List d12 = VECTOR_INIT();
+                        Exp e13;
+                        e13 = sym[3];
+                        list_add(interp, &d12, e13);
+                        Exp e14;
+                        e14 = sym[1];
+                        list_add(interp, &d12, e14);
+                        e11 = mklist(interp, d12);
+                    }
+                    list_add(interp, &d9, e11);
+                    Exp e15;
+                    {
+                        List d16 = VECTOR_INIT();
+                        Exp e17;
+                        e17 = sym[4];
+                        list_add(interp, &d16, e17);
+                        Exp e18;
+                        e18 = sym[1];
+                        list_add(interp, &d16, e18);
+                        e15 = mklist(interp, d16);
+                    }
+                    list_add(interp, &d9, e15);
+                    e8 = mklist(interp, d9);
+                }
+                list_add(interp, &d6, e8);
+                e5 = mklist(interp, d6);
+            }
+            list_add(interp, &d3, e5);
+            e2 = mklist(interp, d3);
+        }
+        list_add(interp, &d0, e2);
+        Exp e19;
+        {
+            List d20 = VECTOR_INIT();
+            Exp e21;
+            e21 = sym[5];
+            list_add(interp, &d20, e21);
+            Exp e22;
+            {
+                List d23 = VECTOR_INIT();
+                Exp e24;
+                e24 = sym[6];
+                list_add(interp, &d23, e24);
+                Exp e25;
+                e25 = sym[7];
+                list_add(interp, &d23, e25);
+                e22 = mklist(interp, d23);
+            }
+            list_add(interp, &d20, e22);
+            Exp e26;
+            e26 = mknum(1.0);
+            list_add(interp, &d20, e26);
+            Exp e27;
+            e27 = mknum(2.0);
+            list_add(interp, &d20, e27);
+            e19 = mklist(interp, d20);
+        }
+        list_add(interp, &d0, e19);
+        lit[0] = mklist(interp, d0);
+    }
+    interp_pin(interp, lit[0]);
+    {
+        List d28 = VECTOR_INIT();
+        Exp e29;
+        e29 = sym[0];
+        list_add(interp, &d28, e29);
+        Exp e30;
+        {
+            List d31 = VECTOR_INIT();
+            Exp e32;
+            e32 = sym[1];
+            list_add(interp, &d31, e32);
+            Exp e33;
+            {
+                List d34 = VECTOR_INIT();
+                Exp e35;
+                {
+                    List d36 = VECTOR_INIT();
+                    Exp e37;
+                    e37 = sym[8];
+                    list_add(interp, &d36, e37);
+                    Exp e38;
+                    e38 = sym[1];
+                    list_add(interp, &d36, e38);
+                    e35 = mklist(interp, d36);
+                }
+                list_add(interp, &d34, e35);
+                Exp e39;
+                {
+                    List d40 = VECTOR_INIT();
+                    Exp e41;
+                    e41 = sym[2];
+                    list_add(interp, &d40, e41);
+                    Exp e42;
+                    {
+                        List d43 = VECTOR_INIT();
+                        Exp e44;
+                        e44 = sym[6];
+                        list_add(interp, &d43, e44);
+                        Exp e45;
+                        e45 = sym[9];
+                        list_add(interp, &d43, e45);
+                        e42 = mklist(interp, d43);
+                    }
+                    list_add(interp, &d40, e42);
+                    Exp e46;
+                    e46 = sym[1];
+                    list_add(interp, &d40, e46);
+                    e39 = mklist(interp, d40);
+                }
+                list_add(interp, &d34, e39);
+                e33 = mklist(interp, d34);
+            }
+            list_add(interp, &d31, e33);
+            e30 = mklist(interp, d31);
+        }
+        list_add(interp, &d28, e30);
+        Exp e47;
+        {
+            List d48 = VECTOR_INIT();
+            Exp e49;
+            e49 = sym[10];
+            list_add(interp, &d48, e49);
+            Exp e50;
+            {
+                List d51 = VECTOR_INIT();
+                Exp e52;
+                e52 = sym[6];
+                list_add(interp, &d51, e52);
+                Exp e53;
+                e53 = sym[11];
+                list_add(interp, &d51, e53);
+                e50 = mklist(interp, d51);
+            }
+            list_add(interp, &d48, e50);
+            e47 = mklist(interp, d48);
+        }
+        list_add(interp, &d28, e47);
+        lit[1] = mklist(interp, d28);
+    }
+    interp_pin(interp, lit[1]);
+    {
+        List d54 = VECTOR_INIT();
+        Exp e55;
+        e55 = sym[12];
+        list_add(interp, &d54, e55);
+        Exp e56;
+        {
+            List d57 = VECTOR_INIT();
+            Exp e58;
+            e58 = sym[13];
+            list_add(interp, &d57, e58);
+            Exp e59;
+            {
+                List d60 = VECTOR_INIT();
+                Exp e61;
+                e61 = sym[1];
+                list_add(interp, &d60, e61);
+                e59 = mklist(interp, d60);
+            }
+            list_add(interp, &d57, e59);
+            Exp e62;
+            e62 = mknum(10.0);
+            list_add(interp, &d57, e62);
+            e56 = mklist(interp, d57);
+        }
+        list_add(interp, &d54, e56);
+        Exp e63;
+        {
+            List d64 = VECTOR_INIT();
+            Exp e65;
+            e65 = sym[13];
+            list_add(interp, &d64, e65);
+            Exp e66;
+            {
+                List d67 = VECTOR_INIT();
+                e66 = mklist(interp, d67);
+            }
+            list_add(interp, &d64, e66);
+            Exp e68;
+            {
+                List d69 = VECTOR_INIT();
+                Exp e70;
+                e70 = sym[14];
+                list_add(interp, &d69, e70);
+                Exp e71;
+                e71 = mknum(1.0);
+                list_add(interp, &d69, e71);
+                Exp e72;
+                {
+                    List d73 = VECTOR_INIT();
+                    Exp e74;
+                    e74 = sym[15];
+                    list_add(interp, &d73, e74);
+                    Exp e75;
+                    {
+                        List d76 = VECTOR_INIT();
+                        Exp e77;
+                        e77 = sym[6];
+                        list_add(interp, &d76, e77);
+                        Exp e78;
+                        e78 = sym[16];
+                        list_add(interp, &d76, e78);
+                        e75 = mklist(interp, d76);
+                    }
+                    list_add(interp, &d73, e75);
+                    e72 = mklist(interp, d73);
+                }
+                list_add(interp, &d69, e72);
+                e68 = mklist(interp, d69);
+            }
+            list_add(interp, &d64, e68);
+            e63 = mklist(interp, d64);
+        }
+        list_add(interp, &d54, e63);
+        lit[2] = mklist(interp, d54);
+    }
+    interp_pin(interp, lit[2]);
+    {
+        List d79 = VECTOR_INIT();
+        Exp e80;
+        e80 = sym[0];
+        list_add(interp, &d79, e80);
+        Exp e81;
+        {
+            List d82 = VECTOR_INIT();
+            Exp e83;
+            e83 = sym[1];
+            list_add(interp, &d82, e83);
+            Exp e84;
+            {
+                List d85 = VECTOR_INIT();
+                Exp e86;
+                e86 = mknum(1.0);
+                list_add(interp, &d85, e86);
+                Exp e87;
+                {
+                    List d88 = VECTOR_INIT();
+                    Exp e89;
+                    e89 = sym[6];
+                    list_add(interp, &d88, e89);
+                    Exp e90;
+                    e90 = sym[17];
+                    list_add(interp, &d88, e90);
+                    e87 = mklist(interp, d88);
+                }
+                list_add(interp, &d85, e87);
+                e84 = mklist(interp, d85);
+            }
+            list_add(interp, &d82, e84);
+            e81 = mklist(interp, d82);
+        }
+        list_add(interp, &d79, e81);
+        Exp e91;
+        {
+            List d92 = VECTOR_INIT();
+            Exp e93;
+            e93 = sym[14];
+            list_add(interp, &d92, e93);
+            Exp e94;
+            e94 = mknum(1.0);
+            list_add(interp, &d92, e94);
+            Exp e95;
+            {
+                List d96 = VECTOR_INIT();
+                Exp e97;
+                e97 = sym[6];
+                list_add(interp, &d96, e97);
+                Exp e98;
+                e98 = sym[18];
+                list_add(interp, &d96, e98);
+                e95 = mklist(interp, d96);
+            }
+            list_add(interp, &d92, e95);
+            e91 = mklist(interp, d92);
+        }
+        list_add(interp, &d79, e91);
+        lit[3] = mklist(interp, d79);
+    }
+    interp_pin(interp, lit[3]);
+    lit[4] = sym[19];
+    interp_pin(interp, lit[4]);
+    lit[5] = sym[20];
+    interp_pin(interp, lit[5]);
+    lit[6] = sym[21];
+    interp_pin(interp, lit[6]);
+    prim[0] = global_ref(interp, sym[12]).cproc;
+    prim[1] = global_ref(interp, sym[22]).cproc;
+    prim[2] = global_ref(interp, sym[23]).cproc;
+    prim[3] = global_ref(interp, sym[5]).cproc;
+}
+
+static void run(Interp *interp)
+{
+    stack_enter(interp);
+    // (guard (e (1 (list (error-object-message e) (error-object-irritants e))) ...
+    eval_form(interp, lit[0]);
+    // (guard (e ((symbol  e) (list (quote caught) e))) (raise (quote oops)))
+    eval_form(interp, lit[1]);
+    // (with-exception-handler (lambda (e) 10) (lambda () (+ 1 (raise-continuab ...
+    eval_form(interp, lit[2]);
+    // (guard (e (1 (quote not-a-number))) (+ 1 (quote a)))
+    eval_form(interp, lit[3]);
+    // (display (quote before))
+    gc_maybe_collect(interp);
+    {
+        Exp a0_data[] = { lit[4] };
+        List a0 = { .data = a0_data, .size = 1, .cap = 1 };
+        Exp v1 = prim[1](interp, a0);
+        show(interp, v1);
+    }
+    // (newline)
+    gc_maybe_collect(interp);
+    {
+        List a0 = VECTOR_INIT();
+        Exp v1 = prim[2](interp, a0);
+        show(interp, v1);
+    }
+    // (error (quote fatal) 1)
+    gc_maybe_collect(interp);
+    {
+        Exp a0_data[] = { lit[5], mknum(1.0) };
+        List a0 = { .data = a0_data, .size = 2, .cap = 2 };
+        Exp v1 = prim[3](interp, a0);
+        show(interp, v1);
+    }
+    // (display (quote unreached))
+    gc_maybe_collect(interp);
+    {
+        Exp a0_data[] = { lit[6] };
+        List a0 = { .data = a0_data, .size = 1, .cap = 1 };
+        Exp v1 = prim[1](interp, a0);
+        show(interp, v1);
+    }
+}
+
+int main(void)
+{
+    Interp *interp = interp_new();
+    // forms left to the interpreter were optimized when compiled
+    interp->optimize = false;
+    init(interp);
+    run(interp);
+    interp_free(interp);
+    return 0;
+}
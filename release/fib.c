@@ -0,0 +1,172 @@
+// Compiled from bench/fib.scm by scheme -c.
+
+#include "scheme.h"
+#include "gcobject.h"
+#include "ht.h"
+
+#define VOID_EXP ((Exp) { .type = EXP_VOID })
+
+static inline noreturn void undefined(Interp *interp, Exp name)
+{
+    die(interp, "undefined symbol: %s\n", AS_SYM(name));
+}
+
+static inline Exp global_ref(Interp *interp, Exp name)
+{
+    Exp value;
+    if (!ht_lookup(&ENV_HT(interp->global), name, &value)) {
+        undefined(interp, name);
+    }
+    return value;
+}
+
+// Raise a stack overflow past the limit run() set, as proc_call does.
+static inline void check_stack(Interp *interp)
+{
+    if ((uintptr_t) __builtin_frame_address(0) < interp->stack_limit) {
+        stack_overflow(interp);
+    }
+}
+
+static inline Exp proc_ref(Interp *interp, Exp proc)
+{
+    if (!is_proc(proc)) {
+        die(interp, "error: not a procedure\n");
+    }
+    return proc;
+}
+
+static inline Exp call(Interp *interp, Exp proc, List args)
+{
+    return proc.type == EXP_C_PROC ? proc.cproc(interp, args)
+                                   : proc_call(interp, &AS_PROC(proc), args);
+}
+
+// Print the value of a top-level form.
+static inline void show(Interp *interp, Exp val)
+{
+    print_to(interp->out, val);
+    if (val.type != EXP_VOID && val.type != EXP_EMPTY) {
+        writer_putc(interp->out, '\n');
+    }
+}
+
+// Run a form the compiler left to the interpreter.
+static inline void eval_form(Interp *interp, Exp form)
+{
+    Exp val = interp_eval(interp, form);
+    show(interp, val);
+    interp_unpin(interp, val);
+}
+
+static Exp sym[3];
+static CProc prim[2];
+static bool defined[1];
+
+static double proc_0_num(Interp *interp, double p0);
+static Exp proc_0(Interp *interp, Exp p0);
+
+// fib
+static double proc_0_num(Interp *interp, double p0)
+{
+    check_stack(interp);
+    double v2 = (double) (p0 < 2.0);
+    double v8;
+    if (v2 != 0) {
+        v8 = p0;
+    } else {
+        double v3 = (p0 - 1.0);
+        double v4 = proc_0_num(interp, v3);
+        double v5 = (p0 - 2.0);
+        double v6 = proc_0_num(interp, v5);
+        double v7 = (0.0 + v4 + v6);
+        v8 = v7;
+    }
+    return v8;
+}
+
+// fib
+static Exp proc_0(Interp *interp, Exp p0)
+{
+    check_stack(interp);
+    if (is_number(p0)) {
+        return mknum(proc_0_num(interp, p0.number));
+    }
+    Exp a2_data[] = { p0, mknum(2.0) };
+    List a2 = { .data = a2_data, .size = 2, .cap = 2 };
+    double v3 = scheme_lt(interp, a2).number;
+    Exp v11;
+    if (v3 != 0) {
+        v11 = p0;
+    } else {
+        Exp a4_data[] = { p0, mknum(1.0) };
+        List a4 = { .data = a4_data, .size = 2, .cap = 2 };
+        double v5 = scheme_sub(interp, a4).number;
+        double v6 = proc_0_num(interp, v5);
+        Exp a7_data[] = { p0, mknum(2.0) };
+        List a7 = { .data = a7_data, .size = 2, .cap = 2 };
+        double v8 = scheme_sub(interp, a7).number;
+        double v9 = proc_0_num(interp, v8);
+        double v10 = (0.0 + v6 + v9);
+        v11 = mknum(v10);
+    }
+    return v11;
+}
+
+static Exp proc_0_entry(Interp *interp, List args)
+{
+    if (args.size != 1) {
+        die(interp, "%s: arity mismatch\n", "fib");
+    }
+    return proc_0(interp, args.data[0]);
+}
+
+static void init(Interp *interp)
+{
+    sym[0] = interp_symbol(interp, "fib");
+    interp_pin(interp, sym[0]);
+    sym[1] = interp_symbol(interp, "display");
+    interp_pin(interp, sym[1]);
+    sym[2] = interp_symbol(interp, "newline");
+    interp_pin(interp, sym[2]);
+    prim[0] = global_ref(interp, sym[1]).cproc;
+    prim[1] = global_ref(interp, sym[2]).cproc;
+}
+
+static void run(Interp *interp)
+{
+    stack_enter(interp);
+    // (define fib (lambda (n) (if (< n 2) n (+ (fib (- n 1)) (fib (- n 2))))))
+    defined[0] = true;
+    interp_define(interp, "fib", mkcproc(proc_0_entry));
+    // (display (fib 22))
+    gc_maybe_collect(interp);
+    {
+        if (!defined[0]) {
+            undefined(interp, sym[0]);
+        }
+        double v0 = proc_0_num(interp, 22.0);
+        Exp a1_data[] = { mknum(v0) };
+        List a1 = { .data = a1_data, .size = 1, .cap = 1 };
+        Exp v2 = prim[0](interp, a1);
+        show(interp, v2);
+    }
+    // (newline)
+    gc_maybe_collect(interp);
+    {
+        List a0 = VECTOR_INIT();
+        Exp v1 = prim[1](interp, a0);
+        show(interp, v1);
+    }
+}
+
+int main(void)
+{
+    Interp *interp = interp_new();
+    // forms left to the interpreter were optimized when compiled
+    interp->optimize = false;
+    init(interp);
+    run(interp);
+    interp_free(interp);
+    return 0;
+}
@@ -0,0 +1,288 @@
+// Compiled from bench/gcstress.scm by scheme -c.
+
+#include "scheme.h"
+#include "gcobject.h"
+#include "ht.h"
+
+#define VOID_EXP ((Exp) { .type = EXP_VOID })
+
+static inline noreturn void undefined(Interp *interp, Exp name)
+{
+    die(interp, "undefined symbol: %s\n", AS_SYM(name));
+}
+
+static inline Exp global_ref(Interp *interp, Exp name)
+{
+    Exp value;
+    if (!ht_lookup(&ENV_HT(interp->global), name, &value)) {
+        undefined(interp, name);
+    }
+    return value;
+}
+
+// Raise a stack overflow past the limit run() set, as proc_call does.
+static inline void check_stack(Interp *interp)
+{
+    if ((uintptr_t) __builtin_frame_address(0) < interp->stack_limit) {
+        stack_overflow(interp);
+    }
+}
+
+static inline Exp proc_ref(Interp *interp, Exp proc)
+{
+    if (!is_proc(proc)) {
+        die(interp, "error: not a procedure\n");
+    }
+    return proc;
+}
+
+static inline Exp call(Interp *interp, Exp proc, List args)
+{
+    return proc.type == EXP_C_PROC ? proc.cproc(interp, args)
+                                   : proc_call(interp, &AS_PROC(proc), args);
+}
+
+// Print the value of a top-level form.
+static inline void show(Interp *interp, Exp val)
+{
+    print_to(interp->out, val);
+    if (val.type != EXP_VOID && val.type != EXP_EMPTY) {
+        writer_putc(interp->out, '\n');
+    }
+}
+
+// Run a form the compiler left to the interpreter.
+static inline void eval_form(Interp *interp, Exp form)
+{
+    Exp val = interp_eval(interp, form);
+    show(interp, val);
+    interp_unpin(interp, val);
+}
+
+static Exp sym[8];
+static Exp lit[4];
+static CProc prim[5];
+static bool defined[3];
+
+static Exp proc_0(Interp *interp, Exp p0, Exp p1);
+static Exp proc_1(Interp *interp, Exp p0, Exp p1);
+static Exp proc_2(Interp *interp, Exp p0);
+
+// make-list
+static Exp proc_0(Interp *interp, Exp p0, Exp p1)
+{
+    check_stack(interp);
+top:;
+    Exp a3_data[] = { p0, mknum(0.0) };
+    List a3 = { .data = a3_data, .size = 2, .cap = 2 };
+    double v4 = scheme_eq(interp, a3).number;
+    Exp v9;
+    if (v4 != 0) {
+        v9 = p1;
+    } else {
+        Exp a5_data[] = { p0, mknum(1.0) };
+        List a5 = { .data = a5_data, .size = 2, .cap = 2 };
+        double v6 = scheme_sub(interp, a5).number;
+        Exp a7_data[] = { p0, p1 };
+        List a7 = { .data = a7_data, .size = 2, .cap = 2 };
+        Exp v8 = prim[0](interp, a7);
+        p0 = mknum(v6);
+        p1 = v8;
+        goto top;
+    }
+    return v9;
+}
+
+static Exp proc_0_entry(Interp *interp, List args)
+{
+    if (args.size != 2) {
+        die(interp, "%s: arity mismatch\n", "make-list");
+    }
+    return proc_0(interp, args.data[0], args.data[1]);
+}
+
+// churn
+static Exp proc_1(Interp *interp, Exp p0, Exp p1)
+{
+    check_stack(interp);
+top:;
+    Exp a3_data[] = { p0, mknum(0.0) };
+    List a3 = { .data = a3_data, .size = 2, .cap = 2 };
+    double v4 = scheme_eq(interp, a3).number;
+    Exp v12;
+    if (v4 != 0) {
+        v12 = p1;
+    } else {
+        Exp a5_data[] = { p0, mknum(1.0) };
+        List a5 = { .data = a5_data, .size = 2, .cap = 2 };
+        double v6 = scheme_sub(interp, a5).number;
+        if (!defined[0]) {
+            undefined(interp, sym[0]);
+        }
+        Exp v7 = proc_0(interp, mknum(200.0), lit[2]);
+        Exp a8_data[] = { v7 };
+        List a8 = { .data = a8_data, .size = 1, .cap = 1 };
+        Exp v9 = prim[1](interp, a8);
+        Exp a10_data[] = { p1, v9 };
+        List a10 = { .data = a10_data, .size = 2, .cap = 2 };
+        double v11 = scheme_sum(interp, a10).number;
+        p0 = mknum(v6);
+        p1 = mknum(v11);
+        goto top;
+    }
+    return v12;
+}
+
+static Exp proc_1_entry(Interp *interp, List args)
+{
+    if (args.size != 2) {
+        die(interp, "%s: arity mismatch\n", "churn");
+    }
+    return proc_1(interp, args.data[0], args.data[1]);
+}
+
+// tree
+static Exp proc_2(Interp *interp, Exp p0)
+{
+    check_stack(interp);
+    Exp a2_data[] = { p0, mknum(0.0) };
+    List a2 = { .data = a2_data, .size = 2, .cap = 2 };
+    double v3 = scheme_eq(interp, a2).number;
+    Exp v12;
+    if (v3 != 0) {
+        v12 = lit[3];
+    } else {
+        Exp a4_data[] = { p0, mknum(1.0) };
+        List a4 = { .data = a4_data, .size = 2, .cap = 2 };
+        double v5 = scheme_sub(interp, a4).number;
+        Exp v6 = proc_2(interp, mknum(v5));
+        Exp a7_data[] = { p0, mknum(1.0) };
+        List a7 = { .data = a7_data, .size = 2, .cap = 2 };
+        double v8 = scheme_sub(interp, a7).number;
+        Exp v9 = proc_2(interp, mknum(v8));
+        Exp a10_data[] = { v6, v9 };
+        List a10 = { .data = a10_data, .size = 2, .cap = 2 };
+        Exp v11 = prim[2](interp, a10);
+        v12 = v11;
+    }
+    return v12;
+}
+
+static Exp proc_2_entry(Interp *interp, List args)
+{
+    if (args.size != 1) {
+        die(interp, "%s: arity mismatch\n", "tree");
+    }
+    return proc_2(interp, args.data[0]);
+}
+
+static void init(Interp *interp)
+{
+    sym[0] = interp_symbol(interp, "make-list");
+    interp_pin(interp, sym[0]);
+    sym[1] = interp_symbol(interp, "churn");
+    interp_pin(interp, sym[1]);
+    sym[2] = interp_symbol(interp, "tree");
+    interp_pin(interp, sym[2]);
+    sym[3] = interp_symbol(interp, "cons");
+    interp_pin(interp, sym[3]);
+    sym[4] = interp_symbol(interp, "length");
+    interp_pin(interp, sym[4]);
+    sym[5] = interp_symbol(interp, "list");
+    interp_pin(interp, sym[5]);
+    sym[6] = interp_symbol(interp, "display");
+    interp_pin(interp, sym[6]);
+    sym[7] = interp_symbol(interp, "newline");
+    interp_pin(interp, sym[7]);
+    {
+        List d0 = VECTOR_INIT();
+        lit[0] = mklist(interp, d0);
+    }
+    interp_pin(interp, lit[0]);
+    {
+        List d1 = VECTOR_INIT();
+        lit[1] = mklist(interp, d1);
+    }
+    interp_pin(interp, lit[1]);
+    {
+        List d2 = VECTOR_INIT();
+        lit[2] = mklist(interp, d2);
+    }
+    interp_pin(interp, lit[2]);
+    {
+        List d3 = VECTOR_INIT();
+        lit[3] = mklist(interp, d3);
+    }
+    interp_pin(interp, lit[3]);
+    prim[0] = global_ref(interp, sym[3]).cproc;
+    prim[1] = global_ref(interp, sym[4]).cproc;
+    prim[2] = global_ref(interp, sym[5]).cproc;
+    prim[3] = global_ref(interp, sym[6]).cproc;
+    prim[4] = global_ref(interp, sym[7]).cproc;
+}
+
+static void run(Interp *interp)
+{
+    stack_enter(interp);
+    // (define make-list (lambda (n acc) (if (= n 0) acc (make-list (- n 1) (co ...
+    defined[0] = true;
+    interp_define(interp, "make-list", mkcproc(proc_0_entry));
+    // (define churn (lambda (k total) (if (= k 0) total (churn (- k 1) (+ tota ...
+    defined[1] = true;
+    interp_define(interp, "churn", mkcproc(proc_1_entry));
+    // (define tree (lambda (d) (if (= d 0) (quote ()) (list (tree (- d 1)) (tr ...
+    defined[2] = true;
+    interp_define(interp, "tree", mkcproc(proc_2_entry));
+    // (display (churn 300 0))
+    gc_maybe_collect(interp);
+    {
+        if (!defined[1]) {
+            undefined(interp, sym[1]);
+        }
+        Exp v0 = proc_1(interp, mknum(300.0), mknum(0.0));
+        Exp a1_data[] = { v0 };
+        List a1 = { .data = a1_data, .size = 1, .cap = 1 };
+        Exp v2 = prim[3](interp, a1);
+        show(interp, v2);
+    }
+    // (newline)
+    gc_maybe_collect(interp);
+    {
+        List a0 = VECTOR_INIT();
+        Exp v1 = prim[4](interp, a0);
+        show(interp, v1);
+    }
+    // (display (length (tree 14)))
+    gc_maybe_collect(interp);
+    {
+        if (!defined[2]) {
+            undefined(interp, sym[2]);
+        }
+        Exp v0 = proc_2(interp, mknum(14.0));
+        Exp a1_data[] = { v0 };
+        List a1 = { .data = a1_data, .size = 1, .cap = 1 };
+        Exp v2 = prim[1](interp, a1);
+        Exp a3_data[] = { v2 };
+        List a3 = { .data = a3_data, .size = 1, .cap = 1 };
+        Exp v4 = prim[3](interp, a3);
+        show(interp, v4);
+    }
+    // (newline)
+    gc_maybe_collect(interp);
+    {
+        List a0 = VECTOR_INIT();
+        Exp v1 = prim[4](interp, a0);
+        show(interp, v1);
+    }
+}
+
+int main(void)
+{
+    Interp *interp = interp_new();
+    // forms left to the interpreter were optimized when compiled
+    interp->optimize = false;
+    init(interp);
+    run(interp);
+    interp_free(interp);
+    return 0;
+}
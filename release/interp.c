@@ -0,0 +1,637 @@
+// Compiled from bench/interp.scm by scheme -c.
+
+#include "scheme.h"
+#include "gcobject.h"
+#include "ht.h"
+
+#define VOID_EXP ((Exp) { .type = EXP_VOID })
+
+static inline noreturn void undefined(Interp *interp, Exp name)
+{
+    die(interp, "undefined symbol: %s\n", AS_SYM(name));
+}
+
+static inline Exp global_ref(Interp *interp, Exp name)
+{
+    Exp value;
+    if (!ht_lookup(&ENV_HT(interp->global), name, &value)) {
+        undefined(interp, name);
+    }
+    return value;
+}
+
+// Raise a stack overflow past the limit run() set, as proc_call does.
+static inline void check_stack(Interp *interp)
+{
+    if ((uintptr_t) __builtin_frame_address(0) < interp->stack_limit) {
+        stack_overflow(interp);
+    }
+}
+
+static inline Exp proc_ref(Interp *interp, Exp proc)
+{
+    if (!is_proc(proc)) {
+        die(interp, "error: not a procedure\n");
+    }
+    return proc;
+}
+
+static inline Exp call(Interp *interp, Exp proc, List args)
+{
+    return proc.type == EXP_C_PROC ? proc.cproc(interp, args)
+                                   : proc_call(interp, &AS_PROC(proc), args);
+}
+
+// Print the value of a top-level form.
+static inline void show(Interp *interp, Exp val)
+{
+    print_to(interp->out, val);
+    if (val.type != EXP_VOID && val.type != EXP_EMPTY) {
+        writer_putc(interp->out, '\n');
+    }
+}
+
+// Run a form the compiler left to the interpreter.
+static inline void eval_form(Interp *interp, Exp form)
+{
+    Exp val = interp_eval(interp, form);
+    show(interp, val);
+    interp_unpin(interp, val);
+}
+
+static Exp sym[27];
+static Exp lit[15];
+static CProc prim[9];
+static bool defined[3];
+
+static Exp proc_0(Interp *interp, Exp p0, Exp p1);
+static Exp proc_1(Interp *interp, Exp p0, Exp p1);
+static Exp proc_2(Interp *interp, Exp p0, Exp p1);
+
+// lookup
+static Exp proc_0(Interp *interp, Exp p0, Exp p1)
+{
+    check_stack(interp);
+top:;
+    Exp a3_data[] = { p1 };
+    List a3 = { .data = a3_data, .size = 1, .cap = 1 };
+    Exp v4 = prim[0](interp, a3);
+    Exp a5_data[] = { v4 };
+    List a5 = { .data = a5_data, .size = 1, .cap = 1 };
+    Exp v6 = prim[0](interp, a5);
+    Exp a7_data[] = { p0, v6 };
+    List a7 = { .data = a7_data, .size = 2, .cap = 2 };
+    Exp v8 = prim[1](interp, a7);
+    Exp v18;
+    if (is_true(v8)) {
+        Exp a9_data[] = { p1 };
+        List a9 = { .data = a9_data, .size = 1, .cap = 1 };
+        Exp v10 = prim[0](interp, a9);
+        Exp a11_data[] = { v10 };
+        List a11 = { .data = a11_data, .size = 1, .cap = 1 };
+        Exp v12 = prim[2](interp, a11);
+        Exp a13_data[] = { v12 };
+        List a13 = { .data = a13_data, .size = 1, .cap = 1 };
+        Exp v14 = prim[0](interp, a13);
+        v18 = v14;
+    } else {
+        Exp a15_data[] = { p1 };
+        List a15 = { .data = a15_data, .size = 1, .cap = 1 };
+        Exp v16 = prim[2](interp, a15);
+        Exp v17 = p0;
+        p0 = v17;
+        p1 = v16;
+        goto top;
+    }
+    return v18;
+}
+
+static Exp proc_0_entry(Interp *interp, List args)
+{
+    if (args.size != 2) {
+        die(interp, "%s: arity mismatch\n", "lookup");
+    }
+    return proc_0(interp, args.data[0], args.data[1]);
+}
+
+// ev
+static Exp proc_1(Interp *interp, Exp p0, Exp p1)
+{
+    check_stack(interp);
+top:;
+    Exp a3_data[] = { p0 };
+    List a3 = { .data = a3_data, .size = 1, .cap = 1 };
+    Exp v4 = prim[3](interp, a3);
+    Exp v94;
+    if (is_true(v4)) {
+        v94 = p0;
+    } else {
+        Exp a5_data[] = { p0 };
+        List a5 = { .data = a5_data, .size = 1, .cap = 1 };
+        Exp v6 = prim[4](interp, a5);
+        Exp v93;
+        if (is_true(v6)) {
+            if (!defined[0]) {
+                undefined(interp, sym[0]);
+            }
+            Exp v7 = proc_0(interp, p0, p1);
+            v93 = v7;
+        } else {
+            Exp a8_data[] = { p0 };
+            List a8 = { .data = a8_data, .size = 1, .cap = 1 };
+            Exp v9 = prim[0](interp, a8);
+            Exp a10_data[] = { v9, lit[4] };
+            List a10 = { .data = a10_data, .size = 2, .cap = 2 };
+            Exp v11 = prim[1](interp, a10);
+            double v92;
+            if (is_true(v11)) {
+                Exp a12_data[] = { p0 };
+                List a12 = { .data = a12_data, .size = 1, .cap = 1 };
+                Exp v13 = prim[2](interp, a12);
+                Exp a14_data[] = { v13 };
+                List a14 = { .data = a14_data, .size = 1, .cap = 1 };
+                Exp v15 = prim[0](interp, a14);
+                Exp v16 = proc_1(interp, v15, p1);
+                Exp a17_data[] = { p0 };
+                List a17 = { .data = a17_data, .size = 1, .cap = 1 };
+                Exp v18 = prim[2](interp, a17);
+                Exp a19_data[] = { v18 };
+                List a19 = { .data = a19_data, .size = 1, .cap = 1 };
+                Exp v20 = prim[2](interp, a19);
+                Exp a21_data[] = { v20 };
+                List a21 = { .data = a21_data, .size = 1, .cap = 1 };
+                Exp v22 = prim[0](interp, a21);
+                Exp v23 = proc_1(interp, v22, p1);
+                Exp a24_data[] = { v16, v23 };
+                List a24 = { .data = a24_data, .size = 2, .cap = 2 };
+                double v25 = scheme_sum(interp, a24).number;
+                v92 = v25;
+            } else {
+                Exp a26_data[] = { p0 };
+                List a26 = { .data = a26_data, .size = 1, .cap = 1 };
+                Exp v27 = prim[0](interp, a26);
+                Exp a28_data[] = { v27, lit[5] };
+                List a28 = { .data = a28_data, .size = 2, .cap = 2 };
+                Exp v29 = prim[1](interp, a28);
+                double v91;
+                if (is_true(v29)) {
+                    Exp a30_data[] = { p0 };
+                    List a30 = { .data = a30_data, .size = 1, .cap = 1 };
+                    Exp v31 = prim[2](interp, a30);
+                    Exp a32_data[] = { v31 };
+                    List a32 = { .data = a32_data, .size = 1, .cap = 1 };
+                    Exp v33 = prim[0](interp, a32);
+                    Exp v34 = proc_1(interp, v33, p1);
+                    Exp a35_data[] = { p0 };
+                    List a35 = { .data = a35_data, .size = 1, .cap = 1 };
+                    Exp v36 = prim[2](interp, a35);
+                    Exp a37_data[] = { v36 };
+                    List a37 = { .data = a37_data, .size = 1, .cap = 1 };
+                    Exp v38 = prim[2](interp, a37);
+                    Exp a39_data[] = { v38 };
+                    List a39 = { .data = a39_data, .size = 1, .cap = 1 };
+                    Exp v40 = prim[0](interp, a39);
+                    Exp v41 = proc_1(interp, v40, p1);
+                    Exp a42_data[] = { v34, v41 };
+                    List a42 = { .data = a42_data, .size = 2, .cap = 2 };
+                    double v43 = scheme_mul(interp, a42).number;
+                    v91 = v43;
+                } else {
+                    Exp a44_data[] = { p0 };
+                    List a44 = { .data = a44_data, .size = 1, .cap = 1 };
+                    Exp v45 = prim[0](interp, a44);
+                    Exp a46_data[] = { v45, lit[6] };
+                    List a46 = { .data = a46_data, .size = 2, .cap = 2 };
+                    Exp v47 = prim[1](interp, a46);
+                    double v90;
+                    if (is_true(v47)) {
+                        Exp a48_data[] = { p0 };
+                        List a48 = { .data = a48_data, .size = 1, .cap = 1 };
+                        Exp v49 = prim[2](interp, a48);
+                        Exp a50_data[] = { v49 };
+                        List a50 = { .data = a50_data, .size = 1, .cap = 1 };
+                        Exp v51 = prim[0](interp, a50);
+                        Exp v52 = proc_1(interp, v51, p1);
+                        Exp a53_data[] = { p0 };
+                        List a53 = { .data = a53_data, .size = 1, .cap = 1 };
+                        Exp v54 = prim[2](interp, a53);
+                        Exp a55_data[] = { v54 };
+                        List a55 = { .data = a55_data, .size = 1, .cap = 1 };
+                        Exp v56 = prim[2](interp, a55);
+                        Exp a57_data[] = { v56 };
+                        List a57 = { .data = a57_data, .size = 1, .cap = 1 };
+                        Exp v58 = prim[0](interp, a57);
+                        Exp v59 = proc_1(interp, v58, p1);
+                        Exp a60_data[] = { v52, v59 };
+                        List a60 = { .data = a60_data, .size = 2, .cap = 2 };
+                        double v61 = scheme_sub(interp, a60).number;
+                        v90 = v61;
+                    } else {
+                        Exp a62_data[] = { p0 };
+                        List a62 = { .data = a62_data, .size = 1, .cap = 1 };
+                        Exp v63 = prim[0](interp, a62);
+                        Exp a64_data[] = { v63, lit[7] };
+                        List a64 = { .data = a64_data, .size = 2, .cap = 2 };
+                        Exp v65 = prim[1](interp, a64);
+                        double v89;
+                        if (is_true(v65)) {
+                            Exp a66_data[] = { p0 };
+                            List a66 = { .data = a66_data, .size = 1, .cap = 1 };
+                            Exp v67 = prim[2](interp, a66);
+                            Exp a68_data[] = { v67 };
+                            List a68 = { .data = a68_data, .size = 1, .cap = 1 };
+                            Exp v69 = prim[2](interp, a68);
+                            Exp a70_data[] = { v69 };
+                            List a70 = { .data = a70_data, .size = 1, .cap = 1 };
+                            Exp v71 = prim[2](interp, a70);
+                            Exp a72_data[] = { v71 };
+                            List a72 = { .data = a72_data, .size = 1, .cap = 1 };
+                            Exp v73 = prim[0](interp, a72);
+                            Exp a74_data[] = { p0 };
+                            List a74 = { .data = a74_data, .size = 1, .cap = 1 };
+                            Exp v75 = prim[2](interp, a74);
+                            Exp a76_data[] = { v75 };
+                            List a76 = { .data = a76_data, .size = 1, .cap = 1 };
+                            Exp v77 = prim[0](interp, a76);
+                            Exp a78_data[] = { p0 };
+                            List a78 = { .data = a78_data, .size = 1, .cap = 1 };
+                            Exp v79 = prim[2](interp, a78);
+                            Exp a80_data[] = { v79 };
+                            List a80 = { .data = a80_data, .size = 1, .cap = 1 };
+                            Exp v81 = prim[2](interp, a80);
+                            Exp a82_data[] = { v81 };
+                            List a82 = { .data = a82_data, .size = 1, .cap = 1 };
+                            Exp v83 = prim[0](interp, a82);
+                            Exp v84 = proc_1(interp, v83, p1);
+                            Exp a85_data[] = { v77, v84 };
+                            List a85 = { .data = a85_data, .size = 2, .cap = 2 };
+                            Exp v86 = prim[5](interp, a85);
+                            Exp a87_data[] = { v86, p1 };
+                            List a87 = { .data = a87_data, .size = 2, .cap = 2 };
+                            Exp v88 = prim[6](interp, a87);
+                            p0 = v73;
+                            p1 = v88;
+                            goto top;
+                        } else {
+                            v89 = 0.0;
+                        }
+                        v90 = v89;
+                    }
+                    v91 = v90;
+                }
+                v92 = v91;
+            }
+            v93 = mknum(v92);
+        }
+        v94 = v93;
+    }
+    return v94;
+}
+
+static Exp proc_1_entry(Interp *interp, List args)
+{
+    if (args.size != 2) {
+        die(interp, "%s: arity mismatch\n", "ev");
+    }
+    return proc_1(interp, args.data[0], args.data[1]);
+}
+
+// loop
+static Exp proc_2(Interp *interp, Exp p0, Exp p1)
+{
+    check_stack(interp);
+top:;
+    Exp a3_data[] = { p0, mknum(0.0) };
+    List a3 = { .data = a3_data, .size = 2, .cap = 2 };
+    double v4 = scheme_eq(interp, a3).number;
+    Exp v12;
+    if (v4 != 0) {
+        v12 = p1;
+    } else {
+        Exp a5_data[] = { p0, mknum(1.0) };
+        List a5 = { .data = a5_data, .size = 2, .cap = 2 };
+        double v6 = scheme_sub(interp, a5).number;
+        Exp v7 = global_ref(interp, sym[1]);
+        Exp v8 = global_ref(interp, sym[2]);
+        if (!defined[1]) {
+            undefined(interp, sym[3]);
+        }
+        Exp v9 = proc_1(interp, v7, v8);
+        Exp a10_data[] = { p1, v9 };
+        List a10 = { .data = a10_data, .size = 2, .cap = 2 };
+        double v11 = scheme_sum(interp, a10).number;
+        p0 = mknum(v6);
+        p1 = mknum(v11);
+        goto top;
+    }
+    return v12;
+}
+
+static Exp proc_2_entry(Interp *interp, List args)
+{
+    if (args.size != 2) {
+        die(interp, "%s: arity mismatch\n", "loop");
+    }
+    return proc_2(interp, args.data[0], args.data[1]);
+}
+
+static void init(Interp *interp)
+{
+    sym[0] = interp_symbol(interp, "lookup");
+    interp_pin(interp, sym[0]);
+    sym[1] = interp_symbol(interp, "prog");
+    interp_pin(interp, sym[1]);
+    sym[2] = interp_symbol(interp, "env0");
+    interp_pin(interp, sym[2]);
+    sym[3] = interp_symbol(interp, "ev");
+    interp_pin(interp, sym[3]);
+    sym[4] = interp_symbol(interp, "loop");
+    interp_pin(interp, sym[4]);
+    sym[5] = interp_symbol(interp, "add");
+    interp_pin(interp, sym[5]);
+    sym[6] = interp_symbol(interp, "mul");
+    interp_pin(interp, sym[6]);
+    sym[7] = interp_symbol(interp, "sub");
+    interp_pin(interp, sym[7]);
+    sym[8] = interp_symbol(interp, "let1");
+    interp_pin(interp, sym[8]);
+    sym[9] = interp_symbol(interp, "alpha");
+    interp_pin(interp, sym[9]);
+    sym[10] = interp_symbol(interp, "beta");
+    interp_pin(interp, sym[10]);
+    sym[11] = interp_symbol(interp, "gamma");
+    interp_pin(interp, sym[11]);
+    sym[12] = interp_symbol(interp, "delta");
+    interp_pin(interp, sym[12]);
+    sym[13] = interp_symbol(interp, "epsilon");
+    interp_pin(interp, sym[13]);
+    sym[14] = interp_symbol(interp, "zeta");
+    interp_pin(interp, sym[14]);
+    sym[15] = interp_symbol(interp, "x");
+    interp_pin(interp, sym[15]);
+    sym[16] = interp_symbol(interp, "y");
+    interp_pin(interp, sym[16]);
+    sym[17] = interp_symbol(interp, "z");
+    interp_pin(interp, sym[17]);
+    sym[18] = interp_symbol(interp, "car");
+    interp_pin(interp, sym[18]);
+    sym[19] = interp_symbol(interp, "equal\?");
+    interp_pin(interp, sym[19]);
+    sym[20] = interp_symbol(interp, "cdr");
+    interp_pin(interp, sym[20]);
+    sym[21] = interp_symbol(interp, "number\?");
+    interp_pin(interp, sym[21]);
+    sym[22] = interp_symbol(interp, "symbol\?");
+    interp_pin(interp, sym[22]);
+    sym[23] = interp_symbol(interp, "list");
+    interp_pin(interp, sym[23]);
+    sym[24] = interp_symbol(interp, "cons");
+    interp_pin(interp, sym[24]);
+    sym[25] = interp_symbol(interp, "display");
+    interp_pin(interp, sym[25]);
+    sym[26] = interp_symbol(interp, "newline");
+    interp_pin(interp, sym[26]);
+    lit[0] = sym[5];
+    interp_pin(interp, lit[0]);
+    lit[1] = sym[6];
+    interp_pin(interp, lit[1]);
+    lit[2] = sym[7];
+    interp_pin(interp, lit[2]);
+    lit[3] = sym[8];
+    interp_pin(interp, lit[3]);
+    lit[4] = sym[5];
+    interp_pin(interp, lit[4]);
+    lit[5] = sym[6];
+    interp_pin(interp, lit[5]);
+    lit[6] = sym[7];
+    interp_pin(interp, lit[6]);
+    lit[7] = sym[8];
+    interp_pin(interp, lit[7]);
+    lit[8] = sym[9];
+    interp_pin(interp, lit[8]);
+    lit[9] = sym[10];
+    interp_pin(interp, lit[9]);
+    lit[10] = sym[11];
+    interp_pin(interp, lit[10]);
+    lit[11] = sym[12];
+    interp_pin(interp, lit[11]);
+    lit[12] = sym[13];
+    interp_pin(interp, lit[12]);
+    lit[13] = sym[14];
+    interp_pin(interp, lit[13]);
+    {
+        List d0 = VECTOR_INIT();
+        Exp e1;
+        e1 = sym[8];
+        list_add(interp, &d0, e1);
+        Exp e2;
+        e2 = sym[15];
+        list_add(interp, &d0, e2);
+        Exp e3;
+        {
+            List d4 = VECTOR_INIT();
+            Exp e5;
+            e5 = sym[5];
+            list_add(interp, &d4, e5);
+            Exp e6;
+            e6 = sym[9];
+            list_add(interp, &d4, e6);
+            Exp e7;
+            e7 = sym[10];
+            list_add(interp, &d4, e7);
+            e3 = mklist(interp, d4);
+        }
+        list_add(interp, &d0, e3);
+        Exp e8;
+        {
+            List d9 = VECTOR_INIT();
+            Exp e10;
+            e10 = sym[8];
+            list_add(interp, &d9, e10);
+            Exp e11;
+            e11 = sym[16];
+            list_add(interp, &d9, e11);
+            Exp e12;
+            {
+                List d13 = VECTOR_INIT();
+                Exp e14;
+                e14 = sym[6];
+                list_add(interp, &d13, e14);
+                Exp e15;
+                e15 = sym[15];
+                list_add(interp, &d13, e15);
+                Exp e16;
+                e16 = sym[11];
+                list_add(interp, &d13, e16);
+                e12 = mklist(interp, d13);
+            }
+            list_add(interp, &d9, e12);
+            Exp e17;
+            {
+                List d18 = VECTOR_INIT();
+                Exp e19;
+                e19 = sym[8];
+                list_add(interp, &d18, e19);
+                Exp e20;
+                e20 = sym[17];
+                list_add(interp, &d18, e20);
+                Exp e21;
+                {
+                    List d22 = VECTOR_INIT();
+                    Exp e23;
+                    e23 = sym[7];
+                    list_add(interp, &d22, e23);
+                    Exp e24;
+                    e24 = sym[16];
+                    list_add(interp, &d22, e24);
+                    Exp e25;
+                    e25 = sym[12];
+                    list_add(interp, &d22, e25);
+                    e21 = mklist(interp, d22);
+                }
+                list_add(interp, &d18, e21);
+                Exp e26;
+                {
+                    List d27 = VECTOR_INIT();
+                    Exp e28;
+                    e28 = sym[5];
+                    list_add(interp, &d27, e28);
+                    Exp e29;
+                    {
+                        List d30 = VECTOR_INIT();
+                        Exp e31;
+                        e31 = sym[6];
+                        list_add(interp, &d30, e31);
+                        Exp e32;
+                        e32 = sym[17];
+                        list_add(interp, &d30, e32);
+                        Exp e33;
+                        e33 = sym[13];
+                        list_add(interp, &d30, e33);
+                        e29 = mklist(interp, d30);
+                    }
+                    list_add(interp, &d27, e29);
+                    Exp e34;
+                    {
+                        List d35 = VECTOR_INIT();
+                        Exp e36;
+                        e36 = sym[5];
+                        list_add(interp, &d35, e36);
+                        Exp e37;
+                        e37 = sym[15];
+                        list_add(interp, &d35, e37);
+                        Exp e38;
+                        {
+                            List d39 = VECTOR_INIT();
+                            Exp e40;
+                            e40 = sym[6];
+                            list_add(interp, &d39, e40);
+                            Exp e41;
+                            e41 = sym[16];
+                            list_add(interp, &d39, e41);
+                            Exp e42;
+                            e42 = sym[14];
+                            list_add(interp, &d39, e42);
+                            e38 = mklist(interp, d39);
+                        }
+                        list_add(interp, &d35, e38);
+                        e34 = mklist(interp, d35);
+                    }
+                    list_add(interp, &d27, e34);
+                    e26 = mklist(interp, d27);
+                }
+                list_add(interp, &d18, e26);
+                e17 = mklist(interp, d18);
+            }
+            list_add(interp, &d9, e17);
+            e8 = mklist(interp, d9);
+        }
+        list_add(interp, &d0, e8);
+        lit[14] = mklist(interp, d0);
+    }
+    interp_pin(interp, lit[14]);
+    prim[0] = global_ref(interp, sym[18]).cproc;
+    prim[1] = global_ref(interp, sym[19]).cproc;
+    prim[2] = global_ref(interp, sym[20]).cproc;
+    prim[3] = global_ref(interp, sym[21]).cproc;
+    prim[4] = global_ref(interp, sym[22]).cproc;
+    prim[5] = global_ref(interp, sym[23]).cproc;
+    prim[6] = global_ref(interp, sym[24]).cproc;
+    prim[7] = global_ref(interp, sym[25]).cproc;
+    prim[8] = global_ref(interp, sym[26]).cproc;
+}
+
+static void run(Interp *interp)
+{
+    stack_enter(interp);
+    // (define lookup (lambda (var env) (if (equal  var (car (car env))) (car ( ...
+    defined[0] = true;
+    interp_define(interp, "lookup", mkcproc(proc_0_entry));
+    // (define ev (lambda (e env) (if (number  e) e (if (symbol  e) (lookup e e ...
+    defined[1] = true;
+    interp_define(interp, "ev", mkcproc(proc_1_entry));
+    // (define env0 (list (list (quote alpha) 1) (list (quote beta) 2) (list (q ...
+    gc_maybe_collect(interp);
+    {
+        Exp a0_data[] = { lit[8], mknum(1.0) };
+        List a0 = { .data = a0_data, .size = 2, .cap = 2 };
+        Exp v1 = prim[5](interp, a0);
+        Exp a2_data[] = { lit[9], mknum(2.0) };
+        List a2 = { .data = a2_data, .size = 2, .cap = 2 };
+        Exp v3 = prim[5](interp, a2);
+        Exp a4_data[] = { lit[10], mknum(3.0) };
+        List a4 = { .data = a4_data, .size = 2, .cap = 2 };
+        Exp v5 = prim[5](interp, a4);
+        Exp a6_data[] = { lit[11], mknum(4.0) };
+        List a6 = { .data = a6_data, .size = 2, .cap = 2 };
+        Exp v7 = prim[5](interp, a6);
+        Exp a8_data[] = { lit[12], mknum(5.0) };
+        List a8 = { .data = a8_data, .size = 2, .cap = 2 };
+        Exp v9 = prim[5](interp, a8);
+        Exp a10_data[] = { lit[13], mknum(6.0) };
+        List a10 = { .data = a10_data, .size = 2, .cap = 2 };
+        Exp v11 = prim[5](interp, a10);
+        Exp a12_data[] = { v1, v3, v5, v7, v9, v11 };
+        List a12 = { .data = a12_data, .size = 6, .cap = 6 };
+        Exp v13 = prim[5](interp, a12);
+        interp_define(interp, "env0", v13);
+    }
+    // (define prog (quote (let1 x (add alpha beta) (let1 y (mul x gamma) (let1 ...
+    gc_maybe_collect(interp);
+    {
+        interp_define(interp, "prog", lit[14]);
+    }
+    // (define loop (lambda (n acc) (if (= n 0) acc (loop (- n 1) (+ acc (ev pr ...
+    defined[2] = true;
+    interp_define(interp, "loop", mkcproc(proc_2_entry));
+    // (display (loop 1000 0))
+    gc_maybe_collect(interp);
+    {
+        if (!defined[2]) {
+            undefined(interp, sym[4]);
+        }
+        Exp v0 = proc_2(interp, mknum(1000.0), mknum(0.0));
+        Exp a1_data[] = { v0 };
+        List a1 = { .data = a1_data, .size = 1, .cap = 1 };
+        Exp v2 = prim[7](interp, a1);
+        show(interp, v2);
+    }
+    // (newline)
+    gc_maybe_collect(interp);
+    {
+        List a0 = VECTOR_INIT();
+        Exp v1 = prim[8](interp, a0);
+        show(interp, v1);
+    }
+}
+
+int main(void)
+{
+    Interp *interp = interp_new();
+    // forms left to the interpreter were optimized when compiled
+    interp->optimize = false;
+    init(interp);
+    run(interp);
+    interp_free(interp);
+    return 0;
+}
@@ -0,0 +1,621 @@
+// Compiled from tests/jit.scm by scheme -c.
+
+#include "scheme.h"
+#include "gcobject.h"
+#include "ht.h"
+
+#define VOID_EXP ((Exp) { .type = EXP_VOID })
+
+static inline noreturn void undefined(Interp *interp, Exp name)
+{
+    die(interp, "undefined symbol: %s\n", AS_SYM(name));
+}
+
+static inline Exp global_ref(Interp *interp, Exp name)
+{
+    Exp value;
+    if (!ht_lookup(&ENV_HT(interp->global), name, &value)) {
+        undefined(interp, name);
+    }
+    return value;
+}
+
+// Raise a stack overflow past the limit run() set, as proc_call does.
+static inline void check_stack(Interp *interp)
+{
+    if ((uintptr_t) __builtin_frame_address(0) < interp->stack_limit) {
+        stack_overflow(interp);
+    }
+}
+
+static inline Exp proc_ref(Interp *interp, Exp proc)
+{
+    if (!is_proc(proc)) {
+        die(interp, "error: not a procedure\n");
+    }
+    return proc;
+}
+
+static inline Exp call(Interp *interp, Exp proc, List args)
+{
+    return proc.type == EXP_C_PROC ? proc.cproc(interp, args)
+                                   : proc_call(interp, &AS_PROC(proc), args);
+}
+
+// Print the value of a top-level form.
+static inline void show(Interp *interp, Exp val)
+{
+    print_to(interp->out, val);
+    if (val.type != EXP_VOID && val.type != EXP_EMPTY) {
+        writer_putc(interp->out, '\n');
+    }
+}
+
+// Run a form the compiler left to the interpreter.
+static inline void eval_form(Interp *interp, Exp form)
+{
+    Exp val = interp_eval(interp, form);
+    show(interp, val);
+    interp_unpin(interp, val);
+}
+
+static Exp sym[13];
+static Exp lit[5];
+static bool defined[4];
+
+static double proc_0_num(Interp *interp, double p0);
+static Exp proc_0(Interp *interp, Exp p0);
+static double proc_1_num(Interp *interp, double p0, double p1);
+static Exp proc_1(Interp *interp, Exp p0, Exp p1);
+static Exp proc_2(Interp *interp, Exp p0, Exp p1);
+static double proc_3_num(Interp *interp, double p0);
+static Exp proc_3(Interp *interp, Exp p0);
+
+// fib
+static double proc_0_num(Interp *interp, double p0)
+{
+    check_stack(interp);
+    double v2 = (double) (p0 < 2.0);
+    double v8;
+    if (v2 != 0) {
+        v8 = p0;
+    } else {
+        double v3 = (p0 - 1.0);
+        double v4 = proc_0_num(interp, v3);
+        double v5 = (p0 - 2.0);
+        double v6 = proc_0_num(interp, v5);
+        double v7 = (0.0 + v4 + v6);
+        v8 = v7;
+    }
+    return v8;
+}
+
+// fib
+static Exp proc_0(Interp *interp, Exp p0)
+{
+    check_stack(interp);
+    if (is_number(p0)) {
+        return mknum(proc_0_num(interp, p0.number));
+    }
+    Exp a2_data[] = { p0, mknum(2.0) };
+    List a2 = { .data = a2_data, .size = 2, .cap = 2 };
+    double v3 = scheme_lt(interp, a2).number;
+    Exp v11;
+    if (v3 != 0) {
+        v11 = p0;
+    } else {
+        Exp a4_data[] = { p0, mknum(1.0) };
+        List a4 = { .data = a4_data, .size = 2, .cap = 2 };
+        double v5 = scheme_sub(interp, a4).number;
+        double v6 = proc_0_num(interp, v5);
+        Exp a7_data[] = { p0, mknum(2.0) };
+        List a7 = { .data = a7_data, .size = 2, .cap = 2 };
+        double v8 = scheme_sub(interp, a7).number;
+        double v9 = proc_0_num(interp, v8);
+        double v10 = (0.0 + v6 + v9);
+        v11 = mknum(v10);
+    }
+    return v11;
+}
+
+static Exp proc_0_entry(Interp *interp, List args)
+{
+    if (args.size != 1) {
+        die(interp, "%s: arity mismatch\n", "fib");
+    }
+    return proc_0(interp, args.data[0]);
+}
+
+// sumsq
+static double proc_1_num(Interp *interp, double p0, double p1)
+{
+    check_stack(interp);
+top:;
+    double v3 = (double) (p0 == 0.0);
+    double v7;
+    if (v3 != 0) {
+        v7 = p1;
+    } else {
+        double v4 = (p0 - 1.0);
+        double v5 = (1.0 * p0 * p0);
+        double v6 = (0.0 + p1 + v5);
+        p0 = v4;
+        p1 = v6;
+        goto top;
+    }
+    return v7;
+}
+
+// sumsq
+static Exp proc_1(Interp *interp, Exp p0, Exp p1)
+{
+    check_stack(interp);
+top:;
+    if (is_number(p0) && is_number(p1)) {
+        return mknum(proc_1_num(interp, p0.number, p1.number));
+    }
+    Exp a3_data[] = { p0, mknum(0.0) };
+    List a3 = { .data = a3_data, .size = 2, .cap = 2 };
+    double v4 = scheme_eq(interp, a3).number;
+    Exp v11;
+    if (v4 != 0) {
+        v11 = p1;
+    } else {
+        Exp a5_data[] = { p0, mknum(1.0) };
+        List a5 = { .data = a5_data, .size = 2, .cap = 2 };
+        double v6 = scheme_sub(interp, a5).number;
+        Exp a7_data[] = { p0, p0 };
+        List a7 = { .data = a7_data, .size = 2, .cap = 2 };
+        double v8 = scheme_mul(interp, a7).number;
+        Exp a9_data[] = { p1, mknum(v8) };
+        List a9 = { .data = a9_data, .size = 2, .cap = 2 };
+        double v10 = scheme_sum(interp, a9).number;
+        p0 = mknum(v6);
+        p1 = mknum(v10);
+        goto top;
+    }
+    return v11;
+}
+
+static Exp proc_1_entry(Interp *interp, List args)
+{
+    if (args.size != 2) {
+        die(interp, "%s: arity mismatch\n", "sumsq");
+    }
+    return proc_1(interp, args.data[0], args.data[1]);
+}
+
+// addk
+static Exp proc_2(Interp *interp, Exp p0, Exp p1)
+{
+    check_stack(interp);
+top:;
+    Exp a3_data[] = { p0, mknum(0.0) };
+    List a3 = { .data = a3_data, .size = 2, .cap = 2 };
+    double v4 = scheme_eq(interp, a3).number;
+    Exp v10;
+    if (v4 != 0) {
+        v10 = p1;
+    } else {
+        Exp a5_data[] = { p0, mknum(1.0) };
+        List a5 = { .data = a5_data, .size = 2, .cap = 2 };
+        double v6 = scheme_sub(interp, a5).number;
+        Exp v7 = global_ref(interp, sym[0]);
+        Exp a8_data[] = { p1, v7 };
+        List a8 = { .data = a8_data, .size = 2, .cap = 2 };
+        double v9 = scheme_sum(interp, a8).number;
+        p0 = mknum(v6);
+        p1 = mknum(v9);
+        goto top;
+    }
+    return v10;
+}
+
+static Exp proc_2_entry(Interp *interp, List args)
+{
+    if (args.size != 2) {
+        die(interp, "%s: arity mismatch\n", "addk");
+    }
+    return proc_2(interp, args.data[0], args.data[1]);
+}
+
+// depth
+static double proc_3_num(Interp *interp, double p0)
+{
+    check_stack(interp);
+    double v2 = (double) (p0 == 0.0);
+    double v6;
+    if (v2 != 0) {
+        v6 = 0.0;
+    } else {
+        double v3 = (p0 - 1.0);
+        double v4 = proc_3_num(interp, v3);
+        double v5 = (0.0 + 1.0 + v4);
+        v6 = v5;
+    }
+    return v6;
+}
+
+// depth
+static Exp proc_3(Interp *interp, Exp p0)
+{
+    check_stack(interp);
+    if (is_number(p0)) {
+        return mknum(proc_3_num(interp, p0.number));
+    }
+    Exp a2_data[] = { p0, mknum(0.0) };
+    List a2 = { .data = a2_data, .size = 2, .cap = 2 };
+    double v3 = scheme_eq(interp, a2).number;
+    double v8;
+    if (v3 != 0) {
+        v8 = 0.0;
+    } else {
+        Exp a4_data[] = { p0, mknum(1.0) };
+        List a4 = { .data = a4_data, .size = 2, .cap = 2 };
+        double v5 = scheme_sub(interp, a4).number;
+        double v6 = proc_3_num(interp, v5);
+        double v7 = (0.0 + 1.0 + v6);
+        v8 = v7;
+    }
+    return mknum(v8);
+}
+
+static Exp proc_3_entry(Interp *interp, List args)
+{
+    if (args.size != 1) {
+        die(interp, "%s: arity mismatch\n", "depth");
+    }
+    return proc_3(interp, args.data[0]);
+}
+
+static void init(Interp *interp)
+{
+    sym[0] = interp_symbol(interp, "k");
+    interp_pin(interp, sym[0]);
+    sym[1] = interp_symbol(interp, "fib");
+    interp_pin(interp, sym[1]);
+    sym[2] = interp_symbol(interp, "sumsq");
+    interp_pin(interp, sym[2]);
+    sym[3] = interp_symbol(interp, "addk");
+    interp_pin(interp, sym[3]);
+    sym[4] = interp_symbol(interp, "depth");
+    interp_pin(interp, sym[4]);
+    sym[5] = interp_symbol(interp, "guard");
+    interp_pin(interp, sym[5]);
+    sym[6] = interp_symbol(interp, "e");
+    interp_pin(interp, sym[6]);
+    sym[7] = interp_symbol(interp, "quote");
+    interp_pin(interp, sym[7]);
+    sym[8] = interp_symbol(interp, "not-a-number");
+    interp_pin(interp, sym[8]);
+    sym[9] = interp_symbol(interp, "list");
+    interp_pin(interp, sym[9]);
+    sym[10] = interp_symbol(interp, "set!");
+    interp_pin(interp, sym[10]);
+    sym[11] = interp_symbol(interp, "k-not-a-number");
+    interp_pin(interp, sym[11]);
+    sym[12] = interp_symbol(interp, "too-deep");
+    interp_pin(interp, sym[12]);
+    {
+        List d0 = VECTOR_INIT();
+        Exp e1;
+        e1 = sym[5];
+        list_add(interp, &d0, e1);
+        Exp e2;
+        {
+            List d3 = VECTOR_INIT();
+            Exp e4;
+            e4 = sym[6];
+            list_add(interp, &d3, e4);
+            Exp e5;
+            {
+                List d6 = VECTOR_INIT();
+                Exp e7;
+                e7 = mknum(1.0);
+                list_add(interp, &d6, e7);
+                Exp e8;
+                {
+                    List d9 = VECTOR_INIT();
+                    Exp e10;
+                    e10 = sym[7];
+                    list_add(interp, &d9, e10);
+                    Exp e11;
+                    e11 = sym[8];
+                    list_add(interp, &d9, e11);
+                    e8 = mklist(interp, d9);
+                }
+                list_add(interp, &d6, e8);
+                e5 = mklist(interp, d6);
+            }
+            list_add(interp, &d3, e5);
+            e2 = mklist(interp, d3);
+        }
+        list_add(interp, &d0, e2);
+        Exp e12;
+        {
+            List d13 = VECTOR_INIT();
+            Exp e14;
+            e14 = sym[2];
+            list_add(interp, &d13, e14);
+            Exp e15;
+            {
+                List d16 = VECTOR_INIT();
+                Exp e17;
+                e17 = sym[9];
+                list_add(interp, &d16, e17);
+                Exp e18;
+                e18 = mknum(1.0);
+                list_add(interp, &d16, e18);
+                e15 = mklist(interp, d16);
+            }
+            list_add(interp, &d13, e15);
+            Exp e19;
+            e19 = mknum(0.0);
+            list_add(interp, &d13, e19);
+            e12 = mklist(interp, d13);
+        }
+        list_add(interp, &d0, e12);
+        lit[0] = mklist(interp, d0);
+    }
+    interp_pin(interp, lit[0]);
+    {
+        List d20 = VECTOR_INIT();
+        Exp e21;
+        e21 = sym[10];
+        list_add(interp, &d20, e21);
+        Exp e22;
+        e22 = sym[0];
+        list_add(interp, &d20, e22);
+        Exp e23;
+        {
+            List d24 = VECTOR_INIT();
+            Exp e25;
+            e25 = sym[9];
+            list_add(interp, &d24, e25);
+            Exp e26;
+            e26 = mknum(1.0);
+            list_add(interp, &d24, e26);
+            e23 = mklist(interp, d24);
+        }
+        list_add(interp, &d20, e23);
+        lit[1] = mklist(interp, d20);
+    }
+    interp_pin(interp, lit[1]);
+    {
+        List d27 = VECTOR_INIT();
+        Exp e28;
+        e28 = sym[5];
+        list_add(interp, &d27, e28);
+        Exp e29;
+        {
+            List d30 = VECTOR_INIT();
+            Exp e31;
+            e31 = sym[6];
+            list_add(interp, &d30, e31);
+            Exp e32;
+            {
+                List d33 = VECTOR_INIT();
+                Exp e34;
+                e34 = mknum(1.0);
+                list_add(interp, &d33, e34);
+                Exp e35;
+                {
+                    List d36 = VECTOR_INIT();
+                    Exp e37;
+                    e37 = sym[7];
+                    list_add(interp, &d36, e37);
+                    Exp e38;
+                    e38 = sym[11];
+                    list_add(interp, &d36, e38);
+                    e35 = mklist(interp, d36);
+                }
+                list_add(interp, &d33, e35);
+                e32 = mklist(interp, d33);
+            }
+            list_add(interp, &d30, e32);
+            e29 = mklist(interp, d30);
+        }
+        list_add(interp, &d27, e29);
+        Exp e39;
+        {
+            List d40 = VECTOR_INIT();
+            Exp e41;
+            e41 = sym[3];
+            list_add(interp, &d40, e41);
+            Exp e42;
+            e42 = mknum(2000.0);
+            list_add(interp, &d40, e42);
+            Exp e43;
+            e43 = mknum(0.0);
+            list_add(interp, &d40, e43);
+            e39 = mklist(interp, d40);
+        }
+        list_add(interp, &d27, e39);
+        lit[2] = mklist(interp, d27);
+    }
+    interp_pin(interp, lit[2]);
+    {
+        List d44 = VECTOR_INIT();
+        Exp e45;
+        e45 = sym[10];
+        list_add(interp, &d44, e45);
+        Exp e46;
+        e46 = sym[0];
+        list_add(interp, &d44, e46);
+        Exp e47;
+        e47 = mknum(5.0);
+        list_add(interp, &d44, e47);
+        lit[3] = mklist(interp, d44);
+    }
+    interp_pin(interp, lit[3]);
+    {
+        List d48 = VECTOR_INIT();
+        Exp e49;
+        e49 = sym[5];
+        list_add(interp, &d48, e49);
+        Exp e50;
+        {
+            List d51 = VECTOR_INIT();
+            Exp e52;
+            e52 = sym[6];
+            list_add(interp, &d51, e52);
+            Exp e53;
+            {
+                List d54 = VECTOR_INIT();
+                Exp e55;
+                e55 = mknum(1.0);
+                list_add(interp, &d54, e55);
+                Exp e56;
+                {
+                    List d57 = VECTOR_INIT();
+                    Exp e58;
+                    e58 = sym[7];
+                    list_add(interp, &d57, e58);
+                    Exp e59;
+                    e59 = sym[12];
+                    list_add(interp, &d57, e59);
+                    e56 = mklist(interp, d57);
+                }
+                list_add(interp, &d54, e56);
+                e53 = mklist(interp, d54);
+            }
+            list_add(interp, &d51, e53);
+            e50 = mklist(interp, d51);
+        }
+        list_add(interp, &d48, e50);
+        Exp e60;
+        {
+            List d61 = VECTOR_INIT();
+            Exp e62;
+            e62 = sym[4];
+            list_add(interp, &d61, e62);
+            Exp e63;
+            e63 = mknum(100000000.0);
+            list_add(interp, &d61, e63);
+            e60 = mklist(interp, d61);
+        }
+        list_add(interp, &d48, e60);
+        lit[4] = mklist(interp, d48);
+    }
+    interp_pin(interp, lit[4]);
+}
+
+static void run(Interp *interp)
+{
+    stack_enter(interp);
+    // (define fib (lambda (n) (if (< n 2) n (+ (fib (- n 1)) (fib (- n 2))))))
+    defined[0] = true;
+    interp_define(interp, "fib", mkcproc(proc_0_entry));
+    // (fib 20)
+    gc_maybe_collect(interp);
+    {
+        if (!defined[0]) {
+            undefined(interp, sym[1]);
+        }
+        double v0 = proc_0_num(interp, 20.0);
+        show(interp, mknum(v0));
+    }
+    // (define sumsq (lambda (n acc) (if (= n 0) acc (sumsq (- n 1) (+ acc (* n ...
+    defined[1] = true;
+    interp_define(interp, "sumsq", mkcproc(proc_1_entry));
+    // (sumsq 2000 0)
+    gc_maybe_collect(interp);
+    {
+        if (!defined[1]) {
+            undefined(interp, sym[2]);
+        }
+        double v0 = proc_1_num(interp, 2000.0, 0.0);
+        show(interp, mknum(v0));
+    }
+    // (guard (e (1 (quote not-a-number))) (sumsq (list 1) 0))
+    eval_form(interp, lit[0]);
+    // (sumsq 10 3.141592653589793)
+    gc_maybe_collect(interp);
+    {
+        if (!defined[1]) {
+            undefined(interp, sym[2]);
+        }
+        double v0 = proc_1_num(interp, 10.0, 3.141592653589793);
+        show(interp, mknum(v0));
+    }
+    // (define k 2)
+    gc_maybe_collect(interp);
+    {
+        interp_define(interp, "k", mknum(2.0));
+    }
+    // (define addk (lambda (n acc) (if (= n 0) acc (addk (- n 1) (+ acc k)))))
+    defined[2] = true;
+    interp_define(interp, "addk", mkcproc(proc_2_entry));
+    // (addk 2000 0)
+    gc_maybe_collect(interp);
+    {
+        if (!defined[2]) {
+            undefined(interp, sym[3]);
+        }
+        Exp v0 = proc_2(interp, mknum(2000.0), mknum(0.0));
+        show(interp, v0);
+    }
+    // (define k 10)
+    gc_maybe_collect(interp);
+    {
+        interp_define(interp, "k", mknum(10.0));
+    }
+    // (addk 2000 0)
+    gc_maybe_collect(interp);
+    {
+        if (!defined[2]) {
+            undefined(interp, sym[3]);
+        }
+        Exp v0 = proc_2(interp, mknum(2000.0), mknum(0.0));
+        show(interp, v0);
+    }
+    // (set! k (list 1))
+    eval_form(interp, lit[1]);
+    // (guard (e (1 (quote k-not-a-number))) (addk 2000 0))
+    eval_form(interp, lit[2]);
+    // (set! k 5)
+    eval_form(interp, lit[3]);
+    // (addk 2000 0)
+    gc_maybe_collect(interp);
+    {
+        if (!defined[2]) {
+            undefined(interp, sym[3]);
+        }
+        Exp v0 = proc_2(interp, mknum(2000.0), mknum(0.0));
+        show(interp, v0);
+    }
+    // (define depth (lambda (n) (if (= n 0) 0 (+ 1 (depth (- n 1))))))
+    defined[3] = true;
+    interp_define(interp, "depth", mkcproc(proc_3_entry));
+    // (depth 5000)
+    gc_maybe_collect(interp);
+    {
+        if (!defined[3]) {
+            undefined(interp, sym[4]);
+        }
+        double v0 = proc_3_num(interp, 5000.0);
+        show(interp, mknum(v0));
+    }
+    // (guard (e (1 (quote too-deep))) (depth 100000000))
+    eval_form(interp, lit[4]);
+    // (depth 10)
+    gc_maybe_collect(interp);
+    {
+        if (!defined[3]) {
+            undefined(interp, sym[4]);
+        }
+        double v0 = proc_3_num(interp, 10.0);
+        show(interp, mknum(v0));
+    }
+}
+
+int main(void)
+{
+    Interp *interp = interp_new();
+    // forms left to the interpreter were optimized when compiled
+    interp->optimize = false;
+    init(interp);
+    run(interp);
+    interp_free(interp);
+    return 0;
+}
@@ -0,0 +1,1083 @@
+// Compiled from tests/loops.scm by scheme -c.
+
+#include "scheme.h"
+#include "gcobject.h"
+#include "ht.h"
+
+#define VOID_EXP ((Exp) { .type = EXP_VOID })
+
+static inline noreturn void undefined(Interp *interp, Exp name)
+{
+    die(interp, "undefined symbol: %s\n", AS_SYM(name));
+}
+
+static inline Exp global_ref(Interp *interp, Exp name)
+{
+    Exp value;
+    if (!ht_lookup(&ENV_HT(interp->global), name, &value)) {
+        undefined(interp, name);
+    }
+    return value;
+}
+
+// Raise a stack overflow past the limit run() set, as proc_call does.
+static inline void check_stack(Interp *interp)
+{
+    if ((uintptr_t) __builtin_frame_address(0) < interp->stack_limit) {
+        stack_overflow(interp);
+    }
+}
+
+static inline Exp proc_ref(Interp *interp, Exp proc)
+{
+    if (!is_proc(proc)) {
+        die(interp, "error: not a procedure\n");
+    }
+    return proc;
+}
+
+static inline Exp call(Interp *interp, Exp proc, List args)
+{
+    return proc.type == EXP_C_PROC ? proc.cproc(interp, args)
+                                   : proc_call(interp, &AS_PROC(proc), args);
+}
+
+// Print the value of a top-level form.
+static inline void show(Interp *interp, Exp val)
+{
+    print_to(interp->out, val);
+    if (val.type != EXP_VOID && val.type != EXP_EMPTY) {
+        writer_putc(interp->out, '\n');
+    }
+}
+
+// Run a form the compiler left to the interpreter.
+static inline void eval_form(Interp *interp, Exp form)
+{
+    Exp val = interp_eval(interp, form);
+    show(interp, val);
+    interp_unpin(interp, val);
+}
+
+static Exp sym[31];
+static Exp lit[5];
+static CProc prim[5];
+static bool defined[1];
+
+static double proc_0_num(Interp *interp, double p0);
+static Exp proc_0(Interp *interp, Exp p0);
+
+// count-down
+static double proc_0_num(Interp *interp, double p0)
+{
+    check_stack(interp);
+    double v2 = (double) (p0 == 0.0);
+    double v6;
+    if (v2 != 0) {
+        v6 = 0.0;
+    } else {
+        double v3 = (p0 - 1.0);
+        double v4 = proc_0_num(interp, v3);
+        double v5 = (0.0 + 1.0 + v4);
+        v6 = v5;
+    }
+    return v6;
+}
+
+// count-down
+static Exp proc_0(Interp *interp, Exp p0)
+{
+    check_stack(interp);
+    if (is_number(p0)) {
+        return mknum(proc_0_num(interp, p0.number));
+    }
+    Exp a2_data[] = { p0, mknum(0.0) };
+    List a2 = { .data = a2_data, .size = 2, .cap = 2 };
+    double v3 = scheme_eq(interp, a2).number;
+    double v8;
+    if (v3 != 0) {
+        v8 = 0.0;
+    } else {
+        Exp a4_data[] = { p0, mknum(1.0) };
+        List a4 = { .data = a4_data, .size = 2, .cap = 2 };
+        double v5 = scheme_sub(interp, a4).number;
+        double v6 = proc_0_num(interp, v5);
+        double v7 = (0.0 + 1.0 + v6);
+        v8 = v7;
+    }
+    return mknum(v8);
+}
+
+static Exp proc_0_entry(Interp *interp, List args)
+{
+    if (args.size != 1) {
+        die(interp, "%s: arity mismatch\n", "count-down");
+    }
+    return proc_0(interp, args.data[0]);
+}
+
+static void init(Interp *interp)
+{
+    sym[0] = interp_symbol(interp, "v");
+    interp_pin(interp, sym[0]);
+    sym[1] = interp_symbol(interp, "list");
+    interp_pin(interp, sym[1]);
+    sym[2] = interp_symbol(interp, "count-down");
+    interp_pin(interp, sym[2]);
+    sym[3] = interp_symbol(interp, "let");
+    interp_pin(interp, sym[3]);
+    sym[4] = interp_symbol(interp, "loop");
+    interp_pin(interp, sym[4]);
+    sym[5] = interp_symbol(interp, "i");
+    interp_pin(interp, sym[5]);
+    sym[6] = interp_symbol(interp, "caught");
+    interp_pin(interp, sym[6]);
+    sym[7] = interp_symbol(interp, "if");
+    interp_pin(interp, sym[7]);
+    sym[8] = interp_symbol(interp, "<");
+    interp_pin(interp, sym[8]);
+    sym[9] = interp_symbol(interp, "+");
+    interp_pin(interp, sym[9]);
+    sym[10] = interp_symbol(interp, "guard");
+    interp_pin(interp, sym[10]);
+    sym[11] = interp_symbol(interp, "e");
+    interp_pin(interp, sym[11]);
+    sym[12] = interp_symbol(interp, "=");
+    interp_pin(interp, sym[12]);
+    sym[13] = interp_symbol(interp, "vector-ref");
+    interp_pin(interp, sym[13]);
+    sym[14] = interp_symbol(interp, "raise");
+    interp_pin(interp, sym[14]);
+    sym[15] = interp_symbol(interp, "ch");
+    interp_pin(interp, sym[15]);
+    sym[16] = interp_symbol(interp, "make-channel");
+    interp_pin(interp, sym[16]);
+    sym[17] = interp_symbol(interp, "producer");
+    interp_pin(interp, sym[17]);
+    sym[18] = interp_symbol(interp, "spawn");
+    interp_pin(interp, sym[18]);
+    sym[19] = interp_symbol(interp, "lambda");
+    interp_pin(interp, sym[19]);
+    sym[20] = interp_symbol(interp, "begin");
+    interp_pin(interp, sym[20]);
+    sym[21] = interp_symbol(interp, "channel-send");
+    interp_pin(interp, sym[21]);
+    sym[22] = interp_symbol(interp, "quote");
+    interp_pin(interp, sym[22]);
+    sym[23] = interp_symbol(interp, "done");
+    interp_pin(interp, sym[23]);
+    sym[24] = interp_symbol(interp, "sum");
+    interp_pin(interp, sym[24]);
+    sym[25] = interp_symbol(interp, "channel-receive");
+    interp_pin(interp, sym[25]);
+    sym[26] = interp_symbol(interp, "join");
+    interp_pin(interp, sym[26]);
+    sym[27] = interp_symbol(interp, "end");
+    interp_pin(interp, sym[27]);
+    sym[28] = interp_symbol(interp, "too-deep");
+    interp_pin(interp, sym[28]);
+    sym[29] = interp_symbol(interp, "make-vector");
+    interp_pin(interp, sym[29]);
+    sym[30] = interp_symbol(interp, "vector-set!");
+    interp_pin(interp, sym[30]);
+    {
+        List d0 = VECTOR_INIT();
+        Exp e1;
+        e1 = sym[3];
+        list_add(interp, &d0, e1);
+        Exp e2;
+        e2 = sym[4];
+        list_add(interp, &d0, e2);
+        Exp e3;
+        {
+            List d4 = VECTOR_INIT();
+            Exp e5;
+            {
+                List d6 = VECTOR_INIT();
+                Exp e7;
+                e7 = sym[5];
+                list_add(interp, &d6, e7);
+                Exp e8;
+                e8 = mknum(0.0);
+                list_add(interp, &d6, e8);
+                e5 = mklist(interp, d6);
+            }
+            list_add(interp, &d4, e5);
+            Exp e9;
+            {
+                List d10 = VECTOR_INIT();
+                Exp e11;
+                e11 = sym[6];
+                list_add(interp, &d10, e11);
+                Exp e12;
+                e12 = mknum(0.0);
+                list_add(interp, &d10, e12);
+                e9 = mklist(interp, d10);
+            }
+            list_add(interp, &d4, e9);
+            e3 = mklist(interp, d4);
+        }
+        list_add(interp, &d0, e3);
+        Exp e13;
+        {
+            List d14 = VECTOR_INIT();
+            Exp e15;
+            e15 = sym[7];
+            list_add(interp, &d14, e15);
+            Exp e16;
+            {
+                List d17 = VECTOR_INIT();
+                Exp e18;
+                e18 = sym[8];
+                list_add(interp, &d17, e18);
+                Exp e19;
+                e19 = sym[5];
+                list_add(interp, &d17, e19);
+                Exp e20;
+                e20 = mknum(20000.0);
+                list_add(interp, &d17, e20);
+                e16 = mklist(interp, d17);
+            }
+            list_add(interp, &d14, e16);
+            Exp e21;
+            {
+                List d22 = VECTOR_INIT();
+                Exp e23;
+                e23 = sym[4];
+                list_add(interp, &d22, e23);
+                Exp e24;
+                {
+                    List d25 = VECTOR_INIT();
+                    Exp e26;
+                    e26 = sym[9];
+                    list_add(interp, &d25, e26);
+                    Exp e27;
+                    e27 = sym[5];
+                    list_add(interp, &d25, e27);
+                    Exp e28;
+                    e28 = mknum(1.0);
+                    list_add(interp, &d25, e28);
+                    e24 = mklist(interp, d25);
+                }
+                list_add(interp, &d22, e24);
+                Exp e29;
+                {
+                    List d30 = VECTOR_INIT();
+                    Exp e31;
+                    e31 = sym[9];
+                    list_add(interp, &d30, e31);
+                    Exp e32;
+                    e32 = sym[6];
+                    list_add(interp, &d30, e32);
+                    Exp e33;
+                    {
+                        List d34 = VECTOR_INIT();
+                        Exp e35;
+                        e35 = sym[10];
+                        list_add(interp, &d34, e35);
+                        Exp e36;
+                        {
+                            List d37 = VECTOR_INIT();
+                            Exp e38;
+                            e38 = sym[11];
+                            list_add(interp, &d37, e38);
+                            Exp e39;
+                            {
+                                List d40 = VECTOR_INIT();
+                                Exp e41;
+                                e41 = mknum(1.0);
+                                list_add(interp, &d40, e41);
+                                Exp e42;
+                                e42 = mknum(1.0);
+                                list_add(interp, &d40, e42);
+                                e39 = mklist(interp, d40);
+                            }
+                            list_add(interp, &d37, e39);
+                            e36 = mklist(interp, d37);
+                        }
+                        list_add(interp, &d34, e36);
+                        Exp e43;
+                        {
+                            List d44 = VECTOR_INIT();
+                            Exp e45;
+                            e45 = sym[7];
+                            list_add(interp, &d44, e45);
+                            Exp e46;
+                            {
+                                List d47 = VECTOR_INIT();
+                                Exp e48;
+                                e48 = sym[12];
+                                list_add(interp, &d47, e48);
+                                Exp e49;
+                                {
+                                    List d50 = VECTOR_INIT();
+                                    Exp e51;
+                                    e51 = sym[13];
+                                    list_add(interp, &d50, e51);
+                                    Exp e52;
+                                    e52 = sym[0];
+                                    list_add(interp, &d50, e52);
+                                    Exp e53;
+                                    e53 = sym[5];
+                                    list_add(interp, &d50, e53);
+                                    e49 = mklist(interp, d50);
+                                }
+                                list_add(interp, &d47, e49);
+                                Exp e54;
+                                e54 = mknum(5.0);
+                                list_add(interp, &d47, e54);
+                                e46 = mklist(interp, d47);
+                            }
+                            list_add(interp, &d44, e46);
+                            Exp e55;
+                            {
+                                List d56 = VECTOR_INIT();
+                                Exp e57;
+                                e57 = sym[14];
+                                list_add(interp, &d56, e57);
+                                Exp e58;
+                                e58 = sym[5];
+                                list_add(interp, &d56, e58);
+                                e55 = mklist(interp, d56);
+                            }
+                            list_add(interp, &d44, e55);
+                            Exp e59;
+                            e59 = mknum(0.0);
+                            list_add(interp, &d44, e59);
+                            e43 = mklist(interp, d44);
+                        }
+                        list_add(interp, &d34, e43);
+                        e33 = mklist(interp, d34);
+                    }
+                    list_add(interp, &d30, e33);
+                    e29 = mklist(interp, d30);
+                }
+                list_add(interp, &d22, e29);
+                e21 = mklist(interp, d22);
+            }
+            list_add(interp, &d14, e21);
+            Exp e60;
+            e60 = sym[6];
+            list_add(interp, &d14, e60);
+            e13 = mklist(interp, d14);
+        }
+        list_add(interp, &d0, e13);
+        lit[0] = mklist(interp, d0);
+    }
+    interp_pin(interp, lit[0]);
+    {
+        List d61 = VECTOR_INIT();
+        Exp e62;
+        e62 = sym[3];
+        list_add(interp, &d61, e62);
+        Exp e63;
+        {
+            List d64 = VECTOR_INIT();
+            Exp e65;
+            {
+                List d66 = VECTOR_INIT();
+                Exp e67;
+                e67 = sym[15];
+                list_add(interp, &d66, e67);
+                Exp e68;
+                {
+                    List d69 = VECTOR_INIT();
+                    Exp e70;
+                    e70 = sym[16];
+                    list_add(interp, &d69, e70);
+                    Exp e71;
+                    e71 = mknum(16.0);
+                    list_add(interp, &d69, e71);
+                    e68 = mklist(interp, d69);
+                }
+                list_add(interp, &d66, e68);
+                e65 = mklist(interp, d66);
+            }
+            list_add(interp, &d64, e65);
+            e63 = mklist(interp, d64);
+        }
+        list_add(interp, &d61, e63);
+        Exp e72;
+        {
+            List d73 = VECTOR_INIT();
+            Exp e74;
+            e74 = sym[3];
+            list_add(interp, &d73, e74);
+            Exp e75;
+            {
+                List d76 = VECTOR_INIT();
+                Exp e77;
+                {
+                    List d78 = VECTOR_INIT();
+                    Exp e79;
+                    e79 = sym[17];
+                    list_add(interp, &d78, e79);
+                    Exp e80;
+                    {
+                        List d81 = VECTOR_INIT();
+                        Exp e82;
+                        e82 = sym[18];
+                        list_add(interp, &d81, e82);
+                        Exp e83;
+                        {
+                            List d84 = VECTOR_INIT();
+                            Exp e85;
+                            e85 = sym[19];
+                            list_add(interp, &d84, e85);
+                            Exp e86;
+                            {
+                                List d87 = VECTOR_INIT();
+                                e86 = mklist(interp, d87);
+                            }
+                            list_add(interp, &d84, e86);
+                            Exp e88;
+                            {
+                                List d89 = VECTOR_INIT();
+                                Exp e90;
+                                e90 = sym[3];
+                                list_add(interp, &d89, e90);
+                                Exp e91;
+                                e91 = sym[4];
+                                list_add(interp, &d89, e91);
+                                Exp e92;
+                                {
+                                    List d93 = VECTOR_INIT();
+                                    Exp e94;
+                                    {
+                                        List d95 = VECTOR_INIT();
+                                        Exp e96;
+                                        e96 = sym[5];
+                                        list_add(interp, &d95, e96);
+                                        Exp e97;
+                                        e97 = mknum(0.0);
+                                        list_add(interp, &d95, e97);
+                                        e94 = mklist(interp, d95);
+                                    }
+                                    list_add(interp, &d93, e94);
+                                    e92 = mklist(interp, d93);
+                                }
+                                list_add(interp, &d89, e92);
+                                Exp e98;
+                                {
+                                    List d99 = VECTOR_INIT();
+                                    Exp e100;
+                                    e100 = sym[7];
+                                    list_add(interp, &d99, e100);
+                                    Exp e101;
+                                    {
+                                        List d102 = VECTOR_INIT();
+                                        Exp e103;
+                                        e103 = sym[8];
+                                        list_add(interp, &d102, e103);
+                                        Exp e104;
+                                        e104 = sym[5];
+                                        list_add(interp, &d102, e104);
+                                        Exp e105;
+                                        e105 = mknum(20000.0);
+                                        list_add(interp, &d102, e105);
+                                        e101 = mklist(interp, d102);
+                                    }
+                                    list_add(interp, &d99, e101);
+                                    Exp e106;
+                                    {
+                                        List d107 = VECTOR_INIT();
+                                        Exp e108;
+                                        e108 = sym[20];
+                                        list_add(interp, &d107, e108);
+                                        Exp e109;
+                                        {
+                                            List d110 = VECTOR_INIT();
+                                            Exp e111;
+                                            e111 = sym[21];
+                                            list_add(interp, &d110, e111);
+                                            Exp e112;
+                                            e112 = sym[15];
+                                            list_add(interp, &d110, e112);
+                                            Exp e113;
+                                            e113 = sym[5];
+                                            list_add(interp, &d110, e113);
+                                            e109 = mklist(interp, d110);
+                                        }
+                                        list_add(interp, &d107, e109);
+                                        Exp e114;
+                                        {
+                                            List d115 = VECTOR_INIT();
+                                            Exp e116;
+                                            e116 = sym[4];
+                                            list_add(interp, &d115, e116);
+                                            Exp e117;
+                                            {
+                                                List d118 = VECTOR_INIT();
+                                                Exp e119;
+                                                e119 = sym[9];
+                                                list_add(interp, &d118, e119);
+                                                Exp e120;
+                                                e120 = sym[5];
+                                                list_add(interp, &d118, e120);
+                                                Exp e121;
+                                                e121 = mknum(1.0);
+                                                list_add(interp, &d118, e121);
+                                                e117 = mklist(interp, d118);
+                                            }
+                                            list_add(interp, &d115, e117);
+                                            e114 = mklist(interp, d115);
+                                        }
+                                        list_add(interp, &d107, e114);
+                                        e106 = mklist(interp, d107);
+                                    }
+                                    list_add(interp, &d99, e106);
+                                    Exp e122;
+                                    {
+                                        List d123 = VECTOR_INIT();
+                                        Exp e124;
+                                        e124 = sym[22];
+                                        list_add(interp, &d123, e124);
+                                        Exp e125;
+                                        e125 = sym[23];
+                                        list_add(interp, &d123, e125);
+                                        e122 = mklist(interp, d123);
+                                    }
+                                    list_add(interp, &d99, e122);
+                                    e98 = mklist(interp, d99);
+                                }
+                                list_add(interp, &d89, e98);
+                                e88 = mklist(interp, d89);
+                            }
+                            list_add(interp, &d84, e88);
+                            e83 = mklist(interp, d84);
+                        }
+                        list_add(interp, &d81, e83);
+                        e80 = mklist(interp, d81);
+                    }
+                    list_add(interp, &d78, e80);
+                    e77 = mklist(interp, d78);
+                }
+                list_add(interp, &d76, e77);
+                e75 = mklist(interp, d76);
+            }
+            list_add(interp, &d73, e75);
+            Exp e126;
+            {
+                List d127 = VECTOR_INIT();
+                Exp e128;
+                e128 = sym[3];
+                list_add(interp, &d127, e128);
+                Exp e129;
+                e129 = sym[4];
+                list_add(interp, &d127, e129);
+                Exp e130;
+                {
+                    List d131 = VECTOR_INIT();
+                    Exp e132;
+                    {
+                        List d133 = VECTOR_INIT();
+                        Exp e134;
+                        e134 = sym[5];
+                        list_add(interp, &d133, e134);
+                        Exp e135;
+                        e135 = mknum(0.0);
+                        list_add(interp, &d133, e135);
+                        e132 = mklist(interp, d133);
+                    }
+                    list_add(interp, &d131, e132);
+                    Exp e136;
+                    {
+                        List d137 = VECTOR_INIT();
+                        Exp e138;
+                        e138 = sym[24];
+                        list_add(interp, &d137, e138);
+                        Exp e139;
+                        e139 = mknum(0.0);
+                        list_add(interp, &d137, e139);
+                        e136 = mklist(interp, d137);
+                    }
+                    list_add(interp, &d131, e136);
+                    e130 = mklist(interp, d131);
+                }
+                list_add(interp, &d127, e130);
+                Exp e140;
+                {
+                    List d141 = VECTOR_INIT();
+                    Exp e142;
+                    e142 = sym[7];
+                    list_add(interp, &d141, e142);
+                    Exp e143;
+                    {
+                        List d144 = VECTOR_INIT();
+                        Exp e145;
+                        e145 = sym[8];
+                        list_add(interp, &d144, e145);
+                        Exp e146;
+                        e146 = sym[5];
+                        list_add(interp, &d144, e146);
+                        Exp e147;
+                        e147 = mknum(20000.0);
+                        list_add(interp, &d144, e147);
+                        e143 = mklist(interp, d144);
+                    }
+                    list_add(interp, &d141, e143);
+                    Exp e148;
+                    {
+                        List d149 = VECTOR_INIT();
+                        Exp e150;
+                        e150 = sym[4];
+                        list_add(interp, &d149, e150);
+                        Exp e151;
+                        {
+                            List d152 = VECTOR_INIT();
+                            Exp e153;
+                            e153 = sym[9];
+                            list_add(interp, &d152, e153);
+                            Exp e154;
+                            e154 = sym[5];
+                            list_add(interp, &d152, e154);
+                            Exp e155;
+                            e155 = mknum(1.0);
+                            list_add(interp, &d152, e155);
+                            e151 = mklist(interp, d152);
+                        }
+                        list_add(interp, &d149, e151);
+                        Exp e156;
+                        {
+                            List d157 = VECTOR_INIT();
+                            Exp e158;
+                            e158 = sym[9];
+                            list_add(interp, &d157, e158);
+                            Exp e159;
+                            e159 = sym[24];
+                            list_add(interp, &d157, e159);
+                            Exp e160;
+                            {
+                                List d161 = VECTOR_INIT();
+                                Exp e162;
+                                e162 = sym[25];
+                                list_add(interp, &d161, e162);
+                                Exp e163;
+                                e163 = sym[15];
+                                list_add(interp, &d161, e163);
+                                e160 = mklist(interp, d161);
+                            }
+                            list_add(interp, &d157, e160);
+                            e156 = mklist(interp, d157);
+                        }
+                        list_add(interp, &d149, e156);
+                        e148 = mklist(interp, d149);
+                    }
+                    list_add(interp, &d141, e148);
+                    Exp e164;
+                    {
+                        List d165 = VECTOR_INIT();
+                        Exp e166;
+                        e166 = sym[1];
+                        list_add(interp, &d165, e166);
+                        Exp e167;
+                        {
+                            List d168 = VECTOR_INIT();
+                            Exp e169;
+                            e169 = sym[26];
+                            list_add(interp, &d168, e169);
+                            Exp e170;
+                            e170 = sym[17];
+                            list_add(interp, &d168, e170);
+                            e167 = mklist(interp, d168);
+                        }
+                        list_add(interp, &d165, e167);
+                        Exp e171;
+                        e171 = sym[24];
+                        list_add(interp, &d165, e171);
+                        e164 = mklist(interp, d165);
+                    }
+                    list_add(interp, &d141, e164);
+                    e140 = mklist(interp, d141);
+                }
+                list_add(interp, &d127, e140);
+                e126 = mklist(interp, d127);
+            }
+            list_add(interp, &d73, e126);
+            e72 = mklist(interp, d73);
+        }
+        list_add(interp, &d61, e72);
+        lit[1] = mklist(interp, d61);
+    }
+    interp_pin(interp, lit[1]);
+    {
+        List d172 = VECTOR_INIT();
+        Exp e173;
+        e173 = sym[3];
+        list_add(interp, &d172, e173);
+        Exp e174;
+        {
+            List d175 = VECTOR_INIT();
+            Exp e176;
+            {
+                List d177 = VECTOR_INIT();
+                Exp e178;
+                e178 = sym[20];
+                list_add(interp, &d177, e178);
+                Exp e179;
+                e179 = sym[1];
+                list_add(interp, &d177, e179);
+                e176 = mklist(interp, d177);
+            }
+            list_add(interp, &d175, e176);
+            e174 = mklist(interp, d175);
+        }
+        list_add(interp, &d172, e174);
+        Exp e180;
+        {
+            List d181 = VECTOR_INIT();
+            Exp e182;
+            e182 = sym[3];
+            list_add(interp, &d181, e182);
+            Exp e183;
+            e183 = sym[4];
+            list_add(interp, &d181, e183);
+            Exp e184;
+            {
+                List d185 = VECTOR_INIT();
+                Exp e186;
+                {
+                    List d187 = VECTOR_INIT();
+                    Exp e188;
+                    e188 = sym[5];
+                    list_add(interp, &d187, e188);
+                    Exp e189;
+                    e189 = mknum(0.0);
+                    list_add(interp, &d187, e189);
+                    e186 = mklist(interp, d187);
+                }
+                list_add(interp, &d185, e186);
+                e184 = mklist(interp, d185);
+            }
+            list_add(interp, &d181, e184);
+            Exp e190;
+            {
+                List d191 = VECTOR_INIT();
+                Exp e192;
+                e192 = sym[7];
+                list_add(interp, &d191, e192);
+                Exp e193;
+                {
+                    List d194 = VECTOR_INIT();
+                    Exp e195;
+                    e195 = sym[8];
+                    list_add(interp, &d194, e195);
+                    Exp e196;
+                    e196 = sym[5];
+                    list_add(interp, &d194, e196);
+                    Exp e197;
+                    e197 = mknum(3.0);
+                    list_add(interp, &d194, e197);
+                    e193 = mklist(interp, d194);
+                }
+                list_add(interp, &d191, e193);
+                Exp e198;
+                {
+                    List d199 = VECTOR_INIT();
+                    Exp e200;
+                    e200 = sym[20];
+                    list_add(interp, &d199, e200);
+                    Exp e201;
+                    e201 = sym[5];
+                    list_add(interp, &d199, e201);
+                    Exp e202;
+                    {
+                        List d203 = VECTOR_INIT();
+                        Exp e204;
+                        e204 = sym[4];
+                        list_add(interp, &d203, e204);
+                        Exp e205;
+                        {
+                            List d206 = VECTOR_INIT();
+                            Exp e207;
+                            e207 = sym[9];
+                            list_add(interp, &d206, e207);
+                            Exp e208;
+                            e208 = sym[5];
+                            list_add(interp, &d206, e208);
+                            Exp e209;
+                            e209 = mknum(1.0);
+                            list_add(interp, &d206, e209);
+                            e205 = mklist(interp, d206);
+                        }
+                        list_add(interp, &d203, e205);
+                        e202 = mklist(interp, d203);
+                    }
+                    list_add(interp, &d199, e202);
+                    e198 = mklist(interp, d199);
+                }
+                list_add(interp, &d191, e198);
+                Exp e210;
+                {
+                    List d211 = VECTOR_INIT();
+                    Exp e212;
+                    e212 = sym[22];
+                    list_add(interp, &d211, e212);
+                    Exp e213;
+                    e213 = sym[27];
+                    list_add(interp, &d211, e213);
+                    e210 = mklist(interp, d211);
+                }
+                list_add(interp, &d191, e210);
+                e190 = mklist(interp, d191);
+            }
+            list_add(interp, &d181, e190);
+            e180 = mklist(interp, d181);
+        }
+        list_add(interp, &d172, e180);
+        lit[2] = mklist(interp, d172);
+    }
+    interp_pin(interp, lit[2]);
+    {
+        List d214 = VECTOR_INIT();
+        Exp e215;
+        e215 = sym[10];
+        list_add(interp, &d214, e215);
+        Exp e216;
+        {
+            List d217 = VECTOR_INIT();
+            Exp e218;
+            e218 = sym[11];
+            list_add(interp, &d217, e218);
+            Exp e219;
+            {
+                List d220 = VECTOR_INIT();
+                Exp e221;
+                e221 = mknum(1.0);
+                list_add(interp, &d220, e221);
+                Exp e222;
+                {
+                    List d223 = VECTOR_INIT();
+                    Exp e224;
+                    e224 = sym[22];
+                    list_add(interp, &d223, e224);
+                    Exp e225;
+                    e225 = sym[28];
+                    list_add(interp, &d223, e225);
+                    e222 = mklist(interp, d223);
+                }
+                list_add(interp, &d220, e222);
+                e219 = mklist(interp, d220);
+            }
+            list_add(interp, &d217, e219);
+            e216 = mklist(interp, d217);
+        }
+        list_add(interp, &d214, e216);
+        Exp e226;
+        {
+            List d227 = VECTOR_INIT();
+            Exp e228;
+            e228 = sym[2];
+            list_add(interp, &d227, e228);
+            Exp e229;
+            e229 = mknum(100000000.0);
+            list_add(interp, &d227, e229);
+            e226 = mklist(interp, d227);
+        }
+        list_add(interp, &d214, e226);
+        lit[3] = mklist(interp, d214);
+    }
+    interp_pin(interp, lit[3]);
+    {
+        List d230 = VECTOR_INIT();
+        Exp e231;
+        e231 = sym[3];
+        list_add(interp, &d230, e231);
+        Exp e232;
+        e232 = sym[4];
+        list_add(interp, &d230, e232);
+        Exp e233;
+        {
+            List d234 = VECTOR_INIT();
+            Exp e235;
+            {
+                List d236 = VECTOR_INIT();
+                Exp e237;
+                e237 = sym[5];
+                list_add(interp, &d236, e237);
+                Exp e238;
+                e238 = mknum(0.0);
+                list_add(interp, &d236, e238);
+                e235 = mklist(interp, d236);
+            }
+            list_add(interp, &d234, e235);
+            e233 = mklist(interp, d234);
+        }
+        list_add(interp, &d230, e233);
+        Exp e239;
+        {
+            List d240 = VECTOR_INIT();
+            Exp e241;
+            e241 = sym[7];
+            list_add(interp, &d240, e241);
+            Exp e242;
+            {
+                List d243 = VECTOR_INIT();
+                Exp e244;
+                e244 = sym[8];
+                list_add(interp, &d243, e244);
+                Exp e245;
+                e245 = sym[5];
+                list_add(interp, &d243, e245);
+                Exp e246;
+                e246 = mknum(20000.0);
+                list_add(interp, &d243, e246);
+                e242 = mklist(interp, d243);
+            }
+            list_add(interp, &d240, e242);
+            Exp e247;
+            {
+                List d248 = VECTOR_INIT();
+                Exp e249;
+                e249 = sym[10];
+                list_add(interp, &d248, e249);
+                Exp e250;
+                {
+                    List d251 = VECTOR_INIT();
+                    Exp e252;
+                    e252 = sym[11];
+                    list_add(interp, &d251, e252);
+                    Exp e253;
+                    {
+                        List d254 = VECTOR_INIT();
+                        Exp e255;
+                        e255 = mknum(1.0);
+                        list_add(interp, &d254, e255);
+                        Exp e256;
+                        {
+                            List d257 = VECTOR_INIT();
+                            Exp e258;
+                            e258 = sym[22];
+                            list_add(interp, &d257, e258);
+                            Exp e259;
+                            e259 = sym[28];
+                            list_add(interp, &d257, e259);
+                            e256 = mklist(interp, d257);
+                        }
+                        list_add(interp, &d254, e256);
+                        e253 = mklist(interp, d254);
+                    }
+                    list_add(interp, &d251, e253);
+                    e250 = mklist(interp, d251);
+                }
+                list_add(interp, &d248, e250);
+                Exp e260;
+                {
+                    List d261 = VECTOR_INIT();
+                    Exp e262;
+                    e262 = sym[4];
+                    list_add(interp, &d261, e262);
+                    Exp e263;
+                    {
+                        List d264 = VECTOR_INIT();
+                        Exp e265;
+                        e265 = sym[9];
+                        list_add(interp, &d264, e265);
+                        Exp e266;
+                        e266 = sym[5];
+                        list_add(interp, &d264, e266);
+                        Exp e267;
+                        e267 = mknum(1.0);
+                        list_add(interp, &d264, e267);
+                        e263 = mklist(interp, d264);
+                    }
+                    list_add(interp, &d261, e263);
+                    e260 = mklist(interp, d261);
+                }
+                list_add(interp, &d248, e260);
+                e247 = mklist(interp, d248);
+            }
+            list_add(interp, &d240, e247);
+            Exp e268;
+            e268 = sym[5];
+            list_add(interp, &d240, e268);
+            e239 = mklist(interp, d240);
+        }
+        list_add(interp, &d230, e239);
+        lit[4] = mklist(interp, d230);
+    }
+    interp_pin(interp, lit[4]);
+    prim[0] = global_ref(interp, sym[29]).cproc;
+    prim[1] = global_ref(interp, sym[30]).cproc;
+    prim[2] = global_ref(interp, sym[13]).cproc;
+    prim[3] = global_ref(interp, sym[16]).cproc;
+    prim[4] = global_ref(interp, sym[18]).cproc;
+}
+
+static void run(Interp *interp)
+{
+    stack_enter(interp);
+    // (define v (make-vector 20000 0))
+    gc_maybe_collect(interp);
+    {
+        Exp a0_data[] = { mknum(20000.0), mknum(0.0) };
+        List a0 = { .data = a0_data, .size = 2, .cap = 2 };
+        Exp v1 = prim[0](interp, a0);
+        interp_define(interp, "v", v1);
+    }
+    // (let loop ((i 0)) (if (< i 20000) (begin (vector-set! v i i) (loop (+ i  ...
+    gc_maybe_collect(interp);
+    {
+        double l2 = 0.0;
+        double v9;
+        loop0:;
+        double v3 = (double) (l2 < 20000.0);
+        double v8;
+        if (v3 != 0) {
+            Exp v4 = global_ref(interp, sym[0]);
+            Exp a5_data[] = { v4, mknum(l2), mknum(l2) };
+            List a5 = { .data = a5_data, .size = 3, .cap = 3 };
+            Exp v6 = prim[1](interp, a5);
+            (void) v6;
+            double v7 = (0.0 + l2 + 1.0);
+            l2 = v7;
+            goto loop0;
+        } else {
+            v8 = l2;
+        }
+        v9 = v8;
+        show(interp, mknum(v9));
+    }
+    // (vector-ref v 19999)
+    gc_maybe_collect(interp);
+    {
+        Exp v0 = global_ref(interp, sym[0]);
+        Exp a1_data[] = { v0, mknum(19999.0) };
+        List a1 = { .data = a1_data, .size = 2, .cap = 2 };
+        Exp v2 = prim[2](interp, a1);
+        show(interp, v2);
+    }
+    // (let loop ((i 0) (caught 0)) (if (< i 20000) (loop (+ i 1) (+ caught (gu ...
+    eval_form(interp, lit[0]);
+    // (let ((ch (make-channel 16))) (let ((producer (spawn (lambda () (let loo ...
+    eval_form(interp, lit[1]);
+    // (let ((begin list)) (let loop ((i 0)) (if (< i 3) (begin i (loop (+ i 1) ...
+    eval_form(interp, lit[2]);
+    // (define count-down (lambda (n) (if (= n 0) 0 (+ 1 (count-down (- n 1)))) ...
+    defined[0] = true;
+    interp_define(interp, "count-down", mkcproc(proc_0_entry));
+    // (guard (e (1 (quote too-deep))) (count-down 100000000))
+    eval_form(interp, lit[3]);
+    // (let loop ((i 0)) (if (< i 20000) (guard (e (1 (quote too-deep))) (loop  ...
+    eval_form(interp, lit[4]);
+    // (count-down 1000)
+    gc_maybe_collect(interp);
+    {
+        if (!defined[0]) {
+            undefined(interp, sym[2]);
+        }
+        double v0 = proc_0_num(interp, 1000.0);
+        show(interp, mknum(v0));
+    }
+}
+
+int main(void)
+{
+    Interp *interp = interp_new();
+    // forms left to the interpreter were optimized when compiled
+    interp->optimize = false;
+    init(interp);
+    run(interp);
+    interp_free(interp);
+    return 0;
+}
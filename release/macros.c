@@ -0,0 +1,657 @@
+// Compiled from tests/macros.scm by scheme -c.
+
+#include "scheme.h"
+#include "gcobject.h"
+#include "ht.h"
+
+#define VOID_EXP ((Exp) { .type = EXP_VOID })
+
+static inline noreturn void undefined(Interp *interp, Exp name)
+{
+    die(interp, "undefined symbol: %s\n", AS_SYM(name));
+}
+
+static inline Exp global_ref(Interp *interp, Exp name)
+{
+    Exp value;
+    if (!ht_lookup(&ENV_HT(interp->global), name, &value)) {
+        undefined(interp, name);
+    }
+    return value;
+}
+
+// Raise a stack overflow past the limit run() set, as proc_call does.
+static inline void check_stack(Interp *interp)
+{
+    if ((uintptr_t) __builtin_frame_address(0) < interp->stack_limit) {
+        stack_overflow(interp);
+    }
+}
+
+static inline Exp proc_ref(Interp *interp, Exp proc)
+{
+    if (!is_proc(proc)) {
+        die(interp, "error: not a procedure\n");
+    }
+    return proc;
+}
+
+static inline Exp call(Interp *interp, Exp proc, List args)
+{
+    return proc.type == EXP_C_PROC ? proc.cproc(interp, args)
+                                   : proc_call(interp, &AS_PROC(proc), args);
+}
+
+// Print the value of a top-level form.
+static inline void show(Interp *interp, Exp val)
+{
+    print_to(interp->out, val);
+    if (val.type != EXP_VOID && val.type != EXP_EMPTY) {
+        writer_putc(interp->out, '\n');
+    }
+}
+
+// Run a form the compiler left to the interpreter.
+static inline void eval_form(Interp *interp, Exp form)
+{
+    Exp val = interp_eval(interp, form);
+    show(interp, val);
+    interp_unpin(interp, val);
+}
+
+static Exp sym[17];
+static Exp lit[7];
+static bool defined[1];
+
+static Exp proc_0(Interp *interp, Exp p0);
+
+// f
+static Exp proc_0(Interp *interp, Exp p0)
+{
+    check_stack(interp);
+    Exp v2 = proc_ref(interp, p0);
+    Exp a3_data[] = { mknum(3.0) };
+    List a3 = { .data = a3_data, .size = 1, .cap = 1 };
+    Exp v4 = call(interp, v2, a3);
+    return v4;
+}
+
+static Exp proc_0_entry(Interp *interp, List args)
+{
+    if (args.size != 1) {
+        die(interp, "%s: arity mismatch\n", "f");
+    }
+    return proc_0(interp, args.data[0]);
+}
+
+static void init(Interp *interp)
+{
+    sym[0] = interp_symbol(interp, "f");
+    interp_pin(interp, sym[0]);
+    sym[1] = interp_symbol(interp, "lambda");
+    interp_pin(interp, sym[1]);
+    sym[2] = interp_symbol(interp, "x");
+    interp_pin(interp, sym[2]);
+    sym[3] = interp_symbol(interp, "*");
+    interp_pin(interp, sym[3]);
+    sym[4] = interp_symbol(interp, "let");
+    interp_pin(interp, sym[4]);
+    sym[5] = interp_symbol(interp, "my-or");
+    interp_pin(interp, sym[5]);
+    sym[6] = interp_symbol(interp, "+");
+    interp_pin(interp, sym[6]);
+    sym[7] = interp_symbol(interp, "let*");
+    interp_pin(interp, sym[7]);
+    sym[8] = interp_symbol(interp, "a");
+    interp_pin(interp, sym[8]);
+    sym[9] = interp_symbol(interp, "letrec");
+    interp_pin(interp, sym[9]);
+    sym[10] = interp_symbol(interp, "if");
+    interp_pin(interp, sym[10]);
+    sym[11] = interp_symbol(interp, "=");
+    interp_pin(interp, sym[11]);
+    sym[12] = interp_symbol(interp, "-");
+    interp_pin(interp, sym[12]);
+    sym[13] = interp_symbol(interp, "done");
+    interp_pin(interp, sym[13]);
+    sym[14] = interp_symbol(interp, "do");
+    interp_pin(interp, sym[14]);
+    sym[15] = interp_symbol(interp, "i");
+    interp_pin(interp, sym[15]);
+    sym[16] = interp_symbol(interp, "define");
+    interp_pin(interp, sym[16]);
+    {
+        List d0 = VECTOR_INIT();
+        Exp e1;
+        e1 = sym[0];
+        list_add(interp, &d0, e1);
+        Exp e2;
+        {
+            List d3 = VECTOR_INIT();
+            Exp e4;
+            e4 = sym[1];
+            list_add(interp, &d3, e4);
+            Exp e5;
+            {
+                List d6 = VECTOR_INIT();
+                Exp e7;
+                e7 = sym[2];
+                list_add(interp, &d6, e7);
+                e5 = mklist(interp, d6);
+            }
+            list_add(interp, &d3, e5);
+            Exp e8;
+            {
+                List d9 = VECTOR_INIT();
+                Exp e10;
+                e10 = sym[3];
+                list_add(interp, &d9, e10);
+                Exp e11;
+                e11 = sym[2];
+                list_add(interp, &d9, e11);
+                Exp e12;
+                e12 = mknum(10.0);
+                list_add(interp, &d9, e12);
+                e8 = mklist(interp, d9);
+            }
+            list_add(interp, &d3, e8);
+            e2 = mklist(interp, d3);
+        }
+        list_add(interp, &d0, e2);
+        lit[0] = mklist(interp, d0);
+    }
+    interp_pin(interp, lit[0]);
+    {
+        List d13 = VECTOR_INIT();
+        Exp e14;
+        e14 = sym[4];
+        list_add(interp, &d13, e14);
+        Exp e15;
+        {
+            List d16 = VECTOR_INIT();
+            Exp e17;
+            {
+                List d18 = VECTOR_INIT();
+                Exp e19;
+                e19 = sym[5];
+                list_add(interp, &d18, e19);
+                Exp e20;
+                {
+                    List d21 = VECTOR_INIT();
+                    Exp e22;
+                    e22 = sym[1];
+                    list_add(interp, &d21, e22);
+                    Exp e23;
+                    {
+                        List d24 = VECTOR_INIT();
+                        Exp e25;
+                        e25 = sym[2];
+                        list_add(interp, &d24, e25);
+                        e23 = mklist(interp, d24);
+                    }
+                    list_add(interp, &d21, e23);
+                    Exp e26;
+                    {
+                        List d27 = VECTOR_INIT();
+                        Exp e28;
+                        e28 = sym[6];
+                        list_add(interp, &d27, e28);
+                        Exp e29;
+                        e29 = sym[2];
+                        list_add(interp, &d27, e29);
+                        Exp e30;
+                        e30 = mknum(1.0);
+                        list_add(interp, &d27, e30);
+                        e26 = mklist(interp, d27);
+                    }
+                    list_add(interp, &d21, e26);
+                    e20 = mklist(interp, d21);
+                }
+                list_add(interp, &d18, e20);
+                e17 = mklist(interp, d18);
+            }
+            list_add(interp, &d16, e17);
+            e15 = mklist(interp, d16);
+        }
+        list_add(interp, &d13, e15);
+        Exp e31;
+        {
+            List d32 = VECTOR_INIT();
+            Exp e33;
+            e33 = sym[5];
+            list_add(interp, &d32, e33);
+            Exp e34;
+            e34 = mknum(3.0);
+            list_add(interp, &d32, e34);
+            e31 = mklist(interp, d32);
+        }
+        list_add(interp, &d13, e31);
+        lit[1] = mklist(interp, d13);
+    }
+    interp_pin(interp, lit[1]);
+    {
+        List d35 = VECTOR_INIT();
+        Exp e36;
+        e36 = sym[7];
+        list_add(interp, &d35, e36);
+        Exp e37;
+        {
+            List d38 = VECTOR_INIT();
+            Exp e39;
+            {
+                List d40 = VECTOR_INIT();
+                Exp e41;
+                e41 = sym[8];
+                list_add(interp, &d40, e41);
+                Exp e42;
+                e42 = mknum(1.0);
+                list_add(interp, &d40, e42);
+                e39 = mklist(interp, d40);
+            }
+            list_add(interp, &d38, e39);
+            Exp e43;
+            {
+                List d44 = VECTOR_INIT();
+                Exp e45;
+                e45 = sym[5];
+                list_add(interp, &d44, e45);
+                Exp e46;
+                {
+                    List d47 = VECTOR_INIT();
+                    Exp e48;
+                    e48 = sym[1];
+                    list_add(interp, &d47, e48);
+                    Exp e49;
+                    {
+                        List d50 = VECTOR_INIT();
+                        Exp e51;
+                        e51 = sym[2];
+                        list_add(interp, &d50, e51);
+                        e49 = mklist(interp, d50);
+                    }
+                    list_add(interp, &d47, e49);
+                    Exp e52;
+                    {
+                        List d53 = VECTOR_INIT();
+                        Exp e54;
+                        e54 = sym[6];
+                        list_add(interp, &d53, e54);
+                        Exp e55;
+                        e55 = sym[2];
+                        list_add(interp, &d53, e55);
+                        Exp e56;
+                        e56 = sym[8];
+                        list_add(interp, &d53, e56);
+                        e52 = mklist(interp, d53);
+                    }
+                    list_add(interp, &d47, e52);
+                    e46 = mklist(interp, d47);
+                }
+                list_add(interp, &d44, e46);
+                e43 = mklist(interp, d44);
+            }
+            list_add(interp, &d38, e43);
+            e37 = mklist(interp, d38);
+        }
+        list_add(interp, &d35, e37);
+        Exp e57;
+        {
+            List d58 = VECTOR_INIT();
+            Exp e59;
+            e59 = sym[5];
+            list_add(interp, &d58, e59);
+            Exp e60;
+            e60 = mknum(3.0);
+            list_add(interp, &d58, e60);
+            e57 = mklist(interp, d58);
+        }
+        list_add(interp, &d35, e57);
+        lit[2] = mklist(interp, d35);
+    }
+    interp_pin(interp, lit[2]);
+    {
+        List d61 = VECTOR_INIT();
+        Exp e62;
+        e62 = sym[9];
+        list_add(interp, &d61, e62);
+        Exp e63;
+        {
+            List d64 = VECTOR_INIT();
+            Exp e65;
+            {
+                List d66 = VECTOR_INIT();
+                Exp e67;
+                e67 = sym[5];
+                list_add(interp, &d66, e67);
+                Exp e68;
+                {
+                    List d69 = VECTOR_INIT();
+                    Exp e70;
+                    e70 = sym[1];
+                    list_add(interp, &d69, e70);
+                    Exp e71;
+                    {
+                        List d72 = VECTOR_INIT();
+                        Exp e73;
+                        e73 = sym[2];
+                        list_add(interp, &d72, e73);
+                        e71 = mklist(interp, d72);
+                    }
+                    list_add(interp, &d69, e71);
+                    Exp e74;
+                    {
+                        List d75 = VECTOR_INIT();
+                        Exp e76;
+                        e76 = sym[10];
+                        list_add(interp, &d75, e76);
+                        Exp e77;
+                        {
+                            List d78 = VECTOR_INIT();
+                            Exp e79;
+                            e79 = sym[11];
+                            list_add(interp, &d78, e79);
+                            Exp e80;
+                            e80 = sym[2];
+                            list_add(interp, &d78, e80);
+                            Exp e81;
+                            e81 = mknum(0.0);
+                            list_add(interp, &d78, e81);
+                            e77 = mklist(interp, d78);
+                        }
+                        list_add(interp, &d75, e77);
+                        Exp e82;
+                        e82 = mknum(0.0);
+                        list_add(interp, &d75, e82);
+                        Exp e83;
+                        {
+                            List d84 = VECTOR_INIT();
+                            Exp e85;
+                            e85 = sym[5];
+                            list_add(interp, &d84, e85);
+                            Exp e86;
+                            {
+                                List d87 = VECTOR_INIT();
+                                Exp e88;
+                                e88 = sym[12];
+                                list_add(interp, &d87, e88);
+                                Exp e89;
+                                e89 = sym[2];
+                                list_add(interp, &d87, e89);
+                                Exp e90;
+                                e90 = mknum(1.0);
+                                list_add(interp, &d87, e90);
+                                e86 = mklist(interp, d87);
+                            }
+                            list_add(interp, &d84, e86);
+                            e83 = mklist(interp, d84);
+                        }
+                        list_add(interp, &d75, e83);
+                        e74 = mklist(interp, d75);
+                    }
+                    list_add(interp, &d69, e74);
+                    e68 = mklist(interp, d69);
+                }
+                list_add(interp, &d66, e68);
+                e65 = mklist(interp, d66);
+            }
+            list_add(interp, &d64, e65);
+            e63 = mklist(interp, d64);
+        }
+        list_add(interp, &d61, e63);
+        Exp e91;
+        {
+            List d92 = VECTOR_INIT();
+            Exp e93;
+            e93 = sym[5];
+            list_add(interp, &d92, e93);
+            Exp e94;
+            e94 = mknum(3.0);
+            list_add(interp, &d92, e94);
+            e91 = mklist(interp, d92);
+        }
+        list_add(interp, &d61, e91);
+        lit[3] = mklist(interp, d61);
+    }
+    interp_pin(interp, lit[3]);
+    lit[4] = sym[13];
+    interp_pin(interp, lit[4]);
+    {
+        List d95 = VECTOR_INIT();
+        Exp e96;
+        e96 = sym[14];
+        list_add(interp, &d95, e96);
+        Exp e97;
+        {
+            List d98 = VECTOR_INIT();
+            Exp e99;
+            {
+                List d100 = VECTOR_INIT();
+                Exp e101;
+                e101 = sym[5];
+                list_add(interp, &d100, e101);
+                Exp e102;
+                {
+                    List d103 = VECTOR_INIT();
+                    Exp e104;
+                    e104 = sym[1];
+                    list_add(interp, &d103, e104);
+                    Exp e105;
+                    {
+                        List d106 = VECTOR_INIT();
+                        Exp e107;
+                        e107 = sym[2];
+                        list_add(interp, &d106, e107);
+                        e105 = mklist(interp, d106);
+                    }
+                    list_add(interp, &d103, e105);
+                    Exp e108;
+                    {
+                        List d109 = VECTOR_INIT();
+                        Exp e110;
+                        e110 = sym[3];
+                        list_add(interp, &d109, e110);
+                        Exp e111;
+                        e111 = sym[2];
+                        list_add(interp, &d109, e111);
+                        Exp e112;
+                        e112 = mknum(2.0);
+                        list_add(interp, &d109, e112);
+                        e108 = mklist(interp, d109);
+                    }
+                    list_add(interp, &d103, e108);
+                    e102 = mklist(interp, d103);
+                }
+                list_add(interp, &d100, e102);
+                e99 = mklist(interp, d100);
+            }
+            list_add(interp, &d98, e99);
+            Exp e113;
+            {
+                List d114 = VECTOR_INIT();
+                Exp e115;
+                e115 = sym[15];
+                list_add(interp, &d114, e115);
+                Exp e116;
+                e116 = mknum(0.0);
+                list_add(interp, &d114, e116);
+                Exp e117;
+                {
+                    List d118 = VECTOR_INIT();
+                    Exp e119;
+                    e119 = sym[6];
+                    list_add(interp, &d118, e119);
+                    Exp e120;
+                    e120 = sym[15];
+                    list_add(interp, &d118, e120);
+                    Exp e121;
+                    e121 = mknum(1.0);
+                    list_add(interp, &d118, e121);
+                    e117 = mklist(interp, d118);
+                }
+                list_add(interp, &d114, e117);
+                e113 = mklist(interp, d114);
+            }
+            list_add(interp, &d98, e113);
+            e97 = mklist(interp, d98);
+        }
+        list_add(interp, &d95, e97);
+        Exp e122;
+        {
+            List d123 = VECTOR_INIT();
+            Exp e124;
+            {
+                List d125 = VECTOR_INIT();
+                Exp e126;
+                e126 = sym[11];
+                list_add(interp, &d125, e126);
+                Exp e127;
+                e127 = sym[15];
+                list_add(interp, &d125, e127);
+                Exp e128;
+                e128 = mknum(1.0);
+                list_add(interp, &d125, e128);
+                e124 = mklist(interp, d125);
+            }
+            list_add(interp, &d123, e124);
+            Exp e129;
+            {
+                List d130 = VECTOR_INIT();
+                Exp e131;
+                e131 = sym[5];
+                list_add(interp, &d130, e131);
+                Exp e132;
+                e132 = mknum(4.0);
+                list_add(interp, &d130, e132);
+                e129 = mklist(interp, d130);
+            }
+            list_add(interp, &d123, e129);
+            e122 = mklist(interp, d123);
+        }
+        list_add(interp, &d95, e122);
+        lit[5] = mklist(interp, d95);
+    }
+    interp_pin(interp, lit[5]);
+    {
+        List d133 = VECTOR_INIT();
+        Exp e134;
+        e134 = sym[4];
+        list_add(interp, &d133, e134);
+        Exp e135;
+        {
+            List d136 = VECTOR_INIT();
+            e135 = mklist(interp, d136);
+        }
+        list_add(interp, &d133, e135);
+        Exp e137;
+        {
+            List d138 = VECTOR_INIT();
+            Exp e139;
+            e139 = sym[16];
+            list_add(interp, &d138, e139);
+            Exp e140;
+            e140 = sym[5];
+            list_add(interp, &d138, e140);
+            Exp e141;
+            {
+                List d142 = VECTOR_INIT();
+                Exp e143;
+                e143 = sym[1];
+                list_add(interp, &d142, e143);
+                Exp e144;
+                {
+                    List d145 = VECTOR_INIT();
+                    Exp e146;
+                    e146 = sym[2];
+                    list_add(interp, &d145, e146);
+                    e144 = mklist(interp, d145);
+                }
+                list_add(interp, &d142, e144);
+                Exp e147;
+                {
+                    List d148 = VECTOR_INIT();
+                    Exp e149;
+                    e149 = sym[12];
+                    list_add(interp, &d148, e149);
+                    Exp e150;
+                    e150 = sym[2];
+                    list_add(interp, &d148, e150);
+                    e147 = mklist(interp, d148);
+                }
+                list_add(interp, &d142, e147);
+                e141 = mklist(interp, d142);
+            }
+            list_add(interp, &d138, e141);
+            e137 = mklist(interp, d138);
+        }
+        list_add(interp, &d133, e137);
+        Exp e151;
+        {
+            List d152 = VECTOR_INIT();
+            Exp e153;
+            e153 = sym[5];
+            list_add(interp, &d152, e153);
+            Exp e154;
+            e154 = mknum(5.0);
+            list_add(interp, &d152, e154);
+            e151 = mklist(interp, d152);
+        }
+        list_add(interp, &d133, e151);
+        lit[6] = mklist(interp, d133);
+    }
+    interp_pin(interp, lit[6]);
+}
+
+static void run(Interp *interp)
+{
+    stack_enter(interp);
+    // (define f (lambda (my-or) (my-or 3)))
+    defined[0] = true;
+    interp_define(interp, "f", mkcproc(proc_0_entry));
+    // (f (lambda (x) (* x 10)))
+    eval_form(interp, lit[0]);
+    // (let ((my-or (lambda (x) (+ x 1)))) (my-or 3))
+    eval_form(interp, lit[1]);
+    // (let* ((a 1) (my-or (lambda (x) (+ x a)))) (my-or 3))
+    eval_form(interp, lit[2]);
+    // (letrec ((my-or (lambda (x) (if (= x 0) 0 (my-or (- x 1)))))) (my-or 3))
+    eval_form(interp, lit[3]);
+    // (let loop ((my-or 2)) (if (= my-or 0) (quote done) (loop (- my-or 1))))
+    gc_maybe_collect(interp);
+    {
+        double l2 = 2.0;
+        Exp v6;
+        loop0:;
+        double v3 = (double) (l2 == 0.0);
+        Exp v5;
+        if (v3 != 0) {
+            v5 = lit[4];
+        } else {
+            double v4 = (l2 - 1.0);
+            l2 = v4;
+            goto loop0;
+        }
+        v6 = v5;
+        show(interp, v6);
+    }
+    // (do ((my-or (lambda (x) (* x 2))) (i 0 (+ i 1))) ((= i 1) (my-or 4)))
+    eval_form(interp, lit[5]);
+    // (let () (define my-or (lambda (x) (- x))) (my-or 5))
+    eval_form(interp, lit[6]);
+    // (let ((x 7)) x)
+    gc_maybe_collect(interp);
+    {
+        double l0 = 7.0;
+        show(interp, mknum(l0));
+    }
+}
+
+int main(void)
+{
+    Interp *interp = interp_new();
+    // forms left to the interpreter were optimized when compiled
+    interp->optimize = false;
+    init(interp);
+    run(interp);
+    interp_free(interp);
+    return 0;
+}
@@ -0,0 +1,381 @@
+// Compiled from bench/nqueens.scm by scheme -c.
+
+#include "scheme.h"
+#include "gcobject.h"
+#include "ht.h"
+
+#define VOID_EXP ((Exp) { .type = EXP_VOID })
+
+static inline noreturn void undefined(Interp *interp, Exp name)
+{
+    die(interp, "undefined symbol: %s\n", AS_SYM(name));
+}
+
+static inline Exp global_ref(Interp *interp, Exp name)
+{
+    Exp value;
+    if (!ht_lookup(&ENV_HT(interp->global), name, &value)) {
+        undefined(interp, name);
+    }
+    return value;
+}
+
+// Raise a stack overflow past the limit run() set, as proc_call does.
+static inline void check_stack(Interp *interp)
+{
+    if ((uintptr_t) __builtin_frame_address(0) < interp->stack_limit) {
+        stack_overflow(interp);
+    }
+}
+
+static inline Exp proc_ref(Interp *interp, Exp proc)
+{
+    if (!is_proc(proc)) {
+        die(interp, "error: not a procedure\n");
+    }
+    return proc;
+}
+
+static inline Exp call(Interp *interp, Exp proc, List args)
+{
+    return proc.type == EXP_C_PROC ? proc.cproc(interp, args)
+                                   : proc_call(interp, &AS_PROC(proc), args);
+}
+
+// Print the value of a top-level form.
+static inline void show(Interp *interp, Exp val)
+{
+    print_to(interp->out, val);
+    if (val.type != EXP_VOID && val.type != EXP_EMPTY) {
+        writer_putc(interp->out, '\n');
+    }
+}
+
+// Run a form the compiler left to the interpreter.
+static inline void eval_form(Interp *interp, Exp form)
+{
+    Exp val = interp_eval(interp, form);
+    show(interp, val);
+    interp_unpin(interp, val);
+}
+
+static Exp sym[11];
+static Exp lit[8];
+static CProc prim[7];
+static bool defined[4];
+
+static Exp proc_0(Interp *interp, Exp p0);
+static Exp proc_1(Interp *interp, Exp p0, Exp p1, Exp p2);
+static Exp proc_2(Interp *interp, Exp p0, Exp p1, Exp p2);
+static Exp proc_3(Interp *interp, Exp p0);
+
+// one-to
+static Exp proc_0(Interp *interp, Exp p0)
+{
+    check_stack(interp);
+    Exp a2_data[] = { p0, mknum(0.0) };
+    List a2 = { .data = a2_data, .size = 2, .cap = 2 };
+    double v3 = scheme_eq(interp, a2).number;
+    Exp v9;
+    if (v3 != 0) {
+        v9 = lit[4];
+    } else {
+        Exp a4_data[] = { p0, mknum(1.0) };
+        List a4 = { .data = a4_data, .size = 2, .cap = 2 };
+        double v5 = scheme_sub(interp, a4).number;
+        Exp v6 = proc_0(interp, mknum(v5));
+        Exp a7_data[] = { p0, v6 };
+        List a7 = { .data = a7_data, .size = 2, .cap = 2 };
+        Exp v8 = prim[0](interp, a7);
+        v9 = v8;
+    }
+    return v9;
+}
+
+static Exp proc_0_entry(Interp *interp, List args)
+{
+    if (args.size != 1) {
+        die(interp, "%s: arity mismatch\n", "one-to");
+    }
+    return proc_0(interp, args.data[0]);
+}
+
+// ok?
+static Exp proc_1(Interp *interp, Exp p0, Exp p1, Exp p2)
+{
+    check_stack(interp);
+top:;
+    Exp a4_data[] = { p2 };
+    List a4 = { .data = a4_data, .size = 1, .cap = 1 };
+    Exp v5 = prim[1](interp, a4);
+    double v25;
+    if (is_true(v5)) {
+        v25 = 1.0;
+    } else {
+        Exp a6_data[] = { p2 };
+        List a6 = { .data = a6_data, .size = 1, .cap = 1 };
+        Exp v7 = prim[2](interp, a6);
+        Exp a8_data[] = { p0, p1 };
+        List a8 = { .data = a8_data, .size = 2, .cap = 2 };
+        double v9 = scheme_sum(interp, a8).number;
+        Exp a10_data[] = { v7, mknum(v9) };
+        List a10 = { .data = a10_data, .size = 2, .cap = 2 };
+        double v11 = scheme_eq(interp, a10).number;
+        double v24;
+        if (v11 != 0) {
+            v24 = 0.0;
+        } else {
+            Exp a12_data[] = { p2 };
+            List a12 = { .data = a12_data, .size = 1, .cap = 1 };
+            Exp v13 = prim[2](interp, a12);
+            Exp a14_data[] = { p0, p1 };
+            List a14 = { .data = a14_data, .size = 2, .cap = 2 };
+            double v15 = scheme_sub(interp, a14).number;
+            Exp a16_data[] = { v13, mknum(v15) };
+            List a16 = { .data = a16_data, .size = 2, .cap = 2 };
+            double v17 = scheme_eq(interp, a16).number;
+            double v23;
+            if (v17 != 0) {
+                v23 = 0.0;
+            } else {
+                Exp a18_data[] = { p1, mknum(1.0) };
+                List a18 = { .data = a18_data, .size = 2, .cap = 2 };
+                double v19 = scheme_sum(interp, a18).number;
+                Exp a20_data[] = { p2 };
+                List a20 = { .data = a20_data, .size = 1, .cap = 1 };
+                Exp v21 = prim[3](interp, a20);
+                Exp v22 = p0;
+                p0 = v22;
+                p1 = mknum(v19);
+                p2 = v21;
+                goto top;
+            }
+            v24 = v23;
+        }
+        v25 = v24;
+    }
+    return mknum(v25);
+}
+
+static Exp proc_1_entry(Interp *interp, List args)
+{
+    if (args.size != 3) {
+        die(interp, "%s: arity mismatch\n", "ok\?");
+    }
+    return proc_1(interp, args.data[0], args.data[1], args.data[2]);
+}
+
+// try-it
+static Exp proc_2(Interp *interp, Exp p0, Exp p1, Exp p2)
+{
+    check_stack(interp);
+    Exp a4_data[] = { p0 };
+    List a4 = { .data = a4_data, .size = 1, .cap = 1 };
+    Exp v5 = prim[1](interp, a4);
+    double v31;
+    if (is_true(v5)) {
+        Exp a6_data[] = { p1 };
+        List a6 = { .data = a6_data, .size = 1, .cap = 1 };
+        Exp v7 = prim[1](interp, a6);
+        double v8;
+        if (is_true(v7)) {
+            v8 = 1.0;
+        } else {
+            v8 = 0.0;
+        }
+        v31 = v8;
+    } else {
+        Exp a9_data[] = { p0 };
+        List a9 = { .data = a9_data, .size = 1, .cap = 1 };
+        Exp v10 = prim[2](interp, a9);
+        if (!defined[1]) {
+            undefined(interp, sym[0]);
+        }
+        Exp v11 = proc_1(interp, v10, mknum(1.0), p2);
+        Exp v21;
+        if (is_true(v11)) {
+            Exp a12_data[] = { p0 };
+            List a12 = { .data = a12_data, .size = 1, .cap = 1 };
+            Exp v13 = prim[3](interp, a12);
+            Exp a14_data[] = { v13, p1 };
+            List a14 = { .data = a14_data, .size = 2, .cap = 2 };
+            Exp v15 = prim[4](interp, a14);
+            Exp a16_data[] = { p0 };
+            List a16 = { .data = a16_data, .size = 1, .cap = 1 };
+            Exp v17 = prim[2](interp, a16);
+            Exp a18_data[] = { v17, p2 };
+            List a18 = { .data = a18_data, .size = 2, .cap = 2 };
+            Exp v19 = prim[0](interp, a18);
+            Exp v20 = proc_2(interp, v15, lit[5], v19);
+            v21 = v20;
+        } else {
+            v21 = mknum(0.0);
+        }
+        Exp a22_data[] = { p0 };
+        List a22 = { .data = a22_data, .size = 1, .cap = 1 };
+        Exp v23 = prim[3](interp, a22);
+        Exp a24_data[] = { p0 };
+        List a24 = { .data = a24_data, .size = 1, .cap = 1 };
+        Exp v25 = prim[2](interp, a24);
+        Exp a26_data[] = { v25, p1 };
+        List a26 = { .data = a26_data, .size = 2, .cap = 2 };
+        Exp v27 = prim[0](interp, a26);
+        Exp v28 = proc_2(interp, v23, v27, p2);
+        Exp a29_data[] = { v21, v28 };
+        List a29 = { .data = a29_data, .size = 2, .cap = 2 };
+        double v30 = scheme_sum(interp, a29).number;
+        v31 = v30;
+    }
+    return mknum(v31);
+}
+
+static Exp proc_2_entry(Interp *interp, List args)
+{
+    if (args.size != 3) {
+        die(interp, "%s: arity mismatch\n", "try-it");
+    }
+    return proc_2(interp, args.data[0], args.data[1], args.data[2]);
+}
+
+// queens
+static Exp proc_3(Interp *interp, Exp p0)
+{
+    check_stack(interp);
+    if (!defined[0]) {
+        undefined(interp, sym[1]);
+    }
+    Exp v2 = proc_0(interp, p0);
+    if (!defined[2]) {
+        undefined(interp, sym[2]);
+    }
+    Exp v3 = proc_2(interp, v2, lit[6], lit[7]);
+    return v3;
+}
+
+static Exp proc_3_entry(Interp *interp, List args)
+{
+    if (args.size != 1) {
+        die(interp, "%s: arity mismatch\n", "queens");
+    }
+    return proc_3(interp, args.data[0]);
+}
+
+static void init(Interp *interp)
+{
+    sym[0] = interp_symbol(interp, "ok\?");
+    interp_pin(interp, sym[0]);
+    sym[1] = interp_symbol(interp, "one-to");
+    interp_pin(interp, sym[1]);
+    sym[2] = interp_symbol(interp, "try-it");
+    interp_pin(interp, sym[2]);
+    sym[3] = interp_symbol(interp, "queens");
+    interp_pin(interp, sym[3]);
+    sym[4] = interp_symbol(interp, "cons");
+    interp_pin(interp, sym[4]);
+    sym[5] = interp_symbol(interp, "null\?");
+    interp_pin(interp, sym[5]);
+    sym[6] = interp_symbol(interp, "car");
+    interp_pin(interp, sym[6]);
+    sym[7] = interp_symbol(interp, "cdr");
+    interp_pin(interp, sym[7]);
+    sym[8] = interp_symbol(interp, "append");
+    interp_pin(interp, sym[8]);
+    sym[9] = interp_symbol(interp, "display");
+    interp_pin(interp, sym[9]);
+    sym[10] = interp_symbol(interp, "newline");
+    interp_pin(interp, sym[10]);
+    {
+        List d0 = VECTOR_INIT();
+        lit[0] = mklist(interp, d0);
+    }
+    interp_pin(interp, lit[0]);
+    {
+        List d1 = VECTOR_INIT();
+        lit[1] = mklist(interp, d1);
+    }
+    interp_pin(interp, lit[1]);
+    {
+        List d2 = VECTOR_INIT();
+        lit[2] = mklist(interp, d2);
+    }
+    interp_pin(interp, lit[2]);
+    {
+        List d3 = VECTOR_INIT();
+        lit[3] = mklist(interp, d3);
+    }
+    interp_pin(interp, lit[3]);
+    {
+        List d4 = VECTOR_INIT();
+        lit[4] = mklist(interp, d4);
+    }
+    interp_pin(interp, lit[4]);
+    {
+        List d5 = VECTOR_INIT();
+        lit[5] = mklist(interp, d5);
+    }
+    interp_pin(interp, lit[5]);
+    {
+        List d6 = VECTOR_INIT();
+        lit[6] = mklist(interp, d6);
+    }
+    interp_pin(interp, lit[6]);
+    {
+        List d7 = VECTOR_INIT();
+        lit[7] = mklist(interp, d7);
+    }
+    interp_pin(interp, lit[7]);
+    prim[0] = global_ref(interp, sym[4]).cproc;
+    prim[1] = global_ref(interp, sym[5]).cproc;
+    prim[2] = global_ref(interp, sym[6]).cproc;
+    prim[3] = global_ref(interp, sym[7]).cproc;
+    prim[4] = global_ref(interp, sym[8]).cproc;
+    prim[5] = global_ref(interp, sym[9]).cproc;
+    prim[6] = global_ref(interp, sym[10]).cproc;
+}
+
+static void run(Interp *interp)
+{
+    stack_enter(interp);
+    // (define one-to (lambda (n) (if (= n 0) (quote ()) (cons n (one-to (- n 1 ...
+    defined[0] = true;
+    interp_define(interp, "one-to", mkcproc(proc_0_entry));
+    // (define ok  (lambda (row dist placed) (if (null  placed) 1 (if (= (car p ...
+    defined[1] = true;
+    interp_define(interp, "ok\?", mkcproc(proc_1_entry));
+    // (define try-it (lambda (x y z) (if (null  x) (if (null  y) 1 0) (+ (if ( ...
+    defined[2] = true;
+    interp_define(interp, "try-it", mkcproc(proc_2_entry));
+    // (define queens (lambda (n) (try-it (one-to n) (quote ()) (quote ()))))
+    defined[3] = true;
+    interp_define(interp, "queens", mkcproc(proc_3_entry));
+    // (display (queens 8))
+    gc_maybe_collect(interp);
+    {
+        if (!defined[3]) {
+            undefined(interp, sym[3]);
+        }
+        Exp v0 = proc_3(interp, mknum(8.0));
+        Exp a1_data[] = { v0 };
+        List a1 = { .data = a1_data, .size = 1, .cap = 1 };
+        Exp v2 = prim[5](interp, a1);
+        show(interp, v2);
+    }
+    // (newline)
+    gc_maybe_collect(interp);
+    {
+        List a0 = VECTOR_INIT();
+        Exp v1 = prim[6](interp, a0);
+        show(interp, v1);
+    }
+}
+
+int main(void)
+{
+    Interp *interp = interp_new();
+    // forms left to the interpreter were optimized when compiled
+    interp->optimize = false;
+    init(interp);
+    run(interp);
+    interp_free(interp);
+    return 0;
+}
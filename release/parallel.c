@@ -0,0 +1,689 @@
+// Compiled from tests/parallel.scm by scheme -c.
+
+#include "scheme.h"
+#include "gcobject.h"
+#include "ht.h"
+
+#define VOID_EXP ((Exp) { .type = EXP_VOID })
+
+static inline noreturn void undefined(Interp *interp, Exp name)
+{
+    die(interp, "undefined symbol: %s\n", AS_SYM(name));
+}
+
+static inline Exp global_ref(Interp *interp, Exp name)
+{
+    Exp value;
+    if (!ht_lookup(&ENV_HT(interp->global), name, &value)) {
+        undefined(interp, name);
+    }
+    return value;
+}
+
+// Raise a stack overflow past the limit run() set, as proc_call does.
+static inline void check_stack(Interp *interp)
+{
+    if ((uintptr_t) __builtin_frame_address(0) < interp->stack_limit) {
+        stack_overflow(interp);
+    }
+}
+
+static inline Exp proc_ref(Interp *interp, Exp proc)
+{
+    if (!is_proc(proc)) {
+        die(interp, "error: not a procedure\n");
+    }
+    return proc;
+}
+
+static inline Exp call(Interp *interp, Exp proc, List args)
+{
+    return proc.type == EXP_C_PROC ? proc.cproc(interp, args)
+                                   : proc_call(interp, &AS_PROC(proc), args);
+}
+
+// Print the value of a top-level form.
+static inline void show(Interp *interp, Exp val)
+{
+    print_to(interp->out, val);
+    if (val.type != EXP_VOID && val.type != EXP_EMPTY) {
+        writer_putc(interp->out, '\n');
+    }
+}
+
+// Run a form the compiler left to the interpreter.
+static inline void eval_form(Interp *interp, Exp form)
+{
+    Exp val = interp_eval(interp, form);
+    show(interp, val);
+    interp_unpin(interp, val);
+}
+
+static Exp sym[25];
+static Exp lit[8];
+static CProc prim[5];
+
+
+static void init(Interp *interp)
+{
+    sym[0] = interp_symbol(interp, "v");
+    interp_pin(interp, sym[0]);
+    sym[1] = interp_symbol(interp, "total");
+    interp_pin(interp, sym[1]);
+    sym[2] = interp_symbol(interp, "w");
+    interp_pin(interp, sym[2]);
+    sym[3] = interp_symbol(interp, "parallel-for-each");
+    interp_pin(interp, sym[3]);
+    sym[4] = interp_symbol(interp, "lambda");
+    interp_pin(interp, sym[4]);
+    sym[5] = interp_symbol(interp, "i");
+    interp_pin(interp, sym[5]);
+    sym[6] = interp_symbol(interp, "vector-set!");
+    interp_pin(interp, sym[6]);
+    sym[7] = interp_symbol(interp, "list");
+    interp_pin(interp, sym[7]);
+    sym[8] = interp_symbol(interp, "x");
+    interp_pin(interp, sym[8]);
+    sym[9] = interp_symbol(interp, "set!");
+    interp_pin(interp, sym[9]);
+    sym[10] = interp_symbol(interp, "+");
+    interp_pin(interp, sym[10]);
+    sym[11] = interp_symbol(interp, "display");
+    interp_pin(interp, sym[11]);
+    sym[12] = interp_symbol(interp, "touch");
+    interp_pin(interp, sym[12]);
+    sym[13] = interp_symbol(interp, "future");
+    interp_pin(interp, sym[13]);
+    sym[14] = interp_symbol(interp, "begin");
+    interp_pin(interp, sym[14]);
+    sym[15] = interp_symbol(interp, "vector-ref");
+    interp_pin(interp, sym[15]);
+    sym[16] = interp_symbol(interp, "guard");
+    interp_pin(interp, sym[16]);
+    sym[17] = interp_symbol(interp, "e");
+    interp_pin(interp, sym[17]);
+    sym[18] = interp_symbol(interp, "quote");
+    interp_pin(interp, sym[18]);
+    sym[19] = interp_symbol(interp, "failed");
+    interp_pin(interp, sym[19]);
+    sym[20] = interp_symbol(interp, "car");
+    interp_pin(interp, sym[20]);
+    sym[21] = interp_symbol(interp, "parallel-map");
+    interp_pin(interp, sym[21]);
+    sym[22] = interp_symbol(interp, "*");
+    interp_pin(interp, sym[22]);
+    sym[23] = interp_symbol(interp, "make-vector");
+    interp_pin(interp, sym[23]);
+    sym[24] = interp_symbol(interp, "newline");
+    interp_pin(interp, sym[24]);
+    {
+        List d0 = VECTOR_INIT();
+        Exp e1;
+        e1 = sym[3];
+        list_add(interp, &d0, e1);
+        Exp e2;
+        {
+            List d3 = VECTOR_INIT();
+            Exp e4;
+            e4 = sym[4];
+            list_add(interp, &d3, e4);
+            Exp e5;
+            {
+                List d6 = VECTOR_INIT();
+                Exp e7;
+                e7 = sym[5];
+                list_add(interp, &d6, e7);
+                e5 = mklist(interp, d6);
+            }
+            list_add(interp, &d3, e5);
+            Exp e8;
+            {
+                List d9 = VECTOR_INIT();
+                Exp e10;
+                e10 = sym[6];
+                list_add(interp, &d9, e10);
+                Exp e11;
+                e11 = sym[0];
+                list_add(interp, &d9, e11);
+                Exp e12;
+                e12 = sym[5];
+                list_add(interp, &d9, e12);
+                Exp e13;
+                e13 = mknum(1.0);
+                list_add(interp, &d9, e13);
+                e8 = mklist(interp, d9);
+            }
+            list_add(interp, &d3, e8);
+            e2 = mklist(interp, d3);
+        }
+        list_add(interp, &d0, e2);
+        Exp e14;
+        {
+            List d15 = VECTOR_INIT();
+            Exp e16;
+            e16 = sym[7];
+            list_add(interp, &d15, e16);
+            Exp e17;
+            e17 = mknum(0.0);
+            list_add(interp, &d15, e17);
+            Exp e18;
+            e18 = mknum(1.0);
+            list_add(interp, &d15, e18);
+            Exp e19;
+            e19 = mknum(2.0);
+            list_add(interp, &d15, e19);
+            Exp e20;
+            e20 = mknum(3.0);
+            list_add(interp, &d15, e20);
+            e14 = mklist(interp, d15);
+        }
+        list_add(interp, &d0, e14);
+        lit[0] = mklist(interp, d0);
+    }
+    interp_pin(interp, lit[0]);
+    {
+        List d21 = VECTOR_INIT();
+        Exp e22;
+        e22 = sym[3];
+        list_add(interp, &d21, e22);
+        Exp e23;
+        {
+            List d24 = VECTOR_INIT();
+            Exp e25;
+            e25 = sym[4];
+            list_add(interp, &d24, e25);
+            Exp e26;
+            {
+                List d27 = VECTOR_INIT();
+                Exp e28;
+                e28 = sym[8];
+                list_add(interp, &d27, e28);
+                e26 = mklist(interp, d27);
+            }
+            list_add(interp, &d24, e26);
+            Exp e29;
+            {
+                List d30 = VECTOR_INIT();
+                Exp e31;
+                e31 = sym[9];
+                list_add(interp, &d30, e31);
+                Exp e32;
+                e32 = sym[1];
+                list_add(interp, &d30, e32);
+                Exp e33;
+                {
+                    List d34 = VECTOR_INIT();
+                    Exp e35;
+                    e35 = sym[10];
+                    list_add(interp, &d34, e35);
+                    Exp e36;
+                    e36 = sym[1];
+                    list_add(interp, &d34, e36);
+                    Exp e37;
+                    e37 = sym[8];
+                    list_add(interp, &d34, e37);
+                    e33 = mklist(interp, d34);
+                }
+                list_add(interp, &d30, e33);
+                e29 = mklist(interp, d30);
+            }
+            list_add(interp, &d24, e29);
+            e23 = mklist(interp, d24);
+        }
+        list_add(interp, &d21, e23);
+        Exp e38;
+        {
+            List d39 = VECTOR_INIT();
+            Exp e40;
+            e40 = sym[7];
+            list_add(interp, &d39, e40);
+            Exp e41;
+            e41 = mknum(1.0);
+            list_add(interp, &d39, e41);
+            Exp e42;
+            e42 = mknum(2.0);
+            list_add(interp, &d39, e42);
+            Exp e43;
+            e43 = mknum(3.0);
+            list_add(interp, &d39, e43);
+            e38 = mklist(interp, d39);
+        }
+        list_add(interp, &d21, e38);
+        lit[1] = mklist(interp, d21);
+    }
+    interp_pin(interp, lit[1]);
+    {
+        List d44 = VECTOR_INIT();
+        Exp e45;
+        e45 = sym[3];
+        list_add(interp, &d44, e45);
+        Exp e46;
+        {
+            List d47 = VECTOR_INIT();
+            Exp e48;
+            e48 = sym[4];
+            list_add(interp, &d47, e48);
+            Exp e49;
+            {
+                List d50 = VECTOR_INIT();
+                Exp e51;
+                e51 = sym[8];
+                list_add(interp, &d50, e51);
+                e49 = mklist(interp, d50);
+            }
+            list_add(interp, &d47, e49);
+            Exp e52;
+            {
+                List d53 = VECTOR_INIT();
+                Exp e54;
+                e54 = sym[11];
+                list_add(interp, &d53, e54);
+                Exp e55;
+                e55 = sym[8];
+                list_add(interp, &d53, e55);
+                e52 = mklist(interp, d53);
+            }
+            list_add(interp, &d47, e52);
+            e46 = mklist(interp, d47);
+        }
+        list_add(interp, &d44, e46);
+        Exp e56;
+        {
+            List d57 = VECTOR_INIT();
+            Exp e58;
+            e58 = sym[7];
+            list_add(interp, &d57, e58);
+            Exp e59;
+            e59 = mknum(1.0);
+            list_add(interp, &d57, e59);
+            Exp e60;
+            e60 = mknum(2.0);
+            list_add(interp, &d57, e60);
+            Exp e61;
+            e61 = mknum(3.0);
+            list_add(interp, &d57, e61);
+            e56 = mklist(interp, d57);
+        }
+        list_add(interp, &d44, e56);
+        lit[2] = mklist(interp, d44);
+    }
+    interp_pin(interp, lit[2]);
+    {
+        List d62 = VECTOR_INIT();
+        Exp e63;
+        e63 = sym[12];
+        list_add(interp, &d62, e63);
+        Exp e64;
+        {
+            List d65 = VECTOR_INIT();
+            Exp e66;
+            e66 = sym[13];
+            list_add(interp, &d65, e66);
+            Exp e67;
+            {
+                List d68 = VECTOR_INIT();
+                Exp e69;
+                e69 = sym[14];
+                list_add(interp, &d68, e69);
+                Exp e70;
+                {
+                    List d71 = VECTOR_INIT();
+                    Exp e72;
+                    e72 = sym[6];
+                    list_add(interp, &d71, e72);
+                    Exp e73;
+                    e73 = sym[2];
+                    list_add(interp, &d71, e73);
+                    Exp e74;
+                    e74 = mknum(0.0);
+                    list_add(interp, &d71, e74);
+                    Exp e75;
+                    e75 = mknum(5.0);
+                    list_add(interp, &d71, e75);
+                    e70 = mklist(interp, d71);
+                }
+                list_add(interp, &d68, e70);
+                Exp e76;
+                {
+                    List d77 = VECTOR_INIT();
+                    Exp e78;
+                    e78 = sym[15];
+                    list_add(interp, &d77, e78);
+                    Exp e79;
+                    e79 = sym[2];
+                    list_add(interp, &d77, e79);
+                    Exp e80;
+                    e80 = mknum(0.0);
+                    list_add(interp, &d77, e80);
+                    e76 = mklist(interp, d77);
+                }
+                list_add(interp, &d68, e76);
+                e67 = mklist(interp, d68);
+            }
+            list_add(interp, &d65, e67);
+            e64 = mklist(interp, d65);
+        }
+        list_add(interp, &d62, e64);
+        lit[3] = mklist(interp, d62);
+    }
+    interp_pin(interp, lit[3]);
+    {
+        List d81 = VECTOR_INIT();
+        Exp e82;
+        e82 = sym[16];
+        list_add(interp, &d81, e82);
+        Exp e83;
+        {
+            List d84 = VECTOR_INIT();
+            Exp e85;
+            e85 = sym[17];
+            list_add(interp, &d84, e85);
+            Exp e86;
+            {
+                List d87 = VECTOR_INIT();
+                Exp e88;
+                e88 = mknum(1.0);
+                list_add(interp, &d87, e88);
+                Exp e89;
+                {
+                    List d90 = VECTOR_INIT();
+                    Exp e91;
+                    e91 = sym[18];
+                    list_add(interp, &d90, e91);
+                    Exp e92;
+                    e92 = sym[19];
+                    list_add(interp, &d90, e92);
+                    e89 = mklist(interp, d90);
+                }
+                list_add(interp, &d87, e89);
+                e86 = mklist(interp, d87);
+            }
+            list_add(interp, &d84, e86);
+            e83 = mklist(interp, d84);
+        }
+        list_add(interp, &d81, e83);
+        Exp e93;
+        {
+            List d94 = VECTOR_INIT();
+            Exp e95;
+            e95 = sym[12];
+            list_add(interp, &d94, e95);
+            Exp e96;
+            {
+                List d97 = VECTOR_INIT();
+                Exp e98;
+                e98 = sym[13];
+                list_add(interp, &d97, e98);
+                Exp e99;
+                {
+                    List d100 = VECTOR_INIT();
+                    Exp e101;
+                    e101 = sym[20];
+                    list_add(interp, &d100, e101);
+                    Exp e102;
+                    e102 = mknum(1.0);
+                    list_add(interp, &d100, e102);
+                    e99 = mklist(interp, d100);
+                }
+                list_add(interp, &d97, e99);
+                e96 = mklist(interp, d97);
+            }
+            list_add(interp, &d94, e96);
+            e93 = mklist(interp, d94);
+        }
+        list_add(interp, &d81, e93);
+        lit[4] = mklist(interp, d81);
+    }
+    interp_pin(interp, lit[4]);
+    {
+        List d103 = VECTOR_INIT();
+        Exp e104;
+        e104 = sym[21];
+        list_add(interp, &d103, e104);
+        Exp e105;
+        {
+            List d106 = VECTOR_INIT();
+            Exp e107;
+            e107 = sym[4];
+            list_add(interp, &d106, e107);
+            Exp e108;
+            {
+                List d109 = VECTOR_INIT();
+                Exp e110;
+                e110 = sym[8];
+                list_add(interp, &d109, e110);
+                e108 = mklist(interp, d109);
+            }
+            list_add(interp, &d106, e108);
+            Exp e111;
+            {
+                List d112 = VECTOR_INIT();
+                Exp e113;
+                e113 = sym[12];
+                list_add(interp, &d112, e113);
+                Exp e114;
+                {
+                    List d115 = VECTOR_INIT();
+                    Exp e116;
+                    e116 = sym[13];
+                    list_add(interp, &d115, e116);
+                    Exp e117;
+                    {
+                        List d118 = VECTOR_INIT();
+                        Exp e119;
+                        e119 = sym[22];
+                        list_add(interp, &d118, e119);
+                        Exp e120;
+                        e120 = sym[8];
+                        list_add(interp, &d118, e120);
+                        Exp e121;
+                        e121 = mknum(10.0);
+                        list_add(interp, &d118, e121);
+                        e117 = mklist(interp, d118);
+                    }
+                    list_add(interp, &d115, e117);
+                    e114 = mklist(interp, d115);
+                }
+                list_add(interp, &d112, e114);
+                e111 = mklist(interp, d112);
+            }
+            list_add(interp, &d106, e111);
+            e105 = mklist(interp, d106);
+        }
+        list_add(interp, &d103, e105);
+        Exp e122;
+        {
+            List d123 = VECTOR_INIT();
+            Exp e124;
+            e124 = sym[7];
+            list_add(interp, &d123, e124);
+            Exp e125;
+            e125 = mknum(1.0);
+            list_add(interp, &d123, e125);
+            Exp e126;
+            e126 = mknum(2.0);
+            list_add(interp, &d123, e126);
+            Exp e127;
+            e127 = mknum(3.0);
+            list_add(interp, &d123, e127);
+            e122 = mklist(interp, d123);
+        }
+        list_add(interp, &d103, e122);
+        lit[5] = mklist(interp, d103);
+    }
+    interp_pin(interp, lit[5]);
+    {
+        List d128 = VECTOR_INIT();
+        Exp e129;
+        e129 = sym[21];
+        list_add(interp, &d128, e129);
+        Exp e130;
+        {
+            List d131 = VECTOR_INIT();
+            Exp e132;
+            e132 = sym[4];
+            list_add(interp, &d131, e132);
+            Exp e133;
+            {
+                List d134 = VECTOR_INIT();
+                Exp e135;
+                e135 = sym[8];
+                list_add(interp, &d134, e135);
+                e133 = mklist(interp, d134);
+            }
+            list_add(interp, &d131, e133);
+            Exp e136;
+            {
+                List d137 = VECTOR_INIT();
+                Exp e138;
+                e138 = sym[10];
+                list_add(interp, &d137, e138);
+                Exp e139;
+                e139 = sym[8];
+                list_add(interp, &d137, e139);
+                Exp e140;
+                e140 = mknum(1.0);
+                list_add(interp, &d137, e140);
+                e136 = mklist(interp, d137);
+            }
+            list_add(interp, &d131, e136);
+            e130 = mklist(interp, d131);
+        }
+        list_add(interp, &d128, e130);
+        Exp e141;
+        {
+            List d142 = VECTOR_INIT();
+            Exp e143;
+            e143 = sym[7];
+            list_add(interp, &d142, e143);
+            Exp e144;
+            e144 = mknum(1.0);
+            list_add(interp, &d142, e144);
+            e141 = mklist(interp, d142);
+        }
+        list_add(interp, &d128, e141);
+        lit[6] = mklist(interp, d128);
+    }
+    interp_pin(interp, lit[6]);
+    {
+        List d145 = VECTOR_INIT();
+        Exp e146;
+        e146 = sym[21];
+        list_add(interp, &d145, e146);
+        Exp e147;
+        {
+            List d148 = VECTOR_INIT();
+            Exp e149;
+            e149 = sym[4];
+            list_add(interp, &d148, e149);
+            Exp e150;
+            {
+                List d151 = VECTOR_INIT();
+                Exp e152;
+                e152 = sym[8];
+                list_add(interp, &d151, e152);
+                e150 = mklist(interp, d151);
+            }
+            list_add(interp, &d148, e150);
+            Exp e153;
+            e153 = sym[8];
+            list_add(interp, &d148, e153);
+            e147 = mklist(interp, d148);
+        }
+        list_add(interp, &d145, e147);
+        Exp e154;
+        {
+            List d155 = VECTOR_INIT();
+            Exp e156;
+            e156 = sym[7];
+            list_add(interp, &d155, e156);
+            e154 = mklist(interp, d155);
+        }
+        list_add(interp, &d145, e154);
+        lit[7] = mklist(interp, d145);
+    }
+    interp_pin(interp, lit[7]);
+    prim[0] = global_ref(interp, sym[23]).cproc;
+    prim[1] = global_ref(interp, sym[3]).cproc;
+    prim[2] = global_ref(interp, sym[24]).cproc;
+    prim[3] = global_ref(interp, sym[12]).cproc;
+    prim[4] = global_ref(interp, sym[21]).cproc;
+}
+
+static void run(Interp *interp)
+{
+    stack_enter(interp);
+    // (define v (make-vector 4 0))
+    gc_maybe_collect(interp);
+    {
+        Exp a0_data[] = { mknum(4.0), mknum(0.0) };
+        List a0 = { .data = a0_data, .size = 2, .cap = 2 };
+        Exp v1 = prim[0](interp, a0);
+        interp_define(interp, "v", v1);
+    }
+    // (parallel-for-each (lambda (i) (vector-set! v i 1)) (list 0 1 2 3))
+    eval_form(interp, lit[0]);
+    // v
+    gc_maybe_collect(interp);
+    {
+        Exp v0 = global_ref(interp, sym[0]);
+        show(interp, v0);
+    }
+    // (define total 0)
+    gc_maybe_collect(interp);
+    {
+        interp_define(interp, "total", mknum(0.0));
+    }
+    // (parallel-for-each (lambda (x) (set! total (+ total x))) (list 1 2 3))
+    eval_form(interp, lit[1]);
+    // total
+    gc_maybe_collect(interp);
+    {
+        Exp v0 = global_ref(interp, sym[1]);
+        show(interp, v0);
+    }
+    // (parallel-for-each (lambda (x) (display x)) (list 1 2 3))
+    eval_form(interp, lit[2]);
+    // (newline)
+    gc_maybe_collect(interp);
+    {
+        List a0 = VECTOR_INIT();
+        Exp v1 = prim[2](interp, a0);
+        show(interp, v1);
+    }
+    // (define w (make-vector 1 0))
+    gc_maybe_collect(interp);
+    {
+        Exp a0_data[] = { mknum(1.0), mknum(0.0) };
+        List a0 = { .data = a0_data, .size = 2, .cap = 2 };
+        Exp v1 = prim[0](interp, a0);
+        interp_define(interp, "w", v1);
+    }
+    // (touch (future (begin (vector-set! w 0 5) (vector-ref w 0))))
+    eval_form(interp, lit[3]);
+    // w
+    gc_maybe_collect(interp);
+    {
+        Exp v0 = global_ref(interp, sym[2]);
+        show(interp, v0);
+    }
+    // (guard (e (1 (quote failed))) (touch (future (car 1))))
+    eval_form(interp, lit[4]);
+    // (parallel-map (lambda (x) (touch (future (* x 10)))) (list 1 2 3))
+    eval_form(interp, lit[5]);
+    // (parallel-map (lambda (x) (+ x 1)) (list 1))
+    eval_form(interp, lit[6]);
+    // (parallel-map (lambda (x) x) (list))
+    eval_form(interp, lit[7]);
+}
+
+int main(void)
+{
+    Interp *interp = interp_new();
+    // forms left to the interpreter were optimized when compiled
+    interp->optimize = false;
+    init(interp);
+    run(interp);
+    interp_free(interp);
+    return 0;
+}
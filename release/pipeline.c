@@ -0,0 +1,616 @@
+// Compiled from bench/pipeline.scm by scheme -c.
+
+#include "scheme.h"
+#include "gcobject.h"
+#include "ht.h"
+
+#define VOID_EXP ((Exp) { .type = EXP_VOID })
+
+static inline noreturn void undefined(Interp *interp, Exp name)
+{
+    die(interp, "undefined symbol: %s\n", AS_SYM(name));
+}
+
+static inline Exp global_ref(Interp *interp, Exp name)
+{
+    Exp value;
+    if (!ht_lookup(&ENV_HT(interp->global), name, &value)) {
+        undefined(interp, name);
+    }
+    return value;
+}
+
+// Raise a stack overflow past the limit run() set, as proc_call does.
+static inline void check_stack(Interp *interp)
+{
+    if ((uintptr_t) __builtin_frame_address(0) < interp->stack_limit) {
+        stack_overflow(interp);
+    }
+}
+
+static inline Exp proc_ref(Interp *interp, Exp proc)
+{
+    if (!is_proc(proc)) {
+        die(interp, "error: not a procedure\n");
+    }
+    return proc;
+}
+
+static inline Exp call(Interp *interp, Exp proc, List args)
+{
+    return proc.type == EXP_C_PROC ? proc.cproc(interp, args)
+                                   : proc_call(interp, &AS_PROC(proc), args);
+}
+
+// Print the value of a top-level form.
+static inline void show(Interp *interp, Exp val)
+{
+    print_to(interp->out, val);
+    if (val.type != EXP_VOID && val.type != EXP_EMPTY) {
+        writer_putc(interp->out, '\n');
+    }
+}
+
+// Run a form the compiler left to the interpreter.
+static inline void eval_form(Interp *interp, Exp form)
+{
+    Exp val = interp_eval(interp, form);
+    show(interp, val);
+    interp_unpin(interp, val);
+}
+
+static Exp sym[20];
+static Exp lit[10];
+static CProc prim[6];
+static bool defined[6];
+
+static Exp proc_0(Interp *interp, Exp p0, Exp p1);
+static Exp proc_1(Interp *interp, Exp p0, Exp p1);
+static Exp proc_2(Interp *interp, Exp p0);
+static Exp proc_3(Interp *interp, Exp p0, Exp p1);
+static Exp proc_5(Interp *interp, Exp p0, Exp p1);
+
+// map
+static Exp proc_0(Interp *interp, Exp p0, Exp p1)
+{
+    check_stack(interp);
+    Exp a3_data[] = { p1 };
+    List a3 = { .data = a3_data, .size = 1, .cap = 1 };
+    Exp v4 = prim[0](interp, a3);
+    Exp v15;
+    if (is_true(v4)) {
+        v15 = lit[6];
+    } else {
+        Exp v5 = proc_ref(interp, p0);
+        Exp a6_data[] = { p1 };
+        List a6 = { .data = a6_data, .size = 1, .cap = 1 };
+        Exp v7 = prim[1](interp, a6);
+        Exp a8_data[] = { v7 };
+        List a8 = { .data = a8_data, .size = 1, .cap = 1 };
+        Exp v9 = call(interp, v5, a8);
+        Exp a10_data[] = { p1 };
+        List a10 = { .data = a10_data, .size = 1, .cap = 1 };
+        Exp v11 = prim[2](interp, a10);
+        Exp v12 = proc_0(interp, p0, v11);
+        Exp a13_data[] = { v9, v12 };
+        List a13 = { .data = a13_data, .size = 2, .cap = 2 };
+        Exp v14 = prim[3](interp, a13);
+        v15 = v14;
+    }
+    return v15;
+}
+
+static Exp proc_0_entry(Interp *interp, List args)
+{
+    if (args.size != 2) {
+        die(interp, "%s: arity mismatch\n", "map");
+    }
+    return proc_0(interp, args.data[0], args.data[1]);
+}
+
+// filter
+static Exp proc_1(Interp *interp, Exp p0, Exp p1)
+{
+    check_stack(interp);
+top:;
+    Exp a3_data[] = { p1 };
+    List a3 = { .data = a3_data, .size = 1, .cap = 1 };
+    Exp v4 = prim[0](interp, a3);
+    Exp v21;
+    if (is_true(v4)) {
+        v21 = lit[7];
+    } else {
+        Exp v5 = proc_ref(interp, p0);
+        Exp a6_data[] = { p1 };
+        List a6 = { .data = a6_data, .size = 1, .cap = 1 };
+        Exp v7 = prim[1](interp, a6);
+        Exp a8_data[] = { v7 };
+        List a8 = { .data = a8_data, .size = 1, .cap = 1 };
+        Exp v9 = call(interp, v5, a8);
+        Exp v20;
+        if (is_true(v9)) {
+            Exp a10_data[] = { p1 };
+            List a10 = { .data = a10_data, .size = 1, .cap = 1 };
+            Exp v11 = prim[1](interp, a10);
+            Exp a12_data[] = { p1 };
+            List a12 = { .data = a12_data, .size = 1, .cap = 1 };
+            Exp v13 = prim[2](interp, a12);
+            Exp v14 = proc_1(interp, p0, v13);
+            Exp a15_data[] = { v11, v14 };
+            List a15 = { .data = a15_data, .size = 2, .cap = 2 };
+            Exp v16 = prim[3](interp, a15);
+            v20 = v16;
+        } else {
+            Exp a17_data[] = { p1 };
+            List a17 = { .data = a17_data, .size = 1, .cap = 1 };
+            Exp v18 = prim[2](interp, a17);
+            Exp v19 = p0;
+            p0 = v19;
+            p1 = v18;
+            goto top;
+        }
+        v21 = v20;
+    }
+    return v21;
+}
+
+static Exp proc_1_entry(Interp *interp, List args)
+{
+    if (args.size != 2) {
+        die(interp, "%s: arity mismatch\n", "filter");
+    }
+    return proc_1(interp, args.data[0], args.data[1]);
+}
+
+// sum
+static Exp proc_2(Interp *interp, Exp p0)
+{
+    check_stack(interp);
+    Exp a2_data[] = { p0 };
+    List a2 = { .data = a2_data, .size = 1, .cap = 1 };
+    Exp v3 = prim[0](interp, a2);
+    double v11;
+    if (is_true(v3)) {
+        v11 = 0.0;
+    } else {
+        Exp a4_data[] = { p0 };
+        List a4 = { .data = a4_data, .size = 1, .cap = 1 };
+        Exp v5 = prim[1](interp, a4);
+        Exp a6_data[] = { p0 };
+        List a6 = { .data = a6_data, .size = 1, .cap = 1 };
+        Exp v7 = prim[2](interp, a6);
+        Exp v8 = proc_2(interp, v7);
+        Exp a9_data[] = { v5, v8 };
+        List a9 = { .data = a9_data, .size = 2, .cap = 2 };
+        double v10 = scheme_sum(interp, a9).number;
+        v11 = v10;
+    }
+    return mknum(v11);
+}
+
+static Exp proc_2_entry(Interp *interp, List args)
+{
+    if (args.size != 1) {
+        die(interp, "%s: arity mismatch\n", "sum");
+    }
+    return proc_2(interp, args.data[0]);
+}
+
+// range
+static Exp proc_3(Interp *interp, Exp p0, Exp p1)
+{
+    check_stack(interp);
+    Exp a3_data[] = { p0, p1 };
+    List a3 = { .data = a3_data, .size = 2, .cap = 2 };
+    double v4 = scheme_lt(interp, a3).number;
+    Exp v10;
+    if (v4 != 0) {
+        Exp a5_data[] = { p0, mknum(1.0) };
+        List a5 = { .data = a5_data, .size = 2, .cap = 2 };
+        double v6 = scheme_sum(interp, a5).number;
+        Exp v7 = proc_3(interp, mknum(v6), p1);
+        Exp a8_data[] = { p0, v7 };
+        List a8 = { .data = a8_data, .size = 2, .cap = 2 };
+        Exp v9 = prim[3](interp, a8);
+        v10 = v9;
+    } else {
+        v10 = lit[8];
+    }
+    return v10;
+}
+
+static Exp proc_3_entry(Interp *interp, List args)
+{
+    if (args.size != 2) {
+        die(interp, "%s: arity mismatch\n", "range");
+    }
+    return proc_3(interp, args.data[0], args.data[1]);
+}
+
+// repeat
+static Exp proc_5(Interp *interp, Exp p0, Exp p1)
+{
+    check_stack(interp);
+top:;
+    Exp a3_data[] = { p0, mknum(0.0) };
+    List a3 = { .data = a3_data, .size = 2, .cap = 2 };
+    double v4 = scheme_eq(interp, a3).number;
+    Exp v13;
+    if (v4 != 0) {
+        v13 = p1;
+    } else {
+        Exp a5_data[] = { p0, mknum(1.0) };
+        List a5 = { .data = a5_data, .size = 2, .cap = 2 };
+        double v6 = scheme_sub(interp, a5).number;
+        Exp v7 = global_ref(interp, sym[2]);
+        Exp v8 = proc_ref(interp, v7);
+        Exp a9_data[] = { mknum(400.0) };
+        List a9 = { .data = a9_data, .size = 1, .cap = 1 };
+        Exp v10 = call(interp, v8, a9);
+        Exp a11_data[] = { p1, v10 };
+        List a11 = { .data = a11_data, .size = 2, .cap = 2 };
+        double v12 = scheme_sum(interp, a11).number;
+        p0 = mknum(v6);
+        p1 = mknum(v12);
+        goto top;
+    }
+    return v13;
+}
+
+static Exp proc_5_entry(Interp *interp, List args)
+{
+    if (args.size != 2) {
+        die(interp, "%s: arity mismatch\n", "repeat");
+    }
+    return proc_5(interp, args.data[0], args.data[1]);
+}
+
+static void init(Interp *interp)
+{
+    sym[0] = interp_symbol(interp, "map");
+    interp_pin(interp, sym[0]);
+    sym[1] = interp_symbol(interp, "sum");
+    interp_pin(interp, sym[1]);
+    sym[2] = interp_symbol(interp, "pipeline");
+    interp_pin(interp, sym[2]);
+    sym[3] = interp_symbol(interp, "repeat");
+    interp_pin(interp, sym[3]);
+    sym[4] = interp_symbol(interp, "define");
+    interp_pin(interp, sym[4]);
+    sym[5] = interp_symbol(interp, "lambda");
+    interp_pin(interp, sym[5]);
+    sym[6] = interp_symbol(interp, "n");
+    interp_pin(interp, sym[6]);
+    sym[7] = interp_symbol(interp, "x");
+    interp_pin(interp, sym[7]);
+    sym[8] = interp_symbol(interp, "*");
+    interp_pin(interp, sym[8]);
+    sym[9] = interp_symbol(interp, "filter");
+    interp_pin(interp, sym[9]);
+    sym[10] = interp_symbol(interp, ">");
+    interp_pin(interp, sym[10]);
+    sym[11] = interp_symbol(interp, "append");
+    interp_pin(interp, sym[11]);
+    sym[12] = interp_symbol(interp, "range");
+    interp_pin(interp, sym[12]);
+    sym[13] = interp_symbol(interp, "+");
+    interp_pin(interp, sym[13]);
+    sym[14] = interp_symbol(interp, "null\?");
+    interp_pin(interp, sym[14]);
+    sym[15] = interp_symbol(interp, "car");
+    interp_pin(interp, sym[15]);
+    sym[16] = interp_symbol(interp, "cdr");
+    interp_pin(interp, sym[16]);
+    sym[17] = interp_symbol(interp, "cons");
+    interp_pin(interp, sym[17]);
+    sym[18] = interp_symbol(interp, "display");
+    interp_pin(interp, sym[18]);
+    sym[19] = interp_symbol(interp, "newline");
+    interp_pin(interp, sym[19]);
+    {
+        List d0 = VECTOR_INIT();
+        lit[0] = mklist(interp, d0);
+    }
+    interp_pin(interp, lit[0]);
+    {
+        List d1 = VECTOR_INIT();
+        lit[1] = mklist(interp, d1);
+    }
+    interp_pin(interp, lit[1]);
+    {
+        List d2 = VECTOR_INIT();
+        lit[2] = mklist(interp, d2);
+    }
+    interp_pin(interp, lit[2]);
+    {
+        List d3 = VECTOR_INIT();
+        lit[3] = mklist(interp, d3);
+    }
+    interp_pin(interp, lit[3]);
+    {
+        List d4 = VECTOR_INIT();
+        lit[4] = mklist(interp, d4);
+    }
+    interp_pin(interp, lit[4]);
+    {
+        List d5 = VECTOR_INIT();
+        lit[5] = mklist(interp, d5);
+    }
+    interp_pin(interp, lit[5]);
+    {
+        List d6 = VECTOR_INIT();
+        lit[6] = mklist(interp, d6);
+    }
+    interp_pin(interp, lit[6]);
+    {
+        List d7 = VECTOR_INIT();
+        lit[7] = mklist(interp, d7);
+    }
+    interp_pin(interp, lit[7]);
+    {
+        List d8 = VECTOR_INIT();
+        lit[8] = mklist(interp, d8);
+    }
+    interp_pin(interp, lit[8]);
+    {
+        List d9 = VECTOR_INIT();
+        Exp e10;
+        e10 = sym[4];
+        list_add(interp, &d9, e10);
+        Exp e11;
+        e11 = sym[2];
+        list_add(interp, &d9, e11);
+        Exp e12;
+        {
+            List d13 = VECTOR_INIT();
+            Exp e14;
+            e14 = sym[5];
+            list_add(interp, &d13, e14);
+            Exp e15;
+            {
+                List d16 = VECTOR_INIT();
+                Exp e17;
+                e17 = sym[6];
+                list_add(interp, &d16, e17);
+                e15 = mklist(interp, d16);
+            }
+            list_add(interp, &d13, e15);
+            Exp e18;
+            {
+                List d19 = VECTOR_INIT();
+                Exp e20;
+                e20 = sym[1];
+                list_add(interp, &d19, e20);
+                Exp e21;
+                {
+                    List d22 = VECTOR_INIT();
+                    Exp e23;
+                    e23 = sym[0];
+                    list_add(interp, &d22, e23);
+                    Exp e24;
+                    {
+                        List d25 = VECTOR_INIT();
+                        Exp e26;
+                        e26 = sym[5];
+                        list_add(interp, &d25, e26);
+                        Exp e27;
+                        {
+                            List d28 = VECTOR_INIT();
+                            Exp e29;
+                            e29 = sym[7];
+                            list_add(interp, &d28, e29);
+                            e27 = mklist(interp, d28);
+                        }
+                        list_add(interp, &d25, e27);
+                        Exp e30;
+                        {
+                            List d31 = VECTOR_INIT();
+                            Exp e32;
+                            e32 = sym[8];
+                            list_add(interp, &d31, e32);
+                            Exp e33;
+                            e33 = sym[7];
+                            list_add(interp, &d31, e33);
+                            Exp e34;
+                            e34 = mknum(3.0);
+                            list_add(interp, &d31, e34);
+                            e30 = mklist(interp, d31);
+                        }
+                        list_add(interp, &d25, e30);
+                        e24 = mklist(interp, d25);
+                    }
+                    list_add(interp, &d22, e24);
+                    Exp e35;
+                    {
+                        List d36 = VECTOR_INIT();
+                        Exp e37;
+                        e37 = sym[9];
+                        list_add(interp, &d36, e37);
+                        Exp e38;
+                        {
+                            List d39 = VECTOR_INIT();
+                            Exp e40;
+                            e40 = sym[5];
+                            list_add(interp, &d39, e40);
+                            Exp e41;
+                            {
+                                List d42 = VECTOR_INIT();
+                                Exp e43;
+                                e43 = sym[7];
+                                list_add(interp, &d42, e43);
+                                e41 = mklist(interp, d42);
+                            }
+                            list_add(interp, &d39, e41);
+                            Exp e44;
+                            {
+                                List d45 = VECTOR_INIT();
+                                Exp e46;
+                                e46 = sym[10];
+                                list_add(interp, &d45, e46);
+                                Exp e47;
+                                e47 = sym[7];
+                                list_add(interp, &d45, e47);
+                                Exp e48;
+                                e48 = mknum(2.0);
+                                list_add(interp, &d45, e48);
+                                e44 = mklist(interp, d45);
+                            }
+                            list_add(interp, &d39, e44);
+                            e38 = mklist(interp, d39);
+                        }
+                        list_add(interp, &d36, e38);
+                        Exp e49;
+                        {
+                            List d50 = VECTOR_INIT();
+                            Exp e51;
+                            e51 = sym[11];
+                            list_add(interp, &d50, e51);
+                            Exp e52;
+                            {
+                                List d53 = VECTOR_INIT();
+                                Exp e54;
+                                e54 = sym[12];
+                                list_add(interp, &d53, e54);
+                                Exp e55;
+                                e55 = mknum(0.0);
+                                list_add(interp, &d53, e55);
+                                Exp e56;
+                                e56 = sym[6];
+                                list_add(interp, &d53, e56);
+                                e52 = mklist(interp, d53);
+                            }
+                            list_add(interp, &d50, e52);
+                            Exp e57;
+                            {
+                                List d58 = VECTOR_INIT();
+                                Exp e59;
+                                e59 = sym[0];
+                                list_add(interp, &d58, e59);
+                                Exp e60;
+                                {
+                                    List d61 = VECTOR_INIT();
+                                    Exp e62;
+                                    e62 = sym[5];
+                                    list_add(interp, &d61, e62);
+                                    Exp e63;
+                                    {
+                                        List d64 = VECTOR_INIT();
+                                        Exp e65;
+                                        e65 = sym[7];
+                                        list_add(interp, &d64, e65);
+                                        e63 = mklist(interp, d64);
+                                    }
+                                    list_add(interp, &d61, e63);
+                                    Exp e66;
+                                    {
+                                        List d67 = VECTOR_INIT();
+                                        Exp e68;
+                                        e68 = sym[13];
+                                        list_add(interp, &d67, e68);
+                                        Exp e69;
+                                        e69 = sym[7];
+                                        list_add(interp, &d67, e69);
+                                        Exp e70;
+                                        e70 = mknum(1.0);
+                                        list_add(interp, &d67, e70);
+                                        e66 = mklist(interp, d67);
+                                    }
+                                    list_add(interp, &d61, e66);
+                                    e60 = mklist(interp, d61);
+                                }
+                                list_add(interp, &d58, e60);
+                                Exp e71;
+                                {
+                                    List d72 = VECTOR_INIT();
+                                    Exp e73;
+                                    e73 = sym[12];
+                                    list_add(interp, &d72, e73);
+                                    Exp e74;
+                                    e74 = mknum(0.0);
+                                    list_add(interp, &d72, e74);
+                                    Exp e75;
+                                    e75 = sym[6];
+                                    list_add(interp, &d72, e75);
+                                    e71 = mklist(interp, d72);
+                                }
+                                list_add(interp, &d58, e71);
+                                e57 = mklist(interp, d58);
+                            }
+                            list_add(interp, &d50, e57);
+                            e49 = mklist(interp, d50);
+                        }
+                        list_add(interp, &d36, e49);
+                        e35 = mklist(interp, d36);
+                    }
+                    list_add(interp, &d22, e35);
+                    e21 = mklist(interp, d22);
+                }
+                list_add(interp, &d19, e21);
+                e18 = mklist(interp, d19);
+            }
+            list_add(interp, &d13, e18);
+            e12 = mklist(interp, d13);
+        }
+        list_add(interp, &d9, e12);
+        lit[9] = mklist(interp, d9);
+    }
+    interp_pin(interp, lit[9]);
+    prim[0] = global_ref(interp, sym[14]).cproc;
+    prim[1] = global_ref(interp, sym[15]).cproc;
+    prim[2] = global_ref(interp, sym[16]).cproc;
+    prim[3] = global_ref(interp, sym[17]).cproc;
+    prim[4] = global_ref(interp, sym[18]).cproc;
+    prim[5] = global_ref(interp, sym[19]).cproc;
+}
+
+static void run(Interp *interp)
+{
+    stack_enter(interp);
+    // (define map (lambda (fn lst) (if (null  lst) (quote ()) (cons (fn (car l ...
+    defined[0] = true;
+    interp_define(interp, "map", mkcproc(proc_0_entry));
+    // (define filter (lambda (pred lst) (if (null  lst) (quote ()) (if (pred ( ...
+    defined[1] = true;
+    interp_define(interp, "filter", mkcproc(proc_1_entry));
+    // (define sum (lambda (lst) (if (null  lst) 0 (+ (car lst) (sum (cdr lst)) ...
+    defined[2] = true;
+    interp_define(interp, "sum", mkcproc(proc_2_entry));
+    // (define range (lambda (a b) (if (< a b) (cons a (range (+ a 1) b)) (quot ...
+    defined[3] = true;
+    interp_define(interp, "range", mkcproc(proc_3_entry));
+    // (define pipeline (lambda (n) (sum (map (lambda (x) (* x 3)) (filter (lam ...
+    eval_form(interp, lit[9]);
+    // (define repeat (lambda (k acc) (if (= k 0) acc (repeat (- k 1) (+ acc (p ...
+    defined[5] = true;
+    interp_define(interp, "repeat", mkcproc(proc_5_entry));
+    // (display (repeat 10 0))
+    gc_maybe_collect(interp);
+    {
+        if (!defined[5]) {
+            undefined(interp, sym[3]);
+        }
+        Exp v0 = proc_5(interp, mknum(10.0), mknum(0.0));
+        Exp a1_data[] = { v0 };
+        List a1 = { .data = a1_data, .size = 1, .cap = 1 };
+        Exp v2 = prim[4](interp, a1);
+        show(interp, v2);
+    }
+    // (newline)
+    gc_maybe_collect(interp);
+    {
+        List a0 = VECTOR_INIT();
+        Exp v1 = prim[5](interp, a0);
+        show(interp, v1);
+    }
+}
+
+int main(void)
+{
+    Interp *interp = interp_new();
+    // forms left to the interpreter were optimized when compiled
+    interp->optimize = false;
+    init(interp);
+    run(interp);
+    interp_free(interp);
+    return 0;
+}
@@ -0,0 +1,526 @@
+// Compiled from tests/redefine.scm by scheme -c.
+
+#include "scheme.h"
+#include "gcobject.h"
+#include "ht.h"
+
+#define VOID_EXP ((Exp) { .type = EXP_VOID })
+
+static inline noreturn void undefined(Interp *interp, Exp name)
+{
+    die(interp, "undefined symbol: %s\n", AS_SYM(name));
+}
+
+static inline Exp global_ref(Interp *interp, Exp name)
+{
+    Exp value;
+    if (!ht_lookup(&ENV_HT(interp->global), name, &value)) {
+        undefined(interp, name);
+    }
+    return value;
+}
+
+// Raise a stack overflow past the limit run() set, as proc_call does.
+static inline void check_stack(Interp *interp)
+{
+    if ((uintptr_t) __builtin_frame_address(0) < interp->stack_limit) {
+        stack_overflow(interp);
+    }
+}
+
+static inline Exp proc_ref(Interp *interp, Exp proc)
+{
+    if (!is_proc(proc)) {
+        die(interp, "error: not a procedure\n");
+    }
+    return proc;
+}
+
+static inline Exp call(Interp *interp, Exp proc, List args)
+{
+    return proc.type == EXP_C_PROC ? proc.cproc(interp, args)
+                                   : proc_call(interp, &AS_PROC(proc), args);
+}
+
+// Print the value of a top-level form.
+static inline void show(Interp *interp, Exp val)
+{
+    print_to(interp->out, val);
+    if (val.type != EXP_VOID && val.type != EXP_EMPTY) {
+        writer_putc(interp->out, '\n');
+    }
+}
+
+// Run a form the compiler left to the interpreter.
+static inline void eval_form(Interp *interp, Exp form)
+{
+    Exp val = interp_eval(interp, form);
+    show(interp, val);
+    interp_unpin(interp, val);
+}
+
+static Exp sym[16];
+static Exp lit[6];
+static bool defined[5];
+
+static Exp proc_0(Interp *interp);
+static Exp proc_1(Interp *interp);
+static Exp proc_2(Interp *interp);
+static Exp proc_3(Interp *interp);
+static Exp proc_4(Interp *interp);
+
+// g
+static Exp proc_0(Interp *interp)
+{
+    check_stack(interp);
+    Exp v1 = global_ref(interp, sym[0]);
+    Exp v2 = proc_ref(interp, v1);
+    Exp a3_data[] = { mknum(3.0) };
+    List a3 = { .data = a3_data, .size = 1, .cap = 1 };
+    Exp v4 = call(interp, v2, a3);
+    return v4;
+}
+
+static Exp proc_0_entry(Interp *interp, List args)
+{
+    if (args.size != 0) {
+        die(interp, "%s: arity mismatch\n", "g");
+    }
+    return proc_0(interp);
+}
+
+// f
+static Exp proc_1(Interp *interp)
+{
+    check_stack(interp);
+    Exp v1 = global_ref(interp, sym[1]);
+    Exp v2 = proc_ref(interp, v1);
+    Exp a3_data[] = { mknum(1.0), mknum(2.0) };
+    List a3 = { .data = a3_data, .size = 2, .cap = 2 };
+    Exp v4 = call(interp, v2, a3);
+    return v4;
+}
+
+static Exp proc_1_entry(Interp *interp, List args)
+{
+    if (args.size != 0) {
+        die(interp, "%s: arity mismatch\n", "f");
+    }
+    return proc_1(interp);
+}
+
+// begin-last
+static Exp proc_2(Interp *interp)
+{
+    check_stack(interp);
+    Exp v1 = global_ref(interp, sym[2]);
+    Exp v2 = proc_ref(interp, v1);
+    Exp a3_data[] = { mknum(1.0), mknum(2.0) };
+    List a3 = { .data = a3_data, .size = 2, .cap = 2 };
+    Exp v4 = call(interp, v2, a3);
+    return v4;
+}
+
+static Exp proc_2_entry(Interp *interp, List args)
+{
+    if (args.size != 0) {
+        die(interp, "%s: arity mismatch\n", "begin-last");
+    }
+    return proc_2(interp);
+}
+
+// h
+static Exp proc_3(Interp *interp)
+{
+    check_stack(interp);
+    Exp v1 = global_ref(interp, sym[3]);
+    Exp v2 = proc_ref(interp, v1);
+    Exp a3_data[] = { mknum(10.0), mknum(2.0) };
+    List a3 = { .data = a3_data, .size = 2, .cap = 2 };
+    Exp v4 = call(interp, v2, a3);
+    return v4;
+}
+
+static Exp proc_3_entry(Interp *interp, List args)
+{
+    if (args.size != 0) {
+        die(interp, "%s: arity mismatch\n", "h");
+    }
+    return proc_3(interp);
+}
+
+// k
+static Exp proc_4(Interp *interp)
+{
+    check_stack(interp);
+    Exp v1 = global_ref(interp, sym[4]);
+    Exp v2 = proc_ref(interp, v1);
+    Exp a3_data[] = { mknum(3.0) };
+    List a3 = { .data = a3_data, .size = 1, .cap = 1 };
+    Exp v4 = call(interp, v2, a3);
+    return v4;
+}
+
+static Exp proc_4_entry(Interp *interp, List args)
+{
+    if (args.size != 0) {
+        die(interp, "%s: arity mismatch\n", "k");
+    }
+    return proc_4(interp);
+}
+
+static void init(Interp *interp)
+{
+    sym[0] = interp_symbol(interp, "sq");
+    interp_pin(interp, sym[0]);
+    sym[1] = interp_symbol(interp, "+");
+    interp_pin(interp, sym[1]);
+    sym[2] = interp_symbol(interp, "begin");
+    interp_pin(interp, sym[2]);
+    sym[3] = interp_symbol(interp, "-");
+    interp_pin(interp, sym[3]);
+    sym[4] = interp_symbol(interp, "cube");
+    interp_pin(interp, sym[4]);
+    sym[5] = interp_symbol(interp, "g");
+    interp_pin(interp, sym[5]);
+    sym[6] = interp_symbol(interp, "f");
+    interp_pin(interp, sym[6]);
+    sym[7] = interp_symbol(interp, "list");
+    interp_pin(interp, sym[7]);
+    sym[8] = interp_symbol(interp, "begin-last");
+    interp_pin(interp, sym[8]);
+    sym[9] = interp_symbol(interp, "h");
+    interp_pin(interp, sym[9]);
+    sym[10] = interp_symbol(interp, "k");
+    interp_pin(interp, sym[10]);
+    sym[11] = interp_symbol(interp, "define");
+    interp_pin(interp, sym[11]);
+    sym[12] = interp_symbol(interp, "lambda");
+    interp_pin(interp, sym[12]);
+    sym[13] = interp_symbol(interp, "x");
+    interp_pin(interp, sym[13]);
+    sym[14] = interp_symbol(interp, "*");
+    interp_pin(interp, sym[14]);
+    sym[15] = interp_symbol(interp, "set!");
+    interp_pin(interp, sym[15]);
+    {
+        List d0 = VECTOR_INIT();
+        Exp e1;
+        e1 = sym[11];
+        list_add(interp, &d0, e1);
+        Exp e2;
+        e2 = sym[0];
+        list_add(interp, &d0, e2);
+        Exp e3;
+        {
+            List d4 = VECTOR_INIT();
+            Exp e5;
+            e5 = sym[12];
+            list_add(interp, &d4, e5);
+            Exp e6;
+            {
+                List d7 = VECTOR_INIT();
+                Exp e8;
+                e8 = sym[13];
+                list_add(interp, &d7, e8);
+                e6 = mklist(interp, d7);
+            }
+            list_add(interp, &d4, e6);
+            Exp e9;
+            {
+                List d10 = VECTOR_INIT();
+                Exp e11;
+                e11 = sym[14];
+                list_add(interp, &d10, e11);
+                Exp e12;
+                e12 = sym[13];
+                list_add(interp, &d10, e12);
+                Exp e13;
+                e13 = sym[13];
+                list_add(interp, &d10, e13);
+                e9 = mklist(interp, d10);
+            }
+            list_add(interp, &d4, e9);
+            e3 = mklist(interp, d4);
+        }
+        list_add(interp, &d0, e3);
+        lit[0] = mklist(interp, d0);
+    }
+    interp_pin(interp, lit[0]);
+    {
+        List d14 = VECTOR_INIT();
+        Exp e15;
+        e15 = sym[11];
+        list_add(interp, &d14, e15);
+        Exp e16;
+        e16 = sym[0];
+        list_add(interp, &d14, e16);
+        Exp e17;
+        {
+            List d18 = VECTOR_INIT();
+            Exp e19;
+            e19 = sym[12];
+            list_add(interp, &d18, e19);
+            Exp e20;
+            {
+                List d21 = VECTOR_INIT();
+                Exp e22;
+                e22 = sym[13];
+                list_add(interp, &d21, e22);
+                e20 = mklist(interp, d21);
+            }
+            list_add(interp, &d18, e20);
+            Exp e23;
+            {
+                List d24 = VECTOR_INIT();
+                Exp e25;
+                e25 = sym[3];
+                list_add(interp, &d24, e25);
+                Exp e26;
+                e26 = sym[13];
+                list_add(interp, &d24, e26);
+                Exp e27;
+                e27 = mknum(1.0);
+                list_add(interp, &d24, e27);
+                e23 = mklist(interp, d24);
+            }
+            list_add(interp, &d18, e23);
+            e17 = mklist(interp, d18);
+        }
+        list_add(interp, &d14, e17);
+        lit[1] = mklist(interp, d14);
+    }
+    interp_pin(interp, lit[1]);
+    {
+        List d28 = VECTOR_INIT();
+        Exp e29;
+        e29 = sym[15];
+        list_add(interp, &d28, e29);
+        Exp e30;
+        e30 = sym[1];
+        list_add(interp, &d28, e30);
+        Exp e31;
+        e31 = sym[14];
+        list_add(interp, &d28, e31);
+        lit[2] = mklist(interp, d28);
+    }
+    interp_pin(interp, lit[2]);
+    {
+        List d32 = VECTOR_INIT();
+        Exp e33;
+        e33 = sym[15];
+        list_add(interp, &d32, e33);
+        Exp e34;
+        e34 = sym[3];
+        list_add(interp, &d32, e34);
+        Exp e35;
+        e35 = sym[1];
+        list_add(interp, &d32, e35);
+        lit[3] = mklist(interp, d32);
+    }
+    interp_pin(interp, lit[3]);
+    {
+        List d36 = VECTOR_INIT();
+        Exp e37;
+        e37 = sym[11];
+        list_add(interp, &d36, e37);
+        Exp e38;
+        e38 = sym[4];
+        list_add(interp, &d36, e38);
+        Exp e39;
+        {
+            List d40 = VECTOR_INIT();
+            Exp e41;
+            e41 = sym[12];
+            list_add(interp, &d40, e41);
+            Exp e42;
+            {
+                List d43 = VECTOR_INIT();
+                Exp e44;
+                e44 = sym[13];
+                list_add(interp, &d43, e44);
+                e42 = mklist(interp, d43);
+            }
+            list_add(interp, &d40, e42);
+            Exp e45;
+            {
+                List d46 = VECTOR_INIT();
+                Exp e47;
+                e47 = sym[14];
+                list_add(interp, &d46, e47);
+                Exp e48;
+                e48 = sym[13];
+                list_add(interp, &d46, e48);
+                Exp e49;
+                e49 = sym[13];
+                list_add(interp, &d46, e49);
+                Exp e50;
+                e50 = sym[13];
+                list_add(interp, &d46, e50);
+                e45 = mklist(interp, d46);
+            }
+            list_add(interp, &d40, e45);
+            e39 = mklist(interp, d40);
+        }
+        list_add(interp, &d36, e39);
+        lit[4] = mklist(interp, d36);
+    }
+    interp_pin(interp, lit[4]);
+    {
+        List d51 = VECTOR_INIT();
+        Exp e52;
+        e52 = sym[11];
+        list_add(interp, &d51, e52);
+        Exp e53;
+        e53 = sym[4];
+        list_add(interp, &d51, e53);
+        Exp e54;
+        {
+            List d55 = VECTOR_INIT();
+            Exp e56;
+            e56 = sym[12];
+            list_add(interp, &d55, e56);
+            Exp e57;
+            {
+                List d58 = VECTOR_INIT();
+                Exp e59;
+                e59 = sym[13];
+                list_add(interp, &d58, e59);
+                e57 = mklist(interp, d58);
+            }
+            list_add(interp, &d55, e57);
+            Exp e60;
+            {
+                List d61 = VECTOR_INIT();
+                Exp e62;
+                e62 = sym[3];
+                list_add(interp, &d61, e62);
+                Exp e63;
+                e63 = sym[13];
+                list_add(interp, &d61, e63);
+                Exp e64;
+                e64 = mknum(1.0);
+                list_add(interp, &d61, e64);
+                e60 = mklist(interp, d61);
+            }
+            list_add(interp, &d55, e60);
+            e54 = mklist(interp, d55);
+        }
+        list_add(interp, &d51, e54);
+        lit[5] = mklist(interp, d51);
+    }
+    interp_pin(interp, lit[5]);
+}
+
+static void run(Interp *interp)
+{
+    stack_enter(interp);
+    // (define sq (lambda (x) (* x x)))
+    eval_form(interp, lit[0]);
+    // (define g (lambda () (sq 3)))
+    defined[0] = true;
+    interp_define(interp, "g", mkcproc(proc_0_entry));
+    // (g)
+    gc_maybe_collect(interp);
+    {
+        if (!defined[0]) {
+            undefined(interp, sym[5]);
+        }
+        Exp v0 = proc_0(interp);
+        show(interp, v0);
+    }
+    // (define sq (lambda (x) (- x 1)))
+    eval_form(interp, lit[1]);
+    // (g)
+    gc_maybe_collect(interp);
+    {
+        if (!defined[0]) {
+            undefined(interp, sym[5]);
+        }
+        Exp v0 = proc_0(interp);
+        show(interp, v0);
+    }
+    // (define f (lambda () (+ 1 2)))
+    defined[1] = true;
+    interp_define(interp, "f", mkcproc(proc_1_entry));
+    // (set! + *)
+    eval_form(interp, lit[2]);
+    // (f)
+    gc_maybe_collect(interp);
+    {
+        if (!defined[1]) {
+            undefined(interp, sym[6]);
+        }
+        Exp v0 = proc_1(interp);
+        show(interp, v0);
+    }
+    // (+ 2 3)
+    gc_maybe_collect(interp);
+    {
+        Exp v0 = global_ref(interp, sym[1]);
+        Exp v1 = proc_ref(interp, v0);
+        Exp a2_data[] = { mknum(2.0), mknum(3.0) };
+        List a2 = { .data = a2_data, .size = 2, .cap = 2 };
+        Exp v3 = call(interp, v1, a2);
+        show(interp, v3);
+    }
+    // (define begin-last (lambda () (begin 1 2)))
+    defined[2] = true;
+    interp_define(interp, "begin-last", mkcproc(proc_2_entry));
+    // (define begin list)
+    gc_maybe_collect(interp);
+    {
+        Exp v0 = global_ref(interp, sym[7]);
+        interp_define(interp, "begin", v0);
+    }
+    // (begin-last)
+    gc_maybe_collect(interp);
+    {
+        if (!defined[2]) {
+            undefined(interp, sym[8]);
+        }
+        Exp v0 = proc_2(interp);
+        show(interp, v0);
+    }
+    // (define h (lambda () (- 10 2)))
+    defined[3] = true;
+    interp_define(interp, "h", mkcproc(proc_3_entry));
+    // (set! - +)
+    eval_form(interp, lit[3]);
+    // (h)
+    gc_maybe_collect(interp);
+    {
+        if (!defined[3]) {
+            undefined(interp, sym[9]);
+        }
+        Exp v0 = proc_3(interp);
+        show(interp, v0);
+    }
+    // (define cube (lambda (x) (* x x x)))
+    eval_form(interp, lit[4]);
+    // (define k (lambda () (cube 3)))
+    defined[4] = true;
+    interp_define(interp, "k", mkcproc(proc_4_entry));
+    // (define cube (lambda (x) (- x 1)))
+    eval_form(interp, lit[5]);
+    // (k)
+    gc_maybe_collect(interp);
+    {
+        if (!defined[4]) {
+            undefined(interp, sym[10]);
+        }
+        Exp v0 = proc_4(interp);
+        show(interp, v0);
+    }
+}
+
+int main(void)
+{
+    Interp *interp = interp_new();
+    // forms left to the interpreter were optimized when compiled
+    interp->optimize = false;
+    init(interp);
+    run(interp);
+    interp_free(interp);
+    return 0;
+}
@@ -0,0 +1,666 @@
+// Compiled from tests/streams-memory.scm by scheme -c.
+
+#include "scheme.h"
+#include "gcobject.h"
+#include "ht.h"
+
+#define VOID_EXP ((Exp) { .type = EXP_VOID })
+
+static inline noreturn void undefined(Interp *interp, Exp name)
+{
+    die(interp, "undefined symbol: %s\n", AS_SYM(name));
+}
+
+static inline Exp global_ref(Interp *interp, Exp name)
+{
+    Exp value;
+    if (!ht_lookup(&ENV_HT(interp->global), name, &value)) {
+        undefined(interp, name);
+    }
+    return value;
+}
+
+// Raise a stack overflow past the limit run() set, as proc_call does.
+static inline void check_stack(Interp *interp)
+{
+    if ((uintptr_t) __builtin_frame_address(0) < interp->stack_limit) {
+        stack_overflow(interp);
+    }
+}
+
+static inline Exp proc_ref(Interp *interp, Exp proc)
+{
+    if (!is_proc(proc)) {
+        die(interp, "error: not a procedure\n");
+    }
+    return proc;
+}
+
+static inline Exp call(Interp *interp, Exp proc, List args)
+{
+    return proc.type == EXP_C_PROC ? proc.cproc(interp, args)
+                                   : proc_call(interp, &AS_PROC(proc), args);
+}
+
+// Print the value of a top-level form.
+static inline void show(Interp *interp, Exp val)
+{
+    print_to(interp->out, val);
+    if (val.type != EXP_VOID && val.type != EXP_EMPTY) {
+        writer_putc(interp->out, '\n');
+    }
+}
+
+// Run a form the compiler left to the interpreter.
+static inline void eval_form(Interp *interp, Exp form)
+{
+    Exp val = interp_eval(interp, form);
+    show(interp, val);
+    interp_unpin(interp, val);
+}
+
+static Exp sym[21];
+static Exp lit[4];
+static CProc prim[5];
+static bool defined[2];
+
+static Exp proc_1(Interp *interp, Exp p0, Exp p1);
+
+// drop
+static Exp proc_1(Interp *interp, Exp p0, Exp p1)
+{
+    check_stack(interp);
+top:;
+    Exp a3_data[] = { p1, mknum(0.0) };
+    List a3 = { .data = a3_data, .size = 2, .cap = 2 };
+    double v4 = scheme_eq(interp, a3).number;
+    Exp v9;
+    if (v4 != 0) {
+        v9 = p0;
+    } else {
+        Exp a5_data[] = { p0 };
+        List a5 = { .data = a5_data, .size = 1, .cap = 1 };
+        Exp v6 = prim[0](interp, a5);
+        Exp a7_data[] = { p1, mknum(1.0) };
+        List a7 = { .data = a7_data, .size = 2, .cap = 2 };
+        double v8 = scheme_sub(interp, a7).number;
+        p0 = v6;
+        p1 = mknum(v8);
+        goto top;
+    }
+    return v9;
+}
+
+static Exp proc_1_entry(Interp *interp, List args)
+{
+    if (args.size != 2) {
+        die(interp, "%s: arity mismatch\n", "drop");
+    }
+    return proc_1(interp, args.data[0], args.data[1]);
+}
+
+static void init(Interp *interp)
+{
+    sym[0] = interp_symbol(interp, "drop");
+    interp_pin(interp, sym[0]);
+    sym[1] = interp_symbol(interp, "define");
+    interp_pin(interp, sym[1]);
+    sym[2] = interp_symbol(interp, "ints");
+    interp_pin(interp, sym[2]);
+    sym[3] = interp_symbol(interp, "lambda");
+    interp_pin(interp, sym[3]);
+    sym[4] = interp_symbol(interp, "n");
+    interp_pin(interp, sym[4]);
+    sym[5] = interp_symbol(interp, "cons-stream");
+    interp_pin(interp, sym[5]);
+    sym[6] = interp_symbol(interp, "+");
+    interp_pin(interp, sym[6]);
+    sym[7] = interp_symbol(interp, "let");
+    interp_pin(interp, sym[7]);
+    sym[8] = interp_symbol(interp, "loop");
+    interp_pin(interp, sym[8]);
+    sym[9] = interp_symbol(interp, "s");
+    interp_pin(interp, sym[9]);
+    sym[10] = interp_symbol(interp, "stream-map");
+    interp_pin(interp, sym[10]);
+    sym[11] = interp_symbol(interp, "x");
+    interp_pin(interp, sym[11]);
+    sym[12] = interp_symbol(interp, "*");
+    interp_pin(interp, sym[12]);
+    sym[13] = interp_symbol(interp, "i");
+    interp_pin(interp, sym[13]);
+    sym[14] = interp_symbol(interp, "if");
+    interp_pin(interp, sym[14]);
+    sym[15] = interp_symbol(interp, "<");
+    interp_pin(interp, sym[15]);
+    sym[16] = interp_symbol(interp, "stream-cdr");
+    interp_pin(interp, sym[16]);
+    sym[17] = interp_symbol(interp, "stream-car");
+    interp_pin(interp, sym[17]);
+    sym[18] = interp_symbol(interp, "stream-filter");
+    interp_pin(interp, sym[18]);
+    sym[19] = interp_symbol(interp, ">");
+    interp_pin(interp, sym[19]);
+    sym[20] = interp_symbol(interp, "list");
+    interp_pin(interp, sym[20]);
+    {
+        List d0 = VECTOR_INIT();
+        Exp e1;
+        e1 = sym[1];
+        list_add(interp, &d0, e1);
+        Exp e2;
+        e2 = sym[2];
+        list_add(interp, &d0, e2);
+        Exp e3;
+        {
+            List d4 = VECTOR_INIT();
+            Exp e5;
+            e5 = sym[3];
+            list_add(interp, &d4, e5);
+            Exp e6;
+            {
+                List d7 = VECTOR_INIT();
+                Exp e8;
+                e8 = sym[4];
+                list_add(interp, &d7, e8);
+                e6 = mklist(interp, d7);
+            }
+            list_add(interp, &d4, e6);
+            Exp e9;
+            {
+                List d10 = VECTOR_INIT();
+                Exp e11;
+                e11 = sym[5];
+                list_add(interp, &d10, e11);
+                Exp e12;
+                e12 = sym[4];
+                list_add(interp, &d10, e12);
+                Exp e13;
+                {
+                    List d14 = VECTOR_INIT();
+                    Exp e15;
+                    e15 = sym[2];
+                    list_add(interp, &d14, e15);
+                    Exp e16;
+                    {
+                        List d17 = VECTOR_INIT();
+                        Exp e18;
+                        e18 = sym[6];
+                        list_add(interp, &d17, e18);
+                        Exp e19;
+                        e19 = sym[4];
+                        list_add(interp, &d17, e19);
+                        Exp e20;
+                        e20 = mknum(1.0);
+                        list_add(interp, &d17, e20);
+                        e16 = mklist(interp, d17);
+                    }
+                    list_add(interp, &d14, e16);
+                    e13 = mklist(interp, d14);
+                }
+                list_add(interp, &d10, e13);
+                e9 = mklist(interp, d10);
+            }
+            list_add(interp, &d4, e9);
+            e3 = mklist(interp, d4);
+        }
+        list_add(interp, &d0, e3);
+        lit[0] = mklist(interp, d0);
+    }
+    interp_pin(interp, lit[0]);
+    {
+        List d21 = VECTOR_INIT();
+        Exp e22;
+        e22 = sym[7];
+        list_add(interp, &d21, e22);
+        Exp e23;
+        e23 = sym[8];
+        list_add(interp, &d21, e23);
+        Exp e24;
+        {
+            List d25 = VECTOR_INIT();
+            Exp e26;
+            {
+                List d27 = VECTOR_INIT();
+                Exp e28;
+                e28 = sym[9];
+                list_add(interp, &d27, e28);
+                Exp e29;
+                {
+                    List d30 = VECTOR_INIT();
+                    Exp e31;
+                    e31 = sym[10];
+                    list_add(interp, &d30, e31);
+                    Exp e32;
+                    {
+                        List d33 = VECTOR_INIT();
+                        Exp e34;
+                        e34 = sym[3];
+                        list_add(interp, &d33, e34);
+                        Exp e35;
+                        {
+                            List d36 = VECTOR_INIT();
+                            Exp e37;
+                            e37 = sym[11];
+                            list_add(interp, &d36, e37);
+                            e35 = mklist(interp, d36);
+                        }
+                        list_add(interp, &d33, e35);
+                        Exp e38;
+                        {
+                            List d39 = VECTOR_INIT();
+                            Exp e40;
+                            e40 = sym[12];
+                            list_add(interp, &d39, e40);
+                            Exp e41;
+                            e41 = mknum(2.0);
+                            list_add(interp, &d39, e41);
+                            Exp e42;
+                            e42 = sym[11];
+                            list_add(interp, &d39, e42);
+                            e38 = mklist(interp, d39);
+                        }
+                        list_add(interp, &d33, e38);
+                        e32 = mklist(interp, d33);
+                    }
+                    list_add(interp, &d30, e32);
+                    Exp e43;
+                    {
+                        List d44 = VECTOR_INIT();
+                        Exp e45;
+                        e45 = sym[2];
+                        list_add(interp, &d44, e45);
+                        Exp e46;
+                        e46 = mknum(0.0);
+                        list_add(interp, &d44, e46);
+                        e43 = mklist(interp, d44);
+                    }
+                    list_add(interp, &d30, e43);
+                    e29 = mklist(interp, d30);
+                }
+                list_add(interp, &d27, e29);
+                e26 = mklist(interp, d27);
+            }
+            list_add(interp, &d25, e26);
+            Exp e47;
+            {
+                List d48 = VECTOR_INIT();
+                Exp e49;
+                e49 = sym[13];
+                list_add(interp, &d48, e49);
+                Exp e50;
+                e50 = mknum(0.0);
+                list_add(interp, &d48, e50);
+                e47 = mklist(interp, d48);
+            }
+            list_add(interp, &d25, e47);
+            e24 = mklist(interp, d25);
+        }
+        list_add(interp, &d21, e24);
+        Exp e51;
+        {
+            List d52 = VECTOR_INIT();
+            Exp e53;
+            e53 = sym[14];
+            list_add(interp, &d52, e53);
+            Exp e54;
+            {
+                List d55 = VECTOR_INIT();
+                Exp e56;
+                e56 = sym[15];
+                list_add(interp, &d55, e56);
+                Exp e57;
+                e57 = sym[13];
+                list_add(interp, &d55, e57);
+                Exp e58;
+                e58 = mknum(1000000.0);
+                list_add(interp, &d55, e58);
+                e54 = mklist(interp, d55);
+            }
+            list_add(interp, &d52, e54);
+            Exp e59;
+            {
+                List d60 = VECTOR_INIT();
+                Exp e61;
+                e61 = sym[8];
+                list_add(interp, &d60, e61);
+                Exp e62;
+                {
+                    List d63 = VECTOR_INIT();
+                    Exp e64;
+                    e64 = sym[16];
+                    list_add(interp, &d63, e64);
+                    Exp e65;
+                    e65 = sym[9];
+                    list_add(interp, &d63, e65);
+                    e62 = mklist(interp, d63);
+                }
+                list_add(interp, &d60, e62);
+                Exp e66;
+                {
+                    List d67 = VECTOR_INIT();
+                    Exp e68;
+                    e68 = sym[6];
+                    list_add(interp, &d67, e68);
+                    Exp e69;
+                    e69 = sym[13];
+                    list_add(interp, &d67, e69);
+                    Exp e70;
+                    e70 = mknum(1.0);
+                    list_add(interp, &d67, e70);
+                    e66 = mklist(interp, d67);
+                }
+                list_add(interp, &d60, e66);
+                e59 = mklist(interp, d60);
+            }
+            list_add(interp, &d52, e59);
+            Exp e71;
+            {
+                List d72 = VECTOR_INIT();
+                Exp e73;
+                e73 = sym[17];
+                list_add(interp, &d72, e73);
+                Exp e74;
+                e74 = sym[9];
+                list_add(interp, &d72, e74);
+                e71 = mklist(interp, d72);
+            }
+            list_add(interp, &d52, e71);
+            e51 = mklist(interp, d52);
+        }
+        list_add(interp, &d21, e51);
+        lit[1] = mklist(interp, d21);
+    }
+    interp_pin(interp, lit[1]);
+    {
+        List d75 = VECTOR_INIT();
+        Exp e76;
+        e76 = sym[7];
+        list_add(interp, &d75, e76);
+        Exp e77;
+        e77 = sym[8];
+        list_add(interp, &d75, e77);
+        Exp e78;
+        {
+            List d79 = VECTOR_INIT();
+            Exp e80;
+            {
+                List d81 = VECTOR_INIT();
+                Exp e82;
+                e82 = sym[9];
+                list_add(interp, &d81, e82);
+                Exp e83;
+                {
+                    List d84 = VECTOR_INIT();
+                    Exp e85;
+                    e85 = sym[18];
+                    list_add(interp, &d84, e85);
+                    Exp e86;
+                    {
+                        List d87 = VECTOR_INIT();
+                        Exp e88;
+                        e88 = sym[3];
+                        list_add(interp, &d87, e88);
+                        Exp e89;
+                        {
+                            List d90 = VECTOR_INIT();
+                            Exp e91;
+                            e91 = sym[11];
+                            list_add(interp, &d90, e91);
+                            e89 = mklist(interp, d90);
+                        }
+                        list_add(interp, &d87, e89);
+                        Exp e92;
+                        {
+                            List d93 = VECTOR_INIT();
+                            Exp e94;
+                            e94 = sym[19];
+                            list_add(interp, &d93, e94);
+                            Exp e95;
+                            e95 = sym[11];
+                            list_add(interp, &d93, e95);
+                            Exp e96;
+                            e96 = mknum(10.0);
+                            list_add(interp, &d93, e96);
+                            e92 = mklist(interp, d93);
+                        }
+                        list_add(interp, &d87, e92);
+                        e86 = mklist(interp, d87);
+                    }
+                    list_add(interp, &d84, e86);
+                    Exp e97;
+                    {
+                        List d98 = VECTOR_INIT();
+                        Exp e99;
+                        e99 = sym[2];
+                        list_add(interp, &d98, e99);
+                        Exp e100;
+                        e100 = mknum(0.0);
+                        list_add(interp, &d98, e100);
+                        e97 = mklist(interp, d98);
+                    }
+                    list_add(interp, &d84, e97);
+                    e83 = mklist(interp, d84);
+                }
+                list_add(interp, &d81, e83);
+                e80 = mklist(interp, d81);
+            }
+            list_add(interp, &d79, e80);
+            Exp e101;
+            {
+                List d102 = VECTOR_INIT();
+                Exp e103;
+                e103 = sym[13];
+                list_add(interp, &d102, e103);
+                Exp e104;
+                e104 = mknum(0.0);
+                list_add(interp, &d102, e104);
+                e101 = mklist(interp, d102);
+            }
+            list_add(interp, &d79, e101);
+            e78 = mklist(interp, d79);
+        }
+        list_add(interp, &d75, e78);
+        Exp e105;
+        {
+            List d106 = VECTOR_INIT();
+            Exp e107;
+            e107 = sym[14];
+            list_add(interp, &d106, e107);
+            Exp e108;
+            {
+                List d109 = VECTOR_INIT();
+                Exp e110;
+                e110 = sym[15];
+                list_add(interp, &d109, e110);
+                Exp e111;
+                e111 = sym[13];
+                list_add(interp, &d109, e111);
+                Exp e112;
+                e112 = mknum(1000000.0);
+                list_add(interp, &d109, e112);
+                e108 = mklist(interp, d109);
+            }
+            list_add(interp, &d106, e108);
+            Exp e113;
+            {
+                List d114 = VECTOR_INIT();
+                Exp e115;
+                e115 = sym[8];
+                list_add(interp, &d114, e115);
+                Exp e116;
+                {
+                    List d117 = VECTOR_INIT();
+                    Exp e118;
+                    e118 = sym[16];
+                    list_add(interp, &d117, e118);
+                    Exp e119;
+                    e119 = sym[9];
+                    list_add(interp, &d117, e119);
+                    e116 = mklist(interp, d117);
+                }
+                list_add(interp, &d114, e116);
+                Exp e120;
+                {
+                    List d121 = VECTOR_INIT();
+                    Exp e122;
+                    e122 = sym[6];
+                    list_add(interp, &d121, e122);
+                    Exp e123;
+                    e123 = sym[13];
+                    list_add(interp, &d121, e123);
+                    Exp e124;
+                    e124 = mknum(1.0);
+                    list_add(interp, &d121, e124);
+                    e120 = mklist(interp, d121);
+                }
+                list_add(interp, &d114, e120);
+                e113 = mklist(interp, d114);
+            }
+            list_add(interp, &d106, e113);
+            Exp e125;
+            {
+                List d126 = VECTOR_INIT();
+                Exp e127;
+                e127 = sym[17];
+                list_add(interp, &d126, e127);
+                Exp e128;
+                e128 = sym[9];
+                list_add(interp, &d126, e128);
+                e125 = mklist(interp, d126);
+            }
+            list_add(interp, &d106, e125);
+            e105 = mklist(interp, d106);
+        }
+        list_add(interp, &d75, e105);
+        lit[2] = mklist(interp, d75);
+    }
+    interp_pin(interp, lit[2]);
+    {
+        List d129 = VECTOR_INIT();
+        Exp e130;
+        e130 = sym[17];
+        list_add(interp, &d129, e130);
+        Exp e131;
+        {
+            List d132 = VECTOR_INIT();
+            Exp e133;
+            e133 = sym[0];
+            list_add(interp, &d132, e133);
+            Exp e134;
+            {
+                List d135 = VECTOR_INIT();
+                Exp e136;
+                e136 = sym[10];
+                list_add(interp, &d135, e136);
+                Exp e137;
+                {
+                    List d138 = VECTOR_INIT();
+                    Exp e139;
+                    e139 = sym[3];
+                    list_add(interp, &d138, e139);
+                    Exp e140;
+                    {
+                        List d141 = VECTOR_INIT();
+                        Exp e142;
+                        e142 = sym[11];
+                        list_add(interp, &d141, e142);
+                        e140 = mklist(interp, d141);
+                    }
+                    list_add(interp, &d138, e140);
+                    Exp e143;
+                    {
+                        List d144 = VECTOR_INIT();
+                        Exp e145;
+                        e145 = sym[12];
+                        list_add(interp, &d144, e145);
+                        Exp e146;
+                        e146 = mknum(2.0);
+                        list_add(interp, &d144, e146);
+                        Exp e147;
+                        e147 = sym[11];
+                        list_add(interp, &d144, e147);
+                        e143 = mklist(interp, d144);
+                    }
+                    list_add(interp, &d138, e143);
+                    e137 = mklist(interp, d138);
+                }
+                list_add(interp, &d135, e137);
+                Exp e148;
+                {
+                    List d149 = VECTOR_INIT();
+                    Exp e150;
+                    e150 = sym[2];
+                    list_add(interp, &d149, e150);
+                    Exp e151;
+                    e151 = mknum(0.0);
+                    list_add(interp, &d149, e151);
+                    e148 = mklist(interp, d149);
+                }
+                list_add(interp, &d135, e148);
+                e134 = mklist(interp, d135);
+            }
+            list_add(interp, &d132, e134);
+            Exp e152;
+            e152 = mknum(2000.0);
+            list_add(interp, &d132, e152);
+            e131 = mklist(interp, d132);
+        }
+        list_add(interp, &d129, e131);
+        lit[3] = mklist(interp, d129);
+    }
+    interp_pin(interp, lit[3]);
+    prim[0] = global_ref(interp, sym[16]).cproc;
+    prim[1] = global_ref(interp, sym[10]).cproc;
+    prim[2] = global_ref(interp, sym[18]).cproc;
+    prim[3] = global_ref(interp, sym[20]).cproc;
+    prim[4] = global_ref(interp, sym[17]).cproc;
+}
+
+static void run(Interp *interp)
+{
+    stack_enter(interp);
+    // (define ints (lambda (n) (cons-stream n (ints (+ n 1)))))
+    eval_form(interp, lit[0]);
+    // (let loop ((s (stream-map (lambda (x) (* 2 x)) (ints 0))) (i 0)) (if (<  ...
+    eval_form(interp, lit[1]);
+    // (let loop ((s (stream-filter (lambda (x) (> x 10)) (ints 0))) (i 0)) (if ...
+    eval_form(interp, lit[2]);
+    // (do ((i 0 (+ i 1)) (l (list) (list i i i))) ((= i 1000000) l))
+    gc_maybe_collect(interp);
+    {
+        List a0 = VECTOR_INIT();
+        Exp v1 = prim[3](interp, a0);
+        double l2 = 0.0;
+        Exp l3 = v1;
+        for (;;) {
+            double v4 = (double) (l2 == 1000000.0);
+            if (v4 != 0) {
+                break;
+            }
+            double v5 = (0.0 + l2 + 1.0);
+            Exp a6_data[] = { mknum(l2), mknum(l2), mknum(l2) };
+            List a6 = { .data = a6_data, .size = 3, .cap = 3 };
+            Exp v7 = prim[3](interp, a6);
+            l2 = v5;
+            l3 = v7;
+        }
+        show(interp, l3);
+    }
+    // (define drop (lambda (s n) (if (= n 0) s (drop (stream-cdr s) (- n 1)))) ...
+    defined[1] = true;
+    interp_define(interp, "drop", mkcproc(proc_1_entry));
+    // (stream-car (drop (stream-map (lambda (x) (* 2 x)) (ints 0)) 2000))
+    eval_form(interp, lit[3]);
+}
+
+int main(void)
+{
+    Interp *interp = interp_new();
+    // forms left to the interpreter were optimized when compiled
+    interp->optimize = false;
+    init(interp);
+    run(interp);
+    interp_free(interp);
+    return 0;
+}
@@ -0,0 +1,752 @@
+// Compiled from tests/streams.scm by scheme -c.
+
+#include "scheme.h"
+#include "gcobject.h"
+#include "ht.h"
+
+#define VOID_EXP ((Exp) { .type = EXP_VOID })
+
+static inline noreturn void undefined(Interp *interp, Exp name)
+{
+    die(interp, "undefined symbol: %s\n", AS_SYM(name));
+}
+
+static inline Exp global_ref(Interp *interp, Exp name)
+{
+    Exp value;
+    if (!ht_lookup(&ENV_HT(interp->global), name, &value)) {
+        undefined(interp, name);
+    }
+    return value;
+}
+
+// Raise a stack overflow past the limit run() set, as proc_call does.
+static inline void check_stack(Interp *interp)
+{
+    if ((uintptr_t) __builtin_frame_address(0) < interp->stack_limit) {
+        stack_overflow(interp);
+    }
+}
+
+static inline Exp proc_ref(Interp *interp, Exp proc)
+{
+    if (!is_proc(proc)) {
+        die(interp, "error: not a procedure\n");
+    }
+    return proc;
+}
+
+static inline Exp call(Interp *interp, Exp proc, List args)
+{
+    return proc.type == EXP_C_PROC ? proc.cproc(interp, args)
+                                   : proc_call(interp, &AS_PROC(proc), args);
+}
+
+// Print the value of a top-level form.
+static inline void show(Interp *interp, Exp val)
+{
+    print_to(interp->out, val);
+    if (val.type != EXP_VOID && val.type != EXP_EMPTY) {
+        writer_putc(interp->out, '\n');
+    }
+}
+
+// Run a form the compiler left to the interpreter.
+static inline void eval_form(Interp *interp, Exp form)
+{
+    Exp val = interp_eval(interp, form);
+    show(interp, val);
+    interp_unpin(interp, val);
+}
+
+static Exp sym[30];
+static Exp lit[9];
+static CProc prim[6];
+
+
+static void init(Interp *interp)
+{
+    sym[0] = interp_symbol(interp, "p");
+    interp_pin(interp, sym[0]);
+    sym[1] = interp_symbol(interp, "outer");
+    interp_pin(interp, sym[1]);
+    sym[2] = interp_symbol(interp, "middle");
+    interp_pin(interp, sym[2]);
+    sym[3] = interp_symbol(interp, "inner");
+    interp_pin(interp, sym[3]);
+    sym[4] = interp_symbol(interp, "q");
+    interp_pin(interp, sym[4]);
+    sym[5] = interp_symbol(interp, "define");
+    interp_pin(interp, sym[5]);
+    sym[6] = interp_symbol(interp, "ints");
+    interp_pin(interp, sym[6]);
+    sym[7] = interp_symbol(interp, "lambda");
+    interp_pin(interp, sym[7]);
+    sym[8] = interp_symbol(interp, "n");
+    interp_pin(interp, sym[8]);
+    sym[9] = interp_symbol(interp, "cons-stream");
+    interp_pin(interp, sym[9]);
+    sym[10] = interp_symbol(interp, "+");
+    interp_pin(interp, sym[10]);
+    sym[11] = interp_symbol(interp, "stream->list");
+    interp_pin(interp, sym[11]);
+    sym[12] = interp_symbol(interp, "stream-take");
+    interp_pin(interp, sym[12]);
+    sym[13] = interp_symbol(interp, "stream-map");
+    interp_pin(interp, sym[13]);
+    sym[14] = interp_symbol(interp, "x");
+    interp_pin(interp, sym[14]);
+    sym[15] = interp_symbol(interp, "*");
+    interp_pin(interp, sym[15]);
+    sym[16] = interp_symbol(interp, "stream-filter");
+    interp_pin(interp, sym[16]);
+    sym[17] = interp_symbol(interp, ">");
+    interp_pin(interp, sym[17]);
+    sym[18] = interp_symbol(interp, "delay");
+    interp_pin(interp, sym[18]);
+    sym[19] = interp_symbol(interp, "begin");
+    interp_pin(interp, sym[19]);
+    sym[20] = interp_symbol(interp, "display");
+    interp_pin(interp, sym[20]);
+    sym[21] = interp_symbol(interp, "quote");
+    interp_pin(interp, sym[21]);
+    sym[22] = interp_symbol(interp, "once");
+    interp_pin(interp, sym[22]);
+    sym[23] = interp_symbol(interp, "newline");
+    interp_pin(interp, sym[23]);
+    sym[24] = interp_symbol(interp, "delay-force");
+    interp_pin(interp, sym[24]);
+    sym[25] = interp_symbol(interp, "set!");
+    interp_pin(interp, sym[25]);
+    sym[26] = interp_symbol(interp, "count");
+    interp_pin(interp, sym[26]);
+    sym[27] = interp_symbol(interp, "if");
+    interp_pin(interp, sym[27]);
+    sym[28] = interp_symbol(interp, "force");
+    interp_pin(interp, sym[28]);
+    sym[29] = interp_symbol(interp, "make-promise");
+    interp_pin(interp, sym[29]);
+    {
+        List d0 = VECTOR_INIT();
+        Exp e1;
+        e1 = sym[5];
+        list_add(interp, &d0, e1);
+        Exp e2;
+        e2 = sym[6];
+        list_add(interp, &d0, e2);
+        Exp e3;
+        {
+            List d4 = VECTOR_INIT();
+            Exp e5;
+            e5 = sym[7];
+            list_add(interp, &d4, e5);
+            Exp e6;
+            {
+                List d7 = VECTOR_INIT();
+                Exp e8;
+                e8 = sym[8];
+                list_add(interp, &d7, e8);
+                e6 = mklist(interp, d7);
+            }
+            list_add(interp, &d4, e6);
+            Exp e9;
+            {
+                List d10 = VECTOR_INIT();
+                Exp e11;
+                e11 = sym[9];
+                list_add(interp, &d10, e11);
+                Exp e12;
+                e12 = sym[8];
+                list_add(interp, &d10, e12);
+                Exp e13;
+                {
+                    List d14 = VECTOR_INIT();
+                    Exp e15;
+                    e15 = sym[6];
+                    list_add(interp, &d14, e15);
+                    Exp e16;
+                    {
+                        List d17 = VECTOR_INIT();
+                        Exp e18;
+                        e18 = sym[10];
+                        list_add(interp, &d17, e18);
+                        Exp e19;
+                        e19 = sym[8];
+                        list_add(interp, &d17, e19);
+                        Exp e20;
+                        e20 = mknum(1.0);
+                        list_add(interp, &d17, e20);
+                        e16 = mklist(interp, d17);
+                    }
+                    list_add(interp, &d14, e16);
+                    e13 = mklist(interp, d14);
+                }
+                list_add(interp, &d10, e13);
+                e9 = mklist(interp, d10);
+            }
+            list_add(interp, &d4, e9);
+            e3 = mklist(interp, d4);
+        }
+        list_add(interp, &d0, e3);
+        lit[0] = mklist(interp, d0);
+    }
+    interp_pin(interp, lit[0]);
+    {
+        List d21 = VECTOR_INIT();
+        Exp e22;
+        e22 = sym[11];
+        list_add(interp, &d21, e22);
+        Exp e23;
+        {
+            List d24 = VECTOR_INIT();
+            Exp e25;
+            e25 = sym[12];
+            list_add(interp, &d24, e25);
+            Exp e26;
+            {
+                List d27 = VECTOR_INIT();
+                Exp e28;
+                e28 = sym[13];
+                list_add(interp, &d27, e28);
+                Exp e29;
+                {
+                    List d30 = VECTOR_INIT();
+                    Exp e31;
+                    e31 = sym[7];
+                    list_add(interp, &d30, e31);
+                    Exp e32;
+                    {
+                        List d33 = VECTOR_INIT();
+                        Exp e34;
+                        e34 = sym[14];
+                        list_add(interp, &d33, e34);
+                        e32 = mklist(interp, d33);
+                    }
+                    list_add(interp, &d30, e32);
+                    Exp e35;
+                    {
+                        List d36 = VECTOR_INIT();
+                        Exp e37;
+                        e37 = sym[15];
+                        list_add(interp, &d36, e37);
+                        Exp e38;
+                        e38 = sym[14];
+                        list_add(interp, &d36, e38);
+                        Exp e39;
+                        e39 = sym[14];
+                        list_add(interp, &d36, e39);
+                        e35 = mklist(interp, d36);
+                    }
+                    list_add(interp, &d30, e35);
+                    e29 = mklist(interp, d30);
+                }
+                list_add(interp, &d27, e29);
+                Exp e40;
+                {
+                    List d41 = VECTOR_INIT();
+                    Exp e42;
+                    e42 = sym[6];
+                    list_add(interp, &d41, e42);
+                    Exp e43;
+                    e43 = mknum(0.0);
+                    list_add(interp, &d41, e43);
+                    e40 = mklist(interp, d41);
+                }
+                list_add(interp, &d27, e40);
+                e26 = mklist(interp, d27);
+            }
+            list_add(interp, &d24, e26);
+            Exp e44;
+            e44 = mknum(5.0);
+            list_add(interp, &d24, e44);
+            e23 = mklist(interp, d24);
+        }
+        list_add(interp, &d21, e23);
+        lit[1] = mklist(interp, d21);
+    }
+    interp_pin(interp, lit[1]);
+    {
+        List d45 = VECTOR_INIT();
+        Exp e46;
+        e46 = sym[11];
+        list_add(interp, &d45, e46);
+        Exp e47;
+        {
+            List d48 = VECTOR_INIT();
+            Exp e49;
+            e49 = sym[12];
+            list_add(interp, &d48, e49);
+            Exp e50;
+            {
+                List d51 = VECTOR_INIT();
+                Exp e52;
+                e52 = sym[16];
+                list_add(interp, &d51, e52);
+                Exp e53;
+                {
+                    List d54 = VECTOR_INIT();
+                    Exp e55;
+                    e55 = sym[7];
+                    list_add(interp, &d54, e55);
+                    Exp e56;
+                    {
+                        List d57 = VECTOR_INIT();
+                        Exp e58;
+                        e58 = sym[14];
+                        list_add(interp, &d57, e58);
+                        e56 = mklist(interp, d57);
+                    }
+                    list_add(interp, &d54, e56);
+                    Exp e59;
+                    {
+                        List d60 = VECTOR_INIT();
+                        Exp e61;
+                        e61 = sym[17];
+                        list_add(interp, &d60, e61);
+                        Exp e62;
+                        e62 = sym[14];
+                        list_add(interp, &d60, e62);
+                        Exp e63;
+                        e63 = mknum(3.0);
+                        list_add(interp, &d60, e63);
+                        e59 = mklist(interp, d60);
+                    }
+                    list_add(interp, &d54, e59);
+                    e53 = mklist(interp, d54);
+                }
+                list_add(interp, &d51, e53);
+                Exp e64;
+                {
+                    List d65 = VECTOR_INIT();
+                    Exp e66;
+                    e66 = sym[6];
+                    list_add(interp, &d65, e66);
+                    Exp e67;
+                    e67 = mknum(1.0);
+                    list_add(interp, &d65, e67);
+                    e64 = mklist(interp, d65);
+                }
+                list_add(interp, &d51, e64);
+                e50 = mklist(interp, d51);
+            }
+            list_add(interp, &d48, e50);
+            Exp e68;
+            e68 = mknum(3.0);
+            list_add(interp, &d48, e68);
+            e47 = mklist(interp, d48);
+        }
+        list_add(interp, &d45, e47);
+        lit[2] = mklist(interp, d45);
+    }
+    interp_pin(interp, lit[2]);
+    {
+        List d69 = VECTOR_INIT();
+        Exp e70;
+        e70 = sym[5];
+        list_add(interp, &d69, e70);
+        Exp e71;
+        e71 = sym[0];
+        list_add(interp, &d69, e71);
+        Exp e72;
+        {
+            List d73 = VECTOR_INIT();
+            Exp e74;
+            e74 = sym[18];
+            list_add(interp, &d73, e74);
+            Exp e75;
+            {
+                List d76 = VECTOR_INIT();
+                Exp e77;
+                e77 = sym[19];
+                list_add(interp, &d76, e77);
+                Exp e78;
+                {
+                    List d79 = VECTOR_INIT();
+                    Exp e80;
+                    e80 = sym[20];
+                    list_add(interp, &d79, e80);
+                    Exp e81;
+                    {
+                        List d82 = VECTOR_INIT();
+                        Exp e83;
+                        e83 = sym[21];
+                        list_add(interp, &d82, e83);
+                        Exp e84;
+                        e84 = sym[22];
+                        list_add(interp, &d82, e84);
+                        e81 = mklist(interp, d82);
+                    }
+                    list_add(interp, &d79, e81);
+                    e78 = mklist(interp, d79);
+                }
+                list_add(interp, &d76, e78);
+                Exp e85;
+                {
+                    List d86 = VECTOR_INIT();
+                    Exp e87;
+                    e87 = sym[23];
+                    list_add(interp, &d86, e87);
+                    e85 = mklist(interp, d86);
+                }
+                list_add(interp, &d76, e85);
+                Exp e88;
+                e88 = mknum(42.0);
+                list_add(interp, &d76, e88);
+                e75 = mklist(interp, d76);
+            }
+            list_add(interp, &d73, e75);
+            e72 = mklist(interp, d73);
+        }
+        list_add(interp, &d69, e72);
+        lit[3] = mklist(interp, d69);
+    }
+    interp_pin(interp, lit[3]);
+    {
+        List d89 = VECTOR_INIT();
+        Exp e90;
+        e90 = sym[5];
+        list_add(interp, &d89, e90);
+        Exp e91;
+        e91 = sym[3];
+        list_add(interp, &d89, e91);
+        Exp e92;
+        {
+            List d93 = VECTOR_INIT();
+            Exp e94;
+            e94 = sym[18];
+            list_add(interp, &d93, e94);
+            Exp e95;
+            {
+                List d96 = VECTOR_INIT();
+                Exp e97;
+                e97 = sym[19];
+                list_add(interp, &d96, e97);
+                Exp e98;
+                {
+                    List d99 = VECTOR_INIT();
+                    Exp e100;
+                    e100 = sym[20];
+                    list_add(interp, &d99, e100);
+                    Exp e101;
+                    {
+                        List d102 = VECTOR_INIT();
+                        Exp e103;
+                        e103 = sym[21];
+                        list_add(interp, &d102, e103);
+                        Exp e104;
+                        e104 = sym[3];
+                        list_add(interp, &d102, e104);
+                        e101 = mklist(interp, d102);
+                    }
+                    list_add(interp, &d99, e101);
+                    e98 = mklist(interp, d99);
+                }
+                list_add(interp, &d96, e98);
+                Exp e105;
+                {
+                    List d106 = VECTOR_INIT();
+                    Exp e107;
+                    e107 = sym[23];
+                    list_add(interp, &d106, e107);
+                    e105 = mklist(interp, d106);
+                }
+                list_add(interp, &d96, e105);
+                Exp e108;
+                e108 = mknum(1.0);
+                list_add(interp, &d96, e108);
+                e95 = mklist(interp, d96);
+            }
+            list_add(interp, &d93, e95);
+            e92 = mklist(interp, d93);
+        }
+        list_add(interp, &d89, e92);
+        lit[4] = mklist(interp, d89);
+    }
+    interp_pin(interp, lit[4]);
+    {
+        List d109 = VECTOR_INIT();
+        Exp e110;
+        e110 = sym[5];
+        list_add(interp, &d109, e110);
+        Exp e111;
+        e111 = sym[2];
+        list_add(interp, &d109, e111);
+        Exp e112;
+        {
+            List d113 = VECTOR_INIT();
+            Exp e114;
+            e114 = sym[24];
+            list_add(interp, &d113, e114);
+            Exp e115;
+            e115 = sym[3];
+            list_add(interp, &d113, e115);
+            e112 = mklist(interp, d113);
+        }
+        list_add(interp, &d109, e112);
+        lit[5] = mklist(interp, d109);
+    }
+    interp_pin(interp, lit[5]);
+    {
+        List d116 = VECTOR_INIT();
+        Exp e117;
+        e117 = sym[5];
+        list_add(interp, &d116, e117);
+        Exp e118;
+        e118 = sym[1];
+        list_add(interp, &d116, e118);
+        Exp e119;
+        {
+            List d120 = VECTOR_INIT();
+            Exp e121;
+            e121 = sym[24];
+            list_add(interp, &d120, e121);
+            Exp e122;
+            e122 = sym[2];
+            list_add(interp, &d120, e122);
+            e119 = mklist(interp, d120);
+        }
+        list_add(interp, &d116, e119);
+        lit[6] = mklist(interp, d116);
+    }
+    interp_pin(interp, lit[6]);
+    {
+        List d123 = VECTOR_INIT();
+        Exp e124;
+        e124 = sym[5];
+        list_add(interp, &d123, e124);
+        Exp e125;
+        e125 = sym[4];
+        list_add(interp, &d123, e125);
+        Exp e126;
+        {
+            List d127 = VECTOR_INIT();
+            Exp e128;
+            e128 = sym[18];
+            list_add(interp, &d127, e128);
+            Exp e129;
+            {
+                List d130 = VECTOR_INIT();
+                Exp e131;
+                e131 = sym[19];
+                list_add(interp, &d130, e131);
+                Exp e132;
+                {
+                    List d133 = VECTOR_INIT();
+                    Exp e134;
+                    e134 = sym[25];
+                    list_add(interp, &d133, e134);
+                    Exp e135;
+                    e135 = sym[26];
+                    list_add(interp, &d133, e135);
+                    Exp e136;
+                    {
+                        List d137 = VECTOR_INIT();
+                        Exp e138;
+                        e138 = sym[10];
+                        list_add(interp, &d137, e138);
+                        Exp e139;
+                        e139 = sym[26];
+                        list_add(interp, &d137, e139);
+                        Exp e140;
+                        e140 = mknum(1.0);
+                        list_add(interp, &d137, e140);
+                        e136 = mklist(interp, d137);
+                    }
+                    list_add(interp, &d133, e136);
+                    e132 = mklist(interp, d133);
+                }
+                list_add(interp, &d130, e132);
+                Exp e141;
+                {
+                    List d142 = VECTOR_INIT();
+                    Exp e143;
+                    e143 = sym[27];
+                    list_add(interp, &d142, e143);
+                    Exp e144;
+                    {
+                        List d145 = VECTOR_INIT();
+                        Exp e146;
+                        e146 = sym[17];
+                        list_add(interp, &d145, e146);
+                        Exp e147;
+                        e147 = sym[26];
+                        list_add(interp, &d145, e147);
+                        Exp e148;
+                        e148 = mknum(5.0);
+                        list_add(interp, &d145, e148);
+                        e144 = mklist(interp, d145);
+                    }
+                    list_add(interp, &d142, e144);
+                    Exp e149;
+                    e149 = sym[26];
+                    list_add(interp, &d142, e149);
+                    Exp e150;
+                    {
+                        List d151 = VECTOR_INIT();
+                        Exp e152;
+                        e152 = sym[28];
+                        list_add(interp, &d151, e152);
+                        Exp e153;
+                        e153 = sym[4];
+                        list_add(interp, &d151, e153);
+                        e150 = mklist(interp, d151);
+                    }
+                    list_add(interp, &d142, e150);
+                    e141 = mklist(interp, d142);
+                }
+                list_add(interp, &d130, e141);
+                e129 = mklist(interp, d130);
+            }
+            list_add(interp, &d127, e129);
+            e126 = mklist(interp, d127);
+        }
+        list_add(interp, &d123, e126);
+        lit[7] = mklist(interp, d123);
+    }
+    interp_pin(interp, lit[7]);
+    {
+        List d154 = VECTOR_INIT();
+        Exp e155;
+        e155 = sym[19];
+        list_add(interp, &d154, e155);
+        Exp e156;
+        {
+            List d157 = VECTOR_INIT();
+            Exp e158;
+            e158 = sym[25];
+            list_add(interp, &d157, e158);
+            Exp e159;
+            e159 = sym[26];
+            list_add(interp, &d157, e159);
+            Exp e160;
+            e160 = mknum(10.0);
+            list_add(interp, &d157, e160);
+            e156 = mklist(interp, d157);
+        }
+        list_add(interp, &d154, e156);
+        Exp e161;
+        {
+            List d162 = VECTOR_INIT();
+            Exp e163;
+            e163 = sym[28];
+            list_add(interp, &d162, e163);
+            Exp e164;
+            e164 = sym[4];
+            list_add(interp, &d162, e164);
+            e161 = mklist(interp, d162);
+        }
+        list_add(interp, &d154, e161);
+        lit[8] = mklist(interp, d154);
+    }
+    interp_pin(interp, lit[8]);
+    prim[0] = global_ref(interp, sym[13]).cproc;
+    prim[1] = global_ref(interp, sym[12]).cproc;
+    prim[2] = global_ref(interp, sym[11]).cproc;
+    prim[3] = global_ref(interp, sym[16]).cproc;
+    prim[4] = global_ref(interp, sym[28]).cproc;
+    prim[5] = global_ref(interp, sym[29]).cproc;
+}
+
+static void run(Interp *interp)
+{
+    stack_enter(interp);
+    // (define ints (lambda (n) (cons-stream n (ints (+ n 1)))))
+    eval_form(interp, lit[0]);
+    // (stream->list (stream-take (stream-map (lambda (x) (* x x)) (ints 0)) 5) ...
+    eval_form(interp, lit[1]);
+    // (stream->list (stream-take (stream-filter (lambda (x) (> x 3)) (ints 1)) ...
+    eval_form(interp, lit[2]);
+    // (define p (delay (begin (display (quote once)) (newline) 42)))
+    eval_form(interp, lit[3]);
+    // (force p)
+    gc_maybe_collect(interp);
+    {
+        Exp v0 = global_ref(interp, sym[0]);
+        Exp a1_data[] = { v0 };
+        List a1 = { .data = a1_data, .size = 1, .cap = 1 };
+        Exp v2 = prim[4](interp, a1);
+        show(interp, v2);
+    }
+    // (force p)
+    gc_maybe_collect(interp);
+    {
+        Exp v0 = global_ref(interp, sym[0]);
+        Exp a1_data[] = { v0 };
+        List a1 = { .data = a1_data, .size = 1, .cap = 1 };
+        Exp v2 = prim[4](interp, a1);
+        show(interp, v2);
+    }
+    // (force (make-promise 7))
+    gc_maybe_collect(interp);
+    {
+        Exp a0_data[] = { mknum(7.0) };
+        List a0 = { .data = a0_data, .size = 1, .cap = 1 };
+        Exp v1 = prim[5](interp, a0);
+        Exp a2_data[] = { v1 };
+        List a2 = { .data = a2_data, .size = 1, .cap = 1 };
+        Exp v3 = prim[4](interp, a2);
+        show(interp, v3);
+    }
+    // (define inner (delay (begin (display (quote inner)) (newline) 1)))
+    eval_form(interp, lit[4]);
+    // (define middle (delay-force inner))
+    eval_form(interp, lit[5]);
+    // (define outer (delay-force middle))
+    eval_form(interp, lit[6]);
+    // (force outer)
+    gc_maybe_collect(interp);
+    {
+        Exp v0 = global_ref(interp, sym[1]);
+        Exp a1_data[] = { v0 };
+        List a1 = { .data = a1_data, .size = 1, .cap = 1 };
+        Exp v2 = prim[4](interp, a1);
+        show(interp, v2);
+    }
+    // (force middle)
+    gc_maybe_collect(interp);
+    {
+        Exp v0 = global_ref(interp, sym[2]);
+        Exp a1_data[] = { v0 };
+        List a1 = { .data = a1_data, .size = 1, .cap = 1 };
+        Exp v2 = prim[4](interp, a1);
+        show(interp, v2);
+    }
+    // (force inner)
+    gc_maybe_collect(interp);
+    {
+        Exp v0 = global_ref(interp, sym[3]);
+        Exp a1_data[] = { v0 };
+        List a1 = { .data = a1_data, .size = 1, .cap = 1 };
+        Exp v2 = prim[4](interp, a1);
+        show(interp, v2);
+    }
+    // (define count 0)
+    gc_maybe_collect(interp);
+    {
+        interp_define(interp, "count", mknum(0.0));
+    }
+    // (define q (delay (begin (set! count (+ count 1)) (if (> count 5) count ( ...
+    eval_form(interp, lit[7]);
+    // (force q)
+    gc_maybe_collect(interp);
+    {
+        Exp v0 = global_ref(interp, sym[4]);
+        Exp a1_data[] = { v0 };
+        List a1 = { .data = a1_data, .size = 1, .cap = 1 };
+        Exp v2 = prim[4](interp, a1);
+        show(interp, v2);
+    }
+    // (begin (set! count 10) (force q))
+    eval_form(interp, lit[8]);
+}
+
+int main(void)
+{
+    Interp *interp = interp_new();
+    // forms left to the interpreter were optimized when compiled
+    interp->optimize = false;
+    init(interp);
+    run(interp);
+    interp_free(interp);
+    return 0;
+}
@@ -0,0 +1,1028 @@
+// Compiled from /tmp/aot/t1.scm by scheme -c.
+
+#include "scheme.h"
+#include "gcobject.h"
+#include "ht.h"
+
+#define VOID_EXP ((Exp) { .type = EXP_VOID })
+
+static inline noreturn void undefined(Interp *interp, Exp name)
+{
+    die(interp, "undefined symbol: %s\n", AS_SYM(name));
+}
+
+static inline Exp global_ref(Interp *interp, Exp name)
+{
+    Exp value;
+    if (!ht_lookup(&ENV_HT(interp->global), name, &value)) {
+        undefined(interp, name);
+    }
+    return value;
+}
+
+static inline Exp proc_ref(Interp *interp, Exp proc)
+{
+    if (!is_proc(proc)) {
+        die(interp, "error: not a procedure\n");
+    }
+    return proc;
+}
+
+static inline Exp call(Interp *interp, Exp proc, List args)
+{
+    return proc.type == EXP_C_PROC ? proc.cproc(interp, args)
+                                   : proc_call(interp, &AS_PROC(proc), args);
+}
+
+// Print the value of a top-level form.
+static inline void show(Interp *interp, Exp val)
+{
+    print_to(interp->out, val);
+    if (val.type != EXP_VOID && val.type != EXP_EMPTY) {
+        writer_putc(interp->out, '\n');
+    }
+}
+
+// Run a form the compiler left to the interpreter.
+static inline void eval_form(Interp *interp, Exp form)
+{
+    Exp val = interp_eval(interp, form);
+    show(interp, val);
+    interp_unpin(interp, val);
+}
+
+static Exp sym[35];
+static Exp lit[18];
+static CProc prim[5];
+static bool defined[12];
+
+static double proc_0_num(Interp *interp, double p0);
+static Exp proc_0(Interp *interp, Exp p0);
+static double proc_1_num(Interp *interp, double p0);
+static Exp proc_1(Interp *interp, Exp p0);
+static Exp proc_2(Interp *interp, Exp p0);
+static Exp proc_3(Interp *interp, Exp p0);
+static Exp proc_4(Interp *interp, Exp p0, Exp p1);
+static Exp proc_5(Interp *interp, Exp p0, Exp p1);
+static Exp proc_6(Interp *interp, Exp p0);
+static Exp proc_7(Interp *interp, Exp p0);
+static Exp proc_8(Interp *interp, Exp p0);
+static double proc_10_num(Interp *interp, double p0);
+static Exp proc_10(Interp *interp, Exp p0);
+static Exp proc_11(Interp *interp, Exp p0);
+
+// sq
+static double proc_0_num(Interp *interp, double p0)
+{
+    double v2 = (1.0 * p0 * p0);
+    return v2;
+}
+
+// sq
+static Exp proc_0(Interp *interp, Exp p0)
+{
+    if (is_number(p0)) {
+        return mknum(proc_0_num(interp, p0.number));
+    }
+    Exp a2_data[] = { p0, p0 };
+    List a2 = { .data = a2_data, .size = 2, .cap = 2 };
+    double v3 = scheme_mul(interp, a2).number;
+    return mknum(v3);
+}
+
+static Exp proc_0_entry(Interp *interp, List args)
+{
+    if (args.size != 1) {
+        die(interp, "%s: arity mismatch\n", "sq");
+    }
+    return proc_0(interp, args.data[0]);
+}
+
+// sum-to
+static double proc_1_num(Interp *interp, double p0)
+{
+    double l4 = 0.0;
+    double l5 = 0.0;
+    double v10;
+    loop2:;
+    double v6 = (double) (l4 > p0);
+    double v9;
+    if (v6 != 0) {
+        v9 = l5;
+    } else {
+        double v7 = (0.0 + l4 + 1.0);
+        double v8 = (0.0 + l5 + l4);
+        l4 = v7;
+        l5 = v8;
+        goto loop2;
+    }
+    v10 = v9;
+    return v10;
+}
+
+// sum-to
+static Exp proc_1(Interp *interp, Exp p0)
+{
+    if (is_number(p0)) {
+        return mknum(proc_1_num(interp, p0.number));
+    }
+    double l4 = 0.0;
+    double l5 = 0.0;
+    double v11;
+    loop2:;
+    Exp a6_data[] = { mknum(l4), p0 };
+    List a6 = { .data = a6_data, .size = 2, .cap = 2 };
+    double v7 = scheme_gt(interp, a6).number;
+    double v10;
+    if (v7 != 0) {
+        v10 = l5;
+    } else {
+        double v8 = (0.0 + l4 + 1.0);
+        double v9 = (0.0 + l5 + l4);
+        l4 = v8;
+        l5 = v9;
+        goto loop2;
+    }
+    v11 = v10;
+    return mknum(v11);
+}
+
+static Exp proc_1_entry(Interp *interp, List args)
+{
+    if (args.size != 1) {
+        die(interp, "%s: arity mismatch\n", "sum-to");
+    }
+    return proc_1(interp, args.data[0]);
+}
+
+// count-do
+static Exp proc_2(Interp *interp, Exp p0)
+{
+    double l2 = 0.0;
+    Exp l3 = lit[8];
+    for (;;) {
+        Exp a4_data[] = { mknum(l2), p0 };
+        List a4 = { .data = a4_data, .size = 2, .cap = 2 };
+        double v5 = scheme_eq(interp, a4).number;
+        if (v5 != 0) {
+            break;
+        }
+        double v6 = (0.0 + l2 + 1.0);
+        Exp a7_data[] = { mknum(l2), l3 };
+        List a7 = { .data = a7_data, .size = 2, .cap = 2 };
+        Exp v8 = prim[0](interp, a7);
+        l2 = v6;
+        l3 = v8;
+    }
+    return l3;
+}
+
+static Exp proc_2_entry(Interp *interp, List args)
+{
+    if (args.size != 1) {
+        die(interp, "%s: arity mismatch\n", "count-do");
+    }
+    return proc_2(interp, args.data[0]);
+}
+
+// classify
+static Exp proc_3(Interp *interp, Exp p0)
+{
+    Exp a2_data[] = { p0, mknum(0.0) };
+    List a2 = { .data = a2_data, .size = 2, .cap = 2 };
+    double v3 = scheme_lt(interp, a2).number;
+    Exp v7;
+    if (v3 != 0) {
+        v7 = lit[9];
+    } else {
+        Exp a4_data[] = { p0, mknum(0.0) };
+        List a4 = { .data = a4_data, .size = 2, .cap = 2 };
+        double v5 = scheme_eq(interp, a4).number;
+        Exp v6;
+        if (v5 != 0) {
+            v6 = lit[10];
+        } else {
+            v6 = lit[11];
+        }
+        v7 = v6;
+    }
+    return v7;
+}
+
+static Exp proc_3_entry(Interp *interp, List args)
+{
+    if (args.size != 1) {
+        die(interp, "%s: arity mismatch\n", "classify");
+    }
+    return proc_3(interp, args.data[0]);
+}
+
+// both
+static Exp proc_4(Interp *interp, Exp p0, Exp p1)
+{
+    Exp v3;
+    if (is_true(p0)) {
+        v3 = p1;
+    } else {
+        v3 = p0;
+    }
+    return v3;
+}
+
+static Exp proc_4_entry(Interp *interp, List args)
+{
+    if (args.size != 2) {
+        die(interp, "%s: arity mismatch\n", "both");
+    }
+    return proc_4(interp, args.data[0], args.data[1]);
+}
+
+// either
+static Exp proc_5(Interp *interp, Exp p0, Exp p1)
+{
+    Exp v3;
+    if (is_true(p0)) {
+        v3 = p0;
+    } else {
+        v3 = p1;
+    }
+    return v3;
+}
+
+static Exp proc_5_entry(Interp *interp, List args)
+{
+    if (args.size != 2) {
+        die(interp, "%s: arity mismatch\n", "either");
+    }
+    return proc_5(interp, args.data[0], args.data[1]);
+}
+
+// w
+static Exp proc_6(Interp *interp, Exp p0)
+{
+    Exp a2_data[] = { p0, mknum(1.0) };
+    List a2 = { .data = a2_data, .size = 2, .cap = 2 };
+    double v3 = scheme_gt(interp, a2).number;
+    Exp v8;
+    if (v3 != 0) {
+        Exp a4_data[] = { p0 };
+        List a4 = { .data = a4_data, .size = 1, .cap = 1 };
+        Exp v5 = prim[1](interp, a4);
+        (void) v5;
+        List a6 = VECTOR_INIT();
+        Exp v7 = prim[2](interp, a6);
+        (void) v7;
+        v8 = p0;
+    } else {
+        v8 = VOID_EXP;
+    }
+    return v8;
+}
+
+static Exp proc_6_entry(Interp *interp, List args)
+{
+    if (args.size != 1) {
+        die(interp, "%s: arity mismatch\n", "w");
+    }
+    return proc_6(interp, args.data[0]);
+}
+
+// u
+static Exp proc_7(Interp *interp, Exp p0)
+{
+    Exp a2_data[] = { p0, mknum(1.0) };
+    List a2 = { .data = a2_data, .size = 2, .cap = 2 };
+    double v3 = scheme_gt(interp, a2).number;
+    Exp v4;
+    if (!(v3 != 0)) {
+        v4 = mknum(42.0);
+    } else {
+        v4 = VOID_EXP;
+    }
+    return v4;
+}
+
+static Exp proc_7_entry(Interp *interp, List args)
+{
+    if (args.size != 1) {
+        die(interp, "%s: arity mismatch\n", "u");
+    }
+    return proc_7(interp, args.data[0]);
+}
+
+// st
+static Exp proc_8(Interp *interp, Exp p0)
+{
+    Exp l2 = p0;
+    Exp a3_data[] = { l2, mknum(2.0) };
+    List a3 = { .data = a3_data, .size = 2, .cap = 2 };
+    double v4 = scheme_mul(interp, a3).number;
+    double l5 = v4;
+    Exp a6_data[] = { l2, mknum(l5) };
+    List a6 = { .data = a6_data, .size = 2, .cap = 2 };
+    double v7 = scheme_sum(interp, a6).number;
+    l2 = mknum(v7);
+    Exp a8_data[] = { l2, mknum(l5) };
+    List a8 = { .data = a8_data, .size = 2, .cap = 2 };
+    Exp v9 = prim[3](interp, a8);
+    return v9;
+}
+
+static Exp proc_8_entry(Interp *interp, List args)
+{
+    if (args.size != 1) {
+        die(interp, "%s: arity mismatch\n", "st");
+    }
+    return proc_8(interp, args.data[0]);
+}
+
+// later
+static double proc_10_num(Interp *interp, double p0)
+{
+    double v2 = (1.0 * p0 * 10.0);
+    return v2;
+}
+
+// later
+static Exp proc_10(Interp *interp, Exp p0)
+{
+    if (is_number(p0)) {
+        return mknum(proc_10_num(interp, p0.number));
+    }
+    Exp a2_data[] = { p0, mknum(10.0) };
+    List a2 = { .data = a2_data, .size = 2, .cap = 2 };
+    double v3 = scheme_mul(interp, a2).number;
+    return mknum(v3);
+}
+
+static Exp proc_10_entry(Interp *interp, List args)
+{
+    if (args.size != 1) {
+        die(interp, "%s: arity mismatch\n", "later");
+    }
+    return proc_10(interp, args.data[0]);
+}
+
+// useg
+static Exp proc_11(Interp *interp, Exp p0)
+{
+    Exp v2 = global_ref(interp, sym[0]);
+    Exp a3_data[] = { p0, v2 };
+    List a3 = { .data = a3_data, .size = 2, .cap = 2 };
+    double v4 = scheme_sum(interp, a3).number;
+    return mknum(v4);
+}
+
+static Exp proc_11_entry(Interp *interp, List args)
+{
+    if (args.size != 1) {
+        die(interp, "%s: arity mismatch\n", "useg");
+    }
+    return proc_11(interp, args.data[0]);
+}
+
+static void init(Interp *interp)
+{
+    sym[0] = interp_symbol(interp, "g");
+    interp_pin(interp, sym[0]);
+    sym[1] = interp_symbol(interp, "sum-to");
+    interp_pin(interp, sym[1]);
+    sym[2] = interp_symbol(interp, "count-do");
+    interp_pin(interp, sym[2]);
+    sym[3] = interp_symbol(interp, "classify");
+    interp_pin(interp, sym[3]);
+    sym[4] = interp_symbol(interp, "both");
+    interp_pin(interp, sym[4]);
+    sym[5] = interp_symbol(interp, "either");
+    interp_pin(interp, sym[5]);
+    sym[6] = interp_symbol(interp, "w");
+    interp_pin(interp, sym[6]);
+    sym[7] = interp_symbol(interp, "u");
+    interp_pin(interp, sym[7]);
+    sym[8] = interp_symbol(interp, "st");
+    interp_pin(interp, sym[8]);
+    sym[9] = interp_symbol(interp, "sq");
+    interp_pin(interp, sym[9]);
+    sym[10] = interp_symbol(interp, "make-adder");
+    interp_pin(interp, sym[10]);
+    sym[11] = interp_symbol(interp, "sw");
+    interp_pin(interp, sym[11]);
+    sym[12] = interp_symbol(interp, "later");
+    interp_pin(interp, sym[12]);
+    sym[13] = interp_symbol(interp, "useg");
+    interp_pin(interp, sym[13]);
+    sym[14] = interp_symbol(interp, "neg");
+    interp_pin(interp, sym[14]);
+    sym[15] = interp_symbol(interp, "zero");
+    interp_pin(interp, sym[15]);
+    sym[16] = interp_symbol(interp, "pos");
+    interp_pin(interp, sym[16]);
+    sym[17] = interp_symbol(interp, "map");
+    interp_pin(interp, sym[17]);
+    sym[18] = interp_symbol(interp, "lambda");
+    interp_pin(interp, sym[18]);
+    sym[19] = interp_symbol(interp, "x");
+    interp_pin(interp, sym[19]);
+    sym[20] = interp_symbol(interp, "+");
+    interp_pin(interp, sym[20]);
+    sym[21] = interp_symbol(interp, "list");
+    interp_pin(interp, sym[21]);
+    sym[22] = interp_symbol(interp, "define");
+    interp_pin(interp, sym[22]);
+    sym[23] = interp_symbol(interp, "n");
+    interp_pin(interp, sym[23]);
+    sym[24] = interp_symbol(interp, "y");
+    interp_pin(interp, sym[24]);
+    sym[25] = interp_symbol(interp, "let");
+    interp_pin(interp, sym[25]);
+    sym[26] = interp_symbol(interp, "tmp#1");
+    interp_pin(interp, sym[26]);
+    sym[27] = interp_symbol(interp, "set!");
+    interp_pin(interp, sym[27]);
+    sym[28] = interp_symbol(interp, "a");
+    interp_pin(interp, sym[28]);
+    sym[29] = interp_symbol(interp, "\"b\"");
+    interp_pin(interp, sym[29]);
+    sym[30] = interp_symbol(interp, "c");
+    interp_pin(interp, sym[30]);
+    sym[31] = interp_symbol(interp, "d");
+    interp_pin(interp, sym[31]);
+    sym[32] = interp_symbol(interp, "cons");
+    interp_pin(interp, sym[32]);
+    sym[33] = interp_symbol(interp, "display");
+    interp_pin(interp, sym[33]);
+    sym[34] = interp_symbol(interp, "newline");
+    interp_pin(interp, sym[34]);
+    {
+        List d0 = VECTOR_INIT();
+        lit[0] = mklist(interp, d0);
+    }
+    interp_pin(interp, lit[0]);
+    lit[1] = sym[14];
+    interp_pin(interp, lit[1]);
+    lit[2] = sym[15];
+    interp_pin(interp, lit[2]);
+    lit[3] = sym[16];
+    interp_pin(interp, lit[3]);
+    {
+        List d1 = VECTOR_INIT();
+        lit[4] = mklist(interp, d1);
+    }
+    interp_pin(interp, lit[4]);
+    lit[5] = sym[14];
+    interp_pin(interp, lit[5]);
+    lit[6] = sym[15];
+    interp_pin(interp, lit[6]);
+    lit[7] = sym[16];
+    interp_pin(interp, lit[7]);
+    {
+        List d2 = VECTOR_INIT();
+        lit[8] = mklist(interp, d2);
+    }
+    interp_pin(interp, lit[8]);
+    lit[9] = sym[14];
+    interp_pin(interp, lit[9]);
+    lit[10] = sym[15];
+    interp_pin(interp, lit[10]);
+    lit[11] = sym[16];
+    interp_pin(interp, lit[11]);
+    {
+        List d3 = VECTOR_INIT();
+        Exp e4;
+        e4 = sym[17];
+        list_add(interp, &d3, e4);
+        Exp e5;
+        {
+            List d6 = VECTOR_INIT();
+            Exp e7;
+            e7 = sym[18];
+            list_add(interp, &d6, e7);
+            Exp e8;
+            {
+                List d9 = VECTOR_INIT();
+                Exp e10;
+                e10 = sym[19];
+                list_add(interp, &d9, e10);
+                e8 = mklist(interp, d9);
+            }
+            list_add(interp, &d6, e8);
+            Exp e11;
+            {
+                List d12 = VECTOR_INIT();
+                Exp e13;
+                e13 = sym[20];
+                list_add(interp, &d12, e13);
+                Exp e14;
+                e14 = sym[19];
+                list_add(interp, &d12, e14);
+                Exp e15;
+                e15 = mknum(1.0);
+                list_add(interp, &d12, e15);
+                e11 = mklist(interp, d12);
+            }
+            list_add(interp, &d6, e11);
+            e5 = mklist(interp, d6);
+        }
+        list_add(interp, &d3, e5);
+        Exp e16;
+        {
+            List d17 = VECTOR_INIT();
+            Exp e18;
+            e18 = sym[21];
+            list_add(interp, &d17, e18);
+            Exp e19;
+            e19 = mknum(1.0);
+            list_add(interp, &d17, e19);
+            Exp e20;
+            e20 = mknum(2.0);
+            list_add(interp, &d17, e20);
+            Exp e21;
+            e21 = mknum(3.0);
+            list_add(interp, &d17, e21);
+            e16 = mklist(interp, d17);
+        }
+        list_add(interp, &d3, e16);
+        lit[12] = mklist(interp, d3);
+    }
+    interp_pin(interp, lit[12]);
+    {
+        List d22 = VECTOR_INIT();
+        Exp e23;
+        e23 = sym[22];
+        list_add(interp, &d22, e23);
+        Exp e24;
+        e24 = sym[10];
+        list_add(interp, &d22, e24);
+        Exp e25;
+        {
+            List d26 = VECTOR_INIT();
+            Exp e27;
+            e27 = sym[18];
+            list_add(interp, &d26, e27);
+            Exp e28;
+            {
+                List d29 = VECTOR_INIT();
+                Exp e30;
+                e30 = sym[23];
+                list_add(interp, &d29, e30);
+                e28 = mklist(interp, d29);
+            }
+            list_add(interp, &d26, e28);
+            Exp e31;
+            {
+                List d32 = VECTOR_INIT();
+                Exp e33;
+                e33 = sym[18];
+                list_add(interp, &d32, e33);
+                Exp e34;
+                {
+                    List d35 = VECTOR_INIT();
+                    Exp e36;
+                    e36 = sym[19];
+                    list_add(interp, &d35, e36);
+                    e34 = mklist(interp, d35);
+                }
+                list_add(interp, &d32, e34);
+                Exp e37;
+                {
+                    List d38 = VECTOR_INIT();
+                    Exp e39;
+                    e39 = sym[20];
+                    list_add(interp, &d38, e39);
+                    Exp e40;
+                    e40 = sym[19];
+                    list_add(interp, &d38, e40);
+                    Exp e41;
+                    e41 = sym[23];
+                    list_add(interp, &d38, e41);
+                    e37 = mklist(interp, d38);
+                }
+                list_add(interp, &d32, e37);
+                e31 = mklist(interp, d32);
+            }
+            list_add(interp, &d26, e31);
+            e25 = mklist(interp, d26);
+        }
+        list_add(interp, &d22, e25);
+        lit[13] = mklist(interp, d22);
+    }
+    interp_pin(interp, lit[13]);
+    {
+        List d42 = VECTOR_INIT();
+        Exp e43;
+        e43 = sym[22];
+        list_add(interp, &d42, e43);
+        Exp e44;
+        e44 = sym[11];
+        list_add(interp, &d42, e44);
+        Exp e45;
+        {
+            List d46 = VECTOR_INIT();
+            Exp e47;
+            e47 = sym[18];
+            list_add(interp, &d46, e47);
+            Exp e48;
+            {
+                List d49 = VECTOR_INIT();
+                Exp e50;
+                e50 = sym[19];
+                list_add(interp, &d49, e50);
+                Exp e51;
+                e51 = sym[24];
+                list_add(interp, &d49, e51);
+                e48 = mklist(interp, d49);
+            }
+            list_add(interp, &d46, e48);
+            Exp e52;
+            {
+                List d53 = VECTOR_INIT();
+                Exp e54;
+                e54 = sym[25];
+                list_add(interp, &d53, e54);
+                Exp e55;
+                {
+                    List d56 = VECTOR_INIT();
+                    Exp e57;
+                    {
+                        List d58 = VECTOR_INIT();
+                        Exp e59;
+                        e59 = sym[26];
+                        list_add(interp, &d58, e59);
+                        Exp e60;
+                        e60 = sym[19];
+                        list_add(interp, &d58, e60);
+                        e57 = mklist(interp, d58);
+                    }
+                    list_add(interp, &d56, e57);
+                    e55 = mklist(interp, d56);
+                }
+                list_add(interp, &d53, e55);
+                Exp e61;
+                {
+                    List d62 = VECTOR_INIT();
+                    Exp e63;
+                    e63 = sym[27];
+                    list_add(interp, &d62, e63);
+                    Exp e64;
+                    e64 = sym[19];
+                    list_add(interp, &d62, e64);
+                    Exp e65;
+                    e65 = sym[24];
+                    list_add(interp, &d62, e65);
+                    e61 = mklist(interp, d62);
+                }
+                list_add(interp, &d53, e61);
+                Exp e66;
+                {
+                    List d67 = VECTOR_INIT();
+                    Exp e68;
+                    e68 = sym[27];
+                    list_add(interp, &d67, e68);
+                    Exp e69;
+                    e69 = sym[24];
+                    list_add(interp, &d67, e69);
+                    Exp e70;
+                    e70 = sym[26];
+                    list_add(interp, &d67, e70);
+                    e66 = mklist(interp, d67);
+                }
+                list_add(interp, &d53, e66);
+                e52 = mklist(interp, d53);
+            }
+            list_add(interp, &d46, e52);
+            Exp e71;
+            {
+                List d72 = VECTOR_INIT();
+                Exp e73;
+                e73 = sym[21];
+                list_add(interp, &d72, e73);
+                Exp e74;
+                e74 = sym[19];
+                list_add(interp, &d72, e74);
+                Exp e75;
+                e75 = sym[24];
+                list_add(interp, &d72, e75);
+                e71 = mklist(interp, d72);
+            }
+            list_add(interp, &d46, e71);
+            e45 = mklist(interp, d46);
+        }
+        list_add(interp, &d42, e45);
+        lit[14] = mklist(interp, d42);
+    }
+    interp_pin(interp, lit[14]);
+    {
+        List d76 = VECTOR_INIT();
+        Exp e77;
+        e77 = sym[28];
+        list_add(interp, &d76, e77);
+        Exp e78;
+        e78 = sym[29];
+        list_add(interp, &d76, e78);
+        Exp e79;
+        {
+            List d80 = VECTOR_INIT();
+            Exp e81;
+            e81 = sym[30];
+            list_add(interp, &d80, e81);
+            Exp e82;
+            e82 = sym[31];
+            list_add(interp, &d80, e82);
+            e79 = mklist(interp, d80);
+        }
+        list_add(interp, &d76, e79);
+        Exp e83;
+        e83 = mknum(1.0);
+        list_add(interp, &d76, e83);
+        lit[15] = mklist(interp, d76);
+    }
+    interp_pin(interp, lit[15]);
+    {
+        List d84 = VECTOR_INIT();
+        Exp e85;
+        e85 = sym[27];
+        list_add(interp, &d84, e85);
+        Exp e86;
+        e86 = sym[0];
+        list_add(interp, &d84, e86);
+        Exp e87;
+        e87 = mknum(20.0);
+        list_add(interp, &d84, e87);
+        lit[16] = mklist(interp, d84);
+    }
+    interp_pin(interp, lit[16]);
+    lit[17] = sym[28];
+    interp_pin(interp, lit[17]);
+    prim[0] = global_ref(interp, sym[32]).cproc;
+    prim[1] = global_ref(interp, sym[33]).cproc;
+    prim[2] = global_ref(interp, sym[34]).cproc;
+    prim[3] = global_ref(interp, sym[21]).cproc;
+    prim[4] = global_ref(interp, sym[17]).cproc;
+}
+
+static void run(Interp *interp)
+{
+    // (define sq (lambda (x) (* x x)))
+    defined[0] = true;
+    interp_define(interp, "sq", mkcproc(proc_0_entry));
+    // (define sum-to (lambda (n) (let loop ((i 0) (acc 0)) (if (> i n) acc (lo ...
+    defined[1] = true;
+    interp_define(interp, "sum-to", mkcproc(proc_1_entry));
+    // (sum-to 100)
+    gc_maybe_collect(interp);
+    {
+        if (!defined[1]) {
+            undefined(interp, sym[1]);
+        }
+        double v0 = proc_1_num(interp, 100.0);
+        show(interp, mknum(v0));
+    }
+    // (define count-do (lambda (n) (do ((i 0 (+ i 1)) (acc (quote ()) (cons i  ...
+    defined[2] = true;
+    interp_define(interp, "count-do", mkcproc(proc_2_entry));
+    // (count-do 5)
+    gc_maybe_collect(interp);
+    {
+        if (!defined[2]) {
+            undefined(interp, sym[2]);
+        }
+        Exp v0 = proc_2(interp, mknum(5.0));
+        show(interp, v0);
+    }
+    // (define classify (lambda (x) (cond ((< x 0) (quote neg)) ((= x 0) (quote ...
+    defined[3] = true;
+    interp_define(interp, "classify", mkcproc(proc_3_entry));
+    // (list (classify -3) (classify 0) (classify 7))
+    gc_maybe_collect(interp);
+    {
+        if (!defined[3]) {
+            undefined(interp, sym[3]);
+        }
+        Exp v0 = proc_3(interp, mknum(-3.0));
+        if (!defined[3]) {
+            undefined(interp, sym[3]);
+        }
+        Exp v1 = proc_3(interp, mknum(0.0));
+        if (!defined[3]) {
+            undefined(interp, sym[3]);
+        }
+        Exp v2 = proc_3(interp, mknum(7.0));
+        Exp a3_data[] = { v0, v1, v2 };
+        List a3 = { .data = a3_data, .size = 3, .cap = 3 };
+        Exp v4 = prim[3](interp, a3);
+        show(interp, v4);
+    }
+    // (define both (lambda (a b) (and a b)))
+    defined[4] = true;
+    interp_define(interp, "both", mkcproc(proc_4_entry));
+    // (define either (lambda (a b) (or a b)))
+    defined[5] = true;
+    interp_define(interp, "either", mkcproc(proc_5_entry));
+    // (list (both 1 2) (both 0 2) (either 0 3) (either 0 0) (and) (or))
+    gc_maybe_collect(interp);
+    {
+        if (!defined[4]) {
+            undefined(interp, sym[4]);
+        }
+        Exp v0 = proc_4(interp, mknum(1.0), mknum(2.0));
+        if (!defined[4]) {
+            undefined(interp, sym[4]);
+        }
+        Exp v1 = proc_4(interp, mknum(0.0), mknum(2.0));
+        if (!defined[5]) {
+            undefined(interp, sym[5]);
+        }
+        Exp v2 = proc_5(interp, mknum(0.0), mknum(3.0));
+        if (!defined[5]) {
+            undefined(interp, sym[5]);
+        }
+        Exp v3 = proc_5(interp, mknum(0.0), mknum(0.0));
+        Exp a4_data[] = { v0, v1, v2, v3, mknum(1.0), mknum(0.0) };
+        List a4 = { .data = a4_data, .size = 6, .cap = 6 };
+        Exp v5 = prim[3](interp, a4);
+        show(interp, v5);
+    }
+    // (define w (lambda (x) (when (> x 1) (display x) (newline) x)))
+    defined[6] = true;
+    interp_define(interp, "w", mkcproc(proc_6_entry));
+    // (w 5)
+    gc_maybe_collect(interp);
+    {
+        if (!defined[6]) {
+            undefined(interp, sym[6]);
+        }
+        Exp v0 = proc_6(interp, mknum(5.0));
+        show(interp, v0);
+    }
+    // (w 0)
+    gc_maybe_collect(interp);
+    {
+        if (!defined[6]) {
+            undefined(interp, sym[6]);
+        }
+        Exp v0 = proc_6(interp, mknum(0.0));
+        show(interp, v0);
+    }
+    // (define u (lambda (x) (unless (> x 1) 42)))
+    defined[7] = true;
+    interp_define(interp, "u", mkcproc(proc_7_entry));
+    // (list (u 0) (u 5))
+    gc_maybe_collect(interp);
+    {
+        if (!defined[7]) {
+            undefined(interp, sym[7]);
+        }
+        Exp v0 = proc_7(interp, mknum(0.0));
+        if (!defined[7]) {
+            undefined(interp, sym[7]);
+        }
+        Exp v1 = proc_7(interp, mknum(5.0));
+        Exp a2_data[] = { v0, v1 };
+        List a2 = { .data = a2_data, .size = 2, .cap = 2 };
+        Exp v3 = prim[3](interp, a2);
+        show(interp, v3);
+    }
+    // (define st (lambda (n) (let* ((a n) (b (* a 2))) (set! a (+ a b)) (list  ...
+    defined[8] = true;
+    interp_define(interp, "st", mkcproc(proc_8_entry));
+    // (st 4)
+    gc_maybe_collect(interp);
+    {
+        if (!defined[8]) {
+            undefined(interp, sym[8]);
+        }
+        Exp v0 = proc_8(interp, mknum(4.0));
+        show(interp, v0);
+    }
+    // (map sq (list 1 2 3))
+    gc_maybe_collect(interp);
+    {
+        Exp v0 = global_ref(interp, sym[9]);
+        Exp a1_data[] = { mknum(1.0), mknum(2.0), mknum(3.0) };
+        List a1 = { .data = a1_data, .size = 3, .cap = 3 };
+        Exp v2 = prim[3](interp, a1);
+        Exp a3_data[] = { v0, v2 };
+        List a3 = { .data = a3_data, .size = 2, .cap = 2 };
+        Exp v4 = prim[4](interp, a3);
+        show(interp, v4);
+    }
+    // (map (lambda (x) (+ x 1)) (list 1 2 3))
+    eval_form(interp, lit[12]);
+    // (define make-adder (lambda (n) (lambda (x) (+ x n))))
+    eval_form(interp, lit[13]);
+    // ((make-adder 3) 4)
+    gc_maybe_collect(interp);
+    {
+        Exp v0 = global_ref(interp, sym[10]);
+        Exp v1 = proc_ref(interp, v0);
+        Exp a2_data[] = { mknum(3.0) };
+        List a2 = { .data = a2_data, .size = 1, .cap = 1 };
+        Exp v3 = call(interp, v1, a2);
+        Exp v4 = proc_ref(interp, v3);
+        Exp a5_data[] = { mknum(4.0) };
+        List a5 = { .data = a5_data, .size = 1, .cap = 1 };
+        Exp v6 = call(interp, v4, a5);
+        show(interp, v6);
+    }
+    // (define sw (lambda (x y) (let ((tmp#1 x)) (set! x y) (set! y tmp#1)) (li ...
+    eval_form(interp, lit[14]);
+    // (sw 1 2)
+    gc_maybe_collect(interp);
+    {
+        Exp v0 = global_ref(interp, sym[11]);
+        Exp v1 = proc_ref(interp, v0);
+        Exp a2_data[] = { mknum(1.0), mknum(2.0) };
+        List a2 = { .data = a2_data, .size = 2, .cap = 2 };
+        Exp v3 = call(interp, v1, a2);
+        show(interp, v3);
+    }
+    // (quote (a "b" (c d) 1))
+    gc_maybe_collect(interp);
+    {
+        show(interp, lit[15]);
+    }
+    // -0
+    gc_maybe_collect(interp);
+    {
+        show(interp, mknum(-0.0));
+    }
+    // 0
+    gc_maybe_collect(interp);
+    {
+        show(interp, mknum(0.0));
+    }
+    // 1
+    gc_maybe_collect(interp);
+    {
+        show(interp, mknum(1.0));
+    }
+    // (define later (lambda (x) (* x 10)))
+    defined[10] = true;
+    interp_define(interp, "later", mkcproc(proc_10_entry));
+    // (later 3)
+    gc_maybe_collect(interp);
+    {
+        if (!defined[10]) {
+            undefined(interp, sym[12]);
+        }
+        double v0 = proc_10_num(interp, 3.0);
+        show(interp, mknum(v0));
+    }
+    // (define g 10)
+    gc_maybe_collect(interp);
+    {
+        interp_define(interp, "g", mknum(10.0));
+    }
+    // (define useg (lambda (x) (+ x g)))
+    defined[11] = true;
+    interp_define(interp, "useg", mkcproc(proc_11_entry));
+    // (useg 1)
+    gc_maybe_collect(interp);
+    {
+        if (!defined[11]) {
+            undefined(interp, sym[13]);
+        }
+        Exp v0 = proc_11(interp, mknum(1.0));
+        show(interp, v0);
+    }
+    // (set! g 20)
+    eval_form(interp, lit[16]);
+    // (useg 1)
+    gc_maybe_collect(interp);
+    {
+        if (!defined[11]) {
+            undefined(interp, sym[13]);
+        }
+        Exp v0 = proc_11(interp, mknum(1.0));
+        show(interp, v0);
+    }
+    // (sq 1)
+    gc_maybe_collect(interp);
+    {
+        if (!defined[0]) {
+            undefined(interp, sym[9]);
+        }
+        double v0 = proc_0_num(interp, 1.0);
+        show(interp, mknum(v0));
+    }
+    // (sq (quote a))
+    gc_maybe_collect(interp);
+    {
+        if (!defined[0]) {
+            undefined(interp, sym[9]);
+        }
+        Exp v0 = proc_0(interp, lit[17]);
+        show(interp, v0);
+    }
+}
+
+int main(void)
+{
+    Interp *interp = interp_new();
+    // forms left to the interpreter were optimized when compiled
+    interp->optimize = false;
+    init(interp);
+    run(interp);
+    interp_free(interp);
+    return 0;
+}
@@ -0,0 +1,212 @@
+// Compiled from /tmp/aot/t2.scm by scheme -c.
+
+#include "scheme.h"
+#include "gcobject.h"
+#include "ht.h"
+
+#define VOID_EXP ((Exp) { .type = EXP_VOID })
+
+static inline noreturn void undefined(Interp *interp, Exp name)
+{
+    die(interp, "undefined symbol: %s\n", AS_SYM(name));
+}
+
+static inline Exp global_ref(Interp *interp, Exp name)
+{
+    Exp value;
+    if (!ht_lookup(&ENV_HT(interp->global), name, &value)) {
+        undefined(interp, name);
+    }
+    return value;
+}
+
+static inline Exp proc_ref(Interp *interp, Exp proc)
+{
+    if (!is_proc(proc)) {
+        die(interp, "error: not a procedure\n");
+    }
+    return proc;
+}
+
+static inline Exp call(Interp *interp, Exp proc, List args)
+{
+    return proc.type == EXP_C_PROC ? proc.cproc(interp, args)
+                                   : proc_call(interp, &AS_PROC(proc), args);
+}
+
+// Print the value of a top-level form.
+static inline void show(Interp *interp, Exp val)
+{
+    print_to(interp->out, val);
+    if (val.type != EXP_VOID && val.type != EXP_EMPTY) {
+        writer_putc(interp->out, '\n');
+    }
+}
+
+// Run a form the compiler left to the interpreter.
+static inline void eval_form(Interp *interp, Exp form)
+{
+    Exp val = interp_eval(interp, form);
+    show(interp, val);
+    interp_unpin(interp, val);
+}
+
+static Exp sym[4];
+static Exp lit[2];
+static CProc prim[2];
+static bool defined[2];
+
+static double proc_0_num(Interp *interp, double p0);
+static Exp proc_0(Interp *interp, Exp p0);
+static Exp proc_1(Interp *interp, Exp p0);
+
+// sumsq
+static double proc_0_num(Interp *interp, double p0)
+{
+    double l2 = 0.0;
+    double l3 = 0.0;
+    for (;;) {
+        double v4 = (double) (l2 == p0);
+        if (v4 != 0) {
+            break;
+        }
+        double v5 = (0.0 + l2 + 1.0);
+        double v6 = (1.0 * l2 * l2);
+        double v7 = (0.0 + l3 + v6);
+        l2 = v5;
+        l3 = v7;
+    }
+    return l3;
+}
+
+// sumsq
+static Exp proc_0(Interp *interp, Exp p0)
+{
+    if (is_number(p0)) {
+        return mknum(proc_0_num(interp, p0.number));
+    }
+    double l2 = 0.0;
+    double l3 = 0.0;
+    for (;;) {
+        Exp a4_data[] = { mknum(l2), p0 };
+        List a4 = { .data = a4_data, .size = 2, .cap = 2 };
+        double v5 = scheme_eq(interp, a4).number;
+        if (v5 != 0) {
+            break;
+        }
+        double v6 = (0.0 + l2 + 1.0);
+        double v7 = (1.0 * l2 * l2);
+        double v8 = (0.0 + l3 + v7);
+        l2 = v6;
+        l3 = v8;
+    }
+    return mknum(l3);
+}
+
+static Exp proc_0_entry(Interp *interp, List args)
+{
+    if (args.size != 1) {
+        die(interp, "%s: arity mismatch\n", "sumsq");
+    }
+    return proc_0(interp, args.data[0]);
+}
+
+// lst
+static Exp proc_1(Interp *interp, Exp p0)
+{
+    double l4 = 0.0;
+    Exp l5 = lit[1];
+    Exp v14;
+    loop2:;
+    Exp a6_data[] = { mknum(l4), p0 };
+    List a6 = { .data = a6_data, .size = 2, .cap = 2 };
+    double v7 = scheme_eq(interp, a6).number;
+    Exp v13;
+    if (v7 != 0) {
+        Exp a8_data[] = { l5 };
+        List a8 = { .data = a8_data, .size = 1, .cap = 1 };
+        Exp v9 = prim[0](interp, a8);
+        v13 = v9;
+    } else {
+        double v10 = (0.0 + l4 + 1.0);
+        Exp a11_data[] = { mknum(l4), l5 };
+        List a11 = { .data = a11_data, .size = 2, .cap = 2 };
+        Exp v12 = prim[1](interp, a11);
+        l4 = v10;
+        l5 = v12;
+        goto loop2;
+    }
+    v14 = v13;
+    return v14;
+}
+
+static Exp proc_1_entry(Interp *interp, List args)
+{
+    if (args.size != 1) {
+        die(interp, "%s: arity mismatch\n", "lst");
+    }
+    return proc_1(interp, args.data[0]);
+}
+
+static void init(Interp *interp)
+{
+    sym[0] = interp_symbol(interp, "sumsq");
+    interp_pin(interp, sym[0]);
+    sym[1] = interp_symbol(interp, "lst");
+    interp_pin(interp, sym[1]);
+    sym[2] = interp_symbol(interp, "length");
+    interp_pin(interp, sym[2]);
+    sym[3] = interp_symbol(interp, "cons");
+    interp_pin(interp, sym[3]);
+    {
+        List d0 = VECTOR_INIT();
+        lit[0] = mklist(interp, d0);
+    }
+    interp_pin(interp, lit[0]);
+    {
+        List d1 = VECTOR_INIT();
+        lit[1] = mklist(interp, d1);
+    }
+    interp_pin(interp, lit[1]);
+    prim[0] = global_ref(interp, sym[2]).cproc;
+    prim[1] = global_ref(interp, sym[3]).cproc;
+}
+
+static void run(Interp *interp)
+{
+    // (define sumsq (lambda (n) (do ((i 0 (+ i 1)) (s 0 (+ s (* i i)))) ((= i  ...
+    defined[0] = true;
+    interp_define(interp, "sumsq", mkcproc(proc_0_entry));
+    // (sumsq 3000000)
+    gc_maybe_collect(interp);
+    {
+        if (!defined[0]) {
+            undefined(interp, sym[0]);
+        }
+        double v0 = proc_0_num(interp, 3000000.0);
+        show(interp, mknum(v0));
+    }
+    // (define lst (lambda (n) (let loop ((i 0) (acc (quote ()))) (if (= i n) ( ...
+    defined[1] = true;
+    interp_define(interp, "lst", mkcproc(proc_1_entry));
+    // (lst 3000)
+    gc_maybe_collect(interp);
+    {
+        if (!defined[1]) {
+            undefined(interp, sym[1]);
+        }
+        Exp v0 = proc_1(interp, mknum(3000.0));
+        show(interp, v0);
+    }
+}
+
+int main(void)
+{
+    Interp *interp = interp_new();
+    // forms left to the interpreter were optimized when compiled
+    interp->optimize = false;
+    init(interp);
+    run(interp);
+    interp_free(interp);
+    return 0;
+}
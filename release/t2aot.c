@@ -0,0 +1,1206 @@
+// Compiled from /tmp/cl/t2aot.scm by scheme -c.
+
+#include "scheme.h"
+#include "gcobject.h"
+#include "ht.h"
+
+#define VOID_EXP ((Exp) { .type = EXP_VOID })
+
+static inline noreturn void undefined(Interp *interp, Exp name)
+{
+    die(interp, "undefined symbol: %s\n", AS_SYM(name));
+}
+
+static inline Exp global_ref(Interp *interp, Exp name)
+{
+    Exp value;
+    if (!ht_lookup(&ENV_HT(interp->global), name, &value)) {
+        undefined(interp, name);
+    }
+    return value;
+}
+
+static inline Exp proc_ref(Interp *interp, Exp proc)
+{
+    if (!is_proc(proc)) {
+        die(interp, "error: not a procedure\n");
+    }
+    return proc;
+}
+
+static inline Exp call(Interp *interp, Exp proc, List args)
+{
+    return proc.type == EXP_C_PROC ? proc.cproc(interp, args)
+                                   : proc_call(interp, &AS_PROC(proc), args);
+}
+
+// Print the value of a top-level form.
+static inline void show(Interp *interp, Exp val)
+{
+    print_to(interp->out, val);
+    if (val.type != EXP_VOID && val.type != EXP_EMPTY) {
+        writer_putc(interp->out, '\n');
+    }
+}
+
+// Run a form the compiler left to the interpreter.
+static inline void eval_form(Interp *interp, Exp form)
+{
+    Exp val = interp_eval(interp, form);
+    show(interp, val);
+    interp_unpin(interp, val);
+}
+
+static Exp sym[33];
+static Exp lit[8];
+static CProc prim[5];
+static bool defined[7];
+
+static double proc_6_num(Interp *interp, double p0);
+static Exp proc_6(Interp *interp, Exp p0);
+
+// w
+static double proc_6_num(Interp *interp, double p0)
+{
+    double l4 = 0.0;
+    double l5 = 0.0;
+    double v10;
+    loop2:;
+    double v6 = (double) (l4 == p0);
+    double v9;
+    if (v6 != 0) {
+        v9 = l5;
+    } else {
+        double v7 = (0.0 + l4 + 1.0);
+        double v8 = (0.0 + l5 + l4);
+        l4 = v7;
+        l5 = v8;
+        goto loop2;
+    }
+    v10 = v9;
+    return v10;
+}
+
+// w
+static Exp proc_6(Interp *interp, Exp p0)
+{
+    if (is_number(p0)) {
+        return mknum(proc_6_num(interp, p0.number));
+    }
+    double l4 = 0.0;
+    double l5 = 0.0;
+    double v11;
+    loop2:;
+    Exp a6_data[] = { mknum(l4), p0 };
+    List a6 = { .data = a6_data, .size = 2, .cap = 2 };
+    double v7 = scheme_eq(interp, a6).number;
+    double v10;
+    if (v7 != 0) {
+        v10 = l5;
+    } else {
+        double v8 = (0.0 + l4 + 1.0);
+        double v9 = (0.0 + l5 + l4);
+        l4 = v8;
+        l5 = v9;
+        goto loop2;
+    }
+    v11 = v10;
+    return mknum(v11);
+}
+
+static Exp proc_6_entry(Interp *interp, List args)
+{
+    if (args.size != 1) {
+        die(interp, "%s: arity mismatch\n", "w");
+    }
+    return proc_6(interp, args.data[0]);
+}
+
+static void init(Interp *interp)
+{
+    sym[0] = interp_symbol(interp, "make-counter");
+    interp_pin(interp, sym[0]);
+    sym[1] = interp_symbol(interp, "c");
+    interp_pin(interp, sym[1]);
+    sym[2] = interp_symbol(interp, "g");
+    interp_pin(interp, sym[2]);
+    sym[3] = interp_symbol(interp, "g2");
+    interp_pin(interp, sym[3]);
+    sym[4] = interp_symbol(interp, "g3");
+    interp_pin(interp, sym[4]);
+    sym[5] = interp_symbol(interp, "g4");
+    interp_pin(interp, sym[5]);
+    sym[6] = interp_symbol(interp, "gg");
+    interp_pin(interp, sym[6]);
+    sym[7] = interp_symbol(interp, "gh");
+    interp_pin(interp, sym[7]);
+    sym[8] = interp_symbol(interp, "shared");
+    interp_pin(interp, sym[8]);
+    sym[9] = interp_symbol(interp, "s");
+    interp_pin(interp, sym[9]);
+    sym[10] = interp_symbol(interp, "w");
+    interp_pin(interp, sym[10]);
+    sym[11] = interp_symbol(interp, "define");
+    interp_pin(interp, sym[11]);
+    sym[12] = interp_symbol(interp, "lambda");
+    interp_pin(interp, sym[12]);
+    sym[13] = interp_symbol(interp, "let");
+    interp_pin(interp, sym[13]);
+    sym[14] = interp_symbol(interp, "n");
+    interp_pin(interp, sym[14]);
+    sym[15] = interp_symbol(interp, "begin");
+    interp_pin(interp, sym[15]);
+    sym[16] = interp_symbol(interp, "set!");
+    interp_pin(interp, sym[16]);
+    sym[17] = interp_symbol(interp, "+");
+    interp_pin(interp, sym[17]);
+    sym[18] = interp_symbol(interp, "x");
+    interp_pin(interp, sym[18]);
+    sym[19] = interp_symbol(interp, "h");
+    interp_pin(interp, sym[19]);
+    sym[20] = interp_symbol(interp, "*");
+    interp_pin(interp, sym[20]);
+    sym[21] = interp_symbol(interp, "y");
+    interp_pin(interp, sym[21]);
+    sym[22] = interp_symbol(interp, "f");
+    interp_pin(interp, sym[22]);
+    sym[23] = interp_symbol(interp, "guard");
+    interp_pin(interp, sym[23]);
+    sym[24] = interp_symbol(interp, "e");
+    interp_pin(interp, sym[24]);
+    sym[25] = interp_symbol(interp, "q");
+    interp_pin(interp, sym[25]);
+    sym[26] = interp_symbol(interp, "raise");
+    interp_pin(interp, sym[26]);
+    sym[27] = interp_symbol(interp, "v");
+    interp_pin(interp, sym[27]);
+    sym[28] = interp_symbol(interp, "list");
+    interp_pin(interp, sym[28]);
+    sym[29] = interp_symbol(interp, "display");
+    interp_pin(interp, sym[29]);
+    sym[30] = interp_symbol(interp, "newline");
+    interp_pin(interp, sym[30]);
+    sym[31] = interp_symbol(interp, "cdr");
+    interp_pin(interp, sym[31]);
+    sym[32] = interp_symbol(interp, "car");
+    interp_pin(interp, sym[32]);
+    {
+        List d0 = VECTOR_INIT();
+        Exp e1;
+        e1 = sym[11];
+        list_add(interp, &d0, e1);
+        Exp e2;
+        e2 = sym[0];
+        list_add(interp, &d0, e2);
+        Exp e3;
+        {
+            List d4 = VECTOR_INIT();
+            Exp e5;
+            e5 = sym[12];
+            list_add(interp, &d4, e5);
+            Exp e6;
+            {
+                List d7 = VECTOR_INIT();
+                e6 = mklist(interp, d7);
+            }
+            list_add(interp, &d4, e6);
+            Exp e8;
+            {
+                List d9 = VECTOR_INIT();
+                Exp e10;
+                e10 = sym[13];
+                list_add(interp, &d9, e10);
+                Exp e11;
+                {
+                    List d12 = VECTOR_INIT();
+                    Exp e13;
+                    {
+                        List d14 = VECTOR_INIT();
+                        Exp e15;
+                        e15 = sym[14];
+                        list_add(interp, &d14, e15);
+                        Exp e16;
+                        e16 = mknum(0.0);
+                        list_add(interp, &d14, e16);
+                        e13 = mklist(interp, d14);
+                    }
+                    list_add(interp, &d12, e13);
+                    e11 = mklist(interp, d12);
+                }
+                list_add(interp, &d9, e11);
+                Exp e17;
+                {
+                    List d18 = VECTOR_INIT();
+                    Exp e19;
+                    e19 = sym[12];
+                    list_add(interp, &d18, e19);
+                    Exp e20;
+                    {
+                        List d21 = VECTOR_INIT();
+                        e20 = mklist(interp, d21);
+                    }
+                    list_add(interp, &d18, e20);
+                    Exp e22;
+                    {
+                        List d23 = VECTOR_INIT();
+                        Exp e24;
+                        e24 = sym[15];
+                        list_add(interp, &d23, e24);
+                        Exp e25;
+                        {
+                            List d26 = VECTOR_INIT();
+                            Exp e27;
+                            e27 = sym[16];
+                            list_add(interp, &d26, e27);
+                            Exp e28;
+                            e28 = sym[14];
+                            list_add(interp, &d26, e28);
+                            Exp e29;
+                            {
+                                List d30 = VECTOR_INIT();
+                                Exp e31;
+                                e31 = sym[17];
+                                list_add(interp, &d30, e31);
+                                Exp e32;
+                                e32 = sym[14];
+                                list_add(interp, &d30, e32);
+                                Exp e33;
+                                e33 = mknum(1.0);
+                                list_add(interp, &d30, e33);
+                                e29 = mklist(interp, d30);
+                            }
+                            list_add(interp, &d26, e29);
+                            e25 = mklist(interp, d26);
+                        }
+                        list_add(interp, &d23, e25);
+                        Exp e34;
+                        e34 = sym[14];
+                        list_add(interp, &d23, e34);
+                        e22 = mklist(interp, d23);
+                    }
+                    list_add(interp, &d18, e22);
+                    e17 = mklist(interp, d18);
+                }
+                list_add(interp, &d9, e17);
+                e8 = mklist(interp, d9);
+            }
+            list_add(interp, &d4, e8);
+            e3 = mklist(interp, d4);
+        }
+        list_add(interp, &d0, e3);
+        lit[0] = mklist(interp, d0);
+    }
+    interp_pin(interp, lit[0]);
+    {
+        List d35 = VECTOR_INIT();
+        Exp e36;
+        e36 = sym[11];
+        list_add(interp, &d35, e36);
+        Exp e37;
+        e37 = sym[2];
+        list_add(interp, &d35, e37);
+        Exp e38;
+        {
+            List d39 = VECTOR_INIT();
+            Exp e40;
+            e40 = sym[12];
+            list_add(interp, &d39, e40);
+            Exp e41;
+            {
+                List d42 = VECTOR_INIT();
+                Exp e43;
+                e43 = sym[18];
+                list_add(interp, &d42, e43);
+                e41 = mklist(interp, d42);
+            }
+            list_add(interp, &d39, e41);
+            Exp e44;
+            {
+                List d45 = VECTOR_INIT();
+                Exp e46;
+                e46 = sym[15];
+                list_add(interp, &d45, e46);
+                Exp e47;
+                {
+                    List d48 = VECTOR_INIT();
+                    Exp e49;
+                    e49 = sym[11];
+                    list_add(interp, &d48, e49);
+                    Exp e50;
+                    e50 = sym[19];
+                    list_add(interp, &d48, e50);
+                    Exp e51;
+                    {
+                        List d52 = VECTOR_INIT();
+                        Exp e53;
+                        e53 = sym[12];
+                        list_add(interp, &d52, e53);
+                        Exp e54;
+                        {
+                            List d55 = VECTOR_INIT();
+                            e54 = mklist(interp, d55);
+                        }
+                        list_add(interp, &d52, e54);
+                        Exp e56;
+                        {
+                            List d57 = VECTOR_INIT();
+                            Exp e58;
+                            e58 = sym[20];
+                            list_add(interp, &d57, e58);
+                            Exp e59;
+                            e59 = sym[18];
+                            list_add(interp, &d57, e59);
+                            Exp e60;
+                            e60 = sym[21];
+                            list_add(interp, &d57, e60);
+                            e56 = mklist(interp, d57);
+                        }
+                        list_add(interp, &d52, e56);
+                        e51 = mklist(interp, d52);
+                    }
+                    list_add(interp, &d48, e51);
+                    e47 = mklist(interp, d48);
+                }
+                list_add(interp, &d45, e47);
+                Exp e61;
+                {
+                    List d62 = VECTOR_INIT();
+                    Exp e63;
+                    e63 = sym[11];
+                    list_add(interp, &d62, e63);
+                    Exp e64;
+                    e64 = sym[21];
+                    list_add(interp, &d62, e64);
+                    Exp e65;
+                    e65 = mknum(5.0);
+                    list_add(interp, &d62, e65);
+                    e61 = mklist(interp, d62);
+                }
+                list_add(interp, &d45, e61);
+                Exp e66;
+                {
+                    List d67 = VECTOR_INIT();
+                    Exp e68;
+                    e68 = sym[19];
+                    list_add(interp, &d67, e68);
+                    e66 = mklist(interp, d67);
+                }
+                list_add(interp, &d45, e66);
+                e44 = mklist(interp, d45);
+            }
+            list_add(interp, &d39, e44);
+            e38 = mklist(interp, d39);
+        }
+        list_add(interp, &d35, e38);
+        lit[1] = mklist(interp, d35);
+    }
+    interp_pin(interp, lit[1]);
+    {
+        List d69 = VECTOR_INIT();
+        Exp e70;
+        e70 = sym[11];
+        list_add(interp, &d69, e70);
+        Exp e71;
+        e71 = sym[3];
+        list_add(interp, &d69, e71);
+        Exp e72;
+        {
+            List d73 = VECTOR_INIT();
+            Exp e74;
+            e74 = sym[12];
+            list_add(interp, &d73, e74);
+            Exp e75;
+            {
+                List d76 = VECTOR_INIT();
+                Exp e77;
+                e77 = sym[18];
+                list_add(interp, &d76, e77);
+                e75 = mklist(interp, d76);
+            }
+            list_add(interp, &d73, e75);
+            Exp e78;
+            {
+                List d79 = VECTOR_INIT();
+                Exp e80;
+                e80 = sym[13];
+                list_add(interp, &d79, e80);
+                Exp e81;
+                {
+                    List d82 = VECTOR_INIT();
+                    e81 = mklist(interp, d82);
+                }
+                list_add(interp, &d79, e81);
+                Exp e83;
+                {
+                    List d84 = VECTOR_INIT();
+                    Exp e85;
+                    e85 = sym[11];
+                    list_add(interp, &d84, e85);
+                    Exp e86;
+                    e86 = sym[19];
+                    list_add(interp, &d84, e86);
+                    Exp e87;
+                    {
+                        List d88 = VECTOR_INIT();
+                        Exp e89;
+                        e89 = sym[12];
+                        list_add(interp, &d88, e89);
+                        Exp e90;
+                        {
+                            List d91 = VECTOR_INIT();
+                            e90 = mklist(interp, d91);
+                        }
+                        list_add(interp, &d88, e90);
+                        Exp e92;
+                        e92 = sym[18];
+                        list_add(interp, &d88, e92);
+                        e87 = mklist(interp, d88);
+                    }
+                    list_add(interp, &d84, e87);
+                    e83 = mklist(interp, d84);
+                }
+                list_add(interp, &d79, e83);
+                Exp e93;
+                {
+                    List d94 = VECTOR_INIT();
+                    Exp e95;
+                    e95 = sym[11];
+                    list_add(interp, &d94, e95);
+                    Exp e96;
+                    e96 = sym[18];
+                    list_add(interp, &d94, e96);
+                    Exp e97;
+                    e97 = mknum(5.0);
+                    list_add(interp, &d94, e97);
+                    e93 = mklist(interp, d94);
+                }
+                list_add(interp, &d79, e93);
+                Exp e98;
+                {
+                    List d99 = VECTOR_INIT();
+                    Exp e100;
+                    e100 = sym[19];
+                    list_add(interp, &d99, e100);
+                    e98 = mklist(interp, d99);
+                }
+                list_add(interp, &d79, e98);
+                e78 = mklist(interp, d79);
+            }
+            list_add(interp, &d73, e78);
+            e72 = mklist(interp, d73);
+        }
+        list_add(interp, &d69, e72);
+        lit[2] = mklist(interp, d69);
+    }
+    interp_pin(interp, lit[2]);
+    {
+        List d101 = VECTOR_INIT();
+        Exp e102;
+        e102 = sym[11];
+        list_add(interp, &d101, e102);
+        Exp e103;
+        e103 = sym[4];
+        list_add(interp, &d101, e103);
+        Exp e104;
+        {
+            List d105 = VECTOR_INIT();
+            Exp e106;
+            e106 = sym[12];
+            list_add(interp, &d105, e106);
+            Exp e107;
+            {
+                List d108 = VECTOR_INIT();
+                Exp e109;
+                e109 = sym[18];
+                list_add(interp, &d108, e109);
+                e107 = mklist(interp, d108);
+            }
+            list_add(interp, &d105, e107);
+            Exp e110;
+            {
+                List d111 = VECTOR_INIT();
+                Exp e112;
+                e112 = sym[15];
+                list_add(interp, &d111, e112);
+                Exp e113;
+                {
+                    List d114 = VECTOR_INIT();
+                    Exp e115;
+                    e115 = sym[11];
+                    list_add(interp, &d114, e115);
+                    Exp e116;
+                    e116 = sym[19];
+                    list_add(interp, &d114, e116);
+                    Exp e117;
+                    {
+                        List d118 = VECTOR_INIT();
+                        Exp e119;
+                        e119 = sym[12];
+                        list_add(interp, &d118, e119);
+                        Exp e120;
+                        {
+                            List d121 = VECTOR_INIT();
+                            e120 = mklist(interp, d121);
+                        }
+                        list_add(interp, &d118, e120);
+                        Exp e122;
+                        e122 = sym[18];
+                        list_add(interp, &d118, e122);
+                        e117 = mklist(interp, d118);
+                    }
+                    list_add(interp, &d114, e117);
+                    e113 = mklist(interp, d114);
+                }
+                list_add(interp, &d111, e113);
+                Exp e123;
+                {
+                    List d124 = VECTOR_INIT();
+                    Exp e125;
+                    e125 = sym[16];
+                    list_add(interp, &d124, e125);
+                    Exp e126;
+                    e126 = sym[18];
+                    list_add(interp, &d124, e126);
+                    Exp e127;
+                    e127 = mknum(9.0);
+                    list_add(interp, &d124, e127);
+                    e123 = mklist(interp, d124);
+                }
+                list_add(interp, &d111, e123);
+                Exp e128;
+                {
+                    List d129 = VECTOR_INIT();
+                    Exp e130;
+                    e130 = sym[19];
+                    list_add(interp, &d129, e130);
+                    e128 = mklist(interp, d129);
+                }
+                list_add(interp, &d111, e128);
+                e110 = mklist(interp, d111);
+            }
+            list_add(interp, &d105, e110);
+            e104 = mklist(interp, d105);
+        }
+        list_add(interp, &d101, e104);
+        lit[3] = mklist(interp, d101);
+    }
+    interp_pin(interp, lit[3]);
+    {
+        List d131 = VECTOR_INIT();
+        Exp e132;
+        e132 = sym[11];
+        list_add(interp, &d131, e132);
+        Exp e133;
+        e133 = sym[5];
+        list_add(interp, &d131, e133);
+        Exp e134;
+        {
+            List d135 = VECTOR_INIT();
+            Exp e136;
+            e136 = sym[12];
+            list_add(interp, &d135, e136);
+            Exp e137;
+            {
+                List d138 = VECTOR_INIT();
+                Exp e139;
+                e139 = sym[18];
+                list_add(interp, &d138, e139);
+                e137 = mklist(interp, d138);
+            }
+            list_add(interp, &d135, e137);
+            Exp e140;
+            {
+                List d141 = VECTOR_INIT();
+                Exp e142;
+                e142 = sym[13];
+                list_add(interp, &d141, e142);
+                Exp e143;
+                {
+                    List d144 = VECTOR_INIT();
+                    Exp e145;
+                    {
+                        List d146 = VECTOR_INIT();
+                        Exp e147;
+                        e147 = sym[22];
+                        list_add(interp, &d146, e147);
+                        Exp e148;
+                        {
+                            List d149 = VECTOR_INIT();
+                            Exp e150;
+                            e150 = sym[12];
+                            list_add(interp, &d149, e150);
+                            Exp e151;
+                            {
+                                List d152 = VECTOR_INIT();
+                                e151 = mklist(interp, d152);
+                            }
+                            list_add(interp, &d149, e151);
+                            Exp e153;
+                            e153 = sym[18];
+                            list_add(interp, &d149, e153);
+                            e148 = mklist(interp, d149);
+                        }
+                        list_add(interp, &d146, e148);
+                        e145 = mklist(interp, d146);
+                    }
+                    list_add(interp, &d144, e145);
+                    e143 = mklist(interp, d144);
+                }
+                list_add(interp, &d141, e143);
+                Exp e154;
+                {
+                    List d155 = VECTOR_INIT();
+                    Exp e156;
+                    e156 = sym[16];
+                    list_add(interp, &d155, e156);
+                    Exp e157;
+                    e157 = sym[18];
+                    list_add(interp, &d155, e157);
+                    Exp e158;
+                    e158 = mknum(11.0);
+                    list_add(interp, &d155, e158);
+                    e154 = mklist(interp, d155);
+                }
+                list_add(interp, &d141, e154);
+                Exp e159;
+                {
+                    List d160 = VECTOR_INIT();
+                    Exp e161;
+                    e161 = sym[22];
+                    list_add(interp, &d160, e161);
+                    e159 = mklist(interp, d160);
+                }
+                list_add(interp, &d141, e159);
+                e140 = mklist(interp, d141);
+            }
+            list_add(interp, &d135, e140);
+            e134 = mklist(interp, d135);
+        }
+        list_add(interp, &d131, e134);
+        lit[4] = mklist(interp, d131);
+    }
+    interp_pin(interp, lit[4]);
+    {
+        List d162 = VECTOR_INIT();
+        Exp e163;
+        e163 = sym[11];
+        list_add(interp, &d162, e163);
+        Exp e164;
+        e164 = sym[6];
+        list_add(interp, &d162, e164);
+        Exp e165;
+        {
+            List d166 = VECTOR_INIT();
+            Exp e167;
+            e167 = sym[23];
+            list_add(interp, &d166, e167);
+            Exp e168;
+            {
+                List d169 = VECTOR_INIT();
+                Exp e170;
+                e170 = sym[24];
+                list_add(interp, &d169, e170);
+                Exp e171;
+                {
+                    List d172 = VECTOR_INIT();
+                    Exp e173;
+                    e173 = mknum(1.0);
+                    list_add(interp, &d172, e173);
+                    Exp e174;
+                    e174 = mknum(0.0);
+                    list_add(interp, &d172, e174);
+                    e171 = mklist(interp, d172);
+                }
+                list_add(interp, &d169, e171);
+                e168 = mklist(interp, d169);
+            }
+            list_add(interp, &d166, e168);
+            Exp e175;
+            {
+                List d176 = VECTOR_INIT();
+                Exp e177;
+                e177 = sym[13];
+                list_add(interp, &d176, e177);
+                Exp e178;
+                {
+                    List d179 = VECTOR_INIT();
+                    Exp e180;
+                    {
+                        List d181 = VECTOR_INIT();
+                        Exp e182;
+                        e182 = sym[25];
+                        list_add(interp, &d181, e182);
+                        Exp e183;
+                        e183 = mknum(7.0);
+                        list_add(interp, &d181, e183);
+                        e180 = mklist(interp, d181);
+                    }
+                    list_add(interp, &d179, e180);
+                    e178 = mklist(interp, d179);
+                }
+                list_add(interp, &d176, e178);
+                Exp e184;
+                e184 = sym[25];
+                list_add(interp, &d176, e184);
+                e175 = mklist(interp, d176);
+            }
+            list_add(interp, &d166, e175);
+            e165 = mklist(interp, d166);
+        }
+        list_add(interp, &d162, e165);
+        lit[5] = mklist(interp, d162);
+    }
+    interp_pin(interp, lit[5]);
+    {
+        List d185 = VECTOR_INIT();
+        Exp e186;
+        e186 = sym[11];
+        list_add(interp, &d185, e186);
+        Exp e187;
+        e187 = sym[7];
+        list_add(interp, &d185, e187);
+        Exp e188;
+        {
+            List d189 = VECTOR_INIT();
+            Exp e190;
+            e190 = sym[23];
+            list_add(interp, &d189, e190);
+            Exp e191;
+            {
+                List d192 = VECTOR_INIT();
+                Exp e193;
+                e193 = sym[24];
+                list_add(interp, &d192, e193);
+                Exp e194;
+                {
+                    List d195 = VECTOR_INIT();
+                    Exp e196;
+                    e196 = mknum(1.0);
+                    list_add(interp, &d195, e196);
+                    Exp e197;
+                    e197 = sym[24];
+                    list_add(interp, &d195, e197);
+                    e194 = mklist(interp, d195);
+                }
+                list_add(interp, &d192, e194);
+                e191 = mklist(interp, d192);
+            }
+            list_add(interp, &d189, e191);
+            Exp e198;
+            {
+                List d199 = VECTOR_INIT();
+                Exp e200;
+                e200 = sym[26];
+                list_add(interp, &d199, e200);
+                Exp e201;
+                e201 = mknum(5.0);
+                list_add(interp, &d199, e201);
+                e198 = mklist(interp, d199);
+            }
+            list_add(interp, &d189, e198);
+            e188 = mklist(interp, d189);
+        }
+        list_add(interp, &d185, e188);
+        lit[6] = mklist(interp, d185);
+    }
+    interp_pin(interp, lit[6]);
+    {
+        List d202 = VECTOR_INIT();
+        Exp e203;
+        e203 = sym[11];
+        list_add(interp, &d202, e203);
+        Exp e204;
+        e204 = sym[8];
+        list_add(interp, &d202, e204);
+        Exp e205;
+        {
+            List d206 = VECTOR_INIT();
+            Exp e207;
+            e207 = sym[12];
+            list_add(interp, &d206, e207);
+            Exp e208;
+            {
+                List d209 = VECTOR_INIT();
+                e208 = mklist(interp, d209);
+            }
+            list_add(interp, &d206, e208);
+            Exp e210;
+            {
+                List d211 = VECTOR_INIT();
+                Exp e212;
+                e212 = sym[13];
+                list_add(interp, &d211, e212);
+                Exp e213;
+                {
+                    List d214 = VECTOR_INIT();
+                    Exp e215;
+                    {
+                        List d216 = VECTOR_INIT();
+                        Exp e217;
+                        e217 = sym[27];
+                        list_add(interp, &d216, e217);
+                        Exp e218;
+                        e218 = mknum(0.0);
+                        list_add(interp, &d216, e218);
+                        e215 = mklist(interp, d216);
+                    }
+                    list_add(interp, &d214, e215);
+                    e213 = mklist(interp, d214);
+                }
+                list_add(interp, &d211, e213);
+                Exp e219;
+                {
+                    List d220 = VECTOR_INIT();
+                    Exp e221;
+                    e221 = sym[28];
+                    list_add(interp, &d220, e221);
+                    Exp e222;
+                    {
+                        List d223 = VECTOR_INIT();
+                        Exp e224;
+                        e224 = sym[12];
+                        list_add(interp, &d223, e224);
+                        Exp e225;
+                        {
+                            List d226 = VECTOR_INIT();
+                            e225 = mklist(interp, d226);
+                        }
+                        list_add(interp, &d223, e225);
+                        Exp e227;
+                        e227 = sym[27];
+                        list_add(interp, &d223, e227);
+                        e222 = mklist(interp, d223);
+                    }
+                    list_add(interp, &d220, e222);
+                    Exp e228;
+                    {
+                        List d229 = VECTOR_INIT();
+                        Exp e230;
+                        e230 = sym[12];
+                        list_add(interp, &d229, e230);
+                        Exp e231;
+                        {
+                            List d232 = VECTOR_INIT();
+                            e231 = mklist(interp, d232);
+                        }
+                        list_add(interp, &d229, e231);
+                        Exp e233;
+                        {
+                            List d234 = VECTOR_INIT();
+                            Exp e235;
+                            e235 = sym[16];
+                            list_add(interp, &d234, e235);
+                            Exp e236;
+                            e236 = sym[27];
+                            list_add(interp, &d234, e236);
+                            Exp e237;
+                            {
+                                List d238 = VECTOR_INIT();
+                                Exp e239;
+                                e239 = sym[17];
+                                list_add(interp, &d238, e239);
+                                Exp e240;
+                                e240 = sym[27];
+                                list_add(interp, &d238, e240);
+                                Exp e241;
+                                e241 = mknum(1.0);
+                                list_add(interp, &d238, e241);
+                                e237 = mklist(interp, d238);
+                            }
+                            list_add(interp, &d234, e237);
+                            e233 = mklist(interp, d234);
+                        }
+                        list_add(interp, &d229, e233);
+                        e228 = mklist(interp, d229);
+                    }
+                    list_add(interp, &d220, e228);
+                    e219 = mklist(interp, d220);
+                }
+                list_add(interp, &d211, e219);
+                e210 = mklist(interp, d211);
+            }
+            list_add(interp, &d206, e210);
+            e205 = mklist(interp, d206);
+        }
+        list_add(interp, &d202, e205);
+        lit[7] = mklist(interp, d202);
+    }
+    interp_pin(interp, lit[7]);
+    prim[0] = global_ref(interp, sym[28]).cproc;
+    prim[1] = global_ref(interp, sym[29]).cproc;
+    prim[2] = global_ref(interp, sym[30]).cproc;
+    prim[3] = global_ref(interp, sym[31]).cproc;
+    prim[4] = global_ref(interp, sym[32]).cproc;
+}
+
+static void run(Interp *interp)
+{
+    // (define make-counter (lambda () (let ((n 0)) (lambda () (begin (set! n ( ...
+    eval_form(interp, lit[0]);
+    // (define c (make-counter))
+    gc_maybe_collect(interp);
+    {
+        Exp v0 = global_ref(interp, sym[0]);
+        Exp v1 = proc_ref(interp, v0);
+        List a2 = VECTOR_INIT();
+        Exp v3 = call(interp, v1, a2);
+        interp_define(interp, "c", v3);
+    }
+    // (c)
+    gc_maybe_collect(interp);
+    {
+        Exp v0 = global_ref(interp, sym[1]);
+        Exp v1 = proc_ref(interp, v0);
+        List a2 = VECTOR_INIT();
+        Exp v3 = call(interp, v1, a2);
+        show(interp, v3);
+    }
+    // (c)
+    gc_maybe_collect(interp);
+    {
+        Exp v0 = global_ref(interp, sym[1]);
+        Exp v1 = proc_ref(interp, v0);
+        List a2 = VECTOR_INIT();
+        Exp v3 = call(interp, v1, a2);
+        show(interp, v3);
+    }
+    // (display (c))
+    gc_maybe_collect(interp);
+    {
+        Exp v0 = global_ref(interp, sym[1]);
+        Exp v1 = proc_ref(interp, v0);
+        List a2 = VECTOR_INIT();
+        Exp v3 = call(interp, v1, a2);
+        Exp a4_data[] = { v3 };
+        List a4 = { .data = a4_data, .size = 1, .cap = 1 };
+        Exp v5 = prim[1](interp, a4);
+        show(interp, v5);
+    }
+    // (newline)
+    gc_maybe_collect(interp);
+    {
+        List a0 = VECTOR_INIT();
+        Exp v1 = prim[2](interp, a0);
+        show(interp, v1);
+    }
+    // (define g (lambda (x) (begin (define h (lambda () (* x y))) (define y 5) ...
+    eval_form(interp, lit[1]);
+    // (display (g 3))
+    gc_maybe_collect(interp);
+    {
+        Exp v0 = global_ref(interp, sym[2]);
+        Exp v1 = proc_ref(interp, v0);
+        Exp a2_data[] = { mknum(3.0) };
+        List a2 = { .data = a2_data, .size = 1, .cap = 1 };
+        Exp v3 = call(interp, v1, a2);
+        Exp a4_data[] = { v3 };
+        List a4 = { .data = a4_data, .size = 1, .cap = 1 };
+        Exp v5 = prim[1](interp, a4);
+        show(interp, v5);
+    }
+    // (newline)
+    gc_maybe_collect(interp);
+    {
+        List a0 = VECTOR_INIT();
+        Exp v1 = prim[2](interp, a0);
+        show(interp, v1);
+    }
+    // (define g2 (lambda (x) (let () (define h (lambda () x)) (define x 5) (h) ...
+    eval_form(interp, lit[2]);
+    // (display (g2 3))
+    gc_maybe_collect(interp);
+    {
+        Exp v0 = global_ref(interp, sym[3]);
+        Exp v1 = proc_ref(interp, v0);
+        Exp a2_data[] = { mknum(3.0) };
+        List a2 = { .data = a2_data, .size = 1, .cap = 1 };
+        Exp v3 = call(interp, v1, a2);
+        Exp a4_data[] = { v3 };
+        List a4 = { .data = a4_data, .size = 1, .cap = 1 };
+        Exp v5 = prim[1](interp, a4);
+        show(interp, v5);
+    }
+    // (newline)
+    gc_maybe_collect(interp);
+    {
+        List a0 = VECTOR_INIT();
+        Exp v1 = prim[2](interp, a0);
+        show(interp, v1);
+    }
+    // (define g3 (lambda (x) (begin (define h (lambda () x)) (set! x 9) (h))))
+    eval_form(interp, lit[3]);
+    // (display (g3 3))
+    gc_maybe_collect(interp);
+    {
+        Exp v0 = global_ref(interp, sym[4]);
+        Exp v1 = proc_ref(interp, v0);
+        Exp a2_data[] = { mknum(3.0) };
+        List a2 = { .data = a2_data, .size = 1, .cap = 1 };
+        Exp v3 = call(interp, v1, a2);
+        Exp a4_data[] = { v3 };
+        List a4 = { .data = a4_data, .size = 1, .cap = 1 };
+        Exp v5 = prim[1](interp, a4);
+        show(interp, v5);
+    }
+    // (newline)
+    gc_maybe_collect(interp);
+    {
+        List a0 = VECTOR_INIT();
+        Exp v1 = prim[2](interp, a0);
+        show(interp, v1);
+    }
+    // (define g4 (lambda (x) (let ((f (lambda () x))) (set! x 11) (f))))
+    eval_form(interp, lit[4]);
+    // (display (g4 3))
+    gc_maybe_collect(interp);
+    {
+        Exp v0 = global_ref(interp, sym[5]);
+        Exp v1 = proc_ref(interp, v0);
+        Exp a2_data[] = { mknum(3.0) };
+        List a2 = { .data = a2_data, .size = 1, .cap = 1 };
+        Exp v3 = call(interp, v1, a2);
+        Exp a4_data[] = { v3 };
+        List a4 = { .data = a4_data, .size = 1, .cap = 1 };
+        Exp v5 = prim[1](interp, a4);
+        show(interp, v5);
+    }
+    // (newline)
+    gc_maybe_collect(interp);
+    {
+        List a0 = VECTOR_INIT();
+        Exp v1 = prim[2](interp, a0);
+        show(interp, v1);
+    }
+    // (define gg (guard (e (1 0)) (let ((q 7)) q)))
+    eval_form(interp, lit[5]);
+    // (display gg)
+    gc_maybe_collect(interp);
+    {
+        Exp v0 = global_ref(interp, sym[6]);
+        Exp a1_data[] = { v0 };
+        List a1 = { .data = a1_data, .size = 1, .cap = 1 };
+        Exp v2 = prim[1](interp, a1);
+        show(interp, v2);
+    }
+    // (newline)
+    gc_maybe_collect(interp);
+    {
+        List a0 = VECTOR_INIT();
+        Exp v1 = prim[2](interp, a0);
+        show(interp, v1);
+    }
+    // (define gh (guard (e (1 e)) (raise 5)))
+    eval_form(interp, lit[6]);
+    // (display gh)
+    gc_maybe_collect(interp);
+    {
+        Exp v0 = global_ref(interp, sym[7]);
+        Exp a1_data[] = { v0 };
+        List a1 = { .data = a1_data, .size = 1, .cap = 1 };
+        Exp v2 = prim[1](interp, a1);
+        show(interp, v2);
+    }
+    // (newline)
+    gc_maybe_collect(interp);
+    {
+        List a0 = VECTOR_INIT();
+        Exp v1 = prim[2](interp, a0);
+        show(interp, v1);
+    }
+    // (define shared (lambda () (let ((v 0)) (list (lambda () v) (lambda () (s ...
+    eval_form(interp, lit[7]);
+    // (define s (shared))
+    gc_maybe_collect(interp);
+    {
+        Exp v0 = global_ref(interp, sym[8]);
+        Exp v1 = proc_ref(interp, v0);
+        List a2 = VECTOR_INIT();
+        Exp v3 = call(interp, v1, a2);
+        interp_define(interp, "s", v3);
+    }
+    // ((car (cdr s)))
+    gc_maybe_collect(interp);
+    {
+        Exp v0 = global_ref(interp, sym[9]);
+        Exp a1_data[] = { v0 };
+        List a1 = { .data = a1_data, .size = 1, .cap = 1 };
+        Exp v2 = prim[3](interp, a1);
+        Exp a3_data[] = { v2 };
+        List a3 = { .data = a3_data, .size = 1, .cap = 1 };
+        Exp v4 = prim[4](interp, a3);
+        Exp v5 = proc_ref(interp, v4);
+        List a6 = VECTOR_INIT();
+        Exp v7 = call(interp, v5, a6);
+        show(interp, v7);
+    }
+    // ((car (cdr s)))
+    gc_maybe_collect(interp);
+    {
+        Exp v0 = global_ref(interp, sym[9]);
+        Exp a1_data[] = { v0 };
+        List a1 = { .data = a1_data, .size = 1, .cap = 1 };
+        Exp v2 = prim[3](interp, a1);
+        Exp a3_data[] = { v2 };
+        List a3 = { .data = a3_data, .size = 1, .cap = 1 };
+        Exp v4 = prim[4](interp, a3);
+        Exp v5 = proc_ref(interp, v4);
+        List a6 = VECTOR_INIT();
+        Exp v7 = call(interp, v5, a6);
+        show(interp, v7);
+    }
+    // (display ((car s)))
+    gc_maybe_collect(interp);
+    {
+        Exp v0 = global_ref(interp, sym[9]);
+        Exp a1_data[] = { v0 };
+        List a1 = { .data = a1_data, .size = 1, .cap = 1 };
+        Exp v2 = prim[4](interp, a1);
+        Exp v3 = proc_ref(interp, v2);
+        List a4 = VECTOR_INIT();
+        Exp v5 = call(interp, v3, a4);
+        Exp a6_data[] = { v5 };
+        List a6 = { .data = a6_data, .size = 1, .cap = 1 };
+        Exp v7 = prim[1](interp, a6);
+        show(interp, v7);
+    }
+    // (newline)
+    gc_maybe_collect(interp);
+    {
+        List a0 = VECTOR_INIT();
+        Exp v1 = prim[2](interp, a0);
+        show(interp, v1);
+    }
+    // (define w (lambda (n) (let loop ((i 0) (acc 0)) (if (= i n) acc (loop (+ ...
+    defined[6] = true;
+    interp_define(interp, "w", mkcproc(proc_6_entry));
+    // (display (w 10))
+    gc_maybe_collect(interp);
+    {
+        if (!defined[6]) {
+            undefined(interp, sym[10]);
+        }
+        double v0 = proc_6_num(interp, 10.0);
+        Exp a1_data[] = { mknum(v0) };
+        List a1 = { .data = a1_data, .size = 1, .cap = 1 };
+        Exp v2 = prim[1](interp, a1);
+        show(interp, v2);
+    }
+    // (newline)
+    gc_maybe_collect(interp);
+    {
+        List a0 = VECTOR_INIT();
+        Exp v1 = prim[2](interp, a0);
+        show(interp, v1);
+    }
+}
+
+int main(void)
+{
+    Interp *interp = interp_new();
+    // forms left to the interpreter were optimized when compiled
+    interp->optimize = false;
+    init(interp);
+    run(interp);
+    interp_free(interp);
+    return 0;
+}
@@ -0,0 +1,210 @@
+// Compiled from /tmp/aot/t3.scm by scheme -c.
+
+#include "scheme.h"
+#include "gcobject.h"
+#include "ht.h"
+
+#define VOID_EXP ((Exp) { .type = EXP_VOID })
+
+static inline noreturn void undefined(Interp *interp, Exp name)
+{
+    die(interp, "undefined symbol: %s\n", AS_SYM(name));
+}
+
+static inline Exp global_ref(Interp *interp, Exp name)
+{
+    Exp value;
+    if (!ht_lookup(&ENV_HT(interp->global), name, &value)) {
+        undefined(interp, name);
+    }
+    return value;
+}
+
+static inline Exp proc_ref(Interp *interp, Exp proc)
+{
+    if (!is_proc(proc)) {
+        die(interp, "error: not a procedure\n");
+    }
+    return proc;
+}
+
+static inline Exp call(Interp *interp, Exp proc, List args)
+{
+    return proc.type == EXP_C_PROC ? proc.cproc(interp, args)
+                                   : proc_call(interp, &AS_PROC(proc), args);
+}
+
+// Print the value of a top-level form.
+static inline void show(Interp *interp, Exp val)
+{
+    print_to(interp->out, val);
+    if (val.type != EXP_VOID && val.type != EXP_EMPTY) {
+        writer_putc(interp->out, '\n');
+    }
+}
+
+// Run a form the compiler left to the interpreter.
+static inline void eval_form(Interp *interp, Exp form)
+{
+    Exp val = interp_eval(interp, form);
+    show(interp, val);
+    interp_unpin(interp, val);
+}
+
+static Exp sym[8];
+static Exp lit[2];
+static CProc prim[1];
+static bool defined[2];
+
+static Exp proc_0(Interp *interp, Exp p0);
+static double proc_1_num(Interp *interp, double p0);
+static Exp proc_1(Interp *interp, Exp p0);
+
+// f
+static Exp proc_0(Interp *interp, Exp p0)
+{
+    Exp a2_data[] = { p0 };
+    List a2 = { .data = a2_data, .size = 1, .cap = 1 };
+    Exp v3 = prim[0](interp, a2);
+    return v3;
+}
+
+static Exp proc_0_entry(Interp *interp, List args)
+{
+    if (args.size != 1) {
+        die(interp, "%s: arity mismatch\n", "f");
+    }
+    return proc_0(interp, args.data[0]);
+}
+
+// h
+static double proc_1_num(Interp *interp, double p0)
+{
+    double v2 = (0.0 + p0 + 1.0);
+    return v2;
+}
+
+// h
+static Exp proc_1(Interp *interp, Exp p0)
+{
+    if (is_number(p0)) {
+        return mknum(proc_1_num(interp, p0.number));
+    }
+    Exp a2_data[] = { p0, mknum(1.0) };
+    List a2 = { .data = a2_data, .size = 2, .cap = 2 };
+    double v3 = scheme_sum(interp, a2).number;
+    return mknum(v3);
+}
+
+static Exp proc_1_entry(Interp *interp, List args)
+{
+    if (args.size != 1) {
+        die(interp, "%s: arity mismatch\n", "h");
+    }
+    return proc_1(interp, args.data[0]);
+}
+
+static void init(Interp *interp)
+{
+    sym[0] = interp_symbol(interp, "h");
+    interp_pin(interp, sym[0]);
+    sym[1] = interp_symbol(interp, "guard");
+    interp_pin(interp, sym[1]);
+    sym[2] = interp_symbol(interp, "e");
+    interp_pin(interp, sym[2]);
+    sym[3] = interp_symbol(interp, "quote");
+    interp_pin(interp, sym[3]);
+    sym[4] = interp_symbol(interp, "caught");
+    interp_pin(interp, sym[4]);
+    sym[5] = interp_symbol(interp, "f");
+    interp_pin(interp, sym[5]);
+    sym[6] = interp_symbol(interp, "a\?b");
+    interp_pin(interp, sym[6]);
+    sym[7] = interp_symbol(interp, "car");
+    interp_pin(interp, sym[7]);
+    {
+        List d0 = VECTOR_INIT();
+        Exp e1;
+        e1 = sym[1];
+        list_add(interp, &d0, e1);
+        Exp e2;
+        {
+            List d3 = VECTOR_INIT();
+            Exp e4;
+            e4 = sym[2];
+            list_add(interp, &d3, e4);
+            Exp e5;
+            {
+                List d6 = VECTOR_INIT();
+                Exp e7;
+                e7 = mknum(1.0);
+                list_add(interp, &d6, e7);
+                Exp e8;
+                {
+                    List d9 = VECTOR_INIT();
+                    Exp e10;
+                    e10 = sym[3];
+                    list_add(interp, &d9, e10);
+                    Exp e11;
+                    e11 = sym[4];
+                    list_add(interp, &d9, e11);
+                    e8 = mklist(interp, d9);
+                }
+                list_add(interp, &d6, e8);
+                e5 = mklist(interp, d6);
+            }
+            list_add(interp, &d3, e5);
+            e2 = mklist(interp, d3);
+        }
+        list_add(interp, &d0, e2);
+        Exp e12;
+        {
+            List d13 = VECTOR_INIT();
+            Exp e14;
+            e14 = sym[5];
+            list_add(interp, &d13, e14);
+            Exp e15;
+            e15 = mknum(5.0);
+            list_add(interp, &d13, e15);
+            e12 = mklist(interp, d13);
+        }
+        list_add(interp, &d0, e12);
+        lit[0] = mklist(interp, d0);
+    }
+    interp_pin(interp, lit[0]);
+    lit[1] = sym[6];
+    interp_pin(interp, lit[1]);
+    prim[0] = global_ref(interp, sym[7]).cproc;
+}
+
+static void run(Interp *interp)
+{
+    // (define f (lambda (x) (car x)))
+    defined[0] = true;
+    interp_define(interp, "f", mkcproc(proc_0_entry));
+    // (guard (e (1 (quote caught))) (f 5))
+    eval_form(interp, lit[0]);
+    // (define h (lambda (x) (+ x 1)))
+    defined[1] = true;
+    interp_define(interp, "h", mkcproc(proc_1_entry));
+    // (h (quote a b))
+    gc_maybe_collect(interp);
+    {
+        if (!defined[1]) {
+            undefined(interp, sym[0]);
+        }
+        Exp v0 = proc_1(interp, lit[1]);
+        show(interp, v0);
+    }
+}
+
+int main(void)
+{
+    Interp *interp = interp_new();
+    // forms left to the interpreter were optimized when compiled
+    interp->optimize = false;
+    init(interp);
+    run(interp);
+    interp_free(interp);
+    return 0;
+}
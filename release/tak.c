@@ -0,0 +1,186 @@
+// Compiled from bench/tak.scm by scheme -c.
+
+#include "scheme.h"
+#include "gcobject.h"
+#include "ht.h"
+
+#define VOID_EXP ((Exp) { .type = EXP_VOID })
+
+static inline noreturn void undefined(Interp *interp, Exp name)
+{
+    die(interp, "undefined symbol: %s\n", AS_SYM(name));
+}
+
+static inline Exp global_ref(Interp *interp, Exp name)
+{
+    Exp value;
+    if (!ht_lookup(&ENV_HT(interp->global), name, &value)) {
+        undefined(interp, name);
+    }
+    return value;
+}
+
+// Raise a stack overflow past the limit run() set, as proc_call does.
+static inline void check_stack(Interp *interp)
+{
+    if ((uintptr_t) __builtin_frame_address(0) < interp->stack_limit) {
+        stack_overflow(interp);
+    }
+}
+
+static inline Exp proc_ref(Interp *interp, Exp proc)
+{
+    if (!is_proc(proc)) {
+        die(interp, "error: not a procedure\n");
+    }
+    return proc;
+}
+
+static inline Exp call(Interp *interp, Exp proc, List args)
+{
+    return proc.type == EXP_C_PROC ? proc.cproc(interp, args)
+                                   : proc_call(interp, &AS_PROC(proc), args);
+}
+
+// Print the value of a top-level form.
+static inline void show(Interp *interp, Exp val)
+{
+    print_to(interp->out, val);
+    if (val.type != EXP_VOID && val.type != EXP_EMPTY) {
+        writer_putc(interp->out, '\n');
+    }
+}
+
+// Run a form the compiler left to the interpreter.
+static inline void eval_form(Interp *interp, Exp form)
+{
+    Exp val = interp_eval(interp, form);
+    show(interp, val);
+    interp_unpin(interp, val);
+}
+
+static Exp sym[3];
+static CProc prim[2];
+static bool defined[1];
+
+static double proc_0_num(Interp *interp, double p0, double p1, double p2);
+static Exp proc_0(Interp *interp, Exp p0, Exp p1, Exp p2);
+
+// tak
+static double proc_0_num(Interp *interp, double p0, double p1, double p2)
+{
+    check_stack(interp);
+top:;
+    double v4 = (double) (p1 < p0);
+    double v5 = (double) (v4 == 0);
+    double v12;
+    if (v5 != 0) {
+        v12 = p2;
+    } else {
+        double v6 = (p0 - 1.0);
+        double v7 = proc_0_num(interp, v6, p1, p2);
+        double v8 = (p1 - 1.0);
+        double v9 = proc_0_num(interp, v8, p2, p0);
+        double v10 = (p2 - 1.0);
+        double v11 = proc_0_num(interp, v10, p0, p1);
+        p0 = v7;
+        p1 = v9;
+        p2 = v11;
+        goto top;
+    }
+    return v12;
+}
+
+// tak
+static Exp proc_0(Interp *interp, Exp p0, Exp p1, Exp p2)
+{
+    check_stack(interp);
+top:;
+    if (is_number(p0) && is_number(p1) && is_number(p2)) {
+        return mknum(proc_0_num(interp, p0.number, p1.number, p2.number));
+    }
+    Exp a4_data[] = { p1, p0 };
+    List a4 = { .data = a4_data, .size = 2, .cap = 2 };
+    double v5 = scheme_lt(interp, a4).number;
+    double v6 = (double) (v5 == 0);
+    Exp v16;
+    if (v6 != 0) {
+        v16 = p2;
+    } else {
+        Exp a7_data[] = { p0, mknum(1.0) };
+        List a7 = { .data = a7_data, .size = 2, .cap = 2 };
+        double v8 = scheme_sub(interp, a7).number;
+        Exp v9 = proc_0(interp, mknum(v8), p1, p2);
+        Exp a10_data[] = { p1, mknum(1.0) };
+        List a10 = { .data = a10_data, .size = 2, .cap = 2 };
+        double v11 = scheme_sub(interp, a10).number;
+        Exp v12 = proc_0(interp, mknum(v11), p2, p0);
+        Exp a13_data[] = { p2, mknum(1.0) };
+        List a13 = { .data = a13_data, .size = 2, .cap = 2 };
+        double v14 = scheme_sub(interp, a13).number;
+        Exp v15 = proc_0(interp, mknum(v14), p0, p1);
+        p0 = v9;
+        p1 = v12;
+        p2 = v15;
+        goto top;
+    }
+    return v16;
+}
+
+static Exp proc_0_entry(Interp *interp, List args)
+{
+    if (args.size != 3) {
+        die(interp, "%s: arity mismatch\n", "tak");
+    }
+    return proc_0(interp, args.data[0], args.data[1], args.data[2]);
+}
+
+static void init(Interp *interp)
+{
+    sym[0] = interp_symbol(interp, "tak");
+    interp_pin(interp, sym[0]);
+    sym[1] = interp_symbol(interp, "display");
+    interp_pin(interp, sym[1]);
+    sym[2] = interp_symbol(interp, "newline");
+    interp_pin(interp, sym[2]);
+    prim[0] = global_ref(interp, sym[1]).cproc;
+    prim[1] = global_ref(interp, sym[2]).cproc;
+}
+
+static void run(Interp *interp)
+{
+    stack_enter(interp);
+    // (define tak (lambda (x y z) (if (not (< y x)) z (tak (tak (- x 1) y z) ( ...
+    defined[0] = true;
+    interp_define(interp, "tak", mkcproc(proc_0_entry));
+    // (display (tak 18 12 6))
+    gc_maybe_collect(interp);
+    {
+        if (!defined[0]) {
+            undefined(interp, sym[0]);
+        }
+        double v0 = proc_0_num(interp, 18.0, 12.0, 6.0);
+        Exp a1_data[] = { mknum(v0) };
+        List a1 = { .data = a1_data, .size = 1, .cap = 1 };
+        Exp v2 = prim[0](interp, a1);
+        show(interp, v2);
+    }
+    // (newline)
+    gc_maybe_collect(interp);
+    {
+        List a0 = VECTOR_INIT();
+        Exp v1 = prim[1](interp, a0);
+        show(interp, v1);
+    }
+}
+
+int main(void)
+{
+    Interp *interp = interp_new();
+    // forms left to the interpreter were optimized when compiled
+    interp->optimize = false;
+    init(interp);
+    run(interp);
+    interp_free(interp);
+    return 0;
+}
@@ -0,0 +1,233 @@
+// Compiled from test.scm by scheme -c.
+
+#include "scheme.h"
+#include "gcobject.h"
+#include "ht.h"
+
+#define VOID_EXP ((Exp) { .type = EXP_VOID })
+
+static inline noreturn void undefined(Interp *interp, Exp name)
+{
+    die(interp, "undefined symbol: %s\n", AS_SYM(name));
+}
+
+static inline Exp global_ref(Interp *interp, Exp name)
+{
+    Exp value;
+    if (!ht_lookup(&ENV_HT(interp->global), name, &value)) {
+        undefined(interp, name);
+    }
+    return value;
+}
+
+static inline Exp proc_ref(Interp *interp, Exp proc)
+{
+    if (!is_proc(proc)) {
+        die(interp, "error: not a procedure\n");
+    }
+    return proc;
+}
+
+static inline Exp call(Interp *interp, Exp proc, List args)
+{
+    return proc.type == EXP_C_PROC ? proc.cproc(interp, args)
+                                   : proc_call(interp, &AS_PROC(proc), args);
+}
+
+// Print the value of a top-level form.
+static inline void show(Interp *interp, Exp val)
+{
+    print_to(interp->out, val);
+    if (val.type != EXP_VOID && val.type != EXP_EMPTY) {
+        writer_putc(interp->out, '\n');
+    }
+}
+
+// Run a form the compiler left to the interpreter.
+static inline void eval_form(Interp *interp, Exp form)
+{
+    Exp val = interp_eval(interp, form);
+    show(interp, val);
+    interp_unpin(interp, val);
+}
+
+static Exp sym[11];
+static Exp lit[3];
+static CProc prim[6];
+static bool defined[1];
+
+static Exp proc_0(Interp *interp, Exp p0, Exp p1);
+
+// map
+static Exp proc_0(Interp *interp, Exp p0, Exp p1)
+{
+    Exp a3_data[] = { p1 };
+    List a3 = { .data = a3_data, .size = 1, .cap = 1 };
+    Exp v4 = prim[0](interp, a3);
+    Exp v15;
+    if (is_true(v4)) {
+        v15 = lit[1];
+    } else {
+        Exp v5 = proc_ref(interp, p0);
+        Exp a6_data[] = { p1 };
+        List a6 = { .data = a6_data, .size = 1, .cap = 1 };
+        Exp v7 = prim[1](interp, a6);
+        Exp a8_data[] = { v7 };
+        List a8 = { .data = a8_data, .size = 1, .cap = 1 };
+        Exp v9 = call(interp, v5, a8);
+        Exp a10_data[] = { p1 };
+        List a10 = { .data = a10_data, .size = 1, .cap = 1 };
+        Exp v11 = prim[2](interp, a10);
+        Exp v12 = proc_0(interp, p0, v11);
+        Exp a13_data[] = { v9, v12 };
+        List a13 = { .data = a13_data, .size = 2, .cap = 2 };
+        Exp v14 = prim[3](interp, a13);
+        v15 = v14;
+    }
+    return v15;
+}
+
+static Exp proc_0_entry(Interp *interp, List args)
+{
+    if (args.size != 2) {
+        die(interp, "%s: arity mismatch\n", "map");
+    }
+    return proc_0(interp, args.data[0], args.data[1]);
+}
+
+static void init(Interp *interp)
+{
+    sym[0] = interp_symbol(interp, "map");
+    interp_pin(interp, sym[0]);
+    sym[1] = interp_symbol(interp, "display");
+    interp_pin(interp, sym[1]);
+    sym[2] = interp_symbol(interp, "lambda");
+    interp_pin(interp, sym[2]);
+    sym[3] = interp_symbol(interp, "x");
+    interp_pin(interp, sym[3]);
+    sym[4] = interp_symbol(interp, "*");
+    interp_pin(interp, sym[4]);
+    sym[5] = interp_symbol(interp, "list");
+    interp_pin(interp, sym[5]);
+    sym[6] = interp_symbol(interp, "null\?");
+    interp_pin(interp, sym[6]);
+    sym[7] = interp_symbol(interp, "car");
+    interp_pin(interp, sym[7]);
+    sym[8] = interp_symbol(interp, "cdr");
+    interp_pin(interp, sym[8]);
+    sym[9] = interp_symbol(interp, "cons");
+    interp_pin(interp, sym[9]);
+    sym[10] = interp_symbol(interp, "newline");
+    interp_pin(interp, sym[10]);
+    {
+        List d0 = VECTOR_INIT();
+        lit[0] = mklist(interp, d0);
+    }
+    interp_pin(interp, lit[0]);
+    {
+        List d1 = VECTOR_INIT();
+        lit[1] = mklist(interp, d1);
+    }
+    interp_pin(interp, lit[1]);
+    {
+        List d2 = VECTOR_INIT();
+        Exp e3;
+        e3 = sym[1];
+        list_add(interp, &d2, e3);
+        Exp e4;
+        {
+            List d5 = VECTOR_INIT();
+            Exp e6;
+            e6 = sym[0];
+            list_add(interp, &d5, e6);
+            Exp e7;
+            {
+                List d8 = VECTOR_INIT();
+                Exp e9;
+                e9 = sym[2];
+                list_add(interp, &d8, e9);
+                Exp e10;
+                {
+                    List d11 = VECTOR_INIT();
+                    Exp e12;
+                    e12 = sym[3];
+                    list_add(interp, &d11, e12);
+                    e10 = mklist(interp, d11);
+                }
+                list_add(interp, &d8, e10);
+                Exp e13;
+                {
+                    List d14 = VECTOR_INIT();
+                    Exp e15;
+                    e15 = sym[4];
+                    list_add(interp, &d14, e15);
+                    Exp e16;
+                    e16 = sym[3];
+                    list_add(interp, &d14, e16);
+                    Exp e17;
+                    e17 = sym[3];
+                    list_add(interp, &d14, e17);
+                    e13 = mklist(interp, d14);
+                }
+                list_add(interp, &d8, e13);
+                e7 = mklist(interp, d8);
+            }
+            list_add(interp, &d5, e7);
+            Exp e18;
+            {
+                List d19 = VECTOR_INIT();
+                Exp e20;
+                e20 = sym[5];
+                list_add(interp, &d19, e20);
+                Exp e21;
+                e21 = mknum(1.0);
+                list_add(interp, &d19, e21);
+                Exp e22;
+                e22 = mknum(2.0);
+                list_add(interp, &d19, e22);
+                Exp e23;
+                e23 = mknum(3.0);
+                list_add(interp, &d19, e23);
+                e18 = mklist(interp, d19);
+            }
+            list_add(interp, &d5, e18);
+            e4 = mklist(interp, d5);
+        }
+        list_add(interp, &d2, e4);
+        lit[2] = mklist(interp, d2);
+    }
+    interp_pin(interp, lit[2]);
+    prim[0] = global_ref(interp, sym[6]).cproc;
+    prim[1] = global_ref(interp, sym[7]).cproc;
+    prim[2] = global_ref(interp, sym[8]).cproc;
+    prim[3] = global_ref(interp, sym[9]).cproc;
+    prim[4] = global_ref(interp, sym[1]).cproc;
+    prim[5] = global_ref(interp, sym[10]).cproc;
+}
+
+static void run(Interp *interp)
+{
+    // (define map (lambda (fn lst) (if (null  lst) (quote ()) (cons (fn (car l ...
+    defined[0] = true;
+    interp_define(interp, "map", mkcproc(proc_0_entry));
+    // (display (map (lambda (x) (* x x)) (list 1 2 3)))
+    eval_form(interp, lit[2]);
+    // (newline)
+    gc_maybe_collect(interp);
+    {
+        List a0 = VECTOR_INIT();
+        Exp v1 = prim[5](interp, a0);
+        show(interp, v1);
+    }
+}
+
+int main(void)
+{
+    Interp *interp = interp_new();
+    // forms left to the interpreter were optimized when compiled
+    interp->optimize = false;
+    init(interp);
+    run(interp);
+    interp_free(interp);
+    return 0;
+}
@@ -0,0 +1,732 @@
+// Compiled from tests/threads-forms.scm by scheme -c.
+
+#include "scheme.h"
+#include "gcobject.h"
+#include "ht.h"
+
+#define VOID_EXP ((Exp) { .type = EXP_VOID })
+
+static inline noreturn void undefined(Interp *interp, Exp name)
+{
+    die(interp, "undefined symbol: %s\n", AS_SYM(name));
+}
+
+static inline Exp global_ref(Interp *interp, Exp name)
+{
+    Exp value;
+    if (!ht_lookup(&ENV_HT(interp->global), name, &value)) {
+        undefined(interp, name);
+    }
+    return value;
+}
+
+// Raise a stack overflow past the limit run() set, as proc_call does.
+static inline void check_stack(Interp *interp)
+{
+    if ((uintptr_t) __builtin_frame_address(0) < interp->stack_limit) {
+        stack_overflow(interp);
+    }
+}
+
+static inline Exp proc_ref(Interp *interp, Exp proc)
+{
+    if (!is_proc(proc)) {
+        die(interp, "error: not a procedure\n");
+    }
+    return proc;
+}
+
+static inline Exp call(Interp *interp, Exp proc, List args)
+{
+    return proc.type == EXP_C_PROC ? proc.cproc(interp, args)
+                                   : proc_call(interp, &AS_PROC(proc), args);
+}
+
+// Print the value of a top-level form.
+static inline void show(Interp *interp, Exp val)
+{
+    print_to(interp->out, val);
+    if (val.type != EXP_VOID && val.type != EXP_EMPTY) {
+        writer_putc(interp->out, '\n');
+    }
+}
+
+// Run a form the compiler left to the interpreter.
+static inline void eval_form(Interp *interp, Exp form)
+{
+    Exp val = interp_eval(interp, form);
+    show(interp, val);
+    interp_unpin(interp, val);
+}
+
+static Exp sym[33];
+static Exp lit[4];
+static CProc prim[8];
+
+
+static void init(Interp *interp)
+{
+    sym[0] = interp_symbol(interp, "cons-t");
+    interp_pin(interp, sym[0]);
+    sym[1] = interp_symbol(interp, "prod");
+    interp_pin(interp, sym[1]);
+    sym[2] = interp_symbol(interp, "ch");
+    interp_pin(interp, sym[2]);
+    sym[3] = interp_symbol(interp, "waiter");
+    interp_pin(interp, sym[3]);
+    sym[4] = interp_symbol(interp, "define");
+    interp_pin(interp, sym[4]);
+    sym[5] = interp_symbol(interp, "spawn");
+    interp_pin(interp, sym[5]);
+    sym[6] = interp_symbol(interp, "lambda");
+    interp_pin(interp, sym[6]);
+    sym[7] = interp_symbol(interp, "let");
+    interp_pin(interp, sym[7]);
+    sym[8] = interp_symbol(interp, "loop");
+    interp_pin(interp, sym[8]);
+    sym[9] = interp_symbol(interp, "i");
+    interp_pin(interp, sym[9]);
+    sym[10] = interp_symbol(interp, "if");
+    interp_pin(interp, sym[10]);
+    sym[11] = interp_symbol(interp, "<");
+    interp_pin(interp, sym[11]);
+    sym[12] = interp_symbol(interp, "begin");
+    interp_pin(interp, sym[12]);
+    sym[13] = interp_symbol(interp, "channel-send");
+    interp_pin(interp, sym[13]);
+    sym[14] = interp_symbol(interp, "list");
+    interp_pin(interp, sym[14]);
+    sym[15] = interp_symbol(interp, "*");
+    interp_pin(interp, sym[15]);
+    sym[16] = interp_symbol(interp, "+");
+    interp_pin(interp, sym[16]);
+    sym[17] = interp_symbol(interp, "quote");
+    interp_pin(interp, sym[17]);
+    sym[18] = interp_symbol(interp, "done");
+    interp_pin(interp, sym[18]);
+    sym[19] = interp_symbol(interp, "sum");
+    interp_pin(interp, sym[19]);
+    sym[20] = interp_symbol(interp, "v");
+    interp_pin(interp, sym[20]);
+    sym[21] = interp_symbol(interp, "channel-receive");
+    interp_pin(interp, sym[21]);
+    sym[22] = interp_symbol(interp, "car");
+    interp_pin(interp, sym[22]);
+    sym[23] = interp_symbol(interp, "cdr");
+    interp_pin(interp, sym[23]);
+    sym[24] = interp_symbol(interp, "guard");
+    interp_pin(interp, sym[24]);
+    sym[25] = interp_symbol(interp, "e");
+    interp_pin(interp, sym[25]);
+    sym[26] = interp_symbol(interp, "deadlock");
+    interp_pin(interp, sym[26]);
+    sym[27] = interp_symbol(interp, "lonely");
+    interp_pin(interp, sym[27]);
+    sym[28] = interp_symbol(interp, "make-channel");
+    interp_pin(interp, sym[28]);
+    sym[29] = interp_symbol(interp, "cons");
+    interp_pin(interp, sym[29]);
+    sym[30] = interp_symbol(interp, "length");
+    interp_pin(interp, sym[30]);
+    sym[31] = interp_symbol(interp, "join");
+    interp_pin(interp, sym[31]);
+    sym[32] = interp_symbol(interp, "iota");
+    interp_pin(interp, sym[32]);
+    {
+        List d0 = VECTOR_INIT();
+        Exp e1;
+        e1 = sym[4];
+        list_add(interp, &d0, e1);
+        Exp e2;
+        e2 = sym[1];
+        list_add(interp, &d0, e2);
+        Exp e3;
+        {
+            List d4 = VECTOR_INIT();
+            Exp e5;
+            e5 = sym[5];
+            list_add(interp, &d4, e5);
+            Exp e6;
+            {
+                List d7 = VECTOR_INIT();
+                Exp e8;
+                e8 = sym[6];
+                list_add(interp, &d7, e8);
+                Exp e9;
+                {
+                    List d10 = VECTOR_INIT();
+                    e9 = mklist(interp, d10);
+                }
+                list_add(interp, &d7, e9);
+                Exp e11;
+                {
+                    List d12 = VECTOR_INIT();
+                    Exp e13;
+                    e13 = sym[7];
+                    list_add(interp, &d12, e13);
+                    Exp e14;
+                    e14 = sym[8];
+                    list_add(interp, &d12, e14);
+                    Exp e15;
+                    {
+                        List d16 = VECTOR_INIT();
+                        Exp e17;
+                        {
+                            List d18 = VECTOR_INIT();
+                            Exp e19;
+                            e19 = sym[9];
+                            list_add(interp, &d18, e19);
+                            Exp e20;
+                            e20 = mknum(0.0);
+                            list_add(interp, &d18, e20);
+                            e17 = mklist(interp, d18);
+                        }
+                        list_add(interp, &d16, e17);
+                        e15 = mklist(interp, d16);
+                    }
+                    list_add(interp, &d12, e15);
+                    Exp e21;
+                    {
+                        List d22 = VECTOR_INIT();
+                        Exp e23;
+                        e23 = sym[10];
+                        list_add(interp, &d22, e23);
+                        Exp e24;
+                        {
+                            List d25 = VECTOR_INIT();
+                            Exp e26;
+                            e26 = sym[11];
+                            list_add(interp, &d25, e26);
+                            Exp e27;
+                            e27 = sym[9];
+                            list_add(interp, &d25, e27);
+                            Exp e28;
+                            e28 = mknum(1000.0);
+                            list_add(interp, &d25, e28);
+                            e24 = mklist(interp, d25);
+                        }
+                        list_add(interp, &d22, e24);
+                        Exp e29;
+                        {
+                            List d30 = VECTOR_INIT();
+                            Exp e31;
+                            e31 = sym[12];
+                            list_add(interp, &d30, e31);
+                            Exp e32;
+                            {
+                                List d33 = VECTOR_INIT();
+                                Exp e34;
+                                e34 = sym[13];
+                                list_add(interp, &d33, e34);
+                                Exp e35;
+                                e35 = sym[2];
+                                list_add(interp, &d33, e35);
+                                Exp e36;
+                                {
+                                    List d37 = VECTOR_INIT();
+                                    Exp e38;
+                                    e38 = sym[14];
+                                    list_add(interp, &d37, e38);
+                                    Exp e39;
+                                    e39 = sym[9];
+                                    list_add(interp, &d37, e39);
+                                    Exp e40;
+                                    {
+                                        List d41 = VECTOR_INIT();
+                                        Exp e42;
+                                        e42 = sym[15];
+                                        list_add(interp, &d41, e42);
+                                        Exp e43;
+                                        e43 = sym[9];
+                                        list_add(interp, &d41, e43);
+                                        Exp e44;
+                                        e44 = sym[9];
+                                        list_add(interp, &d41, e44);
+                                        e40 = mklist(interp, d41);
+                                    }
+                                    list_add(interp, &d37, e40);
+                                    e36 = mklist(interp, d37);
+                                }
+                                list_add(interp, &d33, e36);
+                                e32 = mklist(interp, d33);
+                            }
+                            list_add(interp, &d30, e32);
+                            Exp e45;
+                            {
+                                List d46 = VECTOR_INIT();
+                                Exp e47;
+                                e47 = sym[8];
+                                list_add(interp, &d46, e47);
+                                Exp e48;
+                                {
+                                    List d49 = VECTOR_INIT();
+                                    Exp e50;
+                                    e50 = sym[16];
+                                    list_add(interp, &d49, e50);
+                                    Exp e51;
+                                    e51 = sym[9];
+                                    list_add(interp, &d49, e51);
+                                    Exp e52;
+                                    e52 = mknum(1.0);
+                                    list_add(interp, &d49, e52);
+                                    e48 = mklist(interp, d49);
+                                }
+                                list_add(interp, &d46, e48);
+                                e45 = mklist(interp, d46);
+                            }
+                            list_add(interp, &d30, e45);
+                            e29 = mklist(interp, d30);
+                        }
+                        list_add(interp, &d22, e29);
+                        Exp e53;
+                        {
+                            List d54 = VECTOR_INIT();
+                            Exp e55;
+                            e55 = sym[17];
+                            list_add(interp, &d54, e55);
+                            Exp e56;
+                            e56 = sym[18];
+                            list_add(interp, &d54, e56);
+                            e53 = mklist(interp, d54);
+                        }
+                        list_add(interp, &d22, e53);
+                        e21 = mklist(interp, d22);
+                    }
+                    list_add(interp, &d12, e21);
+                    e11 = mklist(interp, d12);
+                }
+                list_add(interp, &d7, e11);
+                e6 = mklist(interp, d7);
+            }
+            list_add(interp, &d4, e6);
+            e3 = mklist(interp, d4);
+        }
+        list_add(interp, &d0, e3);
+        lit[0] = mklist(interp, d0);
+    }
+    interp_pin(interp, lit[0]);
+    {
+        List d57 = VECTOR_INIT();
+        Exp e58;
+        e58 = sym[4];
+        list_add(interp, &d57, e58);
+        Exp e59;
+        e59 = sym[0];
+        list_add(interp, &d57, e59);
+        Exp e60;
+        {
+            List d61 = VECTOR_INIT();
+            Exp e62;
+            e62 = sym[5];
+            list_add(interp, &d61, e62);
+            Exp e63;
+            {
+                List d64 = VECTOR_INIT();
+                Exp e65;
+                e65 = sym[6];
+                list_add(interp, &d64, e65);
+                Exp e66;
+                {
+                    List d67 = VECTOR_INIT();
+                    e66 = mklist(interp, d67);
+                }
+                list_add(interp, &d64, e66);
+                Exp e68;
+                {
+                    List d69 = VECTOR_INIT();
+                    Exp e70;
+                    e70 = sym[7];
+                    list_add(interp, &d69, e70);
+                    Exp e71;
+                    e71 = sym[8];
+                    list_add(interp, &d69, e71);
+                    Exp e72;
+                    {
+                        List d73 = VECTOR_INIT();
+                        Exp e74;
+                        {
+                            List d75 = VECTOR_INIT();
+                            Exp e76;
+                            e76 = sym[9];
+                            list_add(interp, &d75, e76);
+                            Exp e77;
+                            e77 = mknum(0.0);
+                            list_add(interp, &d75, e77);
+                            e74 = mklist(interp, d75);
+                        }
+                        list_add(interp, &d73, e74);
+                        Exp e78;
+                        {
+                            List d79 = VECTOR_INIT();
+                            Exp e80;
+                            e80 = sym[19];
+                            list_add(interp, &d79, e80);
+                            Exp e81;
+                            e81 = mknum(0.0);
+                            list_add(interp, &d79, e81);
+                            e78 = mklist(interp, d79);
+                        }
+                        list_add(interp, &d73, e78);
+                        e72 = mklist(interp, d73);
+                    }
+                    list_add(interp, &d69, e72);
+                    Exp e82;
+                    {
+                        List d83 = VECTOR_INIT();
+                        Exp e84;
+                        e84 = sym[10];
+                        list_add(interp, &d83, e84);
+                        Exp e85;
+                        {
+                            List d86 = VECTOR_INIT();
+                            Exp e87;
+                            e87 = sym[11];
+                            list_add(interp, &d86, e87);
+                            Exp e88;
+                            e88 = sym[9];
+                            list_add(interp, &d86, e88);
+                            Exp e89;
+                            e89 = mknum(1000.0);
+                            list_add(interp, &d86, e89);
+                            e85 = mklist(interp, d86);
+                        }
+                        list_add(interp, &d83, e85);
+                        Exp e90;
+                        {
+                            List d91 = VECTOR_INIT();
+                            Exp e92;
+                            e92 = sym[7];
+                            list_add(interp, &d91, e92);
+                            Exp e93;
+                            {
+                                List d94 = VECTOR_INIT();
+                                Exp e95;
+                                {
+                                    List d96 = VECTOR_INIT();
+                                    Exp e97;
+                                    e97 = sym[20];
+                                    list_add(interp, &d96, e97);
+                                    Exp e98;
+                                    {
+                                        List d99 = VECTOR_INIT();
+                                        Exp e100;
+                                        e100 = sym[21];
+                                        list_add(interp, &d99, e100);
+                                        Exp e101;
+                                        e101 = sym[2];
+                                        list_add(interp, &d99, e101);
+                                        e98 = mklist(interp, d99);
+                                    }
+                                    list_add(interp, &d96, e98);
+                                    e95 = mklist(interp, d96);
+                                }
+                                list_add(interp, &d94, e95);
+                                e93 = mklist(interp, d94);
+                            }
+                            list_add(interp, &d91, e93);
+                            Exp e102;
+                            {
+                                List d103 = VECTOR_INIT();
+                                Exp e104;
+                                e104 = sym[8];
+                                list_add(interp, &d103, e104);
+                                Exp e105;
+                                {
+                                    List d106 = VECTOR_INIT();
+                                    Exp e107;
+                                    e107 = sym[16];
+                                    list_add(interp, &d106, e107);
+                                    Exp e108;
+                                    e108 = sym[9];
+                                    list_add(interp, &d106, e108);
+                                    Exp e109;
+                                    e109 = mknum(1.0);
+                                    list_add(interp, &d106, e109);
+                                    e105 = mklist(interp, d106);
+                                }
+                                list_add(interp, &d103, e105);
+                                Exp e110;
+                                {
+                                    List d111 = VECTOR_INIT();
+                                    Exp e112;
+                                    e112 = sym[16];
+                                    list_add(interp, &d111, e112);
+                                    Exp e113;
+                                    e113 = sym[19];
+                                    list_add(interp, &d111, e113);
+                                    Exp e114;
+                                    {
+                                        List d115 = VECTOR_INIT();
+                                        Exp e116;
+                                        e116 = sym[22];
+                                        list_add(interp, &d115, e116);
+                                        Exp e117;
+                                        {
+                                            List d118 = VECTOR_INIT();
+                                            Exp e119;
+                                            e119 = sym[23];
+                                            list_add(interp, &d118, e119);
+                                            Exp e120;
+                                            e120 = sym[20];
+                                            list_add(interp, &d118, e120);
+                                            e117 = mklist(interp, d118);
+                                        }
+                                        list_add(interp, &d115, e117);
+                                        e114 = mklist(interp, d115);
+                                    }
+                                    list_add(interp, &d111, e114);
+                                    e110 = mklist(interp, d111);
+                                }
+                                list_add(interp, &d103, e110);
+                                e102 = mklist(interp, d103);
+                            }
+                            list_add(interp, &d91, e102);
+                            e90 = mklist(interp, d91);
+                        }
+                        list_add(interp, &d83, e90);
+                        Exp e121;
+                        e121 = sym[19];
+                        list_add(interp, &d83, e121);
+                        e82 = mklist(interp, d83);
+                    }
+                    list_add(interp, &d69, e82);
+                    e68 = mklist(interp, d69);
+                }
+                list_add(interp, &d64, e68);
+                e63 = mklist(interp, d64);
+            }
+            list_add(interp, &d61, e63);
+            e60 = mklist(interp, d61);
+        }
+        list_add(interp, &d57, e60);
+        lit[1] = mklist(interp, d57);
+    }
+    interp_pin(interp, lit[1]);
+    {
+        List d122 = VECTOR_INIT();
+        Exp e123;
+        e123 = sym[4];
+        list_add(interp, &d122, e123);
+        Exp e124;
+        e124 = sym[3];
+        list_add(interp, &d122, e124);
+        Exp e125;
+        {
+            List d126 = VECTOR_INIT();
+            Exp e127;
+            e127 = sym[5];
+            list_add(interp, &d126, e127);
+            Exp e128;
+            {
+                List d129 = VECTOR_INIT();
+                Exp e130;
+                e130 = sym[6];
+                list_add(interp, &d129, e130);
+                Exp e131;
+                {
+                    List d132 = VECTOR_INIT();
+                    e131 = mklist(interp, d132);
+                }
+                list_add(interp, &d129, e131);
+                Exp e133;
+                {
+                    List d134 = VECTOR_INIT();
+                    Exp e135;
+                    e135 = sym[21];
+                    list_add(interp, &d134, e135);
+                    Exp e136;
+                    e136 = sym[2];
+                    list_add(interp, &d134, e136);
+                    e133 = mklist(interp, d134);
+                }
+                list_add(interp, &d129, e133);
+                e128 = mklist(interp, d129);
+            }
+            list_add(interp, &d126, e128);
+            e125 = mklist(interp, d126);
+        }
+        list_add(interp, &d122, e125);
+        lit[2] = mklist(interp, d122);
+    }
+    interp_pin(interp, lit[2]);
+    {
+        List d137 = VECTOR_INIT();
+        Exp e138;
+        e138 = sym[24];
+        list_add(interp, &d137, e138);
+        Exp e139;
+        {
+            List d140 = VECTOR_INIT();
+            Exp e141;
+            e141 = sym[25];
+            list_add(interp, &d140, e141);
+            Exp e142;
+            {
+                List d143 = VECTOR_INIT();
+                Exp e144;
+                e144 = mknum(1.0);
+                list_add(interp, &d143, e144);
+                Exp e145;
+                {
+                    List d146 = VECTOR_INIT();
+                    Exp e147;
+                    e147 = sym[17];
+                    list_add(interp, &d146, e147);
+                    Exp e148;
+                    e148 = sym[26];
+                    list_add(interp, &d146, e148);
+                    e145 = mklist(interp, d146);
+                }
+                list_add(interp, &d143, e145);
+                e142 = mklist(interp, d143);
+            }
+            list_add(interp, &d140, e142);
+            e139 = mklist(interp, d140);
+        }
+        list_add(interp, &d137, e139);
+        Exp e149;
+        {
+            List d150 = VECTOR_INIT();
+            Exp e151;
+            e151 = sym[21];
+            list_add(interp, &d150, e151);
+            Exp e152;
+            e152 = sym[27];
+            list_add(interp, &d150, e152);
+            e149 = mklist(interp, d150);
+        }
+        list_add(interp, &d137, e149);
+        lit[3] = mklist(interp, d137);
+    }
+    interp_pin(interp, lit[3]);
+    prim[0] = global_ref(interp, sym[28]).cproc;
+    prim[1] = global_ref(interp, sym[5]).cproc;
+    prim[2] = global_ref(interp, sym[14]).cproc;
+    prim[3] = global_ref(interp, sym[29]).cproc;
+    prim[4] = global_ref(interp, sym[30]).cproc;
+    prim[5] = global_ref(interp, sym[31]).cproc;
+    prim[6] = global_ref(interp, sym[32]).cproc;
+    prim[7] = global_ref(interp, sym[13]).cproc;
+}
+
+static void run(Interp *interp)
+{
+    stack_enter(interp);
+    // (define ch (make-channel 2))
+    gc_maybe_collect(interp);
+    {
+        Exp a0_data[] = { mknum(2.0) };
+        List a0 = { .data = a0_data, .size = 1, .cap = 1 };
+        Exp v1 = prim[0](interp, a0);
+        interp_define(interp, "ch", v1);
+    }
+    // (define prod (spawn (lambda () (let loop ((i 0)) (if (< i 1000) (begin ( ...
+    eval_form(interp, lit[0]);
+    // (define garbage (let loop ((i 0) (acc (list))) (if (< i 100000) (loop (+ ...
+    gc_maybe_collect(interp);
+    {
+        List a0 = VECTOR_INIT();
+        Exp v1 = prim[2](interp, a0);
+        double l4 = 0.0;
+        Exp l5 = v1;
+        Exp v17;
+        loop2:;
+        double v6 = (double) (l4 < 100000.0);
+        Exp v16;
+        if (v6 != 0) {
+            double v7 = (0.0 + l4 + 1.0);
+            Exp a8_data[] = { mknum(l4) };
+            List a8 = { .data = a8_data, .size = 1, .cap = 1 };
+            Exp v9 = prim[2](interp, a8);
+            List a10 = VECTOR_INIT();
+            Exp v11 = prim[2](interp, a10);
+            Exp a12_data[] = { v9, v11 };
+            List a12 = { .data = a12_data, .size = 2, .cap = 2 };
+            Exp v13 = prim[3](interp, a12);
+            l4 = v7;
+            l5 = v13;
+            goto loop2;
+        } else {
+            Exp a14_data[] = { l5 };
+            List a14 = { .data = a14_data, .size = 1, .cap = 1 };
+            Exp v15 = prim[4](interp, a14);
+            v16 = v15;
+        }
+        v17 = v16;
+        interp_define(interp, "garbage", v17);
+    }
+    // (define cons-t (spawn (lambda () (let loop ((i 0) (sum 0)) (if (< i 1000 ...
+    eval_form(interp, lit[1]);
+    // (join cons-t)
+    gc_maybe_collect(interp);
+    {
+        Exp v0 = global_ref(interp, sym[0]);
+        Exp a1_data[] = { v0 };
+        List a1 = { .data = a1_data, .size = 1, .cap = 1 };
+        Exp v2 = prim[5](interp, a1);
+        show(interp, v2);
+    }
+    // (join prod)
+    gc_maybe_collect(interp);
+    {
+        Exp v0 = global_ref(interp, sym[1]);
+        Exp a1_data[] = { v0 };
+        List a1 = { .data = a1_data, .size = 1, .cap = 1 };
+        Exp v2 = prim[5](interp, a1);
+        show(interp, v2);
+    }
+    // (define waiter (spawn (lambda () (channel-receive ch))))
+    eval_form(interp, lit[2]);
+    // (define more-garbage (length (iota 100000)))
+    gc_maybe_collect(interp);
+    {
+        Exp a0_data[] = { mknum(100000.0) };
+        List a0 = { .data = a0_data, .size = 1, .cap = 1 };
+        Exp v1 = prim[6](interp, a0);
+        Exp a2_data[] = { v1 };
+        List a2 = { .data = a2_data, .size = 1, .cap = 1 };
+        Exp v3 = prim[4](interp, a2);
+        interp_define(interp, "more-garbage", v3);
+    }
+    // (channel-send ch (list 1 2 3))
+    gc_maybe_collect(interp);
+    {
+        Exp v0 = global_ref(interp, sym[2]);
+        Exp a1_data[] = { mknum(1.0), mknum(2.0), mknum(3.0) };
+        List a1 = { .data = a1_data, .size = 3, .cap = 3 };
+        Exp v2 = prim[2](interp, a1);
+        Exp a3_data[] = { v0, v2 };
+        List a3 = { .data = a3_data, .size = 2, .cap = 2 };
+        Exp v4 = prim[7](interp, a3);
+        show(interp, v4);
+    }
+    // (join waiter)
+    gc_maybe_collect(interp);
+    {
+        Exp v0 = global_ref(interp, sym[3]);
+        Exp a1_data[] = { v0 };
+        List a1 = { .data = a1_data, .size = 1, .cap = 1 };
+        Exp v2 = prim[5](interp, a1);
+        show(interp, v2);
+    }
+    // (define lonely (make-channel))
+    gc_maybe_collect(interp);
+    {
+        List a0 = VECTOR_INIT();
+        Exp v1 = prim[0](interp, a0);
+        interp_define(interp, "lonely", v1);
+    }
+    // (guard (e (1 (quote deadlock))) (channel-receive lonely))
+    eval_form(interp, lit[3]);
+}
+
+int main(void)
+{
+    Interp *interp = interp_new();
+    // forms left to the interpreter were optimized when compiled
+    interp->optimize = false;
+    init(interp);
+    run(interp);
+    interp_free(interp);
+    return 0;
+}
@@ -0,0 +1,627 @@
+// Compiled from tests/threads.scm by scheme -c.
+
+#include "scheme.h"
+#include "gcobject.h"
+#include "ht.h"
+
+#define VOID_EXP ((Exp) { .type = EXP_VOID })
+
+static inline noreturn void undefined(Interp *interp, Exp name)
+{
+    die(interp, "undefined symbol: %s\n", AS_SYM(name));
+}
+
+static inline Exp global_ref(Interp *interp, Exp name)
+{
+    Exp value;
+    if (!ht_lookup(&ENV_HT(interp->global), name, &value)) {
+        undefined(interp, name);
+    }
+    return value;
+}
+
+// Raise a stack overflow past the limit run() set, as proc_call does.
+static inline void check_stack(Interp *interp)
+{
+    if ((uintptr_t) __builtin_frame_address(0) < interp->stack_limit) {
+        stack_overflow(interp);
+    }
+}
+
+static inline Exp proc_ref(Interp *interp, Exp proc)
+{
+    if (!is_proc(proc)) {
+        die(interp, "error: not a procedure\n");
+    }
+    return proc;
+}
+
+static inline Exp call(Interp *interp, Exp proc, List args)
+{
+    return proc.type == EXP_C_PROC ? proc.cproc(interp, args)
+                                   : proc_call(interp, &AS_PROC(proc), args);
+}
+
+// Print the value of a top-level form.
+static inline void show(Interp *interp, Exp val)
+{
+    print_to(interp->out, val);
+    if (val.type != EXP_VOID && val.type != EXP_EMPTY) {
+        writer_putc(interp->out, '\n');
+    }
+}
+
+// Run a form the compiler left to the interpreter.
+static inline void eval_form(Interp *interp, Exp form)
+{
+    Exp val = interp_eval(interp, form);
+    show(interp, val);
+    interp_unpin(interp, val);
+}
+
+static Exp sym[27];
+static Exp lit[4];
+static CProc prim[4];
+
+
+static void init(Interp *interp)
+{
+    sym[0] = interp_symbol(interp, "let");
+    interp_pin(interp, sym[0]);
+    sym[1] = interp_symbol(interp, "t");
+    interp_pin(interp, sym[1]);
+    sym[2] = interp_symbol(interp, "spawn");
+    interp_pin(interp, sym[2]);
+    sym[3] = interp_symbol(interp, "lambda");
+    interp_pin(interp, sym[3]);
+    sym[4] = interp_symbol(interp, "join");
+    interp_pin(interp, sym[4]);
+    sym[5] = interp_symbol(interp, "ch");
+    interp_pin(interp, sym[5]);
+    sym[6] = interp_symbol(interp, "make-channel");
+    interp_pin(interp, sym[6]);
+    sym[7] = interp_symbol(interp, "producer");
+    interp_pin(interp, sym[7]);
+    sym[8] = interp_symbol(interp, "loop");
+    interp_pin(interp, sym[8]);
+    sym[9] = interp_symbol(interp, "i");
+    interp_pin(interp, sym[9]);
+    sym[10] = interp_symbol(interp, "if");
+    interp_pin(interp, sym[10]);
+    sym[11] = interp_symbol(interp, "<");
+    interp_pin(interp, sym[11]);
+    sym[12] = interp_symbol(interp, "begin");
+    interp_pin(interp, sym[12]);
+    sym[13] = interp_symbol(interp, "channel-send");
+    interp_pin(interp, sym[13]);
+    sym[14] = interp_symbol(interp, "+");
+    interp_pin(interp, sym[14]);
+    sym[15] = interp_symbol(interp, "quote");
+    interp_pin(interp, sym[15]);
+    sym[16] = interp_symbol(interp, "done");
+    interp_pin(interp, sym[16]);
+    sym[17] = interp_symbol(interp, "acc");
+    interp_pin(interp, sym[17]);
+    sym[18] = interp_symbol(interp, "list");
+    interp_pin(interp, sym[18]);
+    sym[19] = interp_symbol(interp, "cons");
+    interp_pin(interp, sym[19]);
+    sym[20] = interp_symbol(interp, "channel-receive");
+    interp_pin(interp, sym[20]);
+    sym[21] = interp_symbol(interp, "touch");
+    interp_pin(interp, sym[21]);
+    sym[22] = interp_symbol(interp, "future");
+    interp_pin(interp, sym[22]);
+    sym[23] = interp_symbol(interp, "parallel-map");
+    interp_pin(interp, sym[23]);
+    sym[24] = interp_symbol(interp, "x");
+    interp_pin(interp, sym[24]);
+    sym[25] = interp_symbol(interp, "*");
+    interp_pin(interp, sym[25]);
+    sym[26] = interp_symbol(interp, "iota");
+    interp_pin(interp, sym[26]);
+    {
+        List d0 = VECTOR_INIT();
+        Exp e1;
+        e1 = sym[0];
+        list_add(interp, &d0, e1);
+        Exp e2;
+        {
+            List d3 = VECTOR_INIT();
+            Exp e4;
+            {
+                List d5 = VECTOR_INIT();
+                Exp e6;
+                e6 = sym[1];
+                list_add(interp, &d5, e6);
+                Exp e7;
+                {
+                    List d8 = VECTOR_INIT();
+                    Exp e9;
+                    e9 = sym[2];
+                    list_add(interp, &d8, e9);
+                    Exp e10;
+                    {
+                        List d11 = VECTOR_INIT();
+                        Exp e12;
+                        e12 = sym[3];
+                        list_add(interp, &d11, e12);
+                        Exp e13;
+                        {
+                            List d14 = VECTOR_INIT();
+                            e13 = mklist(interp, d14);
+                        }
+                        list_add(interp, &d11, e13);
+                        Exp e15;
+                        e15 = mknum(5.0);
+                        list_add(interp, &d11, e15);
+                        e10 = mklist(interp, d11);
+                    }
+                    list_add(interp, &d8, e10);
+                    e7 = mklist(interp, d8);
+                }
+                list_add(interp, &d5, e7);
+                e4 = mklist(interp, d5);
+            }
+            list_add(interp, &d3, e4);
+            e2 = mklist(interp, d3);
+        }
+        list_add(interp, &d0, e2);
+        Exp e16;
+        {
+            List d17 = VECTOR_INIT();
+            Exp e18;
+            e18 = sym[4];
+            list_add(interp, &d17, e18);
+            Exp e19;
+            e19 = sym[1];
+            list_add(interp, &d17, e19);
+            e16 = mklist(interp, d17);
+        }
+        list_add(interp, &d0, e16);
+        lit[0] = mklist(interp, d0);
+    }
+    interp_pin(interp, lit[0]);
+    {
+        List d20 = VECTOR_INIT();
+        Exp e21;
+        e21 = sym[0];
+        list_add(interp, &d20, e21);
+        Exp e22;
+        {
+            List d23 = VECTOR_INIT();
+            Exp e24;
+            {
+                List d25 = VECTOR_INIT();
+                Exp e26;
+                e26 = sym[5];
+                list_add(interp, &d25, e26);
+                Exp e27;
+                {
+                    List d28 = VECTOR_INIT();
+                    Exp e29;
+                    e29 = sym[6];
+                    list_add(interp, &d28, e29);
+                    Exp e30;
+                    e30 = mknum(2.0);
+                    list_add(interp, &d28, e30);
+                    e27 = mklist(interp, d28);
+                }
+                list_add(interp, &d25, e27);
+                e24 = mklist(interp, d25);
+            }
+            list_add(interp, &d23, e24);
+            e22 = mklist(interp, d23);
+        }
+        list_add(interp, &d20, e22);
+        Exp e31;
+        {
+            List d32 = VECTOR_INIT();
+            Exp e33;
+            e33 = sym[0];
+            list_add(interp, &d32, e33);
+            Exp e34;
+            {
+                List d35 = VECTOR_INIT();
+                Exp e36;
+                {
+                    List d37 = VECTOR_INIT();
+                    Exp e38;
+                    e38 = sym[7];
+                    list_add(interp, &d37, e38);
+                    Exp e39;
+                    {
+                        List d40 = VECTOR_INIT();
+                        Exp e41;
+                        e41 = sym[2];
+                        list_add(interp, &d40, e41);
+                        Exp e42;
+                        {
+                            List d43 = VECTOR_INIT();
+                            Exp e44;
+                            e44 = sym[3];
+                            list_add(interp, &d43, e44);
+                            Exp e45;
+                            {
+                                List d46 = VECTOR_INIT();
+                                e45 = mklist(interp, d46);
+                            }
+                            list_add(interp, &d43, e45);
+                            Exp e47;
+                            {
+                                List d48 = VECTOR_INIT();
+                                Exp e49;
+                                e49 = sym[0];
+                                list_add(interp, &d48, e49);
+                                Exp e50;
+                                e50 = sym[8];
+                                list_add(interp, &d48, e50);
+                                Exp e51;
+                                {
+                                    List d52 = VECTOR_INIT();
+                                    Exp e53;
+                                    {
+                                        List d54 = VECTOR_INIT();
+                                        Exp e55;
+                                        e55 = sym[9];
+                                        list_add(interp, &d54, e55);
+                                        Exp e56;
+                                        e56 = mknum(0.0);
+                                        list_add(interp, &d54, e56);
+                                        e53 = mklist(interp, d54);
+                                    }
+                                    list_add(interp, &d52, e53);
+                                    e51 = mklist(interp, d52);
+                                }
+                                list_add(interp, &d48, e51);
+                                Exp e57;
+                                {
+                                    List d58 = VECTOR_INIT();
+                                    Exp e59;
+                                    e59 = sym[10];
+                                    list_add(interp, &d58, e59);
+                                    Exp e60;
+                                    {
+                                        List d61 = VECTOR_INIT();
+                                        Exp e62;
+                                        e62 = sym[11];
+                                        list_add(interp, &d61, e62);
+                                        Exp e63;
+                                        e63 = sym[9];
+                                        list_add(interp, &d61, e63);
+                                        Exp e64;
+                                        e64 = mknum(5.0);
+                                        list_add(interp, &d61, e64);
+                                        e60 = mklist(interp, d61);
+                                    }
+                                    list_add(interp, &d58, e60);
+                                    Exp e65;
+                                    {
+                                        List d66 = VECTOR_INIT();
+                                        Exp e67;
+                                        e67 = sym[12];
+                                        list_add(interp, &d66, e67);
+                                        Exp e68;
+                                        {
+                                            List d69 = VECTOR_INIT();
+                                            Exp e70;
+                                            e70 = sym[13];
+                                            list_add(interp, &d69, e70);
+                                            Exp e71;
+                                            e71 = sym[5];
+                                            list_add(interp, &d69, e71);
+                                            Exp e72;
+                                            e72 = sym[9];
+                                            list_add(interp, &d69, e72);
+                                            e68 = mklist(interp, d69);
+                                        }
+                                        list_add(interp, &d66, e68);
+                                        Exp e73;
+                                        {
+                                            List d74 = VECTOR_INIT();
+                                            Exp e75;
+                                            e75 = sym[8];
+                                            list_add(interp, &d74, e75);
+                                            Exp e76;
+                                            {
+                                                List d77 = VECTOR_INIT();
+                                                Exp e78;
+                                                e78 = sym[14];
+                                                list_add(interp, &d77, e78);
+                                                Exp e79;
+                                                e79 = sym[9];
+                                                list_add(interp, &d77, e79);
+                                                Exp e80;
+                                                e80 = mknum(1.0);
+                                                list_add(interp, &d77, e80);
+                                                e76 = mklist(interp, d77);
+                                            }
+                                            list_add(interp, &d74, e76);
+                                            e73 = mklist(interp, d74);
+                                        }
+                                        list_add(interp, &d66, e73);
+                                        e65 = mklist(interp, d66);
+                                    }
+                                    list_add(interp, &d58, e65);
+                                    Exp e81;
+                                    {
+                                        List d82 = VECTOR_INIT();
+                                        Exp e83;
+                                        e83 = sym[15];
+                                        list_add(interp, &d82, e83);
+                                        Exp e84;
+                                        e84 = sym[16];
+                                        list_add(interp, &d82, e84);
+                                        e81 = mklist(interp, d82);
+                                    }
+                                    list_add(interp, &d58, e81);
+                                    e57 = mklist(interp, d58);
+                                }
+                                list_add(interp, &d48, e57);
+                                e47 = mklist(interp, d48);
+                            }
+                            list_add(interp, &d43, e47);
+                            e42 = mklist(interp, d43);
+                        }
+                        list_add(interp, &d40, e42);
+                        e39 = mklist(interp, d40);
+                    }
+                    list_add(interp, &d37, e39);
+                    e36 = mklist(interp, d37);
+                }
+                list_add(interp, &d35, e36);
+                e34 = mklist(interp, d35);
+            }
+            list_add(interp, &d32, e34);
+            Exp e85;
+            {
+                List d86 = VECTOR_INIT();
+                Exp e87;
+                e87 = sym[0];
+                list_add(interp, &d86, e87);
+                Exp e88;
+                e88 = sym[8];
+                list_add(interp, &d86, e88);
+                Exp e89;
+                {
+                    List d90 = VECTOR_INIT();
+                    Exp e91;
+                    {
+                        List d92 = VECTOR_INIT();
+                        Exp e93;
+                        e93 = sym[9];
+                        list_add(interp, &d92, e93);
+                        Exp e94;
+                        e94 = mknum(0.0);
+                        list_add(interp, &d92, e94);
+                        e91 = mklist(interp, d92);
+                    }
+                    list_add(interp, &d90, e91);
+                    Exp e95;
+                    {
+                        List d96 = VECTOR_INIT();
+                        Exp e97;
+                        e97 = sym[17];
+                        list_add(interp, &d96, e97);
+                        Exp e98;
+                        {
+                            List d99 = VECTOR_INIT();
+                            Exp e100;
+                            e100 = sym[18];
+                            list_add(interp, &d99, e100);
+                            e98 = mklist(interp, d99);
+                        }
+                        list_add(interp, &d96, e98);
+                        e95 = mklist(interp, d96);
+                    }
+                    list_add(interp, &d90, e95);
+                    e89 = mklist(interp, d90);
+                }
+                list_add(interp, &d86, e89);
+                Exp e101;
+                {
+                    List d102 = VECTOR_INIT();
+                    Exp e103;
+                    e103 = sym[10];
+                    list_add(interp, &d102, e103);
+                    Exp e104;
+                    {
+                        List d105 = VECTOR_INIT();
+                        Exp e106;
+                        e106 = sym[11];
+                        list_add(interp, &d105, e106);
+                        Exp e107;
+                        e107 = sym[9];
+                        list_add(interp, &d105, e107);
+                        Exp e108;
+                        e108 = mknum(5.0);
+                        list_add(interp, &d105, e108);
+                        e104 = mklist(interp, d105);
+                    }
+                    list_add(interp, &d102, e104);
+                    Exp e109;
+                    {
+                        List d110 = VECTOR_INIT();
+                        Exp e111;
+                        e111 = sym[8];
+                        list_add(interp, &d110, e111);
+                        Exp e112;
+                        {
+                            List d113 = VECTOR_INIT();
+                            Exp e114;
+                            e114 = sym[14];
+                            list_add(interp, &d113, e114);
+                            Exp e115;
+                            e115 = sym[9];
+                            list_add(interp, &d113, e115);
+                            Exp e116;
+                            e116 = mknum(1.0);
+                            list_add(interp, &d113, e116);
+                            e112 = mklist(interp, d113);
+                        }
+                        list_add(interp, &d110, e112);
+                        Exp e117;
+                        {
+                            List d118 = VECTOR_INIT();
+                            Exp e119;
+                            e119 = sym[19];
+                            list_add(interp, &d118, e119);
+                            Exp e120;
+                            {
+                                List d121 = VECTOR_INIT();
+                                Exp e122;
+                                e122 = sym[20];
+                                list_add(interp, &d121, e122);
+                                Exp e123;
+                                e123 = sym[5];
+                                list_add(interp, &d121, e123);
+                                e120 = mklist(interp, d121);
+                            }
+                            list_add(interp, &d118, e120);
+                            Exp e124;
+                            e124 = sym[17];
+                            list_add(interp, &d118, e124);
+                            e117 = mklist(interp, d118);
+                        }
+                        list_add(interp, &d110, e117);
+                        e109 = mklist(interp, d110);
+                    }
+                    list_add(interp, &d102, e109);
+                    Exp e125;
+                    {
+                        List d126 = VECTOR_INIT();
+                        Exp e127;
+                        e127 = sym[18];
+                        list_add(interp, &d126, e127);
+                        Exp e128;
+                        {
+                            List d129 = VECTOR_INIT();
+                            Exp e130;
+                            e130 = sym[4];
+                            list_add(interp, &d129, e130);
+                            Exp e131;
+                            e131 = sym[7];
+                            list_add(interp, &d129, e131);
+                            e128 = mklist(interp, d129);
+                        }
+                        list_add(interp, &d126, e128);
+                        Exp e132;
+                        e132 = sym[17];
+                        list_add(interp, &d126, e132);
+                        e125 = mklist(interp, d126);
+                    }
+                    list_add(interp, &d102, e125);
+                    e101 = mklist(interp, d102);
+                }
+                list_add(interp, &d86, e101);
+                e85 = mklist(interp, d86);
+            }
+            list_add(interp, &d32, e85);
+            e31 = mklist(interp, d32);
+        }
+        list_add(interp, &d20, e31);
+        lit[1] = mklist(interp, d20);
+    }
+    interp_pin(interp, lit[1]);
+    {
+        List d133 = VECTOR_INIT();
+        Exp e134;
+        e134 = sym[21];
+        list_add(interp, &d133, e134);
+        Exp e135;
+        {
+            List d136 = VECTOR_INIT();
+            Exp e137;
+            e137 = sym[22];
+            list_add(interp, &d136, e137);
+            Exp e138;
+            e138 = mknum(42.0);
+            list_add(interp, &d136, e138);
+            e135 = mklist(interp, d136);
+        }
+        list_add(interp, &d133, e135);
+        lit[2] = mklist(interp, d133);
+    }
+    interp_pin(interp, lit[2]);
+    {
+        List d139 = VECTOR_INIT();
+        Exp e140;
+        e140 = sym[23];
+        list_add(interp, &d139, e140);
+        Exp e141;
+        {
+            List d142 = VECTOR_INIT();
+            Exp e143;
+            e143 = sym[3];
+            list_add(interp, &d142, e143);
+            Exp e144;
+            {
+                List d145 = VECTOR_INIT();
+                Exp e146;
+                e146 = sym[24];
+                list_add(interp, &d145, e146);
+                e144 = mklist(interp, d145);
+            }
+            list_add(interp, &d142, e144);
+            Exp e147;
+            {
+                List d148 = VECTOR_INIT();
+                Exp e149;
+                e149 = sym[25];
+                list_add(interp, &d148, e149);
+                Exp e150;
+                e150 = sym[24];
+                list_add(interp, &d148, e150);
+                Exp e151;
+                e151 = sym[24];
+                list_add(interp, &d148, e151);
+                e147 = mklist(interp, d148);
+            }
+            list_add(interp, &d142, e147);
+            e141 = mklist(interp, d142);
+        }
+        list_add(interp, &d139, e141);
+        Exp e152;
+        {
+            List d153 = VECTOR_INIT();
+            Exp e154;
+            e154 = sym[26];
+            list_add(interp, &d153, e154);
+            Exp e155;
+            e155 = mknum(10.0);
+            list_add(interp, &d153, e155);
+            e152 = mklist(interp, d153);
+        }
+        list_add(interp, &d139, e152);
+        lit[3] = mklist(interp, d139);
+    }
+    interp_pin(interp, lit[3]);
+    prim[0] = global_ref(interp, sym[2]).cproc;
+    prim[1] = global_ref(interp, sym[6]).cproc;
+    prim[2] = global_ref(interp, sym[21]).cproc;
+    prim[3] = global_ref(interp, sym[23]).cproc;
+}
+
+static void run(Interp *interp)
+{
+    stack_enter(interp);
+    // (let ((t (spawn (lambda () 5)))) (join t))
+    eval_form(interp, lit[0]);
+    // (let ((ch (make-channel 2))) (let ((producer (spawn (lambda () (let loop ...
+    eval_form(interp, lit[1]);
+    // (touch (future 42))
+    eval_form(interp, lit[2]);
+    // (parallel-map (lambda (x) (* x x)) (iota 10))
+    eval_form(interp, lit[3]);
+}
+
+int main(void)
+{
+    Interp *interp = interp_new();
+    // forms left to the interpreter were optimized when compiled
+    interp->optimize = false;
+    init(interp);
+    run(interp);
+    interp_free(interp);
+    return 0;
+}
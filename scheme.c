@@ -1,31 +1,251 @@
 #include <stdarg.h>
+#include <unistd.h>
 #include "memory.h"
 #include "scheme.h"
 #include "ht.h"
 #include "gcobject.h"
+#include "profile.h"
+#include "jit.h"
+#include "parallel.h"
+#include "green.h"
+
+#define SCHEME_PI 3.14159265358979323846
 
 VECTOR_DEFINE_INIT(List, Exp, list)
-VECTOR_DEFINE_ADD(List, Exp, list)
-VECTOR_DEFINE_FREE(List, Exp, list)
 
-void save(Exp exp) { if (is_obj(exp)) { gc_save(exp.obj); } }
-void unsave(Exp exp) { if (is_obj(exp)) { gc_unsave(); } }
+// Elements stored in a list object itself (see mklist) are never
+// reallocated or freed: a list outgrowing them moves to an array of its own.
+static inline bool list_is_inline(List *arr)
+{
+    return arr->data == (Exp *) (arr + 1);
+}
+
+void list_add(Interp *interp, List *arr, Exp value)
+{
+    if (arr->cap < arr->size + 1) {
+        size_t old = arr->cap;
+        arr->cap = vector_grow_cap(old);
+        if (list_is_inline(arr)) {
+            Exp *data = ALLOCATE(interp, Exp, arr->cap);
+            memcpy(data, arr->data, sizeof(Exp) * arr->size);
+            arr->data = data;
+        } else {
+            arr->data = GROW_ARRAY(interp, Exp, arr->data, old, arr->cap);
+        }
+    }
+    arr->data[arr->size++] = value;
+}
+
+void list_free(Interp *interp, List *arr)
+{
+    if (!list_is_inline(arr)) {
+        FREE_ARRAY(interp, Exp, arr->data, arr->cap);
+    }
+    list_init(arr);
+}
+
+Exp mklist(Interp *interp, List l)
+{
+    size_t room = l.size > 0 ? l.size : l.cap > 0 ? l.cap : LIST_INLINE_EMPTY;
+    if (room > LIST_INLINE_MAX) {
+        GCObject *obj = alloc_obj(interp, GC_LIST, GC_OBJ_SIZE(list));
+        obj->list = l;
+        return (Exp) { .type = EXP_LIST, .obj = obj };
+    }
+    GCObject *obj = alloc_obj(interp, GC_LIST, GC_OBJ_SIZE(list) + sizeof(Exp) * room);
+    obj->inline_cap = room;
+    obj->list = (List) { .size = l.size, .cap = room, .data = (Exp *) (&obj->list + 1) };
+    if (l.data) {
+        memcpy(obj->list.data, l.data, sizeof(Exp) * l.size);
+        FREE_ARRAY(interp, Exp, l.data, l.cap);
+    }
+    return (Exp) { .type = EXP_LIST, .obj = obj };
+}
+
+void save(Interp *interp, Exp exp) { if (is_obj(exp)) { gc_save(interp, exp.obj); } }
+void unsave(Interp *interp, Exp exp) { if (is_obj(exp)) { gc_unsave(interp); } }
+
+static inline Exp mkcsym(Interp *interp, const char *s)
+{
+    return mksym(interp, s, strlen(s));
+}
+
+static bool is_form(Exp op, const char *name)
+{
+    return is_symbol(op) && strcmp(AS_SYM(op), name) == 0;
+}
+
+// Whether (op ...) makes something that may keep the environment it's
+// evaluated in: a closure or a promise.
+static bool keeps_env(Exp op)
+{
+    return is_form(op, "lambda") || is_form(op, "delay") || is_form(op, "delay-force")
+        || is_form(op, "cons-stream");
+}
+
+// Error handling.
+// A raise first goes to the innermost handler installed by
+// with-exception-handler, if there's one more recent than the innermost
+// interp_try. Otherwise it unwinds to that interp_try (a guard or the host),
+// which restores the GC stacks, or exits if there is no interp_try at all.
+
+static bool has_handler_proc(Interp *interp)
+{
+    size_t base = interp->handler ? interp->handler->handlers_size : 0;
+    return interp->handlers.size > base;
+}
+
+static noreturn void unwind(Interp *interp)
+{
+    if (interp->handler) {
+        longjmp(interp->handler->buf, 1);
+    }
+    writer_flush(interp->out);
+    fprintf(stderr, "%s\n", interp->error);
+    exit(1);
+}
 
-noreturn void die(const char *fmt, ...)
+// Call the innermost handler on obj. The handler runs with the outer
+// handlers installed, so raising from it goes further out. If reinstall
+// is set, it's installed again once it returns.
+static Exp call_handler(Interp *interp, Exp obj, bool reinstall)
+{
+    Exp handler = interp->handlers.data[--interp->handlers.size];
+    save(interp, handler);
+    save(interp, obj);
+    List args = { .data = &obj, .size = 1, .cap = 1 };
+    Exp res = handler.type == EXP_C_PROC ? handler.cproc(interp, args)
+                                         : proc_call(interp, &AS_PROC(handler), args);
+    unsave(interp, obj);
+    unsave(interp, handler);
+    if (reinstall) {
+        list_add(interp, &interp->handlers, handler);
+    }
+    return res;
+}
+
+static void print_condition(Writer *w, Condition *c)
+{
+    print_to(w, c->message);
+    List irritants = AS_LIST(c->irritants);
+    for (size_t i = 0; i < irritants.size; i++) {
+        writer_putc(w, ' ');
+        print_to(w, irritants.data[i]);
+    }
+}
+
+// Describe obj in interp->error, for hosts catching it with interp_try.
+static void describe_raised(Interp *interp, Exp obj)
+{
+    Writer w;
+    writer_init(&w, -1, sizeof(interp->error));
+    if (obj.type == EXP_CONDITION) {
+        print_condition(&w, &AS_CONDITION(obj));
+    } else {
+        writer_puts(&w, "uncaught exception: ");
+        print_to(&w, obj);
+    }
+    size_t len = w.len < sizeof(interp->error) ? w.len : sizeof(interp->error) - 1;
+    memcpy(interp->error, w.buf, len);
+    interp->error[len] = '\0';
+    writer_free(&w);
+}
+
+static Exp mkerror(Interp *interp, const char *message)
+{
+    Exp msg = mkcsym(interp, message);
+    save(interp, msg);
+    Exp irritants = mklist(interp, (List) VECTOR_INIT());
+    unsave(interp, msg);
+    return mkcondition(interp, msg, irritants);
+}
+
+noreturn void raise_exp(Interp *interp, Exp obj)
+{
+    if (has_handler_proc(interp)) {
+        call_handler(interp, obj, false);
+        // the handler is still uninstalled, so this goes to the outer ones
+        die(interp, "raise: exception handler returned\n");
+    }
+    interp->raised = obj;
+    describe_raised(interp, obj);
+    unwind(interp);
+}
+
+Exp raise_continuable(Interp *interp, Exp obj)
+{
+    if (!has_handler_proc(interp)) {
+        raise_exp(interp, obj);
+    }
+    return call_handler(interp, obj, true);
+}
+
+noreturn void die(Interp *interp, const char *fmt, ...)
 {
     va_list args;
     va_start(args, fmt);
-    vfprintf(stderr, fmt, args);
+    vsnprintf(interp->error, sizeof(interp->error), fmt, args);
     va_end(args);
-    exit(1);
+    size_t len = strlen(interp->error);
+    if (len > 0 && interp->error[len-1] == '\n') {
+        interp->error[len-1] = '\0';
+    }
+    if (has_handler_proc(interp)) {
+        raise_exp(interp, mkerror(interp, interp->error));
+    }
+    interp->raised = (Exp) { .type = EXP_EMPTY };
+    unwind(interp);
+}
+
+noreturn void stack_overflow(Interp *interp)
+{
+    interp->handlers.size = interp->handler ? interp->handler->handlers_size : 0;
+    die(interp, "stack overflow: recursion too deep\n");
 }
 
-char *string_dup(const char *s, size_t size)
+// How much of the C stack evaluation may use below where it starts: calls
+// deeper than that raise an error instead of overflowing the stack. That's
+// the usual 8MB stack (and a green thread's), less room for the frames
+// between the last check and the deepest one.
+#define EVAL_STACK_SIZE (8 * 1024 * 1024 - 256 * 1024)
+
+uintptr_t stack_enter(Interp *interp)
 {
-    char *dup = ALLOCATE(char, size+1);
-    memcpy(dup, s, size);
-    dup[size] = '\0';
-    return dup;
+    uintptr_t old = interp->stack_limit;
+    if (!old) {
+        interp->stack_base = (uintptr_t) __builtin_frame_address(0);
+        interp->stack_limit = interp->stack_base - EVAL_STACK_SIZE;
+    }
+    return old;
+}
+
+bool interp_try(Interp *interp, void (*fn)(Interp *interp, void *data), void *data)
+{
+    ErrorHandler handler = {
+        .sp = interp->gc.sp, .env_sp = interp->gc.env_sp, .frames_sp = interp->gc.frames_sp,
+        .handlers_size = interp->handlers.size, .stack_limit = stack_enter(interp),
+        .prev = interp->handler,
+    };
+#ifdef HEAP_PROFILE
+    int site = heapprof_current(interp);
+#endif
+    interp->handler = &handler;
+    if (setjmp(handler.buf) != 0) {
+        interp->handler = handler.prev;
+        interp->gc.sp = handler.sp;
+        interp->gc.env_sp = handler.env_sp;
+        interp->gc.frames_sp = handler.frames_sp;
+        interp->handlers.size = handler.handlers_size;
+        interp->stack_limit = handler.stack_limit;
+#ifdef HEAP_PROFILE
+        heapprof_set(interp, site);
+#endif
+        return false;
+    }
+    fn(interp, data);
+    interp->handler = handler.prev;
+    interp->stack_limit = handler.stack_limit;
+    return true;
 }
 
 typedef struct Token {
@@ -66,103 +286,179 @@ static Token next_token(Tokenizer *t)
 }
 
 // Numbers become numbers; every other token is a symbol.
-static Exp atom(Token token)
+static Exp atom(Interp *interp, Token token)
 {
     char *endptr;
     long num = strtol(token.s + token.start, &endptr, 0);
-    return endptr == token.s + token.start
-        ? mksym(string_dup(token.s + token.start, token.end - token.start))
-        : mknum(num);
+    if (endptr == token.s + token.start) {
+        return mksym(interp, token.s + token.start, token.end - token.start);
+    }
+    if (*endptr == '.' || *endptr == 'e' || *endptr == 'E') {
+        // a decimal with a fraction or an exponent, as format_number writes
+        return mknum(strtod(token.s + token.start, &endptr));
+    }
+    return mknum(num);
 }
 
 // Read an expression from a sequence of tokens.
-static Exp read_from_tokens(Tokenizer *t)
+static Exp read_from_tokens(Interp *interp, Tokenizer *t)
 {
     Token token = next_token(t);
     if (token.s == NULL) {
         return (Exp) { .type = EXP_EOF };
     } else if (token.s[token.start] == '(') {
-        Exp list_exp = mklist((List) VECTOR_INIT());
+        Exp list_exp = mklist(interp, (List) VECTOR_INIT());
         List *list = &list_exp.obj->list;
-        save(list_exp);
+        save(interp, list_exp);
         while (t->cur.s != NULL && t->cur.s[0] != ')') {
-            Exp exp = read_from_tokens(t);
-            save(exp);
-            list_add(list, exp);
-            unsave(exp);
+            Exp exp = read_from_tokens(interp, t);
+            save(interp, exp);
+            list_add(interp, list, exp);
+            unsave(interp, exp);
         }
         if (t->cur.s == NULL) {
-            die("error: unexpected EOF\n");
+            die(interp, "error: unexpected EOF\n");
         }
         next_token(t); // pop off ')'
-        unsave(list_exp);
+        unsave(interp, list_exp);
         return list_exp;
     } else if (token.s[token.start] == ')') {
-        die("unexpected ')'\n");
+        die(interp, "unexpected ')'\n");
     } else {
-        return atom(token);
+        return atom(interp, token);
     }
 }
 
 // Read a scheme expression from a string.
-static Exp parse(const char *s)
+static Exp parse(Interp *interp, const char *s)
 {
     Tokenizer t = { .i = 0, .s = s, .len = strlen(s) };
     next_token(&t);
-    return read_from_tokens(&t);
+    return read_from_tokens(interp, &t);
 }
 
-static void add_env(Env *env, Exp symbol, Exp exp)
+static void add_env(Interp *interp, Env *env, Exp symbol, Exp exp)
 {
-    save(symbol);
-    save(exp);
-    ht_install(&env->obj->ht, symbol, exp);
-    unsave(exp);
-    unsave(symbol);
+    if (env == interp->global) {
+        interp->global_version++;
+    }
+    save(interp, symbol);
+    save(interp, exp);
+    ht_install(&ENV_HT(env), symbol, exp);
+    unsave(interp, exp);
+    unsave(interp, symbol);
 }
 
 #include "cprocs.c"
-
-static inline Exp mkcsym(const char *s)
-{
-    return mksym(string_dup(s, strlen(s)));
-}
+#include "expand.c"
+#include "optimize.c"
+#include "closure.c"
 
 // An environment with some scheme standard procedures.
-static Env standard_env()
-{
-    Env env = new_env(NULL);
-    gc_push_env(&env);
-    add_env(&env, mkcsym("+"),          mkcproc(scheme_sum));
-    add_env(&env, mkcsym("-"),          mkcproc(scheme_sub));
-    add_env(&env, mkcsym("*"),          mkcproc(scheme_mul));
-    add_env(&env, mkcsym(">"),          mkcproc(scheme_gt));
-    add_env(&env, mkcsym("<"),          mkcproc(scheme_lt));
-    add_env(&env, mkcsym(">="),         mkcproc(scheme_ge));
-    add_env(&env, mkcsym("<="),         mkcproc(scheme_le));
-    add_env(&env, mkcsym("="),          mkcproc(scheme_eq));
-    add_env(&env, mkcsym("begin"),      mkcproc(scheme_begin));
-    add_env(&env, mkcsym("list"),       mkcproc(scheme_list));
-    add_env(&env, mkcsym("pi"),         mknum(3.14159265358979323846));
-    add_env(&env, mkcsym("cons"),       mkcproc(scheme_cons));
-    add_env(&env, mkcsym("car"),        mkcproc(scheme_car));
-    add_env(&env, mkcsym("cdr"),        mkcproc(scheme_cdr));
-    add_env(&env, mkcsym("length"),     mkcproc(scheme_length));
-    add_env(&env, mkcsym("null?"),      mkcproc(scheme_is_null));
-    add_env(&env, mkcsym("eq?"),        mkcproc(scheme_is_eq));
-    add_env(&env, mkcsym("equal?"),     mkcproc(scheme_equal));
-    add_env(&env, mkcsym("not"),        mkcproc(scheme_not));
-    add_env(&env, mkcsym("and"),        mkcproc(scheme_and));
-    add_env(&env, mkcsym("or"),         mkcproc(scheme_or));
-    add_env(&env, mkcsym("append"),     mkcproc(scheme_append));
-    add_env(&env, mkcsym("apply"),      mkcproc(scheme_apply));
-    add_env(&env, mkcsym("list?"),      mkcproc(scheme_is_list));
-    add_env(&env, mkcsym("number?"),    mkcproc(scheme_is_number));
-    add_env(&env, mkcsym("procedure?"), mkcproc(scheme_is_proc));
-    add_env(&env, mkcsym("symbol?"),    mkcproc(scheme_is_symbol));
-    add_env(&env, mkcsym("display"),    mkcproc(scheme_display));
-    add_env(&env, mkcsym("newline"),    mkcproc(scheme_newline));
-    gc_pop_env();
+static Env *standard_env(Interp *interp)
+{
+    Env *env = new_env(interp, NULL);
+    gc_push_env(interp, env);
+    add_env(interp, env, mkcsym(interp, "+"),          mkcproc(scheme_sum));
+    add_env(interp, env, mkcsym(interp, "-"),          mkcproc(scheme_sub));
+    add_env(interp, env, mkcsym(interp, "*"),          mkcproc(scheme_mul));
+    add_env(interp, env, mkcsym(interp, ">"),          mkcproc(scheme_gt));
+    add_env(interp, env, mkcsym(interp, "<"),          mkcproc(scheme_lt));
+    add_env(interp, env, mkcsym(interp, ">="),         mkcproc(scheme_ge));
+    add_env(interp, env, mkcsym(interp, "<="),         mkcproc(scheme_le));
+    add_env(interp, env, mkcsym(interp, "="),          mkcproc(scheme_eq));
+    add_env(interp, env, mkcsym(interp, "begin"),      mkcproc(scheme_begin));
+    add_env(interp, env, mkcsym(interp, "list"),       mkcproc(scheme_list));
+    add_env(interp, env, mkcsym(interp, "pi"),         mknum(SCHEME_PI));
+    add_env(interp, env, mkcsym(interp, "cons"),       mkcproc(scheme_cons));
+    add_env(interp, env, mkcsym(interp, "car"),        mkcproc(scheme_car));
+    add_env(interp, env, mkcsym(interp, "cdr"),        mkcproc(scheme_cdr));
+    add_env(interp, env, mkcsym(interp, "length"),     mkcproc(scheme_length));
+    add_env(interp, env, mkcsym(interp, "null?"),      mkcproc(scheme_is_null));
+    add_env(interp, env, mkcsym(interp, "eq?"),        mkcproc(scheme_is_eq));
+    add_env(interp, env, mkcsym(interp, "equal?"),     mkcproc(scheme_equal));
+    add_env(interp, env, mkcsym(interp, "not"),        mkcproc(scheme_not));
+    add_env(interp, env, mkcsym(interp, "append"),     mkcproc(scheme_append));
+    add_env(interp, env, mkcsym(interp, "apply"),      mkcproc(scheme_apply));
+    add_env(interp, env, mkcsym(interp, "map"),        mkcproc(scheme_map));
+    add_env(interp, env, mkcsym(interp, "for-each"),   mkcproc(scheme_for_each));
+    add_env(interp, env, mkcsym(interp, "filter"),     mkcproc(scheme_filter));
+    add_env(interp, env, mkcsym(interp, "fold-left"),  mkcproc(scheme_fold_left));
+    add_env(interp, env, mkcsym(interp, "fold-right"), mkcproc(scheme_fold_right));
+    add_env(interp, env, mkcsym(interp, "reduce"),     mkcproc(scheme_reduce));
+    add_env(interp, env, mkcsym(interp, "list-ref"),   mkcproc(scheme_list_ref));
+    add_env(interp, env, mkcsym(interp, "list-tail"),  mkcproc(scheme_list_tail));
+    add_env(interp, env, mkcsym(interp, "reverse"),    mkcproc(scheme_reverse));
+    add_env(interp, env, mkcsym(interp, "assoc"),      mkcproc(scheme_assoc));
+    add_env(interp, env, mkcsym(interp, "assq"),       mkcproc(scheme_assq));
+    add_env(interp, env, mkcsym(interp, "member"),     mkcproc(scheme_member));
+    add_env(interp, env, mkcsym(interp, "memq"),       mkcproc(scheme_memq));
+    add_env(interp, env, mkcsym(interp, "iota"),       mkcproc(scheme_iota));
+    add_env(interp, env, mkcsym(interp, "sort"),       mkcproc(scheme_sort));
+    add_env(interp, env, mkcsym(interp, "sort!"),      mkcproc(scheme_sort_in_place));
+    add_env(interp, env, mkcsym(interp, "vector?"),       mkcproc(scheme_is_vector));
+    add_env(interp, env, mkcsym(interp, "make-vector"),   mkcproc(scheme_make_vector));
+    add_env(interp, env, mkcsym(interp, "vector"),        mkcproc(scheme_vector));
+    add_env(interp, env, mkcsym(interp, "vector-length"), mkcproc(scheme_vector_length));
+    add_env(interp, env, mkcsym(interp, "vector-ref"),    mkcproc(scheme_vector_ref));
+    add_env(interp, env, mkcsym(interp, "vector-set!"),   mkcproc(scheme_vector_set));
+    add_env(interp, env, mkcsym(interp, "vector-fill!"),  mkcproc(scheme_vector_fill));
+    add_env(interp, env, mkcsym(interp, "vector-grow"),   mkcproc(scheme_vector_grow));
+    add_env(interp, env, mkcsym(interp, "vector->list"),  mkcproc(scheme_vector_to_list));
+    add_env(interp, env, mkcsym(interp, "list->vector"),  mkcproc(scheme_list_to_vector));
+    add_env(interp, env, mkcsym(interp, "make-hash-table"),       mkcproc(scheme_make_hash_table));
+    add_env(interp, env, mkcsym(interp, "make-eq-hash-table"),    mkcproc(scheme_make_eq_hash_table));
+    add_env(interp, env, mkcsym(interp, "hash-table?"),           mkcproc(scheme_is_hash_table));
+    add_env(interp, env, mkcsym(interp, "hash-table-ref"),        mkcproc(scheme_hash_table_ref));
+    add_env(interp, env, mkcsym(interp, "hash-table-ref/default"), mkcproc(scheme_hash_table_ref_default));
+    add_env(interp, env, mkcsym(interp, "hash-table-set!"),       mkcproc(scheme_hash_table_set));
+    add_env(interp, env, mkcsym(interp, "hash-table-delete!"),    mkcproc(scheme_hash_table_delete));
+    add_env(interp, env, mkcsym(interp, "hash-table-contains?"),  mkcproc(scheme_hash_table_contains));
+    add_env(interp, env, mkcsym(interp, "hash-table-update!"),    mkcproc(scheme_hash_table_update));
+    add_env(interp, env, mkcsym(interp, "hash-table-update!/default"), mkcproc(scheme_hash_table_update_default));
+    add_env(interp, env, mkcsym(interp, "hash-table-count"),      mkcproc(scheme_hash_table_count));
+    add_env(interp, env, mkcsym(interp, "hash-table-keys"),       mkcproc(scheme_hash_table_keys));
+    add_env(interp, env, mkcsym(interp, "hash-table-values"),     mkcproc(scheme_hash_table_values));
+    add_env(interp, env, mkcsym(interp, "hash-table->alist"),     mkcproc(scheme_hash_table_to_alist));
+    add_env(interp, env, mkcsym(interp, "hash-table-walk"),       mkcproc(scheme_hash_table_walk));
+    add_env(interp, env, mkcsym(interp, "list?"),      mkcproc(scheme_is_list));
+    add_env(interp, env, mkcsym(interp, "number?"),    mkcproc(scheme_is_number));
+    add_env(interp, env, mkcsym(interp, "procedure?"), mkcproc(scheme_is_proc));
+    add_env(interp, env, mkcsym(interp, "symbol?"),    mkcproc(scheme_is_symbol));
+    add_env(interp, env, mkcsym(interp, "display"),    mkcproc(scheme_display));
+    add_env(interp, env, mkcsym(interp, "newline"),    mkcproc(scheme_newline));
+    add_env(interp, env, mkcsym(interp, "error"),      mkcproc(scheme_error));
+    add_env(interp, env, mkcsym(interp, "raise"),      mkcproc(scheme_raise));
+    add_env(interp, env, mkcsym(interp, "raise-continuable"),      mkcproc(scheme_raise_continuable));
+    add_env(interp, env, mkcsym(interp, "with-exception-handler"), mkcproc(scheme_with_exception_handler));
+    add_env(interp, env, mkcsym(interp, "error-object?"),          mkcproc(scheme_is_error_object));
+    add_env(interp, env, mkcsym(interp, "error-object-message"),   mkcproc(scheme_error_object_message));
+    add_env(interp, env, mkcsym(interp, "error-object-irritants"), mkcproc(scheme_error_object_irritants));
+    add_env(interp, env, mkcsym(interp, "force"),        mkcproc(scheme_force));
+    add_env(interp, env, mkcsym(interp, "make-promise"), mkcproc(scheme_make_promise));
+    add_env(interp, env, mkcsym(interp, "promise?"),     mkcproc(scheme_is_promise));
+    add_env(interp, env, mkcsym(interp, "the-empty-stream"), mklist(interp, (List) VECTOR_INIT()));
+    add_env(interp, env, mkcsym(interp, "stream-car"),   mkcproc(scheme_stream_car));
+    add_env(interp, env, mkcsym(interp, "stream-cdr"),   mkcproc(scheme_stream_cdr));
+    add_env(interp, env, mkcsym(interp, "stream-pair?"), mkcproc(scheme_is_stream_pair));
+    add_env(interp, env, mkcsym(interp, "stream-null?"), mkcproc(scheme_is_stream_null));
+    add_env(interp, env, mkcsym(interp, "stream-map"),   mkcproc(scheme_stream_map));
+    add_env(interp, env, mkcsym(interp, "stream-filter"), mkcproc(scheme_stream_filter));
+    add_env(interp, env, mkcsym(interp, "stream-take"),  mkcproc(scheme_stream_take));
+    add_env(interp, env, mkcsym(interp, "stream->list"), mkcproc(scheme_stream_to_list));
+    add_env(interp, env, mkcsym(interp, "touch"),        mkcproc(scheme_touch));
+    add_env(interp, env, mkcsym(interp, "parallel-map"), mkcproc(scheme_parallel_map));
+    add_env(interp, env, mkcsym(interp, "parallel-for-each"), mkcproc(scheme_parallel_for_each));
+    add_env(interp, env, mkcsym(interp, "spawn"),        mkcproc(scheme_spawn));
+    add_env(interp, env, mkcsym(interp, "yield"),        mkcproc(scheme_yield));
+    add_env(interp, env, mkcsym(interp, "join"),         mkcproc(scheme_join));
+    add_env(interp, env, mkcsym(interp, "make-channel"), mkcproc(scheme_make_channel));
+    add_env(interp, env, mkcsym(interp, "channel-send"), mkcproc(scheme_channel_send));
+    add_env(interp, env, mkcsym(interp, "channel-receive"), mkcproc(scheme_channel_receive));
+#ifdef HEAP_PROFILE
+    add_env(interp, env, mkcsym(interp, "heap-profile"), mkcproc(scheme_heap_profile));
+#endif
+    gc_pop_env(interp);
     return env;
 }
 
@@ -171,26 +467,594 @@ static inline Env *env_find(Env *env, Exp var)
 {
     if (!env)
         return NULL;
-    if (ht_lookup(&env->obj->ht, var, NULL))
+    if (ht_lookup(&ENV_HT(env), var, NULL))
         return env;
     return env_find(env->outer, var);
 }
 
-Exp proc_call(Procedure *proc, List args)
+// Assign var where it's bound in env: through its box, if a closure
+// captured it.
+static void assign_env(Interp *interp, Env *env, Exp var, Exp exp)
+{
+    Exp old;
+    if (env != interp->global && ht_lookup(&ENV_HT(env), var, &old) && old.type == EXP_BOX) {
+        old.obj->box = exp;
+        return;
+    }
+    add_env(interp, env, var, exp);
+}
+
+// The environment of a closure made in env, given the variables its lambda
+// captures (see closure.c). Variables that are missing or global mean the
+// closure was made before an internal define: it keeps env, as before.
+static Env *closure_env(Interp *interp, List vars, Env *env)
+{
+    List captured = AS_LIST(vars.data[0]);
+    List boxed = AS_LIST(vars.data[1]);
+    if (captured.size == 0) {
+        return interp->global;
+    }
+    Env *frame = new_env(interp, interp->global);
+    gc_push_env(interp, frame);
+    for (size_t i = 0; i < captured.size; i++) {
+        Exp var = captured.data[i], value;
+        Env *e = env_find(env, var);
+        if (!e || e == interp->global) {
+            gc_pop_env(interp);
+            return env;
+        }
+        ht_lookup(&ENV_HT(e), var, &value);
+        if (value.type != EXP_BOX && in_list(boxed, var)) {
+            value = mkbox(interp, value);
+            ht_install(&ENV_HT(e), var, value);
+        }
+        ht_install(&ENV_HT(frame), var, value);
+    }
+    gc_pop_env(interp);
+    return frame;
+}
+
+Exp proc_call(Interp *interp, Procedure *proc, List args)
 {
-    Env env = new_env(&proc->env);
-    gc_push_env(&env);
+    if (--interp->fuel <= 0) {
+        green_preempt(interp);
+    }
+    if ((uintptr_t) __builtin_frame_address(0) < interp->stack_limit) {
+        stack_overflow(interp);
+    }
+    Exp res;
+    if (jit_enter(interp, proc, args, &res)) {
+        return res;
+    }
+    bool stack_frame = proc->stack_frame;
+    Env *env;
+    if (stack_frame) {
+        env = gc_push_frame(interp, proc->env);
+    } else {
+        env = new_env(interp, proc->env);
+        gc_push_env(interp, env);
+    }
     for (size_t i = 0; i < args.size; i++) {
-        add_env(&env, AS_LIST(proc->params).data[i], args.data[i]);
+        add_env(interp, env, AS_LIST(proc->params).data[i], args.data[i]);
+    }
+    Exp exp = eval(interp, proc->body, env);
+    if (stack_frame) {
+        gc_pop_frame(interp);
+    } else {
+        gc_pop_env(interp);
     }
-    Exp exp = eval(proc->body, &env);
-    gc_pop_env();
     return exp;
 }
 
+// Forms with big stack frames that are kept out of eval, as every level of
+// recursion through eval pays for its frame.
+#define NOINLINE __attribute__((noinline))
+
+// A loop run by a named let (see eval_named_let).
+typedef struct Loop {
+    Exp name;   // a call to name in tail position starts the next iteration
+    List vars;  // the loop variables, as (var init) bindings
+    Exp vals;   // their values for the next iteration, stored by that call
+    bool again; // set by that call
+} Loop;
+
+static Exp eval_loop_tail(Interp *interp, Exp x, Env *env, Loop *loop);
+
+// Evaluate x, which is in tail position of loop's body if there's a loop.
+static inline Exp eval_tail(Interp *interp, Exp x, Env *env, Loop *loop)
+{
+    return loop ? eval_loop_tail(interp, x, env, loop) : eval(interp, x, env);
+}
+
+// Evaluate l[from..] in order and return the last value.
+static Exp eval_body(Interp *interp, List l, size_t from, Env *env, Loop *loop)
+{
+    if (from >= l.size) {
+        return (Exp) { .type = EXP_VOID };
+    }
+    for (size_t i = from; i < l.size - 1; i++) {
+        eval(interp, l.data[i], env);
+    }
+    return eval_tail(interp, l.data[l.size-1], env, loop);
+}
+
+static Exp eval_if(Interp *interp, List l, Env *env, Loop *loop)
+{
+    Exp test        = l.data[1];
+    Exp conseq      = l.data[2];
+    Exp alt         = l.data[3];
+    Exp test_result = eval(interp, test, env);
+    Exp exp = is_true(test_result) ? conseq : alt;
+    return eval_tail(interp, exp, env, loop);
+}
+
+// (when test body...) and (unless test body...)
+static Exp eval_when(Interp *interp, List l, Env *env, Loop *loop, bool when)
+{
+    if (l.size < 2) {
+        die(interp, "%s: bad syntax\n", when ? "when" : "unless");
+    }
+    return is_true(eval(interp, l.data[1], env)) == when
+        ? eval_body(interp, l, 2, env, loop)
+        : (Exp) { .type = EXP_VOID };
+}
+
+// (and exp...) stops at the first false value, (or exp...) at the first true.
+static Exp eval_and_or(Interp *interp, List l, Env *env, Loop *loop, bool and)
+{
+    Exp res = and ? SCHEME_TRUE : SCHEME_FALSE;
+    for (size_t i = 1; i < l.size && is_true(res) == and; i++) {
+        res = i == l.size - 1 ? eval_tail(interp, l.data[i], env, loop)
+                              : eval(interp, l.data[i], env);
+    }
+    return res;
+}
+
+// Evaluate cond clauses l[from..]: (test expr...), (test => proc) or
+// (else expr...). Set *matched if a clause was chosen.
+static Exp eval_clauses(Interp *interp, List l, size_t from, Env *env, Loop *loop,
+                        const char *name, bool *matched)
+{
+    for (size_t i = from; i < l.size; i++) {
+        if (l.data[i].type != EXP_LIST || AS_LIST(l.data[i]).size == 0) {
+            die(interp, "%s: bad clause\n", name);
+        }
+        List clause = AS_LIST(l.data[i]);
+        Exp test = clause.data[0];
+        bool is_else = is_symbol(test) && strcmp(AS_SYM(test), "else") == 0;
+        Exp res = is_else ? SCHEME_TRUE : eval(interp, test, env);
+        if (!is_true(res)) {
+            continue;
+        }
+        *matched = true;
+        if (clause.size == 3 && is_symbol(clause.data[1])
+         && strcmp(AS_SYM(clause.data[1]), "=>") == 0) {
+            Exp proc = eval(interp, clause.data[2], env);
+            if (!is_proc(proc)) {
+                die(interp, "%s: => needs a procedure\n", name);
+            }
+            save(interp, res);
+            List args = { .data = &res, .size = 1, .cap = 1 };
+            Exp val = proc.type == EXP_C_PROC ? proc.cproc(interp, args)
+                                              : proc_call(interp, &AS_PROC(proc), args);
+            unsave(interp, res);
+            return val;
+        }
+        return clause.size == 1 ? res : eval_body(interp, clause, 1, env, loop);
+    }
+    *matched = false;
+    return (Exp) { .type = EXP_VOID };
+}
+
+typedef enum LetKind { LET, LET_STAR, LETREC } LetKind;
+
+// Check a list of (var init ...) bindings, each with between min and max
+// elements.
+static List check_bindings(Interp *interp, Exp bindings, size_t min, size_t max,
+                           const char *name)
+{
+    if (bindings.type != EXP_LIST) {
+        die(interp, "%s: bad syntax\n", name);
+    }
+    List l = AS_LIST(bindings);
+    for (size_t i = 0; i < l.size; i++) {
+        Exp b = l.data[i];
+        if (b.type != EXP_LIST || AS_LIST(b).size < min || AS_LIST(b).size > max
+         || !is_symbol(AS_LIST(b).data[0])) {
+            die(interp, "%s: bad binding\n", name);
+        }
+    }
+    return l;
+}
+
+// (let ((var init)...) body...) and friends.
+// Bindings go straight into one new frame: no procedure or argument list
+// is made. let evaluates inits outside the frame; let* and letrec inside,
+// letrec after binding every variable first.
+static Exp eval_let(Interp *interp, List l, Env *env, Loop *loop, LetKind kind,
+                    const char *name)
+{
+    if (l.size < 3) {
+        die(interp, "%s: bad syntax\n", name);
+    }
+    List bindings = check_bindings(interp, l.data[1], 2, 2, name);
+    Env *frame = new_env(interp, env);
+    gc_push_env(interp, frame);
+    if (kind == LETREC) {
+        for (size_t i = 0; i < bindings.size; i++) {
+            add_env(interp, frame, AS_LIST(bindings.data[i]).data[0], (Exp) { .type = EXP_VOID });
+        }
+    }
+    Env *init_env = kind == LET ? env : frame;
+    for (size_t i = 0; i < bindings.size; i++) {
+        List b = AS_LIST(bindings.data[i]);
+        assign_env(interp, frame, b.data[0], eval(interp, b.data[1], init_env));
+    }
+    Exp res = eval_body(interp, l, 2, frame, loop);
+    gc_pop_env(interp);
+    return res;
+}
+
+// Loops.
+// A named let whose name is only ever called in tail position, and whose
+// body makes no closures that could keep its frame, runs as a loop: each
+// call to the name stores the new values, unwinds to the loop and rebinds
+// the variables in the same frame. Any other named let becomes a procedure.
+// A call to begin counts as a sequence whose last element is in tail
+// position, as long as begin is the primitive: the loop may not rebind it,
+// and it's checked again each time the loop evaluates one.
+
+// Whether op is begin and still means the primitive in env.
+static bool is_begin(Exp op, Env *env)
+{
+    Exp value;
+    Env *e = is_form(op, "begin") ? env_find(env, op) : NULL;
+    if (!e || !ht_lookup(&ENV_HT(e), op, &value)) {
+        return false;
+    }
+    value = unbox(value);
+    return value.type == EXP_C_PROC && value.cproc == scheme_begin;
+}
+
+static bool loop_safe(Exp x, Exp name, bool tail);
+
+// Whether l[from..] is loop-safe, with the last element in tail position.
+static bool loop_safe_body(List l, size_t from, Exp name, bool tail)
+{
+    for (size_t i = from; i < l.size; i++) {
+        if (!loop_safe(l.data[i], name, tail && i == l.size - 1)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Check that name only appears in x as a call in tail position, that
+// nothing in x rebinds it and that x makes no closures.
+static bool loop_safe(Exp x, Exp name, bool tail)
+{
+    if (is_symbol(x)) {
+        return !exp_eq(x, name);
+    } else if (x.type != EXP_LIST || AS_LIST(x).size == 0) {
+        return true;
+    }
+    List l = AS_LIST(x);
+    Exp op = l.data[0];
+    if (exp_eq(op, name)) {
+        return tail && loop_safe_body(l, 1, name, false);
+    } else if (is_form(op, "quote")) {
+        return true;
+    } else if (keeps_env(op)) {
+        return false;
+    } else if ((is_form(op, "set!") || is_form(op, "define")) && l.size > 1
+            && is_form(l.data[1], "begin")) {
+        return false;
+    } else if (is_form(op, "begin")) {
+        return loop_safe_body(l, 1, name, tail);
+    } else if (is_form(op, "if") && l.size == 4) {
+        return loop_safe(l.data[1], name, false)
+            && loop_safe(l.data[2], name, tail) && loop_safe(l.data[3], name, tail);
+    } else if (is_form(op, "when") || is_form(op, "unless")) {
+        return l.size > 1 && loop_safe(l.data[1], name, false)
+            && loop_safe_body(l, 2, name, tail);
+    } else if (is_form(op, "and") || is_form(op, "or")) {
+        return loop_safe_body(l, 1, name, tail);
+    } else if (is_form(op, "cond")) {
+        for (size_t i = 1; i < l.size; i++) {
+            if (l.data[i].type != EXP_LIST) {
+                return false;
+            }
+            List clause = AS_LIST(l.data[i]);
+            bool arrow = clause.size == 3 && is_form(clause.data[1], "=>");
+            if (clause.size > 0 && !(loop_safe(clause.data[0], name, false)
+                                     && loop_safe_body(clause, 1, name, tail && !arrow))) {
+                return false;
+            }
+        }
+        return true;
+    } else if ((is_form(op, "let") || is_form(op, "let*") || is_form(op, "letrec"))
+            && l.size > 1 && l.data[1].type == EXP_LIST) {
+        List bindings = AS_LIST(l.data[1]);
+        for (size_t i = 0; i < bindings.size; i++) {
+            if (bindings.data[i].type != EXP_LIST || AS_LIST(bindings.data[i]).size == 0
+             || is_form(AS_LIST(bindings.data[i]).data[0], "begin")
+             || !loop_safe_body(AS_LIST(bindings.data[i]), 0, name, false)) {
+                return false;
+            }
+        }
+        return loop_safe_body(l, 2, name, tail);
+    }
+    return loop_safe_body(l, 0, name, false);
+}
+
+// The first call to begin in l[from..], or void if there's none.
+static Exp find_begin(List l, size_t from)
+{
+    if (l.size > 0 && is_form(l.data[0], "quote")) {
+        return (Exp) { .type = EXP_VOID };
+    }
+    for (size_t i = from; i < l.size; i++) {
+        if (l.data[i].type != EXP_LIST || AS_LIST(l.data[i]).size == 0) {
+            continue;
+        }
+        List sub = AS_LIST(l.data[i]);
+        Exp begin = is_form(sub.data[0], "begin") ? sub.data[0] : find_begin(sub, 0);
+        if (begin.type != EXP_VOID) {
+            return begin;
+        }
+    }
+    return (Exp) { .type = EXP_VOID };
+}
+
+// Store the arguments of a tail call to the loop as the next values.
+static Exp loop_next(Interp *interp, List call, Env *env, Loop *loop)
+{
+    if (call.size - 1 != loop->vars.size) {
+        die(interp, "%s: arity mismatch\n", AS_SYM(loop->name));
+    }
+    List *vals = &AS_LIST(loop->vals);
+    vals->size = 0;
+    for (size_t i = 1; i < call.size; i++) {
+        vals->data[vals->size++] = eval(interp, call.data[i], env);
+    }
+    loop->again = true;
+    return (Exp) { .type = EXP_VOID };
+}
+
+static Exp eval_loop_tail(Interp *interp, Exp x, Env *env, Loop *loop)
+{
+    if (x.type != EXP_LIST || AS_LIST(x).size == 0) {
+        return eval(interp, x, env);
+    }
+    List l = AS_LIST(x);
+    Exp op = l.data[0];
+    if (exp_eq(op, loop->name)) {
+        return loop_next(interp, l, env, loop);
+    } else if (is_begin(op, env)) {
+        return eval_body(interp, l, 1, env, loop);
+    } else if (is_form(op, "if")) {
+        return eval_if(interp, l, env, loop);
+    } else if (is_form(op, "when") || is_form(op, "unless")) {
+        return eval_when(interp, l, env, loop, is_form(op, "when"));
+    } else if (is_form(op, "and") || is_form(op, "or")) {
+        return eval_and_or(interp, l, env, loop, is_form(op, "and"));
+    } else if (is_form(op, "cond")) {
+        bool matched;
+        return eval_clauses(interp, l, 1, env, loop, "cond", &matched);
+    } else if (is_form(op, "let") && l.size > 1 && !is_symbol(l.data[1])) {
+        return eval_let(interp, l, env, loop, LET, "let");
+    } else if (is_form(op, "let*")) {
+        return eval_let(interp, l, env, loop, LET_STAR, "let*");
+    } else if (is_form(op, "letrec")) {
+        return eval_let(interp, l, env, loop, LETREC, "letrec");
+    }
+    return eval(interp, x, env);
+}
+
+// A named let that can't run as a loop: bind name to a procedure and call it.
+static Exp call_named_let(Interp *interp, List l, Env *env, Env *frame, List bindings)
+{
+    Exp params = mklist_with_cap(interp, bindings.size);
+    save(interp, params);
+    for (size_t i = 0; i < bindings.size; i++) {
+        list_add(interp, &AS_LIST(params), AS_LIST(bindings.data[i]).data[0]);
+    }
+    // a body with several forms runs inside (let () body...)
+    Exp body = l.data[3];
+    if (l.size > 4) {
+        body = mklist_with_cap(interp, l.size - 1);
+        save(interp, body);
+        list_add(interp, &AS_LIST(body), mkcsym(interp, "let"));
+        list_add(interp, &AS_LIST(body), mklist(interp, (List) VECTOR_INIT()));
+        for (size_t i = 3; i < l.size; i++) {
+            list_add(interp, &AS_LIST(body), l.data[i]);
+        }
+        unsave(interp, body);
+    }
+    Exp proc = mkproc(interp, params, body, frame);
+    unsave(interp, params);
+    add_env(interp, frame, l.data[1], proc);
+
+    Exp args = mklist_with_cap(interp, bindings.size);
+    save(interp, args);
+    for (size_t i = 0; i < bindings.size; i++) {
+        Exp val = eval(interp, AS_LIST(bindings.data[i]).data[1], env);
+        save(interp, val);
+        list_add(interp, &AS_LIST(args), val);
+        unsave(interp, val);
+    }
+    Exp res = proc_call(interp, &AS_PROC(proc), AS_LIST(args));
+    unsave(interp, args);
+    return res;
+}
+
+// (let name ((var init)...) body...)
+NOINLINE static Exp eval_named_let(Interp *interp, List l, Env *env)
+{
+    if (l.size < 4) {
+        die(interp, "let: bad syntax\n");
+    }
+    Exp name = l.data[1];
+    List bindings = check_bindings(interp, l.data[2], 2, 2, "let");
+    bool safe = loop_safe_body(l, 3, name, true);
+    Exp begin = find_begin(l, 3);
+    safe = safe && (begin.type == EXP_VOID || is_begin(begin, env));
+    for (size_t i = 0; i < bindings.size; i++) {
+        Exp var = AS_LIST(bindings.data[i]).data[0];
+        safe = safe && !exp_eq(var, name) && !is_form(var, "begin");
+    }
+    Env *frame = new_env(interp, env);
+    gc_push_env(interp, frame);
+    if (!safe) {
+        Exp res = call_named_let(interp, l, env, frame, bindings);
+        gc_pop_env(interp);
+        return res;
+    }
+    for (size_t i = 0; i < bindings.size; i++) {
+        List b = AS_LIST(bindings.data[i]);
+        add_env(interp, frame, b.data[0], eval(interp, b.data[1], env));
+    }
+    Loop loop = { .name = name, .vars = bindings };
+    loop.vals = mklist_with_cap(interp, bindings.size);
+    save(interp, loop.vals);
+    Exp res;
+    do {
+        loop.again = false;
+        res = eval_body(interp, l, 3, frame, &loop);
+        if (loop.again) {
+            for (size_t i = 0; i < bindings.size; i++) {
+                add_env(interp, frame, AS_LIST(bindings.data[i]).data[0],
+                        AS_LIST(loop.vals).data[i]);
+            }
+            gc_safe_point(interp);
+        }
+    } while (loop.again);
+    unsave(interp, loop.vals);
+    gc_pop_env(interp);
+    return res;
+}
+
+// Whether any of l[from..] makes a closure or a promise.
+static bool makes_closures(List l, size_t from)
+{
+    if (l.size > 0 && is_form(l.data[0], "quote")) {
+        return false;
+    }
+    for (size_t i = from; i < l.size; i++) {
+        if (keeps_env(l.data[i])
+         || (l.data[i].type == EXP_LIST && makes_closures(AS_LIST(l.data[i]), 0))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// (do ((var init step)...) (test expr...) command...)
+// The variables live in one frame that is updated in place, unless the loop
+// makes closures: then each iteration gets a new frame, as they may keep it.
+NOINLINE static Exp eval_do(Interp *interp, List l, Env *env)
+{
+    if (l.size < 3 || l.data[2].type != EXP_LIST || AS_LIST(l.data[2]).size == 0) {
+        die(interp, "do: bad syntax\n");
+    }
+    List specs = check_bindings(interp, l.data[1], 2, 3, "do");
+    List end = AS_LIST(l.data[2]);
+    bool fresh_frames = makes_closures(l, 1);
+    Env *frame = new_env(interp, env);
+    gc_push_env(interp, frame);
+    for (size_t i = 0; i < specs.size; i++) {
+        List spec = AS_LIST(specs.data[i]);
+        add_env(interp, frame, spec.data[0], eval(interp, spec.data[1], env));
+    }
+    Exp vals = mklist_with_cap(interp, specs.size);
+    save(interp, vals);
+    while (!is_true(eval(interp, end.data[0], frame))) {
+        for (size_t i = 3; i < l.size; i++) {
+            eval(interp, l.data[i], frame);
+        }
+        List *v = &AS_LIST(vals);
+        v->size = 0;
+        for (size_t i = 0; i < specs.size; i++) {
+            List spec = AS_LIST(specs.data[i]);
+            if (spec.size == 3) {
+                v->data[v->size++] = eval(interp, spec.data[2], frame);
+            } else if (fresh_frames) {
+                ht_lookup(&ENV_HT(frame), spec.data[0], &v->data[v->size]);
+                v->data[v->size] = unbox(v->data[v->size]);
+                v->size++;
+            }
+        }
+        if (fresh_frames) {
+            frame = new_env(interp, env);
+            gc_pop_env(interp);
+            gc_push_env(interp, frame);
+        }
+        for (size_t i = 0, j = 0; i < specs.size; i++) {
+            List spec = AS_LIST(specs.data[i]);
+            if (spec.size == 3 || fresh_frames) {
+                add_env(interp, frame, spec.data[0], v->data[j++]);
+            }
+        }
+        gc_safe_point(interp);
+    }
+    unsave(interp, vals);
+    Exp res = eval_body(interp, end, 1, frame, NULL);
+    gc_pop_env(interp);
+    return res;
+}
+
+typedef struct GuardBody {
+    List form;
+    Env *env;
+    Exp result;
+} GuardBody;
+
+static void eval_guard_body(Interp *interp, void *data)
+{
+    GuardBody *g = data;
+    g->result = eval_body(interp, g->form, 2, g->env, NULL);
+}
+
+// (guard (var clause...) body...)
+// Evaluate body. If it raises, bind what was raised to var and evaluate the
+// first clause whose test is true, as in cond; re-raise if there's none.
+NOINLINE static Exp eval_guard(Interp *interp, List l, Env *env)
+{
+    if (l.size < 2 || l.data[1].type != EXP_LIST || AS_LIST(l.data[1]).size == 0
+     || !is_symbol(AS_LIST(l.data[1]).data[0])) {
+        die(interp, "guard: bad syntax\n");
+    }
+    GuardBody g = { .form = l, .env = env };
+    if (interp_try(interp, eval_guard_body, &g)) {
+        return g.result;
+    }
+    Exp condition = interp->raised.type != EXP_EMPTY ? interp->raised
+                                                     : mkerror(interp, interp->error);
+    interp->raised = (Exp) { .type = EXP_EMPTY };
+    save(interp, condition);
+    List spec = AS_LIST(l.data[1]);
+    Env *guard_env = new_env(interp, env);
+    gc_push_env(interp, guard_env);
+    add_env(interp, guard_env, spec.data[0], condition);
+    bool matched;
+    Exp res = eval_clauses(interp, spec, 1, guard_env, NULL, "guard", &matched);
+    gc_pop_env(interp);
+    unsave(interp, condition);
+    if (!matched) {
+        raise_exp(interp, condition);
+    }
+    return res;
+}
+
+// Calls with up to this many arguments don't allocate an argument list.
+#define ARGS_INLINE 4
+
 // Evaluate an expression in an environment.
-Exp eval(Exp x, Env *env)
+Exp eval(Interp *interp, Exp x, Env *env)
 {
+    if (--interp->fuel <= 0) {
+        green_preempt(interp);
+    }
     if (x.type == EXP_EOF) {
         return x;
     } else if (is_symbol(x)) {
@@ -198,157 +1062,412 @@ Exp eval(Exp x, Env *env)
         // variable reference
         Env *e = env_find(env, x);
         if (!e) {
-            die("undefined symbol: %s\n", s);
+            die(interp, "undefined symbol: %s\n", s);
         }
         Exp value;
-        bool found = ht_lookup(&e->obj->ht, x, &value);
+        bool found = ht_lookup(&ENV_HT(e), x, &value);
         if (!found) {
-            die("error: couldn't find %s in env\n", s);
+            die(interp, "error: couldn't find %s in env\n", s);
         }
-        return value;
-    } else if (is_number(x)) {
-        // constant number
+        return unbox(value);
+    } else if (x.type != EXP_LIST) {
+        // constant: number, vector, or the void left by define-syntax
         return x;
     }
     List l = AS_LIST(x);
     if (l.size == 0) {
-        die("missing procedure expression\n");
+        die(interp, "missing procedure expression\n");
     }
     Exp op = l.data[0];
     if (is_symbol(op) && strcmp(AS_SYM(op), "quote") == 0) {
         return l.data[1];
     } else if (is_symbol(op) && strcmp(AS_SYM(op), "if") == 0) {
         // conditional
-        Exp test        = l.data[1];
-        Exp conseq      = l.data[2];
-        Exp alt         = l.data[3];
-        Exp test_result = eval(test, env);
-        Exp exp = !is_number(test_result)
-               || (is_number(test_result) && test_result.number != 0)
-               ? conseq : alt;
-        return eval(exp, env);
+        return eval_if(interp, l, env, NULL);
     } else if (is_symbol(op) && strcmp(AS_SYM(op), "define") == 0) {
         // definition
         if (!is_symbol(l.data[1])) {
-            die("define: bad syntax\n");
+            die(interp, "define: bad syntax\n");
         }
         Exp exp = l.data[2];
-        add_env(env, l.data[1], eval(exp, env));
+        assign_env(interp, env, l.data[1], eval(interp, exp, env));
         return (Exp) { .type = EXP_VOID };
     } else if (is_symbol(op) && strcmp(AS_SYM(op), "set!") == 0) {
         // assignment
         if (!is_symbol(l.data[1])) {
-            die("set!: bad syntax\n");
+            die(interp, "set!: bad syntax\n");
         }
         Exp exp = l.data[2];
         Env *e = env_find(env, l.data[1]);
         if (!e) {
-            die("undefined symbol: %s\n", AS_SYM(l.data[1]));
+            die(interp, "undefined symbol: %s\n", AS_SYM(l.data[1]));
         }
-        add_env(e, l.data[1], eval(exp, env));
+        assign_env(interp, e, l.data[1], eval(interp, exp, env));
         return (Exp) { .type = EXP_VOID };
+    } else if (is_symbol(op) && strcmp(AS_SYM(op), "let") == 0) {
+        return l.size > 1 && is_symbol(l.data[1])
+            ? eval_named_let(interp, l, env)
+            : eval_let(interp, l, env, NULL, LET, "let");
+    } else if (is_symbol(op) && strcmp(AS_SYM(op), "let*") == 0) {
+        return eval_let(interp, l, env, NULL, LET_STAR, "let*");
+    } else if (is_symbol(op) && strcmp(AS_SYM(op), "letrec") == 0) {
+        return eval_let(interp, l, env, NULL, LETREC, "letrec");
+    } else if (is_symbol(op) && strcmp(AS_SYM(op), "do") == 0) {
+        return eval_do(interp, l, env);
+    } else if (is_symbol(op) && strcmp(AS_SYM(op), "cond") == 0) {
+        bool matched;
+        return eval_clauses(interp, l, 1, env, NULL, "cond", &matched);
+    } else if (is_symbol(op) && strcmp(AS_SYM(op), "when") == 0) {
+        return eval_when(interp, l, env, NULL, true);
+    } else if (is_symbol(op) && strcmp(AS_SYM(op), "unless") == 0) {
+        return eval_when(interp, l, env, NULL, false);
+    } else if (is_symbol(op) && strcmp(AS_SYM(op), "and") == 0) {
+        return eval_and_or(interp, l, env, NULL, true);
+    } else if (is_symbol(op) && strcmp(AS_SYM(op), "or") == 0) {
+        return eval_and_or(interp, l, env, NULL, false);
+    } else if (is_symbol(op) && strcmp(AS_SYM(op), "guard") == 0) {
+        return eval_guard(interp, l, env);
+    } else if (is_symbol(op) && (strcmp(AS_SYM(op), "delay") == 0
+                              || strcmp(AS_SYM(op), "delay-force") == 0)) {
+        if (l.size != 2) {
+            die(interp, "%s: bad syntax\n", AS_SYM(op));
+        }
+        return mkpromise(interp, (Promise) {
+            .chained = strcmp(AS_SYM(op), "delay-force") == 0, .exp = l.data[1], .env = env
+        });
+    } else if (is_symbol(op) && strcmp(AS_SYM(op), "cons-stream") == 0) {
+        // (list first (delay rest))
+        if (l.size != 3) {
+            die(interp, "cons-stream: bad syntax\n");
+        }
+        Exp res = mklist_with_cap(interp, 2);
+        save(interp, res);
+        list_add(interp, &AS_LIST(res), eval(interp, l.data[1], env));
+        list_add(interp, &AS_LIST(res), mkpromise(interp, (Promise) { .exp = l.data[2], .env = env }));
+        unsave(interp, res);
+        return res;
+    } else if (is_symbol(op) && strcmp(AS_SYM(op), "future") == 0) {
+        if (l.size != 2) {
+            die(interp, "future: bad syntax\n");
+        }
+        return make_future(interp, l.data[1], env);
     } else if (is_symbol(op) && strcmp(AS_SYM(op), "lambda") == 0) {
-        // procedure
+        // procedure, with the variables it captures if closure.c found them
         Exp params = l.data[1];
         Exp body   = l.data[2];
-        return mkproc(params, body, *env);
+        if (l.size == 4) {
+            List vars = AS_LIST(AS_LIST(l.data[3]).data[1]);
+            Exp proc = mkproc(interp, params, body, closure_env(interp, vars, env));
+            AS_PROC(proc).stack_frame = is_true(vars.data[2]);
+            return proc;
+        }
+        return mkproc(interp, params, body, env);
     }
     // procedure call
-    Exp proc = eval(op, env);
+    Exp proc = eval(interp, op, env);
     if (proc.type != EXP_C_PROC && proc.type != EXP_PROC) {
-        die("error: not a procedure\n");
+        die(interp, "error: not a procedure\n");
     }
-    // wrap args list in an object. this is to make sure it will be found
-    // by the garbage collector.
+    // arguments go in a buffer on the C stack when they fit, so that calls
+    // don't allocate. they need no rooting: between top-level forms, they're
+    // gone, and within one, the collector scans the C stack (gc_safe_point).
     // procedure calls may not use the underlying list to create new objects.
-    Exp args = mklist((List) VECTOR_INIT());
-    save(args);
+    Exp inline_args[ARGS_INLINE];
+    List args = { .data = inline_args, .size = 0, .cap = ARGS_INLINE };
+    Exp args_obj = (Exp) { .type = EXP_EMPTY };
+    if (l.size - 1 > ARGS_INLINE) {
+        args_obj = mklist_with_cap(interp, l.size - 1);
+        save(interp, args_obj);
+        args.data = AS_LIST(args_obj).data;
+        args.cap = AS_LIST(args_obj).cap;
+    }
     for (size_t i = 1; i < l.size; i++) {
-        Exp new_elem = eval(l.data[i], env);
-        save(new_elem);
-        list_add(&AS_LIST(args), new_elem);
-        unsave(new_elem);
+        args.data[args.size++] = eval(interp, l.data[i], env);
     }
+#ifdef HEAP_PROFILE
+    // attribute what happens inside the call to its site: a primitive
+    // is charged to the current procedure, a user procedure becomes current.
+    const char *name = is_symbol(op) ? AS_SYM(op) : "<lambda>";
+    int prev_site = heapprof_set(interp, proc.type == EXP_C_PROC
+        ? heapprof_site(heapprof_proc(interp), name)
+        : heapprof_site(name, HEAPPROF_EVAL));
+#endif
     Exp res = proc.type == EXP_C_PROC
-        ? proc.cproc(AS_LIST(args))
-        : proc_call(&AS_PROC(proc), AS_LIST(args));
-    unsave(args);
+        ? proc.cproc(interp, args)
+        : proc_call(interp, &AS_PROC(proc), args);
+#ifdef HEAP_PROFILE
+    heapprof_set(interp, prev_site);
+#endif
+    unsave(interp, args_obj);
     return res;
 }
 
-void print(Exp exp)
+static void print_elements(Writer *w, List l)
+{
+    writer_putc(w, '(');
+    for (size_t i = 0; i < l.size; i++) {
+        print_to(w, l.data[i]);
+        if (i != l.size-1) {
+            writer_putc(w, ' ');
+        }
+    }
+    writer_putc(w, ')');
+}
+
+void print_to(Writer *w, Exp exp)
 {
     switch (exp.type) {
     case EXP_EMPTY:  break;
-    case EXP_SYMBOL: printf("%s", AS_SYM(exp)); break;
-    case EXP_NUMBER: printf("%g", exp.number);  break;
-    case EXP_LIST:
-        printf("(");
-        for (size_t i = 0; i < AS_LIST(exp).size; i++) {
-            print(AS_LIST(exp).data[i]);
-            if (i != AS_LIST(exp).size-1) {
-                printf(" ");
-            }
-        }
-        printf(")");
+    case EXP_SYMBOL: writer_puts(w, AS_SYM(exp)); break;
+    case EXP_NUMBER: writer_number(w, exp.number); break;
+    case EXP_LIST:   print_elements(w, AS_LIST(exp)); break;
+    case EXP_VECTOR: writer_putc(w, '#'); print_elements(w, AS_VECTOR(exp)); break;
+    case EXP_HASH_TABLE: writer_puts(w, "<#hash-table>"); break;
+    case EXP_CONDITION:
+        writer_puts(w, "<#error ");
+        print_condition(w, &AS_CONDITION(exp));
+        writer_putc(w, '>');
         break;
-    case EXP_C_PROC: printf("<#c-procedure>"); break;
-    case EXP_PROC:   printf("<#procedure>");   break;
+    case EXP_C_PROC: writer_puts(w, "<#c-procedure>"); break;
+    case EXP_PROC:   writer_puts(w, "<#procedure>");   break;
+    case EXP_BOX:    print_to(w, exp.obj->box); break;
+    case EXP_PROMISE: writer_puts(w, "<#promise>"); break;
+    case EXP_FUTURE: writer_puts(w, "<#future>"); break;
+    case EXP_THREAD: writer_puts(w, "<#thread>"); break;
+    case EXP_CHANNEL: writer_puts(w, "<#channel>"); break;
     case EXP_VOID:   break;
     case EXP_EOF:    break;
     }
 }
 
-// A prompt-read-eval-print loop.
-void repl()
+Interp *interp_new()
+{
+    Interp *interp = malloc(sizeof(Interp));
+    if (!interp) {
+        abort();
+    }
+    gc_init(&interp->gc);
+#ifdef HEAP_PROFILE
+    interp->prof_site = -1;
+#endif
+    writer_init(&interp->stdout_writer, STDOUT_FILENO, WRITER_DEFAULT_SIZE);
+    interp->out = &interp->stdout_writer;
+    interp->handler = NULL;
+    interp->handlers = (List) VECTOR_INIT();
+    interp->raised = (Exp) { .type = EXP_EMPTY };
+    interp->error[0] = '\0';
+    interp->global = NULL;
+    interp->macros = (Exp) { .type = EXP_EMPTY };
+    interp->macros = mkhashtable(interp, false);
+    interp->definitions = (Exp) { .type = EXP_EMPTY };
+    interp->definitions = mkhashtable(interp, false);
+    interp->gensym = 0;
+    interp->optimize = true;
+    interp->whole_program = false;
+    interp->jit = true;
+    interp->global_version = 0;
+    interp->shared_jit = NULL;
+    interp->shared_jit_size = 0;
+    interp->shared_jit_cap = 0;
+    interp->pool = NULL;
+    interp->worker = false;
+    interp->scheduler = NULL;
+    interp->fuel = GREEN_FUEL;
+    interp->stack_limit = 0;
+    interp->stack_base = 0;
+    interp->global = standard_env(interp);
+    return interp;
+}
+
+void interp_free(Interp *interp)
+{
+    interp->gc.sp = 0;
+    interp->gc.env_sp = 0;
+    interp->gc.frames_sp = 0;
+    interp->gc.pins_size = 0;
+    interp->global = NULL;
+    interp->macros = (Exp) { .type = EXP_EMPTY };
+    interp->definitions = (Exp) { .type = EXP_EMPTY };
+    interp->raised = (Exp) { .type = EXP_EMPTY };
+    list_free(interp, &interp->handlers);
+    gc_sweep(interp);
+    parallel_free(interp);
+    green_free(interp);
+    jit_free_shared(interp);
+    gc_free(&interp->gc);
+    writer_free(&interp->stdout_writer);
+    free(interp);
+}
+
+void interp_pin(Interp *interp, Exp exp)   { if (is_obj(exp)) { gc_pin(interp, exp.obj); } }
+void interp_unpin(Interp *interp, Exp exp) { if (is_obj(exp)) { gc_unpin(interp, exp.obj); } }
+
+Exp interp_parse(Interp *interp, const char *src)
+{
+    Exp forms = mklist(interp, (List) VECTOR_INIT());
+    interp_pin(interp, forms);
+    Tokenizer t = { .i = 0, .s = src, .len = strlen(src) };
+    next_token(&t);
+    Exp parsed;
+    while (parsed = read_from_tokens(interp, &t), parsed.type != EXP_EOF) {
+        save(interp, parsed);
+        list_add(interp, &AS_LIST(forms), parsed);
+        unsave(interp, parsed);
+    }
+    return forms;
+}
+
+// Evaluate a top-level form that expand has already been through.
+// This is a safe point for the collector, as the form only ends once no
+// green thread is left (see green.c).
+static Exp eval_expanded(Interp *interp, Exp expanded)
+{
+    uintptr_t stack_limit = stack_enter(interp);
+    save(interp, expanded);
+    green_finish(interp); // the threads of a form that raised an error
+    gc_maybe_collect(interp);
+    if (interp->optimize) {
+        expanded = optimize(interp, expanded);
+        unsave(interp, expanded);
+        save(interp, expanded);
+    }
+    convert_closures(interp, expanded);
+    Exp val = eval(interp, expanded, interp->global);
+    save(interp, val);
+    green_finish(interp);
+    unsave(interp, val);
+    unsave(interp, expanded);
+    interp->stack_limit = stack_limit;
+    return val;
+}
+
+// Evaluate a top-level form.
+static Exp eval_toplevel(Interp *interp, Exp form)
+{
+    uintptr_t stack_limit = stack_enter(interp);
+    save(interp, form);
+    green_finish(interp);
+    Exp expanded = expand(interp, form);
+    unsave(interp, form);
+    interp->stack_limit = stack_limit;
+    return eval_expanded(interp, expanded);
+}
+
+Exp interp_eval(Interp *interp, Exp form)
+{
+    Exp val = eval_toplevel(interp, form);
+    interp_pin(interp, val);
+    return val;
+}
+
+Exp interp_eval_string(Interp *interp, const char *src)
+{
+    Exp val = (Exp) { .type = EXP_VOID };
+    Exp parsed;
+    Tokenizer t = { .i = 0, .s = src, .len = strlen(src) };
+    next_token(&t);
+    while (parsed = read_from_tokens(interp, &t), parsed.type != EXP_EOF) {
+        val = eval_toplevel(interp, parsed);
+    }
+    interp_pin(interp, val);
+    return val;
+}
+
+Exp interp_symbol(Interp *interp, const char *name)
+{
+    return mkcsym(interp, name);
+}
+
+void interp_define(Interp *interp, const char *name, Exp value)
+{
+    add_env(interp, interp->global, mkcsym(interp, name), value);
+}
+
+void interp_register(Interp *interp, const char *name, CProc proc)
+{
+    interp_define(interp, name, mkcproc(proc));
+}
+
+typedef struct ReplLine {
+    const char *input;
+    Exp val;
+} ReplLine;
+
+static void repl_eval(Interp *interp, void *data)
+{
+    ReplLine *line = data;
+    Exp parsed = parse(interp, line->input);
+#ifdef DEBUG
+    writer_puts(interp->out, "parsed = ");
+    print_to(interp->out, parsed);
+    writer_putc(interp->out, '\n');
+#endif
+    line->val = eval_toplevel(interp, parsed);
+}
+
+// A prompt-read-eval-print loop. Errors are reported and the session goes on.
+void repl(Interp *interp)
 {
-    Env env = standard_env();
-    gc_push_env(&env);
     while (true) {
-        printf("sCheme> ");
+        writer_puts(interp->out, "sCheme> ");
+        writer_flush(interp->out);
         char input[BUFSIZ] = {0};
         fgets(input, sizeof(input), stdin);
-        Exp parsed = parse(input);
-#ifdef DEBUG
-        printf("parsed = ");
-        print(parsed);
-        printf("\n");
-#endif
-        save(parsed);
-        Exp val = eval(parsed, &env);
-        if (val.type == EXP_EOF) {
-            printf("\n");
+        ReplLine line = { .input = input };
+        if (!interp_try(interp, repl_eval, &line)) {
+            writer_flush(interp->out);
+            fprintf(stderr, "%s\n", interp->error);
+            continue;
+        }
+        if (line.val.type == EXP_EOF) {
+            writer_putc(interp->out, '\n');
             break;
         }
-        print(val);
-        unsave(parsed);
-        printf("\n");
+        print_to(interp->out, line.val);
+        writer_putc(interp->out, '\n');
     }
-    gc_pop_env(&env);
-    gc_sweep();
 }
 
-void exec_string(const char *input)
+typedef struct Expansion {
+    List forms;
+    size_t expanded;
+} Expansion;
+
+static void expand_forms(Interp *interp, void *data)
 {
-    Env env = standard_env();
-    gc_push_env(&env);
-    Exp parsed;
-    Tokenizer t = { .i = 0, .s = input, .len = strlen(input) };
-    next_token(&t);
-    while (parsed = read_from_tokens(&t), parsed.type != EXP_EOF) {
+    Expansion *e = data;
+    for (; e->expanded < e->forms.size; e->expanded++) {
+        e->forms.data[e->expanded] = expand(interp, e->forms.data[e->expanded]);
+    }
+}
+
+// Evaluate every form in input. The whole input is read and expanded
+// first, so that the optimizer knows about every definition in it, even
+// those a macro makes. If nothing else will run in interp (a script), the
+// host sets interp->whole_program, and the optimizer may then count on no
+// other form assigning a global.
+// Expanding never runs any code, so it's the same done ahead as form by
+// form; if a form fails to expand, it and the forms after it are left to
+// fail in turn, once the ones before have run.
+void exec_string(Interp *interp, const char *input)
+{
+    Exp forms = interp_parse(interp, input);
+    Expansion e = { .forms = AS_LIST(forms), .expanded = 0 };
+    interp_try(interp, expand_forms, &e);
+    for (size_t i = 0; i < e.expanded; i++) {
+        note_definitions(interp, AS_LIST(forms).data[i]);
+    }
+    for (size_t i = 0; i < AS_LIST(forms).size; i++) {
+        Exp form = AS_LIST(forms).data[i];
 #ifdef DEBUG
-        printf("parsed = ");
-        print(parsed);
-        printf("\n");
+        writer_puts(interp->out, i < e.expanded ? "expanded = " : "parsed = ");
+        print_to(interp->out, form);
+        writer_putc(interp->out, '\n');
 #endif
-        save(parsed);
-        Exp val = eval(parsed, &env);
-        print(val);
-        unsave(parsed);
+        Exp val = i < e.expanded ? eval_expanded(interp, form) : eval_toplevel(interp, form);
+        print_to(interp->out, val);
         if (val.type != EXP_VOID && val.type != EXP_EMPTY)
-            printf("\n");
+            writer_putc(interp->out, '\n');
     }
-    gc_pop_env(&env);
-    gc_sweep();
+    interp_unpin(interp, forms);
 }
-
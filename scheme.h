@@ -7,16 +7,19 @@
 #include <stdint.h>
 #include <string.h>
 #include <stdnoreturn.h>
+#include <setjmp.h>
 #include <math.h>
 #include <stdbool.h>
 #include "vector.h"
 #include "memory.h"
+#include "writer.h"
 
-#undef VECTOR_ARRAY_ALLOC
-#define VECTOR_ARRAY_ALLOC GROW_ARRAY
+// Lists are allocated through the interpreter passed as context.
+#undef VECTOR_ARRAY_ALLOC_CTX
+#define VECTOR_ARRAY_ALLOC_CTX GROW_ARRAY
 
-#undef VECTOR_ARRAY_FREE
-#define VECTOR_ARRAY_FREE FREE_ARRAY
+#undef VECTOR_ARRAY_FREE_CTX
+#define VECTOR_ARRAY_FREE_CTX FREE_ARRAY
 
 typedef char *Symbol;   // A Scheme Symbol is implemented as a C string
 typedef double Number;  // A Scheme number is implemented as a C int
@@ -35,14 +38,17 @@ typedef struct Exp Exp;
 // A Scheme List is implemented as a resizable array of expressions
 VECTOR_DECLARE_STRUCT(List, Exp);
 VECTOR_DECLARE_INIT(List, Exp, list);
-VECTOR_DECLARE_ADD(List, Exp, list);
-VECTOR_DECLARE_FREE(List, Exp, list);
+VECTOR_DECLARE_ADD_CTX(List, Exp, list, Interp *);
+VECTOR_DECLARE_FREE_CTX(List, Exp, list, Interp *);
+
+// A Scheme Vector uses the same resizable array as a List, but is a distinct
+// type with O(1) indexing and in-place mutation.
 
 // A native C procedure
-typedef Exp (*CProc)(List args);
+typedef Exp (*CProc)(Interp *interp, List args);
 
 // A Scheme expression is either an Atom, a List, a C Procedure,
-// a user-defined Procedure or void
+// a user-defined Procedure, a Vector, a Hash table or void
 typedef enum ExpType {
     EXP_EMPTY = 0,
     EXP_VOID,
@@ -52,6 +58,14 @@ typedef enum ExpType {
     EXP_C_PROC,
     EXP_PROC,
     EXP_EOF,
+    EXP_VECTOR,
+    EXP_HASH_TABLE,
+    EXP_CONDITION,
+    EXP_BOX,        // only ever bound to a variable, never a value
+    EXP_PROMISE,
+    EXP_FUTURE,
+    EXP_THREAD,
+    EXP_CHANNEL,
 } ExpType;
 
 struct Exp {
@@ -64,21 +78,80 @@ struct Exp {
 };
 
 // An environment: a hashtable of ("var": exp) pairs, with an outer Env.
+// Every Env lives inside its own GC object (see new_env), so an Env * stays
+// valid for as long as that object is reachable, and reaching an Env
+// also reaches all of its outer Envs.
 typedef struct Env {
     GCObject *obj; // hashtable is contained here
     struct Env *outer;
 } Env;
 
+// Native code for a procedure (see jit.c).
+typedef struct JitCode JitCode;
+
 // A user-defined Scheme procedure
 typedef struct Procedure {
     Exp params;
     Exp body;
-    Env env;
+    Env *env;
+    int calls;    // calls so far, until it's compiled
+    JitCode *jit; // native code, or NULL
+    bool stack_frame; // no closure can keep a call's frame (see closure.c)
 } Procedure;
 
+// An error object, as made by error or by a failing primitive.
+typedef struct Condition {
+    Exp message;   // usually a symbol
+    Exp irritants; // a list
+} Condition;
+
+// A promise, as made by delay, delay-force, cons-stream or make-promise.
+typedef struct Promise {
+    bool done;    // whether exp is the value
+    bool chained; // made by delay-force: exp evaluates to another promise
+    bool shared;  // its state was handed over to the promise exp (see force)
+    Exp exp;      // the value, the expression that computes it, or the promise
+    Env *env;     // where exp is evaluated, or NULL once done
+} Promise;
+
+// A future, as made by (future expr) (see parallel.c).
+typedef struct Future {
+    struct Task *task; // computing the value, or NULL once it was touched
+    Exp value;         // once touched: the value, or what was raised
+    bool failed;       // whether it raised
+} Future;
+
+// Green threads waiting for something, first come first served.
+typedef struct WaitQueue {
+    struct Fiber *head;
+    struct Fiber *tail;
+} WaitQueue;
+
+// A green thread, as made by spawn (see green.c).
+typedef struct Thread {
+    struct Fiber *fiber; // running it, or NULL once it finished
+    Exp thunk;           // what it runs
+    Exp value;           // once finished: what thunk returned, or raised
+    bool failed;         // whether it raised
+    WaitQueue joiners;   // threads waiting for it to finish
+} Thread;
+
+// A channel, as made by make-channel (see green.c).
+typedef struct Channel {
+    List values;         // sent and not received yet, from head on
+    size_t head;
+    size_t capacity;     // how many values it holds at most, or 0 for no limit
+    WaitQueue receivers; // threads waiting for a value
+    WaitQueue senders;   // threads waiting for room
+} Channel;
+
 // Some utilities for working with Exp.
 static inline bool is_symbol(Exp exp) { return exp.type == EXP_SYMBOL; }
 static inline bool is_number(Exp exp) { return exp.type == EXP_NUMBER; }
+static inline bool is_proc(Exp exp)   { return exp.type == EXP_PROC || exp.type == EXP_C_PROC; }
+
+// Everything except the number 0 counts as true.
+static inline bool is_true(Exp exp)   { return !is_number(exp) || exp.number != 0; }
 
 static inline Exp mknum(double n)
 {
@@ -93,10 +166,139 @@ static inline Exp mkcproc(CProc cproc)
 #define SCHEME_TRUE mknum(1)
 #define SCHEME_FALSE mknum(0)
 
-Exp eval(Exp x, Env *env);
-Exp proc_call(Procedure *proc, List args);
-void repl();
-void print();
-void exec_string(const char *s);
+bool exp_eq(Exp first, Exp second);
+bool exp_equal(Exp first, Exp second);
+
+// Where errors jump to when they are caught (see interp_try).
+typedef struct ErrorHandler {
+    jmp_buf buf;
+    int sp;         // GC stack depths to restore
+    int env_sp;
+    size_t frames_sp;
+    size_t handlers_size;
+    uintptr_t stack_limit;
+    struct ErrorHandler *prev;
+} ErrorHandler;
+
+// An interpreter instance. All mutable interpreter state lives here, so
+// independent interpreters can exist side by side in one process, each one
+// used by a single thread at a time.
+struct Interp {
+    GC gc;
+    Env *global;           // the standard environment plus top-level definitions
+    Writer *out;           // where display, newline and results are written
+    Writer stdout_writer;  // the default out
+    ErrorHandler *handler; // innermost interp_try, or NULL to exit on errors
+    List handlers;         // installed by with-exception-handler, innermost last
+    Exp raised;            // object of the last caught raise, empty if it was a die
+    char error[256];       // message of the last caught error
+    Exp macros;            // hash table from macro names to their syntax-rules
+    size_t gensym;         // counter for the names made by macro expansion
+    bool optimize;         // whether forms go through the optimizer first
+    Exp definitions;       // hash table of what the optimizer knows about globals
+    bool whole_program;    // whether every form was scanned before any ran (see exec_string)
+    bool jit;              // whether procedures called often are compiled
+    size_t global_version; // changes whenever a global variable is assigned
+    struct SharedJit *shared_jit; // JIT state of shared procedures (see jit_run_shared)
+    size_t shared_jit_size;
+    size_t shared_jit_cap;
+    struct Pool *pool;     // worker threads, started on first use (see parallel.c)
+    bool worker;           // whether this runs tasks for another interpreter
+    struct Scheduler *scheduler; // green threads, made on first spawn (see green.c)
+    int fuel;              // evaluation steps left before the next thread's turn
+    uintptr_t stack_limit; // lowest C stack address a call may use, 0 outside eval
+    uintptr_t stack_base;  // where the C stack was when eval started, if it has
+#ifdef HEAP_PROFILE
+    int prof_site;         // allocation site charged for what's allocated now
+#endif
+};
+
+// Report an error. The error is raised as a condition if a handler installed
+// by with-exception-handler can see it; otherwise it jumps to the innermost
+// interp_try (e.g. a guard), or exits if there's none.
+noreturn void die(Interp *interp, const char *fmt, ...);
+
+// Report that the recursion is too deep for the GC stacks or the C stack.
+// Handlers installed by with-exception-handler are skipped, as calling one
+// would need more stack: the error goes to the innermost interp_try.
+noreturn void stack_overflow(Interp *interp);
+
+// Limit the C stack from here on, unless it's limited already, so that
+// calls past the limit raise a stack overflow. Evaluation starts with
+// this; compiled programs call it before running any code themselves.
+// Returns the limit to restore afterwards.
+uintptr_t stack_enter(Interp *interp);
+
+// Raise obj. raise_exp never returns: if the handler returns, that's an error.
+// raise_continuable returns what the handler returns.
+noreturn void raise_exp(Interp *interp, Exp obj);
+Exp raise_continuable(Interp *interp, Exp obj);
+
+// Numeric primitives of the standard environment, which jit.c compiles.
+Exp scheme_sum(Interp *interp, List args);
+Exp scheme_sub(Interp *interp, List args);
+Exp scheme_mul(Interp *interp, List args);
+Exp scheme_gt(Interp *interp, List args);
+Exp scheme_lt(Interp *interp, List args);
+Exp scheme_ge(Interp *interp, List args);
+Exp scheme_le(Interp *interp, List args);
+Exp scheme_eq(Interp *interp, List args);
+Exp scheme_not(Interp *interp, List args);
+
+// Expand every macro use in form, in place where possible.
+Exp expand(Interp *interp, Exp form);
+// Fold constants and prune dead code in an expanded form.
+Exp optimize(Interp *interp, Exp form);
+// Record which global names form defines once as a lambda, and which it
+// defines again or set!s, in interp->definitions.
+void note_definitions(Interp *interp, Exp form);
+Exp eval(Interp *interp, Exp x, Env *env);
+Exp proc_call(Interp *interp, Procedure *proc, List args);
+void repl(Interp *interp);
+void print_to(Writer *w, Exp exp);
+void exec_string(Interp *interp, const char *s);
+
+// Embedding API.
+// An Interp is a persistent session: definitions made by one call are seen
+// by the next ones, and the standard environment is built only once.
+// Values returned by interp_parse, interp_eval and interp_eval_string are
+// pinned, so the garbage collector won't free them until interp_unpin.
+// Garbage is collected between top-level forms, and within one at each
+// iteration of a loop (named let or do) and at each force, so that walking
+// a long stream runs in bounded memory. Calls that aren't loops nest, up to
+// GC_STACK_SIZE deep or the C stack's limit, past which they raise a
+// "stack overflow" error.
+// As a later call may define or set! any global, the optimizer relies on
+// none of them unless the host sets interp->whole_program (see exec_string).
+
+// Create a session with the standard environment.
+Interp *interp_new();
+
+// Destroy a session and every value it owns, pinned or not.
+void interp_free(Interp *interp);
+
+// Parse every top-level form in src and return them as a list.
+Exp interp_parse(Interp *interp, const char *src);
+
+// Evaluate a single form (e.g. an element of interp_parse's result)
+// in the global environment.
+Exp interp_eval(Interp *interp, Exp form);
+
+// Parse and evaluate every form in src, returning the last value.
+Exp interp_eval_string(Interp *interp, const char *src);
+
+// Make the symbol name.
+Exp interp_symbol(Interp *interp, const char *name);
+
+// Bind name in the global environment.
+void interp_define(Interp *interp, const char *name, Exp value);
+void interp_register(Interp *interp, const char *name, CProc proc);
+
+// Call fn(interp, data). Return true if it finished, or false if it raised
+// an error, whose message is then in interp->error.
+bool interp_try(Interp *interp, void (*fn)(Interp *interp, void *data), void *data);
+
+void interp_pin(Interp *interp, Exp exp);
+void interp_unpin(Interp *interp, Exp exp);
 
 
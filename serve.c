@@ -0,0 +1,345 @@
+// Server mode: evaluate framed requests against one persistent session.
+//
+// Requests are read from stdin, or from the connections of a Unix-domain
+// socket (served one at a time, all sharing the same global environment).
+// Two framings are accepted, and can be mixed freely:
+//
+//   <forms>\n           a line holding one or more expressions
+//   #<n>\n<n bytes>     n bytes holding one or more expressions
+//
+// A request may be at most SERVE_MAX_REQUEST bytes. A bigger one, or a
+// header that can't be parsed as a length up to that, gets the response
+// "err request too large" and ends the stream, as its framing is lost.
+//
+// Every request gets one response, framed the same way as the request:
+//
+//   ok <output>\n       or   ok <n>\n<n bytes>
+//   err <message>\n     or   err <n>\n<n bytes>
+//
+// <output> is whatever the request displayed, followed by its last value.
+// In line framing, newlines and backslashes in it are escaped as \n and \\.
+// Responses go through a large output buffer, which is flushed only when
+// every request received so far has been answered.
+//
+// Fork-server mode is for jobs that should start from the same state and
+// not see each other. The prelude is evaluated once; then every connection
+// to the socket is one job, run by a child forked for it, which inherits
+// the prelude's heap copy-on-write. The client sends the source of the job
+// and shuts down its writing side; the child evaluates it as with -f, with
+// its standard output and error going straight back to the client, and the
+// connection closes when the job is done.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "serve.h"
+
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include "scheme.h"
+#include "parallel.h"
+
+#define SERVE_READ_SIZE (64 * 1024)
+#define SERVE_OUTBUF_SIZE (1024 * 1024)
+#define SERVE_MAX_REQUEST (64 * 1024 * 1024)
+
+typedef struct Request {
+    char *src;      // NUL-terminated copy of the request body
+    Writer capture; // collects the output of the request
+} Request;
+
+static void run_request(Interp *interp, void *data)
+{
+    Request *req = data;
+    Exp val = interp_eval_string(interp, req->src);
+    print_to(interp->out, val);
+    interp_unpin(interp, val);
+}
+
+static void write_escaped(Writer *out, const char *s, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        switch (s[i]) {
+        case '\n': writer_write(out, "\\n", 2);  break;
+        case '\\': writer_write(out, "\\\\", 2); break;
+        default:   writer_putc(out, s[i]);      break;
+        }
+    }
+}
+
+// Evaluate one request and write its response.
+static void handle_request(Interp *interp, Request *req, const char *body, size_t len,
+                           bool length_framed, Writer *out)
+{
+    req->src = realloc(req->src, len + 1);
+    if (!req->src) {
+        abort();
+    }
+    memcpy(req->src, body, len);
+    req->src[len] = '\0';
+
+    writer_clear(&req->capture);
+    Writer *prev_out = interp->out;
+    interp->out = &req->capture;
+    bool ok = interp_try(interp, run_request, req);
+    interp->out = prev_out;
+
+    const char *payload = ok ? req->capture.buf : interp->error;
+    size_t payload_len = ok ? req->capture.len : strlen(interp->error);
+    writer_puts(out, ok ? "ok " : "err ");
+    if (length_framed) {
+        writer_int(out, payload_len);
+        writer_putc(out, '\n');
+        writer_write(out, payload, payload_len);
+    } else {
+        write_escaped(out, payload, payload_len);
+        writer_putc(out, '\n');
+    }
+}
+
+typedef enum Header {
+    HEADER_NONE,      // a line request
+    HEADER_OK,        // a length
+    HEADER_TOO_LARGE, // a length over SERVE_MAX_REQUEST
+} Header;
+
+// Parse a "#<n>" header line into *n.
+static Header parse_length_header(const char *line, size_t len, size_t *n)
+{
+    if (len < 2 || line[0] != '#') {
+        return HEADER_NONE;
+    }
+    size_t value = 0;
+    for (size_t i = 1; i < len; i++) {
+        if (line[i] < '0' || line[i] > '9') {
+            return HEADER_NONE;
+        }
+        value = value * 10 + (line[i] - '0');
+        if (value > SERVE_MAX_REQUEST) {
+            return HEADER_TOO_LARGE;
+        }
+    }
+    *n = value;
+    return HEADER_OK;
+}
+
+// Serve every request coming from in_fd until EOF.
+static void serve_fd(Interp *interp, int in_fd, int out_fd)
+{
+    Request req = { .src = NULL };
+    writer_init(&req.capture, -1, WRITER_DEFAULT_SIZE);
+    Writer out;
+    writer_init(&out, out_fd, SERVE_OUTBUF_SIZE);
+
+    size_t cap = SERVE_READ_SIZE, start = 0, end = 0;
+    char *buf = malloc(cap);
+    if (!buf) {
+        abort();
+    }
+    bool eof = false;
+    while (!eof) {
+        // make room at the end of the buffer
+        if (start > 0) {
+            memmove(buf, buf + start, end - start);
+            end -= start;
+            start = 0;
+        }
+        if (cap - end < SERVE_READ_SIZE) {
+            cap *= 2;
+            buf = realloc(buf, cap);
+            if (!buf) {
+                abort();
+            }
+        }
+        ssize_t n = read(in_fd, buf + end, cap - end);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        eof = n <= 0;
+        end += n > 0 ? n : 0;
+
+        // answer every complete request in the buffer
+        for (;;) {
+            char *nl = memchr(buf + start, '\n', end - start);
+            size_t line_len = nl ? (size_t) (nl - (buf + start)) : end - start;
+            size_t body_len;
+            Header header = parse_length_header(buf + start, line_len, &body_len);
+            if (header == HEADER_TOO_LARGE || line_len > SERVE_MAX_REQUEST) {
+                writer_puts(&out, "err request too large\n");
+                start = end;
+                eof = true;
+                break;
+            }
+            if (!nl && !(eof && start < end)) {
+                break;
+            }
+            if (header == HEADER_OK) {
+                size_t body = start + line_len + 1;
+                if (end < body + body_len) {
+                    if (eof) {
+                        start = end; // truncated request
+                    }
+                    break;
+                }
+                handle_request(interp, &req, buf + body, body_len, true, &out);
+                start = body + body_len;
+            } else {
+                if (line_len > 0) {
+                    handle_request(interp, &req, buf + start, line_len, false, &out);
+                }
+                start += line_len + (nl ? 1 : 0);
+            }
+        }
+        // a batch is done: we're about to wait for more input
+        writer_flush(&out);
+    }
+    free(buf);
+    free(req.src);
+    writer_free(&req.capture);
+    writer_free(&out);
+}
+
+// Listen on a Unix-domain socket at path. Return its fd, or -1.
+static int listen_on(const char *path)
+{
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "error: socket path too long: %s\n", path);
+        return -1;
+    }
+    strcpy(addr.sun_path, path);
+    // a client going away shouldn't kill the server
+    signal(SIGPIPE, SIG_IGN);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        perror("error");
+        return -1;
+    }
+    unlink(path);
+    if (bind(fd, (struct sockaddr *) &addr, sizeof(addr)) < 0 || listen(fd, 16) < 0) {
+        perror("error");
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Accept a connection on fd, or return -1 if accept fails.
+static int accept_on(int fd)
+{
+    for (;;) {
+        int conn = accept(fd, NULL, NULL);
+        if (conn >= 0 || errno != EINTR) {
+            if (conn < 0) {
+                perror("error");
+            }
+            return conn;
+        }
+    }
+}
+
+static int serve_socket(Interp *interp, const char *path)
+{
+    int fd = listen_on(path);
+    if (fd < 0) {
+        return 1;
+    }
+    int conn;
+    while ((conn = accept_on(fd)) >= 0) {
+        serve_fd(interp, conn, conn);
+        close(conn);
+    }
+    close(fd);
+    unlink(path);
+    return 1;
+}
+
+// Read everything from fd until EOF, as a NUL-terminated string.
+static char *read_all(int fd)
+{
+    size_t cap = SERVE_READ_SIZE, len = 0;
+    char *buf = malloc(cap);
+    if (!buf) {
+        abort();
+    }
+    for (;;) {
+        if (cap - len < SERVE_READ_SIZE) {
+            cap *= 2;
+            buf = realloc(buf, cap);
+            if (!buf) {
+                abort();
+            }
+        }
+        ssize_t n = read(fd, buf + len, cap - len - 1);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        len += n;
+    }
+    buf[len] = '\0';
+    return buf;
+}
+
+// In a child of the fork server: run the job sent on conn, then exit.
+static noreturn void run_job(Interp *interp, int conn)
+{
+    char *src = read_all(conn);
+    if (dup2(conn, STDOUT_FILENO) < 0 || dup2(conn, STDERR_FILENO) < 0) {
+        _exit(1);
+    }
+    close(conn);
+    exec_string(interp, src);
+    writer_flush(interp->out);
+    // leave the inherited heap alone: freeing it would copy every page
+    _exit(0);
+}
+
+int fork_serve(Interp *interp, const char *socket_path)
+{
+    // fork keeps only the calling thread, so the children start without
+    // worker threads, and make their own on first use
+    parallel_free(interp);
+    gc_collect(interp);
+    gc_share(interp);
+    writer_flush(interp->out);
+    int fd = listen_on(socket_path);
+    if (fd < 0) {
+        return 1;
+    }
+    // the children are reaped as they exit
+    signal(SIGCHLD, SIG_IGN);
+    int conn;
+    while ((conn = accept_on(fd)) >= 0) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            close(fd);
+            run_job(interp, conn);
+        }
+        if (pid < 0) {
+            perror("error");
+        }
+        close(conn);
+    }
+    close(fd);
+    unlink(socket_path);
+    return 1;
+}
+
+int serve(Interp *interp, const char *socket_path)
+{
+    if (socket_path) {
+        return serve_socket(interp, socket_path);
+    }
+    writer_flush(interp->out);
+    serve_fd(interp, STDIN_FILENO, STDOUT_FILENO);
+    return 0;
+}
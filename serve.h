@@ -0,0 +1,10 @@
+#pragma once
+
+#include "scheme.h"
+
+// Serve framed requests from stdin (socket_path == NULL) or from a
+// Unix-domain socket. See serve.c for the protocol.
+int serve(Interp *interp, const char *socket_path);
+// Run every connection to the Unix-domain socket at socket_path as a job in
+// a child forked from interp, once interp evaluated the prelude. See serve.c.
+int fork_serve(Interp *interp, const char *socket_path);
@@ -0,0 +1,45 @@
+(define square (lambda (x) (* x x)))
+(map square (list 1 2 3))
+(define make-counter
+  (lambda ()
+    (let ((n 0))
+      (lambda () (begin (set! n (+ n 1)) n)))))
+(define c (make-counter))
+(c)
+(c)
+(let* ((a 1) (b (+ a 1))) (list a b))
+(letrec ((even? (lambda (n) (if (= n 0) 1 (odd? (- n 1)))))
+         (odd? (lambda (n) (if (= n 0) 0 (even? (- n 1))))))
+  (even? 100))
+(cond ((< 2 1) (quote less)) ((> 2 1) (quote more)) (else (quote same)))
+(and 1 2 3)
+(or 0 0)
+(fold-left + 0 (iota 10))
+(filter (lambda (x) (> x 2)) (list 1 2 3 4))
+(sort (list 5 3 1 4 2) <)
+(reverse (append (list 1 2) (list 3)))
+(assq (quote b) (list (list (quote a) 1) (list (quote b) 2)))
+(define v (make-vector 3 0))
+(vector-set! v 1 (quote x))
+v
+(vector->list (list->vector (list 1 2 3)))
+(define h (make-hash-table))
+(hash-table-set! h (list 1 2) (quote pair))
+(hash-table-ref/default h (list 1 2) (quote none))
+(hash-table-count h)
+(do ((i 0 (+ i 1)) (acc (list) (cons i acc))) ((= i 3) acc))
+(let loop ((i 0) (acc 0)) (if (= i 100) acc (loop (+ i 1) (+ acc i))))
+(define-syntax swap!
+  (syntax-rules ()
+    ((_ a b) (let ((tmp a)) (set! a b) (set! b tmp)))))
+(define x 1)
+(define y 2)
+(swap! x y)
+(list x y)
+0.1
+(+ 0.1 0.2)
+1e23
+5e-324
+-0.0
+3.141592653589793
+(list -2.5 1.5e300 (* 2 0.25))
@@ -0,0 +1,62 @@
+// Client for the fork server in tests/run.sh.
+// Connects to the Unix-domain socket given as its argument, sends its
+// standard input as one job, shuts down its writing side, and copies the
+// reply to standard output until the server closes the connection.
+//
+// usage: client socket < job
+
+#define _POSIX_C_SOURCE 200809L
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+// Copy everything from in to out; return -1 on an error.
+static int copy(int in, int out)
+{
+    char buf[4096];
+    for (;;) {
+        ssize_t n = read(in, buf, sizeof(buf));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return (int) n;
+        }
+        for (ssize_t off = 0; off < n; ) {
+            ssize_t m = write(out, buf + off, n - off);
+            if (m < 0 && errno != EINTR) {
+                return -1;
+            }
+            off += m > 0 ? m : 0;
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s socket < job\n", argv[0]);
+        return 2;
+    }
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    if (strlen(argv[1]) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "error: socket path too long: %s\n", argv[1]);
+        return 2;
+    }
+    strcpy(addr.sun_path, argv[1]);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, (struct sockaddr *) &addr, sizeof(addr)) < 0) {
+        perror("error");
+        return 1;
+    }
+    if (copy(STDIN_FILENO, fd) < 0 || shutdown(fd, SHUT_WR) < 0
+     || copy(fd, STDOUT_FILENO) < 0) {
+        perror("error");
+        return 1;
+    }
+    close(fd);
+    return 0;
+}
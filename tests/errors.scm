@@ -0,0 +1,13 @@
+(guard (e (1 (list (error-object-message e) (error-object-irritants e))))
+  (error (quote boom) 1 2))
+(guard (e ((symbol? e) (list (quote caught) e)))
+  (raise (quote oops)))
+(with-exception-handler
+  (lambda (e) 10)
+  (lambda () (+ 1 (raise-continuable (quote again)))))
+(guard (e (1 (quote not-a-number)))
+  (+ 1 (quote a)))
+(display (quote before))
+(newline)
+(error (quote fatal) 1)
+(display (quote unreached))
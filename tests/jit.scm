@@ -0,0 +1,19 @@
+(define fib (lambda (n) (if (< n 2) n (+ (fib (- n 1)) (fib (- n 2))))))
+(fib 20)
+(define sumsq (lambda (n acc) (if (= n 0) acc (sumsq (- n 1) (+ acc (* n n))))))
+(sumsq 2000 0)
+(guard (e (1 (quote not-a-number))) (sumsq (list 1) 0))
+(sumsq 10 pi)
+(define k 2)
+(define addk (lambda (n acc) (if (= n 0) acc (addk (- n 1) (+ acc k)))))
+(addk 2000 0)
+(define k 10)
+(addk 2000 0)
+(set! k (list 1))
+(guard (e (1 (quote k-not-a-number))) (addk 2000 0))
+(set! k 5)
+(addk 2000 0)
+(define depth (lambda (n) (if (= n 0) 0 (+ 1 (depth (- n 1))))))
+(depth 5000)
+(guard (e (1 (quote too-deep))) (depth 100000000))
+(depth 10)
@@ -0,0 +1,18 @@
+(define v (make-vector 20000 0))
+(let loop ((i 0)) (if (< i 20000) (begin (vector-set! v i i) (loop (+ i 1))) i))
+(vector-ref v 19999)
+(let loop ((i 0) (caught 0))
+  (if (< i 20000)
+      (begin (loop (+ i 1) (+ caught (guard (e (1 1)) (if (= (vector-ref v i) 5) (raise i) 0)))))
+      caught))
+(let ((ch (make-channel 16)))
+  (let ((producer (spawn (lambda ()
+                           (let loop ((i 0))
+                             (if (< i 20000) (begin (channel-send ch i) (loop (+ i 1))) (quote done)))))))
+    (let loop ((i 0) (sum 0))
+      (if (< i 20000) (loop (+ i 1) (+ sum (channel-receive ch))) (list (join producer) sum)))))
+(let ((begin list)) (let loop ((i 0)) (if (< i 3) (begin i (loop (+ i 1))) (quote end))))
+(define count-down (lambda (n) (if (= n 0) 0 (+ 1 (count-down (- n 1))))))
+(guard (e (1 (quote too-deep))) (count-down 100000000))
+(let loop ((i 0)) (if (< i 20000) (guard (e (1 (quote too-deep))) (loop (+ i 1))) i))
+(count-down 1000)
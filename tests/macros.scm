@@ -0,0 +1,10 @@
+(define-syntax my-or (syntax-rules () ((_) 0) ((_ e) e) ((_ e r ...) (let ((t e)) (if t t (my-or r ...))))))
+(define f (lambda (my-or) (my-or 3)))
+(f (lambda (x) (* x 10)))
+(let ((my-or (lambda (x) (+ x 1)))) (my-or 3))
+(let* ((a 1) (my-or (lambda (x) (+ x a)))) (my-or 3))
+(letrec ((my-or (lambda (x) (if (= x 0) 0 (my-or (- x 1)))))) (my-or 3))
+(let loop ((my-or 2)) (if (= my-or 0) (quote done) (loop (- my-or 1))))
+(do ((my-or (lambda (x) (* x 2))) (i 0 (+ i 1))) ((= i 1) (my-or 4)))
+(let () (define my-or (lambda (x) (- x))) (my-or 5))
+(let ((x (my-or 7))) x)
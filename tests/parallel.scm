@@ -0,0 +1,15 @@
+(define v (make-vector 4 0))
+(parallel-for-each (lambda (i) (vector-set! v i 1)) (list 0 1 2 3))
+v
+(define total 0)
+(parallel-for-each (lambda (x) (set! total (+ total x))) (list 1 2 3))
+total
+(parallel-for-each (lambda (x) (display x)) (list 1 2 3))
+(newline)
+(define w (make-vector 1 0))
+(touch (future (begin (vector-set! w 0 5) (vector-ref w 0))))
+w
+(guard (e (1 (quote failed))) (touch (future (car 1))))
+(parallel-map (lambda (x) (touch (future (* x 10)))) (list 1 2 3))
+(parallel-map (lambda (x) (+ x 1)) (list 1))
+(parallel-map (lambda (x) x) (list))
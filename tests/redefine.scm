@@ -0,0 +1,21 @@
+(define sq (lambda (x) (* x x)))
+(define g (lambda () (sq 3)))
+(g)
+(define sq (lambda (x) (- x 1)))
+(g)
+(define f (lambda () (+ 1 2)))
+(set! + *)
+(f)
+(+ 2 3)
+(define begin-last (lambda () (begin 1 2)))
+(define begin list)
+(begin-last)
+(define-syntax clobber (syntax-rules () ((_ n v) (set! n v))))
+(define h (lambda () (- 10 2)))
+(clobber - +)
+(h)
+(define-syntax redef (syntax-rules () ((_ n v) (define n v))))
+(define cube (lambda (x) (* x x x)))
+(define k (lambda () (cube 3)))
+(redef cube (lambda (x) (- x 1)))
+(k)
@@ -0,0 +1,87 @@
+#!/bin/sh
+# Run every tests/NAME.scm and compare what it writes (standard output and
+# error) with tests/NAME.out. Each test runs four times: with and without
+# the optimizer (-O0), and with one worker thread and with four
+# (SCHEME_THREADS), which must all give the same output. A test with a
+# tests/NAME.limit file runs under a virtual memory limit of that many KB.
+# Given a directory of the tests compiled by scheme -c (make aot), each
+# compiled program DIR/NAME runs too, with one and four worker threads.
+# A tests/NAME.serve file holds requests for scheme --serve, which runs the
+# same four ways with them as its input.
+# A tests/NAME.jobs file holds jobs for scheme --fork-server with the
+# prelude tests/NAME.prelude, one job per line, each sent on a connection
+# of its own by the client built from tests/client.c, which is looked for
+# next to scheme as test-client.
+#
+# usage: tests/run.sh path/to/scheme [DIR]
+
+scheme=${1:?usage: tests/run.sh path/to/scheme [DIR]}
+compiled=$2
+dir=$(dirname "$0")
+client=$(dirname "$scheme")/test-client
+out=$(mktemp)
+sock=$out.sock
+trap 'rm -f "$out" "$sock"' EXIT
+
+failed=0
+total=0
+
+# Compare what the last run wrote with tests/$1.out; $2 says how it ran.
+check() {
+    total=$((total + 1))
+    if ! cmp -s "$out" "$dir/$1.out"; then
+        failed=$((failed + 1))
+        echo "FAIL $1 ($2)"
+        diff "$dir/$1.out" "$out" | head -20
+    fi
+}
+
+for test in "$dir"/*.scm; do
+    name=$(basename "$test" .scm)
+    limit=unlimited
+    if [ -f "$dir/$name.limit" ]; then
+        limit=$(cat "$dir/$name.limit")
+    fi
+    for threads in 1 4; do
+        for opt in "" -O0; do
+            (ulimit -v "$limit"; SCHEME_THREADS=$threads "$scheme" $opt -f "$test") > "$out" 2>&1
+            check "$name" "SCHEME_THREADS=$threads${opt:+ $opt}"
+        done
+        if [ -n "$compiled" ]; then
+            (ulimit -v "$limit"; SCHEME_THREADS=$threads "$compiled/$name") > "$out" 2>&1
+            check "$name" "compiled, SCHEME_THREADS=$threads"
+        fi
+    done
+done
+for test in "$dir"/*.serve; do
+    name=$(basename "$test" .serve)
+    for threads in 1 4; do
+        for opt in "" -O0; do
+            SCHEME_THREADS=$threads "$scheme" $opt --serve < "$test" > "$out" 2>&1
+            check "$name" "--serve, SCHEME_THREADS=$threads${opt:+ $opt}"
+        done
+    done
+done
+for test in "$dir"/*.jobs; do
+    name=$(basename "$test" .jobs)
+    for threads in 1 4; do
+        for opt in "" -O0; do
+            rm -f "$sock"
+            SCHEME_THREADS=$threads "$scheme" $opt --fork-server "$sock" "$dir/$name.prelude" > "$out" 2>&1 &
+            server=$!
+            tries=0
+            while [ ! -S "$sock" ] && [ "$tries" -lt 50 ]; do
+                sleep 0.1
+                tries=$((tries + 1))
+            done
+            while IFS= read -r job; do
+                printf '%s\n' "$job" | "$client" "$sock" >> "$out" 2>&1
+            done < "$test"
+            kill "$server"
+            wait "$server" 2> /dev/null
+            check "$name" "--fork-server, SCHEME_THREADS=$threads${opt:+ $opt}"
+        done
+    done
+done
+echo "$((total - failed))/$total passed"
+[ "$failed" -eq 0 ]
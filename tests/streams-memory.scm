@@ -0,0 +1,8 @@
+(define ints (lambda (n) (cons-stream n (ints (+ n 1)))))
+(let loop ((s (stream-map (lambda (x) (* 2 x)) (ints 0))) (i 0))
+  (if (< i 1000000) (loop (stream-cdr s) (+ i 1)) (stream-car s)))
+(let loop ((s (stream-filter (lambda (x) (> x 10)) (ints 0))) (i 0))
+  (if (< i 1000000) (loop (stream-cdr s) (+ i 1)) (stream-car s)))
+(do ((i 0 (+ i 1)) (l (list) (list i i i))) ((= i 1000000) l))
+(define drop (lambda (s n) (if (= n 0) s (drop (stream-cdr s) (- n 1)))))
+(stream-car (drop (stream-map (lambda (x) (* 2 x)) (ints 0)) 2000))
@@ -0,0 +1,17 @@
+(define ints (lambda (n) (cons-stream n (ints (+ n 1)))))
+(stream->list (stream-take (stream-map (lambda (x) (* x x)) (ints 0)) 5))
+(stream->list (stream-take (stream-filter (lambda (x) (> x 3)) (ints 1)) 3))
+(define p (delay (begin (display (quote once)) (newline) 42)))
+(force p)
+(force p)
+(force (make-promise 7))
+(define inner (delay (begin (display (quote inner)) (newline) 1)))
+(define middle (delay-force inner))
+(define outer (delay-force middle))
+(force outer)
+(force middle)
+(force inner)
+(define count 0)
+(define q (delay (begin (set! count (+ count 1)) (if (> count 5) count (force q)))))
+(force q)
+(begin (set! count 10) (force q))
@@ -0,0 +1,16 @@
+(define ch (make-channel 2))
+(define prod (spawn (lambda ()
+  (let loop ((i 0))
+    (if (< i 1000) (begin (channel-send ch (list i (* i i))) (loop (+ i 1))) (quote done))))))
+(define garbage (let loop ((i 0) (acc (list))) (if (< i 100000) (loop (+ i 1) (cons (list i) (list))) (length acc))))
+(define cons-t (spawn (lambda ()
+  (let loop ((i 0) (sum 0))
+    (if (< i 1000) (let ((v (channel-receive ch))) (loop (+ i 1) (+ sum (car (cdr v))))) sum)))))
+(join cons-t)
+(join prod)
+(define waiter (spawn (lambda () (channel-receive ch))))
+(define more-garbage (length (iota 100000)))
+(channel-send ch (list 1 2 3))
+(join waiter)
+(define lonely (make-channel))
+(guard (e (1 (quote deadlock))) (channel-receive lonely))
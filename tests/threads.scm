@@ -0,0 +1,9 @@
+(let ((t (spawn (lambda () (+ 2 3))))) (join t))
+(let ((ch (make-channel 2)))
+  (let ((producer (spawn (lambda ()
+                           (let loop ((i 0))
+                             (if (< i 5) (begin (channel-send ch i) (loop (+ i 1))) (quote done)))))))
+    (let loop ((i 0) (acc (list)))
+      (if (< i 5) (loop (+ i 1) (cons (channel-receive ch) acc)) (list (join producer) acc)))))
+(touch (future (* 6 7)))
+(parallel-map (lambda (x) (* x x)) (iota 10))
@@ -27,6 +27,20 @@ static inline size_t vector_grow_cap(size_t old_cap)
 #define VECTOR_DECLARE_SEARCH(T, TVal, header) TVal *header##_search(T *arr, TVal value)
 #define VECTOR_DECLARE_DELETE(T, TVal, header) void header##_delete(T *arr, TVal value)
 
+/*
+ * Variants of add and free whose functions take a context as their first
+ * argument, which is passed on to the allocation macros (e.g. the state of
+ * a custom allocator). By default the context is ignored.
+ */
+#define VECTOR_ARRAY_ALLOC_CTX(ctx, type, ptr, old, new) \
+    ((void) (ctx), VECTOR_ARRAY_ALLOC(type, ptr, old, new))
+
+#define VECTOR_ARRAY_FREE_CTX(ctx, type, ptr, size) \
+    do { (void) (ctx); VECTOR_ARRAY_FREE(type, ptr, size); } while (0)
+
+#define VECTOR_DECLARE_ADD_CTX(T, TVal, header, Ctx)  void header##_add(Ctx ctx, T *arr, TVal value)
+#define VECTOR_DECLARE_FREE_CTX(T, TVal, header, Ctx) void header##_free(Ctx ctx, T *arr)
+
 #define VECTOR_DEFINE_INIT(T, TVal, header) \
 void header##_init(T *arr)                  \
 {                                           \
@@ -53,6 +67,24 @@ void header##_free(T *arr)                        \
     header##_init(arr);                           \
 }                                                 \
 
+#define VECTOR_DEFINE_ADD_CTX(T, TVal, header, Ctx) \
+void header##_add(Ctx ctx, T *arr, TVal value)      \
+{                                                   \
+    if (arr->cap < arr->size + 1) {                 \
+        size_t old = arr->cap;                      \
+        arr->cap = vector_grow_cap(old);            \
+        arr->data = VECTOR_ARRAY_ALLOC_CTX(ctx, TVal, arr->data, old, arr->cap); \
+    }                                               \
+    arr->data[arr->size++] = value;                 \
+}                                                   \
+
+#define VECTOR_DEFINE_FREE_CTX(T, TVal, header, Ctx)          \
+void header##_free(Ctx ctx, T *arr)                           \
+{                                                             \
+    VECTOR_ARRAY_FREE_CTX(ctx, TVal, arr->data, arr->cap);    \
+    header##_init(arr);                                       \
+}                                                             \
+
 #define VECTOR_DEFINE_SEARCH(T, TVal, header) \
 TVal *header##_search(T *arr, TVal elem)      \
 {                                             \
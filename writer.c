@@ -0,0 +1,413 @@
+#include "writer.h"
+
+#include <errno.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+void writer_init(Writer *w, int fd, size_t cap)
+{
+    w->buf = malloc(cap);
+    if (!w->buf) {
+        abort();
+    }
+    w->len = 0;
+    w->cap = cap;
+    w->fd = fd;
+}
+
+void writer_free(Writer *w)
+{
+    writer_flush(w);
+    free(w->buf);
+    w->buf = NULL;
+    w->len = w->cap = 0;
+}
+
+static void write_all(int fd, const char *s, size_t len)
+{
+    while (len > 0) {
+        ssize_t n = write(fd, s, len);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return; // nobody is reading anymore; drop the output
+        }
+        s += n;
+        len -= n;
+    }
+}
+
+void writer_flush(Writer *w)
+{
+    if (w->fd >= 0 && w->len > 0) {
+        write_all(w->fd, w->buf, w->len);
+        w->len = 0;
+    }
+}
+
+void writer_reserve(Writer *w, size_t n)
+{
+    if (w->cap - w->len >= n) {
+        return;
+    }
+    writer_flush(w);
+    if (w->cap - w->len < n) {
+        while (w->cap - w->len < n) {
+            w->cap = w->cap < 64 ? 64 : w->cap * 2;
+        }
+        w->buf = realloc(w->buf, w->cap);
+        if (!w->buf) {
+            abort();
+        }
+    }
+}
+
+void writer_write(Writer *w, const char *s, size_t len)
+{
+    if (w->cap - w->len < len) {
+        writer_flush(w);
+        // too big to be worth buffering
+        if (w->fd >= 0 && len >= w->cap) {
+            write_all(w->fd, s, len);
+            return;
+        }
+        writer_reserve(w, len);
+    }
+    memcpy(w->buf + w->len, s, len);
+    w->len += len;
+}
+
+void writer_puts(Writer *w, const char *s) { writer_write(w, s, strlen(s)); }
+
+static const char digit_pairs[201] =
+    "00010203040506070809101112131415161718192021222324"
+    "25262728293031323334353637383940414243444546474849"
+    "50515253545556575859606162636465666768697071727374"
+    "75767778798081828384858687888990919293949596979899";
+
+static size_t format_uint(uint64_t n, char *buf)
+{
+    char tmp[20];
+    char *p = tmp + sizeof(tmp);
+    while (n >= 100) {
+        unsigned i = (n % 100) * 2;
+        n /= 100;
+        *--p = digit_pairs[i+1];
+        *--p = digit_pairs[i];
+    }
+    if (n >= 10) {
+        *--p = digit_pairs[n*2+1];
+        *--p = digit_pairs[n*2];
+    } else {
+        *--p = '0' + n;
+    }
+    size_t len = tmp + sizeof(tmp) - p;
+    memcpy(buf, p, len);
+    return len;
+}
+
+static size_t format_int(int64_t n, char *buf)
+{
+    if (n < 0) {
+        buf[0] = '-';
+        return 1 + format_uint((uint64_t) 0 - (uint64_t) n, buf + 1);
+    }
+    return format_uint(n, buf);
+}
+
+void writer_int(Writer *w, int64_t n)
+{
+    writer_reserve(w, 21);
+    w->len += format_int(n, w->buf + w->len);
+}
+
+void writer_number(Writer *w, double x)
+{
+    writer_reserve(w, FORMAT_NUMBER_MAX);
+    w->len += format_number(x, w->buf + w->len);
+}
+
+// Round-trip formatting of doubles, using Florian Loitsch's Grisu2
+// ("Printing Floating-Point Numbers Quickly and Accurately with Integers").
+// It generates a digit string that lies within the rounding interval of x,
+// so it reads back as x, working only with 64-bit integers. As it narrows
+// the interval to stay exact, the string is the shortest one for about
+// 99.9% of doubles but not for the rest: 1e23 comes out as
+// 9.999999999999999e+22, for one.
+
+// A floating point number f * 2^e with a 64-bit significand.
+typedef struct DiyFp {
+    uint64_t f;
+    int e;
+} DiyFp;
+
+#define DP_SIGNIFICAND_SIZE 52
+#define DP_EXPONENT_BIAS    (0x3FF + DP_SIGNIFICAND_SIZE)
+#define DP_MIN_EXPONENT     (-DP_EXPONENT_BIAS)
+#define DP_EXPONENT_MASK    0x7FF0000000000000ull
+#define DP_SIGNIFICAND_MASK 0x000FFFFFFFFFFFFFull
+#define DP_HIDDEN_BIT       0x0010000000000000ull
+
+static DiyFp diyfp_from_double(double d)
+{
+    uint64_t u;
+    memcpy(&u, &d, sizeof(u));
+    int biased_e = (u & DP_EXPONENT_MASK) >> DP_SIGNIFICAND_SIZE;
+    uint64_t significand = u & DP_SIGNIFICAND_MASK;
+    return biased_e != 0
+        ? (DiyFp) { significand + DP_HIDDEN_BIT, biased_e - DP_EXPONENT_BIAS }
+        : (DiyFp) { significand, DP_MIN_EXPONENT + 1 };
+}
+
+// Multiply two DiyFps, keeping the rounded upper 64 bits of the product.
+static DiyFp diyfp_mul(DiyFp x, DiyFp y)
+{
+    const uint64_t mask = 0xFFFFFFFFull;
+    uint64_t a = x.f >> 32, b = x.f & mask;
+    uint64_t c = y.f >> 32, d = y.f & mask;
+    uint64_t ac = a * c, bc = b * c, ad = a * d, bd = b * d;
+    uint64_t tmp = (bd >> 32) + (ad & mask) + (bc & mask);
+    tmp += 1ull << 31;
+    return (DiyFp) { ac + (ad >> 32) + (bc >> 32) + (tmp >> 32), x.e + y.e + 64 };
+}
+
+static DiyFp diyfp_normalize(DiyFp x)
+{
+    int shift = __builtin_clzll(x.f);
+    return (DiyFp) { x.f << shift, x.e - shift };
+}
+
+// The boundaries m- and m+ of the rounding interval of v, normalized to the
+// same exponent.
+static void normalized_boundaries(DiyFp v, DiyFp *minus, DiyFp *plus)
+{
+    DiyFp pl = diyfp_normalize((DiyFp) { (v.f << 1) + 1, v.e - 1 });
+    DiyFp mi = v.f == DP_HIDDEN_BIT
+        ? (DiyFp) { (v.f << 2) - 1, v.e - 2 }
+        : (DiyFp) { (v.f << 1) - 1, v.e - 1 };
+    mi.f <<= mi.e - pl.e;
+    mi.e = pl.e;
+    *minus = mi;
+    *plus = pl;
+}
+
+// Normalized 10^k for k = -348, -340, ..., 340.
+static const DiyFp cached_powers[] = {
+    { 0xfa8fd5a0081c0288ull, -1220 }, { 0xbaaee17fa23ebf76ull, -1193 },
+    { 0x8b16fb203055ac76ull, -1166 }, { 0xcf42894a5dce35eaull, -1140 },
+    { 0x9a6bb0aa55653b2dull, -1113 }, { 0xe61acf033d1a45dfull, -1087 },
+    { 0xab70fe17c79ac6caull, -1060 }, { 0xff77b1fcbebcdc4full, -1034 },
+    { 0xbe5691ef416bd60cull, -1007 }, { 0x8dd01fad907ffc3cull,  -980 },
+    { 0xd3515c2831559a83ull,  -954 }, { 0x9d71ac8fada6c9b5ull,  -927 },
+    { 0xea9c227723ee8bcbull,  -901 }, { 0xaecc49914078536dull,  -874 },
+    { 0x823c12795db6ce57ull,  -847 }, { 0xc21094364dfb5637ull,  -821 },
+    { 0x9096ea6f3848984full,  -794 }, { 0xd77485cb25823ac7ull,  -768 },
+    { 0xa086cfcd97bf97f4ull,  -741 }, { 0xef340a98172aace5ull,  -715 },
+    { 0xb23867fb2a35b28eull,  -688 }, { 0x84c8d4dfd2c63f3bull,  -661 },
+    { 0xc5dd44271ad3cdbaull,  -635 }, { 0x936b9fcebb25c996ull,  -608 },
+    { 0xdbac6c247d62a584ull,  -582 }, { 0xa3ab66580d5fdaf6ull,  -555 },
+    { 0xf3e2f893dec3f126ull,  -529 }, { 0xb5b5ada8aaff80b8ull,  -502 },
+    { 0x87625f056c7c4a8bull,  -475 }, { 0xc9bcff6034c13053ull,  -449 },
+    { 0x964e858c91ba2655ull,  -422 }, { 0xdff9772470297ebdull,  -396 },
+    { 0xa6dfbd9fb8e5b88full,  -369 }, { 0xf8a95fcf88747d94ull,  -343 },
+    { 0xb94470938fa89bcfull,  -316 }, { 0x8a08f0f8bf0f156bull,  -289 },
+    { 0xcdb02555653131b6ull,  -263 }, { 0x993fe2c6d07b7facull,  -236 },
+    { 0xe45c10c42a2b3b06ull,  -210 }, { 0xaa242499697392d3ull,  -183 },
+    { 0xfd87b5f28300ca0eull,  -157 }, { 0xbce5086492111aebull,  -130 },
+    { 0x8cbccc096f5088ccull,  -103 }, { 0xd1b71758e219652cull,   -77 },
+    { 0x9c40000000000000ull,   -50 }, { 0xe8d4a51000000000ull,   -24 },
+    { 0xad78ebc5ac620000ull,     3 }, { 0x813f3978f8940984ull,    30 },
+    { 0xc097ce7bc90715b3ull,    56 }, { 0x8f7e32ce7bea5c70ull,    83 },
+    { 0xd5d238a4abe98068ull,   109 }, { 0x9f4f2726179a2245ull,   136 },
+    { 0xed63a231d4c4fb27ull,   162 }, { 0xb0de65388cc8ada8ull,   189 },
+    { 0x83c7088e1aab65dbull,   216 }, { 0xc45d1df942711d9aull,   242 },
+    { 0x924d692ca61be758ull,   269 }, { 0xda01ee641a708deaull,   295 },
+    { 0xa26da3999aef774aull,   322 }, { 0xf209787bb47d6b85ull,   348 },
+    { 0xb454e4a179dd1877ull,   375 }, { 0x865b86925b9bc5c2ull,   402 },
+    { 0xc83553c5c8965d3dull,   428 }, { 0x952ab45cfa97a0b3ull,   455 },
+    { 0xde469fbd99a05fe3ull,   481 }, { 0xa59bc234db398c25ull,   508 },
+    { 0xf6c69a72a3989f5cull,   534 }, { 0xb7dcbf5354e9beceull,   561 },
+    { 0x88fcf317f22241e2ull,   588 }, { 0xcc20ce9bd35c78a5ull,   614 },
+    { 0x98165af37b2153dfull,   641 }, { 0xe2a0b5dc971f303aull,   667 },
+    { 0xa8d9d1535ce3b396ull,   694 }, { 0xfb9b7cd9a4a7443cull,   720 },
+    { 0xbb764c4ca7a44410ull,   747 }, { 0x8bab8eefb6409c1aull,   774 },
+    { 0xd01fef10a657842cull,   800 }, { 0x9b10a4e5e9913129ull,   827 },
+    { 0xe7109bfba19c0c9dull,   853 }, { 0xac2820d9623bf429ull,   880 },
+    { 0x80444b5e7aa7cf85ull,   907 }, { 0xbf21e44003acdd2dull,   933 },
+    { 0x8e679c2f5e44ff8full,   960 }, { 0xd433179d9c8cb841ull,   986 },
+    { 0x9e19db92b4e31ba9ull,  1013 }, { 0xeb96bf6ebadf77d9ull,  1039 },
+    { 0xaf87023b9bf0ee6bull,  1066 },
+};
+
+// Find a cached power c = 10^-K such that c * 2^e has its exponent in the
+// range Grisu needs.
+static DiyFp cached_power(int e, int *K)
+{
+    double dk = (-61 - e) * 0.30102999566398114 + 347; // 1/log2(10)
+    int k = (int) dk;
+    if (dk - k > 0.0) {
+        k++;
+    }
+    unsigned index = (unsigned) ((k >> 3) + 1);
+    *K = -(-348 + (int) (index << 3));
+    return cached_powers[index];
+}
+
+static const uint64_t powers_of_10[] = {
+    1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull,
+    100000000ull, 1000000000ull, 10000000000ull, 100000000000ull,
+    1000000000000ull, 10000000000000ull, 100000000000000ull,
+    1000000000000000ull, 10000000000000000ull, 100000000000000000ull,
+    1000000000000000000ull, 10000000000000000000ull,
+};
+
+static int count_digits(uint32_t n)
+{
+    int count = 1;
+    while (count < 10 && n >= powers_of_10[count]) {
+        count++;
+    }
+    return count;
+}
+
+// Move the last digit down while that brings the number closer to w.
+static void grisu_round(char *buf, int len, uint64_t delta, uint64_t rest,
+                        uint64_t ten_kappa, uint64_t wp_w)
+{
+    while (rest < wp_w && delta - rest >= ten_kappa
+        && (rest + ten_kappa < wp_w || wp_w - rest > rest + ten_kappa - wp_w)) {
+        buf[len-1]--;
+        rest += ten_kappa;
+    }
+}
+
+static void digit_gen(DiyFp w, DiyFp mp, uint64_t delta, char *buf, int *len, int *K)
+{
+    DiyFp one = { 1ull << -mp.e, mp.e };
+    uint64_t wp_w = mp.f - w.f;
+    uint32_t p1 = (uint32_t) (mp.f >> -one.e);
+    uint64_t p2 = mp.f & (one.f - 1);
+    int kappa = count_digits(p1);
+    *len = 0;
+
+    // integral part
+    while (kappa > 0) {
+        uint32_t div = powers_of_10[kappa-1];
+        uint32_t d = p1 / div;
+        p1 %= div;
+        if (d || *len) {
+            buf[(*len)++] = '0' + d;
+        }
+        kappa--;
+        uint64_t rest = ((uint64_t) p1 << -one.e) + p2;
+        if (rest <= delta) {
+            *K += kappa;
+            grisu_round(buf, *len, delta, rest, powers_of_10[kappa] << -one.e, wp_w);
+            return;
+        }
+    }
+
+    // fractional part
+    for (;;) {
+        p2 *= 10;
+        delta *= 10;
+        char d = (char) (p2 >> -one.e);
+        if (d || *len) {
+            buf[(*len)++] = '0' + d;
+        }
+        p2 &= one.f - 1;
+        kappa--;
+        if (p2 < delta) {
+            *K += kappa;
+            int index = -kappa;
+            grisu_round(buf, *len, delta, p2, one.f, wp_w * (index < 20 ? powers_of_10[index] : 0));
+            return;
+        }
+    }
+}
+
+// Write digits of x > 0 to buf that read back as x, with x ~ digits * 10^K.
+static void grisu2(double x, char *buf, int *len, int *K)
+{
+    DiyFp v = diyfp_from_double(x);
+    DiyFp w_m, w_p;
+    normalized_boundaries(v, &w_m, &w_p);
+    DiyFp c_mk = cached_power(w_p.e, K);
+    DiyFp w  = diyfp_mul(diyfp_normalize(v), c_mk);
+    DiyFp wp = diyfp_mul(w_p, c_mk);
+    DiyFp wm = diyfp_mul(w_m, c_mk);
+    wm.f++;
+    wp.f--;
+    digit_gen(w, wp, wp.f - wm.f, buf, len, K);
+}
+
+// Lay out digits * 10^K the way a reader expects: plainly when the decimal
+// point is near the digits, in exponent notation otherwise.
+static size_t prettify(const char *digits, int len, int K, char *buf)
+{
+    int point = len + K; // position of the decimal point
+    char *p = buf;
+    if (len <= point && point <= 21) {
+        // an integer too large for the fast path
+        memcpy(p, digits, len);
+        memset(p + len, '0', point - len);
+        p += point;
+    } else if (0 < point && point <= 21) {
+        memcpy(p, digits, point);
+        p[point] = '.';
+        memcpy(p + point + 1, digits + point, len - point);
+        p += len + 1;
+    } else if (-6 < point && point <= 0) {
+        *p++ = '0';
+        *p++ = '.';
+        memset(p, '0', -point);
+        p += -point;
+        memcpy(p, digits, len);
+        p += len;
+    } else {
+        *p++ = digits[0];
+        if (len > 1) {
+            *p++ = '.';
+            memcpy(p, digits + 1, len - 1);
+            p += len - 1;
+        }
+        *p++ = 'e';
+        *p++ = point - 1 < 0 ? '-' : '+';
+        p += format_uint(abs(point - 1), p);
+    }
+    return p - buf;
+}
+
+size_t format_number(double x, char buf[FORMAT_NUMBER_MAX])
+{
+    // integers are by far the most common numbers, so try them first
+    if (x > -9007199254740992.0 && x < 9007199254740992.0 && x == (int64_t) x
+        && !(x == 0 && signbit(x))) {
+        return format_int((int64_t) x, buf);
+    }
+    if (isnan(x)) {
+        memcpy(buf, "+nan.0", 6);
+        return 6;
+    }
+    if (isinf(x)) {
+        memcpy(buf, x < 0 ? "-inf.0" : "+inf.0", 6);
+        return 6;
+    }
+    if (x == 0) {
+        // the fraction keeps the sign when it's read back
+        memcpy(buf, "-0.0", 4);
+        return 4;
+    }
+    size_t sign = 0;
+    if (x < 0) {
+        buf[sign++] = '-';
+        x = -x;
+    }
+    char digits[32];
+    int len, K;
+    grisu2(x, digits, &len, &K);
+    return sign + prettify(digits, len, K, buf + sign);
+}
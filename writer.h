@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// A buffered output stream.
+// Output accumulates in buf and is written to fd only when the buffer fills
+// up or on writer_flush. A Writer with fd == -1 is an in-memory writer:
+// instead of flushing, its buffer grows, so that output can be captured.
+typedef struct Writer {
+    char *buf;
+    size_t len;
+    size_t cap;
+    int fd;
+} Writer;
+
+#define WRITER_DEFAULT_SIZE (64 * 1024)
+
+// Longest output of format_number, with its terminating NUL.
+#define FORMAT_NUMBER_MAX 32
+
+void writer_init(Writer *w, int fd, size_t cap);
+void writer_free(Writer *w);
+
+// Write out everything buffered so far. Does nothing on in-memory writers.
+void writer_flush(Writer *w);
+
+// Discard everything buffered so far.
+static inline void writer_clear(Writer *w) { w->len = 0; }
+
+// Make room for at least n more bytes.
+void writer_reserve(Writer *w, size_t n);
+
+void writer_write(Writer *w, const char *s, size_t len);
+void writer_puts(Writer *w, const char *s);
+void writer_int(Writer *w, int64_t n);
+void writer_number(Writer *w, double x);
+
+static inline void writer_putc(Writer *w, char c)
+{
+    if (w->len == w->cap) {
+        writer_reserve(w, 1);
+    }
+    w->buf[w->len++] = c;
+}
+
+// Format x as a decimal string that reads back as x. It's the shortest such
+// string for nearly every x, but may have a digit too many (see grisu2).
+// Integers are written without a fractional part.
+// Return the length of the string written to buf.
+size_t format_number(double x, char buf[FORMAT_NUMBER_MAX]);